@@ -1,9 +1,11 @@
 TEMPLATE = subdirs
-SUBDIRS = YUViewLib YUViewApp YUViewUnitTest
+SUBDIRS = YUViewLib YUViewApp YUViewCmd YUViewUnitTest
 
 YUViewApp.subdir = YUViewApp
+YUViewCmd.subdir = YUViewCmd
 YUViewLib.subdir = YUViewLib
 YUViewUnitTest.subdir = YUViewUnitTest
 
 YUViewApp.depends = YUViewLib
+YUViewCmd.depends = YUViewLib
 YUViewUnitTest.depends = YUViewLib
@@ -0,0 +1,45 @@
+QT += gui opengl xml concurrent network
+
+TARGET = YUViewCmd
+TEMPLATE = app
+CONFIG += c++1z console
+CONFIG -= debug_and_release app_bundle
+
+SOURCES += $$files(src/*.cpp, false)
+HEADERS += $$files(src/*.h, false)
+
+INCLUDEPATH += $$top_srcdir/YUViewLib/src
+LIBS += -L$$top_builddir/YUViewLib -lYUViewLib
+
+win32 {
+    PRE_TARGETDEPS += $$top_builddir/YUViewLib/YUViewLib.lib
+} else {
+    PRE_TARGETDEPS += $$top_builddir/YUViewLib/libYUViewLib.a
+}
+
+unix:!mac {
+    isEmpty(PREFIX) {
+        PREFIX = /usr/local
+    }
+    isEmpty(BINDIR) {
+        BINDIR = bin
+    }
+
+    target.path = $$PREFIX/$$BINDIR/
+    INSTALLS += target
+}
+
+win32-g++ {
+    QMAKE_FLAGS_RELEASE += -O3 -Ofast -msse4.1 -mssse3 -msse3 -msse2 -msse -mfpmath=sse
+    QMAKE_CXXFLAGS_RELEASE += -O3 -Ofast -msse4.1 -mssse3 -msse3 -msse2 -msse -mfpmath=sse
+}
+win32 {
+    DEFINES += NOMINMAX
+}
+
+SVNN = $$system("git describe --tags")
+isEmpty(SVNN) {
+    SVNN = 0
+}
+VERSTR = '\\"$${SVNN}\\"'
+DEFINES += YUVIEW_VERSION=$${VERSTR}
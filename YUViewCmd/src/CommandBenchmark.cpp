@@ -0,0 +1,162 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Commands.h"
+
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QThread>
+
+#include "common/functions.h"
+#include "decoder/DecoderBenchmark.h"
+
+int runCommandBenchmark(const QStringList &arguments)
+{
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Measure the decoding throughput of bitstream files without any GUI, caching or conversion. "
+                                   "Reports the frame rate, per frame latency percentiles, peak memory and the time split between "
+                                   "reading the file, pushData, decodeNextFrame and getRawFrameData.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("files", "The bitstream files to decode.", "<files...>");
+  QCommandLineOption decoderOption(QStringList() << "d" << "decoder", "The decoder to use: libDe265, HM, VTM, Dav1d or FFmpeg. By default, the decoder is chosen from the file type.", "decoder");
+  QCommandLineOption threadsOption(QStringList() << "t" << "threads", "Comma separated list of decoder thread counts. Every file is decoded once per thread count.", "threads");
+  QCommandLineOption framesOption(QStringList() << "n" << "frames", "Stop after this many frames.", "frames");
+  QCommandLineOption jsonOption(QStringList() << "json", "Write the results as JSON to this file (- for stdout).", "file");
+  QCommandLineOption quietOption(QStringList() << "q" << "quiet", "Do not print the results to stderr.");
+  parser.addOption(decoderOption);
+  parser.addOption(threadsOption);
+  parser.addOption(framesOption);
+  parser.addOption(jsonOption);
+  parser.addOption(quietOption);
+  parser.process(arguments);
+
+  QTextStream err(stderr);
+
+  const auto files = parser.positionalArguments();
+  if (files.isEmpty())
+  {
+    err << "No input files given.\n";
+    return 1;
+  }
+
+  auto decoder = YUView::decoderEngineInvalid;
+  if (parser.isSet(decoderOption))
+  {
+    decoder = functions::getDecoderEngineFromName(parser.value(decoderOption));
+    if (decoder == YUView::decoderEngineInvalid)
+    {
+      err << "Unknown decoder " << parser.value(decoderOption) << "\n";
+      return 1;
+    }
+  }
+
+  QList<int> threadCounts;
+  if (parser.isSet(threadsOption))
+  {
+    for (const auto &value : parser.value(threadsOption).split(",", QString::SkipEmptyParts))
+    {
+      bool ok;
+      const int nrThreads = value.toInt(&ok);
+      if (!ok || nrThreads <= 0)
+      {
+        err << "Invalid thread count " << value << "\n";
+        return 1;
+      }
+      threadCounts.append(nrThreads);
+    }
+  }
+  if (threadCounts.isEmpty())
+    threadCounts.append(QThread::idealThreadCount());
+
+  DecoderBenchmark benchmark(decoder, parser.isSet(framesOption) ? parser.value(framesOption).toInt() : 0);
+
+  int nrErrors = 0;
+  QJsonArray jsonResults;
+  for (const auto &file : files)
+  {
+    for (const auto nrThreads : threadCounts)
+    {
+      const auto result = benchmark.runFile(file, nrThreads);
+      jsonResults.append(result.toJSON());
+      if (!result.success)
+        nrErrors++;
+      if (parser.isSet(quietOption) && result.success)
+        continue;
+
+      err << result.fileName << " (" << result.decoderName << ", " << result.nrThreads << " threads";
+      if (result.nrThreads != result.requestedNrThreads)
+        err << " of " << result.requestedNrThreads << " requested";
+      err << "): ";
+      if (!result.success)
+      {
+        err << "Error: " << result.error << "\n";
+        continue;
+      }
+      err << result.nrFrames << " frames " << result.frameSize.width() << "x" << result.frameSize.height() << " in "
+          << QString::number(result.seconds, 'f', 3) << " s (" << QString::number(result.getFramesPerSecond(), 'f', 2) << " fps)\n"
+          << "  latency p50 " << QString::number(result.getLatencyPercentileMs(50), 'f', 2) << " ms, p90 " 
+          << QString::number(result.getLatencyPercentileMs(90), 'f', 2) << " ms, p99 " << QString::number(result.getLatencyPercentileMs(99), 'f', 2) 
+          << " ms, max " << QString::number(result.getLatencyPercentileMs(100), 'f', 2) << " ms\n"
+          << "  read " << QString::number(result.readSeconds, 'f', 3) << " s, pushData " << QString::number(result.pushDataSeconds, 'f', 3)
+          << " s, decodeNextFrame " << QString::number(result.decodeNextFrameSeconds, 'f', 3) << " s, getRawFrameData "
+          << QString::number(result.getRawFrameDataSeconds, 'f', 3) << " s\n"
+          << (result.peakMemoryOfRun ? "  peak memory " : "  process peak memory (including previous runs) ") << result.peakMemoryMB << " MB\n";
+    }
+  }
+
+  if (parser.isSet(jsonOption))
+  {
+    QJsonObject json;
+    json["version"] = QString::fromUtf8(YUVIEW_VERSION);
+    json["results"] = jsonResults;
+    const auto jsonData = QJsonDocument(json).toJson();
+
+    const auto jsonFileName = parser.value(jsonOption);
+    QFile jsonFile(jsonFileName);
+    bool opened;
+    if (jsonFileName == "-")
+      opened = jsonFile.open(stdout, QIODevice::WriteOnly);
+    else
+      opened = jsonFile.open(QIODevice::WriteOnly);
+    if (!opened)
+    {
+      err << "Unable to open the JSON output file " << jsonFileName << "\n";
+      return 1;
+    }
+    jsonFile.write(jsonData);
+  }
+
+  return (nrErrors > 0) ? 2 : 0;
+}
@@ -0,0 +1,116 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Commands.h"
+
+#include <algorithm>
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QTextStream>
+
+#include "common/functions.h"
+#include "parser/BitstreamDumper.h"
+
+int runCommandDump(const QStringList &arguments)
+{
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Parse bitstream files (AnnexB AVC/HEVC/VVC or any container supported by libavformat) "
+                                   "and write the syntax of every packet as JSON Lines or CSV.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("files", "The bitstream files to parse.", "<files...>");
+  QCommandLineOption formatOption(QStringList() << "f" << "format", "Output format: jsonl (default) or csv.", "format", "jsonl");
+  QCommandLineOption outputOption(QStringList() << "o" << "output", "Write one output file per input file into this directory instead of stdout.", "directory");
+  QCommandLineOption threadsOption(QStringList() << "j" << "threads", "Number of files to parse in parallel.", "threads");
+  QCommandLineOption quietOption(QStringList() << "q" << "quiet", "Do not print the throughput summary to stderr.");
+  parser.addOption(formatOption);
+  parser.addOption(outputOption);
+  parser.addOption(threadsOption);
+  parser.addOption(quietOption);
+  parser.process(arguments);
+
+  QTextStream err(stderr);
+
+  bool formatOk;
+  const auto format = PacketDumpWriter::formatFromName(parser.value(formatOption), &formatOk);
+  if (!formatOk)
+  {
+    err << "Unknown output format " << parser.value(formatOption) << "\n";
+    return 1;
+  }
+
+  const auto files = parser.positionalArguments();
+  if (files.isEmpty())
+  {
+    err << "No input files given.\n";
+    return 1;
+  }
+
+  const auto outputDirectory = parser.value(outputOption);
+  if (!outputDirectory.isEmpty() && !QDir().mkpath(outputDirectory))
+  {
+    err << "Unable to create the output directory " << outputDirectory << "\n";
+    return 1;
+  }
+
+  unsigned nrThreads = functions::getOptimalThreadCount();
+  if (parser.isSet(threadsOption))
+    nrThreads = std::max(parser.value(threadsOption).toInt(), 1);
+
+  BitstreamDumper dumper(format, outputDirectory);
+  const auto results = dumper.dumpFiles(files, nrThreads);
+
+  int64_t totalBytes = 0;
+  int64_t totalPackets = 0;
+  double totalSeconds = 0.0;
+  int nrErrors = 0;
+  for (const auto &result : results)
+  {
+    totalBytes += result.fileSize;
+    totalPackets += result.nrPackets;
+    totalSeconds += result.seconds;
+    if (!result.success)
+      nrErrors++;
+    if (parser.isSet(quietOption) && result.success)
+      continue;
+    err << result.fileName << ": " << result.nrPackets << " packets, " << QString::number(double(result.fileSize) / 1000000.0, 'f', 2) 
+        << " MB in " << QString::number(result.seconds, 'f', 3) << " s (" << QString::number(result.getMBPerSecond(), 'f', 2) << " MB/s)";
+    if (!result.success)
+      err << " - Error: " << (result.error.isEmpty() ? QString("Parsing failed") : result.error);
+    err << "\n";
+  }
+  if (!parser.isSet(quietOption) && results.size() > 1)
+    err << "Total: " << results.size() << " files, " << totalPackets << " packets, " << QString::number(double(totalBytes) / 1000000.0, 'f', 2)
+        << " MB, " << QString::number(totalSeconds, 'f', 3) << " s parsing time in " << nrThreads << " threads\n";
+
+  return (nrErrors > 0) ? 2 : 0;
+}
@@ -0,0 +1,144 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Commands.h"
+
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "common/functions.h"
+#include "video/FrameExporter.h"
+
+int runCommandExport(const QStringList &arguments)
+{
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Decode a bitstream or read a raw YUV/RGB file and write all frames as raw YUV, raw RGB "
+                                   "(8 bit, interleaved), Y4M or a sequence of PNG files. Decoding, conversion and writing "
+                                   "run in parallel.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("file", "The bitstream or raw file to export.", "<file>");
+  QCommandLineOption outputOption(QStringList() << "o" << "output", "The output file. For PNG, the frame number is appended to the file name.", "file");
+  QCommandLineOption formatOption(QStringList() << "f" << "format", "The output format: yuv, rgb, y4m or png. By default, the format is chosen from the output file extension.", "format");
+  QCommandLineOption decoderOption(QStringList() << "d" << "decoder", "The decoder to use: libDe265, HM, VTM, Dav1d or FFmpeg. By default, the decoder is chosen from the file type.", "decoder");
+  QCommandLineOption framesOption(QStringList() << "n" << "frames", "Stop after this many frames.", "frames");
+  QCommandLineOption sizeOption(QStringList() << "s" << "size", "The frame size of a raw input file (e.g. 1920x1080). By default, it is guessed from the file name.", "WxH");
+  QCommandLineOption pixelFormatOption(QStringList() << "p" << "pixel-format", "The pixel format of a raw input file as shown in YUView (e.g. \"YUV 4:2:0 8-bit\" or \"RGB 8bit\"). Requires --size.", "name");
+  QCommandLineOption threadsOption(QStringList() << "t" << "threads", "The number of conversion threads.", "threads");
+  QCommandLineOption quietOption(QStringList() << "q" << "quiet", "Do not print the result to stderr.");
+  parser.addOption(outputOption);
+  parser.addOption(formatOption);
+  parser.addOption(decoderOption);
+  parser.addOption(framesOption);
+  parser.addOption(sizeOption);
+  parser.addOption(pixelFormatOption);
+  parser.addOption(threadsOption);
+  parser.addOption(quietOption);
+  parser.process(arguments);
+
+  QTextStream err(stderr);
+
+  const auto files = parser.positionalArguments();
+  if (files.size() != 1)
+  {
+    err << "Exactly one input file must be given.\n";
+    return 1;
+  }
+  if (!parser.isSet(outputOption))
+  {
+    err << "No output file given.\n";
+    return 1;
+  }
+  const auto outputFileName = parser.value(outputOption);
+
+  auto outputFormat = FrameExporter::outputFormatFromFileName(outputFileName);
+  if (parser.isSet(formatOption) && !FrameExporter::outputFormatFromName(parser.value(formatOption), outputFormat))
+  {
+    err << "Unknown output format " << parser.value(formatOption) << "\n";
+    return 1;
+  }
+
+  FrameExporter::Source source;
+  source.fileName = files[0];
+  if (parser.isSet(decoderOption))
+  {
+    source.decoder = functions::getDecoderEngineFromName(parser.value(decoderOption));
+    if (source.decoder == YUView::decoderEngineInvalid)
+    {
+      err << "Unknown decoder " << parser.value(decoderOption) << "\n";
+      return 1;
+    }
+  }
+  if (parser.isSet(pixelFormatOption))
+  {
+    const auto size = parser.value(sizeOption).split("x");
+    bool okWidth = false, okHeight = false;
+    const auto width = size.value(0).toInt(&okWidth);
+    const auto height = size.value(1).toInt(&okHeight);
+    if (size.size() != 2 || !okWidth || !okHeight || width <= 0 || height <= 0)
+    {
+      err << "Invalid or missing frame size " << parser.value(sizeOption) << "\n";
+      return 1;
+    }
+    // The same format string that the raw file item uses (see videoHandler::getFormatAsString)
+    const auto pixelFormat = parser.value(pixelFormatOption);
+    const auto ext = QFileInfo(source.fileName).suffix().toLower();
+    const bool rgb = (ext == "rgb" || ext == "gbr" || ext == "bgr" || ext == "brg");
+    source.rawFormat = QString("%1;%2;%3;%4").arg(width).arg(height).arg(rgb ? "RGB" : "YUV").arg(pixelFormat);
+  }
+  else if (parser.isSet(sizeOption))
+  {
+    err << "The --size option requires --pixel-format.\n";
+    return 1;
+  }
+
+  FrameExporter exporter(source, outputFileName, outputFormat);
+  if (parser.isSet(framesOption))
+    exporter.setMaxNrFrames(parser.value(framesOption).toLongLong());
+  if (parser.isSet(threadsOption))
+    exporter.setNrConversionThreads(parser.value(threadsOption).toInt());
+
+  const auto result = exporter.run();
+  if (!result.success)
+  {
+    err << source.fileName << ": Error: " << result.error << "\n";
+    return 2;
+  }
+  if (!parser.isSet(quietOption))
+  {
+    // A very short export may not take a measurable amount of time
+    const auto fps = (result.seconds > 0.0) ? QString::number(double(result.nrFrames) / result.seconds, 'f', 2) : QString("-");
+    err << source.fileName << ": " << result.nrFrames << " frames (" << QString::number(double(result.nrBytesWritten) / 1024 / 1024, 'f', 1)
+        << " MB) written in " << QString::number(result.seconds, 'f', 3) << " s (" << fps << " fps)\n";
+  }
+  return 0;
+}
@@ -0,0 +1,109 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Commands.h"
+
+#include <algorithm>
+
+#include <QCommandLineParser>
+#include <QTextStream>
+
+#include "common/functions.h"
+#include "parser/HRDConformanceChecker.h"
+
+int runCommandHRD(const QStringList &arguments)
+{
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Simulate the hypothetical reference decoder (HRD) for bitstream files in a single pass "
+                                   "and report buffer underflows, overflows and other conformance violations. "
+                                   "The exit code is 0 if all files are conformant, 3 if at least one is not and 2 on errors.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("files", "The bitstream files to check.", "<files...>");
+  QCommandLineOption threadsOption(QStringList() << "j" << "threads", "Number of files to check in parallel.", "threads");
+  QCommandLineOption eventsOption(QStringList() << "e" << "events", "Print every event and not only the summary per file.");
+  parser.addOption(threadsOption);
+  parser.addOption(eventsOption);
+  parser.process(arguments);
+
+  QTextStream out(stdout);
+  QTextStream err(stderr);
+
+  const auto files = parser.positionalArguments();
+  if (files.isEmpty())
+  {
+    err << "No input files given.\n";
+    return 1;
+  }
+
+  unsigned nrThreads = functions::getOptimalThreadCount();
+  if (parser.isSet(threadsOption))
+    nrThreads = std::max(parser.value(threadsOption).toInt(), 1);
+
+  HRDConformanceChecker checker;
+  const auto results = checker.checkFiles(files, nrThreads);
+
+  int nrErrors = 0;
+  int nrNotConformant = 0;
+  for (const auto &result : results)
+  {
+    out << result.fileName << ": ";
+    if (!result.success)
+    {
+      nrErrors++;
+      out << "Error: " << (result.error.isEmpty() ? QString("Parsing failed") : result.error) << "\n";
+      continue;
+    }
+    if (!result.hasHRD())
+      out << "no HRD simulation (no HRD parameters or unsupported format)";
+    else if (result.isConformant())
+      out << "conformant";
+    else
+    {
+      nrNotConformant++;
+      out << "NOT conformant (" << result.nrEvents << " events)";
+    }
+    out << " - " << QString::number(result.getMBPerSecond(), 'f', 2) << " MB/s\n";
+
+    if (parser.isSet(eventsOption))
+    {
+      for (const auto &event : result.events)
+        out << "  " << HRDPlotModel::eventTypeToString(event.type) << " AU " << event.accessUnit << " POC " << event.poc
+            << " time " << QString::number(event.time * 1000, 'f', 3) << " ms: " << event.message << "\n";
+      if (result.nrEvents > uint64_t(result.events.size()))
+        out << "  ... " << (result.nrEvents - uint64_t(result.events.size())) << " more events\n";
+    }
+  }
+
+  if (nrErrors > 0)
+    return 2;
+  return (nrNotConformant > 0) ? 3 : 0;
+}
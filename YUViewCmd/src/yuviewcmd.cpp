@@ -0,0 +1,85 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "Commands.h"
+
+namespace
+{
+
+void printUsage()
+{
+  QTextStream err(stderr);
+  err << "Usage: YUViewCmd <command> [options]\n"
+      << "\n"
+      << "Commands:\n"
+      << "  dump    Parse bitstream files and dump the syntax of all packets as JSON Lines or CSV\n"
+      << "  hrd     Check the HRD buffer conformance of bitstream files\n"
+      << "  bench   Measure the decoding throughput of bitstream files\n"
+      << "  export  Export the frames of a bitstream or raw file as raw YUV/RGB, Y4M or PNG\n"
+      << "\n"
+      << "Use YUViewCmd <command> --help for the options of a command.\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName("YUViewCmd");
+  QCoreApplication::setApplicationVersion(QString::fromUtf8(YUVIEW_VERSION));
+  QCoreApplication::setOrganizationName("Institut für Nachrichtentechnik, RWTH Aachen University");
+  QCoreApplication::setOrganizationDomain("ient.rwth-aachen.de");
+
+  const auto args = app.arguments();
+  if (args.size() < 2)
+  {
+    printUsage();
+    return 1;
+  }
+
+  const auto command = args[1];
+  const auto commandArgs = args.mid(1);
+  if (command == "dump")
+    return runCommandDump(commandArgs);
+  if (command == "hrd")
+    return runCommandHRD(commandArgs);
+  if (command == "bench")
+    return runCommandBenchmark(commandArgs);
+  if (command == "export")
+    return runCommandExport(commandArgs);
+
+  printUsage();
+  return (command == "--help" || command == "-h") ? 0 : 1;
+}
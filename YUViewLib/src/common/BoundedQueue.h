@@ -0,0 +1,95 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+#include <deque>
+
+/* A queue with a maximum number of entries to pass data between the threads of a pipeline.
+ * push blocks while the queue is full and pop blocks while it is empty. This way, a fast producer
+ * can never run ahead of a slow consumer by more than the capacity of the queue.
+ * After close(), push fails and pop returns the remaining entries before it fails.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+  explicit BoundedQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+  // Returns false if the queue was closed
+  bool push(T value)
+  {
+    QMutexLocker lock(&this->mutex);
+    while (this->entries.size() >= this->capacity && !this->closed)
+      this->notFull.wait(&this->mutex);
+    if (this->closed)
+      return false;
+    this->entries.push_back(std::move(value));
+    this->notEmpty.wakeOne();
+    return true;
+  }
+
+  // Returns false if the queue was closed and is empty
+  bool pop(T &value)
+  {
+    QMutexLocker lock(&this->mutex);
+    while (this->entries.empty() && !this->closed)
+      this->notEmpty.wait(&this->mutex);
+    if (this->entries.empty())
+      return false;
+    value = std::move(this->entries.front());
+    this->entries.pop_front();
+    this->notFull.wakeOne();
+    return true;
+  }
+
+  void close()
+  {
+    QMutexLocker lock(&this->mutex);
+    this->closed = true;
+    this->notEmpty.wakeAll();
+    this->notFull.wakeAll();
+  }
+
+private:
+  const size_t capacity;
+  std::deque<T> entries;
+  bool closed {false};
+
+  QMutex mutex;
+  QWaitCondition notFull;
+  QWaitCondition notEmpty;
+};
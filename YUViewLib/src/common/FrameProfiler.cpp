@@ -0,0 +1,263 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FrameProfiler.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+
+struct FrameProfiler::ThreadBuffer
+{
+  struct Slot
+  {
+    std::atomic<const char*> name {nullptr};
+    std::atomic<int64_t> startNs {0};
+    std::atomic<int64_t> endNs {0};
+    std::atomic<int64_t> frameIdx {-1};
+  };
+
+  Qt::HANDLE threadHandle {nullptr};
+  int threadId {0};
+  // Guarded by the threadBufferMutex of the profiler
+  QString threadName;
+
+  // The writing thread increments startedCount before it overwrites a slot and writtenCount when it is done.
+  // A reader can thereby detect the slots that were overwritten while it copied them.
+  std::atomic<uint64_t> startedCount {0};
+  std::atomic<uint64_t> writtenCount {0};
+  // Spans before this count were cleared
+  std::atomic<uint64_t> clearedCount {0};
+  std::array<Slot, FrameProfiler::RING_SIZE> slots;
+};
+
+namespace
+{
+
+// Every profiler gets a unique serial so that the per thread lookup below never matches a deleted profiler
+std::atomic<uint64_t> profilerSerialCounter {0};
+
+struct ThreadBufferLookup
+{
+  uint64_t profilerSerial {0};
+  void *buffer {nullptr};
+};
+thread_local ThreadBufferLookup lastThreadBufferLookup;
+
+} // namespace
+
+FrameProfiler &FrameProfiler::instance()
+{
+  static FrameProfiler profiler;
+  return profiler;
+}
+
+FrameProfiler::FrameProfiler() : serial(++profilerSerialCounter)
+{
+}
+
+FrameProfiler::~FrameProfiler()
+{
+  qDeleteAll(this->threadBuffers);
+}
+
+int64_t FrameProfiler::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+FrameProfiler::ThreadBuffer *FrameProfiler::getThreadBuffer()
+{
+  if (lastThreadBufferLookup.profilerSerial == this->serial)
+    return static_cast<ThreadBuffer*>(lastThreadBufferLookup.buffer);
+
+  QMutexLocker lock(&this->threadBufferMutex);
+
+  // If a thread ended, a new thread may get the same handle. It continues in the buffer of the old thread.
+  const auto threadHandle = QThread::currentThreadId();
+  ThreadBuffer *buffer = nullptr;
+  for (ThreadBuffer *b : this->threadBuffers)
+    if (b->threadHandle == threadHandle)
+      buffer = b;
+  if (buffer == nullptr)
+  {
+    buffer = new ThreadBuffer;
+    buffer->threadHandle = threadHandle;
+    buffer->threadId = ++this->threadIdCounter;
+    this->threadBuffers.append(buffer);
+  }
+
+  const auto app = QCoreApplication::instance();
+  const auto objectName = QThread::currentThread()->objectName();
+  if (!objectName.isEmpty())
+    buffer->threadName = objectName;
+  else if (app && QThread::currentThread() == app->thread())
+    buffer->threadName = "Main";
+  else
+    buffer->threadName = QString("Thread %1").arg(buffer->threadId);
+
+  lastThreadBufferLookup.profilerSerial = this->serial;
+  lastThreadBufferLookup.buffer = buffer;
+  return buffer;
+}
+
+void FrameProfiler::setThreadName(const QString &name)
+{
+  ThreadBuffer *buffer = this->getThreadBuffer();
+  QMutexLocker lock(&this->threadBufferMutex);
+  buffer->threadName = name;
+}
+
+void FrameProfiler::addSpan(const char *name, int64_t startNs, int64_t endNs, int64_t frameIdx)
+{
+  ThreadBuffer *buffer = this->getThreadBuffer();
+
+  // Only this thread writes to the buffer
+  const uint64_t idx = buffer->writtenCount.load(std::memory_order_relaxed);
+  buffer->startedCount.store(idx + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  ThreadBuffer::Slot &slot = buffer->slots[idx % RING_SIZE];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.startNs.store(startNs, std::memory_order_relaxed);
+  slot.endNs.store(endNs, std::memory_order_relaxed);
+  slot.frameIdx.store(frameIdx, std::memory_order_relaxed);
+
+  buffer->writtenCount.store(idx + 1, std::memory_order_release);
+}
+
+QList<FrameProfiler::ThreadSpans> FrameProfiler::getSpans(int64_t sinceNs) const
+{
+  QMutexLocker lock(&this->threadBufferMutex);
+
+  QList<ThreadSpans> threads;
+  for (const ThreadBuffer *buffer : this->threadBuffers)
+  {
+    const uint64_t written = buffer->writtenCount.load(std::memory_order_acquire);
+    const uint64_t first = std::max(buffer->clearedCount.load(std::memory_order_relaxed), (written > RING_SIZE) ? written - RING_SIZE : 0);
+
+    QVector<Span> spans;
+    spans.reserve(int(written - first));
+    for (uint64_t i = first; i < written; i++)
+    {
+      const ThreadBuffer::Slot &slot = buffer->slots[i % RING_SIZE];
+      Span span;
+      span.name = slot.name.load(std::memory_order_relaxed);
+      span.startNs = slot.startNs.load(std::memory_order_relaxed);
+      span.endNs = slot.endNs.load(std::memory_order_relaxed);
+      span.frameIdx = slot.frameIdx.load(std::memory_order_relaxed);
+      spans.append(span);
+    }
+
+    // Drop the spans that the thread may have overwritten while we copied them
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t started = buffer->startedCount.load(std::memory_order_relaxed);
+    const uint64_t firstValid = (started > RING_SIZE) ? started - RING_SIZE : 0;
+    if (firstValid > first)
+      spans.remove(0, std::min(spans.size(), int(firstValid - first)));
+
+    spans.erase(std::remove_if(spans.begin(), spans.end(), [sinceNs](const Span &s) { return s.endNs < sinceNs; }), spans.end());
+    if (spans.isEmpty())
+      continue;
+
+    ThreadSpans thread;
+    thread.threadId = buffer->threadId;
+    thread.threadName = buffer->threadName;
+    thread.spans = spans;
+    threads.append(thread);
+  }
+  return threads;
+}
+
+void FrameProfiler::clear()
+{
+  QMutexLocker lock(&this->threadBufferMutex);
+  for (ThreadBuffer *buffer : this->threadBuffers)
+    buffer->clearedCount.store(buffer->writtenCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+QByteArray FrameProfiler::toChromeTrace(const QList<ThreadSpans> &threads)
+{
+  // The timestamps are in microseconds relative to the first span
+  int64_t originNs = -1;
+  for (const auto &thread : threads)
+    for (const auto &span : thread.spans)
+      if (originNs < 0 || span.startNs < originNs)
+        originNs = span.startNs;
+
+  QJsonArray events;
+  for (const auto &thread : threads)
+  {
+    QJsonObject threadName;
+    threadName["name"] = "thread_name";
+    threadName["ph"] = "M";
+    threadName["pid"] = 1;
+    threadName["tid"] = thread.threadId;
+    threadName["args"] = QJsonObject({{"name", thread.threadName}});
+    events.append(threadName);
+
+    for (const auto &span : thread.spans)
+    {
+      QJsonObject event;
+      event["name"] = QString::fromLatin1(span.name);
+      event["cat"] = "YUView";
+      event["ph"] = "X";
+      event["ts"] = double(span.startNs - originNs) / 1000.0;
+      event["dur"] = double(span.endNs - span.startNs) / 1000.0;
+      event["pid"] = 1;
+      event["tid"] = thread.threadId;
+      if (span.frameIdx >= 0)
+        event["args"] = QJsonObject({{"frame", double(span.frameIdx)}});
+      events.append(event);
+    }
+  }
+
+  QJsonObject root;
+  root["traceEvents"] = events;
+  root["displayTimeUnit"] = "ms";
+  return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool FrameProfiler::exportChromeTrace(const QString &fileName, int64_t sinceNs) const
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  const auto data = toChromeTrace(this->getSpans(sinceNs));
+  return file.write(data) == data.size();
+}
@@ -0,0 +1,142 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/* A lightweight profiler for the hot path of loading and showing frames (reading, decoding, conversion,
+ * caching, painting and the playback timer).
+ * Code is instrumented with FRAME_PROFILER_SCOPE("name") which records the start and end time of the scope
+ * as a span. Every thread writes its spans into its own ring buffer without locking, so the last
+ * RING_SIZE spans of each thread are kept. If the profiler is disabled (the default), a scope only checks
+ * an atomic flag. The spans can be shown in a timeline or exported in the Chrome trace event format
+ * (chrome://tracing or https://ui.perfetto.dev).
+ */
+class FrameProfiler
+{
+public:
+  static FrameProfiler &instance();
+
+  FrameProfiler();
+  ~FrameProfiler();
+  FrameProfiler(const FrameProfiler&) = delete;
+  FrameProfiler &operator=(const FrameProfiler&) = delete;
+
+  void setEnabled(bool enabled) { this->enabled.store(enabled, std::memory_order_relaxed); }
+  bool isEnabled() const { return this->enabled.load(std::memory_order_relaxed); }
+
+  // The monotonic time (in ns) that the spans are recorded with
+  static int64_t now();
+
+  // Set the name of the calling thread. By default, the objectName of the QThread is used.
+  void setThreadName(const QString &name);
+
+  // Record a span in the ring buffer of the calling thread. The name must be a string literal (only the pointer is kept).
+  void addSpan(const char *name, int64_t startNs, int64_t endNs, int64_t frameIdx = -1);
+
+  struct Span
+  {
+    const char *name {nullptr};
+    int64_t startNs {0};
+    int64_t endNs {0};
+    int64_t frameIdx {-1};
+  };
+  struct ThreadSpans
+  {
+    int threadId {0};
+    QString threadName;
+    QVector<Span> spans;
+  };
+  // Get the spans of all threads that ended at or after the given time (oldest first).
+  // This can be called from any thread while spans are recorded.
+  QList<ThreadSpans> getSpans(int64_t sinceNs = 0) const;
+  // Forget all spans that were recorded so far
+  void clear();
+
+  static QByteArray toChromeTrace(const QList<ThreadSpans> &threads);
+  // Write the spans that ended at or after the given time to a file. Returns false if writing failed.
+  bool exportChromeTrace(const QString &fileName, int64_t sinceNs = 0) const;
+
+  // The number of spans that are kept per thread
+  static const int RING_SIZE = 4096;
+
+  // Record the duration of the scope (if the profiler is enabled when the scope is entered)
+  class Scope
+  {
+  public:
+    Scope(const char *name, int64_t frameIdx = -1, FrameProfiler &profiler = FrameProfiler::instance())
+      : profiler(profiler), name(name), frameIdx(frameIdx)
+    {
+      if (profiler.isEnabled())
+        this->startNs = FrameProfiler::now();
+    }
+    ~Scope()
+    {
+      if (this->startNs >= 0)
+        this->profiler.addSpan(this->name, this->startNs, FrameProfiler::now(), this->frameIdx);
+    }
+    Scope(const Scope&) = delete;
+    Scope &operator=(const Scope&) = delete;
+
+  private:
+    FrameProfiler &profiler;
+    const char *name;
+    int64_t frameIdx;
+    int64_t startNs {-1};
+  };
+
+private:
+  struct ThreadBuffer;
+  ThreadBuffer *getThreadBuffer();
+
+  std::atomic<bool> enabled {false};
+  const uint64_t serial;
+
+  // The buffers of all threads that recorded a span. A buffer is never removed because its thread may still write to it.
+  mutable QMutex threadBufferMutex;
+  QList<ThreadBuffer*> threadBuffers;
+  int threadIdCounter {0};
+};
+
+#define FRAME_PROFILER_CONCAT_(a, b) a##b
+#define FRAME_PROFILER_CONCAT(a, b) FRAME_PROFILER_CONCAT_(a, b)
+// Profile the enclosing scope: FRAME_PROFILER_SCOPE("Convert YUV") or FRAME_PROFILER_SCOPE("Decode", frameIdx)
+#define FRAME_PROFILER_SCOPE(...) FrameProfiler::Scope FRAME_PROFILER_CONCAT(frameProfilerScope, __LINE__)(__VA_ARGS__)
@@ -0,0 +1,186 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PlaybackClock.h"
+
+#include <QJsonArray>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// Qt timers have a resolution of 1 ms. A timer that fires slightly before the due time should still present the frame.
+const int64_t DUE_TOLERANCE_NS = 500000;
+
+// Lower limit for the frame rate (100 seconds per frame)
+const double MIN_FRAME_RATE = 0.01;
+
+} // namespace
+
+void PlaybackClock::start(double frameRate, int64_t nowNs)
+{
+  this->frameRate = std::max(frameRate, MIN_FRAME_RATE);
+  this->anchorNs = nowNs;
+  this->presentedFrame = 0;
+}
+
+void PlaybackClock::setFrameRate(double frameRate)
+{
+  frameRate = std::max(frameRate, MIN_FRAME_RATE);
+  if (frameRate == this->frameRate)
+    return;
+  this->anchorNs = this->getDueTime(this->presentedFrame);
+  this->presentedFrame = 0;
+  this->frameRate = frameRate;
+}
+
+int64_t PlaybackClock::getFramePeriodNs() const
+{
+  return std::llround(1e9 / this->frameRate);
+}
+
+int64_t PlaybackClock::getNrFramesDue(int64_t nowNs) const
+{
+  const auto framesSinceAnchor = int64_t(std::floor(double(nowNs + DUE_TOLERANCE_NS - this->anchorNs) * this->frameRate / 1e9));
+  return std::max(int64_t(0), framesSinceAnchor - this->presentedFrame);
+}
+
+int64_t PlaybackClock::getNsUntilNextFrame(int64_t nowNs) const
+{
+  return std::max(int64_t(0), this->getDueTime(this->presentedFrame + 1) - nowNs);
+}
+
+int64_t PlaybackClock::advance(int64_t nrFrames, int64_t nowNs)
+{
+  this->presentedFrame += nrFrames;
+  return nowNs - this->getDueTime(this->presentedFrame);
+}
+
+void PlaybackClock::setNextFrameDue(int64_t timeNs)
+{
+  this->anchorNs = timeNs - this->getFramePeriodNs();
+  this->presentedFrame = 0;
+}
+
+int64_t PlaybackClock::getDueTime(int64_t frame) const
+{
+  return this->anchorNs + std::llround(double(frame) * 1e9 / this->frameRate);
+}
+
+void PlaybackStatistics::addPresentedFrame(int64_t latencyNs)
+{
+  // A frame that is presented a bit early (within the timer tolerance) is on time
+  latencyNs = std::max(int64_t(0), latencyNs);
+  this->nrPresentedFrames++;
+  this->latencySumNs += latencyNs;
+  this->maxLatencyNs = std::max(this->maxLatencyNs, latencyNs);
+  const auto bin = int(double(latencyNs) / 1e6 / LATENCY_BIN_MS);
+  this->latencyHistogram[std::min(bin, NR_LATENCY_BINS - 1)]++;
+}
+
+void PlaybackStatistics::addStall(int64_t durationNs)
+{
+  this->nrStalls++;
+  this->stallNs += durationNs;
+  this->maxStallNs = std::max(this->maxStallNs, durationNs);
+}
+
+double PlaybackStatistics::getMeanLatencyMs() const
+{
+  if (this->nrPresentedFrames == 0)
+    return 0.0;
+  return double(this->latencySumNs) / double(this->nrPresentedFrames) / 1e6;
+}
+
+double PlaybackStatistics::getLatencyPercentileMs(double percentile) const
+{
+  if (this->nrPresentedFrames == 0)
+    return 0.0;
+  const auto rank = std::max(int64_t(1), int64_t(std::ceil(percentile / 100.0 * double(this->nrPresentedFrames))));
+  int64_t count = 0;
+  for (int bin = 0; bin < NR_LATENCY_BINS - 1; bin++)
+  {
+    count += this->latencyHistogram[bin];
+    if (count >= rank)
+      return std::min((bin + 1) * LATENCY_BIN_MS, this->getMaxLatencyMs());
+  }
+  return this->getMaxLatencyMs();
+}
+
+QString PlaybackStatistics::toString() const
+{
+  return QString("Frames presented: %1\n"
+                 "Presentation latency: mean %2 ms, p50 %3 ms, p99 %4 ms, max %5 ms\n"
+                 "Frames dropped: %6\n"
+                 "Frames held (shown late): %7\n"
+                 "Stalls: %8 (%9 s in total, longest %10 ms)")
+    .arg(this->nrPresentedFrames)
+    .arg(this->getMeanLatencyMs(), 0, 'f', 2)
+    .arg(this->getLatencyPercentileMs(50), 0, 'f', 1)
+    .arg(this->getLatencyPercentileMs(99), 0, 'f', 1)
+    .arg(this->getMaxLatencyMs(), 0, 'f', 1)
+    .arg(this->nrDroppedFrames)
+    .arg(this->nrHeldFrames)
+    .arg(this->nrStalls)
+    .arg(this->getStallSeconds(), 0, 'f', 2)
+    .arg(this->getMaxStallMs(), 0, 'f', 1);
+}
+
+QJsonObject PlaybackStatistics::toJSON() const
+{
+  QJsonObject json;
+  json["framesPresented"] = double(this->nrPresentedFrames);
+  json["framesDropped"] = double(this->nrDroppedFrames);
+  json["framesHeld"] = double(this->nrHeldFrames);
+
+  QJsonObject latency;
+  latency["mean"] = this->getMeanLatencyMs();
+  latency["p50"] = this->getLatencyPercentileMs(50);
+  latency["p90"] = this->getLatencyPercentileMs(90);
+  latency["p99"] = this->getLatencyPercentileMs(99);
+  latency["max"] = this->getMaxLatencyMs();
+  latency["binMs"] = LATENCY_BIN_MS;
+  QJsonArray histogram;
+  for (const auto count : this->latencyHistogram)
+    histogram.append(double(count));
+  latency["histogram"] = histogram;
+  json["latencyMs"] = latency;
+
+  QJsonObject stalls;
+  stalls["count"] = double(this->nrStalls);
+  stalls["seconds"] = this->getStallSeconds();
+  stalls["maxMs"] = this->getMaxStallMs();
+  json["stalls"] = stalls;
+  return json;
+}
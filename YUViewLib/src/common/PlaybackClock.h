@@ -0,0 +1,121 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+#include <array>
+#include <cstdint>
+
+/* Schedule the presentation of frames on a monotonic clock.
+ * Frame n after the anchor is due at anchor + n / frameRate. The due times are computed from the
+ * anchor and not by adding up (integer millisecond) timer intervals, so the playback does not drift:
+ * 59.94 fps are played at 59.94 fps and not at the 62.5 fps of a 16 ms timer.
+ * All times are in nanoseconds of a monotonic clock (e.g. QElapsedTimer::nsecsElapsed).
+ */
+class PlaybackClock
+{
+public:
+  // Start the schedule. The current frame is presented now, the next one is due one frame period later.
+  void start(double frameRate, int64_t nowNs);
+  // Change the frame rate. The schedule continues from the due time of the last presented frame.
+  void setFrameRate(double frameRate);
+  double getFrameRate() const { return this->frameRate; }
+  int64_t getFramePeriodNs() const;
+
+  // The number of frames that are due since the last presented frame.
+  // 0: The next frame is not due yet. 1: Present the next frame. >1: The presentation is late.
+  int64_t getNrFramesDue(int64_t nowNs) const;
+  // The time when the next frame is due (relative to now). Use this to start the timer for the next frame.
+  int64_t getNsUntilNextFrame(int64_t nowNs) const;
+
+  // Advance the schedule by the given number of frames. Returns how late the last of these frames was presented.
+  int64_t advance(int64_t nrFrames, int64_t nowNs);
+  // Move the schedule so that the next frame is due at the given time. Use this to hold (continue with the
+  // next frame instead of dropping frames) after the presentation was late or stalled.
+  void setNextFrameDue(int64_t timeNs);
+
+private:
+  int64_t getDueTime(int64_t frame) const;
+
+  double frameRate {20.0};
+  int64_t anchorNs {0};
+  // The last presented frame (counted from the anchor)
+  int64_t presentedFrame {0};
+};
+
+/* Frame pacing statistics of the playback: The presentation latency of each frame (how late it was shown
+ * relative to its due time), the number of dropped frames, frames that were held (shown late without
+ * dropping) and the duration of stalls (waiting for frames to be loaded).
+ */
+class PlaybackStatistics
+{
+public:
+  void reset() { *this = PlaybackStatistics(); }
+
+  void addPresentedFrame(int64_t latencyNs);
+  void addDroppedFrames(int64_t nrFrames) { this->nrDroppedFrames += nrFrames; }
+  void addHeldFrame() { this->nrHeldFrames++; }
+  void addStall(int64_t durationNs);
+
+  int64_t getNrPresentedFrames() const { return this->nrPresentedFrames; }
+  int64_t getNrDroppedFrames() const { return this->nrDroppedFrames; }
+  int64_t getNrHeldFrames() const { return this->nrHeldFrames; }
+  int64_t getNrStalls() const { return this->nrStalls; }
+  double getStallSeconds() const { return double(this->stallNs) / 1e9; }
+  double getMaxStallMs() const { return double(this->maxStallNs) / 1e6; }
+  double getMeanLatencyMs() const;
+  // The percentile from the latency histogram (upper edge of the bin). Latencies above the last bin are reported as the maximum.
+  double getLatencyPercentileMs(double percentile) const;
+  double getMaxLatencyMs() const { return double(this->maxLatencyNs) / 1e6; }
+
+  // The latency histogram has bins of LATENCY_BIN_MS. The last bin collects all larger latencies.
+  static const int NR_LATENCY_BINS = 100;
+  static constexpr double LATENCY_BIN_MS = 0.5;
+  const std::array<int64_t, NR_LATENCY_BINS> &getLatencyHistogram() const { return this->latencyHistogram; }
+
+  QString toString() const;
+  QJsonObject toJSON() const;
+
+private:
+  int64_t nrPresentedFrames {0};
+  int64_t nrDroppedFrames {0};
+  int64_t nrHeldFrames {0};
+  int64_t nrStalls {0};
+  int64_t stallNs {0};
+  int64_t maxStallNs {0};
+  int64_t latencySumNs {0};
+  int64_t maxLatencyNs {0};
+  std::array<int64_t, NR_LATENCY_BINS> latencyHistogram {};
+};
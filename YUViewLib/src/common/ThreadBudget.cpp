@@ -0,0 +1,158 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ThreadBudget.h"
+
+#include <algorithm>
+#include <QSettings>
+#include <QThread>
+#include <QThreadPool>
+
+#include "common/functions.h"
+
+#define THREADBUDGET_DEBUG_OUTPUT 0
+#if THREADBUDGET_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_THREADBUDGET qDebug
+#else
+#define DEBUG_THREADBUDGET(fmt,...) ((void)0)
+#endif
+
+ThreadBudget &ThreadBudget::instance()
+{
+  static ThreadBudget budget;
+  return budget;
+}
+
+ThreadBudget::ThreadBudget()
+{
+  this->updateSettings();
+}
+
+void ThreadBudget::updateSettings()
+{
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  const bool cachingEnabled = settings.value("Enabled", true).toBool();
+  const bool userNrThreads = settings.value("SetNrThreads", false).toBool();
+  const int nrThreadsSetting = settings.value("NrThreads", functions::getOptimalThreadCount()).toInt();
+  settings.endGroup();
+
+  QMutexLocker lock(&this->accessMutex);
+
+  // If the user limited the number of threads, this is the budget for everything. Otherwise, use all cores.
+  // More threads than cores only make the decoders compete for the cores.
+  const int nrHardwareThreads = std::max(QThread::idealThreadCount(), 1);
+  this->totalThreads = userNrThreads ? std::min(nrThreadsSetting, nrHardwareThreads) : nrHardwareThreads;
+  if (this->totalThreads <= 0)
+    this->totalThreads = 1;
+
+  this->nrCachingThreads = userNrThreads ? nrThreadsSetting : int(functions::getOptimalThreadCount());
+  if (this->nrCachingThreads <= 0)
+    this->nrCachingThreads = 1;
+  if (!cachingEnabled)
+    this->nrCachingThreads = 0;
+
+  DEBUG_THREADBUDGET("ThreadBudget::updateSettings total %d caching %d", this->totalThreads, this->nrCachingThreads);
+}
+
+void ThreadBudget::setTotalThreads(int nrThreads)
+{
+  QMutexLocker lock(&this->accessMutex);
+  this->totalThreads = std::max(nrThreads, 1);
+  this->nrCachingThreads = std::min(this->nrCachingThreads, this->totalThreads);
+  DEBUG_THREADBUDGET("ThreadBudget::setTotalThreads total %d caching %d", this->totalThreads, this->nrCachingThreads);
+}
+
+int ThreadBudget::getTotalThreads() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->totalThreads;
+}
+
+int ThreadBudget::getNrCachingThreads() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->nrCachingThreads;
+}
+
+int ThreadBudget::getNrThreadsPerDecoder() const
+{
+  QMutexLocker lock(&this->accessMutex);
+
+  // Split the budget evenly between all decoders. Compressed items are cached by only one worker
+  // which spends its time waiting for the caching decoder, so the caching workers are not subtracted.
+  const int nrDecoders = std::max(1, this->nrRegisteredDecoders);
+  const int threads = this->totalThreads / nrDecoders;
+  return std::max(1, std::min(threads, int(maxThreadsPerDecoder)));
+}
+
+int ThreadBudget::getNrRegisteredDecoders() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->nrRegisteredDecoders;
+}
+
+void ThreadBudget::limitThreadPool(QThreadPool *pool) const
+{
+  const int nrThreads = this->getTotalThreads();
+  if (pool->maxThreadCount() != nrThreads)
+  {
+    DEBUG_THREADBUDGET("ThreadBudget::limitThreadPool %d threads", nrThreads);
+    pool->setMaxThreadCount(nrThreads);
+  }
+}
+
+ThreadBudget::Registration::Registration()
+{
+  auto &budget = ThreadBudget::instance();
+  QMutexLocker lock(&budget.accessMutex);
+  budget.nrRegisteredDecoders++;
+  DEBUG_THREADBUDGET("ThreadBudget::Registration %d decoders", budget.nrRegisteredDecoders);
+}
+
+ThreadBudget::Registration::~Registration()
+{
+  this->setActive(false);
+}
+
+void ThreadBudget::Registration::setActive(bool active)
+{
+  if (active == this->active)
+    return;
+  this->active = active;
+
+  auto &budget = ThreadBudget::instance();
+  QMutexLocker lock(&budget.accessMutex);
+  budget.nrRegisteredDecoders += active ? 1 : -1;
+  DEBUG_THREADBUDGET("ThreadBudget::Registration::setActive %d - %d decoders", active, budget.nrRegisteredDecoders);
+}
@@ -0,0 +1,94 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QMutex>
+
+class QThreadPool;
+
+/* The thread budget distributes the CPU threads that YUView may keep busy between the caching
+ * workers of the videoCache and the internal threads (frame/slice/tile/wavefront) of all decoders.
+ * Every decoder holds a Registration for as long as it exists. When a decoder (re)allocates its
+ * library decoder, it asks for its current share of the budget. This way, the shares are rebalanced
+ * whenever items are added or removed, a decoder is reset (e.g. when seeking) or the settings change.
+ * The thread pools that split the work on one frame (statistics stripes, row band conversion) are
+ * limited to the total budget.
+ */
+class ThreadBudget
+{
+public:
+  static ThreadBudget &instance();
+
+  // Read the thread settings (VideoCache/SetNrThreads, NrThreads and Enabled). The total is at most the number of hardware threads.
+  void updateSettings();
+  // Override the settings with a fixed number of threads (e.g. from the command line)
+  void setTotalThreads(int nrThreads);
+
+  // The total number of threads that may be kept busy
+  int getTotalThreads() const;
+  // The number of caching worker threads that the videoCache should run
+  int getNrCachingThreads() const;
+  // The number of internal threads that one decoder should use right now
+  int getNrThreadsPerDecoder() const;
+  int getNrRegisteredDecoders() const;
+
+  // Limit the given pool to the total number of threads. Call this before the pool is used because
+  // the budget changes with the settings.
+  void limitThreadPool(QThreadPool *pool) const;
+
+  // The maximum number of internal threads of one decoder. More threads do not scale well for a single stream.
+  static const int maxThreadsPerDecoder = 16;
+
+  class Registration
+  {
+  public:
+    Registration();
+    ~Registration();
+    Registration(const Registration&) = delete;
+    Registration &operator=(const Registration&) = delete;
+
+    // An inactive registration is not counted when the threads are split between the decoders
+    void setActive(bool active);
+
+  private:
+    bool active {true};
+  };
+
+private:
+  ThreadBudget();
+
+  mutable QMutex accessMutex;
+  int totalThreads {1};
+  int nrCachingThreads {1};
+  int nrRegisteredDecoders {0};
+};
@@ -35,16 +35,26 @@
 #ifdef Q_OS_MAC
 #include <sys/types.h>
 #include <sys/sysctl.h>
+#include <sys/resource.h>
 #elif defined(Q_OS_UNIX)
 #include <unistd.h>
+#include <sys/resource.h>
 #elif defined(Q_OS_WIN32)
 #include <windows.h>
+// Use K32GetProcessMemoryInfo from kernel32 so that psapi does not have to be linked
+#define PSAPI_VERSION 2
+#include <psapi.h>
 #endif
 
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QIcon>
 #include <QSettings>
 #include <QThread>
 
+#include <algorithm>
+
 using namespace YUView;
 
 bool functions::isInputFormatTypeAnnexB(inputFormat format) 
@@ -133,6 +143,57 @@ unsigned int functions::systemMemorySizeInMB()
   return memorySizeInMB;
 }
 
+unsigned int functions::peakProcessMemoryInMB()
+{
+#ifdef Q_OS_LINUX
+  // ru_maxrss is not lowered by resetPeakProcessMemory. The high water mark in the status is.
+  QFile status("/proc/self/status");
+  if (status.open(QIODevice::ReadOnly))
+  {
+    for (const auto &line : status.readAll().split('\n'))
+    {
+      if (!line.startsWith("VmHWM:"))
+        continue;
+      bool ok;
+      const auto kiloBytes = line.mid(6).trimmed().split(' ').first().toULongLong(&ok);
+      if (ok)
+        return (unsigned int)(kiloBytes >> 10);
+    }
+  }
+#endif
+#if defined Q_OS_MAC || defined Q_OS_UNIX
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+  #ifdef Q_OS_MAC
+  // On macOS, ru_maxrss is in bytes. Everywhere else it is in kilobytes.
+  return (unsigned int)(usage.ru_maxrss >> 20);
+  #else
+  return (unsigned int)(usage.ru_maxrss >> 10);
+  #endif
+#elif defined Q_OS_WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return (unsigned int)(counters.PeakWorkingSetSize >> 20);
+#else
+  return 0;
+#endif
+}
+
+bool functions::resetPeakProcessMemory()
+{
+#ifdef Q_OS_LINUX
+  // Writing 5 resets the high water mark of the resident memory (see proc(5))
+  QFile clearRefs("/proc/self/clear_refs");
+  if (!clearRefs.open(QIODevice::WriteOnly | QIODevice::Unbuffered))
+    return false;
+  return clearRefs.write("5") == 1;
+#else
+  return false;
+#endif
+}
+
 QIcon functions::convertIcon(QString iconPath)
 {
   QSettings settings;
@@ -326,3 +387,53 @@ QString functions::formatDataSize(double size, bool isBits)
 
   return valueString;
 }
+
+QStringList functions::getNumberedFileSequence(const QString &filePath, const QStringList &fileNamesInDir)
+{
+  // See if the filename ends with a number
+  QFileInfo fi(filePath);
+  QString base = fi.baseName();
+
+  int lastN = 0;
+  for (int i = base.count() - 1; i >= 0; i--)
+  {
+    // Get the char and see if it is a number
+    if (base[i].isDigit())
+      lastN++;
+    else
+      break;
+  }
+
+  if (lastN == 0)
+    // No number at the end of the file name
+    return QStringList() << filePath;
+
+  // The base name without the indexing number at the end
+  QString absBaseName = base.left(base.count() - lastN);
+
+  // Get all files in the directory that have the same pattern.
+  QDir currentDir(fi.path());
+  QVector<QPair<qint64, QString>> numberedFiles;
+  for (auto &fileName : fileNamesInDir)
+  {
+    QFileInfo file(fileName);
+    if (file.baseName().startsWith(absBaseName) && file.suffix() == fi.suffix())
+    {
+      // Check if the remaining part is all digits
+      QString remainder = file.baseName().right(file.baseName().length() - absBaseName.length());
+      bool isNumber;
+      qint64 num = remainder.toLongLong(&isNumber);
+      if (isNumber && num >= 0)
+        numberedFiles.append(qMakePair(num, currentDir.absoluteFilePath(file.fileName())));
+    }
+  }
+
+  // Sort by the number (and not by the name) so that the order is also right if the number of digits
+  // changes (image9.png, image10.png). If two files have the same number (image1.png, image01.png), only the first one is used.
+  std::sort(numberedFiles.begin(), numberedFiles.end());
+  QStringList files;
+  for (int i = 0; i < numberedFiles.size(); i++)
+    if (i == 0 || numberedFiles[i].first != numberedFiles[i - 1].first)
+      files.append(numberedFiles[i].second);
+  return files;
+}
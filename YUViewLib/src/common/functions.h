@@ -103,6 +103,13 @@ unsigned int getOptimalThreadCount();
 // This function is thread safe and inexpensive to call.
 unsigned int systemMemorySizeInMB();
 
+// Returns the peak resident memory (maximum resident set size) of this process in megabytes
+// or 0 if it can not be determined on this platform.
+unsigned int peakProcessMemoryInMB();
+// Reset the peak resident memory of this process to the current resident memory so that peakProcessMemoryInMB
+// returns the peak from now on. This is only supported on Linux. Returns false if the peak could not be reset.
+bool resetPeakProcessMemory();
+
 // These are the names of the supported themes
 QStringList getThemeNameList();
 // Get the name of the theme in the resource file that we will load
@@ -120,4 +127,9 @@ QPixmap convertPixmap(QString pixmapPath);
 // From Qt 5.10 there is a built in function (QLocale::formattedDataSize). But we want to be 5.9 compatible.
 QString formatDataSize(double size, bool isBits = false);
 
+// Get the files of a numbered sequence (e.g. image000.png, image001.png ...) that the given file belongs to.
+// fileNamesInDir are the names of all files in the directory of filePath. The files are sorted by their number
+// and the absolute paths are returned. If the file name does not end with a number, only filePath is returned.
+QStringList getNumberedFileSequence(const QString &filePath, const QStringList &fileNamesInDir);
+
 } // namespace functions
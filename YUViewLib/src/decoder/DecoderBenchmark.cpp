@@ -0,0 +1,172 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DecoderBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+
+#include "common/functions.h"
+#include "common/ThreadBudget.h"
+#include "decoder/FileDecoder.h"
+
+using namespace YUView;
+
+#define DECODERBENCHMARK_DEBUG_OUTPUT 0
+#if DECODERBENCHMARK_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_BENCHMARK qDebug
+#else
+#define DEBUG_BENCHMARK(fmt,...) ((void)0)
+#endif
+
+namespace
+{
+
+double nsToSeconds(qint64 ns)
+{
+  return double(ns) / 1000000000.0;
+}
+
+} // namespace
+
+double DecoderBenchmark::Result::getLatencyPercentileMs(double percentile) const
+{
+  if (this->frameLatenciesMs.isEmpty())
+    return 0.0;
+  auto sorted = this->frameLatenciesMs;
+  std::sort(sorted.begin(), sorted.end());
+  const auto rank = int(std::ceil(percentile / 100.0 * sorted.size())) - 1;
+  return sorted.at(std::max(0, std::min(rank, sorted.size() - 1)));
+}
+
+QJsonObject DecoderBenchmark::Result::toJSON() const
+{
+  QJsonObject json;
+  json["file"] = this->fileName;
+  json["decoder"] = this->decoderName;
+  json["success"] = this->success;
+  if (!this->error.isEmpty())
+    json["error"] = this->error;
+  json["threads"] = this->nrThreads;
+  json["requestedThreads"] = this->requestedNrThreads;
+  json["width"] = this->frameSize.width();
+  json["height"] = this->frameSize.height();
+  json["frames"] = double(this->nrFrames);
+  json["seconds"] = this->seconds;
+  json["fps"] = this->getFramesPerSecond();
+
+  QJsonObject latency;
+  latency["p50"] = this->getLatencyPercentileMs(50);
+  latency["p90"] = this->getLatencyPercentileMs(90);
+  latency["p99"] = this->getLatencyPercentileMs(99);
+  latency["max"] = this->getLatencyPercentileMs(100);
+  json["latencyMs"] = latency;
+
+  QJsonObject split;
+  split["read"] = this->readSeconds;
+  split["pushData"] = this->pushDataSeconds;
+  split["decodeNextFrame"] = this->decodeNextFrameSeconds;
+  split["getRawFrameData"] = this->getRawFrameDataSeconds;
+  json["secondsSplit"] = split;
+
+  json["peakMemoryMB"] = int(this->peakMemoryMB);
+  json["peakMemoryOfRun"] = this->peakMemoryOfRun;
+  return json;
+}
+
+DecoderBenchmark::Result DecoderBenchmark::runFile(const QString &fileName, int nrThreads)
+{
+  Result result;
+  result.fileName = fileName;
+  result.nrThreads = nrThreads;
+  result.requestedNrThreads = nrThreads;
+  result.peakMemoryOfRun = functions::resetPeakProcessMemory();
+
+  // Every decoder asks the budget for its share of threads when it is allocated. We only run one decoder.
+  ThreadBudget::instance().setTotalThreads(nrThreads);
+
+  // Opening the file (and parsing an AnnexB file for FFmpeg) is not part of the measurement.
+  FileDecoder fileDecoder(this->decoder);
+  if (!fileDecoder.openFile(fileName))
+  {
+    result.error = fileDecoder.getError();
+    return result;
+  }
+  auto dec = fileDecoder.getDecoder();
+  result.decoderName = dec->getDecoderName();
+  // The decoder took its share of the budget when it was allocated
+  result.nrThreads = ThreadBudget::instance().getNrThreadsPerDecoder();
+  result.frameSize = fileDecoder.getFrameSize();
+
+  // Reading from the file, pushing to the decoder and retrieving frames is timed separately
+  QElapsedTimer totalTimer;
+  QElapsedTimer frameTimer;
+  QElapsedTimer timer;
+  qint64 getDataNs = 0;
+  totalTimer.start();
+  frameTimer.start();
+
+  while ((this->maxNrFrames <= 0 || result.nrFrames < this->maxNrFrames) && fileDecoder.decodeNextFrame())
+  {
+    timer.start();
+    const auto data = dec->getRawFrameData();
+    getDataNs += timer.nsecsElapsed();
+    if (data.isEmpty())
+    {
+      result.error = "The decoder returned an empty frame";
+      break;
+    }
+    result.frameLatenciesMs.append(double(frameTimer.nsecsElapsed()) / 1000000.0);
+    frameTimer.start();
+    result.nrFrames++;
+    if (!result.frameSize.isValid())
+      result.frameSize = dec->getFrameSize();
+    DEBUG_BENCHMARK("DecoderBenchmark::runFile frame %d", int(result.nrFrames));
+  }
+  if (result.error.isEmpty())
+    result.error = fileDecoder.getError();
+
+  result.seconds = nsToSeconds(totalTimer.nsecsElapsed());
+  result.readSeconds = nsToSeconds(fileDecoder.getReadNs());
+  result.pushDataSeconds = nsToSeconds(fileDecoder.getPushDataNs());
+  result.decodeNextFrameSeconds = nsToSeconds(fileDecoder.getDecodeNextFrameNs());
+  result.getRawFrameDataSeconds = nsToSeconds(getDataNs);
+  result.peakMemoryMB = functions::peakProcessMemoryInMB();
+  result.success = result.error.isEmpty() && result.nrFrames > 0;
+  if (result.error.isEmpty() && result.nrFrames == 0)
+    result.error = "No frames were decoded";
+  return result;
+}
@@ -0,0 +1,90 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <QSize>
+#include <QString>
+
+#include "common/typedef.h"
+
+/* Decode a bitstream file without any GUI, caching or conversion and measure the decoder.
+ * The file is read and decoded using a FileDecoder. The time spent in pushData, decodeNextFrame
+ * and getRawFrameData is accumulated separately from the time needed for reading the file.
+ */
+class DecoderBenchmark
+{
+public:
+  struct Result
+  {
+    QString fileName;
+    QString decoderName;
+    bool success {false};
+    QString error;
+    // The number of threads that the decoder used. The requested number is limited by the thread budget.
+    int nrThreads {0};
+    int requestedNrThreads {0};
+    QSize frameSize;
+    int64_t nrFrames {0};
+
+    // The time from the first pushData until the last frame was retrieved
+    double seconds {0.0};
+    double readSeconds {0.0};
+    double pushDataSeconds {0.0};
+    double decodeNextFrameSeconds {0.0};
+    double getRawFrameDataSeconds {0.0};
+    // The time between two frames that were retrieved from the decoder (in milliseconds)
+    QList<double> frameLatenciesMs;
+    // The peak memory of the process during this run. If the peak can not be reset on this platform
+    // (peakMemoryOfRun is false), this is the peak of the whole process (including all previous runs).
+    unsigned int peakMemoryMB {0};
+    bool peakMemoryOfRun {false};
+
+    double getFramesPerSecond() const { return (seconds > 0.0) ? double(nrFrames) / seconds : 0.0; }
+    // Get the given percentile (0 to 100) of the frame latencies in milliseconds
+    double getLatencyPercentileMs(double percentile) const;
+    QJsonObject toJSON() const;
+  };
+
+  // If the decoder is invalid, the decoder is chosen from the file type (libde265 for HEVC, VTM for VVC, dav1d for AV1, FFmpeg otherwise).
+  // If maxNrFrames is greater than 0, decoding stops after this many frames.
+  DecoderBenchmark(YUView::decoderEngine decoder, int maxNrFrames = 0) : decoder(decoder), maxNrFrames(maxNrFrames) {}
+
+  // Decode the file with the given number of decoder threads
+  Result runFile(const QString &fileName, int nrThreads);
+
+private:
+  YUView::decoderEngine decoder;
+  int maxNrFrames;
+};
@@ -0,0 +1,226 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DecoderPool.h"
+
+#include <QSettings>
+
+#include "common/ThreadBudget.h"
+#include "decoder/decoderDav1d.h"
+#include "decoder/decoderHM.h"
+#include "decoder/decoderLibde265.h"
+#include "decoder/decoderVTM.h"
+
+using namespace YUView;
+
+#define DECODERPOOL_DEBUG_OUTPUT 0
+#if DECODERPOOL_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_DECODERPOOL qDebug
+#else
+#define DEBUG_DECODERPOOL(fmt,...) ((void)0)
+#endif
+
+bool DecoderPool::Key::operator==(const Key &other) const
+{
+  return engine == other.engine && signalID == other.signalID && cachingDecoder == other.cachingDecoder && libraryConfig == other.libraryConfig;
+}
+
+DecoderPool &DecoderPool::instance()
+{
+  static DecoderPool pool;
+  return pool;
+}
+
+DecoderPool::DecoderPool()
+{
+  // The idle decoders unregister from the thread budget when they are deleted on exit.
+  // Make sure that the budget is created first so that it is destroyed after the pool.
+  ThreadBudget::instance();
+}
+
+DecoderPool::~DecoderPool()
+{
+  this->clear();
+}
+
+void DecoderPool::Releaser::cleanup(decoderBase *decoder)
+{
+  if (decoder)
+    DecoderPool::instance().releaseDecoder(decoder);
+}
+
+QString DecoderPool::getLibraryConfig(decoderEngine engine)
+{
+  QSettings settings;
+  settings.beginGroup("Decoders");
+  QString libraryFile;
+  if (engine == decoderEngineLibde265)
+    libraryFile = settings.value("libde265File", "").toString();
+  else if (engine == decoderEngineHM)
+    libraryFile = settings.value("libHMFile", "").toString();
+  else if (engine == decoderEngineVTM)
+    libraryFile = settings.value("libVTMFile", "").toString();
+  else if (engine == decoderEngineDav1d)
+    libraryFile = settings.value("libDav1dFile", "").toString();
+  const QString searchPath = settings.value("SearchPath", "").toString();
+  settings.endGroup();
+  return libraryFile + "|" + searchPath;
+}
+
+decoderBase *DecoderPool::getDecoder(decoderEngine engine, int signalID, bool cachingDecoder)
+{
+  Key key;
+  key.engine = engine;
+  key.signalID = signalID;
+  key.cachingDecoder = cachingDecoder;
+  key.libraryConfig = getLibraryConfig(engine);
+
+  decoderBase *decoder = nullptr;
+  {
+    QMutexLocker lock(&this->accessMutex);
+    for (int i = this->idleDecoders.size() - 1; i >= 0; i--)
+    {
+      if (this->idleDecoders[i].first == key)
+      {
+        decoder = this->idleDecoders.takeAt(i).second;
+        break;
+      }
+    }
+    if (decoder)
+      this->nrHits++;
+    else
+      this->nrMisses++;
+  }
+
+  if (decoder)
+  {
+    DEBUG_DECODERPOOL("DecoderPool::getDecoder reusing decoder engine %d signal %d", engine, signalID);
+    decoder->setThreadBudgetActive(true);
+    // Drop the state of the previous item. If the thread share changed, this also reopens the library decoder.
+    decoder->resetDecoder();
+  }
+  else
+  {
+    DEBUG_DECODERPOOL("DecoderPool::getDecoder creating decoder engine %d signal %d", engine, signalID);
+    DecoderFactory factory;
+    {
+      QMutexLocker lock(&this->accessMutex);
+      factory = this->decoderFactory;
+    }
+    decoder = factory ? factory(engine, signalID, cachingDecoder) : createDecoder(engine, signalID, cachingDecoder);
+    if (decoder == nullptr)
+      return nullptr;
+  }
+
+  QMutexLocker lock(&this->accessMutex);
+  this->handedOutDecoders.append(qMakePair(key, decoder));
+  return decoder;
+}
+
+void DecoderPool::releaseDecoder(decoderBase *decoder)
+{
+  decoderBase *deleteDecoder = decoder;
+  {
+    QMutexLocker lock(&this->accessMutex);
+    for (int i = 0; i < this->handedOutDecoders.size(); i++)
+    {
+      if (this->handedOutDecoders[i].second != decoder)
+        continue;
+
+      auto key = this->handedOutDecoders.takeAt(i).first;
+      // The statistics retrieval can not be switched off again. Only keep decoders in their initial configuration.
+      if (!decoder->errorInDecoder() && !decoder->statisticsEnabled() && !decoder->decodesAllSignals())
+      {
+        key.signalID = decoder->getDecodeSignal();
+        decoder->setThreadBudgetActive(false);
+        this->idleDecoders.append(qMakePair(key, decoder));
+        deleteDecoder = nullptr;
+        if (this->idleDecoders.size() > maxNrIdleDecoders)
+          deleteDecoder = this->idleDecoders.takeFirst().second;
+      }
+      break;
+    }
+    DEBUG_DECODERPOOL("DecoderPool::releaseDecoder %d idle decoders", this->idleDecoders.size());
+  }
+
+  // Deleting a decoder unloads its library. Do this without holding the lock.
+  delete deleteDecoder;
+}
+
+decoderBase *DecoderPool::createDecoder(decoderEngine engine, int signalID, bool cachingDecoder)
+{
+  if (engine == decoderEngineLibde265)
+    return new decoderLibde265(signalID, cachingDecoder);
+  if (engine == decoderEngineHM)
+    return new decoderHM(signalID, cachingDecoder);
+  if (engine == decoderEngineVTM)
+    return new decoderVTM(signalID, cachingDecoder);
+  if (engine == decoderEngineDav1d)
+    return new decoderDav1d(signalID, cachingDecoder);
+  return nullptr;
+}
+
+void DecoderPool::setDecoderFactory(const DecoderFactory &factory)
+{
+  QMutexLocker lock(&this->accessMutex);
+  this->decoderFactory = factory;
+}
+
+void DecoderPool::clear()
+{
+  QList<QPair<Key, decoderBase*>> decoders;
+  {
+    QMutexLocker lock(&this->accessMutex);
+    decoders.swap(this->idleDecoders);
+  }
+  for (auto &entry : decoders)
+    delete entry.second;
+}
+
+int64_t DecoderPool::getNrHits() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->nrHits;
+}
+
+int64_t DecoderPool::getNrMisses() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->nrMisses;
+}
+
+int DecoderPool::getNrIdleDecoders() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->idleDecoders.size();
+}
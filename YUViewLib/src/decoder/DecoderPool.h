@@ -0,0 +1,112 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+
+#include <functional>
+
+#include "common/typedef.h"
+
+class decoderBase;
+
+/* A pool of idle decoders that is shared by all playlist items.
+ * Creating a decoder loads its library, resolves all library functions and opens the library decoder.
+ * When an item is deleted or switches its decoder, its decoders are put back into the pool and handed out
+ * again to the next item that asks for the same decoder (same engine, library, display signal and
+ * loading/caching role). A reused decoder is reset, so only the loading of the library is saved. Depending on
+ * the library, the reset may still restart its worker threads (de265_reset does this for libde265).
+ * Idle decoders do not take a share of the thread budget.
+ * Only the decoders that load a single library (libde265, HM, VTM and dav1d) are pooled. The FFmpeg decoder
+ * is configured from the codec parameters of the file and is always created and deleted.
+ */
+class DecoderPool
+{
+public:
+  static DecoderPool &instance();
+
+  // Use this as the cleanup handler of a QScopedPointer<decoderBase> to put the decoder back into the pool
+  struct Releaser
+  {
+    static void cleanup(decoderBase *decoder);
+  };
+
+  // Get a decoder of the given engine (libde265, HM, VTM or dav1d). An idle decoder with the same
+  // configuration is reset and reused. Otherwise, a new decoder is created.
+  decoderBase *getDecoder(YUView::decoderEngine engine, int signalID, bool cachingDecoder = false);
+  // Put the decoder back into the pool. Decoders that were not created by the pool, that are in an error state
+  // or that were reconfigured (statistics, single pass signals) are deleted.
+  void releaseDecoder(decoderBase *decoder);
+
+  // Delete all idle decoders
+  void clear();
+
+  // Creates a new decoder for the engine. By default, the decoder of the engine is created. This can be
+  // replaced (e.g. to test the pool without the decoder libraries). Pass an empty function to restore the default.
+  typedef std::function<decoderBase*(YUView::decoderEngine engine, int signalID, bool cachingDecoder)> DecoderFactory;
+  void setDecoderFactory(const DecoderFactory &factory);
+
+  int64_t getNrHits() const;
+  int64_t getNrMisses() const;
+  int getNrIdleDecoders() const;
+
+  // At most this many idle decoders are kept. If more are released, the least recently used one is deleted.
+  static const int maxNrIdleDecoders = 8;
+
+private:
+  DecoderPool();
+  ~DecoderPool();
+
+  struct Key
+  {
+    YUView::decoderEngine engine {YUView::decoderEngineInvalid};
+    int signalID {0};
+    bool cachingDecoder {false};
+    // The library settings of the engine. Decoders that loaded another library are not reused.
+    QString libraryConfig;
+    bool operator==(const Key &other) const;
+  };
+  static QString getLibraryConfig(YUView::decoderEngine engine);
+  static decoderBase *createDecoder(YUView::decoderEngine engine, int signalID, bool cachingDecoder);
+  DecoderFactory decoderFactory;
+
+  mutable QMutex accessMutex;
+  // The most recently released decoder is at the end
+  QList<QPair<Key, decoderBase*>> idleDecoders;
+  QList<QPair<Key, decoderBase*>> handedOutDecoders;
+  int64_t nrHits {0};
+  int64_t nrMisses {0};
+};
@@ -0,0 +1,291 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FileDecoder.h"
+
+#include <QFileInfo>
+
+#include "common/functions.h"
+#include "decoder/decoderDav1d.h"
+#include "decoder/decoderFFmpeg.h"
+#include "decoder/decoderHM.h"
+#include "decoder/decoderLibde265.h"
+#include "decoder/decoderVTM.h"
+#include "filesource/FileSourceAnnexBFile.h"
+#include "filesource/FileSourceFFmpegFile.h"
+#include "parser/parserAnnexBAVC.h"
+#include "parser/parserAnnexBHEVC.h"
+#include "parser/parserAnnexBVVC.h"
+
+using namespace YUView;
+
+#define FILEDECODER_DEBUG_OUTPUT 0
+#if FILEDECODER_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_FILEDECODER qDebug
+#else
+#define DEBUG_FILEDECODER(fmt,...) ((void)0)
+#endif
+
+namespace
+{
+
+inputFormat getInputFormatFromFileName(const QString &fileName)
+{
+  const auto ext = QFileInfo(fileName).suffix().toLower();
+  if (ext == "hevc" || ext == "h265" || ext == "265")
+    return inputAnnexBHEVC;
+  if (ext == "vvc" || ext == "h266" || ext == "266")
+    return inputAnnexBVVC;
+  if (ext == "avc" || ext == "h264" || ext == "264")
+    return inputAnnexBAVC;
+  return inputLibavformat;
+}
+
+} // namespace
+
+FileDecoder::FileDecoder(decoderEngine decoder) : engine(decoder)
+{
+}
+
+FileDecoder::~FileDecoder()
+{
+}
+
+bool FileDecoder::openFile(const QString &fileName)
+{
+  const auto input = getInputFormatFromFileName(fileName);
+  AVCodecIDWrapper ffmpegCodec;
+  if (functions::isInputFormatTypeAnnexB(input))
+  {
+    this->annexBFile.reset(new FileSourceAnnexBFile(fileName));
+    if (!this->annexBFile->isOk())
+    {
+      this->error = "Unable to open the file";
+      return false;
+    }
+    if (input == inputAnnexBHEVC)
+    {
+      ffmpegCodec.setTypeHEVC();
+      if (this->engine == decoderEngineInvalid)
+        this->engine = decoderEngineLibde265;
+    }
+    else if (input == inputAnnexBAVC)
+    {
+      ffmpegCodec.setTypeAVC();
+      if (this->engine == decoderEngineInvalid)
+        this->engine = decoderEngineFFMpeg;
+    }
+    else if (this->engine == decoderEngineInvalid)
+      this->engine = decoderEngineVTM;
+
+    if (this->engine == decoderEngineFFMpeg)
+    {
+      if (input == inputAnnexBHEVC)
+        this->annexBParser.reset(new parserAnnexBHEVC());
+      else if (input == inputAnnexBAVC)
+        this->annexBParser.reset(new parserAnnexBAVC());
+      else
+      {
+        this->error = "FFmpeg can not decode raw VVC bitstreams";
+        return false;
+      }
+      if (!this->annexBParser->parseAnnexBFile(this->annexBFile))
+      {
+        this->error = "Error parsing the AnnexB file";
+        return false;
+      }
+    }
+    this->annexBFile->seek(0);
+  }
+  else
+  {
+    this->ffmpegFile.reset(new FileSourceFFmpegFile());
+    if (!this->ffmpegFile->openFile(fileName, nullptr, nullptr, false))
+    {
+      this->error = "Error opening the file using libavformat";
+      return false;
+    }
+    ffmpegCodec = this->ffmpegFile->getVideoStreamCodecID();
+    if (this->engine == decoderEngineInvalid)
+      this->engine = ffmpegCodec.isAV1() ? decoderEngineDav1d : decoderEngineFFMpeg;
+  }
+
+  // Allocate the decoder
+  if (this->engine == decoderEngineLibde265)
+    this->dec.reset(new decoderLibde265(0));
+  else if (this->engine == decoderEngineHM)
+    this->dec.reset(new decoderHM(0));
+  else if (this->engine == decoderEngineVTM)
+    this->dec.reset(new decoderVTM(0));
+  else if (this->engine == decoderEngineDav1d)
+    this->dec.reset(new decoderDav1d(0));
+  else if (this->engine == decoderEngineFFMpeg && this->annexBParser)
+    this->dec.reset(new decoderFFmpeg(ffmpegCodec, this->annexBParser->getSequenceSizeSamples(), this->annexBParser->getExtradata(), this->annexBParser->getPixelFormat(), this->annexBParser->getProfileLevel(), this->annexBParser->getSampleAspectRatio()));
+  else if (this->engine == decoderEngineFFMpeg)
+    this->dec.reset(new decoderFFmpeg(this->ffmpegFile->getVideoCodecPar()));
+  else
+  {
+    this->error = "No valid decoder";
+    return false;
+  }
+  if (this->dec->errorInDecoder())
+  {
+    this->error = this->dec->decoderErrorString();
+    return false;
+  }
+
+  DEBUG_FILEDECODER("FileDecoder::openFile opened %s with %s", qUtf8Printable(fileName), qUtf8Printable(this->dec->getDecoderName()));
+  return true;
+}
+
+QSize FileDecoder::getFrameSize() const
+{
+  if (this->annexBParser)
+    return this->annexBParser->getSequenceSizeSamples();
+  if (this->ffmpegFile && this->ffmpegFile->getSequenceSizeSamples().isValid())
+    return this->ffmpegFile->getSequenceSizeSamples();
+  if (this->dec)
+    return this->dec->getFrameSize();
+  return {};
+}
+
+double FileDecoder::getFrameRate() const
+{
+  if (this->annexBParser)
+    return this->annexBParser->getFramerate();
+  if (this->ffmpegFile)
+    return this->ffmpegFile->getFramerate();
+  return -1;
+}
+
+bool FileDecoder::pushParameterSets()
+{
+  this->parameterSetsPushed = true;
+  if (!this->ffmpegFile || this->engine == decoderEngineFFMpeg)
+    return true;
+
+  // Libraries other than FFmpeg need the parameter sets from the container
+  this->timer.start();
+  auto parameterSets = this->ffmpegFile->getParameterSets();
+  this->readNs += this->timer.nsecsElapsed();
+  for (auto &data : parameterSets)
+  {
+    this->timer.start();
+    const bool pushed = this->dec->pushData(data);
+    this->pushNs += this->timer.nsecsElapsed();
+    if (!pushed)
+    {
+      this->error = "Error pushing the parameter sets to the decoder";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FileDecoder::pushNextData()
+{
+  if (this->ffmpegFile && this->engine == decoderEngineFFMpeg)
+  {
+    // Pass the AVPackets from the container directly to FFmpeg
+    this->timer.start();
+    auto pkt = this->ffmpegFile->getNextPacket(this->repushData);
+    this->readNs += this->timer.nsecsElapsed();
+    this->timer.start();
+    const bool pushed = dynamic_cast<decoderFFmpeg*>(this->dec.data())->pushAVPacket(pkt);
+    this->pushNs += this->timer.nsecsElapsed();
+    return pushed;
+  }
+
+  this->timer.start();
+  QByteArray data;
+  if (this->annexBParser)
+  {
+    // FFmpeg gets the data of one frame at a time
+    if (this->annexBFrameCounter < this->annexBParser->getNumberPOCs())
+    {
+      auto frameStartEndFilePos = this->annexBParser->getFrameStartEndPos(this->annexBFrameCounter);
+      if (frameStartEndFilePos)
+        data = this->annexBFile->getFrameData(*frameStartEndFilePos);
+    }
+  }
+  else if (this->annexBFile)
+    data = this->annexBFile->getNextNALUnit(this->repushData);
+  else
+    data = this->ffmpegFile->getNextUnit(this->repushData);
+  this->readNs += this->timer.nsecsElapsed();
+
+  this->timer.start();
+  const bool pushed = this->dec->pushData(data);
+  this->pushNs += this->timer.nsecsElapsed();
+  if (pushed && this->annexBParser)
+    this->annexBFrameCounter++;
+  return pushed;
+}
+
+bool FileDecoder::decodeNextFrame()
+{
+  if (!this->dec || !this->error.isEmpty())
+    return false;
+  if (!this->parameterSetsPushed && !this->pushParameterSets())
+    return false;
+
+  while (true)
+  {
+    while (this->dec->needsMoreData())
+    {
+      // The decoder may refuse data because frames have to be retrieved first. Push the same data again later.
+      const bool pushed = this->pushNextData();
+      this->repushData = !pushed;
+      if (!pushed && !this->dec->decodeFrames())
+        break;
+    }
+
+    if (this->dec->decodeFrames())
+    {
+      this->timer.start();
+      const bool frameDecoded = this->dec->decodeNextFrame();
+      this->decodeNs += this->timer.nsecsElapsed();
+      if (frameDecoded)
+        return true;
+    }
+
+    if (this->dec->errorInDecoder())
+    {
+      this->error = this->dec->decoderErrorString();
+      return false;
+    }
+    if (!this->dec->needsMoreData() && !this->dec->decodeFrames())
+      // End of the bitstream
+      return false;
+  }
+}
@@ -0,0 +1,99 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QScopedPointer>
+#include <QSize>
+#include <QString>
+
+#include "common/typedef.h"
+#include "decoder/decoderBase.h"
+
+class FileSourceAnnexBFile;
+class FileSourceFFmpegFile;
+class parserAnnexB;
+
+/* Open a bitstream file and decode it frame by frame without any GUI or caching.
+ * The file is read with the same file sources as the compressed video item (AnnexB or libavformat)
+ * and the data is pushed to any decoderBase implementation. The time spent reading the file, in
+ * pushData and in decodeNextFrame is accumulated separately (e.g. for the DecoderBenchmark).
+ */
+class FileDecoder
+{
+public:
+  // If the decoder is invalid, the decoder is chosen from the file type (libde265 for HEVC, VTM for VVC, dav1d for AV1, FFmpeg otherwise).
+  FileDecoder(YUView::decoderEngine decoder = YUView::decoderEngineInvalid);
+  ~FileDecoder();
+
+  // Open the file and allocate the decoder. Parsing an AnnexB file (needed for FFmpeg) is done here.
+  bool openFile(const QString &fileName);
+
+  // Decode until the next frame can be retrieved from getDecoder(). Returns false at the end of
+  // the bitstream or if an error occurred (getError() is not empty).
+  bool decodeNextFrame();
+
+  decoderBase *getDecoder() const { return this->dec.data(); }
+  QString getError() const { return this->error; }
+
+  // The size from the container or the parser. If unknown, the size of the decoded frames.
+  QSize getFrameSize() const;
+  // The frame rate from the container or the parser. -1 if unknown.
+  double getFrameRate() const;
+
+  // The accumulated time in nanoseconds
+  qint64 getReadNs() const { return this->readNs; }
+  qint64 getPushDataNs() const { return this->pushNs; }
+  qint64 getDecodeNextFrameNs() const { return this->decodeNs; }
+
+private:
+  bool pushParameterSets();
+  bool pushNextData();
+
+  YUView::decoderEngine engine;
+  QString error;
+
+  QScopedPointer<FileSourceAnnexBFile> annexBFile;
+  QScopedPointer<parserAnnexB> annexBParser;
+  QScopedPointer<FileSourceFFmpegFile> ffmpegFile;
+  QScopedPointer<decoderBase> dec;
+
+  bool parameterSetsPushed {false};
+  bool repushData {false};
+  int annexBFrameCounter {0};
+
+  QElapsedTimer timer;
+  qint64 readNs {0};
+  qint64 pushNs {0};
+  qint64 decodeNs {0};
+};
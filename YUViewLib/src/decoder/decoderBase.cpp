@@ -33,7 +33,12 @@
 #include "decoderBase.h"
 
 #include <QDir>
+#include <QFuture>
 #include <QSettings>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <vector>
 
 using namespace YUView;
 
@@ -70,6 +75,20 @@ void decoderBase::resetDecoder()
   rawFormat = raw_Invalid;
 }
 
+namespace
+{
+
+// The stripes of the statistics extraction of all decoders run in this pool. Every decoder splits
+// its statistics into as many stripes as it has threads, so all decoders together stay in the budget.
+QThreadPool &statisticsThreadPool()
+{
+  static QThreadPool pool;
+  ThreadBudget::instance().limitThreadPool(&pool);
+  return pool;
+}
+
+} // namespace
+
 statisticsData decoderBase::getStatisticsData(int typeIdx)
 {
   if (!retrieveStatistics)
@@ -78,6 +97,37 @@ statisticsData decoderBase::getStatisticsData(int typeIdx)
   return curPOCStats[typeIdx];
 }
 
+void decoderBase::cacheStatisticsInStripes(int nrRows, const StatisticsRowParser &parseRows)
+{
+  const int nrStripes = std::min(nrRows, this->getNrDecoderThreads());
+  if (nrStripes <= 1)
+  {
+    parseRows(0, nrRows, this->curPOCStats);
+    return;
+  }
+
+  DEBUG_DECODERBASE("decoderBase::cacheStatisticsInStripes %d rows in %d stripes", nrRows, nrStripes);
+
+  std::vector<QHash<int, statisticsData>> stripeStats(nrStripes);
+  QList<QFuture<void>> futures;
+  for (int i = 1; i < nrStripes; i++)
+  {
+    const int rowBegin = nrRows * i / nrStripes;
+    const int rowEnd = nrRows * (i + 1) / nrStripes;
+    auto stats = &stripeStats[i];
+    futures.append(QtConcurrent::run(&statisticsThreadPool(), [&parseRows, rowBegin, rowEnd, stats]() { parseRows(rowBegin, rowEnd, *stats); }));
+  }
+
+  // Parse the first stripe in this thread while the others run in the pool
+  parseRows(0, nrRows / nrStripes, stripeStats[0]);
+  for (auto &future : futures)
+    future.waitForFinished();
+
+  for (const auto &stats : stripeStats)
+    for (auto it = stats.constBegin(); it != stats.constEnd(); it++)
+      this->curPOCStats[it.key()].append(it.value());
+}
+
 void decoderBaseSingleLib::loadDecoderLibrary(QString specificLibrary)
 {
   // Try to load the HM library from the current working directory
@@ -34,9 +34,13 @@
 
 #include <QLibrary>
 
+#include <functional>
+
+#include "common/ThreadBudget.h"
 #include "filesource/FileSourceAnnexBFile.h"
 #include "statistics/statisticHandler.h"
 #include "statistics/statisticsExtensions.h"
+#include "video/FrameBuffer.h"
 #include "video/videoHandlerYUV.h"
 #include "video/videoHandlerRGB.h"
 
@@ -65,11 +69,33 @@ public:
   virtual void setDecodeSignal(int signalID, bool &decoderResetNeeded) { if (signalID >= 0 && signalID < nrSignalsSupported()) decodeSignal = signalID; decoderResetNeeded = false; }
   int getDecodeSignal() { return decodeSignal; }
 
+  // Some decoders can export all signals (and the statistics) in one decoding pass. In this mode, the decode signal
+  // only selects which signal getRawFrameData/getFrameBuffer return and changing it does not require a decoder reset.
+  // All other signals of the current frame can be retrieved using getSignalFrameBuffer(signalID).
+  virtual bool supportsSinglePassSignals() const { return false; }
+  void setDecodeAllSignals(bool allSignals, bool &decoderResetNeeded)
+  {
+    decoderResetNeeded = false;
+    if (!this->supportsSinglePassSignals() || allSignals == this->decodeAllSignals)
+      return;
+    this->decodeAllSignals = allSignals;
+    decoderResetNeeded = true;
+  }
+  bool decodesAllSignals() const { return this->decodeAllSignals; }
+
+  // Idle decoders (e.g. in the DecoderPool) do not take a share of the thread budget
+  void setThreadBudgetActive(bool active) { this->threadBudgetRegistration.setActive(active); }
+
   // -- The decoding interface
   // If the current frame is valid, the current frame can be retrieved using getRawFrameData.
   // Call decodeNextFrame to advance to the next frame. When the function returns false, more data is probably needed.
   virtual bool decodeNextFrame() = 0;
   virtual QByteArray getRawFrameData() = 0;
+  // Get the current frame as a reference counted FrameBuffer. By default, this wraps the data from getRawFrameData.
+  // Decoders that can hand out a reference to their decoded picture override this so that the planes are not copied.
+  virtual FrameBuffer getFrameBuffer() { return FrameBuffer(this->getRawFrameData()); }
+  // Get the given signal of the current frame. Only the decode signal is available unless all signals are decoded.
+  virtual FrameBuffer getSignalFrameBuffer(int signalID) { return (signalID == this->decodeSignal) ? this->getFrameBuffer() : FrameBuffer(); }
   YUView::RawFormat getRawFormat() const { return rawFormat; }
   YUV_Internals::yuvPixelFormat getYUVPixelFormat() const { return formatYUV; }
   RGB_Internals::rgbPixelFormat getRGBPixelFormat() const { return formatRGB; }
@@ -88,6 +114,8 @@ public:
   bool statisticsEnabled() const { return retrieveStatistics; }
   void enableStatisticsRetrieval() { retrieveStatistics = true; }
   statisticsData getStatisticsData(int typeIdx);
+  // Get the statistics of all types for the current frame. Call this after getRawFrameData/getFrameBuffer.
+  QHash<int, statisticsData> getCurrentFrameStatistics() const { return this->retrieveStatistics ? this->curPOCStats : QHash<int, statisticsData>(); }
   virtual void fillStatisticList(statisticHandler &statSource) const { Q_UNUSED(statSource); };
 
   // Error handling
@@ -116,8 +144,29 @@ protected:
   DecoderState decoderState;
   
   int decodeSignal { 0 }; ///< Which signal should be decoded?
+  bool decodeAllSignals { false }; ///< Export all signals in one pass (only if supportsSinglePassSignals)
   bool isCachingDecoder; ///< Is this the caching or the interactive decoder?
 
+  // Every decoder takes part in the thread budget. Use getNrDecoderThreads when (re)allocating the library decoder.
+  ThreadBudget::Registration threadBudgetRegistration;
+  int getNrDecoderThreads() const { return ThreadBudget::instance().getNrThreadsPerDecoder(); }
+
+  // The configuration that the library decoder was allocated with. If it did not change, resetDecoder
+  // can flush the library decoder instead of closing and reopening it (including its worker threads).
+  struct LibraryConfig
+  {
+    int nrThreads {0};
+    int decodeSignal {0};
+    bool retrieveStatistics {false};
+    bool decodeAllSignals {false};
+    bool operator==(const LibraryConfig &other) const
+    {
+      return nrThreads == other.nrThreads && decodeSignal == other.decodeSignal && retrieveStatistics == other.retrieveStatistics && decodeAllSignals == other.decodeAllSignals;
+    }
+  };
+  LibraryConfig getCurrentLibraryConfig() const { return {this->getNrDecoderThreads(), this->decodeSignal, this->retrieveStatistics, this->decodeAllSignals}; }
+  LibraryConfig allocatedLibraryConfig;
+
   bool internalsSupported { false };  ///< Enable in the constructor if you support statistics
   bool retrieveStatistics { false };  ///< If enabled, the decoder should also retrive statistics data from the bitstream
   QSize frameSize;
@@ -135,6 +184,13 @@ protected:
   // Statistics caching
   QHash<int, statisticsData> curPOCStats;  // cache of the statistics for the current POC [statsTypeID]
   int statsCacheCurPOC;                    // the POC of the statistics that are in the curPOCStats
+
+  // Extract the statistics of the current frame in stripes of rows (e.g. CTU or superblock rows). Each stripe
+  // is parsed by parseRows(rowBegin, rowEnd, stats) into its own output, in parallel up to the thread share of
+  // this decoder. The outputs are appended to curPOCStats in the order of the stripes, so the order of the
+  // items is the same as when parsing all rows at once. parseRows must only read from the decoded frame.
+  typedef std::function<void(int rowBegin, int rowEnd, QHash<int, statisticsData> &stats)> StatisticsRowParser;
+  void cacheStatisticsInStripes(int nrRows, const StatisticsRowParser &parseRows);
 };
 
 // This abstract base class extends the decoderBase class by the ability to load one single library
@@ -32,6 +32,7 @@
 
 #include "decoderDav1d.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <QCoreApplication>
@@ -96,6 +97,7 @@ decoderDav1d::decoderDav1d(int signalID, bool cachingDecoder) :
 
 decoderDav1d::~decoderDav1d()
 {
+  curPicture.clear();
   if (decoder != nullptr)
   {
     // Free the decoder
@@ -111,6 +113,19 @@ void decoderDav1d::resetDecoder()
   if (!decoder)
     return setError("Resetting the decoder failed. No decoder allocated.");
 
+  curPicture.clear();
+  if (allocatedLibraryConfig == getCurrentLibraryConfig())
+  {
+    // Nothing changed. Keep the decoder and its thread pool and only drop the decoding state.
+    DEBUG_DAV1D("decoderDav1d::resetDecoder flushing the decoder");
+    dav1d_flush(decoder);
+    decoderBase::resetDecoder();
+    currentOutputBuffer.clear();
+    decodedFrameWaiting = false;
+    flushing = false;
+    return;
+  }
+
   dav1d_close(&decoder);
   if (decoder != nullptr)
     DEBUG_DAV1D("Error closing the decoder. The close function should set the decoder pointer to NULL");
@@ -126,7 +141,11 @@ void decoderDav1d::setDecodeSignal(int signalID, bool &decoderResetNeeded)
     return;
   if (signalID >= 0 && signalID < nrSignalsSupported())
     decodeSignal = signalID;
-  decoderResetNeeded = true;
+  if (decodeAllSignals)
+    // All signals are exported by the decoder. Only the output buffer has to be filled again.
+    currentOutputBuffer.clear();
+  else
+    decoderResetNeeded = true;
 }
 
 void decoderDav1d::resolveLibraryFunctionPointers()
@@ -138,6 +157,7 @@ void decoderDav1d::resolveLibraryFunctionPointers()
   if (!resolve(dav1d_parse_sequence_header, "dav1d_parse_sequence_header")) return;
   if (!resolve(dav1d_send_data, "dav1d_send_data")) return;
   if (!resolve(dav1d_get_picture, "dav1d_get_picture")) return;
+  if (!resolve(dav1d_picture_unref, "dav1d_picture_unref")) return;
   if (!resolve(dav1d_close, "dav1d_close")) return;
   if (!resolve(dav1d_flush, "dav1d_flush")) return;
 
@@ -182,6 +202,14 @@ void decoderDav1d::allocateNewDecoder()
 
   dav1d_default_settings(&settings);
 
+  // Use our share of the thread budget. Tile threads only help for streams with multiple tiles,
+  // so the remaining threads are used for frame threading.
+  allocatedLibraryConfig = getCurrentLibraryConfig();
+  const int nrThreads = allocatedLibraryConfig.nrThreads;
+  settings.n_tile_threads = std::min(nrThreads, 4);
+  settings.n_frame_threads = std::max(1, nrThreads / settings.n_tile_threads);
+  DEBUG_DAV1D("decoderDav1d::allocateNewDecoder - %d frame threads, %d tile threads", settings.n_frame_threads, settings.n_tile_threads);
+
   // Create new decoder object
   int err = dav1d_open(&decoder, &settings);
   if (err != 0)
@@ -195,7 +223,13 @@ void decoderDav1d::allocateNewDecoder()
   {
     // Apply the analizer settings
     dav1d_default_analyzer_settings(&analyzerSettings);
-    if (nrSignals > 0)
+    if (nrSignals > 0 && decodeAllSignals)
+    {
+      analyzerSettings.export_prediction = 1;
+      analyzerSettings.export_prefilter = 1;
+      DEBUG_DAV1D("decoderDav1d::allocateNewDecoder - Activated export of all signals");
+    }
+    else if (nrSignals > 0)
     {
       if (decodeSignal == 1)
       {
@@ -246,10 +280,14 @@ bool decoderDav1d::decodeFrame()
 
   curPicture.clear();
 
-  int res = dav1d_get_picture(decoder, curPicture.getPicture());
+  Dav1dPicture picture;
+  memset(&picture, 0, sizeof(Dav1dPicture));
+  int res = dav1d_get_picture(decoder, &picture);
   if (res >= 0)
   { 
     // We did get a picture
+    curPicture.setPicture(picture, dav1d_picture_unref);
+
     // Get the resolution / yuv format from the frame
     QSize s = curPicture.getFrameSize();
     if (!s.isValid())
@@ -281,6 +319,7 @@ bool decoderDav1d::decodeFrame()
 
     decoderState = DecoderState::RetrieveFrames;
     currentOutputBuffer.clear();
+    statisticsCached = false;
     return true;
   }
   else if (res != -EAGAIN)
@@ -311,15 +350,95 @@ QByteArray decoderDav1d::getRawFrameData()
     // Put image data into buffer
     copyImgToByteArray(curPicture, currentOutputBuffer);
     DEBUG_DAV1D("decoderDav1d::getRawFrameData copied frame to buffer");
+  }
 
-    if (retrieveStatistics)
-      // Get the statistics from the image and put them into the statistics cache
-      cacheStatistics(curPicture);
+  if (retrieveStatistics && !statisticsCached)
+  {
+    // Get the statistics from the image and put them into the statistics cache
+    cacheStatistics(curPicture);
+    statisticsCached = true;
   }
 
   return currentOutputBuffer;
 }
 
+FrameBuffer decoderDav1d::getFrameBuffer()
+{
+  return getSignalFrameBuffer(decodeSignal);
+}
+
+FrameBuffer decoderDav1d::getSignalFrameBuffer(int signalID)
+{
+  if (signalID != decodeSignal && !decodeAllSignals)
+    return FrameBuffer();
+  QSize s = curPicture.getFrameSize();
+  if (s.width() <= 0 || s.height() <= 0)
+  {
+    DEBUG_DAV1D("decoderDav1d::getSignalFrameBuffer: Current picture has invalid size.");
+    return FrameBuffer();
+  }
+  if (decoderState != DecoderState::RetrieveFrames)
+  {
+    DEBUG_DAV1D("decoderDav1d::getSignalFrameBuffer: Wrong decoder state.");
+    return FrameBuffer();
+  }
+
+  // Reference the planes of the picture instead of copying them. The FrameBuffer holds a reference
+  // to the picture so that dav1d can not reuse it while it is in use.
+  const auto layout = curPicture.getSubsampling();
+  const int nrPlanes = (layout == Subsampling::YUV_400) ? 1 : 3;
+  const int nrBytesPerSample = (curPicture.getBitDepth() > 8) ? 2 : 1;
+  FrameBuffer buffer(curPicture.getPictureReference());
+  for (int c = 0; c < nrPlanes; c++)
+  {
+    int width = s.width();
+    int height = s.height();
+    if (c != 0)
+    {
+      if (layout == Subsampling::YUV_420 || layout == Subsampling::YUV_422)
+        width /= 2;
+      if (layout == Subsampling::YUV_420)
+        height /= 2;
+    }
+
+    const uint8_t *img_c = getDecodeSignalData(c, signalID);
+    if (img_c == nullptr)
+      return FrameBuffer();
+    const int stride = (c == 0) ? curPicture.getStride(0) : curPicture.getStride(1);
+    buffer.addPlane(img_c, stride, width * nrBytesPerSample, height);
+  }
+  DEBUG_DAV1D("decoderDav1d::getSignalFrameBuffer referenced signal %d of picture", signalID);
+
+  if (retrieveStatistics && !statisticsCached)
+  {
+    // Get the statistics from the image and put them into the statistics cache
+    cacheStatistics(curPicture);
+    statisticsCached = true;
+  }
+
+  return buffer;
+}
+
+uint8_t *decoderDav1d::getDecodeSignalData(int component, int signalID) const
+{
+  if (signalID == 0)
+    return curPicture.getData(component);
+  else if (signalID == 1)
+    return curPicture.getDataPrediction(component);
+  else if (signalID == 2)
+    return curPicture.getDataReconstructionPreFiltering(component);
+  return nullptr;
+}
+
+void decoderDav1d::Dav1dPictureWrapper::setPicture(const Dav1dPicture &picture, void (*pictureUnref)(Dav1dPicture*))
+{
+  curPicture.reset(new Dav1dPicture(picture), [pictureUnref](Dav1dPicture *p)
+  {
+    pictureUnref(p);
+    delete p;
+  });
+}
+
 bool decoderDav1d::pushData(QByteArray &data) 
 {
   if (decoderState != DecoderState::NeedsMoreData)
@@ -450,14 +569,7 @@ void decoderDav1d::copyImgToByteArray(const Dav1dPictureWrapper &src, QByteArray
     }
     const size_t widthInBytes = width * nrBytesPerSample;
 
-    uint8_t* img_c = nullptr;
-    if (decodeSignal == 0)
-      img_c = curPicture.getData(c);
-    else if (decodeSignal == 1)
-      img_c = curPicture.getDataPrediction(c);
-    else if (decodeSignal == 2)
-      img_c = curPicture.getDataReconstructionPreFiltering(c);
-
+    uint8_t* img_c = getDecodeSignalData(c, decodeSignal);
     if (img_c == nullptr)
       return;
 
@@ -726,12 +838,18 @@ void decoderDav1d::cacheStatistics(const Dav1dPictureWrapper &img)
 
   const int sb_step = subBlockSize >> 2;
 
-  for (int y = 0; y < frameInfo.frameSizeAligned.height(); y += sb_step)
-    for (int x = 0; x < frameInfo.frameSizeAligned.width(); x += sb_step)
-      parseBlockRecursive(blockData, x, y, BL_128X128, frameInfo);
+  // Parse the superblocks in stripes of superblock rows
+  const int nrSuperblockRows = (frameInfo.frameSizeAligned.height() + sb_step - 1) / sb_step;
+  auto parseSuperblockRows = [&](int sbRowBegin, int sbRowEnd, QHash<int, statisticsData> &stats)
+  {
+    for (int y = sbRowBegin * sb_step; y < sbRowEnd * sb_step; y += sb_step)
+      for (int x = 0; x < frameInfo.frameSizeAligned.width(); x += sb_step)
+        parseBlockRecursive(stats, blockData, x, y, BL_128X128, frameInfo);
+  };
+  cacheStatisticsInStripes(nrSuperblockRows, parseSuperblockRows);
 }
 
-void decoderDav1d::parseBlockRecursive(Av1Block *blockData, int x, int y, BlockLevel level, dav1dFrameInfo &frameInfo)
+void decoderDav1d::parseBlockRecursive(QHash<int, statisticsData> &stats, Av1Block *blockData, int x, int y, BlockLevel level, const dav1dFrameInfo &frameInfo) const
 {
   if (y >= frameInfo.sizeInBlocks.height())
     return;
@@ -750,10 +868,10 @@ void decoderDav1d::parseBlockRecursive(Av1Block *blockData, int x, int y, BlockL
     // Recurse
     const BlockLevel nextLevel = (BlockLevel)(level + 1);
     const int subw = blockWidth4 / 2;
-    parseBlockRecursive(blockData, x       , y       , nextLevel, frameInfo);
-    parseBlockRecursive(blockData, x + subw, y       , nextLevel, frameInfo);
-    parseBlockRecursive(blockData, x       , y + subw, nextLevel, frameInfo);
-    parseBlockRecursive(blockData, x + subw, y + subw, nextLevel, frameInfo);
+    parseBlockRecursive(stats, blockData, x       , y       , nextLevel, frameInfo);
+    parseBlockRecursive(stats, blockData, x + subw, y       , nextLevel, frameInfo);
+    parseBlockRecursive(stats, blockData, x       , y + subw, nextLevel, frameInfo);
+    parseBlockRecursive(stats, blockData, x + subw, y + subw, nextLevel, frameInfo);
   }
   else
   {
@@ -766,57 +884,57 @@ void decoderDav1d::parseBlockRecursive(Av1Block *blockData, int x, int y, BlockL
     switch (blockPartition)
     {
     case PARTITION_NONE:
-      parseBlockPartition(blockData, x, y, bs, bs, frameInfo);
+      parseBlockPartition(stats, blockData, x, y, bs, bs, frameInfo);
       break;
     case PARTITION_H:
-      parseBlockPartition(blockData, x, y    , bs, bs / 2, frameInfo);
-      parseBlockPartition(blockData, x, y + o, bs, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x, y    , bs, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x, y + o, bs, bs / 2, frameInfo);
       break;
     case PARTITION_V:
-      parseBlockPartition(blockData, x    , y, bs / 2, bs, frameInfo);
-      parseBlockPartition(blockData, x + o, y, bs / 2, bs, frameInfo);
+      parseBlockPartition(stats, blockData, x    , y, bs / 2, bs, frameInfo);
+      parseBlockPartition(stats, blockData, x + o, y, bs / 2, bs, frameInfo);
       break;
     case PARTITION_T_TOP_SPLIT: // PARTITION_HORZ_A
-      parseBlockPartition(blockData, x    , y    , bs / 2, bs / 2, frameInfo);
-      parseBlockPartition(blockData, x + o, y    , bs / 2, bs / 2, frameInfo);
-      parseBlockPartition(blockData, x    , y + o, bs    , bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x    , y    , bs / 2, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x + o, y    , bs / 2, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x    , y + o, bs    , bs / 2, frameInfo);
       break;
     case PARTITION_T_BOTTOM_SPLIT: // PARTITION_HORZ_B
-      parseBlockPartition(blockData, x    , y    , bs    , bs / 2, frameInfo);
-      parseBlockPartition(blockData, x    , y + o, bs / 2, bs / 2, frameInfo);
-      parseBlockPartition(blockData, x + o, y + o, bs / 2, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x    , y    , bs    , bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x    , y + o, bs / 2, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x + o, y + o, bs / 2, bs / 2, frameInfo);
       break;
     case PARTITION_T_LEFT_SPLIT: // PARTITION_VERT_A
-      parseBlockPartition(blockData, x    , y    , bs / 2, bs / 2, frameInfo);
-      parseBlockPartition(blockData, x    , y + o, bs / 2, bs / 2, frameInfo);
-      parseBlockPartition(blockData, x + o, y    , bs / 2, bs    , frameInfo);
+      parseBlockPartition(stats, blockData, x    , y    , bs / 2, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x    , y + o, bs / 2, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x + o, y    , bs / 2, bs    , frameInfo);
       break;
     case PARTITION_T_RIGHT_SPLIT: // PARTITION_VERT_B
-      parseBlockPartition(blockData, x    , y    , bs / 2, bs    , frameInfo);
-      parseBlockPartition(blockData, x    , y + o, bs / 2, bs / 2, frameInfo);
-      parseBlockPartition(blockData, x + o, y + o, bs / 2, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x    , y    , bs / 2, bs    , frameInfo);
+      parseBlockPartition(stats, blockData, x    , y + o, bs / 2, bs / 2, frameInfo);
+      parseBlockPartition(stats, blockData, x + o, y + o, bs / 2, bs / 2, frameInfo);
       break;
     case PARTITION_H4: // PARTITION_HORZ_4
-      parseBlockPartition(blockData, x, y         , bs, bs / 4, frameInfo);
-      parseBlockPartition(blockData, x, y + oq    , bs, bs / 4, frameInfo);
-      parseBlockPartition(blockData, x, y + oq * 2, bs, bs / 4, frameInfo);
-      parseBlockPartition(blockData, x, y + oq * 3, bs, bs / 4, frameInfo);
+      parseBlockPartition(stats, blockData, x, y         , bs, bs / 4, frameInfo);
+      parseBlockPartition(stats, blockData, x, y + oq    , bs, bs / 4, frameInfo);
+      parseBlockPartition(stats, blockData, x, y + oq * 2, bs, bs / 4, frameInfo);
+      parseBlockPartition(stats, blockData, x, y + oq * 3, bs, bs / 4, frameInfo);
       break;
     case PARTITION_V4: // PARTITION_VER_4
-      parseBlockPartition(blockData, x         , y, bs / 4, bs, frameInfo);
-      parseBlockPartition(blockData, x + oq    , y, bs / 4, bs, frameInfo);
-      parseBlockPartition(blockData, x + oq * 2, y, bs / 4, bs, frameInfo);
-      parseBlockPartition(blockData, x + oq * 3, y, bs / 4, bs, frameInfo);
+      parseBlockPartition(stats, blockData, x         , y, bs / 4, bs, frameInfo);
+      parseBlockPartition(stats, blockData, x + oq    , y, bs / 4, bs, frameInfo);
+      parseBlockPartition(stats, blockData, x + oq * 2, y, bs / 4, bs, frameInfo);
+      parseBlockPartition(stats, blockData, x + oq * 3, y, bs / 4, bs, frameInfo);
       break;
     case PARTITION_SPLIT:
       if (blockLevel == BL_8X8)
       {
         // 4 square 4x4 blocks. This is allowed.
         assert(blockWidth4 == 2);
-        parseBlockPartition(blockData, x    , y    , 1, 1, frameInfo);
-        parseBlockPartition(blockData, x + 1, y    , 1, 1, frameInfo);
-        parseBlockPartition(blockData, x    , y + 1, 1, 1, frameInfo);
-        parseBlockPartition(blockData, x + 1, y + 1, 1, 1, frameInfo);
+        parseBlockPartition(stats, blockData, x    , y    , 1, 1, frameInfo);
+        parseBlockPartition(stats, blockData, x + 1, y    , 1, 1, frameInfo);
+        parseBlockPartition(stats, blockData, x    , y + 1, 1, 1, frameInfo);
+        parseBlockPartition(stats, blockData, x + 1, y + 1, 1, 1, frameInfo);
       }
       else
       {
@@ -830,7 +948,7 @@ void decoderDav1d::parseBlockRecursive(Av1Block *blockData, int x, int y, BlockL
   }
 }
 
-void decoderDav1d::parseBlockPartition(Av1Block *blockData, int x, int y, int blockWidth4, int blockHeight4, dav1dFrameInfo &frameInfo)
+void decoderDav1d::parseBlockPartition(QHash<int, statisticsData> &stats, Av1Block *blockData, int x, int y, int blockWidth4, int blockHeight4, const dav1dFrameInfo &frameInfo) const
 {
   if (y >= frameInfo.sizeInBlocks.height() || x >= frameInfo.sizeInBlocks.width())
     return;
@@ -845,34 +963,34 @@ void decoderDav1d::parseBlockPartition(Av1Block *blockData, int x, int y, int bl
   // Set prediction mode (ID 0)
   const bool isIntra = (b.intra != 0);
   const int predMode = isIntra ? 0 : 1;
-  curPOCStats[0].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, predMode);
+  stats[0].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, predMode);
 
   bool FrameIsIntra = (frameInfo.frameType == DAV1D_FRAME_TYPE_KEY || frameInfo.frameType == DAV1D_FRAME_TYPE_INTRA);
   if (FrameIsIntra)
   {
     // Set the segment ID (ID 1)
-    curPOCStats[1].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.seg_id);
+    stats[1].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.seg_id);
   }
 
   // Set the skip "flag" (ID 2)
-  curPOCStats[2].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.skip);
+  stats[2].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.skip);
 
   // Set the skip_mode (ID 3)
-  curPOCStats[3].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.skip_mode);
+  stats[3].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.skip_mode);
 
   if (isIntra)
   {
     // Set the intra pred mode luma/chrmoa (ID 4, 5)
-    curPOCStats[4].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.y_mode);
-    curPOCStats[5].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.uv_mode);
+    stats[4].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.y_mode);
+    stats[5].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.uv_mode);
 
     // Set the palette size Y/UV (ID 6, 7)
-    curPOCStats[6].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.pal_sz[0]);
-    curPOCStats[7].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.pal_sz[1]);
+    stats[6].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.pal_sz[0]);
+    stats[7].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.pal_sz[1]);
 
     // Set the intra angle delta luma/chroma (ID 8, 9)
-    curPOCStats[8].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.y_angle);
-    curPOCStats[9].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.uv_angle);
+    stats[8].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.y_angle);
+    stats[9].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.uv_angle);
 
     // Calculate and set the intra prediction direction luma/chroma (ID 10, 11)
     for (int yc=0; yc<2; yc++)
@@ -887,14 +1005,14 @@ void decoderDav1d::parseBlockPartition(Av1Block *blockData, int x, int y, int bl
       int vecX = (float)vec.first * blockScale / 4;
       int vecY = (float)vec.second * blockScale / 4;
       
-      curPOCStats[10 + yc].addBlockVector(cbPosX, cbPosY, cbWidth, cbHeight, vecX, vecY);
+      stats[10 + yc].addBlockVector(cbPosX, cbPosY, cbWidth, cbHeight, vecX, vecY);
     }
 
     if (b.y_mode == CFL_PRED)
     {
       // Set the chroma from luma alpha U/V (ID 12, 13)
-      curPOCStats[12].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.cfl_alpha[0]);
-      curPOCStats[13].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.cfl_alpha[1]);
+      stats[12].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.cfl_alpha[0]);
+      stats[13].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.cfl_alpha[1]);
     }
   }
   else // inter
@@ -903,43 +1021,43 @@ void decoderDav1d::parseBlockPartition(Av1Block *blockData, int x, int y, int bl
     bool isCompound = (compoundType != COMP_INTER_NONE);
 
     // Set the reference frame indices 0/1 (ID 14, 15)
-    curPOCStats[14].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.ref[0]);
+    stats[14].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.ref[0]);
     if (isCompound)
-      curPOCStats[15].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.ref[1]);
+      stats[15].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.ref[1]);
 
     // Set the compound prediction type (ID 16)
-    curPOCStats[16].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.comp_type);
+    stats[16].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.comp_type);
 
     // Set the wedge index (ID 17)
     if (b.comp_type == COMP_INTER_WEDGE || b.interintra_type == INTER_INTRA_WEDGE)
-      curPOCStats[17].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.wedge_idx);
+      stats[17].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.wedge_idx);
 
     // Set the mask sign (ID 18)
     if (isCompound) // TODO: This might not be correct
-      curPOCStats[18].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.mask_sign);
+      stats[18].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.mask_sign);
 
     // Set the inter mode (ID 19)
-    curPOCStats[19].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.inter_mode);
+    stats[19].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.inter_mode);
 
     // Set the dynamic reference list index (ID 20)
     if (isCompound) // TODO: This might not be correct
-      curPOCStats[20].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.drl_idx);
+      stats[20].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.drl_idx);
 
     if (isCompound)
     {
       // Set inter intra type (ID 21)
-      curPOCStats[21].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.interintra_type);
+      stats[21].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.interintra_type);
       // Set inter intra mode (ID 22)
-      curPOCStats[22].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.interintra_mode);
+      stats[22].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.interintra_mode);
     }
 
     // Set motion mode (ID 23)
-    curPOCStats[23].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.motion_mode);
+    stats[23].addBlockValue(cbPosX, cbPosY, cbWidth, cbHeight, b.motion_mode);
 
     // Set motion vector 0/1 (ID 24, 25)
-    curPOCStats[24].addBlockVector(cbPosX, cbPosY, cbWidth, cbHeight, b.mv[0].x, b.mv[0].y);
+    stats[24].addBlockVector(cbPosX, cbPosY, cbWidth, cbHeight, b.mv[0].x, b.mv[0].y);
     if (isCompound)
-      curPOCStats[25].addBlockVector(cbPosX, cbPosY, cbWidth, cbHeight, b.mv[1].x, b.mv[1].y);
+      stats[25].addBlockVector(cbPosX, cbPosY, cbWidth, cbHeight, b.mv[1].x, b.mv[1].y);
   }
 
   const TxfmSize tx_val = TxfmSize(isIntra ? b.tx : b.max_ytx);
@@ -957,12 +1075,12 @@ void decoderDav1d::parseBlockPartition(Av1Block *blockData, int x, int y, int bl
       const int x_abs = cbPosX + x;
       const int y_abs = cbPosY + y;
       if (x_abs < frameInfo.frameSize.width() && y_abs < frameInfo.frameSize.height())
-        curPOCStats[26].addBlockValue(x_abs, y_abs, tx_w, tx_h, (int)tx_val);
+        stats[26].addBlockValue(x_abs, y_abs, tx_w, tx_h, (int)tx_val);
     }
   }
 }
 
-QIntPair decoderDav1d::calculateIntraPredDirection(IntraPredMode predMode, int angleDelta)
+QIntPair decoderDav1d::calculateIntraPredDirection(IntraPredMode predMode, int angleDelta) const
 {
   if (predMode == DC_PRED || predMode > VERT_LEFT_PRED)
     return QIntPair(0, 0);
@@ -33,6 +33,7 @@
 #pragma once
 
 #include <QLibrary>
+#include <memory>
 
 #include "decoderBase.h"
 #include "externalHeader/dav1d/dav1d.h"
@@ -49,6 +50,7 @@ struct decoderDav1d_Functions
   int         (*dav1d_parse_sequence_header) (Dav1dSequenceHeader*, const uint8_t*, const size_t);
   int         (*dav1d_send_data)             (Dav1dContext*, Dav1dData*);
   int         (*dav1d_get_picture)           (Dav1dContext*, Dav1dPicture*);
+  void        (*dav1d_picture_unref)         (Dav1dPicture*);
   void        (*dav1d_close)                 (Dav1dContext**);
   void        (*dav1d_flush)                 (Dav1dContext*);
 
@@ -72,10 +74,13 @@ public:
   bool isSignalDifference(int signalID) const Q_DECL_OVERRIDE { return signalID == 2 || signalID == 3; }
   QStringList getSignalNames() const Q_DECL_OVERRIDE { return QStringList() << "Reconstruction" << "Prediction" << "Reconstruction pre-filter"; }
   void setDecodeSignal(int signalID, bool &decoderResetNeeded) Q_DECL_OVERRIDE;
+  bool supportsSinglePassSignals() const Q_DECL_OVERRIDE { return nrSignals > 1; }
 
   // Decoding / pushing data
   bool decodeNextFrame() Q_DECL_OVERRIDE;
   QByteArray getRawFrameData() Q_DECL_OVERRIDE;
+  FrameBuffer getFrameBuffer() Q_DECL_OVERRIDE;
+  FrameBuffer getSignalFrameBuffer(int signalID) Q_DECL_OVERRIDE;
   bool pushData(QByteArray &data) Q_DECL_OVERRIDE;
 
   // Check if the given library file is an existing libde265 decoder that we can use.
@@ -126,25 +131,34 @@ private:
 
     void setInternalsSupported() { internalsSupported = true;  }
 
-    void clear() { memset(&curPicture, 0, sizeof(Dav1dPicture)); }
-    QSize getFrameSize() const { return QSize(curPicture.p.w, curPicture.p.h); }
-    Dav1dPicture *getPicture() const { return (Dav1dPicture*)(&curPicture); }
-    YUV_Internals::Subsampling getSubsampling() const { return decoderDav1d::convertFromInternalSubsampling(curPicture.p.layout); }
-    int getBitDepth() const { return curPicture.p.bpc; }
-    uint8_t *getData(int component) const { return (uint8_t*)curPicture.data[component]; }
-    ptrdiff_t getStride(int component) const { return curPicture.stride[component]; }
-    uint8_t *getDataPrediction(int component) const { return internalsSupported ? (uint8_t*)curPicture.pred[component] : nullptr; }
-    uint8_t *getDataReconstructionPreFiltering(int component) const { return internalsSupported ? (uint8_t*)curPicture.pre_lpf[component] : nullptr; }
-    Av1Block *getBlockData() const { return internalsSupported ? reinterpret_cast<Av1Block*>(curPicture.blk_data) : nullptr; }
-
-    Dav1dSequenceHeader *getSequenceHeader() const { return curPicture.seq_hdr; }
-    Dav1dFrameHeader *getFrameHeader() const { return curPicture.frame_hdr; }
+    // Release our reference to the picture. The picture is freed once all FrameBuffers that use it are gone.
+    void clear() { curPicture.reset(); }
+    // Take over the reference of the given picture. It is released using the given unref function.
+    void setPicture(const Dav1dPicture &picture, void (*pictureUnref)(Dav1dPicture*));
+    bool isValid() const { return bool(curPicture); }
+    std::shared_ptr<Dav1dPicture> getPictureReference() const { return curPicture; }
+
+    QSize getFrameSize() const { return curPicture ? QSize(curPicture->p.w, curPicture->p.h) : QSize(); }
+    YUV_Internals::Subsampling getSubsampling() const { return decoderDav1d::convertFromInternalSubsampling(curPicture->p.layout); }
+    int getBitDepth() const { return curPicture->p.bpc; }
+    uint8_t *getData(int component) const { return (uint8_t*)curPicture->data[component]; }
+    ptrdiff_t getStride(int component) const { return curPicture->stride[component]; }
+    uint8_t *getDataPrediction(int component) const { return internalsSupported ? (uint8_t*)curPicture->pred[component] : nullptr; }
+    uint8_t *getDataReconstructionPreFiltering(int component) const { return internalsSupported ? (uint8_t*)curPicture->pre_lpf[component] : nullptr; }
+    Av1Block *getBlockData() const { return internalsSupported ? reinterpret_cast<Av1Block*>(curPicture->blk_data) : nullptr; }
+
+    Dav1dSequenceHeader *getSequenceHeader() const { return curPicture->seq_hdr; }
+    Dav1dFrameHeader *getFrameHeader() const { return curPicture->frame_hdr; }
     
   private:
-    Dav1dPicture curPicture;
+    std::shared_ptr<Dav1dPicture> curPicture;
     bool internalsSupported {false};
   };
 
+  // Get the plane of the given signal (reconstruction, prediction, ...) from the current picture
+  uint8_t *getDecodeSignalData(int component, int signalID) const;
+  bool statisticsCached {false};
+
   Dav1dPictureWrapper curPicture;
 
   // We buffer the current image as a QByteArray so you can call getYUVFrameData as often as necessary
@@ -171,8 +185,8 @@ private:
   // Statistics
   void fillStatisticList(statisticHandler &statSource) const Q_DECL_OVERRIDE;
   void cacheStatistics(const Dav1dPictureWrapper &img);
-  void parseBlockRecursive(Av1Block *blockData, int x, int y, BlockLevel level, dav1dFrameInfo &frameInfo);
-  void parseBlockPartition(Av1Block *blockData, int x, int y, int blockWidth4, int blockHeight4, dav1dFrameInfo &frameInfo);
-  QIntPair calculateIntraPredDirection(IntraPredMode predMode, int angleDelta);
+  void parseBlockRecursive(QHash<int, statisticsData> &stats, Av1Block *blockData, int x, int y, BlockLevel level, const dav1dFrameInfo &frameInfo) const;
+  void parseBlockPartition(QHash<int, statisticsData> &stats, Av1Block *blockData, int x, int y, int blockWidth4, int blockHeight4, const dav1dFrameInfo &frameInfo) const;
+  QIntPair calculateIntraPredDirection(IntraPredMode predMode, int angleDelta) const;
   unsigned int subBlockSize {0};
 };
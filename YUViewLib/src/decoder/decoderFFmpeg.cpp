@@ -138,7 +138,7 @@ bool decoderFFmpeg::decodeNextFrame()
   if (!decodeFrame())
     return false;
 
-  copyCurImageToBuffer();
+  this->currentOutputBufferValid = false;
   
   if (retrieveStatistics)
     // Get the statistics from the image and put them into the statistics cache
@@ -157,12 +157,55 @@ QByteArray decoderFFmpeg::getRawFrameData()
 
   DEBUG_FFMPEG("decoderFFmpeg::getYUVFrameData Copy frame");
 
+  if (!this->currentOutputBufferValid)
+  {
+    this->copyCurImageToBuffer();
+    this->currentOutputBufferValid = true;
+  }
+
   if (this->currentOutputBuffer.isEmpty())
     DEBUG_FFMPEG("decoderFFmpeg::loadYUVFrameData empty buffer");
 
   return this->currentOutputBuffer;
 }
 
+FrameBuffer decoderFFmpeg::getFrameBuffer()
+{
+  if (this->decoderState != DecoderState::RetrieveFrames)
+  {
+    DEBUG_FFMPEG("decoderFFmpeg::getFrameBuffer: Wrong decoder state.");
+    return FrameBuffer();
+  }
+
+  // Only planar YUV can be handed out without copying. Everything else is converted in copyCurImageToBuffer.
+  const yuvPixelFormat pixFmt = this->getYUVPixelFormat();
+  if (!this->frame || this->rawFormat != raw_YUV || !pixFmt.planar || pixFmt.uvInterleaved)
+    return decoderBase::getFrameBuffer();
+
+  // Create a new reference to the frame. The frames from avcodec_receive_frame are always reference counted,
+  // so the new reference shares the buffers (and data pointers) with the decoded frame. The decoder will then
+  // not reuse the buffers until the FrameBuffer is released.
+  auto frameFree = this->ff.lib.av_frame_free;
+  std::shared_ptr<AVFrame> frameReference(this->ff.lib.av_frame_clone(this->frame.get_frame()), [frameFree](AVFrame *f)
+  {
+    frameFree(&f);
+  });
+  if (!frameReference)
+    return decoderBase::getFrameBuffer();
+
+  const auto nrBytesPerSample = pixFmt.bitsPerSample <= 8 ? 1 : 2;
+  FrameBuffer buffer(frameReference);
+  for (unsigned plane = 0; plane < pixFmt.getNrPlanes(); plane++)
+  {
+    const auto component = (plane == 0) ? Component::Luma : Component::Chroma;
+    const auto widthInBytes = this->frameSize.width() / pixFmt.getSubsamplingHor(component) * nrBytesPerSample;
+    const auto height = this->frameSize.height() / pixFmt.getSubsamplingVer(component);
+    buffer.addPlane(this->frame.get_data(plane), this->frame.get_line_size(plane), widthInBytes, height);
+  }
+  DEBUG_FFMPEG("decoderFFmpeg::getFrameBuffer referenced frame");
+  return buffer;
+}
+
 void decoderFFmpeg::copyCurImageToBuffer()
 {
   if (!frame)
@@ -455,6 +498,12 @@ bool decoderFFmpeg::createDecoder(AVCodecIDWrapper codecID, AVCodecParametersWra
   if (ret < 0)
     return this->setErrorB(QStringLiteral("Could not request motion vector retrieval. Return code %1").arg(ret));
 
+  // Use our share of the thread budget for frame and slice threading
+  const auto nrThreads = QString::number(this->getNrDecoderThreads());
+  ret = this->ff.av_dict_set(opts, "threads", nrThreads.toLatin1().constData(), 0);
+  if (ret < 0)
+    return this->setErrorB(QStringLiteral("Could not set the number of decoder threads. Return code %1").arg(ret));
+
   // Open codec
   ret = this->ff.avcodec_open2(decCtx, videoCodec, opts);
   if (ret < 0)
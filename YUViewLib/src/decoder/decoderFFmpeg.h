@@ -47,6 +47,7 @@ public:
   // Decoding / pushing data
   bool decodeNextFrame() Q_DECL_OVERRIDE;
   QByteArray getRawFrameData() Q_DECL_OVERRIDE;
+  FrameBuffer getFrameBuffer() Q_DECL_OVERRIDE;
   
   // Push an AVPacket or raw data. When this returns false, pushing the given packet failed. Probably the 
   // decoder switched to DecoderState::RetrieveFrames. Don't forget to push the given packet again later.
@@ -78,7 +79,9 @@ protected:
   // Statistics caching
   void cacheCurStatistics();
 
+  // The frame is only copied to the currentOutputBuffer if getRawFrameData is used.
   QByteArray currentOutputBuffer;
+  bool currentOutputBufferValid {false};
   void copyCurImageToBuffer();   // Copy the raw data from the de265_image source *src to the byte array
 
   // At the end of the file, when no more data is available, we will swith to flushing. After all
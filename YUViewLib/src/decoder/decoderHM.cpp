@@ -38,6 +38,7 @@
 #include <QSettings>
 
 #include "common/typedef.h"
+#include "video/PlaneCopy.h"
 
 // Debug the decoder ( 0:off 1:interactive deocder only 2:caching decoder only 3:both)
 #define DECODERHM_DEBUG_OUTPUT 0
@@ -54,21 +55,6 @@
 #define DEBUG_DECHM(fmt,...) ((void)0)
 #endif
 
-// Restrict is basically a promise to the compiler that for the scope of the pointer, the target of the pointer will only be accessed through that pointer (and pointers copied from it).
-#if __STDC__ != 1
-#    define restrict __restrict /* use implementation __ format */
-#else
-#    ifndef __STDC_VERSION__
-#        define restrict __restrict /* use implementation __ format */
-#    else
-#        if __STDC_VERSION__ < 199901L
-#            define restrict __restrict /* use implementation __ format */
-#        else
-#            /* all ok */
-#        endif
-#    endif
-#endif
-
 decoderHM_Functions::decoderHM_Functions() 
 { 
   memset(this, 0, sizeof(*this)); 
@@ -280,7 +266,7 @@ bool decoderHM::pushData(QByteArray &data)
   {
     decodedFrameWaiting = true;
     decoderState = DecoderState::RetrieveFrames;
-    currentOutputBuffer.clear();
+    currentOutputBufferValid = false;
   }
 
   // If bNewPicture is true, the decoder noticed that a new picture starts with this 
@@ -299,10 +285,11 @@ QByteArray decoderHM::getRawFrameData()
     return QByteArray();
   }
 
-  if (currentOutputBuffer.isEmpty())
+  if (!currentOutputBufferValid)
   {
     // Put image data into buffer
     copyImgToByteArray(currentHMPic, currentOutputBuffer);
+    currentOutputBufferValid = true;
     DEBUG_DECHM("decoderHM::getRawFrameData copied frame to buffer");
 
     if (retrieveStatistics)
@@ -340,8 +327,13 @@ void decoderHM::copyImgToByteArray(libHMDec_picture *src, QByteArray &dst)
   int nrBytesOutput = (outSizeY + outSizeCb + outSizeCr) * (outputTwoByte ? 2 : 1);
   DEBUG_DECHM("decoderHM::copyImgToByteArray nrBytesOutput %d", nrBytesOutput);
 
-  // Is the output big enough?
-  if (dst.capacity() < nrBytesOutput)
+  // The buffer is reused for the next frame. If the last frame is still referenced (e.g. by the
+  // cache), start a new buffer instead of letting QByteArray copy the old frame when detaching.
+#if !SSE_CONVERSION
+  if (!dst.isDetached())
+    dst.clear();
+#endif
+  if (dst.size() != nrBytesOutput)
     dst.resize(nrBytesOutput);
 
   // The source (from HM) is always short (16bit). The destination is a QByteArray so
@@ -361,39 +353,22 @@ void decoderHM::copyImgToByteArray(libHMDec_picture *src, QByteArray &dst)
 
     if (outputTwoByte)
     {
-      unsigned short * restrict d = (unsigned short*)dst.data();
+      unsigned short *d = (unsigned short*)dst.data();
       if (c > 0)
         d += outSizeY;
       if (c == 2)
         d += outSizeCb;
-
-      for (int y = 0; y < height; y++)
-      {
-        for (int x = 0; x < width; x++)
-        {
-          d[x] = (unsigned short)img_c[x];
-        }
-        img_c += stride;
-        d += width;
-      }
+      PlaneCopy::copy16Bit(img_c, stride, d, width, width, height);
     }
     else
     {
-      unsigned char * restrict d = (unsigned char*)dst.data();
+      // Output is one byte per pixel but HM internally always saves everything in two bytes per pixel
+      unsigned char *d = (unsigned char*)dst.data();
       if (c > 0)
         d += outSizeY;
       if (c == 2)
         d += outSizeCb;
-
-      for (int y = 0; y < height; y++)
-      {
-        for (int x = 0; x < width; x++)
-        {
-          d[x] = (char)img_c[x];
-        }
-        img_c += stride;
-        d += width;
-      }
+      PlaneCopy::narrow16BitTo8Bit(img_c, stride, d, width, width, height);
     }
   }
 }
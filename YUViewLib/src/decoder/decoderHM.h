@@ -144,4 +144,5 @@ private:
   QByteArray currentOutputBuffer;
   void copyImgToByteArray(libHMDec_picture *src, QByteArray &dst);   // Copy the raw data from the de265_image source *src to the byte array
 #endif  
+  bool currentOutputBufferValid {false};
 };
@@ -91,6 +91,18 @@ void decoderLibde265::resetDecoder()
   if (!decoder)
     return;
 
+  if (!flushing && allocatedLibraryConfig == getCurrentLibraryConfig())
+  {
+    // Nothing changed. Keep the decoder context and only drop its decoding state.
+    DEBUG_LIBDE265("decoderLibde265::resetDecoder reusing the decoder context");
+    de265_reset(decoder);
+    decoderBase::resetDecoder();
+    currentOutputBuffer.clear();
+    curImage = nullptr;
+    decodedFrameWaiting = false;
+    return;
+  }
+
   // Delete decoder
   de265_error err = de265_free_decoder(decoder);
   if (err != DE265_OK)
@@ -110,7 +122,11 @@ void decoderLibde265::setDecodeSignal(int signalID, bool &decoderResetNeeded)
     return;
   if (signalID >= 0 && signalID < nrSignalsSupported())
     decodeSignal = signalID;
-  decoderResetNeeded = true;
+  if (decodeAllSignals)
+    // All signals are saved by the decoder. Only the output buffer has to be filled again.
+    currentOutputBuffer.clear();
+  else
+    decoderResetNeeded = true;
 }
 
 void decoderLibde265::resolveLibraryFunctionPointers()
@@ -135,6 +151,7 @@ void decoderLibde265::resolveLibraryFunctionPointers()
   if (!resolve(de265_flush_data, "de265_flush_data")) return;
   if (!resolve(de265_get_next_picture, "de265_get_next_picture")) return;
   if (!resolve(de265_free_decoder, "de265_free_decoder")) return;
+  if (!resolve(de265_reset, "de265_reset")) return;
   DEBUG_LIBDE265("decoderLibde265::resolveLibraryFunctionPointers - decoding functions found");
 
   // Get pointers to the internals/statistics functions (if present)
@@ -201,7 +218,13 @@ void decoderLibde265::allocateNewDecoder()
   de265_set_parameter_bool(decoder, DE265_DECODER_PARAM_DISABLE_SAO, false);
 
   // Set retrieval of the right component
-  if (nrSignals > 0)
+  if (nrSignals > 0 && decodeAllSignals)
+  {
+    de265_internals_set_parameter_bool(decoder, DE265_INTERNALS_DECODER_PARAM_SAVE_PREDICTION, true);
+    de265_internals_set_parameter_bool(decoder, DE265_INTERNALS_DECODER_PARAM_SAVE_RESIDUAL, true);
+    de265_internals_set_parameter_bool(decoder, DE265_INTERNALS_DECODER_PARAM_SAVE_TR_COEFF, true);
+  }
+  else if (nrSignals > 0)
   {
     if (decodeSignal == 1)
       de265_internals_set_parameter_bool(decoder, DE265_INTERNALS_DECODER_PARAM_SAVE_PREDICTION, true);
@@ -221,8 +244,8 @@ void decoderLibde265::allocateNewDecoder()
   de265_set_limit_TID(decoder, 100);
 
   // Set the number of decoder threads. Libde265 can use wavefronts to utilize these.
-  // TODO: We should add a setting for this maybe?
-  de265_error err = de265_start_worker_threads(decoder, 8);
+  allocatedLibraryConfig = getCurrentLibraryConfig();
+  de265_error err = de265_start_worker_threads(decoder, allocatedLibraryConfig.nrThreads);
   if (err != DE265_OK)
     return setError("Error starting libde265 worker threads (de265_start_worker_threads)");
 
@@ -327,7 +350,7 @@ QByteArray decoderLibde265::getRawFrameData()
   if (currentOutputBuffer.isEmpty())
   {
     // Put image data into buffer
-    copyImgToByteArray(curImage, currentOutputBuffer);
+    copyImgToByteArray(curImage, currentOutputBuffer, decodeSignal);
     DEBUG_LIBDE265("decoderLibde265::getRawFrameData copied frame to buffer");
     
     if (retrieveStatistics)
@@ -338,6 +361,24 @@ QByteArray decoderLibde265::getRawFrameData()
   return currentOutputBuffer;
 }
 
+FrameBuffer decoderLibde265::getSignalFrameBuffer(int signalID)
+{
+  if (signalID == decodeSignal)
+    return getFrameBuffer();
+  if (!decodeAllSignals || signalID < 0 || signalID >= nrSignals || curImage == nullptr)
+    return FrameBuffer();
+  if (decoderState != DecoderState::RetrieveFrames)
+  {
+    DEBUG_LIBDE265("decoderLibde265::getSignalFrameBuffer: Wrong decoder state.");
+    return FrameBuffer();
+  }
+
+  QByteArray signalData;
+  copyImgToByteArray(curImage, signalData, signalID);
+  DEBUG_LIBDE265("decoderLibde265::getSignalFrameBuffer copied signal %d to buffer", signalID);
+  return FrameBuffer(signalData);
+}
+
 bool decoderLibde265::pushData(QByteArray &data) 
 {
   if (decoderState != DecoderState::NeedsMoreData)
@@ -387,9 +428,9 @@ bool decoderLibde265::pushData(QByteArray &data)
 }
 
 #if SSE_CONVERSION
-void decoderLibde265::copyImgToByteArray(const de265_image *src, byteArrayAligned &dst)
+void decoderLibde265::copyImgToByteArray(const de265_image *src, byteArrayAligned &dst, int signalID)
 #else
-void decoderLibde265::copyImgToByteArray(const de265_image *src, QByteArray &dst)
+void decoderLibde265::copyImgToByteArray(const de265_image *src, QByteArray &dst, int signalID)
 #endif
 {
   // How many image planes are there?
@@ -425,13 +466,13 @@ void decoderLibde265::copyImgToByteArray(const de265_image *src, QByteArray &dst
     const size_t widthInBytes = width * nrBytesPerSample;
 
     const uint8_t* img_c = nullptr;
-    if (decodeSignal == 0)
+    if (signalID == 0)
       img_c = de265_get_image_plane(src, c, &stride);
-    else if (decodeSignal == 1)
+    else if (signalID == 1)
       img_c = de265_internals_get_image_plane(src, DE265_INTERNALS_DECODER_PARAM_SAVE_PREDICTION, c, &stride);
-    else if (decodeSignal == 2)
+    else if (signalID == 2)
       img_c = de265_internals_get_image_plane(src, DE265_INTERNALS_DECODER_PARAM_SAVE_RESIDUAL, c, &stride);
-    else if (decodeSignal == 3)
+    else if (signalID == 3)
       img_c = de265_internals_get_image_plane(src, DE265_INTERNALS_DECODER_PARAM_SAVE_TR_COEFF, c, &stride);
       
     if (img_c == nullptr)
@@ -519,80 +560,89 @@ void decoderLibde265::cacheStatistics(const de265_image *img)
   QScopedArrayPointer<uint8_t> tuInfo(new uint8_t[widthInTUInfoUnits*heightInTUInfoUnits]);
   de265_internals_get_TUInfo_info(img, tuInfo.data());
 
-  for (int y = 0; y < heightInCB; y++)
+  // Parse the CBs in stripes of CTU rows. Only the top left unit of each CB adds statistics, so every CB
+  // is handled by exactly one stripe.
+  const int cbRowsPerCTB = ctb_size / cb_infoUnit_size;
+  auto parseCTBRows = [&](int ctbRowBegin, int ctbRowEnd, QHash<int, statisticsData> &stats)
   {
-    for (int x = 0; x < widthInCB; x++)
+    const int cbRowBegin = ctbRowBegin * cbRowsPerCTB;
+    const int cbRowEnd = std::min(ctbRowEnd * cbRowsPerCTB, heightInCB);
+    for (int y = cbRowBegin; y < cbRowEnd; y++)
     {
-      uint16_t val = cbInfoArr[ y * widthInCB + x ];
-
-      uint8_t log2_cbSize = (val & 7);	 // Extract lowest 3 bits;
+      for (int x = 0; x < widthInCB; x++)
+      {
+        uint16_t val = cbInfoArr[ y * widthInCB + x ];
 
-      if (log2_cbSize > 0) {
-        // We are in the top left position of a CB.
+        uint8_t log2_cbSize = (val & 7);	 // Extract lowest 3 bits;
 
-        // Get values of this CB
-        uint8_t cbSizePix = 1 << log2_cbSize;  // Size (w,h) in pixels
-        int cbPosX = x * cb_infoUnit_size;	   // Position of this CB in pixels
-        int cbPosY = y * cb_infoUnit_size;
-        uint8_t partMode = ((val >> 3) & 7);   // Extract next 3 bits (part size);
-        uint8_t predMode = ((val >> 6) & 3);   // Extract next 2 bits (prediction mode);
-        bool    pcmFlag  = (val & 256);		   // Next bit (PCM flag)
-        bool    tqBypass = (val & 512);        // Next bit (TransQuant bypass flag)
+        if (log2_cbSize > 0) {
+          // We are in the top left position of a CB.
 
-                                               // Set part mode (ID 1)
-        curPOCStats[1].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, partMode);
+          // Get values of this CB
+          uint8_t cbSizePix = 1 << log2_cbSize;  // Size (w,h) in pixels
+          int cbPosX = x * cb_infoUnit_size;	   // Position of this CB in pixels
+          int cbPosY = y * cb_infoUnit_size;
+          uint8_t partMode = ((val >> 3) & 7);   // Extract next 3 bits (part size);
+          uint8_t predMode = ((val >> 6) & 3);   // Extract next 2 bits (prediction mode);
+          bool    pcmFlag  = (val & 256);		   // Next bit (PCM flag)
+          bool    tqBypass = (val & 512);        // Next bit (TransQuant bypass flag)
 
-        // Set prediction mode (ID 2)
-        curPOCStats[2].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, predMode);
+                                                 // Set part mode (ID 1)
+          stats[1].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, partMode);
 
-        // Set PCM flag (ID 3)
-        curPOCStats[3].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, pcmFlag);
+          // Set prediction mode (ID 2)
+          stats[2].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, predMode);
 
-        // Set transQuant bypass flag (ID 4)
-        curPOCStats[4].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, tqBypass);
+          // Set PCM flag (ID 3)
+          stats[3].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, pcmFlag);
 
-        if (predMode != 0)
-        {
-          // For each of the prediction blocks set some info
+          // Set transQuant bypass flag (ID 4)
+          stats[4].addBlockValue(cbPosX, cbPosY, cbSizePix, cbSizePix, tqBypass);
 
-          int numPB = (partMode == 0) ? 1 : (partMode == 3) ? 4 : 2;
-          for (int i=0; i<numPB; i++)
+          if (predMode != 0)
           {
-            // Get pb position/size
-            int pbSubX, pbSubY, pbW, pbH;
-            getPBSubPosition(partMode, cbSizePix, i, &pbSubX, &pbSubY, &pbW, &pbH);
-            int pbX = cbPosX + pbSubX;
-            int pbY = cbPosY + pbSubY;
-
-            // Get index for this xy position in pb_info array
-            int pbIdx = (pbY / pb_infoUnit_size) * widthInPB + (pbX / pb_infoUnit_size);
-
-            // Add ref index 0 (ID 5)
-            int16_t ref0 = refPOC0[pbIdx];
-            if (ref0 != -1)
-              curPOCStats[5].addBlockValue(pbX, pbY, pbW, pbH, ref0-iPOC);
-
-            // Add ref index 1 (ID 6)
-            int16_t ref1 = refPOC1[pbIdx];
-            if (ref1 != -1)
-              curPOCStats[6].addBlockValue(pbX, pbY, pbW, pbH, ref1-iPOC);
-
-            // Add motion vector 0 (ID 7)
-            if (ref0 != -1)
-              curPOCStats[7].addBlockVector(pbX, pbY, pbW, pbH, vec0_x[pbIdx], vec0_y[pbIdx]);
-
-            // Add motion vector 1 (ID 8)
-            if (ref1 != -1)
-              curPOCStats[8].addBlockVector(pbX, pbY, pbW, pbH, vec1_x[pbIdx], vec1_y[pbIdx]);
+            // For each of the prediction blocks set some info
+
+            int numPB = (partMode == 0) ? 1 : (partMode == 3) ? 4 : 2;
+            for (int i=0; i<numPB; i++)
+            {
+              // Get pb position/size
+              int pbSubX, pbSubY, pbW, pbH;
+              getPBSubPosition(partMode, cbSizePix, i, &pbSubX, &pbSubY, &pbW, &pbH);
+              int pbX = cbPosX + pbSubX;
+              int pbY = cbPosY + pbSubY;
+
+              // Get index for this xy position in pb_info array
+              int pbIdx = (pbY / pb_infoUnit_size) * widthInPB + (pbX / pb_infoUnit_size);
+
+              // Add ref index 0 (ID 5)
+              int16_t ref0 = refPOC0[pbIdx];
+              if (ref0 != -1)
+                stats[5].addBlockValue(pbX, pbY, pbW, pbH, ref0-iPOC);
+
+              // Add ref index 1 (ID 6)
+              int16_t ref1 = refPOC1[pbIdx];
+              if (ref1 != -1)
+                stats[6].addBlockValue(pbX, pbY, pbW, pbH, ref1-iPOC);
+
+              // Add motion vector 0 (ID 7)
+              if (ref0 != -1)
+                stats[7].addBlockVector(pbX, pbY, pbW, pbH, vec0_x[pbIdx], vec0_y[pbIdx]);
+
+              // Add motion vector 1 (ID 8)
+              if (ref1 != -1)
+                stats[8].addBlockVector(pbX, pbY, pbW, pbH, vec1_x[pbIdx], vec1_y[pbIdx]);
+            }
           }
-        }
 
-        // Walk into the TU tree
-        int tuIdx = (cbPosY / tuInfo_unit_size) * widthInTUInfoUnits + (cbPosX / tuInfo_unit_size);
-        cacheStatistics_TUTree_recursive(tuInfo.data(), widthInTUInfoUnits, tuInfo_unit_size, iPOC, tuIdx, cbSizePix / tuInfo_unit_size, 0, predMode == 0, intraDirY.data(), intraDirC.data(), intraDir_infoUnit_size, widthInIntraDirUnits);
+          // Walk into the TU tree
+          int tuIdx = (cbPosY / tuInfo_unit_size) * widthInTUInfoUnits + (cbPosX / tuInfo_unit_size);
+          cacheStatistics_TUTree_recursive(stats, tuInfo.data(), widthInTUInfoUnits, tuInfo_unit_size, iPOC, tuIdx, cbSizePix / tuInfo_unit_size, 0, predMode == 0, intraDirY.data(), intraDirC.data(), intraDir_infoUnit_size, widthInIntraDirUnits);
+        }
       }
     }
-  }
+  };
+  cacheStatisticsInStripes(heightInCTB, parseCTBRows);
 }
 
 void decoderLibde265::getPBSubPosition(int partMode, int cbSizePix, int pbIdx, int *pbX, int *pbY, int *pbW, int *pbH) const
@@ -657,6 +707,7 @@ void decoderLibde265::getPBSubPosition(int partMode, int cbSizePix, int pbIdx, i
 }
 
 /* Walk into the TU tree and set the tree depth as a statistic value if the TU is not further split
+* \param stats: The statistics to add the TUs to
 * \param tuInfo: The tuInfo array
 * \param tuInfoWidth: The number of TU units per line in the tuInfo array
 * \param tuUnitSizePix: The size of one TU unit in pixels
@@ -666,17 +717,17 @@ void decoderLibde265::getPBSubPosition(int partMode, int cbSizePix, int pbIdx, i
 * \param trDepth: The current transform tree depth
 * \param isIntra: is the CU using intra prediction?
 */
-void decoderLibde265::cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, int tuInfoWidth, int tuUnitSizePix, int iPOC, int tuIdx, int tuWidth_units, int trDepth, bool isIntra, uint8_t *const intraDirY, uint8_t *const intraDirC, int intraDir_infoUnit_size, int widthInIntraDirUnits)
+void decoderLibde265::cacheStatistics_TUTree_recursive(QHash<int, statisticsData> &stats, uint8_t *const tuInfo, int tuInfoWidth, int tuUnitSizePix, int iPOC, int tuIdx, int tuWidth_units, int trDepth, bool isIntra, uint8_t *const intraDirY, uint8_t *const intraDirC, int intraDir_infoUnit_size, int widthInIntraDirUnits) const
 {
   // Check if the TU is further split.
   if (tuInfo[tuIdx] & (1 << trDepth))
   {
     // The transform is split further
     int yOffset = (tuWidth_units / 2) * tuInfoWidth;
-    cacheStatistics_TUTree_recursive(tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx                              , tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
-    cacheStatistics_TUTree_recursive(tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx           + tuWidth_units / 2, tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
-    cacheStatistics_TUTree_recursive(tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx + yOffset                    , tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
-    cacheStatistics_TUTree_recursive(tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx + yOffset + tuWidth_units / 2, tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
+    cacheStatistics_TUTree_recursive(stats, tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx                              , tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
+    cacheStatistics_TUTree_recursive(stats, tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx           + tuWidth_units / 2, tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
+    cacheStatistics_TUTree_recursive(stats, tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx + yOffset                    , tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
+    cacheStatistics_TUTree_recursive(stats, tuInfo, tuInfoWidth, tuUnitSizePix, iPOC, tuIdx + yOffset + tuWidth_units / 2, tuWidth_units / 2, trDepth+1, isIntra, intraDirY, intraDirC, intraDir_infoUnit_size, widthInIntraDirUnits);
   }
   else
   {
@@ -684,7 +735,7 @@ void decoderLibde265::cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, in
     int tuWidth = tuWidth_units * tuUnitSizePix;
     int posX = tuIdx % tuInfoWidth * tuUnitSizePix;
     int posY = tuIdx / tuInfoWidth * tuUnitSizePix;
-    curPOCStats[11].addBlockValue(posX, posY, tuWidth, tuWidth, trDepth);
+    stats[11].addBlockValue(posX, posY, tuWidth, tuWidth, trDepth);
 
     if (isIntra)
     {
@@ -713,14 +764,14 @@ void decoderLibde265::cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, in
       int intraDirLuma = intraDirY[intraDirIdx];
       if (intraDirLuma <= 34)
       {
-        curPOCStats[9].addBlockValue(posX, posY, tuWidth, tuWidth, intraDirLuma);
+        stats[9].addBlockValue(posX, posY, tuWidth, tuWidth, intraDirLuma);
 
         if (intraDirLuma >= 2)
         {
           // Set Intra prediction direction Luma (ID 9) as vector
           int vecX = (float)vectorTable[intraDirLuma][0] * tuWidth / 4;
           int vecY = (float)vectorTable[intraDirLuma][1] * tuWidth / 4;
-          curPOCStats[9].addBlockVector(posX, posY, tuWidth, tuWidth, vecX, vecY);
+          stats[9].addBlockVector(posX, posY, tuWidth, tuWidth, vecX, vecY);
         }
       }
 
@@ -728,14 +779,14 @@ void decoderLibde265::cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, in
       int intraDirChroma = intraDirC[intraDirIdx];
       if (intraDirChroma <= 34)
       {
-        curPOCStats[10].addBlockValue(posX, posY, tuWidth, tuWidth, intraDirChroma);
+        stats[10].addBlockValue(posX, posY, tuWidth, tuWidth, intraDirChroma);
 
         if (intraDirChroma >= 2)
         {
           // Set Intra prediction direction Chroma (ID 10) as vector
           int vecX = (float)vectorTable[intraDirChroma][0] * tuWidth / 4;
           int vecY = (float)vectorTable[intraDirChroma][1] * tuWidth / 4;
-          curPOCStats[10].addBlockVector(posX, posY, tuWidth, tuWidth, vecX, vecY);
+          stats[10].addBlockVector(posX, posY, tuWidth, tuWidth, vecX, vecY);
         }
       }
     }
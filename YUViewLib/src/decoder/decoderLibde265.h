@@ -62,6 +62,7 @@ struct decoderLibde265_Functions
   de265_error            (*de265_flush_data)           (de265_decoder_context*);
   const de265_image*     (*de265_get_next_picture)     (de265_decoder_context*);
   de265_error            (*de265_free_decoder)         (de265_decoder_context*);
+  void                   (*de265_reset)                (de265_decoder_context*);
 
   // libde265 decoder library function pointers for internals
   void (*de265_internals_get_CTB_Info_Layout)		   (const de265_image*, int*, int*, int*);
@@ -93,10 +94,12 @@ public:
   bool isSignalDifference(int signalID) const Q_DECL_OVERRIDE { return signalID == 2 || signalID == 3; }
   QStringList getSignalNames() const Q_DECL_OVERRIDE { return QStringList() << "Reconstruction" << "Prediction" << "Residual" << "Transform Coefficients"; }
   void setDecodeSignal(int signalID, bool &decoderResetNeeded) Q_DECL_OVERRIDE;
+  bool supportsSinglePassSignals() const Q_DECL_OVERRIDE { return nrSignals > 1; }
 
   // Decoding / pushing data
   bool decodeNextFrame() Q_DECL_OVERRIDE;
   QByteArray getRawFrameData() Q_DECL_OVERRIDE;
+  FrameBuffer getSignalFrameBuffer(int signalID) Q_DECL_OVERRIDE;
   bool pushData(QByteArray &data) Q_DECL_OVERRIDE;
   
   // Statistics
@@ -148,15 +151,15 @@ private:
   // With the given partitioning mode, the size of the CU and the prediction block index, calculate the
   // sub-position and size of the prediction block
   void getPBSubPosition(int partMode, int CUSizePix, int pbIdx, int *pbX, int *pbY, int *pbW, int *pbH) const;
-  void cacheStatistics_TUTree_recursive(uint8_t *const tuInfo, int tuInfoWidth, int tuUnitSizePix, int iPOC, int tuIdx, int tuWidth_units, int trDepth, bool isIntra, uint8_t *const intraDirY, uint8_t *const intraDirC, int intraDir_infoUnit_size, int widthInIntraDirUnits);
+  void cacheStatistics_TUTree_recursive(QHash<int, statisticsData> &stats, uint8_t *const tuInfo, int tuInfoWidth, int tuUnitSizePix, int iPOC, int tuIdx, int tuWidth_units, int trDepth, bool isIntra, uint8_t *const intraDirY, uint8_t *const intraDirC, int intraDir_infoUnit_size, int widthInIntraDirUnits) const;
 
   // We buffer the current image as a QByteArray so you can call getYUVFrameData as often as necessary
   // without invoking the copy operation from the libde265 buffer to the QByteArray again.
 #if SSE_CONVERSION
   byteArrayAligned currentOutputBuffer;
-  void copyImgToByteArray(const de265_image *src, byteArrayAligned &dst);
+  void copyImgToByteArray(const de265_image *src, byteArrayAligned &dst, int signalID);
 #else
   QByteArray currentOutputBuffer;
-  void copyImgToByteArray(const de265_image *src, QByteArray &dst);   // Copy the raw data from the de265_image source *src to the byte array
+  void copyImgToByteArray(const de265_image *src, QByteArray &dst, int signalID);   // Copy the raw data of the given signal from the de265_image source *src to the byte array
 #endif
 };
@@ -138,4 +138,5 @@ private:
   QByteArray currentOutputBuffer;
   void copyImgToByteArray(libVTMDec_picture *src, QByteArray &dst);   // Copy the raw data from the de265_image source *src to the byte array
 #endif  
+  bool currentOutputBufferValid {false};
 };
@@ -869,6 +869,7 @@ FFmpegLibraryFunctions::FFmpegLibraryFunctions()
 
   av_frame_alloc = nullptr;
   av_frame_free = nullptr;
+  av_frame_clone = nullptr;
   av_mallocz = nullptr;
   avutil_version = nullptr;
 
@@ -920,6 +921,7 @@ bool FFmpegLibraryFunctions::bindFunctionsFromAVUtilLib()
 {
   if (!resolveAvUtil(av_frame_alloc, "av_frame_alloc")) return false;
   if (!resolveAvUtil(av_frame_free, "av_frame_free")) return false;
+  if (!resolveAvUtil(av_frame_clone, "av_frame_clone")) return false;
   if (!resolveAvUtil(av_mallocz, "av_mallocz")) return false;
   if (!resolveAvUtil(avutil_version, "avutil_version")) return false;
   if (!resolveAvUtil(av_dict_set, "av_dict_set")) return false;
@@ -96,6 +96,7 @@ public:
   // From avutil
   AVFrame                  *(*av_frame_alloc)         (void);
   void                      (*av_frame_free)          (AVFrame **frame);
+  AVFrame                  *(*av_frame_clone)         (const AVFrame *src);
   void                     *(*av_mallocz)             (size_t size);
   unsigned                  (*avutil_version)         (void);
   int                       (*av_dict_set)            (AVDictionary **pm, const char *key, const char *value, int flags);
@@ -404,6 +405,8 @@ public:
   int get_frame_height();
   AVColorSpace get_colorspace();
   int get_index() { update(); return index; }
+  // The format specific stream id (e.g. the track ID in MP4 or the PID in MPEG-TS)
+  int get_id() { update(); return id; }
 
   AVCodecParametersWrapper get_codecpar() { update(); return codecpar; }
 
@@ -0,0 +1,617 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ContainerIndex.h"
+
+#include <QFile>
+#include <QPair>
+#include <QVector>
+
+#define CONTAINERINDEX_DEBUG_OUTPUT 0
+#if CONTAINERINDEX_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_INDEX(msg) qDebug() << msg
+#else
+#define DEBUG_INDEX(msg) ((void)0)
+#endif
+
+namespace
+{
+
+uint64_t readBigEndian(const char *data, int nrBytes)
+{
+  uint64_t value = 0;
+  for (int i = 0; i < nrBytes; i++)
+    value = (value << 8) | uint8_t(data[i]);
+  return value;
+}
+
+bool readBigEndian(QFile &file, int nrBytes, uint64_t &value)
+{
+  char data[8];
+  if (file.read(data, nrBytes) != nrBytes)
+    return false;
+  value = readBigEndian(data, nrBytes);
+  return true;
+}
+
+// ------------------------------------ MP4 ------------------------------------
+
+constexpr uint32_t fourCC(const char *s)
+{
+  return (uint32_t(uint8_t(s[0])) << 24) | (uint32_t(uint8_t(s[1])) << 16) | (uint32_t(uint8_t(s[2])) << 8) | uint32_t(uint8_t(s[3]));
+}
+
+struct BoxHeader
+{
+  uint32_t type {0};
+  int64_t bodyStart {0};
+  int64_t end {0};
+};
+
+bool readBoxHeader(QFile &file, int64_t parentEnd, BoxHeader &header)
+{
+  const auto start = file.pos();
+  if (start + 8 > parentEnd)
+    return false;
+
+  uint64_t size, type;
+  if (!readBigEndian(file, 4, size) || !readBigEndian(file, 4, type))
+    return false;
+  header.type = uint32_t(type);
+  header.bodyStart = start + 8;
+  if (size == 1)
+  {
+    if (!readBigEndian(file, 8, size))
+      return false;
+    header.bodyStart += 8;
+  }
+  else if (size == 0)
+    // The box extends to the end of the parent (the file)
+    size = uint64_t(parentEnd - start);
+
+  header.end = start + int64_t(size);
+  return int64_t(size) >= header.bodyStart - start && header.end <= parentEnd;
+}
+
+struct MP4Track
+{
+  int64_t trackID {-1};
+  bool isVideo {false};
+  // stts: (sample_count, sample_delta)
+  QVector<QPair<uint32_t, uint32_t>> timeToSample;
+  bool hasSyncSampleTable {false};
+  QVector<uint32_t> syncSamples;
+  int64_t sampleCount {0};
+};
+
+bool readFullBoxBody(QFile &file, const BoxHeader &box, QByteArray &body)
+{
+  body = file.read(box.end - box.bodyStart);
+  // All full boxes start with version and flags (4 bytes)
+  return body.size() == box.end - box.bodyStart && body.size() >= 4;
+}
+
+bool parseMP4TrackBoxes(QFile &file, int64_t end, MP4Track &track)
+{
+  BoxHeader box;
+  while (file.pos() < end)
+  {
+    if (!readBoxHeader(file, end, box))
+      return false;
+
+    const auto type = box.type;
+    if (type == fourCC("mdia") || type == fourCC("minf") || type == fourCC("stbl"))
+    {
+      if (!parseMP4TrackBoxes(file, box.end, track))
+        return false;
+    }
+    else if (type == fourCC("tkhd") || type == fourCC("hdlr") || type == fourCC("stts") || 
+             type == fourCC("stss") || type == fourCC("stsz") || type == fourCC("stz2"))
+    {
+      // These are small except for stss and stts which contain one entry per sync sample / timing run
+      QByteArray body;
+      if (!readFullBoxBody(file, box, body))
+        return false;
+      const auto data = body.constData();
+      const auto version = uint8_t(data[0]);
+
+      if (type == fourCC("tkhd"))
+      {
+        const auto pos = (version == 1) ? 20 : 12;
+        if (body.size() < pos + 4)
+          return false;
+        track.trackID = int64_t(readBigEndian(data + pos, 4));
+      }
+      else if (type == fourCC("hdlr"))
+      {
+        if (body.size() < 12)
+          return false;
+        track.isVideo = (uint32_t(readBigEndian(data + 8, 4)) == fourCC("vide"));
+      }
+      else if (type == fourCC("stts") || type == fourCC("stss"))
+      {
+        if (body.size() < 8)
+          return false;
+        const auto entrySize = (type == fourCC("stts")) ? 8 : 4;
+        const auto nrEntries = int64_t(readBigEndian(data + 4, 4));
+        if (body.size() < 8 + nrEntries * entrySize)
+          return false;
+        for (int64_t i = 0; i < nrEntries; i++)
+        {
+          const auto entry = data + 8 + i * entrySize;
+          if (type == fourCC("stts"))
+            track.timeToSample.append({uint32_t(readBigEndian(entry, 4)), uint32_t(readBigEndian(entry + 4, 4))});
+          else
+            track.syncSamples.append(uint32_t(readBigEndian(entry, 4)));
+        }
+        if (type == fourCC("stss"))
+          track.hasSyncSampleTable = true;
+      }
+      else if (type == fourCC("stsz") || type == fourCC("stz2"))
+      {
+        if (body.size() < 12)
+          return false;
+        track.sampleCount = int64_t(readBigEndian(data + 8, 4));
+      }
+    }
+
+    if (!file.seek(box.end))
+      return false;
+  }
+  return true;
+}
+
+// ---------------------------------- Matroska ----------------------------------
+
+const uint32_t EBMLHeaderID = 0x1A45DFA3;
+const uint32_t SegmentID = 0x18538067;
+const uint32_t ClusterID = 0x1F43B675;
+const uint32_t TimecodeID = 0xE7;
+const uint32_t SimpleBlockID = 0xA3;
+const uint32_t BlockGroupID = 0xA0;
+const uint32_t BlockID = 0xA1;
+const uint32_t ReferenceBlockID = 0xFB;
+const uint32_t TracksID = 0x1654AE6B;
+const uint32_t TrackEntryID = 0xAE;
+const uint32_t TrackNumberID = 0xD7;
+const uint32_t TrackTypeID = 0x83;
+const int64_t MatroskaTrackTypeVideo = 1;
+
+// Read a variable size integer. The ID keeps the length marker bits, sizes don't.
+bool readEBMLVariableInt(QFile &file, bool keepMarker, uint64_t &value, int &length)
+{
+  char firstByte;
+  if (!file.getChar(&firstByte))
+    return false;
+  const auto first = uint8_t(firstByte);
+  if (first == 0)
+    return false;
+
+  length = 1;
+  while ((first & (0x80 >> (length - 1))) == 0)
+    length++;
+
+  value = keepMarker ? first : (first & (0xFF >> length));
+  for (int i = 1; i < length; i++)
+  {
+    char c;
+    if (!file.getChar(&c))
+      return false;
+    value = (value << 8) | uint8_t(c);
+  }
+  return true;
+}
+
+struct EBMLElement
+{
+  uint32_t id {0};
+  bool unknownSize {false};
+  int64_t bodyStart {0};
+  int64_t end {0};
+};
+
+bool readEBMLElement(QFile &file, int64_t parentEnd, EBMLElement &element)
+{
+  uint64_t id, size;
+  int idLength, sizeLength;
+  if (!readEBMLVariableInt(file, true, id, idLength) || idLength > 4)
+    return false;
+  if (!readEBMLVariableInt(file, false, size, sizeLength))
+    return false;
+
+  element.id = uint32_t(id);
+  element.bodyStart = file.pos();
+  // All bits of the size set means that the size is unknown
+  element.unknownSize = (size == (uint64_t(1) << (7 * sizeLength)) - 1);
+  element.end = element.unknownSize ? parentEnd : element.bodyStart + int64_t(size);
+  return element.end <= parentEnd;
+}
+
+bool readEBMLUInt(QFile &file, const EBMLElement &element, uint64_t &value)
+{
+  const auto length = int(element.end - element.bodyStart);
+  if (length > 8)
+    return false;
+  if (length == 0)
+  {
+    value = 0;
+    return true;
+  }
+  return readBigEndian(file, length, value);
+}
+
+struct MatroskaBlockHeader
+{
+  uint64_t trackNumber {0};
+  int16_t relativeTimecode {0};
+  uint8_t flags {0};
+};
+
+bool readMatroskaBlockHeader(QFile &file, MatroskaBlockHeader &header)
+{
+  int length;
+  if (!readEBMLVariableInt(file, false, header.trackNumber, length))
+    return false;
+  char data[3];
+  if (file.read(data, 3) != 3)
+    return false;
+  header.relativeTimecode = int16_t(readBigEndian(data, 2));
+  header.flags = uint8_t(data[2]);
+  return true;
+}
+
+// ---------------------------------- MPEG-TS ----------------------------------
+
+const int TSPacketSize = 188;
+const char TSSyncByte = 0x47;
+
+// Return the packet size (188 for TS or 192 for M2TS) and the offset of the sync byte. 0 if this is not a transport stream.
+int getTSPacketSize(const QByteArray &fileStart, int &syncOffset)
+{
+  for (const auto packetSize : {TSPacketSize, TSPacketSize + 4})
+  {
+    syncOffset = packetSize - TSPacketSize;
+    if (fileStart.size() < syncOffset + packetSize * 2 + 1)
+      continue;
+    if (fileStart[syncOffset] == TSSyncByte && fileStart[syncOffset + packetSize] == TSSyncByte && fileStart[syncOffset + packetSize * 2] == TSSyncByte)
+      return packetSize;
+  }
+  return 0;
+}
+
+int64_t readPESTimestamp(const uint8_t *data)
+{
+  return (int64_t(data[0] >> 1) & 0x07) << 30 | int64_t(data[1]) << 22 | int64_t(data[2] >> 1) << 15 | int64_t(data[3]) << 7 | int64_t(data[4] >> 1);
+}
+
+} // namespace
+
+bool ContainerIndex::readIndex(const QString &fileName, int streamID)
+{
+  this->nrFrames = 0;
+  this->keyFrames.clear();
+  this->firstSamples.clear();
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  this->container = detectContainer(file.read(1024));
+  file.seek(0);
+
+  bool success = false;
+  if (this->container == Container::MP4)
+    success = this->readMP4(file, streamID);
+  else if (this->container == Container::Matroska)
+    success = this->readMatroska(file, streamID);
+  else if (this->container == Container::MPEGTS)
+    success = this->readMPEGTS(file, streamID);
+
+  DEBUG_INDEX("ContainerIndex::readIndex " << fileName << " success " << success << " frames " << this->nrFrames << " keyframes " << this->keyFrames.size());
+  return success && this->nrFrames > 0 && !this->keyFrames.isEmpty();
+}
+
+ContainerIndex::Container ContainerIndex::detectContainer(const QByteArray &fileStart)
+{
+  if (fileStart.size() >= 8)
+  {
+    const auto type = uint32_t(readBigEndian(fileStart.constData() + 4, 4));
+    for (const auto boxType : {"ftyp", "moov", "mdat", "free", "skip", "wide"})
+      if (type == fourCC(boxType))
+        return Container::MP4;
+  }
+  if (fileStart.size() >= 4 && uint32_t(readBigEndian(fileStart.constData(), 4)) == EBMLHeaderID)
+    return Container::Matroska;
+  int syncOffset;
+  if (getTSPacketSize(fileStart, syncOffset) > 0)
+    return Container::MPEGTS;
+  return Container::Unknown;
+}
+
+bool ContainerIndex::readMP4(QFile &file, int trackID)
+{
+  const auto fileSize = file.size();
+  BoxHeader box;
+  bool moovFound = false;
+  MP4Track videoTrack;
+  while (file.pos() < fileSize && !moovFound)
+  {
+    if (!readBoxHeader(file, fileSize, box))
+      return false;
+
+    if (box.type == fourCC("moov"))
+    {
+      moovFound = true;
+      // Go through all tracks in the moov box. The big media data (mdat) is never read.
+      BoxHeader trakBox;
+      while (file.pos() < box.end)
+      {
+        if (!readBoxHeader(file, box.end, trakBox))
+          return false;
+        if (trakBox.type == fourCC("trak"))
+        {
+          MP4Track track;
+          if (!parseMP4TrackBoxes(file, trakBox.end, track))
+            return false;
+          if (track.trackID == trackID)
+            videoTrack = track;
+        }
+        else if (trakBox.type == fourCC("mvex"))
+        {
+          // Fragmented MP4. The samples are in the moof boxes.
+          DEBUG_INDEX("ContainerIndex::readMP4 fragmented files are not supported");
+          return false;
+        }
+        if (!file.seek(trakBox.end))
+          return false;
+      }
+    }
+    if (!file.seek(box.end))
+      return false;
+  }
+
+  if (!moovFound || videoTrack.trackID != trackID || !videoTrack.isVideo || videoTrack.sampleCount == 0)
+    return false;
+
+  int64_t dts = 0;
+  int64_t sampleNumber = 1;
+  int syncSampleIdx = 0;
+  for (const auto &entry : videoTrack.timeToSample)
+  {
+    for (uint32_t i = 0; i < entry.first && sampleNumber <= videoTrack.sampleCount; i++)
+    {
+      bool keyframe = true;
+      if (videoTrack.hasSyncSampleTable)
+      {
+        while (syncSampleIdx < videoTrack.syncSamples.size() && videoTrack.syncSamples[syncSampleIdx] < sampleNumber)
+          syncSampleIdx++;
+        keyframe = (syncSampleIdx < videoTrack.syncSamples.size() && videoTrack.syncSamples[syncSampleIdx] == sampleNumber);
+      }
+      this->addSample(dts, keyframe);
+      dts += entry.second;
+      sampleNumber++;
+    }
+  }
+
+  // The time to sample table must cover all samples
+  return this->nrFrames == videoTrack.sampleCount;
+}
+
+bool ContainerIndex::readMatroska(QFile &file, int trackNumber)
+{
+  const auto fileSize = file.size();
+  EBMLElement element;
+  if (!readEBMLElement(file, fileSize, element) || element.id != EBMLHeaderID || !file.seek(element.end))
+    return false;
+  if (!readEBMLElement(file, fileSize, element) || element.id != SegmentID)
+    return false;
+  const auto segmentEnd = element.end;
+
+  // All level 1 elements are processed in one flat loop. The children of a cluster are handled in this loop as well.
+  // This way, clusters with an unknown size (live streams) are supported.
+  bool videoTrackFound = false;
+  int64_t clusterTimecode = 0;
+  while (file.pos() < segmentEnd)
+  {
+    if (!readEBMLElement(file, segmentEnd, element))
+      // Probably a truncated file. Use what we have.
+      break;
+
+    if (element.id == ClusterID)
+      continue;
+    if (element.unknownSize)
+      return false;
+
+    if (element.id == TimecodeID)
+    {
+      uint64_t timecode;
+      if (!readEBMLUInt(file, element, timecode))
+        return false;
+      clusterTimecode = int64_t(timecode);
+    }
+    else if (element.id == TracksID)
+    {
+      EBMLElement trackEntry;
+      while (file.pos() < element.end)
+      {
+        if (!readEBMLElement(file, element.end, trackEntry))
+          return false;
+        if (trackEntry.id == TrackEntryID)
+        {
+          EBMLElement child;
+          uint64_t number = 0, type = 0;
+          while (file.pos() < trackEntry.end)
+          {
+            if (!readEBMLElement(file, trackEntry.end, child))
+              return false;
+            if (child.id == TrackNumberID && !readEBMLUInt(file, child, number))
+              return false;
+            if (child.id == TrackTypeID && !readEBMLUInt(file, child, type))
+              return false;
+            if (!file.seek(child.end))
+              return false;
+          }
+          if (number == uint64_t(trackNumber) && type == MatroskaTrackTypeVideo)
+            videoTrackFound = true;
+        }
+        if (!file.seek(trackEntry.end))
+          return false;
+      }
+    }
+    else if (element.id == SimpleBlockID || element.id == BlockGroupID)
+    {
+      MatroskaBlockHeader header;
+      bool blockFound = false;
+      bool keyframe = false;
+      if (element.id == SimpleBlockID)
+      {
+        if (!readMatroskaBlockHeader(file, header))
+          return false;
+        blockFound = true;
+        keyframe = (header.flags & 0x80);
+      }
+      else
+      {
+        // In a block group, a block is a keyframe if it does not reference any other block
+        bool hasReference = false;
+        EBMLElement child;
+        while (file.pos() < element.end)
+        {
+          if (!readEBMLElement(file, element.end, child))
+            return false;
+          if (child.id == BlockID)
+          {
+            if (!readMatroskaBlockHeader(file, header))
+              return false;
+            blockFound = true;
+          }
+          else if (child.id == ReferenceBlockID)
+            hasReference = true;
+          if (!file.seek(child.end))
+            return false;
+        }
+        keyframe = !hasReference;
+      }
+
+      if (blockFound && header.trackNumber == uint64_t(trackNumber))
+      {
+        if ((header.flags & 0x06) != 0)
+        {
+          // Laced blocks contain multiple frames. This is very uncommon for video and we don't know the frame timestamps.
+          DEBUG_INDEX("ContainerIndex::readMatroska laced video blocks are not supported");
+          return false;
+        }
+        this->addSample(clusterTimecode + header.relativeTimecode, keyframe);
+      }
+    }
+
+    if (!file.seek(element.end))
+      return false;
+  }
+
+  return videoTrackFound;
+}
+
+bool ContainerIndex::readMPEGTS(QFile &file, int pid)
+{
+  int syncOffset;
+  const auto packetSize = getTSPacketSize(file.read(1024), syncOffset);
+  if (packetSize == 0 || !file.seek(0))
+    return false;
+
+  // Only the PES headers of the given PID are parsed. The timestamps are unwrapped (33 bit).
+  const int64_t wrapValue = int64_t(1) << 33;
+  int64_t lastTimestamp = -1;
+  int64_t wrapOffset = 0;
+  const auto nrPacketsPerRead = 4096;
+  while (!file.atEnd())
+  {
+    const auto data = file.read(packetSize * nrPacketsPerRead);
+    const auto nrPackets = data.size() / packetSize;
+    for (int i = 0; i < nrPackets; i++)
+    {
+      const auto packet = reinterpret_cast<const uint8_t *>(data.constData() + i * packetSize + syncOffset);
+      if (packet[0] != uint8_t(TSSyncByte))
+      {
+        DEBUG_INDEX("ContainerIndex::readMPEGTS lost sync");
+        return false;
+      }
+
+      const auto packetPID = (int(packet[1] & 0x1F) << 8) | packet[2];
+      const bool payloadUnitStart = (packet[1] & 0x40);
+      if (packetPID != pid || !payloadUnitStart)
+        continue;
+
+      const auto adaptationFieldControl = (packet[3] >> 4) & 0x03;
+      int pos = 4;
+      bool randomAccess = false;
+      if (adaptationFieldControl & 0x02)
+      {
+        const auto adaptationFieldLength = packet[4];
+        if (adaptationFieldLength > 0)
+          randomAccess = (packet[5] & 0x40);
+        pos += 1 + adaptationFieldLength;
+      }
+      if ((adaptationFieldControl & 0x01) == 0 || pos + 19 > TSPacketSize)
+        continue;
+
+      // PES header
+      const auto pes = packet + pos;
+      if (pes[0] != 0 || pes[1] != 0 || pes[2] != 1)
+        continue;
+      const auto ptsDtsFlags = (pes[7] >> 6) & 0x03;
+      if ((ptsDtsFlags & 0x02) == 0)
+        // Without a timestamp we can not seek to this frame
+        return false;
+      auto timestamp = readPESTimestamp(pes + ((ptsDtsFlags == 3) ? 14 : 9));
+
+      if (lastTimestamp >= 0 && timestamp + wrapOffset < lastTimestamp - wrapValue / 2)
+        wrapOffset += wrapValue;
+      timestamp += wrapOffset;
+      lastTimestamp = timestamp;
+
+      this->addSample(timestamp, randomAccess);
+    }
+  }
+
+  return true;
+}
+
+void ContainerIndex::addSample(int64_t timestamp, bool keyframe)
+{
+  if (this->firstSamples.size() < nrFirstSamples)
+    this->firstSamples.append({timestamp, keyframe});
+  if (keyframe)
+    this->keyFrames.append({this->nrFrames, timestamp});
+  this->nrFrames++;
+}
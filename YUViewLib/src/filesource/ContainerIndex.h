@@ -0,0 +1,99 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+class QFile;
+
+/* Read the seek index (the number of frames and the position of all keyframes) of one stream
+ * directly from the container without demuxing the packets:
+ * - MP4/MOV: From the sample tables of the track (stts, stss, stsz/stz2)
+ * - Matroska/WebM: From the block headers in the clusters. The payload of the blocks is skipped.
+ * - MPEG-TS: From the PES headers (DTS/PTS) and the random access indicator of the stream PID.
+ * The timestamps are in the time base of the container which is also used by libavformat. However, libavformat
+ * may shift the timestamps by a constant offset (e.g. for edit lists). So the index should be checked against
+ * the first packets that libavformat returns.
+ */
+class ContainerIndex
+{
+public:
+  enum class Container
+  {
+    Unknown,
+    MP4,
+    Matroska,
+    MPEGTS
+  };
+
+  struct Sample
+  {
+    int64_t timestamp;
+    bool keyframe;
+  };
+
+  struct KeyFrame
+  {
+    int64_t frame;
+    int64_t timestamp;
+  };
+
+  // Read the index of the stream with the given ID. This is the AVStream id of libavformat which is the
+  // track ID in MP4, the track number in Matroska and the PID in MPEG-TS. Return false if the index
+  // could not be read (unknown container, fragmented MP4, laced Matroska blocks ...).
+  bool readIndex(const QString &fileName, int streamID);
+
+  static Container detectContainer(const QByteArray &fileStart);
+
+  Container getContainer() const { return this->container; }
+  int64_t getNrFrames() const { return this->nrFrames; }
+  const QList<KeyFrame> &getKeyFrames() const { return this->keyFrames; }
+  // The first samples in decoding order which can be used to verify the index
+  const QList<Sample> &getFirstSamples() const { return this->firstSamples; }
+
+  static const int nrFirstSamples = 16;
+
+private:
+  bool readMP4(QFile &file, int trackID);
+  bool readMatroska(QFile &file, int trackNumber);
+  bool readMPEGTS(QFile &file, int pid);
+
+  void addSample(int64_t timestamp, bool keyframe);
+
+  Container container {Container::Unknown};
+  int64_t nrFrames {0};
+  QList<KeyFrame> keyFrames;
+  QList<Sample> firstSamples;
+};
@@ -35,6 +35,7 @@
 #include <QSettings>
 #include <QProgressDialog>
 
+#include "ContainerIndex.h"
 #include "parser/common/SubByteReader.h"
 
 #define FILESOURCEFFMPEGFILE_DEBUG_OUTPUT 0
@@ -357,8 +358,12 @@ bool FileSourceFFmpegFile::openFile(const QString &filePath, QWidget *mainWindow
   }
   else if (parseFile)
   {
-    if (!scanBitstream(mainWindow))
-      return false;
+    if (!readContainerIndex())
+    {
+      seekFileToBeginning();
+      if (!scanBitstream(mainWindow))
+        return false;
+    }
     
     seekFileToBeginning();
   }
@@ -422,12 +427,17 @@ bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
   }
 
   nrFrames = 0;
+  keyFrameList.clear();
   while (goToNextPacket(true))
   {
     DEBUG_FFMPEG("FileSourceFFmpegFile::scanBitstream: frame %d pts %d dts %d%s", nrFrames, (int)pkt.get_pts(), (int)pkt.get_dts(), pkt.get_flag_keyframe() ? " - keyframe" : "");
 
     if (pkt.get_flag_keyframe())
-      keyFrameList.append(pictureIdx(nrFrames, pkt.get_dts()));
+    {
+      // Some containers (e.g. Matroska) only provide a pts
+      const auto dts = pkt.get_dts();
+      keyFrameList.append(pictureIdx(nrFrames, (dts == AV_NOPTS_VALUE) ? pkt.get_pts() : dts));
+    }
 
     if (progress && progress->wasCanceled())
       return false;
@@ -446,7 +456,44 @@ bool FileSourceFFmpegFile::scanBitstream(QWidget *mainWindow)
   }
 
   DEBUG_FFMPEG("FileSourceFFmpegFile::scanBitstream: Scan done. Found %d frames and %d keyframes.", nrFrames, keyFrameList.length());
-  return !progress->wasCanceled();
+  return !progress || !progress->wasCanceled();
+}
+
+bool FileSourceFFmpegFile::readContainerIndex()
+{
+  if (!isFileOpened)
+    return false;
+
+  ContainerIndex index;
+  if (!index.readIndex(fullFilePath, video_stream.get_id()))
+    return false;
+
+  // libavformat may apply a constant offset to the timestamps (e.g. for edit lists in MP4).
+  // Compare the first packets with the index and get the offset.
+  int64_t offset = 0;
+  const auto &firstSamples = index.getFirstSamples();
+  for (int i = 0; i < firstSamples.size(); i++)
+  {
+    if (!goToNextPacket(true))
+      break;
+    const auto dts = pkt.get_dts();
+    const auto timestamp = (dts == AV_NOPTS_VALUE) ? pkt.get_pts() : dts;
+    if (i == 0)
+      offset = timestamp - firstSamples[0].timestamp;
+    if (timestamp - offset != firstSamples[i].timestamp || pkt.get_flag_keyframe() != firstSamples[i].keyframe)
+    {
+      DEBUG_FFMPEG("FileSourceFFmpegFile::readContainerIndex: Index does not match packet %d. Falling back to scanning.", i);
+      return false;
+    }
+  }
+
+  nrFrames = int(index.getNrFrames());
+  keyFrameList.clear();
+  for (const auto &keyFrame : index.getKeyFrames())
+    keyFrameList.append(pictureIdx(keyFrame.frame, keyFrame.timestamp + offset));
+
+  DEBUG_FFMPEG("FileSourceFFmpegFile::readContainerIndex: Found %d frames and %d keyframes in the container index.", nrFrames, keyFrameList.length());
+  return true;
 }
 
 void FileSourceFFmpegFile::openFileAndFindVideoStream(QString fileName)
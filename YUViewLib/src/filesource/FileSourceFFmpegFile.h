@@ -157,6 +157,10 @@ protected:
   // the PTS values of keyframes that we can start decoding at.
   // If a mainWindow pointer is given, open a progress dialog. Return true on success. False if the process was canceled.
   bool scanBitstream(QWidget *mainWindow);
+  // Try to get the frame count and the keyframes from the index in the container (MP4, Matroska, MPEG-TS)
+  // without reading all packets. The index is checked against the first packets from libavformat.
+  // Return false if this is not possible. Then scanBitstream must be used.
+  bool readContainerIndex();
   int nrFrames {0};
 
   // Private struct for navigation. We index frames by frame number and FFMpeg uses the pts.
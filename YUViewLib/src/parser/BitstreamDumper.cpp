@@ -0,0 +1,119 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BitstreamDumper.h"
+
+#include <algorithm>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "ParserFactory.h"
+
+QList<BitstreamDumper::Result> BitstreamDumper::dumpFiles(const QStringList &fileNames, unsigned nrThreads)
+{
+  QFile stdOut;
+  QMutex stdOutMutex;
+  const bool useStdOut = this->outputDirectory.isEmpty();
+  if (useStdOut)
+  {
+    stdOut.open(stdout, QIODevice::WriteOnly);
+    if (this->format == PacketDumpWriter::Format::CSV)
+      PacketDumpWriter(&stdOut, this->format, {}).writeHeader();
+  }
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(int(std::max(nrThreads, 1u)));
+
+  QIODevice *sharedOutput = useStdOut ? &stdOut : nullptr;
+  QList<QFuture<Result>> futures;
+  for (const auto &fileName : fileNames)
+    futures.append(QtConcurrent::run(&pool, this, &BitstreamDumper::dumpFile, fileName, sharedOutput, &stdOutMutex));
+
+  QList<Result> results;
+  for (auto &future : futures)
+    results.append(future.result());
+
+  if (useStdOut)
+    stdOut.flush();
+  return results;
+}
+
+BitstreamDumper::Result BitstreamDumper::dumpFile(const QString &fileName, QIODevice *sharedOutput, QMutex *sharedOutputMutex)
+{
+  Result result;
+  result.fileName = fileName;
+  result.fileSize = QFileInfo(fileName).size();
+
+  QFile outputFile;
+  QIODevice *output = sharedOutput;
+  QMutex *outputMutex = sharedOutputMutex;
+  if (sharedOutput == nullptr)
+  {
+    const auto ext = (this->format == PacketDumpWriter::Format::CSV) ? ".csv" : ".jsonl";
+    outputFile.setFileName(QDir(this->outputDirectory).filePath(QFileInfo(fileName).fileName() + ext));
+    if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+      result.error = "Unable to open output file " + outputFile.fileName();
+      return result;
+    }
+    output = &outputFile;
+    outputMutex = nullptr;
+  }
+
+  PacketDumpWriter writer(output, this->format, fileName, outputMutex);
+  if (sharedOutput == nullptr)
+    writer.writeHeader();
+
+  QScopedPointer<parserBase> parser(createParserForFile(fileName));
+  parser->enableModel();
+  parser->setPacketSink(&writer);
+  QObject::connect(parser.data(), &parserBase::backgroundParsingDone, [&result](QString error) { result.error = error; });
+
+  QElapsedTimer timer;
+  timer.start();
+  const bool parsingOk = parser->runParsingOfFile(fileName);
+  result.seconds = double(timer.nsecsElapsed()) / 1e9;
+  result.nrPackets = writer.getNrPacketsWritten();
+  result.success = parsingOk && result.error.isEmpty();
+
+  if (sharedOutput == nullptr)
+    outputFile.close();
+  return result;
+}
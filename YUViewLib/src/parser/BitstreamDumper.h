@@ -0,0 +1,72 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "common/PacketDumpWriter.h"
+
+/* Parse bitstream files without any GUI and stream the parsed syntax of every packet (NAL unit,
+ * OBU or AVPacket) to a JSON Lines or CSV output. The packets are passed on to the output right
+ * after they were parsed, so the full syntax tree of a file is never held in memory.
+ * Multiple files can be processed in parallel.
+ */
+class BitstreamDumper
+{
+public:
+  struct Result
+  {
+    QString fileName;
+    bool success {false};
+    QString error;
+    int64_t fileSize {0};
+    int64_t nrPackets {0};
+    double seconds {0.0};
+    double getMBPerSecond() const { return (seconds > 0.0) ? double(fileSize) / 1000000.0 / seconds : 0.0; }
+  };
+
+  // If outputDirectory is empty, everything is written to stdout and each packet is tagged with its file name.
+  // Otherwise, one output file per input file is created in the directory (<fileName>.jsonl / <fileName>.csv).
+  BitstreamDumper(PacketDumpWriter::Format format, const QString &outputDirectory = {}) : format(format), outputDirectory(outputDirectory) {}
+
+  // Dump all files using up to nrThreads files in parallel. The results are in the order of the given files.
+  QList<Result> dumpFiles(const QStringList &fileNames, unsigned nrThreads);
+
+private:
+  Result dumpFile(const QString &fileName, QIODevice *sharedOutput, QMutex *sharedOutputMutex);
+
+  PacketDumpWriter::Format format;
+  QString outputDirectory;
+};
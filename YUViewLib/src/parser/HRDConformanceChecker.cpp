@@ -0,0 +1,83 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "HRDConformanceChecker.h"
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFuture>
+#include <QScopedPointer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "ParserFactory.h"
+
+QList<HRDConformanceChecker::Result> HRDConformanceChecker::checkFiles(const QStringList &fileNames, unsigned nrThreads)
+{
+  QThreadPool pool;
+  pool.setMaxThreadCount(int(std::max(nrThreads, 1u)));
+
+  QList<QFuture<Result>> futures;
+  for (const auto &fileName : fileNames)
+    futures.append(QtConcurrent::run(&pool, this, &HRDConformanceChecker::checkFile, fileName));
+
+  QList<Result> results;
+  for (auto &future : futures)
+    results.append(future.result());
+  return results;
+}
+
+HRDConformanceChecker::Result HRDConformanceChecker::checkFile(const QString &fileName)
+{
+  Result result;
+  result.fileName = fileName;
+  result.fileSize = QFileInfo(fileName).size();
+
+  // The model is not enabled so no TreeItems are created while parsing. The frame limit is
+  // not enabled either so the whole file is simulated.
+  QScopedPointer<parserBase> parser(createParserForFile(fileName));
+  QObject::connect(parser.data(), &parserBase::backgroundParsingDone, [&result](QString error) { result.error = error; });
+
+  QElapsedTimer timer;
+  timer.start();
+  const bool parsingOk = parser->runParsingOfFile(fileName);
+  result.seconds = double(timer.nsecsElapsed()) / 1e9;
+  result.success = parsingOk && result.error.isEmpty();
+
+  const auto hrdModel = parser->getHRDPlotModel();
+  result.nrHRDEntries = hrdModel->getNrEntries();
+  result.nrEvents = hrdModel->getNrEvents();
+  result.events = hrdModel->getEvents();
+  return result;
+}
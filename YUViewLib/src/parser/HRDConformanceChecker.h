@@ -0,0 +1,75 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "common/HRDPlotModel.h"
+
+/* Check the HRD conformance of bitstream files without any GUI. Each file is parsed in a single pass
+ * without creating the packet tree, so this runs close to the speed of reading the file. The HRD
+ * simulation of the parser streams into an HRDPlotModel which only keeps a decimated envelope and the
+ * list of underflow/overflow events. Multiple files can be checked in parallel.
+ */
+class HRDConformanceChecker
+{
+public:
+  struct Result
+  {
+    QString fileName;
+    bool success {false};
+    QString error;
+    int64_t fileSize {0};
+    double seconds {0.0};
+
+    // The number of buffer entries of the simulation. This is 0 if the stream has no HRD parameters
+    // or if the HRD simulation is not supported for the format.
+    uint64_t nrHRDEntries {0};
+    uint64_t nrEvents {0};
+    QList<HRDPlotModel::HRDEvent> events;
+
+    bool hasHRD() const { return nrHRDEntries > 0; }
+    bool isConformant() const { return success && nrEvents == 0; }
+    double getMBPerSecond() const { return (seconds > 0.0) ? double(fileSize) / 1000000.0 / seconds : 0.0; }
+  };
+
+  HRDConformanceChecker() = default;
+
+  // Check all files using up to nrThreads files in parallel. The results are in the order of the given files.
+  QList<Result> checkFiles(const QStringList &fileNames, unsigned nrThreads);
+
+private:
+  Result checkFile(const QString &fileName);
+};
@@ -72,7 +72,8 @@ PlotModel::StreamParameter HRDPlotModel::getStreamParameter(unsigned streamIndex
     streamParameter.limits.append(zeroLimit);
   }
 
-  const auto nrPoints = this->data.empty() ? 0 : unsigned(this->data.size() + 1);
+  // Each bucket of the envelope results in two points (min and max)
+  const auto nrPoints = this->envelope.empty() ? 0 : unsigned(this->envelope.size() * 2 + 1);
   streamParameter.plotParameters.append({PlotType::Line, nrPoints});
 
   return streamParameter;
@@ -90,12 +91,15 @@ PlotModel::Point HRDPlotModel::getPlotPoint(unsigned streamIndex, unsigned plotI
 
   QMutexLocker locker(&this->dataMutex);
 
-  if (pointIndex > unsigned(this->data.size()))
+  const auto bucketIndex = (pointIndex - 1) / 2;
+  if (bucketIndex >= unsigned(this->envelope.size()))
     return {};
 
+  const auto &bucket = this->envelope[bucketIndex];
+  const auto &entry = ((pointIndex - 1) % 2 == 0) ? bucket.first : bucket.second;
   PlotModel::Point point;
-  point.x = this->data[pointIndex - 1].time_offset_end;
-  point.y = this->data[pointIndex - 1].cbp_fullness_end;
+  point.x = entry.time_offset_end;
+  point.y = entry.cbp_fullness_end;
   
   return point;
 }
@@ -104,13 +108,17 @@ QString HRDPlotModel::getPointInfo(unsigned streamIndex, unsigned plotIndex, uns
 {
   Q_UNUSED(plotIndex);
 
-  if (streamIndex > 0)
+  if (streamIndex > 0 || pointIndex == 0)
     return {};
 
-  if (pointIndex > unsigned(this->data.size()))
+  QMutexLocker locker(&this->dataMutex);
+
+  const auto bucketIndex = (pointIndex - 1) / 2;
+  if (bucketIndex >= unsigned(this->envelope.size()))
     return {};
 
-  const auto &entry = this->data[pointIndex - 1];
+  const auto &bucket = this->envelope[bucketIndex];
+  const auto entry = ((pointIndex - 1) % 2 == 0) ? bucket.first : bucket.second;
   const auto timeScale = 1000;  // This results in the time being in ms
 
   const auto cpbDiff = entry.cbp_fullness_end - entry.cbp_fullness_start;
@@ -169,7 +177,19 @@ void HRDPlotModel::addHRDEntry(HRDPlotModel::HRDEntry &entry)
 {
   QMutexLocker locker(&this->dataMutex);
 
-  this->data.append(entry);
+  if (this->nrEntriesInLastBucket == 0 || this->nrEntriesInLastBucket >= this->nrEntriesPerBucket)
+  {
+    if (this->envelope.size() >= maxNrBuckets)
+      this->decimateEnvelope();
+    this->envelope.append({entry, entry});
+    this->nrEntriesInLastBucket = 1;
+  }
+  else
+  {
+    this->envelope.last() = mergeBuckets(this->envelope.last(), {entry, entry});
+    this->nrEntriesInLastBucket++;
+  }
+  this->nrEntries++;
 
   if (entry.time_offset_end > this->time_offset_max)
     this->time_offset_max = entry.time_offset_end;
@@ -185,7 +205,7 @@ void HRDPlotModel::addHRDEntry(HRDPlotModel::HRDEntry &entry)
   DEBUG_PLOT("HRDPlotModel::addHRDEntry time_offset_end " << entry.time_offset_end << " cbp_fullness_end " << entry.cbp_fullness_end);
 
   this->eventSubsampler.postEvent();
-  if (this->data.size() == 1)
+  if (this->nrEntries == 1)
     // Technically the number of streams did not change but with this we can inform the view to start drawing.
     emit nrStreamsChanged();
 }
@@ -199,3 +219,77 @@ void HRDPlotModel::setCPBBufferSize(int size)
     this->eventSubsampler.postEvent();
   }
 }
+
+QString HRDPlotModel::eventTypeToString(HRDEvent::Type type)
+{
+  if (type == HRDEvent::Type::Underflow)
+    return "Underflow";
+  if (type == HRDEvent::Type::Overflow)
+    return "Overflow";
+  return "Conformance";
+}
+
+void HRDPlotModel::addHRDEvent(const HRDEvent &event)
+{
+  QMutexLocker locker(&this->dataMutex);
+
+  DEBUG_PLOT("HRDPlotModel::addHRDEvent " << eventTypeToString(event.type) << " AU " << event.accessUnit << " " << event.message);
+  if (this->events.size() < maxNrStoredEvents)
+    this->events.append(event);
+  this->nrEvents++;
+}
+
+QList<HRDPlotModel::HRDEvent> HRDPlotModel::getEvents() const
+{
+  QMutexLocker locker(&this->dataMutex);
+  return this->events;
+}
+
+uint64_t HRDPlotModel::getNrEvents() const
+{
+  QMutexLocker locker(&this->dataMutex);
+  return this->nrEvents;
+}
+
+uint64_t HRDPlotModel::getNrEntries() const
+{
+  QMutexLocker locker(&this->dataMutex);
+  return this->nrEntries;
+}
+
+HRDPlotModel::Bucket HRDPlotModel::mergeBuckets(const Bucket &a, const Bucket &b)
+{
+  const HRDEntry *candidates[] = {&a.first, &a.second, &b.first, &b.second};
+  auto minEntry = candidates[0];
+  auto maxEntry = candidates[0];
+  for (const auto entry : candidates)
+  {
+    if (entry->cbp_fullness_end < minEntry->cbp_fullness_end)
+      minEntry = entry;
+    if (entry->cbp_fullness_end > maxEntry->cbp_fullness_end)
+      maxEntry = entry;
+  }
+
+  if (minEntry->time_offset_end <= maxEntry->time_offset_end)
+    return {*minEntry, *maxEntry};
+  return {*maxEntry, *minEntry};
+}
+
+void HRDPlotModel::decimateEnvelope()
+{
+  // Merge each two neighboring buckets into one. The last bucket may be incomplete if the number of buckets is odd.
+  const auto nrBuckets = this->envelope.size();
+  for (int i = 0; i < nrBuckets / 2; i++)
+    this->envelope[i] = mergeBuckets(this->envelope[i * 2], this->envelope[i * 2 + 1]);
+  if (nrBuckets % 2 == 1)
+  {
+    this->envelope[nrBuckets / 2] = this->envelope[nrBuckets - 1];
+    this->nrEntriesInLastBucket = this->nrEntriesPerBucket;
+  }
+  else
+    this->nrEntriesInLastBucket += this->nrEntriesPerBucket;
+  this->envelope.resize((nrBuckets + 1) / 2);
+  this->nrEntriesPerBucket *= 2;
+
+  DEBUG_PLOT("HRDPlotModel::decimateEnvelope now " << this->nrEntriesPerBucket << " entries per bucket");
+}
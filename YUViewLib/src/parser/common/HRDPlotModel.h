@@ -35,10 +35,17 @@
 #include <QList>
 #include <QMutex>
 #include <QString>
+#include <QVector>
 
 #include "common/typedef.h"
 #include "ui/views/plotModel.h"
 
+/* The HRD simulation of the parser streams its buffer entries into this model. Only a decimated
+ * envelope of the buffer level is kept so that the memory stays bounded for arbitrarily long streams:
+ * The entries are grouped into buckets and only the entries with the lowest and highest buffer level of each
+ * bucket are stored. If all buckets are used, neighboring buckets are merged. Buffer underflows, overflows and
+ * other conformance violations are collected in a separate event list.
+ */
 class HRDPlotModel : public PlotModel
 {
 public:
@@ -78,9 +85,55 @@ public:
   void addHRDEntry(HRDEntry &entry);
   void setCPBBufferSize(int size);
 
+  struct HRDEvent
+  {
+    enum class Type
+    {
+      // The buffer did not contain enough bits at the removal time of an access unit
+      Underflow,
+      // More bits were added than the buffer can hold
+      Overflow,
+      // Any other violation of the bitstream conformance requirements (e.g. the initial removal delay)
+      ConformanceViolation
+    };
+    Type type {Type::ConformanceViolation};
+
+    double time {0};
+    int poc {0};
+    uint64_t accessUnit {0};
+    // The number of bits that the buffer underflowed/overflowed by
+    int64_t bits {0};
+    QString message;
+  };
+  static QString eventTypeToString(HRDEvent::Type type);
+
+  void addHRDEvent(const HRDEvent &event);
+  // Only the first maxNrStoredEvents events are kept. getNrEvents() returns the total count.
+  QList<HRDEvent> getEvents() const;
+  uint64_t getNrEvents() const;
+  uint64_t getNrEntries() const;
+
 private:
+  struct Bucket
+  {
+    // The entries with the minimum and maximum buffer level in the order of their time
+    HRDEntry first;
+    HRDEntry second;
+  };
+  static Bucket mergeBuckets(const Bucket &a, const Bucket &b);
+  void decimateEnvelope();
+
+  static const int maxNrBuckets = 8192;
+  static const int maxNrStoredEvents = 10000;
+
+  QVector<Bucket> envelope;
+  unsigned nrEntriesPerBucket {1};
+  unsigned nrEntriesInLastBucket {0};
+  uint64_t nrEntries {0};
+
+  QList<HRDEvent> events;
+  uint64_t nrEvents {0};
 
-  QList<HRDEntry> data;
   mutable QMutex dataMutex;
 
   int cpb_buffer_size {0};
@@ -0,0 +1,208 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PacketDumpWriter.h"
+
+#include <QIODevice>
+#include <QMutexLocker>
+
+namespace
+{
+
+const QStringList itemDataNames = QStringList() << "name" << "value" << "coding" << "code" << "meaning";
+
+void appendJSONString(QByteArray &out, const QString &str)
+{
+  out.append('"');
+  for (const auto c : str.toUtf8())
+  {
+    if (c == '"')
+      out.append("\\\"");
+    else if (c == '\\')
+      out.append("\\\\");
+    else if (c == '\n')
+      out.append("\\n");
+    else if (c == '\r')
+      out.append("\\r");
+    else if (c == '\t')
+      out.append("\\t");
+    else if (c >= 0 && c < 0x20)
+      out.append(QString("\\u%1").arg(int(c), 4, 16, QChar('0')).toLatin1());
+    else
+      out.append(c);
+  }
+  out.append('"');
+}
+
+void appendCSVField(QByteArray &out, const QString &str)
+{
+  if (str.contains(',') || str.contains('"') || str.contains('\n') || str.contains('\r'))
+  {
+    QString quoted = str;
+    quoted.replace("\"", "\"\"");
+    out.append('"');
+    out.append(quoted.toUtf8());
+    out.append('"');
+  }
+  else
+    out.append(str.toUtf8());
+}
+
+} // namespace
+
+PacketDumpWriter::PacketDumpWriter(QIODevice *device, Format format, const QString &fileName, QMutex *deviceMutex) :
+  device(device), deviceMutex(deviceMutex), format(format)
+{
+  if (format == Format::JSONLines)
+    appendJSONString(this->fileNameEscaped, fileName);
+  else
+    appendCSVField(this->fileNameEscaped, fileName);
+}
+
+PacketDumpWriter::Format PacketDumpWriter::formatFromName(const QString &name, bool *ok)
+{
+  const auto n = name.toLower();
+  if (ok)
+    *ok = (n == "jsonl" || n == "json" || n == "csv");
+  if (n == "csv")
+    return Format::CSV;
+  return Format::JSONLines;
+}
+
+void PacketDumpWriter::writeHeader()
+{
+  if (this->format == Format::CSV)
+    this->writeToDevice("file,packet,stream,depth,name,value,coding,code,meaning,error\n");
+}
+
+void PacketDumpWriter::writePacket(const TreeItem *packetRoot)
+{
+  if (packetRoot == nullptr)
+    return;
+
+  QByteArray out;
+  out.reserve(4096);
+  const auto packetIdx = this->packetCounter++;
+  if (this->format == Format::JSONLines)
+  {
+    out.append("{\"file\":");
+    out.append(this->fileNameEscaped);
+    out.append(",\"packet\":");
+    out.append(QByteArray::number(qlonglong(packetIdx)));
+    out.append(",\"stream\":");
+    out.append(QByteArray::number(packetRoot->getStreamIndex()));
+    out.append(",\"name\":");
+    appendJSONString(out, packetRoot->getName(false));
+    if (packetRoot->isError())
+      out.append(",\"error\":true");
+    out.append(",\"syntax\":[");
+    for (int i = 0; i < packetRoot->getNrChildren(); i++)
+    {
+      if (i > 0)
+        out.append(',');
+      this->appendJSONItem(out, packetRoot->getChild(i));
+    }
+    out.append("]}\n");
+  }
+  else
+  {
+    QByteArray prefix = this->fileNameEscaped;
+    prefix.append(',');
+    prefix.append(QByteArray::number(qlonglong(packetIdx)));
+    prefix.append(',');
+    prefix.append(QByteArray::number(packetRoot->getStreamIndex()));
+    prefix.append(',');
+    this->appendCSVItem(out, packetRoot, prefix, 0);
+  }
+  this->writeToDevice(out);
+}
+
+void PacketDumpWriter::appendJSONItem(QByteArray &out, const TreeItem *item) const
+{
+  out.append('{');
+  bool first = true;
+  for (int i = 0; i < itemDataNames.size(); i++)
+  {
+    // Empty values are not written to keep the output compact. Only the name is always present.
+    const auto text = item->getData(i);
+    if (i > 0 && text.isEmpty())
+      continue;
+    if (!first)
+      out.append(',');
+    first = false;
+    appendJSONString(out, itemDataNames[i]);
+    out.append(':');
+    appendJSONString(out, text);
+  }
+  if (item->isError())
+    out.append(first ? "\"error\":true" : ",\"error\":true");
+  if (item->getNrChildren() > 0)
+  {
+    out.append(first ? "\"children\":[" : ",\"children\":[");
+    for (int i = 0; i < item->getNrChildren(); i++)
+    {
+      if (i > 0)
+        out.append(',');
+      this->appendJSONItem(out, item->getChild(i));
+    }
+    out.append(']');
+  }
+  out.append('}');
+}
+
+void PacketDumpWriter::appendCSVItem(QByteArray &out, const TreeItem *item, const QByteArray &packetPrefix, int depth) const
+{
+  out.append(packetPrefix);
+  out.append(QByteArray::number(depth));
+  for (int i = 0; i < itemDataNames.size(); i++)
+  {
+    out.append(',');
+    appendCSVField(out, (i == 0 && depth == 0) ? item->getName(false) : item->getData(i));
+  }
+  out.append(item->isError() ? ",1\n" : ",0\n");
+
+  for (int i = 0; i < item->getNrChildren(); i++)
+    this->appendCSVItem(out, item->getChild(i), packetPrefix, depth + 1);
+}
+
+void PacketDumpWriter::writeToDevice(const QByteArray &data)
+{
+  if (this->device == nullptr)
+    return;
+  if (this->deviceMutex)
+  {
+    QMutexLocker locker(this->deviceMutex);
+    this->device->write(data);
+  }
+  else
+    this->device->write(data);
+}
@@ -0,0 +1,85 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include "TreeItem.h"
+
+class QIODevice;
+class QMutex;
+
+// A sink that parsed packets can be forwarded to instead of being collected in the PacketItemModel.
+// The parser hands over the root TreeItem of each packet (AVPacket, NAL or OBU) right after it was
+// parsed. The item (and all of its children) is deleted by the parser after the call returns.
+class ParsedPacketSink
+{
+public:
+  virtual ~ParsedPacketSink() = default;
+  virtual void writePacket(const TreeItem *packetRoot) = 0;
+};
+
+// Serialize parsed packets to a structured text format. This is used by the command line
+// bitstream dump where no tree view is attached and the syntax only has to be streamed out.
+class PacketDumpWriter : public ParsedPacketSink
+{
+public:
+  enum class Format
+  {
+    JSONLines,  // One JSON object per packet with the nested syntax elements
+    CSV         // One line per syntax element
+  };
+
+  // If a mutex is given, it is locked for every write to the device. Each packet is first
+  // serialized into a local buffer so that packets of multiple writers never interleave.
+  PacketDumpWriter(QIODevice *device, Format format, const QString &fileName, QMutex *deviceMutex = nullptr);
+
+  void writeHeader();
+  void writePacket(const TreeItem *packetRoot) override;
+
+  int64_t getNrPacketsWritten() const { return this->packetCounter; }
+
+  static Format formatFromName(const QString &name, bool *ok = nullptr);
+
+private:
+  void appendJSONItem(QByteArray &out, const TreeItem *item) const;
+  void appendCSVItem(QByteArray &out, const TreeItem *item, const QByteArray &packetPrefix, int depth) const;
+  void writeToDevice(const QByteArray &data);
+
+  QIODevice *device {nullptr};
+  QMutex *deviceMutex {nullptr};
+  Format format {Format::JSONLines};
+  QByteArray fileNameEscaped;
+  int64_t packetCounter {0};
+};
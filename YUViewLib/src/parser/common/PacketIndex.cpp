@@ -0,0 +1,259 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PacketIndex.h"
+
+#include <algorithm>
+
+#include <QMutexLocker>
+#include <QRegularExpression>
+
+#include "PacketItemModel.h"
+
+namespace
+{
+
+struct ColumnName
+{
+  const char *name;
+  PacketIndex::Column column;
+};
+
+// The first name per column is the one shown in the help text. The others are aliases.
+const ColumnName columnNames[] = {
+  {"stream", PacketIndex::Column::StreamIndex},
+  {"stream_index", PacketIndex::Column::StreamIndex},
+  {"nal_type", PacketIndex::Column::NalType},
+  {"type", PacketIndex::Column::NalType},
+  {"obu_type", PacketIndex::Column::NalType},
+  {"poc", PacketIndex::Column::POC},
+  {"tid", PacketIndex::Column::TemporalID},
+  {"temporal_id", PacketIndex::Column::TemporalID},
+  {"layer", PacketIndex::Column::LayerID},
+  {"layer_id", PacketIndex::Column::LayerID},
+  {"spatial_id", PacketIndex::Column::LayerID},
+  {"size", PacketIndex::Column::Size},
+  {"slice_type", PacketIndex::Column::SliceType},
+  {"pps_id", PacketIndex::Column::ParameterSetID},
+  {"ps_id", PacketIndex::Column::ParameterSetID},
+  {"sei", PacketIndex::Column::SEIPayloadType},
+  {"sei_type", PacketIndex::Column::SEIPayloadType},
+  {"payload_type", PacketIndex::Column::SEIPayloadType}
+};
+
+std::optional<PacketIndex::Column> columnFromName(const QString &name)
+{
+  const auto n = name.toLower();
+  for (const auto &c : columnNames)
+    if (n == c.name)
+      return c.column;
+  return {};
+}
+
+std::optional<PacketIndex::Operator> operatorFromString(const QString &op)
+{
+  if (op == "=" || op == "==")
+    return PacketIndex::Operator::Equal;
+  if (op == "!=")
+    return PacketIndex::Operator::NotEqual;
+  if (op == "<")
+    return PacketIndex::Operator::Less;
+  if (op == "<=")
+    return PacketIndex::Operator::LessEqual;
+  if (op == ">")
+    return PacketIndex::Operator::Greater;
+  if (op == ">=")
+    return PacketIndex::Operator::GreaterEqual;
+  return {};
+}
+
+template <typename Compare>
+void filterCandidates(const QVector<int> &column, QVector<int> &candidates, bool firstCondition, Compare compare)
+{
+  if (firstCondition)
+  {
+    const auto n = column.size();
+    const auto values = column.constData();
+    for (int i = 0; i < n; i++)
+      if (compare(values[i]))
+        candidates.append(i);
+  }
+  else
+  {
+    int nrKept = 0;
+    for (const auto idx : candidates)
+      if (compare(column[idx]))
+        candidates[nrKept++] = idx;
+    candidates.resize(nrKept);
+  }
+}
+
+} // namespace
+
+void PacketIndex::addEntry(Entry entry, const QList<int> &seiPayloadTypes)
+{
+  if (this->model == nullptr || this->model->isNull())
+    return;
+  const auto rootItem = this->model->getRootItem();
+  if (rootItem->getNrChildren() == 0)
+    return;
+
+  const auto modelRow = rootItem->getNrChildren() - 1;
+  if (entry[Column::StreamIndex] == -1)
+    entry[Column::StreamIndex] = rootItem->getLastChild()->getStreamIndex();
+
+  QMutexLocker locker(&this->accessMutex);
+  const auto nrEntries = std::max(seiPayloadTypes.size(), 1);
+  for (int i = 0; i < nrEntries; i++)
+  {
+    if (!seiPayloadTypes.isEmpty())
+      entry[Column::SEIPayloadType] = seiPayloadTypes[i];
+    for (int c = 0; c < nrColumns; c++)
+      this->columns[c].append(entry[Column(c)]);
+    this->modelRows.append(modelRow);
+  }
+}
+
+void PacketIndex::clear()
+{
+  QMutexLocker locker(&this->accessMutex);
+  for (auto &column : this->columns)
+    column.clear();
+  this->modelRows.clear();
+}
+
+int PacketIndex::getNrEntries() const
+{
+  QMutexLocker locker(&this->accessMutex);
+  return this->modelRows.size();
+}
+
+QVector<int> PacketIndex::findModelRows(const Query &query) const
+{
+  QMutexLocker locker(&this->accessMutex);
+
+  QVector<int> candidates;
+  if (query.isEmpty())
+  {
+    candidates.resize(this->modelRows.size());
+    for (int i = 0; i < candidates.size(); i++)
+      candidates[i] = i;
+  }
+
+  // Unknown values (-1) never match an ordering condition.
+  // Each condition scans one contiguous column. The first one over all entries and the following
+  // ones only over the remaining candidates.
+  bool firstCondition = true;
+  for (const auto &condition : query)
+  {
+    const auto &column = this->columns[int(condition.column)];
+    const auto v = condition.value;
+    switch (condition.op)
+    {
+    case Operator::Equal:
+      filterCandidates(column, candidates, firstCondition, [v](int x) { return x == v; });
+      break;
+    case Operator::NotEqual:
+      filterCandidates(column, candidates, firstCondition, [v](int x) { return x != v; });
+      break;
+    case Operator::Less:
+      filterCandidates(column, candidates, firstCondition, [v](int x) { return x != -1 && x < v; });
+      break;
+    case Operator::LessEqual:
+      filterCandidates(column, candidates, firstCondition, [v](int x) { return x != -1 && x <= v; });
+      break;
+    case Operator::Greater:
+      filterCandidates(column, candidates, firstCondition, [v](int x) { return x != -1 && x > v; });
+      break;
+    case Operator::GreaterEqual:
+      filterCandidates(column, candidates, firstCondition, [v](int x) { return x != -1 && x >= v; });
+      break;
+    default:
+      break;
+    }
+    firstCondition = false;
+    if (candidates.isEmpty())
+      break;
+  }
+
+  // The entries are appended in the order of the model rows so the rows are already sorted.
+  QVector<int> rows;
+  rows.reserve(candidates.size());
+  for (const auto idx : candidates)
+  {
+    const auto row = this->modelRows[idx];
+    if (rows.isEmpty() || rows.last() != row)
+      rows.append(row);
+  }
+  return rows;
+}
+
+std::optional<PacketIndex::Query> PacketIndex::parseQuery(const QString &text, QString &errorMessage)
+{
+  static const QRegularExpression conditionRegExp("([A-Za-z_]+)\\s*(==|!=|<=|>=|=|<|>)\\s*(-?\\d+)");
+  static const QRegularExpression separatorRegExp("^(\\s|,|&|and)*$", QRegularExpression::CaseInsensitiveOption);
+
+  Query query;
+  int lastEnd = 0;
+  auto it = conditionRegExp.globalMatch(text);
+  while (it.hasNext())
+  {
+    const auto match = it.next();
+    if (!separatorRegExp.match(text.mid(lastEnd, match.capturedStart() - lastEnd)).hasMatch())
+    {
+      errorMessage = QString("Unexpected text '%1'").arg(text.mid(lastEnd, match.capturedStart() - lastEnd).trimmed());
+      return {};
+    }
+    lastEnd = match.capturedEnd();
+
+    const auto column = columnFromName(match.captured(1));
+    if (!column)
+    {
+      errorMessage = QString("Unknown column '%1'").arg(match.captured(1));
+      return {};
+    }
+    query.append({*column, *operatorFromString(match.captured(2)), match.captured(3).toInt()});
+  }
+  if (!separatorRegExp.match(text.mid(lastEnd)).hasMatch())
+  {
+    errorMessage = QString("Unexpected text '%1'").arg(text.mid(lastEnd).trimmed());
+    return {};
+  }
+  return query;
+}
+
+QString PacketIndex::getQuerySyntaxHelp()
+{
+  return "Filter packets by conditions in the form <column><op><value> (e.g. \"nal_type=21 pps_id=3\" or \"sei=137\").\n"
+         "Columns: stream, nal_type, poc, tid, layer, size, slice_type, pps_id, sei\n"
+         "Operators: =, !=, <, <=, >, >=";
+}
@@ -0,0 +1,122 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <array>
+#include <optional>
+
+class PacketItemModel;
+
+/* A column oriented table with the most important integer properties of all parsed units (NAL units,
+ * OBUs or AVPackets). It is filled while parsing and can be queried without walking the TreeItems
+ * of the PacketItemModel. Each entry points to the first level row of the PacketItemModel that the
+ * unit belongs to. Multiple entries may point to the same row (e.g. all NAL units in an AVPacket or
+ * all messages in an SEI NAL unit).
+ * Adding entries (from the parsing thread) and querying (from the GUI) can be done concurrently.
+ */
+class PacketIndex
+{
+public:
+  enum class Column
+  {
+    StreamIndex,
+    NalType,        // NAL unit type, OBU type or start code value
+    POC,
+    TemporalID,
+    LayerID,        // nuh_layer_id or spatial_id
+    Size,           // Size of the unit in bytes
+    SliceType,
+    ParameterSetID, // The ID of a parameter set or the ID of the PPS referenced by a slice
+    SEIPayloadType,
+    NrColumns
+  };
+  static const int nrColumns = int(Column::NrColumns);
+
+  // A value of -1 means that the value is not known or does not apply to the unit.
+  class Entry
+  {
+  public:
+    Entry() { values.fill(-1); }
+    int &operator[](Column column) { return values[int(column)]; }
+    int operator[](Column column) const { return values[int(column)]; }
+  private:
+    std::array<int, nrColumns> values;
+  };
+
+  enum class Operator
+  {
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual
+  };
+  struct Condition
+  {
+    Column column;
+    Operator op;
+    int value;
+  };
+  // All conditions must be met (AND)
+  using Query = QList<Condition>;
+
+  PacketIndex(PacketItemModel *model) : model(model) {}
+
+  // Add an entry for the last first level item in the packet model. If the stream index is not set,
+  // it is taken from that item. For SEI NAL units, one entry per SEI payload type is added.
+  void addEntry(Entry entry, const QList<int> &seiPayloadTypes = {});
+  void clear();
+  int getNrEntries() const;
+
+  // Get the first level rows of the packet model that match all conditions of the query. The rows
+  // are sorted and unique.
+  QVector<int> findModelRows(const Query &query) const;
+
+  // Parse a query in the form "nal_type=21 pps_id=3" or "sei=137, poc>=10". If parsing fails, an
+  // empty optional is returned and the error message is set.
+  static std::optional<Query> parseQuery(const QString &text, QString &errorMessage);
+  static QString getQuerySyntaxHelp();
+
+private:
+  PacketItemModel *model {nullptr};
+
+  mutable QMutex accessMutex;
+  std::array<QVector<int>, nrColumns> columns;
+  QVector<int> modelRows;
+};
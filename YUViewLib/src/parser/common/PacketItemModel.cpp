@@ -70,10 +70,27 @@ PacketItemModel::~PacketItemModel()
 {
 }
 
+void PacketItemModel::createRootItem(const QStringList &headerNames)
+{
+  TreeItemArena::Scope arenaScope(&this->arena);
+  this->headerNames = headerNames;
+  this->rootItem = new TreeItem(headerNames, nullptr);
+}
+
+void PacketItemModel::clearItems()
+{
+  if (this->rootItem == nullptr)
+    return;
+
+  this->arena.clear();
+  this->nrShowChildItems = 0;
+  this->createRootItem(this->headerNames);
+}
+
 QVariant PacketItemModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
   if (orientation == Qt::Horizontal && role == Qt::DisplayRole && rootItem != nullptr)
-    return rootItem->itemData.value(section, QString());
+    return rootItem->getData(section);
 
   return QVariant();
 }
@@ -104,7 +121,7 @@ QVariant PacketItemModel::data(const QModelIndex &index, int role) const
     if (index.column() == 0)
       return QVariant(item->getName(!showVideoOnly));
     else
-      return QVariant(item->itemData.value(index.column()));
+      return QVariant(item->getData(index.column()));
   }
   return QVariant();
 }
@@ -116,13 +133,13 @@ QModelIndex PacketItemModel::index(int row, int column, const QModelIndex &paren
 
   TreeItem *parentItem;
   if (!parent.isValid())
-    parentItem = rootItem.data();
+    parentItem = rootItem;
   else
     parentItem = static_cast<TreeItem*>(parent.internalPointer());
 
   Q_ASSERT_X(parentItem != nullptr, Q_FUNC_INFO, "pointer to parent is null. This must never happen");
 
-  TreeItem *childItem = parentItem->childItems.value(row, nullptr);
+  TreeItem *childItem = parentItem->getChild(row);
   if (childItem)
     return createIndex(row, column, childItem);
   else
@@ -135,17 +152,12 @@ QModelIndex PacketItemModel::parent(const QModelIndex &index) const
     return QModelIndex();
 
   TreeItem *childItem = static_cast<TreeItem*>(index.internalPointer());
-  TreeItem *parentItem = childItem->parentItem;
+  TreeItem *parentItem = childItem->getParent();
 
-  if (parentItem == rootItem.data())
+  if (parentItem == rootItem || parentItem == nullptr)
     return QModelIndex();
 
-  // Get the row of the item in the list of children of the parent item
-  int row = 0;
-  if (parentItem)
-    row = parentItem->parentItem->childItems.indexOf(const_cast<TreeItem*>(parentItem));
-
-  return createIndex(row, 0, parentItem);
+  return createIndex(parentItem->getRow(), 0, parentItem);
 }
 
 int PacketItemModel::rowCount(const QModelIndex &parent) const
@@ -155,11 +167,11 @@ int PacketItemModel::rowCount(const QModelIndex &parent) const
 
   if (!parent.isValid())
   {
-    TreeItem *p = rootItem.data();
+    TreeItem *p = rootItem;
     return (p == nullptr) ? 0 : nrShowChildItems;
   }
   TreeItem *p = static_cast<TreeItem*>(parent.internalPointer());
-  return (p == nullptr) ? 0 : p->childItems.count();
+  return (p == nullptr) ? 0 : p->getNrChildren();
 }
 
 void PacketItemModel::updateNumberModelItems()
@@ -202,8 +214,33 @@ void FilterByStreamIndexProxyModel::setFilterStreamIndex(int idx)
   invalidateFilter();
 }
 
+void FilterByStreamIndexProxyModel::setFilterRows(const QVector<int> &rows)
+{
+  this->acceptedRows = QBitArray(rows.isEmpty() ? 0 : rows.last() + 1);
+  for (const auto row : rows)
+    this->acceptedRows.setBit(row);
+  this->rowFilterActive = true;
+  invalidateFilter();
+}
+
+void FilterByStreamIndexProxyModel::clearFilterRows()
+{
+  if (!this->rowFilterActive)
+    return;
+  this->acceptedRows.clear();
+  this->rowFilterActive = false;
+  invalidateFilter();
+}
+
 bool FilterByStreamIndexProxyModel::filterAcceptsRow(int row, const QModelIndex &sourceParent) const
 {
+  if (this->rowFilterActive && !sourceParent.isValid())
+  {
+    // The row filter only applies to the first level items
+    if (row >= this->acceptedRows.size() || !this->acceptedRows.testBit(row))
+      return false;
+  }
+
   if (streamIndex == -1)
   {
     DEBUG_FILTER("FilterByStreamIndexProxyModel::filterAcceptsRow %d - accepting all", row);
@@ -227,7 +264,7 @@ bool FilterByStreamIndexProxyModel::filterAcceptsRow(int row, const QModelIndex
     parentItem = static_cast<TreeItem*>(sourceParent.internalPointer());
   Q_ASSERT_X(parentItem != nullptr, Q_FUNC_INFO, "pointer to parent is null. This must never happen");
 
-  TreeItem *childItem = parentItem->childItems.value(row, nullptr);
+  TreeItem *childItem = parentItem->getChild(row);
   if (childItem != nullptr)
   {
     DEBUG_FILTER("FilterByStreamIndexProxyModel::filterAcceptsRow item %d", childItem->getStreamIndex());
@@ -33,9 +33,11 @@
 #pragma once
 
 #include <QAbstractItemModel>
+#include <QBitArray>
 #include <QSortFilterProxyModel>
 
 #include "TreeItem.h"
+#include "TreeItemArena.h"
 
 // The item model which is used to display packets from the bitstream. This can be AVPackets or other units from the bitstream (NAL units e.g.)
 class PacketItemModel : public QAbstractItemModel
@@ -54,22 +56,31 @@ public:
   virtual int rowCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
   virtual int columnCount(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE { Q_UNUSED(parent); return 5; }
 
-  // The root of the tree
-  QScopedPointer<TreeItem> rootItem;
-  TreeItem *getRootItem() { return rootItem.data(); }
-  bool isNull() { return rootItem.isNull(); }
+  // Create the root of the tree with the given column names. All items of the tree are allocated
+  // from the arena of this model so the parser must activate it (see TreeItemArena::Scope).
+  void createRootItem(const QStringList &headerNames);
+  // Remove all items below the root (in O(1) by releasing the arena). Only valid if the model is not shown.
+  void clearItems();
+  TreeItem *getRootItem() { return rootItem; }
+  bool isNull() { return rootItem == nullptr; }
+  TreeItemArena *getArena() { return &arena; }
 
   void setUseColorCoding(bool colorCoding);
   void setShowVideoStreamOnly(bool showVideoOnly);
 
   void updateNumberModelItems();
 private:
+  // The arena must be declared before the root so that it outlives the items
+  TreeItemArena arena;
+  TreeItem *rootItem {nullptr};
+  QStringList headerNames;
+
   // This is the current number of first level child items which we show right now.
   // The brackground parser will add more items and it will notify the bitstreamAnalysisWindow
   // about them. The bitstream analysis window will then update this count and the view to show the new items.
   unsigned int nrShowChildItems {0};
 
-  unsigned int getNumberFirstLevelChildren() { return rootItem.isNull() ? 0 : rootItem->childItems.size(); }
+  unsigned int getNumberFirstLevelChildren() { return (rootItem == nullptr) ? 0 : rootItem->getNrChildren(); }
 
   static QList<QColor> streamIndexColors;
   bool useColorCoding { true };
@@ -86,9 +97,18 @@ public:
   int filterStreamIndex() const { return streamIndex; }
   void setFilterStreamIndex(int idx);
 
+  // Additionally only show the given first level rows (e.g. the result of a PacketIndex query).
+  // The rows must be sorted. Call clearFilterRows to show all rows again.
+  void setFilterRows(const QVector<int> &rows);
+  void clearFilterRows();
+  bool isRowFilterActive() const { return rowFilterActive; }
+
 protected:
   bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
 
 private:
   int streamIndex { -1 };
+
+  bool rowFilterActive { false };
+  QBitArray acceptedRows;
 };
\ No newline at end of file
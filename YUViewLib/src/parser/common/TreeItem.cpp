@@ -0,0 +1,231 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TreeItem.h"
+
+#include <cstring>
+#include <new>
+
+TreeItem::TreeItem(TreeItem *parent)
+{
+  this->appendToParent(parent);
+}
+
+TreeItem::TreeItem(const QStringList &data, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(data.value(0), data.value(2), data.value(3), data.value(4));
+  if (data.size() > 1)
+    this->setValue(data[1]);
+}
+
+TreeItem::TreeItem(const QString &name, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, {}, {}, {});
+}
+
+TreeItem::TreeItem(const QString &name, int val, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, {}, {}, {});
+  this->valueType      = ValueType::Int;
+  this->value.intValue = val;
+}
+
+TreeItem::TreeItem(const QString &name, QString val, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, {}, {}, {});
+  this->setValue(val);
+}
+
+TreeItem::TreeItem(const QString &name, int val, const QString &coding, const QString &code, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, coding, code, {});
+  this->valueType      = ValueType::Int;
+  this->value.intValue = val;
+}
+
+TreeItem::TreeItem(const QString &name, unsigned int val, const QString &coding, const QString &code, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, coding, code, {});
+  this->valueType       = ValueType::UInt;
+  this->value.uintValue = val;
+}
+
+TreeItem::TreeItem(const QString &name, uint64_t val, const QString &coding, const QString &code, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, coding, code, {});
+  this->valueType       = ValueType::UInt;
+  this->value.uintValue = val;
+}
+
+TreeItem::TreeItem(const QString &name, int64_t val, const QString &coding, const QString &code, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, coding, code, {});
+  this->valueType      = ValueType::Int;
+  this->value.intValue = val;
+}
+
+TreeItem::TreeItem(const QString &name, bool val, const QString &coding, const QString &code, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, coding, code, {});
+  this->valueType       = ValueType::Bool;
+  this->value.uintValue = val ? 1 : 0;
+}
+
+TreeItem::TreeItem(const QString &name, double val, const QString &coding, const QString &code, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, coding, code, {});
+  this->valueType         = ValueType::Double;
+  this->value.doubleValue = val;
+}
+
+TreeItem::TreeItem(const QString &name, QString val, const QString &coding, const QString &code, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, coding, code, {});
+  this->setValue(val);
+}
+
+TreeItem::TreeItem(const QString &name, int val, const QString &coding, const QString &code, QString meaning, TreeItem *parent)
+{
+  this->appendToParent(parent);
+  this->setText(name, coding, code, meaning);
+  this->valueType      = ValueType::Int;
+  this->value.intValue = val;
+}
+
+TreeItem::TreeItem(const QString &name, QString val, const QString &coding, const QString &code, QString meaning, TreeItem *parent, bool isError)
+{
+  this->appendToParent(parent);
+  this->setText(name, coding, code, meaning);
+  this->setValue(val);
+  this->setError(isError);
+}
+
+void *TreeItem::operator new(size_t size)
+{
+  return TreeItemArena::current()->allocate(size, alignof(TreeItem));
+}
+
+QString TreeItem::getName(bool showStreamIndex) const
+{
+  QString r = (showStreamIndex && streamIndex != -1) ? QString("Stream %1 - ").arg(streamIndex) : "";
+  r += this->name.toString();
+  return r;
+}
+
+void TreeItem::setName(const QString &name)
+{
+  // Names of packets are unique (they contain the packet number) so there is no point in interning them
+  this->name = this->arena->storeText(name);
+}
+
+QString TreeItem::getData(int column) const
+{
+  switch (column)
+  {
+  case 0:
+    return this->name.toString();
+  case 1:
+    switch (this->valueType)
+    {
+    case ValueType::Int:
+      return QString::number(this->value.intValue);
+    case ValueType::UInt:
+      return QString::number(this->value.uintValue);
+    case ValueType::Bool:
+      return (this->value.uintValue != 0) ? "1" : "0";
+    case ValueType::Double:
+      return QString::number(this->value.doubleValue);
+    case ValueType::Text:
+      return this->value.textValue.toString();
+    default:
+      return {};
+    }
+  case 2:
+    return this->coding.toString();
+  case 3:
+    return this->code.toString();
+  case 4:
+    return this->meaning.toString();
+  default:
+    return {};
+  }
+}
+
+void TreeItem::appendToParent(TreeItem *parent)
+{
+  this->arena = TreeItemArena::current();
+  this->parentItem = parent;
+  if (parent)
+    parent->appendChild(this);
+}
+
+void TreeItem::appendChild(TreeItem *child)
+{
+  if (this->nrChildren == this->childCapacity)
+  {
+    const auto newCapacity = (this->childCapacity == 0) ? 4 : this->childCapacity * 2;
+    auto newChildItems = static_cast<TreeItem **>(this->arena->allocate(sizeof(TreeItem *) * newCapacity, alignof(TreeItem *)));
+    if (this->nrChildren > 0)
+      std::memcpy(newChildItems, this->childItems, sizeof(TreeItem *) * this->nrChildren);
+    this->childItems    = newChildItems;
+    this->childCapacity = newCapacity;
+  }
+  child->row = this->nrChildren;
+  this->childItems[this->nrChildren] = child;
+  this->nrChildren++;
+}
+
+void TreeItem::setText(const QString &name, const QString &coding, const QString &code, const QString &meaning)
+{
+  // The names, codings and meanings of the syntax elements repeat for every NAL/OBU so these are interned.
+  this->name    = this->arena->internText(name);
+  this->coding  = this->arena->internText(coding);
+  this->code    = this->arena->storeText(code);
+  this->meaning = this->arena->internText(meaning);
+}
+
+void TreeItem::setValue(const QString &val)
+{
+  this->valueType       = ValueType::Text;
+  this->value.textValue = this->arena->storeText(val);
+}
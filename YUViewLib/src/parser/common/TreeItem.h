@@ -32,44 +32,99 @@
 
 #pragma once
 
-#include <QList>
 #include <QString>
+#include <QStringList>
 
-// The tree item is used to feed the tree view. Each NAL unit can return a representation using TreeItems
+#include "TreeItemArena.h"
+
+/* The tree item is used to feed the tree view. Each NAL unit can return a representation using TreeItems.
+ * TreeItems are allocated from the TreeItemArena that is active in the current thread (see TreeItemArena::Scope).
+ * They are never deleted one by one. All items are released at once when their arena is cleared. Names, codings
+ * and meanings are interned in the arena and numeric values are only converted to text when they are displayed.
+ */
 class TreeItem
 {
 public:
   // Some useful constructors of new Tree items. You must at least specify a parent. The new item is atomatically added as a child 
   // of the parent.
-  TreeItem(TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); }
-  TreeItem(QList<QString> &data, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData = data; }
-  TreeItem(const QString &name, TreeItem *parent)  { parentItem = parent; if (parent) parent->childItems.append(this); itemData.append(name); }
-  TreeItem(const QString &name, int          val, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val); }
-  TreeItem(const QString &name, QString      val, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << val; }
-  TreeItem(const QString &name, int          val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, unsigned int val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, uint64_t     val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, int64_t      val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, bool         val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << (val ? "1" : "0")    << coding << code; }
-  TreeItem(const QString &name, double       val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; }
-  TreeItem(const QString &name, QString      val, const QString &coding, const QString &code, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << val << coding << code; }
-  TreeItem(const QString &name, int          val, const QString &coding, const QString &code, QString meaning, TreeItem *parent) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << QString::number(val) << coding << code; itemData.append(meaning); }
-  TreeItem(const QString &name, QString      val, const QString &coding, const QString &code, QString meaning, TreeItem *parent, bool isError=false) { parentItem = parent; if (parent) parent->childItems.append(this); itemData << name << val << coding << code; itemData.append(meaning); setError(isError); }
-
-  ~TreeItem() { qDeleteAll(childItems); }
+  TreeItem(TreeItem *parent);
+  TreeItem(const QStringList &data, TreeItem *parent);
+  TreeItem(const QString &name, TreeItem *parent);
+  TreeItem(const QString &name, int          val, TreeItem *parent);
+  TreeItem(const QString &name, QString      val, TreeItem *parent);
+  TreeItem(const QString &name, int          val, const QString &coding, const QString &code, TreeItem *parent);
+  TreeItem(const QString &name, unsigned int val, const QString &coding, const QString &code, TreeItem *parent);
+  TreeItem(const QString &name, uint64_t     val, const QString &coding, const QString &code, TreeItem *parent);
+  TreeItem(const QString &name, int64_t      val, const QString &coding, const QString &code, TreeItem *parent);
+  TreeItem(const QString &name, bool         val, const QString &coding, const QString &code, TreeItem *parent);
+  TreeItem(const QString &name, double       val, const QString &coding, const QString &code, TreeItem *parent);
+  TreeItem(const QString &name, QString      val, const QString &coding, const QString &code, TreeItem *parent);
+  TreeItem(const QString &name, int          val, const QString &coding, const QString &code, QString meaning, TreeItem *parent);
+  TreeItem(const QString &name, QString      val, const QString &coding, const QString &code, QString meaning, TreeItem *parent, bool isError=false);
+
+  // The memory is owned by the arena. Deleting an item does nothing.
+  static void *operator new(size_t size);
+  static void operator delete(void *) {}
+
   void setError(bool isError = true) { error = isError; }
-  bool isError()                     { return error; }
+  bool isError() const               { return error; }
 
-  QString getName(bool showStreamIndex) const { QString r = (showStreamIndex && streamIndex != -1) ? QString("Stream %1 - ").arg(streamIndex) : ""; if (itemData.count() > 0) r += itemData[0]; return r; }
+  QString getName(bool showStreamIndex) const;
+  void setName(const QString &name);
 
-  QList<TreeItem*> childItems;
-  QList<QString> itemData;
-  TreeItem *parentItem { nullptr };
+  // Get the text of the given column (name, value, coding, code, meaning)
+  QString getData(int column) const;
 
-  int getStreamIndex() { if (streamIndex >= 0) return streamIndex; if (parentItem) return parentItem->getStreamIndex(); return -1; }
+  TreeItem *getParent() const { return this->parentItem; }
+  int getNrChildren() const   { return this->nrChildren; }
+  TreeItem *getChild(int row) const { return (row >= 0 && row < this->nrChildren) ? this->childItems[row] : nullptr; }
+  TreeItem *getLastChild() const    { return this->getChild(this->nrChildren - 1); }
+  // The row of this item in the list of children of the parent
+  int getRow() const { return this->row; }
+
+  int getStreamIndex() const { if (streamIndex >= 0) return streamIndex; if (parentItem) return parentItem->getStreamIndex(); return -1; }
   void setStreamIndex(int idx) { streamIndex = idx; }
 
 private:
+  enum class ValueType : uint8_t
+  {
+    None,
+    Int,
+    UInt,
+    Bool,
+    Double,
+    Text
+  };
+
+  void appendToParent(TreeItem *parent);
+  void appendChild(TreeItem *child);
+  void setText(const QString &name, const QString &coding, const QString &code, const QString &meaning);
+  void setValue(const QString &val);
+
+  TreeItemArena *arena {nullptr};
+  TreeItem *parentItem {nullptr};
+
+  // The children are kept in an array in the arena. If it is full, a new array with twice the size
+  // is allocated. The old one is not reused but stays valid until the arena is cleared.
+  TreeItem **childItems {nullptr};
+  int nrChildren {0};
+  int childCapacity {0};
+  int row {0};
+
+  TreeItemText name {};
+  TreeItemText coding {};
+  TreeItemText code {};
+  TreeItemText meaning {};
+
+  ValueType valueType {ValueType::None};
+  union
+  {
+    int64_t intValue;
+    uint64_t uintValue;
+    double doubleValue;
+    TreeItemText textValue;
+  } value {};
+
   bool error { false };
   // This is set for the first layer items in case of AVPackets
   int streamIndex { -1 };
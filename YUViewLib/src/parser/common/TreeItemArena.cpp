@@ -0,0 +1,159 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TreeItemArena.h"
+
+#include <cstring>
+
+#include <QMutexLocker>
+
+namespace
+{
+
+thread_local TreeItemArena *currentThreadArena = nullptr;
+
+} // namespace
+
+void *TreeItemArena::allocate(size_t size, size_t alignment)
+{
+  if (!this->accessMutex)
+    return this->allocateUnlocked(size, alignment);
+  QMutexLocker locker(this->accessMutex.get());
+  return this->allocateUnlocked(size, alignment);
+}
+
+TreeItemText TreeItemArena::storeText(const QString &text)
+{
+  if (!this->accessMutex)
+    return this->storeTextUnlocked(text);
+  QMutexLocker locker(this->accessMutex.get());
+  return this->storeTextUnlocked(text);
+}
+
+TreeItemText TreeItemArena::internText(const QString &text)
+{
+  if (text.isEmpty())
+    return {};
+
+  std::unique_ptr<QMutexLocker> locker;
+  if (this->accessMutex)
+    locker.reset(new QMutexLocker(this->accessMutex.get()));
+
+  auto it = this->internedTexts.constFind(text);
+  if (it != this->internedTexts.constEnd())
+    return it.value();
+
+  const auto stored = this->storeTextUnlocked(text);
+  this->internedTexts.insert(text, stored);
+  return stored;
+}
+
+void TreeItemArena::clear()
+{
+  std::unique_ptr<QMutexLocker> locker;
+  if (this->accessMutex)
+    locker.reset(new QMutexLocker(this->accessMutex.get()));
+
+  // Keep the first block for reuse. Parsing a new file will most likely need it again.
+  if (this->blocks.size() > 1)
+    this->blocks.resize(1);
+  this->blockPos = this->blocks.empty() ? nullptr : this->blocks.front().get();
+  this->blockRemaining = this->blocks.empty() ? 0 : blockSize;
+  this->largeAllocations.clear();
+  this->nrBytesLargeAllocations = 0;
+  this->internedTexts.clear();
+}
+
+TreeItemArena *TreeItemArena::current()
+{
+  if (currentThreadArena)
+    return currentThreadArena;
+  return TreeItemArena::global();
+}
+
+TreeItemArena *TreeItemArena::global()
+{
+  static TreeItemArena *globalArena = []() {
+    auto arena = new TreeItemArena();
+    arena->accessMutex.reset(new QMutex());
+    return arena;
+  }();
+  return globalArena;
+}
+
+TreeItemArena::Scope::Scope(TreeItemArena *arena)
+{
+  this->previousArena = currentThreadArena;
+  currentThreadArena = arena;
+}
+
+TreeItemArena::Scope::~Scope()
+{
+  currentThreadArena = this->previousArena;
+}
+
+void *TreeItemArena::allocateUnlocked(size_t size, size_t alignment)
+{
+  if (size > blockSize / 4)
+  {
+    // Big allocations get their own memory. This way they don't waste the rest of the current block.
+    this->largeAllocations.emplace_back(new char[size]);
+    this->nrBytesLargeAllocations += size;
+    return this->largeAllocations.back().get();
+  }
+
+  auto misalignment = reinterpret_cast<uintptr_t>(this->blockPos) % alignment;
+  auto padding      = (misalignment == 0) ? 0 : alignment - misalignment;
+  if (this->blockPos == nullptr || padding + size > this->blockRemaining)
+  {
+    this->blocks.emplace_back(new char[blockSize]);
+    this->blockPos       = this->blocks.back().get();
+    this->blockRemaining = blockSize;
+    padding              = 0;
+  }
+
+  auto ptr = this->blockPos + padding;
+  this->blockPos += padding + size;
+  this->blockRemaining -= padding + size;
+  return ptr;
+}
+
+TreeItemText TreeItemArena::storeTextUnlocked(const QString &text)
+{
+  if (text.isEmpty())
+    return {};
+
+  const auto nrBytes = size_t(text.size()) * sizeof(QChar);
+  auto data = static_cast<QChar *>(this->allocateUnlocked(nrBytes, alignof(QChar)));
+  std::memcpy(data, text.constData(), nrBytes);
+  return {data, int(text.size())};
+}
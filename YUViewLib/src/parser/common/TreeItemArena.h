@@ -0,0 +1,113 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// A reference to text that is stored in a TreeItemArena. The data stays valid until the arena is cleared.
+// This is a trivial type so that it can be used in unions. Use TreeItemText{} for an empty text.
+struct TreeItemText
+{
+  const QChar *data;
+  int size;
+
+  bool isEmpty() const { return size == 0; }
+  QString toString() const { return (size == 0) ? QString() : QString(data, size); }
+};
+
+/* A simple bump allocator for TreeItems and their strings.
+ * All items of a packet tree are allocated from the arena of the PacketItemModel in big blocks. Items
+ * are never freed one by one. Instead, the whole arena is cleared (or destroyed) at once which is O(1)
+ * in the number of items. Strings that repeat very often (like syntax element names, codings or meanings)
+ * are interned so that every distinct string is only stored once per arena.
+ * The arena is not thread safe. Only one thread (the parsing thread) may allocate from it at a time.
+ * Other threads may read the already allocated items and strings since the memory never moves.
+ */
+class TreeItemArena
+{
+public:
+  TreeItemArena() = default;
+  TreeItemArena(const TreeItemArena &) = delete;
+  TreeItemArena &operator=(const TreeItemArena &) = delete;
+
+  void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  // Copy the text into the arena
+  TreeItemText storeText(const QString &text);
+  // Return the interned copy of the text. Identical texts share the same storage.
+  TreeItemText internText(const QString &text);
+
+  // Release all memory. All TreeItems and texts from this arena become invalid.
+  void clear();
+
+  size_t getNrBytesAllocated() const { return this->blocks.size() * blockSize + this->nrBytesLargeAllocations; }
+
+  // Items are allocated from the arena that is currently active in the calling thread.
+  // If no arena is active, a global fallback arena (which is never cleared) is used.
+  static TreeItemArena *current();
+  static TreeItemArena *global();
+
+  // Activate the given arena in the current thread while the scope object exists.
+  class Scope
+  {
+  public:
+    Scope(TreeItemArena *arena);
+    ~Scope();
+  private:
+    TreeItemArena *previousArena {nullptr};
+  };
+
+private:
+  static const size_t blockSize = 256 * 1024;
+
+  void *allocateUnlocked(size_t size, size_t alignment);
+  TreeItemText storeTextUnlocked(const QString &text);
+
+  std::vector<std::unique_ptr<char[]>> blocks;
+  std::vector<std::unique_ptr<char[]>> largeAllocations;
+  char *blockPos {nullptr};
+  size_t blockRemaining {0};
+  size_t nrBytesLargeAllocations {0};
+
+  QHash<QString, TreeItemText> internedTexts;
+
+  // Only set for the global fallback arena which can be accessed from multiple threads
+  std::unique_ptr<QMutex> accessMutex;
+};
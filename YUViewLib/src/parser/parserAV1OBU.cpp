@@ -178,6 +178,15 @@ unsigned int parserAV1OBU::parseAndAddOBU(int obuID, QByteArray data, TreeItem *
   // Get the payload of the OBU
   QByteArray obuData = data.mid(nrBytesHeader, obu.obu_size);
 
+  PacketIndex::Entry indexEntry;
+  indexEntry[PacketIndex::Column::NalType] = obu.obu_type;
+  indexEntry[PacketIndex::Column::Size] = data.size();
+  if (obu.obu_extension_flag)
+  {
+    indexEntry[PacketIndex::Column::TemporalID] = obu.temporal_id;
+    indexEntry[PacketIndex::Column::LayerID] = obu.spatial_id;
+  }
+
   bool parsingSuccess = true;
   if (obu.obu_type == OBU_TEMPORAL_DELIMITER)
   {
@@ -198,6 +207,8 @@ unsigned int parserAV1OBU::parseAndAddOBU(int obuID, QByteArray data, TreeItem *
   {
     auto new_frame_header = QSharedPointer<frame_header>(new frame_header(obu));
     parsingSuccess = new_frame_header->parse_frame_header(obuData, obuRoot, active_sequence_header, decValues);
+    if (parsingSuccess)
+      indexEntry[PacketIndex::Column::SliceType] = new_frame_header->frame_type;
 
     if (obuTypeName)
       *obuTypeName = parsingSuccess ? "FRAME" : "FRAME(ERR)";
@@ -205,7 +216,9 @@ unsigned int parserAV1OBU::parseAndAddOBU(int obuID, QByteArray data, TreeItem *
 
   if (obuRoot)
     // Set a useful name of the TreeItem (the root for this NAL)
-    obuRoot->itemData.append(QString("OBU %1: %2").arg(obu.obu_idx).arg(obu_type_toString.value(obu.obu_type)) + specificDescription);
+    obuRoot->setName(QString("OBU %1: %2").arg(obu.obu_idx).arg(obu_type_toString.value(obu.obu_type)) + specificDescription);
+
+  this->addPacketIndexEntry(indexEntry);
 
   return nrBytesHeader + (int)obu.obu_size;
 }
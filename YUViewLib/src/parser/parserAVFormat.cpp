@@ -345,6 +345,14 @@ bool parserAVFormat::parseAVPacket(unsigned int packetID, AVPacketWrapper &packe
 
   itemTree->setStreamIndex(packet.get_stream_index());
 
+  if (packet.getPacketType() != PacketType::VIDEO || (!this->annexBParser && !this->obuParser))
+  {
+    // The units in video packets are added to the index by the annexB/OBU parser
+    PacketIndex::Entry indexEntry;
+    indexEntry[PacketIndex::Column::Size] = packet.get_data_size();
+    this->addPacketIndexEntry(indexEntry);
+  }
+
   if (packet.getPacketType() == PacketType::VIDEO)
   {
     if (this->annexBParser)
@@ -533,7 +541,7 @@ bool parserAVFormat::parseAVPacket(unsigned int packetID, AVPacketWrapper &packe
   }
 
   // Set a useful name of the TreeItem (the root for this NAL)
-  itemTree->itemData.append(QString("AVPacket %1%2").arg(packetID).arg(packet.get_flag_keyframe() ? " - Keyframe": "") + specificDescription);
+  itemTree->setName(QString("AVPacket %1%2").arg(packetID).arg(packet.get_flag_keyframe() ? " - Keyframe": "") + specificDescription);
 
   return true;
 }
@@ -642,6 +650,9 @@ bool parserAVFormat::hvcC_nalUnit::parse_hvcC_nalUnit(int unitID, ReaderHelper &
 
 bool parserAVFormat::runParsingOfFile(QString compressedFilePath)
 {
+  // All TreeItems that are created while parsing (also by the sub parsers) are allocated from the arena of our model
+  TreeItemArena::Scope arenaScope(this->packetModel->getArena());
+
   // Open the file but don't parse it yet.
   QScopedPointer<FileSourceFFmpegFile> ffmpegFile(new FileSourceFFmpegFile());
   if (!ffmpegFile->openFile(compressedFilePath, nullptr, nullptr, false))
@@ -666,9 +677,15 @@ bool parserAVFormat::runParsingOfFile(QString compressedFilePath)
   }
 
   if (this->annexBParser)
+  {
     this->annexBParser->setRedirectPlotModel(this->getHRDPlotModel());
+    this->annexBParser->setRedirectPacketIndex(this->getPacketIndex());
+  }
   if (this->obuParser)
+  {
     this->obuParser->setRedirectPlotModel(this->getHRDPlotModel());
+    this->obuParser->setRedirectPacketIndex(this->getPacketIndex());
+  }
 
   int max_ts = ffmpegFile->getMaxTS();
   videoStreamIndex = ffmpegFile->getVideoStreamIndex();
@@ -733,6 +750,7 @@ bool parserAVFormat::runParsingOfFile(QString compressedFilePath)
     }
 
     packetID++;
+    this->forwardParsedPacketsToSink();
     packet = ffmpegFile->getNextPacket(false, false);
     
     // For signal slot debugging purposes, sleep
@@ -756,6 +774,8 @@ bool parserAVFormat::runParsingOfFile(QString compressedFilePath)
     }
   }
 
+  this->forwardParsedPacketsToSink(true);
+
   // Seek back to the beginning of the stream.
   ffmpegFile->seekFileToBeginning();
 
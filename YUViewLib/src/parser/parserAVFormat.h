@@ -59,6 +59,9 @@ public:
 
   int getVideoStreamIndex() Q_DECL_OVERRIDE { return videoStreamIndex; }
 
+  // The NAL units in the packets are parsed by the annexB parser which may reparse SEIs later
+  bool isPacketReparsePending() const override { return this->annexBParser && this->annexBParser->isPacketReparsePending(); }
+
 private:
   AVCodecIDWrapper codecID;
 
@@ -137,6 +137,9 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
 {
   DEBUG_ANNEXB("parserAnnexB::parseAnnexBFile");
 
+  // All TreeItems that are created while parsing are allocated from the arena of our model
+  TreeItemArena::Scope arenaScope(this->packetModel->getArena());
+
   int64_t maxPos = file->getFileSize();
   QScopedPointer<QProgressDialog> progressDialog;
   int curPercentValue = 0;
@@ -196,6 +199,7 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
     }
 
     nalID++;
+    this->forwardParsedPacketsToSink();
 
     if (progressDialog)
     {
@@ -236,6 +240,7 @@ bool parserAnnexB::parseAnnexBFile(QScopedPointer<FileSourceAnnexBFile> &file, Q
   if (!parseResult.success)
     DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Error finalizing parsing. This should not happen.");
   DEBUG_ANNEXB("parserAnnexB::parseAndAddNALUnit Parsing done. Found " << POCList.length() << " POCs");
+  this->forwardParsedPacketsToSink(true);
 
   if (packetModel)
     emit modelDataUpdated();
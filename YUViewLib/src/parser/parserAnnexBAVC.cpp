@@ -208,6 +208,11 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
     }
   }
 
+  PacketIndex::Entry indexEntry;
+  indexEntry[PacketIndex::Column::NalType] = nal_avc.nal_unit_type;
+  indexEntry[PacketIndex::Column::Size] = data.size();
+  QList<int> seiPayloadTypes;
+
   bool parsingSuccess = true;
   bool currentSliceIntra = false;
   QString currentSliceType;
@@ -227,6 +232,8 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
 
     // Add the SPS ID
     specificDescription = parsingSuccess ? QString(" SPS_NUT ID %1").arg(new_sps->seq_parameter_set_id) : " SPS_NUT ERR";
+    if (parsingSuccess)
+      indexEntry[PacketIndex::Column::ParameterSetID] = new_sps->seq_parameter_set_id;
     parseResult.nalTypeName = parsingSuccess ? QString("SPS(%1)").arg(new_sps->seq_parameter_set_id) : "SPS(ERR)";
     
     if (new_sps->vui_parameters.nal_hrd_parameters_present_flag || new_sps->vui_parameters.vcl_hrd_parameters_present_flag)
@@ -253,6 +260,8 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
 
     // Add the PPS ID
     specificDescription = parsingSuccess ? QString(" PPS_NUT ID %1").arg(new_pps->pic_parameter_set_id) : "PPS_NUT ERR";
+    if (parsingSuccess)
+      indexEntry[PacketIndex::Column::ParameterSetID] = new_pps->pic_parameter_set_id;
     parseResult.nalTypeName = parsingSuccess ? QString("PPS(%1)").arg(new_pps->pic_parameter_set_id) : "PPS(ERR)";
 
     DEBUG_AVC("parserAnnexBAVC::parseAndAddNALUnit Parse PPS ID " << new_pps->pic_parameter_set_id);
@@ -308,6 +317,10 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
       currentSliceIntra = new_slice->isRandomAccess();
       currentSliceType = new_slice->getSliceTypeString();
 
+      indexEntry[PacketIndex::Column::POC] = new_slice->globalPOC;
+      indexEntry[PacketIndex::Column::SliceType] = new_slice->slice_type;
+      indexEntry[PacketIndex::Column::ParameterSetID] = new_slice->pic_parameter_set_id;
+
       DEBUG_AVC("parserAnnexBAVC::parseAndAddNALUnit Parsed Slice POC " << new_slice->globalPOC);
     }
     else
@@ -333,7 +346,8 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
       sei_data.remove(0, nrBytes);
 
       if (message_tree)
-        message_tree->itemData[0] = QString("sei_message %1 - %2").arg(sei_count).arg(new_sei->payloadTypeName);
+        message_tree->setName(QString("sei_message %1 - %2").arg(sei_count).arg(new_sei->payloadTypeName));
+      seiPayloadTypes.append(new_sei->payloadType);
 
       // The real number of bytes to read from the bitstream may be higher than the indicated payload size (emulation prevention)
       int realPayloadSize = determineRealNumberOfBytesSEIEmulationPrevention(sei_data, new_sei->payloadSize);
@@ -453,10 +467,12 @@ parserAnnexB::ParseResult parserAnnexBAVC::parseAndAddNALUnit(int nalID, QByteAr
   if (nalRoot)
   {
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_avc.nal_idx).arg(nal_unit_type_toString.value(nal_avc.nal_unit_type)) + specificDescription);
+    nalRoot->setName(QString("NAL %1: %2").arg(nal_avc.nal_idx).arg(nal_unit_type_toString.value(nal_avc.nal_unit_type)) + specificDescription);
     nalRoot->setError(!parsingSuccess);
   }
 
+  this->addPacketIndexEntry(indexEntry, seiPayloadTypes);
+
   parseResult.success = true;
   return parseResult;
 }
@@ -2326,13 +2342,14 @@ void parserAnnexBAVC::HRD::addAU(unsigned auBits, unsigned poc, QSharedPointer<s
     time_t initial_cpb_removal_delay_time(initial_cpb_removal_delay);
     if (!cbr_flag && initial_cpb_removal_delay_time > ceil(t_g_90))
     {
-      // TODO: These logs should go somewhere!
       DEBUG_AVC("HRD AU " << this->au_n << " POC " << poc << " - Warning: Conformance fail. initial_cpb_removal_delay " << initial_cpb_removal_delay << " - should be <= ceil(t_g_90) " << double(ceil(t_g_90)));
+      this->addEvent(HRDPlotModel::HRDEvent::Type::ConformanceViolation, poc, t_r_nominal_n, 0, QString("initial_cpb_removal_delay %1 should be <= ceil(t_g_90) %2").arg(initial_cpb_removal_delay).arg(double(ceil(t_g_90))), plotModel);
     }
 
     if (cbr_flag && initial_cpb_removal_delay_time < floor(t_g_90))
     {
       DEBUG_AVC("HRD AU " << this->au_n << " POC " << poc << " - Warning: Conformance fail. initial_cpb_removal_delay " << initial_cpb_removal_delay << " - should be >= floor(t_g_90) " << double(floor(t_g_90)));
+      this->addEvent(HRDPlotModel::HRDEvent::Type::ConformanceViolation, poc, t_r_nominal_n, 0, QString("initial_cpb_removal_delay %1 should be >= floor(t_g_90) %2").arg(initial_cpb_removal_delay).arg(double(floor(t_g_90))), plotModel);
     }
   }
 
@@ -2366,11 +2383,13 @@ void parserAnnexBAVC::HRD::addAU(unsigned auBits, unsigned poc, QSharedPointer<s
           // This should not happen (all frames prior to t_af_nm1 should have been
           // removed from the buffer already). Remove now and warn.
           DEBUG_AVC("HRD AU " << this->au_n << " POC " << poc << " - Warning: Removing frame with removal time (" << double(it->t_r) << ") before final arrival time (" << double(t_af_nm1) << "). Buffer underflow");
+          this->addEvent(HRDPlotModel::HRDEvent::Type::Underflow, it->poc, it->t_r, 0, QString("Removal time %1 is before the final arrival time %2 of the previous AU").arg(double(it->t_r)).arg(double(this->t_af_nm1)), plotModel);
         }
-        this->addConstantBufferLine(poc, lastFrameTime, (*it).t_r, plotModel);
-        this->removeFromBufferAndCheck((*it), poc, (*it).t_r, plotModel);
+        const auto t_r = it->t_r;
+        this->addConstantBufferLine(poc, lastFrameTime, t_r, plotModel);
+        this->removeFromBufferAndCheck((*it), poc, t_r, plotModel);
         it = this->framesToRemove.erase(it);
-        lastFrameTime = (*it).t_r;
+        lastFrameTime = t_r;
       }
       else
         break;
@@ -2467,6 +2486,7 @@ void parserAnnexBAVC::HRD::addAU(unsigned auBits, unsigned poc, QSharedPointer<s
   if (t_r_nominal_n < t_af && !sps->vui_parameters.low_delay_hrd_flag)
   {
     DEBUG_AVC("HRD AU " << this->au_n << " POC " << poc << " - Warning: Decoding Buffer underflow t_r_n " << double(t_r_n) << " t_af " << double(t_af));
+    this->addEvent(HRDPlotModel::HRDEvent::Type::Underflow, poc, t_r_n, 0, QString("Nominal removal time %1 is before the final arrival time %2").arg(double(t_r_nominal_n)).arg(double(t_af)), plotModel);
   }
 
   this->au_n++;
@@ -2523,8 +2543,10 @@ void parserAnnexBAVC::HRD::addToBufferAndCheck(unsigned bufferAdd, unsigned buff
   }
   if (this->decodingBufferLevel > bufferSize)
   {
+    const auto overflowBits = this->decodingBufferLevel - int64_t(bufferSize);
     this->decodingBufferLevel = bufferSize;
-    DEBUG_AVC("HRD AU " << this->au_n << " POC " << poc << " - Warning: Time " << double(t_end) << " Decoding Buffer overflow by " << (int(this->decodingBufferLevel) - bufferSize) << "bits" << " added bits " << bufferAdd << ")");
+    DEBUG_AVC("HRD AU " << this->au_n << " POC " << poc << " - Warning: Time " << double(t_end) << " Decoding Buffer overflow by " << overflowBits << "bits" << " added bits " << bufferAdd << ")");
+    this->addEvent(HRDPlotModel::HRDEvent::Type::Overflow, poc, t_end, overflowBits, QString("Buffer overflow by %1 bits").arg(overflowBits), plotModel);
   }
 }
 
@@ -2552,9 +2574,22 @@ void parserAnnexBAVC::HRD::removeFromBufferAndCheck(const HRDFrameToRemove &fram
     // at the time but there is not enough data in the buffer to do so (to take the AU
     // out of the buffer).
     DEBUG_AVC("HRD AU " << this->au_n << " POC " << poc << " - Warning: Time " << double(frame.t_r) << " Decoding Buffer underflow by " << this->decodingBufferLevel << "bits");
+    this->addEvent(HRDPlotModel::HRDEvent::Type::Underflow, frame.poc, removalTime, -this->decodingBufferLevel, QString("Buffer underflow by %1 bits").arg(-this->decodingBufferLevel), plotModel);
   }
 }
 
+void parserAnnexBAVC::HRD::addEvent(HRDPlotModel::HRDEvent::Type type, int poc, time_t time, int64_t bits, const QString &message, HRDPlotModel *plotModel)
+{
+  HRDPlotModel::HRDEvent event;
+  event.type = type;
+  event.time = double(time);
+  event.poc = poc;
+  event.accessUnit = this->au_n;
+  event.bits = bits;
+  event.message = message;
+  plotModel->addHRDEvent(event);
+}
+
 void parserAnnexBAVC::HRD::addConstantBufferLine(int poc, time_t t_begin, time_t t_end, HRDPlotModel *plotModel)
 {
   HRDPlotModel::HRDEntry entry;
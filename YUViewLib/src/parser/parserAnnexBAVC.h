@@ -61,6 +61,8 @@ public:
   QPair<int,int> getProfileLevel() Q_DECL_OVERRIDE;
   QPair<int,int> getSampleAspectRatio() Q_DECL_OVERRIDE;
 
+  bool isPacketReparsePending() const override { return !this->reparse_sei.empty(); }
+
 protected:
   // ----- Some nested classes that are only used in the scope of this file handler class
 
@@ -610,6 +612,7 @@ protected:
     void addToBufferAndCheck(unsigned bufferAdd, unsigned bufferSize, int poc, time_t t_begin, time_t t_end, HRDPlotModel *plotModel);
     void removeFromBufferAndCheck(const HRDFrameToRemove &frame, int poc, time_t removalTime, HRDPlotModel *plotModel);
     void addConstantBufferLine(int poc, time_t t_begin, time_t t_end, HRDPlotModel *plotModel);
+    void addEvent(HRDPlotModel::HRDEvent::Type type, int poc, time_t time, int64_t bits, const QString &message, HRDPlotModel *plotModel);
 
     int64_t decodingBufferLevel {0};
   };
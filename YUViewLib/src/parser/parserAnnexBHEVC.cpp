@@ -389,6 +389,13 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
     }
   }
 
+  PacketIndex::Entry indexEntry;
+  indexEntry[PacketIndex::Column::NalType] = nal_hevc.nal_type;
+  indexEntry[PacketIndex::Column::TemporalID] = int(nal_hevc.nuh_temporal_id_plus1) - 1;
+  indexEntry[PacketIndex::Column::LayerID] = nal_hevc.nuh_layer_id;
+  indexEntry[PacketIndex::Column::Size] = data.size();
+  QList<int> seiPayloadTypes;
+
   bool parsingSuccess = true;
   if (nal_hevc.nal_type == VPS_NUT)
   {
@@ -404,6 +411,8 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
 
     // Add the VPS ID
     specificDescription = parsingSuccess ? QString(" VPS_NUT ID %1").arg(new_vps->vps_video_parameter_set_id) : " VPS_NUT ERR";
+    if (parsingSuccess)
+      indexEntry[PacketIndex::Column::ParameterSetID] = new_vps->vps_video_parameter_set_id;
     parseResult.nalTypeName = parsingSuccess ? QString("VPS(%1)").arg(new_vps->vps_video_parameter_set_id) : "VPS(ERR)";
 
     DEBUG_HEVC("parserAnnexBHEVC::parseAndAddNALUnit VPS ID " << new_vps->vps_video_parameter_set_id);
@@ -422,6 +431,8 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
 
     // Add the SPS ID
     specificDescription = parsingSuccess ? QString(" SPS_NUT ID %1").arg(new_sps->sps_seq_parameter_set_id) : " SPS_NUT ERR";
+    if (parsingSuccess)
+      indexEntry[PacketIndex::Column::ParameterSetID] = new_sps->sps_seq_parameter_set_id;
     parseResult.nalTypeName = parsingSuccess ? QString("SPS(%1)").arg(new_sps->sps_seq_parameter_set_id) : "SPS(ERR)";
 
     DEBUG_HEVC("parserAnnexBHEVC::parseAndAddNALUnit SPS ID " << new_sps->sps_seq_parameter_set_id);
@@ -440,6 +451,8 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
 
     // Add the PPS ID
     specificDescription = parsingSuccess ? QString(" PPS_NUT ID %1").arg(new_pps->pps_pic_parameter_set_id) : " PPS_NUT ERR";
+    if (parsingSuccess)
+      indexEntry[PacketIndex::Column::ParameterSetID] = new_pps->pps_pic_parameter_set_id;
     parseResult.nalTypeName = parsingSuccess ? QString("PPS(%1)").arg(new_pps->pps_pic_parameter_set_id) : "PPS(ERR)";
 
     DEBUG_HEVC("parserAnnexBHEVC::parseAndAddNALUnit PPS ID " << new_pps->pps_pic_parameter_set_id);
@@ -519,6 +532,10 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
         currentSliceIntra = true;
       }
       currentSliceType = new_slice->getSliceTypeString();
+
+      indexEntry[PacketIndex::Column::POC] = POC;
+      indexEntry[PacketIndex::Column::SliceType] = new_slice->slice_type;
+      indexEntry[PacketIndex::Column::ParameterSetID] = new_slice->slice_pic_parameter_set_id;
     }
 
     specificDescription = parsingSuccess ? QString(" POC %1").arg(POC) : " POC ERR";
@@ -542,7 +559,8 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
         return parseResult;
 
       if (message_tree)
-        message_tree->itemData[0] = QString("sei_message %1 - %2").arg(sei_count).arg(new_sei->payloadTypeName);
+        message_tree->setName(QString("sei_message %1 - %2").arg(sei_count).arg(new_sei->payloadTypeName));
+      seiPayloadTypes.append(new_sei->payloadType);
 
       auto sub_sei_data = seiReader.readBytes(new_sei->payloadSize);
 
@@ -668,7 +686,9 @@ parserAnnexB::ParseResult parserAnnexBHEVC::parseAndAddNALUnit(int nalID, QByteA
 
   if (nalRoot)
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_hevc.nal_idx).arg(nal_unit_type_toString.value(nal_hevc.nal_type)) + specificDescription);
+    nalRoot->setName(QString("NAL %1: %2").arg(nal_hevc.nal_idx).arg(nal_unit_type_toString.value(nal_hevc.nal_type)) + specificDescription);
+
+  this->addPacketIndexEntry(indexEntry, seiPayloadTypes);
 
   parseResult.success = true;
   return parseResult;
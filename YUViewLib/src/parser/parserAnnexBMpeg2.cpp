@@ -176,6 +176,10 @@ parserAnnexB::ParseResult parserAnnexBMpeg2::parseAndAddNALUnit(int nalID, QByte
   if (!nal_mpeg2.parse_nal_unit_header(nalHeaderBytes, nalRoot))
     return parseResult;
 
+  PacketIndex::Entry indexEntry;
+  indexEntry[PacketIndex::Column::NalType] = nal_mpeg2.nal_unit_type;
+  indexEntry[PacketIndex::Column::Size] = data.size();
+
   bool parsingSuccess = true;
   bool currentSliceIntra = false;
   QString currentSliceType;
@@ -207,6 +211,8 @@ parserAnnexB::ParseResult parserAnnexBMpeg2::parseAndAddNALUnit(int nalID, QByte
       currentSliceIntra = new_picture_header->isIntraPicture();
       lastPictureHeader = new_picture_header;
       currentSliceType = new_picture_header->getPictureTypeString();
+      indexEntry[PacketIndex::Column::POC] = curFramePOC;
+      indexEntry[PacketIndex::Column::SliceType] = new_picture_header->picture_coding_type;
       
       DEBUG_MPEG2("parserAnnexBMpeg2::parseAndAddNALUnit Picture");
     }
@@ -244,7 +250,7 @@ parserAnnexB::ParseResult parserAnnexBMpeg2::parseAndAddNALUnit(int nalID, QByte
       return parseResult;
 
     if (message_tree)
-      message_tree->itemData[0] = new_extension->get_extension_function_name();
+      message_tree->setName(new_extension->get_extension_function_name());
 
     if (new_extension->extension_type == EXT_SEQUENCE)
     {
@@ -321,7 +327,9 @@ parserAnnexB::ParseResult parserAnnexBMpeg2::parseAndAddNALUnit(int nalID, QByte
   
   if (nalRoot)
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_mpeg2.nal_idx).arg(nal_unit_type_toString.value(nal_mpeg2.nal_unit_type)) + specificDescription);
+    nalRoot->setName(QString("NAL %1: %2").arg(nal_mpeg2.nal_idx).arg(nal_unit_type_toString.value(nal_mpeg2.nal_unit_type)) + specificDescription);
+
+  this->addPacketIndexEntry(indexEntry);
 
   parseResult.success = true;
   return parseResult;
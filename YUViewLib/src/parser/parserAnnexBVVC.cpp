@@ -121,6 +121,12 @@ parserAnnexB::ParseResult parserAnnexBVVC::parseAndAddNALUnit(int nalID, QByteAr
   if (!nal_vvc.parse_nal_unit_header(nalHeaderBytes, nalRoot))
     return parseResult;
 
+  PacketIndex::Entry indexEntry;
+  indexEntry[PacketIndex::Column::NalType] = nal_vvc.nal_unit_type_id;
+  indexEntry[PacketIndex::Column::TemporalID] = int(nal_vvc.nuh_temporal_id_plus1) - 1;
+  indexEntry[PacketIndex::Column::LayerID] = nal_vvc.nuh_layer_id;
+  indexEntry[PacketIndex::Column::Size] = data.size();
+
   if (nal_vvc.isAUDelimiter())
   {
     DEBUG_VVC("Start of new AU. Adding bitrate " << sizeCurrentAU);
@@ -166,7 +172,9 @@ parserAnnexB::ParseResult parserAnnexBVVC::parseAndAddNALUnit(int nalID, QByteAr
 
   if (nalRoot)
     // Set a useful name of the TreeItem (the root for this NAL)
-    nalRoot->itemData.append(QString("NAL %1: %2").arg(nal_vvc.nal_idx).arg(nal_vvc.nal_unit_type_id) + specificDescription);
+    nalRoot->setName(QString("NAL %1: %2").arg(nal_vvc.nal_idx).arg(nal_vvc.nal_unit_type_id) + specificDescription);
+
+  this->addPacketIndexEntry(indexEntry);
 
   parseResult.success = true;
   return parseResult;
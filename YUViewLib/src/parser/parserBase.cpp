@@ -34,6 +34,8 @@
 
 #include <assert.h>
 
+#include "common/PacketDumpWriter.h"
+
 #define PARSERBASE_DEBUG_OUTPUT 0
 #if PARSERBASE_DEBUG_OUTPUT && !NDEBUG
 #include <QDebug>
@@ -51,6 +53,7 @@ parserBase::parserBase(QObject *parent) : QObject(parent)
   this->hrdPlotModel.reset(new HRDPlotModel());
   this->streamIndexFilter.reset(new FilterByStreamIndexProxyModel(parent));
   this->streamIndexFilter->setSourceModel(this->packetModel.data());
+  this->packetIndex.reset(new PacketIndex(this->packetModel.data()));
 }
 
 parserBase::~parserBase()
@@ -73,10 +76,33 @@ void parserBase::setRedirectPlotModel(HRDPlotModel *plotModel)
   this->redirectPlotModel = plotModel;
 }
 
+PacketIndex *parserBase::getPacketIndex()
+{
+  if (this->redirectPacketIndex != nullptr)
+    return this->redirectPacketIndex;
+  return this->packetIndex.data();
+}
+
+void parserBase::setRedirectPacketIndex(PacketIndex *index)
+{
+  Q_ASSERT_X(index != nullptr, Q_FUNC_INFO, "Redirect pointer is NULL");
+  this->packetIndex.reset(nullptr);
+  this->redirectPacketIndex = index;
+}
+
+void parserBase::addPacketIndexEntry(const PacketIndex::Entry &entry, const QList<int> &seiPayloadTypes)
+{
+  if (this->packetSink != nullptr)
+    // The packets are not kept in the model so there is nothing to index
+    return;
+  if (auto index = this->getPacketIndex())
+    index->addEntry(entry, seiPayloadTypes);
+}
+
 void parserBase::enableModel()
 {
   if (this->packetModel->isNull())
-    this->packetModel->rootItem.reset(new TreeItem(QStringList() << "Name" << "Value" << "Coding" << "Code" << "Meaning", nullptr));
+    this->packetModel->createRootItem(QStringList() << "Name" << "Value" << "Coding" << "Code" << "Meaning");
 }
 
 void parserBase::updateNumberModelItems()
@@ -84,6 +110,19 @@ void parserBase::updateNumberModelItems()
   this->packetModel->updateNumberModelItems();
 }
 
+void parserBase::forwardParsedPacketsToSink(bool finalFlush)
+{
+  if (this->packetSink == nullptr || this->packetModel->isNull())
+    return;
+  if (!finalFlush && this->isPacketReparsePending())
+    return;
+
+  auto rootItem = this->packetModel->getRootItem();
+  for (int i = 0; i < rootItem->getNrChildren(); i++)
+    this->packetSink->writePacket(rootItem->getChild(i));
+  this->packetModel->clearItems();
+}
+
 QString parserBase::convertSliceTypeMapToString(QMap<QString, unsigned int> &sliceTypes)
 {
   QString text;
@@ -40,6 +40,9 @@
 #include "common/PacketItemModel.h"
 #include "common/BitratePlotModel.h"
 #include "common/HRDPlotModel.h"
+#include "common/PacketIndex.h"
+
+class ParsedPacketSink;
 
 // If the file parsing limit is enabled (setParsingLimitEnabled) parsing will be aborted after
 // 500 frames have been parsed. This should be enough in most situations and full parsing can be
@@ -60,6 +63,8 @@ public:
   BitratePlotModel *getBitratePlotModel() { return bitratePlotModel.data(); }
   HRDPlotModel *getHRDPlotModel();
   void setRedirectPlotModel(HRDPlotModel *plotModel);
+  PacketIndex *getPacketIndex();
+  void setRedirectPacketIndex(PacketIndex *index);
   
   void updateNumberModelItems();
   void enableModel();
@@ -78,9 +83,21 @@ public:
 
   void setStreamColorCoding(bool colorCoding) { packetModel->setUseColorCoding(colorCoding); }
   void setFilterStreamIndex(int streamIndex) { streamIndexFilter->setFilterStreamIndex(streamIndex); }
+  void setFilterRows(const QVector<int> &rows) { streamIndexFilter->setFilterRows(rows); }
+  void clearFilterRows() { streamIndexFilter->clearFilterRows(); }
   void setParsingLimitEnabled(bool limitEnabled) { parsingLimitEnabled = limitEnabled; }
   void setBitrateSortingIndex(int sortingIndex) { bitratePlotModel->setBitrateSortingIndex(sortingIndex); }
 
+  // If a sink is set, every parsed packet is handed to the sink and then deleted from the packet
+  // model right away. This way, the syntax of huge files can be streamed out (e.g. to a file)
+  // without keeping the whole tree in memory. The model must be enabled for this (enableModel).
+  void setPacketSink(ParsedPacketSink *sink) { packetSink = sink; }
+
+  // Some units (e.g. SEIs that reference a parameter set that was not received yet) are parsed
+  // again later and then write into the tree items of an already parsed packet. As long as this
+  // returns true, the parsed packets must not be handed to the sink (and deleted) yet.
+  virtual bool isPacketReparsePending() const { return false; }
+
 signals:
   // Some data was updated and the models can be updated to reflec this. This is called regularly
   // but not for every packet/Nal unit that is parsed.
@@ -95,6 +112,14 @@ protected:
   QScopedPointer<FilterByStreamIndexProxyModel> streamIndexFilter;
   QScopedPointer<BitratePlotModel> bitratePlotModel;
 
+  // Add the properties of the parsed unit to the packet index (if enabled)
+  void addPacketIndexEntry(const PacketIndex::Entry &entry, const QList<int> &seiPayloadTypes = {});
+
+  // Pass all first level items of the packet model to the packet sink (if set) and delete them.
+  // Call this after each parsed packet. The items are held back while a reparse is pending
+  // (isPacketReparsePending). Set finalFlush once parsing is done to forward them anyway.
+  void forwardParsedPacketsToSink(bool finalFlush = false);
+
   static QString convertSliceTypeMapToString(QMap<QString, unsigned int> &currentAUSliceTypes);
 
   // If this variable is set (from an external thread), the parsing process should cancel immediately
@@ -105,4 +130,7 @@ protected:
 private:
   QScopedPointer<HRDPlotModel> hrdPlotModel;
   HRDPlotModel *redirectPlotModel {nullptr};
+  QScopedPointer<PacketIndex> packetIndex;
+  PacketIndex *redirectPacketIndex {nullptr};
+  ParsedPacketSink *packetSink {nullptr};
 };
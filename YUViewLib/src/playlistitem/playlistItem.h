@@ -133,6 +133,11 @@ public:
   // item is not indexed by frame, the parameter frameIdx is ignored. drawRawValues can control if the raw pixel values are drawn. 
   // This implementation will draw the infoText on screen. You can use this in derived classes to draw an info text in certain situations.
   virtual void drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues);
+  // Draw the item like drawItem but only from data that is already loaded (e.g. the double buffer) and without changing which
+  // frame is the current one. Return false if the frame can not be drawn like this. This is used to compose overlays ahead of time.
+  virtual bool drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues) { Q_UNUSED(painter); Q_UNUSED(frameIdx); Q_UNUSED(zoomFactor); Q_UNUSED(drawRawValues); return false; }
+  // The frame was shown without calling drawItem (e.g. from a composed overlay layer). Update the internal state as drawItem would.
+  virtual void setDrawnFrame(int frameIdx) { Q_UNUSED(frameIdx); }
 
   // When a new frame is selected (by the user or by playback), it will firstly be checked if the playlistitem needs to load the frame.
   // If this returns true, the loadFrame() function will be called in the background.
@@ -170,6 +175,15 @@ public:
   // too late.
   virtual void activateDoubleBuffer() {}
 
+  // Playback is running backwards. Items that load the next frame into a double buffer during playback
+  // should load the previous frame instead.
+  virtual void setPlaybackReverse(bool reverse) { playbackReverse = reverse; }
+
+  // The number of downscaled levels (see ImagePyramid) that the views need at their zoom factor. Items that convert
+  // frames to images can build these ahead of time (e.g. when caching or loading the double buffer). While playing,
+  // they may also convert frames at the reduced size directly. These must be loaded again once playback stopped.
+  virtual void setNrPyramidLevelsToBuild(int nrLevels, bool playing) { Q_UNUSED(nrLevels); Q_UNUSED(playing); }
+
   // ----- Caching -----
 
   // Can this item be cached? The default is no. Set cachingEnabled in your subclass to true
@@ -180,6 +194,9 @@ public:
   virtual bool taggedForDeletion() const { return itemTaggedForDeletion; }
   // Is there a limit on the number of threads that can cache from this item at the same time? (-1 = no limit)
   virtual int cachingThreadLimit() { return -1; }
+  // How many frames after the next one should the caching threads load ahead while playback is running? This is done
+  // even if caching during playback is disabled (the prefetch setting applies). Items that load a frame slower than the frame rate can use this.
+  virtual int getPlaybackReadAheadFrames() const { return 0; }
   // Tag the item as "to be deleted"
   void tagItemForDeletion() { itemTaggedForDeletion = true; }
   // Cache the given frame. This function is thread save. So multiple instances of this function can run at the same time.
@@ -253,6 +270,9 @@ protected:
 
   // Is caching enabled for this item? This can be changed at any point.
   bool cachingEnabled {false};
+
+  // Is playback currently running backwards?
+  bool playbackReverse {false};
   
   // Item is being deleted. We might need to wait until all caching/loading jobs for the item are finished
   // before we can actually delete it. An item that is tagged for deletion should not be cached/loaded anymore.
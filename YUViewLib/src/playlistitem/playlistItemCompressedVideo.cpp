@@ -35,16 +35,14 @@
 #include <QThread>
 #include <QInputDialog>
 #include <QPlainTextEdit>
+#include <QtConcurrent>
 
 #include <inttypes.h>
 
+#include "common/FrameProfiler.h"
 #include "common/functions.h"
 #include "common/YUViewDomElement.h"
 #include "decoder/decoderFFmpeg.h"
-#include "decoder/decoderHM.h"
-#include "decoder/decoderVTM.h"
-#include "decoder/decoderDav1d.h"
-#include "decoder/decoderLibde265.h"
 #include "parser/parserAnnexBAVC.h"
 #include "parser/parserAnnexBHEVC.h"
 #include "parser/parserAnnexBVVC.h"
@@ -263,6 +261,7 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   DEBUG_COMPRESSED("playlistItemCompressedVideo::playlistItemCompressedVideo Initializing decoder enigne type %d", decoderEngineType);
   if (!allocateDecoder(displayComponent))
     return;
+  updateSettings();
 
   if (rawFormat == raw_YUV)
   {
@@ -294,6 +293,12 @@ playlistItemCompressedVideo::playlistItemCompressedVideo(const QString &compress
   connect(&statSource, &statisticHandler::requestStatisticsLoading, this, &playlistItemCompressedVideo::loadStatisticToCache, Qt::DirectConnection);
 }
 
+playlistItemCompressedVideo::~playlistItemCompressedVideo()
+{
+  // The staging job uses the caching decoder
+  stopReverseStaging();
+}
+
 void playlistItemCompressedVideo::savePlaylist(QDomElement &root, const QDir &playlistDir) const
 {
   // Determine the relative path to the HEVC file. We save both in the playlist.
@@ -313,6 +318,8 @@ void playlistItemCompressedVideo::savePlaylist(QDomElement &root, const QDir &pl
 
   d.appendProperiteChild("inputFormat", functions::getInputFormatName(inputFormatType));
   d.appendProperiteChild("decoder", functions::getDecoderEngineName(decoderEngineType));
+  if (decodeAllSignals)
+    d.appendProperiteChild("decodeAllSignals", "1");
   
   root.appendChild(d);
 }
@@ -339,6 +346,8 @@ playlistItemCompressedVideo *playlistItemCompressedVideo::newPlaylistItemCompres
   
   // We can still not be sure that the file really exists, but we gave our best to try to find it.
   playlistItemCompressedVideo *newFile = new playlistItemCompressedVideo(filePath, displaySignal, input, decoder);
+  if (root.findChildValue("decodeAllSignals") == "1")
+    newFile->decodeAllSignalsCheckBoxToggled(true);
 
   // Load the propertied of the playlistItemIndexed
   playlistItem::loadPropertiesFromPlaylist(root, newFile);
@@ -380,6 +389,8 @@ infoData playlistItemCompressedVideo::getInfo() const
       info.items.append(infoItem("Decoder", loadingDecoder->getCodecName()));
       info.items.append(infoItem("Statistics", loadingDecoder->statisticsSupported() ? "Yes" : "No", "Is the decoder able to provide internals (statistics)?"));
       info.items.append(infoItem("Stat Parsing", loadingDecoder->statisticsEnabled() ? "Yes" : "No", "Are the statistics of the sequence currently extracted from the stream?"));
+      auto &pool = DecoderPool::instance();
+      info.items.append(infoItem("Decoder Pool", QString("%1 hits / %2 misses (%3 idle)").arg(pool.getNrHits()).arg(pool.getNrMisses()).arg(pool.getNrIdleDecoders()), "How often a decoder could be reused from the pool of idle decoders instead of creating a new one."));
     }
   }
   if (decoderEngineType == decoderEngineFFMpeg)
@@ -460,7 +471,77 @@ void playlistItemCompressedVideo::drawItem(QPainter *painter, int frameIdx, doub
   }
 }
 
+bool playlistItemCompressedVideo::drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData)
+{
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+
+  // The info text is set in drawItem
+  if (decodingNotPossibleAfter >= 0 && frameIdxInternal >= decodingNotPossibleAfter)
+    return false;
+  if (unresolvableError || !decodingEnabled || loadingDecoder.isNull())
+    return false;
+  // The pixel values are drawn from the raw data of the current frame
+  if (drawRawData && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
+    return false;
+
+  if (frameIdxInternal < startEndFrame.first || frameIdxInternal > startEndFrame.second)
+    // Nothing is drawn for this frame
+    return true;
+  if (statSource.needsLoading(frameIdxInternal) != LoadingNotNeeded)
+    return false;
+  if (!video->drawLoadedFrame(painter, frameIdxInternal, zoomFactor))
+    return false;
+  statSource.paintStatistics(painter, frameIdxInternal, zoomFactor);
+  return true;
+}
+
 void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching)
+{
+  FRAME_PROFILER_SCOPE(caching ? "Decode (caching)" : "Decode", frameIdxInternal);
+  if (!caching && decodingEnabled && frameIdxInternal >= 0 && frameIdxInternal <= startEndFrame.second)
+  {
+    // Frames that the interactive decoder produced recently do not have to be decoded again
+    const int signalID = loadingDecoder->getDecodeSignal();
+    auto frame = decodedFrameRing.get(frameIdxInternal, signalID);
+    if (frame.isNull() && playbackReverse)
+    {
+      QFuture<void> stagingFuture;
+      {
+        QMutexLocker lock(&reverseStagingMutex);
+        stagingFuture = reverseStagingFuture;
+      }
+      if (stagingFuture.isRunning())
+      {
+        // The frame is probably being staged right now. This is faster than decoding the GOP again.
+        DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData %d waiting for reverse staging", frameIdxInternal);
+        stagingFuture.waitForFinished();
+        frame = decodedFrameRing.get(frameIdxInternal, signalID);
+      }
+    }
+    if (frame.isNull() && frameIdxInternal == currentFrameIdx[0] && loadingDecoder->decodesAllSignals())
+      // After a switch of the display signal, the decoder still holds all signals of its current frame
+      frame = (rawFormat == raw_YUV) ? loadingDecoder->getFrameBuffer() : FrameBuffer(loadingDecoder->getRawFrameData());
+    if (!frame.isNull())
+    {
+      DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData %d from the decoded frame ring", frameIdxInternal);
+      if (rawFormat == raw_YUV)
+        video->rawFrameBuffer = frame;
+      else
+        video->rawData = frame.toByteArray();
+      video->rawData_frameIdx = frameIdxInternal;
+    }
+    else
+      decodeRawData(frameIdxInternal, caching);
+
+    if (playbackReverse)
+      startReverseStaging(frameIdxInternal);
+    return;
+  }
+
+  decodeRawData(frameIdxInternal, caching);
+}
+
+void playlistItemCompressedVideo::decodeRawData(int frameIdxInternal, bool caching, bool stageOnly)
 {
   if (caching && !cachingEnabled)
     return;
@@ -527,6 +608,9 @@ void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching
   bool rightFrame = caching ? currentFrameIdx[1] == frameIdxInternal : currentFrameIdx[0] == frameIdxInternal;
   while (!rightFrame)
   {
+    if (stageOnly && cancelReverseStaging)
+      return;
+
     while (dec->needsMoreData())
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoder needs more data");
@@ -609,10 +693,28 @@ void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching
 
         DEBUG_COMPRESSED("playlistItemCompressedVideo::loadRawData decoded frame %d", caching ? currentFrameIdx[1] : currentFrameIdx[0]);
         rightFrame = caching ? currentFrameIdx[1] == frameIdxInternal : currentFrameIdx[0] == frameIdxInternal;
-        if (rightFrame)
+        // Keep all frames of the interactive decoder. After a backwards seek, this checkpoints the
+        // whole GOP up to the requested frame so that further steps backwards do not decode again.
+        const bool storeInRing = (!caching || stageOnly) && decodedFrameRing.isEnabled();
+        if ((rightFrame && !stageOnly) || storeInRing)
         {
-          video->rawData = dec->getRawFrameData();
-          video->rawData_frameIdx = frameIdxInternal;
+          // Reference the decoded picture. The YUV conversion reads directly from the planes of the decoder.
+          auto frame = (rawFormat == raw_YUV) ? dec->getFrameBuffer() : FrameBuffer(dec->getRawFrameData());
+          if (storeInRing)
+          {
+            const int frameIdx = caching ? currentFrameIdx[1] : currentFrameIdx[0];
+            decodedFrameRing.store(frameIdx, frame, dec->getDecodeSignal());
+            if (dec->decodesAllSignals())
+              storeAllSignalsInRing(dec, frameIdx);
+          }
+          if (rightFrame && !stageOnly)
+          {
+            if (rawFormat == raw_YUV)
+              video->rawFrameBuffer = frame;
+            else
+              video->rawData = frame.toByteArray();
+            video->rawData_frameIdx = frameIdxInternal;
+          }
         }
       }
     }
@@ -635,11 +737,12 @@ void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching
       currentFrameIdx[0] = frameIdxInternal;
     // Just set the frame number of the buffer to the current frame so that it will trigger a
     // reload when the frame number changes.
-    video->rawData_frameIdx = frameIdxInternal;
+    if (!stageOnly)
+      video->rawData_frameIdx = frameIdxInternal;
   }
-  else if (loadingDecoder->errorInDecoder())
+  else if (!stageOnly && loadingDecoder->errorInDecoder())
   {
-    // There was an error in the deocder. 
+    // There was an error in the deocder. The staging thread must not change the state of the item.
     infoText = "There was an error in the decoder: \n";
     infoText += loadingDecoder->decoderErrorString();
     infoText += "\n";
@@ -648,6 +751,108 @@ void playlistItemCompressedVideo::loadRawData(int frameIdxInternal, bool caching
   }
 }
 
+void playlistItemCompressedVideo::storeAllSignalsInRing(decoderBase *dec, int frameIdxInternal)
+{
+  for (int signalID = 0; signalID < dec->nrSignalsSupported(); signalID++)
+    if (signalID != dec->getDecodeSignal())
+      decodedFrameRing.store(frameIdxInternal, dec->getSignalFrameBuffer(signalID), signalID);
+  if (dec->statisticsEnabled())
+    decodedFrameRing.storeStatistics(frameIdxInternal, dec->getCurrentFrameStatistics());
+}
+
+bool playlistItemCompressedVideo::applyDecodeAllSignals()
+{
+  bool resetLoadingDecoder = false;
+  loadingDecoder->setDecodeAllSignals(decodeAllSignals, resetLoadingDecoder);
+  if (decodeAllSignals && loadingDecoder->decodesAllSignals() && loadingDecoder->statisticsSupported() && !loadingDecoder->statisticsEnabled())
+  {
+    // The statistics are exported in the same pass. Statistics are always retrieved for the loading decoder.
+    loadingDecoder->enableStatisticsRetrieval();
+    resetLoadingDecoder = true;
+  }
+  if (resetLoadingDecoder)
+    loadingDecoder->resetDecoder();
+  return resetLoadingDecoder;
+}
+
+void playlistItemCompressedVideo::setCachingDecoderAllSignals(bool allSignals)
+{
+  if (!cachingDecoder)
+    return;
+
+  bool resetCachingDecoder = false;
+  cachingDecoder->setDecodeAllSignals(allSignals, resetCachingDecoder);
+  if (resetCachingDecoder)
+  {
+    cachingDecoder->resetDecoder();
+    // The caching decoder has to seek before it can decode again
+    currentFrameIdx[1] = -1;
+  }
+}
+
+void playlistItemCompressedVideo::setPlaybackReverse(bool reverse)
+{
+  playlistItemWithVideo::setPlaybackReverse(reverse);
+  decodedFrameRing.setPlaybackReverse(reverse);
+  if (!reverse)
+    // Let a running staging job finish early. Its frames are not needed anymore.
+    cancelReverseStaging = true;
+}
+
+int playlistItemCompressedVideo::getClosestSeekableFrameBefore(int frameIdxInternal)
+{
+  int seekToFrame = -1;
+  if (isInputFormatTypeAnnexB(inputFormatType))
+  {
+    int seekToAnnexBFrameCount;
+    seekToFrame = inputFileAnnexBParser->getClosestSeekableFrameNumberBefore(frameIdxInternal, seekToAnnexBFrameCount);
+  }
+  else
+    inputFileFFmpegLoading->getClosestSeekableDTSBefore(frameIdxInternal, seekToFrame);
+  return seekToFrame;
+}
+
+void playlistItemCompressedVideo::startReverseStaging(int frameIdxInternal)
+{
+  // Staging uses the caching decoder and needs space in the ring to put the frames
+  if (!cachingEnabled || !decodedFrameRing.isEnabled())
+    return;
+
+  QMutexLocker lock(&reverseStagingMutex);
+  if (reverseStagingFuture.isRunning())
+    return;
+
+  // Playback continues with the last frame of the GOP before the GOP of the given frame
+  const int lastFrameIdx = getClosestSeekableFrameBefore(frameIdxInternal) - 1;
+  if (lastFrameIdx < startEndFrame.first || decodedFrameRing.contains(lastFrameIdx, loadingDecoder->getDecodeSignal()))
+    return;
+
+  DEBUG_COMPRESSED("playlistItemCompressedVideo::startReverseStaging staging GOP up to frame %d", lastFrameIdx);
+  cancelReverseStaging = false;
+  reverseStagingFuture = QtConcurrent::run(this, &playlistItemCompressedVideo::stageFramesForReversePlayback, lastFrameIdx);
+}
+
+void playlistItemCompressedVideo::stageFramesForReversePlayback(int lastFrameIdx)
+{
+  // The caching decoder seeks to the random access point before lastFrameIdx and puts all frames
+  // up to lastFrameIdx into the ring.
+  QMutexLocker lock(&cachingMutex);
+  setCachingDecoderAllSignals(decodeAllSignals);
+  decodeRawData(lastFrameIdx, true, true);
+  setCachingDecoderAllSignals(false);
+}
+
+void playlistItemCompressedVideo::stopReverseStaging()
+{
+  cancelReverseStaging = true;
+  QFuture<void> stagingFuture;
+  {
+    QMutexLocker lock(&reverseStagingMutex);
+    stagingFuture = reverseStagingFuture;
+  }
+  stagingFuture.waitForFinished();
+}
+
 void playlistItemCompressedVideo::seekToPosition(int seekToFrame, int seekToDTS, bool caching)
 {
   // Do the seek
@@ -747,14 +952,19 @@ void playlistItemCompressedVideo::createPropertiesWidget()
     ui.comboBoxDecoder->addItem(decoderTypeName);
   }
   ui.comboBoxDecoder->setCurrentIndex(possibleDecoders.indexOf(decoderEngineType));
+  ui.checkBoxDecodeAllSignals->setChecked(decodeAllSignals);
+  ui.checkBoxDecodeAllSignals->setEnabled(loadingDecoder && loadingDecoder->supportsSinglePassSignals());
 
   // Connect signals/slots
   connect(ui.comboBoxDisplaySignal, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &playlistItemCompressedVideo::displaySignalComboBoxChanged);
   connect(ui.comboBoxDecoder, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &playlistItemCompressedVideo::decoderComboxBoxChanged);
+  connect(ui.checkBoxDecodeAllSignals, &QCheckBox::toggled, this, &playlistItemCompressedVideo::decodeAllSignalsCheckBoxToggled);
 }
 
 bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
 {
+  stopReverseStaging();
+
   // Reset (existing) decoders
   loadingDecoder.reset();
   cachingDecoder.reset();
@@ -762,41 +972,41 @@ bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
   if (decoderEngineType == decoderEngineLibde265)
   {
     DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive libde265 decoder");
-    loadingDecoder.reset(new decoderLibde265(displayComponent));
+    loadingDecoder.reset(DecoderPool::instance().getDecoder(decoderEngineLibde265, displayComponent));
     if (cachingEnabled)
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing caching libde265 decoder");
-      cachingDecoder.reset(new decoderLibde265(displayComponent, true));
+      cachingDecoder.reset(DecoderPool::instance().getDecoder(decoderEngineLibde265, displayComponent, true));
     }
   }
   else if (decoderEngineType == decoderEngineHM)
   {
     DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive HM decoder");
-    loadingDecoder.reset(new decoderHM(displayComponent));
+    loadingDecoder.reset(DecoderPool::instance().getDecoder(decoderEngineHM, displayComponent));
     if (cachingEnabled)
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder caching interactive HM decoder");
-      cachingDecoder.reset(new decoderHM(displayComponent, true));
+      cachingDecoder.reset(DecoderPool::instance().getDecoder(decoderEngineHM, displayComponent, true));
     }
   }
   else if (decoderEngineType == decoderEngineVTM)
   {
     DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive VTM decoder");
-    loadingDecoder.reset(new decoderVTM(displayComponent));
+    loadingDecoder.reset(DecoderPool::instance().getDecoder(decoderEngineVTM, displayComponent));
     if (cachingEnabled)
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder caching interactive VTM decoder");
-      cachingDecoder.reset(new decoderVTM(displayComponent, true));
+      cachingDecoder.reset(DecoderPool::instance().getDecoder(decoderEngineVTM, displayComponent, true));
     }
   }
   else if (decoderEngineType == decoderEngineDav1d)
   {
     DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder Initializing interactive dav1d decoder");
-    loadingDecoder.reset(new decoderDav1d(displayComponent));
+    loadingDecoder.reset(DecoderPool::instance().getDecoder(decoderEngineDav1d, displayComponent));
     if (cachingEnabled)
     {
       DEBUG_COMPRESSED("playlistItemCompressedVideo::allocateDecoder caching interactive dav1d decoder");
-      cachingDecoder.reset(new decoderDav1d(displayComponent, true));
+      cachingDecoder.reset(DecoderPool::instance().getDecoder(decoderEngineDav1d, displayComponent, true));
     }
   }
   else if (decoderEngineType == decoderEngineFFMpeg)
@@ -844,6 +1054,7 @@ bool playlistItemCompressedVideo::allocateDecoder(int displayComponent)
     return false;
   }
 
+  applyDecodeAllSignals();
   return true;
 }
 
@@ -862,24 +1073,34 @@ void playlistItemCompressedVideo::loadStatisticToCache(int frameIdx, int typeIdx
 
   if (!loadingDecoder->statisticsSupported())
     return;
+
+  // If all signals are decoded in one pass, the statistics of recently decoded frames are kept in the ring
+  statisticsData ringStatistics;
+  if (decodedFrameRing.getStatistics(frameIdxInternal, typeIdx, ringStatistics))
+  {
+    DEBUG_COMPRESSED("playlistItemCompressedVideo::loadStatisticToCache frame %d from the decoded frame ring", frameIdxInternal);
+    statSource.statsCache[typeIdx] = ringStatistics;
+    return;
+  }
+
   if (!loadingDecoder->statisticsEnabled())
   {
     // We have to enable collecting of statistics in the decoder. By default (for speed reasons) this is off.
     // Enabeling works like this: Enable collection, reset the decoder and decode the current frame again.
-    // Statisitcs are always retrieved for the loading decoder.
+    // Statistics are always retrieved for the loading decoder.
     loadingDecoder->enableStatisticsRetrieval();
 
     // Reload the current frame (force a seek and decode operation)
     int frameToLoad = currentFrameIdx[0];
     currentFrameIdx[0] = INT_MAX;
-    loadRawData(frameToLoad, false);
+    decodeRawData(frameToLoad, false);
 
     // The statistics should now be loaded
   }
   else if (frameIdxInternal != currentFrameIdx[0])
     // If the requested frame is not currently decoded, decode it.
-    // This can happen if the picture was gotten from the cache.
-    loadRawData(frameIdxInternal, false);
+    // This can happen if the picture was gotten from the cache or the decoded frame ring.
+    decodeRawData(frameIdxInternal, false);
 
   statSource.statsCache[typeIdx] = loadingDecoder->getStatisticsData(typeIdx);
 }
@@ -939,10 +1160,26 @@ void playlistItemCompressedVideo::reloadItemSource()
 
   // Reset the videoHandlerYUV source. With the next draw event, the videoHandlerYUV will request to decode the frame again.
   video->invalidateAllBuffers();
+  stopReverseStaging();
+  decodedFrameRing.clear();
 
   // Load frame 0. This will decode the first frame in the sequence and set the
   // correct frame size/YUV format.
   loadRawData(0, false);
+
+  emit signalItemChanged(true, RECACHE_CLEAR);
+}
+
+void playlistItemCompressedVideo::updateSettings()
+{
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  const bool ringEnabled = settings.value("FrameRingEnabled", false).toBool();
+  const int64_t ringSizeMB = settings.value("FrameRingSizeMB", 512).toInt();
+  const bool ringCompress = settings.value("FrameRingCompress", false).toBool();
+  settings.endGroup();
+
+  decodedFrameRing.setLimits(ringEnabled ? ringSizeMB * 1024 * 1024 : 0, ringCompress);
 }
 
 void playlistItemCompressedVideo::cacheFrame(int frameIdx, bool testMode)
@@ -1005,6 +1242,8 @@ void playlistItemCompressedVideo::displaySignalComboBoxChanged(int idx)
 {
   if (loadingDecoder && idx != loadingDecoder->getDecodeSignal())
   {
+    stopReverseStaging();
+
     bool resetDecoder = false;
     loadingDecoder->setDecodeSignal(idx, resetDecoder);
     cachingDecoder->setDecodeSignal(idx, resetDecoder);
@@ -1018,6 +1257,9 @@ void playlistItemCompressedVideo::displaySignalComboBoxChanged(int idx)
       currentFrameIdx[0] = -1;
       currentFrameIdx[1] = -1;
     }
+    // The kept frames show the previous signal (unless all signals are kept)
+    if (!loadingDecoder->decodesAllSignals())
+      decodedFrameRing.clear();
 
     // A different display signal was chosen. Invalidate the cache and signal that we will need a redraw.
     videoHandlerYUV *yuvVideo = dynamic_cast<videoHandlerYUV*>(video.data());
@@ -1046,6 +1288,7 @@ void playlistItemCompressedVideo::decoderComboxBoxChanged(int idx)
     // Reset the decoded frame indices so that decoding of the current frame is triggered
     currentFrameIdx[0] = -1;
     currentFrameIdx[1] = -1;
+    decodedFrameRing.clear();
 
     // Update the list of display signals
     if (loadingDecoder)
@@ -1055,6 +1298,7 @@ void playlistItemCompressedVideo::decoderComboxBoxChanged(int idx)
       ui.comboBoxDisplaySignal->addItems(loadingDecoder->getSignalNames());
       ui.comboBoxDisplaySignal->setCurrentIndex(loadingDecoder->getDecodeSignal());
     }
+    ui.checkBoxDecodeAllSignals->setEnabled(loadingDecoder && loadingDecoder->supportsSinglePassSignals());
 
     // Update the statistics list with what the new decoder can provide
     statSource.clearStatTypes();
@@ -1064,3 +1308,22 @@ void playlistItemCompressedVideo::decoderComboxBoxChanged(int idx)
     emit signalItemChanged(true, RECACHE_CLEAR);
   }
 }
+
+void playlistItemCompressedVideo::decodeAllSignalsCheckBoxToggled(bool checked)
+{
+  if (!loadingDecoder || checked == decodeAllSignals)
+    return;
+
+  stopReverseStaging();
+  decodeAllSignals = checked;
+  if (applyDecodeAllSignals())
+  {
+    // Reset the decoded frame indices so that decoding of the current frame is triggered
+    currentFrameIdx[0] = -1;
+    currentFrameIdx[1] = -1;
+  }
+  // The kept frames only contain the display signal
+  decodedFrameRing.clear();
+
+  emit signalItemChanged(true, RECACHE_NONE);
+}
@@ -32,11 +32,16 @@
 
 #pragma once
 
+#include <QFuture>
+#include <atomic>
+
 #include "decoder/decoderBase.h"
+#include "decoder/DecoderPool.h"
 #include "filesource/FileSourceFFmpegFile.h"
 #include "parser/parserAnnexB.h"
 #include "playlistItemWithVideo.h"
 #include "statistics/statisticHandler.h"
+#include "video/DecodedFrameRing.h"
 #include "ui_playlistItemCompressedFile.h"
 
 class videoHandler;
@@ -58,6 +63,7 @@ public:
   * 'displayComponent' initializes the component to display (reconstruction/prediction/residual/trCoeff).
   */
   playlistItemCompressedVideo(const QString &fileName, int displayComponent=0, YUView::inputFormat input = YUView::inputInvalid, YUView::decoderEngine decoder = YUView::decoderEngineInvalid);
+  virtual ~playlistItemCompressedVideo();
 
   // Save the compressed file element to the given XML structure.
   virtual void savePlaylist(QDomElement &root, const QDir &playlistDir) const Q_DECL_OVERRIDE;
@@ -74,6 +80,8 @@ public:
 
   // Draw the compressed item using the given painter and zoom factor.
   virtual void drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) Q_DECL_OVERRIDE;
+  // Draw the loaded frame and its statistics. If drawItem would show an info text instead, false is returned.
+  virtual bool drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) Q_DECL_OVERRIDE;
 
   // Return the source (YUV and statistics) values under the given pixel position.
   virtual ValuePairListSets getPixelValues(const QPoint &pixelPos, int frameIdx) Q_DECL_OVERRIDE;
@@ -87,7 +95,10 @@ public:
   // ----- Detection of source/file change events -----
   virtual bool isSourceChanged()        Q_DECL_OVERRIDE { /* TODO */ return false; }
   virtual void reloadItemSource()       Q_DECL_OVERRIDE;
-  virtual void updateSettings()         Q_DECL_OVERRIDE { /* TODO loadingDecoder->updateFileWatchSetting(); statSource.updateSettings(); */ }
+  virtual void updateSettings()         Q_DECL_OVERRIDE;
+
+  // During reverse playback, the GOP before the current one is decoded in the background
+  virtual void setPlaybackReverse(bool reverse) Q_DECL_OVERRIDE;
 
   // Do we need to load the given frame first?
   virtual itemLoadingState needsLoading(int frameIdx, bool loadRawData) Q_DECL_OVERRIDE;
@@ -106,6 +117,7 @@ public:
   virtual int cachingThreadLimit() Q_DECL_OVERRIDE { return 1; }
 
   YUView::inputFormat getInputFormat() const { return inputFormatType; }
+  YUView::decoderEngine getDecoderEngine() const { return decoderEngineType; }
   
 protected:
   // Override from playlistItemIndexed. The readerEngine can tell us how many frames there are in the sequence.
@@ -115,8 +127,9 @@ protected:
 
   // We allocate two decoder: One for loading images in the foreground and one for caching in the background.
   // This is better if random access and linear decoding (caching) is performed at the same time.
-  QScopedPointer<decoderBase> loadingDecoder;
-  QScopedPointer<decoderBase> cachingDecoder;
+  // The decoders are returned to the DecoderPool when they are not used anymore
+  QScopedPointer<decoderBase, DecoderPool::Releaser> loadingDecoder;
+  QScopedPointer<decoderBase, DecoderPool::Releaser> cachingDecoder;
 
   // When opening the file, we will fill this list with the possible decoders
   QList<YUView::decoderEngine> possibleDecoders;
@@ -161,6 +174,36 @@ protected:
   // The current frame index of the decoders (interactive/caching)
   int currentFrameIdx[2] {-1, -1};
 
+  // Frames recently decoded by the interactive decoder. Stepping backwards is served from here
+  // instead of seeking to the previous random access point and decoding the GOP again.
+  DecodedFrameRing decodedFrameRing;
+
+  // Export all signals and the statistics in one decoding pass and keep them per frame in the decodedFrameRing.
+  // Switching the display signal or showing statistics is then a lookup instead of a decoder reset.
+  bool decodeAllSignals {false};
+  // Apply decodeAllSignals to the loading decoder. Returns true if the decoder was reset.
+  // The caching decoder only decodes all signals while it stages frames for reverse playback. Caching
+  // does not keep the other signals, so exporting them would only cost time.
+  bool applyDecodeAllSignals();
+  // Switch the caching decoder to/from decoding all signals. Must be called with the cachingMutex locked.
+  void setCachingDecoderAllSignals(bool allSignals);
+  // Put all other signals and the statistics of the current frame of the decoder into the ring
+  void storeAllSignalsInRing(decoderBase *dec, int frameIdxInternal);
+
+  // Decode the given frame with the interactive/caching decoder (seeking if necessary).
+  // If stageOnly is set, the decoded frames are only put into the decodedFrameRing.
+  void decodeRawData(int frameIdxInternal, bool caching, bool stageOnly=false);
+
+  // Reverse playback: While the current GOP is played backwards, the previous GOP is decoded forward by the
+  // caching decoder in the background and staged in the decodedFrameRing.
+  void startReverseStaging(int frameIdxInternal);
+  void stageFramesForReversePlayback(int lastFrameIdx);
+  void stopReverseStaging();
+  int getClosestSeekableFrameBefore(int frameIdxInternal);
+  QFuture<void> reverseStagingFuture;
+  QMutex reverseStagingMutex;  //< Guards reverseStagingFuture (it is started in the loading thread and stopped in the GUI thread)
+  std::atomic<bool> cancelReverseStaging {false};
+
   // Seek the input file to the given position, reset the decoder and prepare it to start decoding from the given position.
   void seekToPosition(int seekToFrame, int seekToDTS, bool caching);
 
@@ -187,4 +230,5 @@ private slots:
   void updateStatSource(bool bRedraw) { emit signalItemChanged(bRedraw, RECACHE_NONE); }
   void displaySignalComboBoxChanged(int idx);
   void decoderComboxBoxChanged(int idx);
+  void decodeAllSignalsCheckBoxToggled(bool checked);
 };
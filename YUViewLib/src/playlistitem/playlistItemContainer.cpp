@@ -266,6 +266,25 @@ void playlistItemContainer::updateSettings()
   }
 }
 
+void playlistItemContainer::setPlaybackReverse(bool reverse)
+{
+  playlistItem::setPlaybackReverse(reverse);
+  for (int i = 0; i < childCount(); i++)
+  {
+    playlistItem *childItem = getChildPlaylistItem(i);
+    childItem->setPlaybackReverse(reverse);
+  }
+}
+
+void playlistItemContainer::setNrPyramidLevelsToBuild(int nrLevels, bool playing)
+{
+  for (int i = 0; i < childCount(); i++)
+  {
+    playlistItem *childItem = getChildPlaylistItem(i);
+    childItem->setNrPyramidLevelsToBuild(nrLevels, playing);
+  }
+}
+
 playlistItem *playlistItemContainer::getChildPlaylistItem(int index) const
 {
   if (index < 0 || index > childCount())
@@ -62,6 +62,10 @@ public:
   virtual void reloadItemSource()       Q_DECL_OVERRIDE;  // Reload all child items
   virtual void updateSettings()         Q_DECL_OVERRIDE;  // Install/remove the file watchers.
 
+  // Forward the playback direction to all child items
+  virtual void setPlaybackReverse(bool reverse) Q_DECL_OVERRIDE;
+  virtual void setNrPyramidLevelsToBuild(int nrLevels, bool playing) Q_DECL_OVERRIDE;
+
     // Return a list containing this item and all child items (if any).
   QList<playlistItem*> getAllChildPlaylistItems() const;
 
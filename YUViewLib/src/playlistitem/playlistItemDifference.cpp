@@ -58,6 +58,7 @@ playlistItemDifference::playlistItemDifference()
   frameLimitsMax = false;
   isDifferenceLoading = false;
   isDifferenceLoadingToDoubleBuffer = false;
+  cachingEnabled = true;
 
   // The text that is shown when no difference can be drawn
   infoText = DIFFERENCE_INFO_TEXT;
@@ -234,9 +235,9 @@ void playlistItemDifference::loadFrame(int frameIdx, bool playing, bool loadRawD
   
   if (playing && (state == LoadingNeeded || state == LoadingNeededDoubleBuffer))
   {
-    // Load the next frame into the double buffer
-    int nextFrameIdx = frameIdxInternal + 1;
-    if (nextFrameIdx <= startEndFrame.second)
+    // Load the next frame into the double buffer (the previous one if playback runs backwards)
+    int nextFrameIdx = frameIdxInternal + (playbackReverse ? -1 : 1);
+    if (nextFrameIdx >= startEndFrame.first && nextFrameIdx <= startEndFrame.second)
     {
       DEBUG_DIFF("playlistItemDifference::loadFrame loading difference into double buffer %d %s", nextFrameIdx, playing ? "(playing)" : "");
       isDifferenceLoadingToDoubleBuffer = true;
@@ -251,10 +252,52 @@ void playlistItemDifference::loadFrame(int frameIdx, bool playing, bool loadRawD
   }
 }
 
+bool playlistItemDifference::isCachable() const
+{
+  if (!playlistItem::isCachable() || childCount() != 2 || !difference.inputsValid())
+    return false;
+
+  // The children load their raw data for every difference that is cached. This is only done in parallel
+  // if the children can be cached by any number of threads (e.g. a decoder can only be used by one thread).
+  for (int i = 0; i < 2; i++)
+  {
+    playlistItem *child = getChildPlaylistItem(i);
+    if (dynamic_cast<videoHandler*>(child->getFrameHandler()) == nullptr)
+      continue;
+    if (!child->isCachable() || child->cachingThreadLimit() != -1)
+      return false;
+  }
+  return true;
+}
+
+void playlistItemDifference::cacheFrame(int frameIdx, bool testMode)
+{
+  if (!isCachable())
+    return;
+
+  // Since every playlist item can have it's own relative indexing, we need two frame indices
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  const int idx0 = getChildPlaylistItem(0)->getFrameIdxInternal(frameIdxInternal);
+  const int idx1 = getChildPlaylistItem(1)->getFrameIdxInternal(frameIdxInternal);
+  difference.cacheDifferenceFrame(frameIdxInternal, idx0, idx1, testMode);
+}
+
+QList<int> playlistItemDifference::getCachedFrames() const
+{
+  // Convert indices from internal to external indices
+  QList<int> retList;
+  for (int i : difference.getCachedFrames())
+    retList.append(getFrameIdxExternal(i));
+  return retList;
+}
+
 void playlistItemDifference::childChanged(bool redraw, recacheIndicator recache)
 {
-  // One of the child items changed and needs to redraw. This means that the difference is out of date
-  // and has to be recalculated.
-  difference.invalidateAllBuffers();
-  playlistItemContainer::childChanged(redraw, recache);
+  // One of the child items changed and needs to redraw. This means that the current difference is out of date
+  // and has to be recalculated. If the cache of the child is cleared, all cached differences are invalid as well.
+  const bool onlyCurrentFrame = (recache == RECACHE_NONE);
+  difference.invalidateDifference(onlyCurrentFrame);
+  // The cache of the difference is invalid now (e.g. also if a child only changed its start/end frame and sent a
+  // RECACHE_UPDATE). Only a RECACHE_CLEAR clears the cached differences and makes the cache valid again.
+  playlistItemContainer::childChanged(redraw, onlyCurrentFrame ? RECACHE_NONE : RECACHE_CLEAR);
 }
\ No newline at end of file
@@ -59,6 +59,17 @@ public:
   virtual void loadFrame(int frameIdx, bool playing, bool loadRawData, bool emitSignals=true) Q_DECL_OVERRIDE;
   virtual bool isLoading() const Q_DECL_OVERRIDE { return isDifferenceLoading; }
   virtual bool isLoadingDoubleBuffer() const Q_DECL_OVERRIDE { return isDifferenceLoadingToDoubleBuffer; }
+  virtual void setPlaybackReverse(bool reverse) Q_DECL_OVERRIDE { playlistItemContainer::setPlaybackReverse(reverse); difference.setPlaybackReverse(reverse); }
+  virtual void setNrPyramidLevelsToBuild(int nrLevels, bool playing) Q_DECL_OVERRIDE { playlistItemContainer::setNrPyramidLevelsToBuild(nrLevels, playing); difference.setNrPyramidLevelsToBuild(nrLevels, playing); }
+
+  // Overloads from playlistItem. The differences are calculated and cached by the caching threads.
+  virtual bool isCachable() const Q_DECL_OVERRIDE;
+  virtual void cacheFrame(int frameIdx, bool testMode) Q_DECL_OVERRIDE;
+  virtual QList<int> getCachedFrames() const Q_DECL_OVERRIDE;
+  virtual int getNumberCachedFrames() const Q_DECL_OVERRIDE { return difference.getNumberCachedFrames(); }
+  virtual unsigned int getCachingFrameSize() const Q_DECL_OVERRIDE { return difference.getCachingFrameSize(); }
+  virtual void removeFrameFromCache(int frameIdx) Q_DECL_OVERRIDE { difference.removeFrameFromCache(getFrameIdxInternal(frameIdx)); }
+  virtual void removeAllFramesFromCache() Q_DECL_OVERRIDE { difference.removeAllFrameFromCache(); }
     
   // Overload from playlistItem. Save the playlist item to playlist.
   virtual void savePlaylist(QDomElement &root, const QDir &playlistDir) const Q_DECL_OVERRIDE;
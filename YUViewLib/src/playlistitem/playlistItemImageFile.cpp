@@ -120,6 +120,14 @@ playlistItemImageFile *playlistItemImageFile::newplaylistItemImageFile(const YUV
   return newImage;
 }
 
+bool playlistItemImageFile::drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData)
+{
+  if (needToLoadImage || imageLoading)
+    return false;
+  drawItem(painter, frameIdx, zoomFactor, drawRawData);
+  return true;
+}
+
 void playlistItemImageFile::drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData)
 {
   Q_UNUSED(frameIdx);
@@ -66,6 +66,8 @@ public:
   // Draw the text item. Since isIndexedByFrame() returned false, this item is not indexed by frames
   // and the given value of frameIdx will be ignored.
   virtual void drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) Q_DECL_OVERRIDE;
+  // The image is the same in every frame
+  virtual bool drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) Q_DECL_OVERRIDE;
 
   // Do we need to load the given frame first?
   virtual itemLoadingState needsLoading(int frameIdx, bool loadRawValues) Q_DECL_OVERRIDE { Q_UNUSED(frameIdx); Q_UNUSED(loadRawValues); return needToLoadImage ? LoadingNeeded : LoadingNotNeeded; }
@@ -36,10 +36,11 @@
 #include <QSettings>
 #include <QUrl>
 
+#include "common/FrameProfiler.h"
 #include "common/functions.h"
 #include "filesource/FileSource.h"
 
-playlistItemImageFileSequence::playlistItemImageFileSequence(const QString &rawFilePath)
+playlistItemImageFileSequence::playlistItemImageFileSequence(const QString &rawFilePath, const QStringList &sequenceFiles)
   : playlistItemWithVideo(rawFilePath, playlistItem_Indexed)
 {
   // Set the properties of the playlistItem
@@ -61,7 +62,10 @@ playlistItemImageFileSequence::playlistItemImageFileSequence(const QString &rawF
   if (!rawFilePath.isEmpty())
   {
     // Get the frames to use as a sequence
-    fillImageFileList(imageFiles, rawFilePath);
+    if (sequenceFiles.isEmpty())
+      fillImageFileList(imageFiles, rawFilePath);
+    else
+      imageFiles = sequenceFiles;
 
     setInternals(rawFilePath);
   }
@@ -75,68 +79,21 @@ playlistItemImageFileSequence::playlistItemImageFileSequence(const QString &rawF
   updateSettings();
 }
 
-bool playlistItemImageFileSequence::isImageSequence(const QString &filePath)
+bool playlistItemImageFileSequence::isImageSequence(const QString &filePath, QStringList *sequenceFiles)
 {
   QStringList files;
   fillImageFileList(files, filePath);
+  if (sequenceFiles)
+    *sequenceFiles = files;
   return files.count() > 1;
 }
 
 void playlistItemImageFileSequence::fillImageFileList(QStringList &imageFiles, const QString &filePath)
 {
-  // See if the filename ends with a number
+  // List all files in the directory and get all that belong to the sequence.
   QFileInfo fi(filePath);
-  QString fileName = fi.fileName();
-  QString base = fi.baseName();
-
-  int lastN = 0;
-  for (int i = base.count() - 1; i >= 0; i--)
-  {
-    // Get the char and see if it is a number
-    if (base[i].isDigit())
-      lastN++;
-    else
-      break;
-  }
-
-  if (lastN == 0)
-  {
-    // No number at the end of the file name
-    imageFiles.append(filePath);
-    return;
-  }
-
-  // The base name without the indexing number at the end
-  QString absBaseName = base.left(base.count() - lastN);
-
-  // List all files in the directory and get all that have the same pattern.
   QDir currentDir(fi.path());
-  const QFileInfoList fileList = currentDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
-  QMap<int, QString> unsortedFiles;
-  for (auto &file : fileList)
-  {
-    if (file.baseName().startsWith(absBaseName) && file.suffix() == fi.suffix())
-    {
-      // Check if the remaining part is all digits
-      QString remainder = file.baseName().right(file.baseName().length() - absBaseName.length());
-      bool isNumber;
-      int num = remainder.toInt(&isNumber);
-      if (isNumber)
-        unsortedFiles.insert(num, file.absoluteFilePath());
-    }
-  }
-
-  int count = unsortedFiles.count();
-  int i = 0;
-  while(count > 0 && i < INT_MAX)
-  {
-    if (unsortedFiles.contains(i))
-    {
-      imageFiles.append(unsortedFiles[i]);
-      count--;
-    }
-    i++;
-  }
+  imageFiles.append(functions::getNumberedFileSequence(filePath, currentDir.entryList(QDir::Files | QDir::NoDotAndDotDot)));
 }
 
 void playlistItemImageFileSequence::createPropertiesWidget()
@@ -265,16 +222,51 @@ void playlistItemImageFileSequence::slotFrameRequest(int frameIdxInternal, bool
 {
   Q_UNUSED(caching);
 
+  // Load the given frame
+  const QImage image = loadImageFile(frameIdxInternal);
+  if (image.isNull())
+    return;
+
+  video->requestedFrame = image;
+  video->requestedFrame_idx = frameIdxInternal;
+}
+
+QImage playlistItemImageFileSequence::loadImageFile(int frameIdxInternal) const
+{
   // Does the index/file exist?
   if (frameIdxInternal < 0 || frameIdxInternal >= imageFiles.count())
+    return QImage();
+
+  FRAME_PROFILER_SCOPE("Read image file", frameIdxInternal);
+  QImageReader reader(imageFiles[frameIdxInternal]);
+  QImage image = reader.read();
+
+  // Convert images with more than 8 bit per component (or other special formats) here, in the loading thread.
+  // Otherwise, this would be done every time the frame is drawn.
+  const auto format = image.format();
+  if (!image.isNull() && format != QImage::Format_RGB32 && format != QImage::Format_ARGB32 && format != QImage::Format_ARGB32_Premultiplied)
+    image = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : functions::platformImageFormat());
+
+  return image;
+}
+
+void playlistItemImageFileSequence::cacheFrame(int frameIdx, bool testMode)
+{
+  if (!cachingEnabled || unresolvableError)
     return;
-  QFileInfo fileInfo(imageFiles[frameIdxInternal]);
-  if (!fileInfo.exists() || !fileInfo.isFile())
+
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  if (video->isInCache(frameIdxInternal) && !testMode)
     return;
-  
-  // Load the given frame
-  video->requestedFrame = QImage(imageFiles[frameIdxInternal]);
-  video->requestedFrame_idx = frameIdxInternal;
+
+  // Unlike videoHandler::cacheFrame (which requests the frame through slotFrameRequest while holding the
+  // lock of the video handler), the files are read and decoded in all caching threads at the same time.
+  const QImage image = loadImageFile(frameIdxInternal);
+  if (image.isNull() || image.size() != video->getFrameSize())
+    // Loading failed or the image does not have the size of the sequence. The frame is loaded when it is shown.
+    return;
+
+  video->insertFrameIntoCache(frameIdxInternal, image, testMode);
 }
 
 void playlistItemImageFileSequence::setInternals(const QString &filePath)
@@ -283,11 +275,15 @@ void playlistItemImageFileSequence::setInternals(const QString &filePath)
   if (startEndFrame == indexRange(-1,-1))
     startEndFrame = getStartEndFrameLimits();
 
-  // Open frame 0 and set the size of it
-  QImage frame0 = QImage(imageFiles[0]);
-  video->setFrameSize(frame0.size());
+  // Get the size of frame 0. Most image formats have the size in the header so the image does not have to be decoded.
+  QImageReader reader(imageFiles[0]);
+  QSize frameSize = reader.size();
+  if (!frameSize.isValid())
+    frameSize = reader.read().size();
+  video->setFrameSize(frameSize);
 
-  cachingEnabled = false;  
+  // The image files are decoded in the caching threads (see cacheFrame)
+  cachingEnabled = true;
 
   // Set the internal name
   QFileInfo fi(filePath);
@@ -311,6 +307,9 @@ void playlistItemImageFileSequence::reloadItemSource()
 {
   // Clear the video's buffers. The video will ask to reload the images.
   video->invalidateAllBuffers();
+
+  // Emit that the item needs redrawing and the cache must be cleared.
+  emit signalItemChanged(true, RECACHE_CLEAR);
 }
 
 void playlistItemImageFileSequence::updateSettings()
@@ -38,12 +38,16 @@
 #include "playlistItemRawFile.h"
 #include "video/videoHandler.h"
 
+// How many frames are read ahead of playback by the caching threads
+#define IMAGE_SEQUENCE_READ_AHEAD_FRAMES 16
+
 class playlistItemImageFileSequence : public playlistItemWithVideo
 {
   Q_OBJECT
 
 public:
-  playlistItemImageFileSequence(const QString &rawFilePath = QString());
+  // If the list of files in the sequence is already known (from isImageSequence), it is not listed again.
+  playlistItemImageFileSequence(const QString &rawFilePath = QString(), const QStringList &sequenceFiles = QStringList());
 
   // Overload from playlistItem. Save the raw file item to playlist.
   virtual void savePlaylist(QDomElement &root, const QDir &playlistDir) const Q_DECL_OVERRIDE;
@@ -68,7 +72,8 @@ public:
 
   // Check if this is just one image, or if there is a pattern in the file name. E.g:
   // image000.png, image001.png ...
-  static bool isImageSequence(const QString &filePath);
+  // If sequenceFiles is given, the sorted list of files of the sequence is returned in there.
+  static bool isImageSequence(const QString &filePath, QStringList *sequenceFiles = nullptr);
 
   // ----- Detection of source/file change events -----
   virtual bool isSourceChanged()        Q_DECL_OVERRIDE { bool b = fileChanged; fileChanged = false; return b; }
@@ -78,6 +83,11 @@ public:
   // Is an image currently being loaded?
   virtual bool isLoading() const Q_DECL_OVERRIDE { return isFrameLoading; }
 
+  // Decode the image files directly in the caching threads. This way, multiple files are decoded in parallel.
+  virtual void cacheFrame(int frameIdx, bool testMode) Q_DECL_OVERRIDE;
+  // Decoding an image file (e.g. a 16 bit TIFF) is often slower than the frame rate
+  virtual int getPlaybackReadAheadFrames() const Q_DECL_OVERRIDE { return IMAGE_SEQUENCE_READ_AHEAD_FRAMES; }
+
 private slots:
   // Load the given frame from file. This slot is called by the videoHandler if the frame that is
   // requested to be drawn has not been loaded yet.
@@ -107,8 +117,12 @@ private:
   QString internalName;
 
   // Fill the given imageFiles list with all the files that can be found for the given file.
+  // The files are sorted by the number at the end of the file name.
   static void fillImageFileList(QStringList &imageFiles, const QString &filePath);
   QStringList imageFiles;
+
+  // Read the image file of the given frame. This is thread-safe and does not touch the video handler.
+  QImage loadImageFile(int frameIdxInternal) const;
   
   // This is true if the sequence was loaded from playlist and a frame is missing
   bool loadPlaylistFrameMissing;
@@ -51,6 +51,13 @@
 
 #define CUSTOM_POS_MAX 100000
 
+// The composition layers that are kept and the maximum size of a layer (in device pixels). If the overlay is zoomed in
+// so far that the layer would be bigger, the child items are drawn directly.
+#define COMPOSITION_NR_LAYERS 2
+#define COMPOSITION_MAX_LAYER_PIXELS (3840 * 2160)
+// A margin around the layer (in device pixels) for anything the children draw slightly outside of their rect
+#define COMPOSITION_LAYER_MARGIN 4
+
 playlistItemOverlay::playlistItemOverlay() :
   playlistItemContainer("Overlay Item")
 {
@@ -163,24 +170,202 @@ void playlistItemOverlay::drawItem(QPainter *painter, int frameIdx, double zoomF
   // Update the layout if the number of items changedupdateLayout
   updateLayout();
 
+  LayerParameters parameters;
+  parameters.zoomFactor = zoomFactor;
+  parameters.devicePixelRatio = painter->device()->devicePixelRatioF();
+  parameters.drawRawData = drawRawData;
+  parameters.font = painter->font();
+  parameters.renderHints = painter->renderHints();
+
+  const QSize layerSize = getLayerSize(parameters);
+  const bool layerDrawable = canDrawLayer(painter, layerSize);
+  bool drawnAgain;
+  bool drawnFromLayer = false;
+  {
+    QMutexLocker lock(&compositionLayerAccess);
+    if (layerDrawable)
+    {
+      for (int i = 0; i < compositionLayers.count(); i++)
+      {
+        if (compositionLayers[i].frameIdx == frameIdx && compositionLayers[i].parameters == parameters)
+        {
+          DEBUG_OVERLAY("playlistItemOverlay::drawItem frame %d from composition layer", frameIdx);
+          compositionLayers.move(i, 0);
+          drawLayer(painter, compositionLayers[0].image);
+          drawnFromLayer = true;
+          break;
+        }
+      }
+    }
+    drawnAgain = (frameIdx == lastDrawnFrameIdx && parameters == lastDrawnParameters);
+    lastDrawnFrameIdx = frameIdx;
+    lastDrawnParameters = parameters;
+  }
+
+  if (drawnFromLayer)
+  {
+    // The children did not draw. Let them update their current frame (e.g. from the double buffer) as if they had.
+    for (int i = 0; i < childCount(); i++)
+      if (playlistItem *childItem = getChildPlaylistItem(i))
+        childItem->setDrawnFrame(frameIdx);
+    return;
+  }
+
+  QMutexLocker drawLock(&childDrawMutex);
+  if (layerDrawable && drawnAgain)
+  {
+    // The same frame is drawn again (e.g. the view was moved or the item is drawn in both views).
+    // Compose the children once and reuse the layer from now on.
+    unsigned int revision;
+    {
+      QMutexLocker lock(&compositionLayerAccess);
+      revision = compositionRevision;
+    }
+    const QImage layer = composeLayer(frameIdx, parameters);
+    insertCompositionLayer(frameIdx, parameters, layer, revision);
+    drawLayer(painter, layer);
+  }
+  else
+    drawChildItems(painter, frameIdx, zoomFactor, drawRawData);
+}
+
+bool playlistItemOverlay::drawChildItems(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData, bool onlyLoaded)
+{
   // Translate to the center of this overlay item
   painter->translate(centerRoundTL(boundingRect) * zoomFactor * -1);
 
   // Draw all child items at their positions
-  for (int i = 0; i < childCount(); i++)
+  bool allDrawn = true;
+  for (int i = 0; i < childCount() && allDrawn; i++)
   {
     playlistItem *childItem = getChildPlaylistItem(i);
     if (childItem)
     {
       QPoint center = centerRoundTL(childItemRects[i]);
       painter->translate(center * zoomFactor);
-      childItem->drawItem(painter, frameIdx, zoomFactor, drawRawData);
+      if (onlyLoaded)
+        allDrawn = childItem->drawLoadedItem(painter, frameIdx, zoomFactor, drawRawData);
+      else
+        childItem->drawItem(painter, frameIdx, zoomFactor, drawRawData);
       painter->translate(center * zoomFactor * -1);
     }
   }
 
   // Reverse translation to the center of this overlay item
   painter->translate(centerRoundTL(boundingRect) * zoomFactor);
+  return allDrawn;
+}
+
+bool playlistItemOverlay::LayerParameters::operator==(const LayerParameters &other) const
+{
+  return this->zoomFactor == other.zoomFactor && this->devicePixelRatio == other.devicePixelRatio &&
+         this->drawRawData == other.drawRawData && this->font == other.font && this->renderHints == other.renderHints;
+}
+
+QSize playlistItemOverlay::getLayerSize(const LayerParameters &parameters) const
+{
+  if (boundingRect.isEmpty())
+    return QSize();
+
+  // Round up to an even number of pixels so that the layer center is on a pixel border
+  const double scale = parameters.zoomFactor * parameters.devicePixelRatio;
+  const int width  = (int(std::ceil(boundingRect.width()  * scale)) + 2 * COMPOSITION_LAYER_MARGIN + 1) & ~1;
+  const int height = (int(std::ceil(boundingRect.height() * scale)) + 2 * COMPOSITION_LAYER_MARGIN + 1) & ~1;
+  if (int64_t(width) * height > COMPOSITION_MAX_LAYER_PIXELS)
+    return QSize();
+  return QSize(width, height);
+}
+
+bool playlistItemOverlay::canDrawLayer(QPainter *painter, const QSize &layerSize) const
+{
+  if (!layerSize.isValid())
+    return false;
+  if (painter->transform().type() > QTransform::TxTranslate)
+    return false;
+
+  // The top left corner of the layer must be exactly on a device pixel. Otherwise the layer would be resampled.
+  const QPointF topLeft = painter->deviceTransform().map(QPointF(0, 0)) - QPointF(layerSize.width() / 2, layerSize.height() / 2);
+  return std::abs(topLeft.x() - std::round(topLeft.x())) < 0.001 && std::abs(topLeft.y() - std::round(topLeft.y())) < 0.001;
+}
+
+void playlistItemOverlay::drawLayer(QPainter *painter, const QImage &layer) const
+{
+  // The layer is centered at (0,0) like the child items
+  const qreal dpr = layer.devicePixelRatio();
+  painter->drawImage(QPointF(-layer.width() / 2 / dpr, -layer.height() / 2 / dpr), layer);
+}
+
+QImage playlistItemOverlay::composeLayer(int frameIdx, const LayerParameters &parameters, bool onlyLoaded)
+{
+  DEBUG_OVERLAY("playlistItemOverlay::composeLayer frame %d zoom %f", frameIdx, parameters.zoomFactor);
+
+  QImage layer(getLayerSize(parameters), QImage::Format_ARGB32_Premultiplied);
+  layer.setDevicePixelRatio(parameters.devicePixelRatio);
+  layer.fill(Qt::transparent);
+
+  QPainter layerPainter(&layer);
+  layerPainter.setRenderHints(parameters.renderHints);
+  layerPainter.setFont(parameters.font);
+  layerPainter.translate(QPointF(layer.width() / 2 / parameters.devicePixelRatio, layer.height() / 2 / parameters.devicePixelRatio));
+  const bool allDrawn = drawChildItems(&layerPainter, frameIdx, parameters.zoomFactor, parameters.drawRawData, onlyLoaded);
+  layerPainter.end();
+
+  if (!allDrawn)
+    return {};
+  return layer;
+}
+
+void playlistItemOverlay::insertCompositionLayer(int frameIdx, const LayerParameters &parameters, const QImage &layer, unsigned int revision)
+{
+  QMutexLocker lock(&compositionLayerAccess);
+  if (revision != compositionRevision)
+    // The layout or a child changed while the layer was composed
+    return;
+
+  for (int i = compositionLayers.count() - 1; i >= 0; i--)
+    if (compositionLayers[i].frameIdx == frameIdx && compositionLayers[i].parameters == parameters)
+      compositionLayers.removeAt(i);
+
+  CompositionLayer newLayer;
+  newLayer.frameIdx = frameIdx;
+  newLayer.parameters = parameters;
+  newLayer.image = layer;
+  compositionLayers.prepend(newLayer);
+  while (compositionLayers.count() > COMPOSITION_NR_LAYERS)
+    compositionLayers.removeLast();
+}
+
+void playlistItemOverlay::composeLoadedFrame(int frameIdx)
+{
+  LayerParameters parameters;
+  unsigned int revision;
+  {
+    QMutexLocker lock(&compositionLayerAccess);
+    if (lastDrawnFrameIdx == -1)
+      // The item was not drawn yet. We don't know the zoom factor.
+      return;
+    parameters = lastDrawnParameters;
+    revision = compositionRevision;
+    for (const CompositionLayer &l : compositionLayers)
+      if (l.frameIdx == frameIdx && l.parameters == parameters)
+        return;
+  }
+
+  // Only draw what the children already loaded. Drawing them normally would change their current frame (e.g. swap
+  // the double buffer) before the frame is shown.
+  QMutexLocker drawLock(&childDrawMutex);
+  if (!getLayerSize(parameters).isValid())
+    return;
+  const QImage layer = composeLayer(frameIdx, parameters, true);
+  if (!layer.isNull())
+    insertCompositionLayer(frameIdx, parameters, layer, revision);
+}
+
+void playlistItemOverlay::clearCompositionLayers()
+{
+  QMutexLocker lock(&compositionLayerAccess);
+  compositionLayers.clear();
+  compositionRevision++;
 }
 
 QSize playlistItemOverlay::getSize() const
@@ -193,8 +378,12 @@ QSize playlistItemOverlay::getSize() const
 
 void playlistItemOverlay::updateLayout(bool onlyIfItemsChanged)
 {
+  // The layout must not change while the children are composed in the loading thread
+  QMutexLocker drawLock(&childDrawMutex);
+
   if (childCount() == 0)
   {
+    clearCompositionLayers();
     childItemRects.clear();
     childItemsIDs.clear();
     boundingRect = QRect();
@@ -220,6 +409,9 @@ void playlistItemOverlay::updateLayout(bool onlyIfItemsChanged)
   if (onlyIfItemsChanged && !nrItemsChanged && !itemOrderChanged)
     return;
 
+  // The composed layers were drawn with the old layout or old child items
+  clearCompositionLayers();
+
   DEBUG_OVERLAY("playlistItemOverlay::updateLayout%s", onlyIfNrItemsChanged ? " onlyIfNrItemsChanged" : "");
 
   if (nrItemsChanged || itemOrderChanged)
@@ -526,6 +718,8 @@ void playlistItemOverlay::childChanged(bool redraw, recacheIndicator recache)
 {
   if (redraw)
     updateLayout(false);
+  else if (recache != RECACHE_NONE)
+    clearCompositionLayers();
 
   playlistItemContainer::childChanged(redraw, recache);
 }
@@ -591,6 +785,13 @@ void playlistItemOverlay::loadFrame(int frameIdx, bool playing, bool loadRawData
       itemLoadedDoubleBuffer = true;
   }
 
+  // The children are ready to draw this frame (and the next one from the double buffer) now. Compose them here so
+  // that the GUI thread only has to draw the finished layer. The children only draw what they already loaded.
+  if (itemLoaded)
+    composeLoadedFrame(frameIdx);
+  if (itemLoadedDoubleBuffer)
+    composeLoadedFrame(frameIdx + (playbackReverse ? -1 : 1));
+
   if (emitSignals && itemLoaded)
     emit signalItemChanged(true, RECACHE_NONE);
   if (emitSignals && itemLoadedDoubleBuffer)
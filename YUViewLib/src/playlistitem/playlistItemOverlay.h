@@ -37,6 +37,9 @@
 #include "ui_playlistItemOverlay.h"
 
 #include <QGridLayout>
+#include <QImage>
+#include <QMutex>
+#include <QPainter>
 
 class playlistItemOverlay : public playlistItemContainer
 {
@@ -110,6 +113,51 @@ private:
   int arangementMode {0};
   QMap<int, QPoint> customPositions;
 
+  // Draw all child items at their position in the layout. If onlyLoaded is set, the children are drawn with
+  // drawLoadedItem and false is returned if one of them could not be drawn.
+  bool drawChildItems(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData, bool onlyLoaded = false);
+
+  // --- Composition cache
+  // Drawing all children (e.g. a video and several statistics) on every paint is expensive. The children can be
+  // composed into a layer image that is reused as long as the frame, the zoom factor and the layout do not change
+  // (e.g. if only the view is moved, the split line is moved or the item is drawn in both views).
+  // During playback, the layer of the next frame is composed in the loading thread right after the children loaded it.
+  // The GUI thread then only draws the finished layer.
+  struct LayerParameters
+  {
+    bool operator==(const LayerParameters &other) const;
+    double zoomFactor {0.0};
+    qreal devicePixelRatio {1.0};
+    bool drawRawData {false};
+    QFont font;
+    QPainter::RenderHints renderHints;
+  };
+  struct CompositionLayer
+  {
+    int frameIdx {-1};
+    LayerParameters parameters;
+    QImage image;
+  };
+  // The size of the layer image in device pixels. Invalid if the layer would be too big.
+  QSize getLayerSize(const LayerParameters &parameters) const;
+  // Can the layer be drawn with the given painter without resampling it?
+  bool canDrawLayer(QPainter *painter, const QSize &layerSize) const;
+  void drawLayer(QPainter *painter, const QImage &layer) const;
+  // Returns a null image if onlyLoaded is set and not all children have the frame loaded
+  QImage composeLayer(int frameIdx, const LayerParameters &parameters, bool onlyLoaded = false);
+  void insertCompositionLayer(int frameIdx, const LayerParameters &parameters, const QImage &layer, unsigned int revision);
+  void clearCompositionLayers();
+  // Compose the layer for the given frame from the data that the children loaded (called from the loading thread)
+  void composeLoadedFrame(int frameIdx);
+
+  QList<CompositionLayer> compositionLayers;  //< The most recently used layer first
+  unsigned int compositionRevision {0};       //< Incremented when the layers are cleared
+  // The frame index and parameters of the last drawItem call. Loaded frames are composed using these.
+  int lastDrawnFrameIdx {-1};
+  LayerParameters lastDrawnParameters;
+  QMutex compositionLayerAccess;  //< Guards the layers, the revision and the last drawn frame and parameters
+  QMutex childDrawMutex;          //< Only one thread can draw the child items at a time. Also guards the layout.
+
 private slots:
   void slotControlChanged();
   void childChanged(bool redraw, recacheIndicator recache) Q_DECL_OVERRIDE;
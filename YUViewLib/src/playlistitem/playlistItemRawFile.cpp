@@ -36,6 +36,7 @@
 #include <QUrl>
 #include <QVBoxLayout>
 
+#include "common/FrameProfiler.h"
 #include "common/functions.h"
 #include "handler/itemMemoryHandler.h"
 
@@ -469,6 +470,8 @@ void playlistItemRawFile::loadRawData(int frameIdxInternal)
   if (!video->isFormatValid())
     return;
 
+  FRAME_PROFILER_SCOPE("Read file", frameIdxInternal);
+
   // Load the raw data for the given frameIdx from file and set it in the video
   int64_t fileStartPos;
   if (isY4MFile)
@@ -528,5 +531,5 @@ void playlistItemRawFile::reloadItemSource()
   video->invalidateAllBuffers();
 
   // Emit that the item needs redrawing and the cache changed.
-  emit signalItemChanged(true, RECACHE_NONE);
+  emit signalItemChanged(true, RECACHE_CLEAR);
 }
@@ -115,6 +115,17 @@ void playlistItemStatisticsFile::drawItem(QPainter *painter, int frameIdx, doubl
   currentDrawnFrameIdx = frameIdxInternal;
 }
 
+bool playlistItemStatisticsFile::drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData)
+{
+  Q_UNUSED(drawRawData);
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  if (statSource.needsLoading(frameIdxInternal) != LoadingNotNeeded)
+    return false;
+
+  statSource.paintStatistics(painter, frameIdxInternal, zoomFactor);
+  return true;
+}
+
 // This timer event is called regularly when the background loading process is running.
 // It will update
 void playlistItemStatisticsFile::timerEvent(QTimerEvent *event)
@@ -63,6 +63,8 @@ public:
   virtual QString getPropertiesTitle() const Q_DECL_OVERRIDE { return "Statistics File Properties"; }
 
   virtual void drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) Q_DECL_OVERRIDE;
+  virtual bool drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) Q_DECL_OVERRIDE;
+  virtual void setDrawnFrame(int frameIdx) Q_DECL_OVERRIDE { currentDrawnFrameIdx = getFrameIdxInternal(frameIdx); }
 
   // ------ Statistics ----
 
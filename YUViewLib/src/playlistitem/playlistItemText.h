@@ -63,6 +63,8 @@ public:
   // Draw the text item. Since isIndexedByFrame() returned false, this item is not indexed by frames
   // and the given value of frameIdx will be ignored.
   virtual void drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) Q_DECL_OVERRIDE;
+  // The item looks the same in every frame
+  virtual bool drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawData) Q_DECL_OVERRIDE { drawItem(painter, frameIdx, zoomFactor, drawRawData); return true; }
   
 protected:
   // Overload from playlistItem. Create a properties widget custom to the text item
@@ -73,6 +73,33 @@ void playlistItemWithVideo::drawItem(QPainter *painter, int frameIdx, double zoo
     video->drawFrame(painter, frameIdxInternal, zoomFactor, drawRawValues);
 }
 
+bool playlistItemWithVideo::drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues)
+{
+  if (unresolvableError)
+    return false;
+  // The pixel values are drawn from the raw data of the current frame
+  if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
+    return false;
+
+  indexRange range = getStartEndFrameLimits();
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  if (frameIdxInternal < range.first || frameIdxInternal > range.second)
+    // Nothing is drawn for this frame
+    return true;
+  return video->drawLoadedFrame(painter, frameIdxInternal, zoomFactor);
+}
+
+void playlistItemWithVideo::setDrawnFrame(int frameIdx)
+{
+  if (unresolvableError)
+    return;
+
+  indexRange range = getStartEndFrameLimits();
+  const int frameIdxInternal = getFrameIdxInternal(frameIdx);
+  if (frameIdxInternal >= range.first && frameIdxInternal <= range.second)
+    video->updateCurrentImage(frameIdxInternal);
+}
+
 void playlistItemWithVideo::loadFrame(int frameIdx, bool playing, bool loadRawData, bool emitSignals)
 {
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
@@ -91,9 +118,9 @@ void playlistItemWithVideo::loadFrame(int frameIdx, bool playing, bool loadRawDa
   
   if (playing && (state == LoadingNeeded || state == LoadingNeededDoubleBuffer))
   {
-    // Load the next frame into the double buffer
-    int nextFrameIdx = frameIdxInternal + 1;
-    if (nextFrameIdx <= startEndFrame.second)
+    // Load the next frame into the double buffer (the previous one if playback runs backwards)
+    int nextFrameIdx = frameIdxInternal + (playbackReverse ? -1 : 1);
+    if (nextFrameIdx >= startEndFrame.first && nextFrameIdx <= startEndFrame.second)
     {
       DEBUG_PLVIDEO("playlistItemWithVideo::loadFrame loading frame into double buffer %d%s%s", nextFrameIdx, playing ? " playing" : "", loadRawData ? " raw" : "");
       isFrameLoadingDoubleBuffer = true;
@@ -105,6 +132,13 @@ void playlistItemWithVideo::loadFrame(int frameIdx, bool playing, bool loadRawDa
   }
 }
 
+void playlistItemWithVideo::setPlaybackReverse(bool reverse)
+{
+  playlistItem::setPlaybackReverse(reverse);
+  if (video)
+    video->setPlaybackReverse(reverse);
+}
+
 itemLoadingState playlistItemWithVideo::needsLoading(int frameIdx, bool loadRawValues)
 {
   const int frameIdxInternal = getFrameIdxInternal(frameIdx);
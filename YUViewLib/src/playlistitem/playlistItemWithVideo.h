@@ -47,12 +47,16 @@ public:
 
   // Draw the item
   virtual void drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues) Q_DECL_OVERRIDE;
+  virtual bool drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues) Q_DECL_OVERRIDE;
+  virtual void setDrawnFrame(int frameIdx) Q_DECL_OVERRIDE;
 
   // All the functions that we have to overload if we are using a video handler
   virtual QSize getSize() const Q_DECL_OVERRIDE { return (video) ? video->getFrameSize() : QSize(); }
   virtual frameHandler *getFrameHandler() Q_DECL_OVERRIDE { return video.data(); }
   // Activate the double buffer (set it as current frame)
   virtual void activateDoubleBuffer() Q_DECL_OVERRIDE { if (video) video->activateDoubleBuffer(); }
+  virtual void setPlaybackReverse(bool reverse) Q_DECL_OVERRIDE;
+  virtual void setNrPyramidLevelsToBuild(int nrLevels, bool playing) Q_DECL_OVERRIDE { if (video) video->setNrPyramidLevelsToBuild(nrLevels, playing); }
 
   // Do we need to load the frame first?
   virtual itemLoadingState needsLoading(int frameIdx, bool loadRawValues) Q_DECL_OVERRIDE;
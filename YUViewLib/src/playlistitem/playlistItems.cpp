@@ -131,7 +131,8 @@ namespace playlistItems
       {
         // This is definitely an image file. But could it also be an image file sequence?
         bool openAsImageSequence = false;
-        if (playlistItemImageFileSequence::isImageSequence(fileName))
+        QStringList sequenceFiles;
+        if (playlistItemImageFileSequence::isImageSequence(fileName, &sequenceFiles))
         {
           // This is not only one image, but a sequence of images. Ask the user how to open it.
           QMessageBox::StandardButton choice = QMessageBox::question(parent, "Open image sequence", "This image can be opened as an image sequence. Do you want to open it as an image sequence (Yes) or as a single static image (No)?\n", QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel, QMessageBox::Yes);
@@ -146,7 +147,7 @@ namespace playlistItems
         if (openAsImageSequence)
         {
           // Open it as a file sequence
-          playlistItemImageFileSequence *newSequence = new playlistItemImageFileSequence(fileName);
+          playlistItemImageFileSequence *newSequence = new playlistItemImageFileSequence(fileName, sequenceFiles);
           return newSequence;
         }
         else
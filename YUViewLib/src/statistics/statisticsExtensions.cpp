@@ -391,6 +391,17 @@ void statisticsData::addPolygonVector(const QVector<QPoint> &points, int vecX, i
   polygonVectorData.append(vec);
 }
 
+void statisticsData::append(const statisticsData &other)
+{
+  valueData.append(other.valueData);
+  vectorData.append(other.vectorData);
+  affineTFData.append(other.affineTFData);
+  polygonValueData.append(other.polygonValueData);
+  polygonVectorData.append(other.polygonVectorData);
+  if (other.maxBlockSize > maxBlockSize)
+    maxBlockSize = other.maxBlockSize;
+}
+
 // Setup an invalid (uninitialized color mapper)
 colorMapper::colorMapper()
 {
@@ -241,6 +241,8 @@ public:
   void addLine(unsigned short x, unsigned short y, unsigned short w, unsigned short h, int x1, int y1, int x2, int y2);
   void addPolygonVector(const QVector<QPoint> &points, int vecX, int vecY);
   void addPolygonValue(const QVector<QPoint> &points, int val);
+  // Append all items of the other data (e.g. the statistics of another part of the same frame)
+  void append(const statisticsData &other);
 
   QList<statisticsItem_Value> valueData;
   QList<statisticsItem_Vector> vectorData;
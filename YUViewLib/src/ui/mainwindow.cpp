@@ -33,18 +33,25 @@
 #include "mainwindow.h"
 
 #include <QByteArray>
+#include <QEventLoop>
 #include <QFileDialog>
+#include <QFutureWatcher>
 #include <QImageWriter>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QShortcut>
 #include <QStringList>
 #include <QTextBrowser>
+#include <QTimer>
+#include <QtConcurrent>
 
 #include "common/functions.h"
 #include "mainwindow_performanceTestDialog.h"
 #include "playlistitem/playlistItems.h"
 #include "settingsDialog.h"
+#include "ui/widgets/FrameTimelineWidget.h"
 #include "ui/widgets/PlaylistTreeWidget.h"
+#include "video/FrameExporter.h"
 
 MainWindow::MainWindow(bool useAlternativeSources, QWidget *parent) : QMainWindow(parent)
 {
@@ -197,6 +204,7 @@ void MainWindow::createMenusAndActions()
   fileMenu->addAction("&Save Playlist...", ui.playlistTreeWidget, &PlaylistTreeWidget::savePlaylistToFile, Qt::CTRL + Qt::Key_S);
   fileMenu->addSeparator();
   fileMenu->addAction("&Save Screenshot...", this, &MainWindow::saveScreenshot);
+  fileMenu->addAction("&Export Frames...", this, &MainWindow::exportFrames);
   fileMenu->addSeparator();
   fileMenu->addAction("&Settings...", this, &MainWindow::showSettingsWindow);
   fileMenu->addSeparator();
@@ -260,10 +268,14 @@ void MainWindow::createMenusAndActions()
   // The playback menu
   QMenu *playbackMenu = menuBar()->addMenu(tr("&Playback"));
   playbackMenu->addAction("Play/Pause", ui.playbackController, &PlaybackController::on_playPauseButton_clicked, Qt::Key_Space);
+  playbackMenu->addAction("Play/Pause Backwards", ui.playbackController, &PlaybackController::on_playReverseButton_clicked, Qt::SHIFT + Qt::Key_Space);
   playbackMenu->addAction("Next Playlist Item", ui.playlistTreeWidget, &PlaylistTreeWidget::onSelectNextItem, Qt::Key_Down);
   playbackMenu->addAction("Previous Playlist Item", ui.playlistTreeWidget, &PlaylistTreeWidget::selectPreviousItem, Qt::Key_Up);
   playbackMenu->addAction("Next Frame", ui.playbackController, &PlaybackController::nextFrame, Qt::Key_Right);
   playbackMenu->addAction("Previous Frame", ui.playbackController, &PlaybackController::previousFrame, Qt::Key_Left);
+  playbackMenu->addSeparator();
+  playbackMenu->addAction("Playback Statistics...", ui.playbackController, &PlaybackController::showPlaybackStatistics);
+  playbackMenu->addAction("Frame Timeline...", this, &MainWindow::showFrameTimeline);
 
   // The Help menu
   QMenu *helpMenu = menuBar()->addMenu(tr("&Help"));
@@ -413,6 +425,11 @@ bool MainWindow::handleKeyPress(QKeyEvent *event, bool keyFromSeparateView)
     ui.displaySplitView->toggleFullScreenAction();
     return true;
   }
+  else if (key == Qt::Key_Space && event->modifiers() == Qt::ShiftModifier)
+  {
+    ui.playbackController->on_playReverseButton_clicked();
+    return true;
+  }
   else if (key == Qt::Key_Space)
   {
     ui.playbackController->on_playPauseButton_clicked();
@@ -694,6 +711,73 @@ void MainWindow::saveScreenshot()
   }
 }
 
+void MainWindow::exportFrames()
+{
+  // Export all frames of the selected compressed or raw file
+  auto item = ui.playlistTreeWidget->getSelectedItems()[0];
+  FrameExporter::Source source;
+  if (auto compressedItem = dynamic_cast<playlistItemCompressedVideo*>(item))
+  {
+    source.fileName = compressedItem->getName();
+    source.decoder = compressedItem->getDecoderEngine();
+  }
+  else if (auto rawItem = dynamic_cast<playlistItemRawFile*>(item))
+  {
+    source.fileName = rawItem->getName();
+    source.rawFormat = rawItem->getFrameHandler()->getFormatAsString();
+  }
+  else
+  {
+    QMessageBox::information(this, "Export Frames", "Please select a compressed or raw YUV/RGB file to export.");
+    return;
+  }
+
+  const QStringList fileExtensions = QStringList() << "yuv" << "rgb" << "y4m" << "png";
+  const QStringList fileFilterStrings = QStringList() << "Raw YUV File (*.yuv)" << "Raw RGB File (*.rgb)" << "Y4M File (*.y4m)" << "PNG Sequence (*.png)";
+  QSettings settings;
+  QString selectedFilter = fileFilterStrings[0];
+  QString filename = QFileDialog::getSaveFileName(this, tr("Export Frames"), settings.value("LastExportPath").toString(), fileFilterStrings.join(";;"), &selectedFilter);
+  if (filename.isEmpty())
+    return;
+  if (!fileExtensions.contains(QFileInfo(filename).suffix().toLower()))
+    filename += "." + fileExtensions[std::max(0, fileFilterStrings.indexOf(selectedFilter))];
+  settings.setValue("LastExportPath", filename.section('/', 0, -2));
+
+  // Run the export in the background and show the progress. The export is canceled with the dialog.
+  FrameExporter exporter(source, filename, FrameExporter::outputFormatFromFileName(filename));
+  QProgressDialog progress("Exporting frames...", "Cancel", 0, 0, this);
+  progress.setWindowModality(Qt::WindowModal);
+  progress.setMinimumDuration(0);
+  progress.setAutoClose(false);
+  progress.setAutoReset(false);
+  connect(&progress, &QProgressDialog::canceled, [&exporter]() { exporter.cancel(); });
+
+  QTimer progressTimer;
+  connect(&progressTimer, &QTimer::timeout, [&exporter, &progress]() {
+    const auto nrFramesTotal = exporter.getNrFramesTotal();
+    const auto nrFramesWritten = exporter.getNrFramesWritten();
+    if (nrFramesTotal > 0)
+    {
+      progress.setMaximum(int(nrFramesTotal));
+      progress.setValue(int(nrFramesWritten));
+    }
+    progress.setLabelText(QString("Exporting frames... (%1 written)").arg(nrFramesWritten));
+  });
+  progressTimer.start(200);
+
+  QEventLoop loop;
+  QFutureWatcher<FrameExporter::Result> watcher;
+  connect(&watcher, &QFutureWatcher<FrameExporter::Result>::finished, &loop, &QEventLoop::quit);
+  watcher.setFuture(QtConcurrent::run(&exporter, &FrameExporter::run));
+  loop.exec();
+  progressTimer.stop();
+  progress.close();
+
+  const auto result = watcher.result();
+  if (!result.success && !progress.wasCanceled())
+    QMessageBox::critical(this, "Export Frames", result.error);
+}
+
 /* Show the file open dialog and open the selected files
  */
 void MainWindow::showFileOpenDialog()
@@ -791,6 +875,15 @@ void MainWindow::closeAndClearSettings()
   close();
 }
 
+void MainWindow::showFrameTimeline()
+{
+  if (frameTimeline.isNull())
+    frameTimeline = new FrameTimelineWidget(this);
+  frameTimeline->show();
+  frameTimeline->raise();
+  frameTimeline->activateWindow();
+}
+
 void MainWindow::performanceTest()
 {
   performanceTestDialog dialog(this);
@@ -42,6 +42,7 @@
 
 #include "ui_mainwindow.h"
 
+class FrameTimelineWidget;
 class QAction;
 class playlistItem;
 
@@ -78,6 +79,7 @@ private slots:
   void showHelp() { showAboutHelp(false); }
   void showSettingsWindow();
   void saveScreenshot();
+  void exportFrames();
   void showFileOpenDialog();
   void resetWindowLayout();
   void closeAndClearSettings();
@@ -105,6 +107,7 @@ private slots:
   void openDav1dWebsite()    { QDesktopServices::openUrl(QUrl("https://github.com/ChristianFeldmann/dav1d/releases")); }
   void checkForNewVersion()  { updater->startCheckForNewVersion(); }
   void performanceTest();
+  void showFrameTimeline();
 
 private:
 
@@ -128,6 +131,7 @@ private:
 
   QPointer<QAction> recentFileActions[MAX_RECENT_FILES];
   QScopedPointer<videoCache> cache;
+  QPointer<FrameTimelineWidget> frameTimeline;
   bool saveWindowsStateOnExit;
   QScopedPointer<updateHandler> updater;
   ViewStateHandler stateHandler;
@@ -32,9 +32,16 @@
 
 #include "playbackController.h"
 
+#include <QFile>
+#include <QFileDialog>
+#include <QJsonDocument>
+#include <QMessageBox>
+#include <QPushButton>
 #include <QSettings>
+#include <QTransform>
 
 #include "playlistitem/playlistItem.h"
+#include "common/FrameProfiler.h"
 #include "common/functions.h"
 #include "common/typedef.h"
 
@@ -68,10 +75,11 @@ PlaybackController::PlaybackController()
   // Initialize variables
   currentFrameIdx = -1;
   lastValidFrameIdx = -1;
-  timerInterval = -1;
+  clockTimer.start();
   timerFPSCounter = 0;
-  timerLastFPSTime = QTime::currentTime();
+  timerLastFPSTimeNs = 0;
   playbackMode = PlaybackStopped;
+  playbackReverse = false;
   playbackWasStalled = false;
   waitingForItem[0] = false;
   waitingForItem[1] = false;
@@ -118,6 +126,9 @@ void PlaybackController::on_playPauseButton_clicked()
     DEBUG_PLAYBACK("PlaybackController::on_playPauseButton_clicked Stop");
     timer.stop();
     playbackMode = PlaybackStopped;
+    stallStartNs = -1;
+    playbackReverse = false;
+    setItemsPlaybackReverse(false);
     emit(waitForItemCaching(nullptr));
     playPauseButton->setIcon(iconPlay);
     fpsLabel->setText("0");
@@ -130,8 +141,12 @@ void PlaybackController::on_playPauseButton_clicked()
   else
   {
     // Playback is not running. Start it.
-    DEBUG_PLAYBACK("PlaybackController::on_playPauseButton_clicked Start");
-    if (currentFrameIdx >= frameSlider->maximum() && repeatMode == RepeatModeOff)
+    DEBUG_PLAYBACK("PlaybackController::on_playPauseButton_clicked Start%s", playbackReverse ? " reverse" : "");
+    setItemsPlaybackReverse(playbackReverse);
+    if (playbackReverse && currentFrameIdx <= frameSlider->minimum())
+      // We are at the start of the sequence. Play it backwards from the end.
+      setCurrentFrame(frameSlider->maximum());
+    else if (!playbackReverse && currentFrameIdx >= frameSlider->maximum() && repeatMode == RepeatModeOff)
     {
       // We are currently at the end of the sequence and the user pressed play.
       // If there is no next item to play, replay the current item from the beginning.
@@ -140,6 +155,7 @@ void PlaybackController::on_playPauseButton_clicked()
     }
 
     emit(signalPlaybackStarting());
+    playbackStatistics.reset();
 
     if (waitForCachingOfItem)
     {
@@ -166,6 +182,24 @@ void PlaybackController::on_playPauseButton_clicked()
   }
 }
 
+void PlaybackController::on_playReverseButton_clicked()
+{
+  if (!currentItem[0])
+    return;
+
+  // Pause playback (in any direction) or start playing backwards
+  if (!playing())
+    playbackReverse = true;
+  on_playPauseButton_clicked();
+}
+
+void PlaybackController::setItemsPlaybackReverse(bool reverse)
+{
+  for (int i = 0; i < 2; i++)
+    if (currentItem[i])
+      currentItem[i]->setPlaybackReverse(reverse);
+}
+
 void PlaybackController::itemCachingFinished(playlistItem *item)
 {
   Q_UNUSED(item);
@@ -189,32 +223,55 @@ void PlaybackController::startPlayback()
 
 void PlaybackController::startOrUpdateTimer()
 {
-  // Get the frame rate of the current item. Lower limit is 0.01 fps (100 seconds per frame).
   if (currentItem[0]->isIndexedByFrame() || (currentItem[1] && currentItem[1]->isIndexedByFrame()))
-  {
-    // One (of the possibly two items) is indexed by frame. Get and set the frame rate
-    double frameRate = currentItem[0]->isIndexedByFrame() ? currentItem[0]->getFrameRate() : currentItem[1]->getFrameRate();
-    if (frameRate < 0.01)
-      frameRate = 0.01;
     timerStaticItemCountDown = -1;
-    timerInterval = 1000.0 / frameRate;
-    DEBUG_PLAYBACK("PlaybackController::startOrUpdateTimer framerate %f", frameRate);
-  }
   else
-  {
-    // The item (or both items) are not indexed by frame.
-    // Use the duration of item 0
-    timerInterval = int(1000 / 10);
+    // The item (or both items) are not indexed by frame. Use the duration of item 0
     timerStaticItemCountDown = currentItem[0]->getDuration() * 10;
-    DEBUG_PLAYBACK("PlaybackController::startOrUpdateTimer duration %d", timerInterval);
-  }
-  
-  timer.start(timerInterval, Qt::PreciseTimer, this);
+
+  // Start a new schedule. The frame that is shown right now counts as presented now.
+  const auto now = clockTimer.nsecsElapsed();
+  playbackClock.start(getCurrentFrameRate(), now);
+  DEBUG_PLAYBACK("PlaybackController::startOrUpdateTimer framerate %f", playbackClock.getFrameRate());
+
+  startTimerForNextFrame();
   playbackMode = PlaybackRunning;
-  timerLastFPSTime = QTime::currentTime();
+  timerLastFPSTimeNs = now;
   timerFPSCounter = 0;
 }
 
+void PlaybackController::startTimerForNextFrame()
+{
+  // Round up so that the timer does not fire before the frame is due
+  const auto nsUntilNextFrame = playbackClock.getNsUntilNextFrame(clockTimer.nsecsElapsed());
+  timer.start(int((nsUntilNextFrame + 999999) / 1000000), Qt::PreciseTimer, this);
+}
+
+double PlaybackController::getCurrentFrameRate() const
+{
+  if (currentItem[0] && currentItem[0]->isIndexedByFrame())
+    return currentItem[0]->getFrameRate();
+  if (currentItem[1] && currentItem[1]->isIndexedByFrame())
+    return currentItem[1]->getFrameRate();
+  return 10.0;
+}
+
+bool PlaybackController::canDropFramesUntil(int frameIdx) const
+{
+  // Only skip forward within the current item and only to frames that are already cached. Loading any other
+  // frame would take even longer than the frame we are late for.
+  if (playbackReverse || frameIdx <= currentFrameIdx || frameIdx > frameSlider->maximum())
+    return false;
+  for (int i = 0; i < 2; i++)
+  {
+    if (i == 1 && !splitViewPrimary->isSplitting())
+      continue;
+    if (currentItem[i] && currentItem[i]->isIndexedByFrame() && !currentItem[i]->getCachedFrames().contains(frameIdx))
+      return false;
+  }
+  return true;
+}
+
 void PlaybackController::nextFrame()
 {
   // Abort playback (if running) and go to the next frame (if possible).
@@ -260,9 +317,13 @@ void PlaybackController::currentSelectedItemsChanged(playlistItem *item1, playli
     // Stop playback (if running)
     pausePlayback();
 
+  // The previous items are not played back anymore. The new items play in the current direction.
+  setItemsPlaybackReverse(false);
+
   // Set the correct number of frames
   currentItem[0] = item1;
   currentItem[1] = item2;
+  setItemsPlaybackReverse(playingReverse());
 
   if (!(item1 && item1->isIndexedByFrame()) && !(item2 && item2->isIndexedByFrame()))
   {
@@ -383,9 +444,12 @@ void PlaybackController::updateSettings()
   bool caching = settings.value("Enabled", true).toBool();
   bool wait = settings.value("PlaybackPauseCaching", false).toBool();
   waitForCachingOfItem = caching && wait;
+  settings.endGroup();
+  dropFramesWhenLate = settings.value("PlaybackDropFrames", false).toBool();
 
   // Load the icons for the buttons
   iconPlay = functions::convertIcon(":img_play.png");
+  iconPlayReverse = QIcon(iconPlay.pixmap(64).transformed(QTransform().scale(-1, 1)));
   iconStop = functions::convertIcon(":img_stop.png");
   iconPause = functions::convertIcon(":img_pause.png");
   iconRepeatOff = functions::convertIcon(":img_repeat.png");
@@ -397,6 +461,7 @@ void PlaybackController::updateSettings()
     playPauseButton->setIcon(iconPlay);
   else
     playPauseButton->setIcon(iconPause);
+  playReverseButton->setIcon(iconPlayReverse);
   stopButton->setIcon(iconStop);
 
   // Don't change the repeat mode but set the icons
@@ -447,7 +512,15 @@ void PlaybackController::enableControls(bool enable)
 
 int PlaybackController::getNextFrameIndex()
 {
-  if (currentFrameIdx >= frameSlider->maximum() || (!currentItem[0]->isIndexedByFrame() && (!currentItem[1] || !currentItem[1]->isIndexedByFrame())))
+  const bool indexedByFrame = currentItem[0]->isIndexedByFrame() || (currentItem[1] && currentItem[1]->isIndexedByFrame());
+  if (playbackReverse && indexedByFrame)
+  {
+    if (currentFrameIdx > frameSlider->minimum())
+      return currentFrameIdx - 1;
+    // Reverse playback does not continue into the previous item. With repeat on, the current item is repeated.
+    return (repeatMode == RepeatModeOff) ? -1 : frameSlider->maximum();
+  }
+  if (currentFrameIdx >= frameSlider->maximum() || !indexedByFrame)
   {
     // The sequence is at the end. Check the repeat mode to see what the next frame index is
     if (repeatMode == RepeatModeOne)
@@ -467,6 +540,20 @@ void PlaybackController::timerEvent(QTimerEvent *event)
     DEBUG_PLAYBACK("PlaybackController::timerEvent Different Timer IDs");
     return QWidget::timerEvent(event);
   }
+
+  FRAME_PROFILER_SCOPE("Playback timer", currentFrameIdx);
+  const auto now = clockTimer.nsecsElapsed();
+  auto nrFramesDue = playbackClock.getNrFramesDue(now);
+  if (event && nrFramesDue == 0)
+  {
+    // The timer fired before the next frame is due
+    startTimerForNextFrame();
+    return;
+  }
+  if (!event)
+    // Called directly to show the next frame now (after a stall)
+    nrFramesDue = 1;
+
   if (timerStaticItemCountDown > 0)
   {
     // We are currently displaying a static item (until timerStaticItemCountDown reaches 0)
@@ -477,11 +564,19 @@ void PlaybackController::timerEvent(QTimerEvent *event)
     timerStaticItemCountDown--;
     frameSlider->setValue(frameSlider->value() + 1);
     frameSpinBox->setValue((timerStaticItemCountDown / 10 + 1));
+    playbackClock.advance(1, now);
+    startTimerForNextFrame();
     return;
   }
 
   int nextFrameIdx = getNextFrameIndex();
-  if (nextFrameIdx == -1)
+  if (nextFrameIdx == -1 && playbackReverse)
+  {
+    // The start of the item was reached
+    DEBUG_PLAYBACK("PlaybackController::timerEvent reverse playback done");
+    on_playPauseButton_clicked();
+  }
+  else if (nextFrameIdx == -1)
   {
     if (waitForCachingOfItem)
     {
@@ -532,47 +627,60 @@ void PlaybackController::timerEvent(QTimerEvent *event)
       timer.stop();
       playbackMode = PlaybackStalled;
       playbackWasStalled = true;
+      stallStartNs = now;
       DEBUG_PLAYBACK("PlaybackController::timerEvent playback stalled");
       return;
     }
 
+    // If we are late by one or more frames, either drop the frames that should have been shown already
+    // or hold (show the next frame now and continue the schedule from here).
+    int64_t nrFramesToAdvance = 1;
+    if (nrFramesDue > 1)
+    {
+      if (dropFramesWhenLate && canDropFramesUntil(nextFrameIdx + int(nrFramesDue) - 1))
+      {
+        nrFramesToAdvance = nrFramesDue;
+        nextFrameIdx += int(nrFramesDue) - 1;
+        playbackStatistics.addDroppedFrames(nrFramesDue - 1);
+      }
+      else
+        playbackStatistics.addHeldFrame();
+      playbackWasStalled = true;
+    }
+
     // Go to the next frame and update the splitView
     DEBUG_PLAYBACK("PlaybackController::timerEvent next frame %d", nextFrameIdx);
     setCurrentFrame(nextFrameIdx);
+    // The latency is measured when the frame is handed to the split view (not when it appears on screen)
+    playbackStatistics.addPresentedFrame(playbackClock.advance(nrFramesToAdvance, now));
+    if (nrFramesToAdvance < nrFramesDue)
+      playbackClock.setNextFrameDue(now + playbackClock.getFramePeriodNs());
 
     // Update the FPS counter every 50 frames
     timerFPSCounter++;
     if (timerFPSCounter >= 50)
     {
-      QTime newFrameTime = QTime::currentTime();
-      double msecsSinceLastUpdate = (double)timerLastFPSTime.msecsTo(newFrameTime);
+      const double secondsSinceLastUpdate = double(now - timerLastFPSTimeNs) / 1e9;
 
       // Print the frames per second as float with one digit after the decimal dot.
-      double framesPerSec = (50 / (msecsSinceLastUpdate / 1000.0));
+      // Dropped frames are not counted. Only the frames that were actually shown.
+      double framesPerSec = (50 / secondsSinceLastUpdate);
       if (framesPerSec > 0)
         fpsLabel->setText(QString::number(framesPerSec, 'f', 1));
       if (playbackWasStalled)
         fpsLabel->setStyleSheet("QLabel { background-color: yellow }");
       else
         fpsLabel->setStyleSheet("");
+      fpsLabel->setToolTip(playbackStatistics.toString());
       playbackWasStalled = false;
 
-      timerLastFPSTime = QTime::currentTime();
+      timerLastFPSTimeNs = now;
       timerFPSCounter = 0;
     }
 
-    // Check if the time interval changed (the user changed the rate of the item)
-    if (currentItem[0]->isIndexedByFrame() || (currentItem[1] && currentItem[1]->isIndexedByFrame()))
-    {
-      // One (of the possibly two items) is indexed by frame. Get and set the frame rate
-      double frameRate = currentItem[0]->isIndexedByFrame() ? currentItem[0]->getFrameRate() : currentItem[1]->getFrameRate();
-      if (frameRate < 0.01)
-        frameRate = 0.01;
-
-      int newtimerInterval = 1000.0 / frameRate;
-      if (timerInterval != newtimerInterval)
-        startOrUpdateTimer();
-    }
+    // The user may have changed the rate of the item. The schedule continues from the current frame.
+    playbackClock.setFrameRate(getCurrentFrameRate());
+    startTimerForNextFrame();
   }
 }
 
@@ -585,16 +693,46 @@ void PlaybackController::currentSelectedItemsDoubleBufferLoad(int itemID)
     if (!waitingForItem[0] && !waitingForItem[1])
     {
       // Playback was stalled because we were waiting for the double buffer to load.
-      // We can go on now.
-      DEBUG_PLAYBACK("PlaybackController::currentSelectedItemsDoubleBufferLoad - timer interval %d", timerInterval);
-      timer.start(timerInterval, Qt::PreciseTimer, this);
-      timerEvent(nullptr);
+      // We can go on now. The schedule continues from now so the stall is not counted as latency of the next frame.
+      const auto now = clockTimer.nsecsElapsed();
+      DEBUG_PLAYBACK("PlaybackController::currentSelectedItemsDoubleBufferLoad - stalled for %f ms", double(now - stallStartNs) / 1e6);
+      if (stallStartNs >= 0)
+        playbackStatistics.addStall(now - stallStartNs);
+      stallStartNs = -1;
+      playbackClock.setNextFrameDue(now);
       // Playback is not stalled anymore
       playbackMode = PlaybackRunning;
+      timerEvent(nullptr);
     }
   }
 }
 
+void PlaybackController::showPlaybackStatistics()
+{
+  QMessageBox msgBox(this);
+  msgBox.setWindowTitle("Playback Statistics");
+  msgBox.setText(playbackStatistics.toString());
+  QPushButton *exportButton = msgBox.addButton(tr("Export..."), QMessageBox::ActionRole);
+  msgBox.addButton(QMessageBox::Close);
+  msgBox.exec();
+  if (msgBox.clickedButton() != exportButton)
+    return;
+
+  QSettings settings;
+  const auto filename = QFileDialog::getSaveFileName(this, tr("Export Playback Statistics"), settings.value("LastPlaybackStatisticsPath").toString(), "JSON File (*.json)");
+  if (filename.isEmpty())
+    return;
+  settings.setValue("LastPlaybackStatisticsPath", filename.section('/', 0, -2));
+
+  auto json = playbackStatistics.toJSON();
+  json["frameRate"] = playbackClock.getFrameRate();
+  if (currentItem[0])
+    json["item"] = currentItem[0]->getName();
+  QFile file(filename);
+  if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(json).toJson()) < 0)
+    QMessageBox::critical(this, "Playback Statistics", "Error writing the file " + filename);
+}
+
 /* Set the value currentFrame to frame and update the value in the splinBox and the slider without
  * invoking any events from these controls. Also update the splitView.
 */
@@ -33,12 +33,13 @@
 #pragma once
 
 #include <QBasicTimer>
+#include <QElapsedTimer>
 #include <QPointer>
-#include <QTime>
 #include <QWidget>
 
 #include "widgets/PlaylistTreeWidget.h"
 #include "views/splitViewWidget.h"
+#include "common/PlaybackClock.h"
 #include "common/typedef.h"
 
 #include "ui_playbackController.h"
@@ -62,6 +63,7 @@ public:
 
   // What is the sate of the playback?
   bool playing() const { return playbackMode != PlaybackStopped; }
+  bool playingReverse() const { return playing() && playbackReverse; }
   bool isWaitingForCaching() const { return playbackMode == PlaybackWaitingForCache; }
 
   // Get the currently shown frame index
@@ -74,9 +76,13 @@ public:
   // -1: The next frame is the first fame of the next item.
   int getNextFrameIndex();
 
+  // The frame pacing statistics of the current (or last) playback
+  const PlaybackStatistics &getPlaybackStatistics() const { return playbackStatistics; }
+
 public slots:
   // Slots for the play/stop/toggleRepera buttons (these are automatically connected by the UI file (connectSlotsByName))
   void on_playPauseButton_clicked();
+  void on_playReverseButton_clicked();
   void on_stopButton_clicked();
   void on_repeatModeButton_clicked();
 
@@ -100,6 +106,9 @@ public slots:
   // Update the current settings fomr the QSettings
   void updateSettings();
 
+  // Show the frame pacing statistics of the current (or last) playback. They can be exported as JSON.
+  void showPlaybackStatistics();
+
 signals:
   void ControllerStartCachingCurrentSelection(indexRange range);
   void ControllerRemoveFromCache(indexRange range);
@@ -139,6 +148,11 @@ private:
   // Start playback. Start the timer (startOrUpdateTimer()), set the icons, inform the split views...
   void startPlayback(); 
 
+  // Does playback run backwards? The selected items are told about this so that they prepare the previous
+  // instead of the next frame.
+  bool playbackReverse;
+  void setItemsPlaybackReverse(bool reverse);
+
   // Set the new repeat mode and save it into the settings. Update the control.
   // Always use this function to set the new repeat mode.
   typedef enum {
@@ -150,6 +164,7 @@ private:
   void setRepeatMode(RepeatMode mode);
 
   QIcon iconPlay;
+  QIcon iconPlayReverse;
   QIcon iconStop;
   QIcon iconPause;
   QIcon iconRepeatOff;
@@ -174,13 +189,24 @@ private:
   // Before starting playback of an item, do we wait until caching is complete?
   bool waitForCachingOfItem;
 
-  // The timer for playback
+  // The timer for playback. It is restarted for every frame with the time until the frame is due on the playbackClock.
   QBasicTimer timer;
-  int    timerInterval;        // The current timer interval in milli seconds. If it changes, update the running timer.
-  int    timerFPSCounter;      // Every time the timer is toggled count this up. If it reaches 50, calculate FPS.
-  QTime  timerLastFPSTime;     // The last time we updated the FPS counter. Used to calculate new FPS.
+  QElapsedTimer clockTimer;       // The monotonic time base of the playbackClock
+  PlaybackClock playbackClock;    // When is the next frame due?
+  int    timerFPSCounter;         // Every time the timer is toggled count this up. If it reaches 50, calculate FPS.
+  qint64 timerLastFPSTimeNs;      // The last time we updated the FPS counter. Used to calculate new FPS.
   int    timerStaticItemCountDown; // Also for static items we run the timer to update the slider.
   virtual void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE; // Overloaded from QObject. Called when the timer fires.
+  void startTimerForNextFrame();
+  // The frame rate of the selected item(s). 10 if no item is indexed by frame (the slider for static items is updated 10 times per second).
+  double getCurrentFrameRate() const;
+
+  // If playback is late by one or more frames, skip frames (if they are cached) instead of showing the next frame late.
+  bool dropFramesWhenLate {false};
+  bool canDropFramesUntil(int frameIdx) const;
+
+  PlaybackStatistics playbackStatistics;
+  qint64 stallStartNs {-1};       // When playback stalled (waiting for the double buffer) or -1
 
   // We keep a pointer to the currently selected item(s)
   QPointer<playlistItem> currentItem[2];
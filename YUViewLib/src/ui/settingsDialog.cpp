@@ -64,6 +64,7 @@ SettingsDialog::SettingsDialog(QWidget *parent) :
   ui.checkBoxWatchFiles->setChecked(settings.value("WatchFiles", true).toBool());
   ui.checkBoxAskToSave->setChecked(settings.value("AskToSaveOnExit", true).toBool());
   ui.checkBoxContinuePlaybackNewSelection->setChecked(settings.value("ContinuePlaybackOnSequenceSelection", false).toBool());
+  ui.checkBoxPlaybackDropFrames->setChecked(settings.value("PlaybackDropFrames", false).toBool());
   ui.checkBoxSavePositionPerItem->setChecked(settings.value("SavePositionAndZoomPerItem", false).toBool());
   // UI
   const auto theme = settings.value("Theme", "Default").toString();
@@ -125,6 +126,14 @@ SettingsDialog::SettingsDialog(QWidget *parent) :
   ui.checkBoxEnablePlaybackCaching->setChecked(playbackCaching);
   ui.spinBoxThreadLimit->setValue(settings.value("PlaybackCachingThreadLimit", 1).toInt());
   ui.spinBoxThreadLimit->setEnabled(playbackCaching);
+  const bool playbackPrefetch = settings.value("PlaybackPrefetchEnabled", false).toBool();
+  ui.checkBoxEnablePlaybackPrefetch->setChecked(playbackPrefetch);
+  ui.spinBoxPrefetchThreadLimit->setValue(settings.value("PlaybackPrefetchThreadLimit", functions::getOptimalThreadCount()).toInt());
+  ui.spinBoxPrefetchThreadLimit->setEnabled(playbackPrefetch);
+  // Decoded frames kept for stepping backwards
+  ui.groupBoxFrameRing->setChecked(settings.value("FrameRingEnabled", false).toBool());
+  ui.spinBoxFrameRingSize->setValue(settings.value("FrameRingSizeMB", 512).toInt());
+  ui.checkBoxFrameRingCompress->setChecked(settings.value("FrameRingCompress", false).toBool());
   settings.endGroup();
 
   // "Decoders" tab
@@ -178,6 +187,11 @@ void SettingsDialog::on_checkBoxEnablePlaybackCaching_stateChanged(int state)
   ui.spinBoxThreadLimit->setEnabled(state != Qt::Unchecked);
 }
 
+void SettingsDialog::on_checkBoxEnablePlaybackPrefetch_stateChanged(int state)
+{
+  ui.spinBoxPrefetchThreadLimit->setEnabled(state != Qt::Unchecked);
+}
+
 void SettingsDialog::on_pushButtonEditViewBackgroundColor_clicked()
 {
   QColor currentColor = ui.viewBackgroundColor->getPlainColor();
@@ -360,6 +374,7 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("WatchFiles", ui.checkBoxWatchFiles->isChecked());
   settings.setValue("AskToSaveOnExit", ui.checkBoxAskToSave->isChecked());
   settings.setValue("ContinuePlaybackOnSequenceSelection", ui.checkBoxContinuePlaybackNewSelection->isChecked());
+  settings.setValue("PlaybackDropFrames", ui.checkBoxPlaybackDropFrames->isChecked());
   settings.setValue("SavePositionAndZoomPerItem", ui.checkBoxSavePositionPerItem->isChecked());
   // UI
   settings.setValue("Theme", ui.comboBoxTheme->currentText());
@@ -393,6 +408,11 @@ void SettingsDialog::on_pushButtonSave_clicked()
   settings.setValue("PlaybackPauseCaching", ui.checkBoxPausPlaybackForCaching->isChecked());
   settings.setValue("PlaybackCachingEnabled", ui.checkBoxEnablePlaybackCaching->isChecked());
   settings.setValue("PlaybackCachingThreadLimit", ui.spinBoxThreadLimit->value());
+  settings.setValue("PlaybackPrefetchEnabled", ui.checkBoxEnablePlaybackPrefetch->isChecked());
+  settings.setValue("PlaybackPrefetchThreadLimit", ui.spinBoxPrefetchThreadLimit->value());
+  settings.setValue("FrameRingEnabled", ui.groupBoxFrameRing->isChecked());
+  settings.setValue("FrameRingSizeMB", ui.spinBoxFrameRingSize->value());
+  settings.setValue("FrameRingCompress", ui.checkBoxFrameRingCompress->isChecked());
   settings.endGroup();
 
   // "Decoders" tab
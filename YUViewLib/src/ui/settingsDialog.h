@@ -54,6 +54,7 @@ private slots:
   // Caching threads check box
   void on_checkBoxNrThreads_stateChanged(int newState);
   void on_checkBoxEnablePlaybackCaching_stateChanged(int state);
+  void on_checkBoxEnablePlaybackPrefetch_stateChanged(int state);
 
   // Colors buttons
   void on_pushButtonEditViewBackgroundColor_clicked();
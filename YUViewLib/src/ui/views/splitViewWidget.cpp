@@ -32,6 +32,7 @@
 
 #include "splitViewWidget.h"
 
+#include <algorithm>
 #include <QActionGroup>
 #include <QBackingStore>
 #include <QDockWidget>
@@ -45,9 +46,11 @@
 #include <QSettings>
 #include <QTextDocument>
 
+#include "common/FrameProfiler.h"
 #include "ui/playbackController.h"
 #include "playlistitem/playlistItem.h"
 #include "video/frameHandler.h"
+#include "video/ImagePyramid.h"
 #include "video/videoCache.h"
 
 // The splitter can be grabbed with a certain margin of pixels to the left and right. The margin
@@ -145,6 +148,7 @@ void splitViewWidget::updateSettings()
 void splitViewWidget::paintEvent(QPaintEvent *paint_event)
 {
   Q_UNUSED(paint_event);
+  FRAME_PROFILER_SCOPE("Paint");
 
   MoveAndZoomableView::updatePaletteIfNeeded();
 
@@ -197,6 +201,10 @@ void splitViewWidget::paintEvent(QPaintEvent *paint_event)
   const auto item = playlist->getSelectedItems();
   const bool anyItemsSelected = item[0] != nullptr || item[1] != nullptr;
 
+  // Let the items build the downscaled levels that the views need. The zoom box and screenshots draw the items at
+  // other zoom factors and must not change this.
+  this->updateItemPyramidLevels(playing);
+
   // The x position of the split (if splitting)
   const int xSplit = int(drawArea_botR.x() * splittingPoint);
 
@@ -1323,6 +1331,14 @@ QImage splitViewWidget::getScreenshot(bool fullItem)
 
     // TODO: What if loading is still in progress?
 
+    // The current frame may have been converted at a reduced size for playback. Load it at full size.
+    const bool playing = playback->playing();
+    item[0]->setNrPyramidLevelsToBuild(this->getNrPyramidLevelsForViews(), false);
+    if (item[0]->needsLoading(frame, showRawData()) == LoadingNeeded)
+      item[0]->loadFrame(frame, false, showRawData(), false);
+    if (playing)
+      this->updateItemPyramidLevels(playing);
+
     // Draw the item at position (0,0)
     item[0]->drawItem(&painter, frame, 1, showRawData());
 
@@ -1387,6 +1403,9 @@ void splitViewWidget::update(bool newFrame, bool itemRedraw)
     int frameIdx = playback->getCurrentFrame();
     bool loadRawData = showRawData() && !playing;
     bool itemLoading[2] = {false, false};
+
+    // Frames that were converted at a reduced size during playback are loaded again at full size once playback stopped
+    this->updateItemPyramidLevels(playing);
     if (item[0])
     {
       auto state = item[0]->needsLoading(frameIdx, loadRawData);
@@ -1428,6 +1447,10 @@ void splitViewWidget::update(bool newFrame, bool itemRedraw)
       }
     }
 
+    if (playing && newFrame && this->isMasterView)
+      // Let the cache fetch the next frames of both items together (if the view is split)
+      cache->prefetchPlaybackFrames(item[0], isSplitting() ? item[1] : nullptr);
+
     DEBUG_LOAD_DRAW("splitViewWidget::update" << (this->isMasterView ? "" : " seperate") << " itemLoading[" << itemLoading[0] << "," << itemLoading[1] << "]");
 
     if ((itemLoading[0] || itemLoading[1]) && playing)
@@ -1795,6 +1818,27 @@ void splitViewWidget::testFinished(bool canceled)
   QMessageBox::information(this, "Test results", QString("We drew 1000 frames in %1 msec. The draw rate is %2 frames per second.").arg(msec).arg(rate));
 }
 
+void splitViewWidget::updateItemPyramidLevels(bool playing)
+{
+  const int nrPyramidLevels = this->getNrPyramidLevelsForViews();
+  for (auto item : playlist->getSelectedItems())
+    if (item)
+      item->setNrPyramidLevelsToBuild(nrPyramidLevels, playing);
+}
+
+int splitViewWidget::getNrPyramidLevelsForViews() const
+{
+  // The view that is zoomed in the most (and needs the fewest levels) decides
+  const auto otherWidget = this->getOtherWidget();
+  double zoom = this->isViewFrozen ? 0.0 : this->zoomFactor;
+  if (otherWidget && otherWidget->isVisible() && !otherWidget->isViewFrozen)
+    zoom = std::max(zoom, otherWidget->zoomFactor);
+  if (zoom == 0.0)
+    // No view shows the items
+    return 0;
+  return ImagePyramid::getLevelForZoom(zoom * this->devicePixelRatioF());
+}
+
 QPointer<splitViewWidget> splitViewWidget::getOtherWidget() const
 {
   if (this->isMasterView)
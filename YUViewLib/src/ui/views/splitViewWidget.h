@@ -268,6 +268,10 @@ protected:
   void testFinished(bool canceled);             //< Report the test results and stop the testProgrssUpdateTimer
 
   QPointer<splitViewWidget> getOtherWidget() const;
+  // The number of downscaled image levels that the main and the separate view (if shown) need at their zoom factors
+  int getNrPyramidLevelsForViews() const;
+  // Set these levels for the selected items. Only while playing may frames be converted at a reduced size.
+  void updateItemPyramidLevels(bool playing);
   void getStateFromMaster() override;
 };
 
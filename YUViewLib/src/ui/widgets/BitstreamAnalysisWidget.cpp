@@ -32,6 +32,8 @@
 
 #include "BitstreamAnalysisWidget.h"
 
+#include <QElapsedTimer>
+
 #include "parser/parserAnnexBAVC.h"
 #include "parser/parserAnnexBHEVC.h"
 #include "parser/parserAnnexBVVC.h"
@@ -59,6 +61,8 @@ BitstreamAnalysisWidget::BitstreamAnalysisWidget(QWidget *parent) :
   this->connect(this->ui.colorCodeStreamsCheckBox, &QCheckBox::toggled, this, &BitstreamAnalysisWidget::colorCodeStreamsCheckBoxToggled);
   this->connect(this->ui.parseEntireFileCheckBox, &QCheckBox::toggled, this, &BitstreamAnalysisWidget::parseEntireBitstreamCheckBoxToggled);
   this->connect(this->ui.bitratePlotOrderComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &BitstreamAnalysisWidget::bitratePlotOrderComboBoxIndexChanged);
+  this->connect(this->ui.packetFilterLineEdit, &QLineEdit::editingFinished, this, &BitstreamAnalysisWidget::packetFilterEditingFinished);
+  this->ui.packetFilterLineEdit->setToolTip(PacketIndex::getQuerySyntaxHelp());
 
   this->currentSelectedItemsChanged(nullptr, nullptr, false);
 }
@@ -79,7 +83,38 @@ void BitstreamAnalysisWidget::updateParserItemModel()
   {
     this->parser->updateNumberModelItems();
     this->updateParsingStatusText(this->parser->getParsingProgressPercent());
+    if (!this->ui.packetFilterLineEdit->text().trimmed().isEmpty())
+      this->updatePacketFilter();
+  }
+}
+
+void BitstreamAnalysisWidget::updatePacketFilter()
+{
+  if (!this->parser)
+    return;
+
+  const auto text = this->ui.packetFilterLineEdit->text().trimmed();
+  if (text.isEmpty())
+  {
+    this->parser->clearFilterRows();
+    this->ui.packetFilterStatusText->clear();
+    return;
   }
+
+  QString errorMessage;
+  const auto query = PacketIndex::parseQuery(text, errorMessage);
+  if (!query)
+  {
+    this->ui.packetFilterStatusText->setText("Error: " + errorMessage);
+    return;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  const auto rows = this->parser->getPacketIndex()->findModelRows(*query);
+  const auto queryTime = timer.elapsed();
+  this->parser->setFilterRows(rows);
+  this->ui.packetFilterStatusText->setText(QString("%1 packets (%2 ms)").arg(rows.size()).arg(queryTime));
 }
 
 void BitstreamAnalysisWidget::updateStreamInfo()
@@ -231,6 +266,7 @@ void BitstreamAnalysisWidget::restartParsingOfCurrentItem()
   this->ui.hrdPlotWidget->setModel(this->parser->getHRDPlotModel());
 
   this->updateStreamInfo();
+  this->updatePacketFilter();
 
   this->updateParsingStatusText(0);
   this->backgroundParserFuture = QtConcurrent::run(this, &BitstreamAnalysisWidget::backgroundParsingFunction);
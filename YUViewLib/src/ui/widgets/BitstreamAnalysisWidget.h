@@ -65,6 +65,7 @@ private slots:
   void colorCodeStreamsCheckBoxToggled(bool state) { this->parser->setStreamColorCoding(state); }
   void parseEntireBitstreamCheckBoxToggled(bool state) { Q_UNUSED(state); this->restartParsingOfCurrentItem(); }
   void bitratePlotOrderComboBoxIndexChanged(int index);
+  void packetFilterEditingFinished() { this->updatePacketFilter(); }
 
 protected:
   void hideEvent(QHideEvent *event) override;
@@ -79,6 +80,10 @@ private:
 
   void stopAndDeleteParserBlocking();
 
+  // Run the query from the packet filter line edit on the packet index of the parser and
+  // only show the matching packets.
+  void updatePacketFilter();
+
   void restartParsingOfCurrentItem();
   void createAndConnectNewParser(YUView::inputFormat inputFormatType);
 
@@ -0,0 +1,298 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FrameTimelineWidget.h"
+
+#include <QCheckBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPushButton>
+#include <QScrollArea>
+#include <QSettings>
+#include <QSpinBox>
+#include <QToolTip>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+namespace
+{
+
+const int labelWidth = 120;
+const int axisHeight = 20;
+const int levelHeight = 16;
+const int rowSpacing = 4;
+
+QColor getSpanColor(const char *name)
+{
+  // The list of colors that we choose the span colors from (the same as in the VideoCacheInfoWidget)
+  static const QList<QColor> colors = QList<QColor>()
+    << QColor(33, 150, 243) // Blue
+    << QColor(0, 150, 136)  // Teal
+    << QColor(139, 195, 74) // Light Green
+    << QColor(96, 125, 139) // Blue Grey
+    << QColor(255, 193, 7)  // Amber
+    << QColor(103, 58, 183) // Deep Purple
+    << QColor(0, 188, 212)  // Cyan
+    << QColor(156, 39, 176) // Purple
+    << QColor(255, 87, 34)  // Deep Orange
+    << QColor(3, 169, 244); // Light blue
+  return colors.at(int(qHash(QByteArray(name)) % uint(colors.count())));
+}
+
+} // namespace
+
+FrameTimelineView::FrameTimelineView(QWidget *parent) : QWidget(parent)
+{
+  setMouseTracking(true);
+  setMinimumHeight(axisHeight);
+}
+
+void FrameTimelineView::setSpans(const QList<FrameProfiler::ThreadSpans> &threads, int64_t endNs, int64_t durationNs)
+{
+  this->endNs = endNs;
+  this->durationNs = std::max(durationNs, int64_t(1));
+
+  this->rows.clear();
+  int y = axisHeight;
+  for (const auto &thread : threads)
+  {
+    ThreadRow row;
+    row.threadName = thread.threadName;
+    row.spans = thread.spans;
+    // Spans are recorded when they end, so an enclosing span comes after the spans within it
+    std::stable_sort(row.spans.begin(), row.spans.end(), [](const FrameProfiler::Span &a, const FrameProfiler::Span &b) {
+      return a.startNs < b.startNs || (a.startNs == b.startNs && a.endNs > b.endNs);
+    });
+
+    // The level of a span is the number of spans that enclose it
+    QVector<int64_t> openSpanEnds;
+    for (const auto &span : row.spans)
+    {
+      while (!openSpanEnds.isEmpty() && openSpanEnds.last() <= span.startNs)
+        openSpanEnds.removeLast();
+      row.levels.append(openSpanEnds.size());
+      row.nrLevels = std::max(row.nrLevels, openSpanEnds.size() + 1);
+      openSpanEnds.append(span.endNs);
+    }
+
+    row.y = y;
+    y += row.nrLevels * levelHeight + rowSpacing;
+    this->rows.append(row);
+  }
+
+  setMinimumHeight(y);
+  update();
+}
+
+int FrameTimelineView::timeToX(int64_t timeNs) const
+{
+  const int64_t startNs = this->endNs - this->durationNs;
+  const int timelineWidth = std::max(width() - labelWidth, 1);
+  return labelWidth + int((timeNs - startNs) * timelineWidth / this->durationNs);
+}
+
+void FrameTimelineView::paintEvent(QPaintEvent *event)
+{
+  Q_UNUSED(event);
+
+  QPainter painter(this);
+  painter.fillRect(rect(), palette().base());
+
+  // The time axis with a tick every second (or every 100 ms for short durations)
+  const int64_t tickNs = (this->durationNs > 2000000000) ? 1000000000 : 100000000;
+  for (int64_t t = 0; t <= this->durationNs; t += tickNs)
+  {
+    const int x = timeToX(this->endNs - t);
+    painter.setPen(palette().mid().color());
+    painter.drawLine(x, axisHeight, x, height());
+    painter.setPen(palette().text().color());
+    painter.drawText(x + 2, 0, 80, axisHeight, Qt::AlignLeft | Qt::AlignVCenter, QString("-%1 s").arg(double(t) / 1e9));
+  }
+
+  for (const auto &row : this->rows)
+  {
+    painter.setPen(palette().text().color());
+    const auto threadName = painter.fontMetrics().elidedText(row.threadName, Qt::ElideRight, labelWidth - 8);
+    painter.drawText(4, row.y, labelWidth - 8, levelHeight, Qt::AlignLeft | Qt::AlignVCenter, threadName);
+
+    painter.setClipRect(labelWidth, row.y, width() - labelWidth, row.nrLevels * levelHeight);
+    for (int i = 0; i < row.spans.size(); i++)
+    {
+      const auto &span = row.spans[i];
+      const int x0 = timeToX(span.startNs);
+      const int x1 = std::max(timeToX(span.endNs), x0 + 1);
+      const QRect spanRect(x0, row.y + row.levels[i] * levelHeight + 1, x1 - x0, levelHeight - 2);
+      painter.fillRect(spanRect, getSpanColor(span.name));
+      if (spanRect.width() > 40)
+      {
+        painter.setPen(Qt::white);
+        painter.drawText(spanRect.adjusted(2, 0, -2, 0), Qt::AlignLeft | Qt::AlignVCenter, painter.fontMetrics().elidedText(QString::fromLatin1(span.name), Qt::ElideRight, spanRect.width() - 4));
+      }
+    }
+    painter.setClipping(false);
+  }
+}
+
+bool FrameTimelineView::getSpanAt(const QPoint &pos, FrameProfiler::Span &span) const
+{
+  if (pos.x() < labelWidth)
+    return false;
+
+  for (const auto &row : this->rows)
+  {
+    if (pos.y() < row.y || pos.y() >= row.y + row.nrLevels * levelHeight)
+      continue;
+    const int level = (pos.y() - row.y) / levelHeight;
+    for (int i = 0; i < row.spans.size(); i++)
+    {
+      if (row.levels[i] != level)
+        continue;
+      const int x0 = timeToX(row.spans[i].startNs);
+      const int x1 = std::max(timeToX(row.spans[i].endNs), x0 + 1);
+      if (pos.x() >= x0 && pos.x() <= x1)
+      {
+        span = row.spans[i];
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void FrameTimelineView::mouseMoveEvent(QMouseEvent *event)
+{
+  FrameProfiler::Span span;
+  if (!getSpanAt(event->pos(), span))
+  {
+    QToolTip::hideText();
+    return;
+  }
+
+  QString text = QString("%1\n%2 ms").arg(QString::fromLatin1(span.name)).arg(double(span.endNs - span.startNs) / 1e6, 0, 'f', 3);
+  if (span.frameIdx >= 0)
+    text += QString("\nFrame %1").arg(span.frameIdx);
+  QToolTip::showText(event->globalPos(), text, this);
+}
+
+/// ------------------------- FrameTimelineWidget -----------------------
+
+FrameTimelineWidget::FrameTimelineWidget(QWidget *parent) : QWidget(parent, Qt::Window)
+{
+  setWindowTitle("Frame Timeline");
+  resize(900, 400);
+
+  QSettings settings;
+  recordCheckBox = new QCheckBox("Record", this);
+  durationSpinBox = new QSpinBox(this);
+  durationSpinBox->setRange(1, 60);
+  durationSpinBox->setSuffix(" s");
+  durationSpinBox->setValue(settings.value("FrameTimeline/Duration", 5).toInt());
+  QPushButton *clearButton = new QPushButton("Clear", this);
+  QPushButton *exportButton = new QPushButton("Export Chrome Trace...", this);
+
+  QHBoxLayout *controlsLayout = new QHBoxLayout;
+  controlsLayout->addWidget(recordCheckBox);
+  controlsLayout->addWidget(new QLabel("Show the last", this));
+  controlsLayout->addWidget(durationSpinBox);
+  controlsLayout->addStretch(1);
+  controlsLayout->addWidget(clearButton);
+  controlsLayout->addWidget(exportButton);
+
+  timelineView = new FrameTimelineView(this);
+  QScrollArea *scrollArea = new QScrollArea(this);
+  scrollArea->setWidget(timelineView);
+  scrollArea->setWidgetResizable(true);
+
+  QVBoxLayout *mainLayout = new QVBoxLayout(this);
+  mainLayout->addLayout(controlsLayout);
+  mainLayout->addWidget(scrollArea, 1);
+  setLayout(mainLayout);
+
+  connect(recordCheckBox, &QCheckBox::toggled, this, &FrameTimelineWidget::onRecordToggled);
+  connect(durationSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, [=](int value) {
+    QSettings().setValue("FrameTimeline/Duration", value);
+    updateTimeline();
+  });
+  connect(clearButton, &QPushButton::clicked, this, &FrameTimelineWidget::onClear);
+  connect(exportButton, &QPushButton::clicked, this, &FrameTimelineWidget::onExport);
+  connect(&updateTimer, &QTimer::timeout, this, &FrameTimelineWidget::updateTimeline);
+}
+
+void FrameTimelineWidget::showEvent(QShowEvent *event)
+{
+  const QSignalBlocker blocker(recordCheckBox);
+  recordCheckBox->setChecked(FrameProfiler::instance().isEnabled());
+  updateTimeline();
+  updateTimer.start(100);
+  QWidget::showEvent(event);
+}
+
+void FrameTimelineWidget::hideEvent(QHideEvent *event)
+{
+  updateTimer.stop();
+  QWidget::hideEvent(event);
+}
+
+void FrameTimelineWidget::onRecordToggled(bool checked)
+{
+  FrameProfiler::instance().setEnabled(checked);
+}
+
+void FrameTimelineWidget::onClear()
+{
+  FrameProfiler::instance().clear();
+  updateTimeline();
+}
+
+void FrameTimelineWidget::onExport()
+{
+  QSettings settings;
+  const auto filename = QFileDialog::getSaveFileName(this, tr("Export Chrome Trace"), settings.value("LastFrameTimelinePath").toString(), "Chrome Trace (*.json)");
+  if (filename.isEmpty())
+    return;
+  settings.setValue("LastFrameTimelinePath", filename.section('/', 0, -2));
+
+  if (!FrameProfiler::instance().exportChromeTrace(filename))
+    QMessageBox::critical(this, "Frame Timeline", "Error writing the file " + filename);
+}
+
+void FrameTimelineWidget::updateTimeline()
+{
+  const int64_t durationNs = int64_t(durationSpinBox->value()) * 1000000000;
+  const int64_t nowNs = FrameProfiler::now();
+  timelineView->setSpans(FrameProfiler::instance().getSpans(nowNs - durationNs), nowNs, durationNs);
+}
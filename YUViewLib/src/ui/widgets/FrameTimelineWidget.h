@@ -0,0 +1,101 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QTimer>
+#include <QWidget>
+
+#include "common/FrameProfiler.h"
+
+class QCheckBox;
+class QSpinBox;
+
+// Paints the spans of all threads over time (one row per thread, the newest spans on the right)
+class FrameTimelineView : public QWidget
+{
+  Q_OBJECT
+
+public:
+  FrameTimelineView(QWidget *parent = nullptr);
+
+  void setSpans(const QList<FrameProfiler::ThreadSpans> &threads, int64_t endNs, int64_t durationNs);
+
+protected:
+  virtual void paintEvent(QPaintEvent *event) Q_DECL_OVERRIDE;
+  virtual void mouseMoveEvent(QMouseEvent *event) Q_DECL_OVERRIDE;
+
+private:
+  // Get the span at the given position in the widget. Returns false if there is none.
+  bool getSpanAt(const QPoint &pos, FrameProfiler::Span &span) const;
+  int timeToX(int64_t timeNs) const;
+
+  // Spans of a thread that are nested (e.g. a conversion within a caching job) are drawn below each other
+  struct ThreadRow
+  {
+    QString threadName;
+    QVector<FrameProfiler::Span> spans;  // Sorted by the start time
+    QVector<int> levels;
+    int nrLevels {1};
+    int y {0};
+  };
+  QList<ThreadRow> rows;
+  int64_t endNs {0};
+  int64_t durationNs {1};
+};
+
+/* A window that shows the spans that were recorded by the FrameProfiler in the last seconds.
+ * Recording can be switched on and off and the recorded spans can be exported in the Chrome trace format.
+ */
+class FrameTimelineWidget : public QWidget
+{
+  Q_OBJECT
+
+public:
+  FrameTimelineWidget(QWidget *parent = nullptr);
+
+protected:
+  virtual void showEvent(QShowEvent *event) Q_DECL_OVERRIDE;
+  virtual void hideEvent(QHideEvent *event) Q_DECL_OVERRIDE;
+
+private slots:
+  void onRecordToggled(bool checked);
+  void onClear();
+  void onExport();
+  void updateTimeline();
+
+private:
+  FrameTimelineView *timelineView {nullptr};
+  QCheckBox *recordCheckBox {nullptr};
+  QSpinBox *durationSpinBox {nullptr};
+  QTimer updateTimer;
+};
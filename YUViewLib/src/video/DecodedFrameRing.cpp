@@ -0,0 +1,229 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DecodedFrameRing.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iterator>
+
+// Fastest zlib level. Raw video compresses only moderately anyway and retrieval must stay interactive.
+#define FRAME_RING_COMPRESSION_LEVEL 1
+
+namespace
+{
+
+std::atomic<int64_t> totalNrBytesAllRings {0};
+
+} // namespace
+
+DecodedFrameRing::~DecodedFrameRing()
+{
+  this->clear();
+}
+
+void DecodedFrameRing::setLimits(int64_t maxNrBytes, bool compressFrames)
+{
+  QMutexLocker lock(&this->accessMutex);
+  if (compressFrames != this->compressFrames)
+  {
+    this->frames.clear();
+    this->addNrBytes(-this->nrBytes);
+  }
+  this->maxNrBytes = maxNrBytes;
+  this->compressFrames = compressFrames;
+  this->evictFrames(this->lastRequestedFrameIdx);
+}
+
+bool DecodedFrameRing::isEnabled() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->maxNrBytes > 0;
+}
+
+void DecodedFrameRing::setPlaybackReverse(bool reverse)
+{
+  QMutexLocker lock(&this->accessMutex);
+  this->playbackReverse = reverse;
+}
+
+void DecodedFrameRing::store(int frameIdx, const FrameBuffer &frame, int signalID)
+{
+  if (frame.isNull())
+    return;
+
+  QMutexLocker lock(&this->accessMutex);
+  if (this->maxNrBytes <= 0)
+    return;
+  auto it = this->frames.find(frameIdx);
+  if (it != this->frames.end() && it->second.signalData.count(signalID) > 0)
+    return;
+
+  SignalData data;
+  int64_t nrBytes;
+  if (this->compressFrames)
+  {
+    data.compressedData = qCompress(frame.toByteArray(), FRAME_RING_COMPRESSION_LEVEL);
+    nrBytes = data.compressedData.size();
+  }
+  else
+  {
+    data.frame = frame;
+    nrBytes = frame.getNrBytes();
+  }
+  if (!this->fitsIntoRing(frameIdx, nrBytes))
+    return;
+
+  auto &entry = this->frames[frameIdx];
+  entry.signalData[signalID] = data;
+  entry.nrBytes += nrBytes;
+  this->addNrBytes(nrBytes);
+  this->evictFrames(this->lastRequestedFrameIdx < 0 ? frameIdx : this->lastRequestedFrameIdx);
+}
+
+FrameBuffer DecodedFrameRing::get(int frameIdx, int signalID)
+{
+  QMutexLocker lock(&this->accessMutex);
+  this->lastRequestedFrameIdx = frameIdx;
+  auto it = this->frames.find(frameIdx);
+  if (it == this->frames.end())
+    return {};
+  auto signalIt = it->second.signalData.find(signalID);
+  if (signalIt == it->second.signalData.end())
+    return {};
+  if (this->compressFrames)
+    return FrameBuffer(qUncompress(signalIt->second.compressedData));
+  return signalIt->second.frame;
+}
+
+void DecodedFrameRing::storeStatistics(int frameIdx, const QHash<int, statisticsData> &statistics)
+{
+  QMutexLocker lock(&this->accessMutex);
+  if (this->maxNrBytes <= 0)
+    return;
+  auto it = this->frames.find(frameIdx);
+  if (it != this->frames.end() && it->second.hasStatistics)
+    return;
+
+  // Estimate the memory of the statistics from the number of items. The lists are implicitly shared with the decoder.
+  int64_t nrBytes = 0;
+  for (const auto &data : statistics)
+  {
+    nrBytes += data.valueData.size() * int64_t(sizeof(statisticsItem_Value));
+    nrBytes += data.vectorData.size() * int64_t(sizeof(statisticsItem_Vector));
+    nrBytes += data.affineTFData.size() * int64_t(sizeof(statisticsItem_AffineTF));
+    nrBytes += data.polygonValueData.size() * int64_t(sizeof(statisticsItemPolygon_Value));
+    nrBytes += data.polygonVectorData.size() * int64_t(sizeof(statisticsItemPolygon_Vector));
+  }
+  if (!this->fitsIntoRing(frameIdx, nrBytes))
+    return;
+
+  auto &entry = this->frames[frameIdx];
+  entry.statistics = statistics;
+  entry.hasStatistics = true;
+  entry.nrBytes += nrBytes;
+  this->addNrBytes(nrBytes);
+  this->evictFrames(this->lastRequestedFrameIdx < 0 ? frameIdx : this->lastRequestedFrameIdx);
+}
+
+bool DecodedFrameRing::getStatistics(int frameIdx, int typeIdx, statisticsData &data) const
+{
+  QMutexLocker lock(&this->accessMutex);
+  auto it = this->frames.find(frameIdx);
+  if (it == this->frames.end() || !it->second.hasStatistics)
+    return false;
+  // A type without an entry has no data in this frame
+  data = it->second.statistics.value(typeIdx);
+  return true;
+}
+
+bool DecodedFrameRing::contains(int frameIdx, int signalID) const
+{
+  QMutexLocker lock(&this->accessMutex);
+  auto it = this->frames.find(frameIdx);
+  return it != this->frames.end() && it->second.signalData.count(signalID) > 0;
+}
+
+void DecodedFrameRing::clear()
+{
+  QMutexLocker lock(&this->accessMutex);
+  this->frames.clear();
+  this->addNrBytes(-this->nrBytes);
+  this->lastRequestedFrameIdx = -1;
+}
+
+int DecodedFrameRing::getNrFrames() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return int(this->frames.size());
+}
+
+int64_t DecodedFrameRing::getNrBytes() const
+{
+  QMutexLocker lock(&this->accessMutex);
+  return this->nrBytes;
+}
+
+int64_t DecodedFrameRing::getTotalNrBytes()
+{
+  return totalNrBytesAllRings;
+}
+
+void DecodedFrameRing::addNrBytes(int64_t nrBytes)
+{
+  this->nrBytes += nrBytes;
+  totalNrBytesAllRings += nrBytes;
+}
+
+bool DecodedFrameRing::fitsIntoRing(int frameIdx, int64_t nrBytes) const
+{
+  auto it = this->frames.find(frameIdx);
+  const int64_t entryNrBytes = (it == this->frames.end()) ? 0 : it->second.nrBytes;
+  return entryNrBytes + nrBytes <= this->maxNrBytes;
+}
+
+void DecodedFrameRing::evictFrames(int keepFrameIdx)
+{
+  // Always remove the frame at the end of the window that is farther away from the frame to keep.
+  // On a tie, drop the later frame. Frames after the playhead are cheap to decode again.
+  // The limit also applies to all rings together.
+  while ((this->nrBytes > this->maxNrBytes || totalNrBytesAllRings > this->maxNrBytes) && !this->frames.empty())
+  {
+    auto first = this->frames.begin();
+    auto last = std::prev(this->frames.end());
+    auto evict = (std::abs(keepFrameIdx - first->first) > std::abs(last->first - keepFrameIdx)) ? first : last;
+    if (this->playbackReverse && last->first > keepFrameIdx)
+      evict = last;
+    this->addNrBytes(-evict->second.nrBytes);
+    this->frames.erase(evict);
+  }
+}
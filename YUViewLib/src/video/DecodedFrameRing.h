@@ -0,0 +1,112 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "statistics/statisticsExtensions.h"
+#include "video/FrameBuffer.h"
+
+#include <QHash>
+#include <QMutex>
+
+#include <map>
+
+/* A bounded buffer of recently decoded frames of one (interactive) decoder.
+ * Decoders can only seek to random access points. Stepping one frame backwards therefore requires
+ * decoding everything from the previous random access point up to the requested frame, which can be
+ * hundreds of frames for long GOPs. Frames that pass through the decoder are stored here so that they
+ * can be retrieved again without decoding.
+ * The memory limit is enforced by evicting the frame that is farthest away from the most recently
+ * requested frame. The limit applies to all rings together (one ring per compressed item), so that several
+ * items do not use the limit each. A ring only evicts its own frames. If the other rings already use the
+ * whole limit, a ring does not keep any frames. Frames are stored as references (FrameBuffer) or, optionally, losslessly compressed.
+ * If the decoder exports all signals in one pass, all signals (reconstruction, prediction, ...) and the
+ * statistics of a frame are kept together so that switching the displayed signal needs no decoding.
+ */
+class DecodedFrameRing
+{
+public:
+  DecodedFrameRing() = default;
+  ~DecodedFrameRing();
+
+  // Set the memory limit of all rings together. A limit of 0 disables the ring.
+  void setLimits(int64_t maxNrBytes, bool compressFrames);
+  bool isEnabled() const;
+  // During reverse playback, frames after the last requested frame were already shown. They are evicted first.
+  void setPlaybackReverse(bool reverse);
+
+  // Store the given signal of the frame. If it does not fit, frames far away from the last requested frame are evicted.
+  void store(int frameIdx, const FrameBuffer &frame, int signalID = 0);
+  // Get the signal of the frame (or a null FrameBuffer if it is not in the ring)
+  FrameBuffer get(int frameIdx, int signalID = 0);
+  bool contains(int frameIdx, int signalID = 0) const;
+
+  // Store the statistics of all types of the frame
+  void storeStatistics(int frameIdx, const QHash<int, statisticsData> &statistics);
+  // Get the statistics of the given type. Returns false if no statistics were stored for the frame.
+  bool getStatistics(int frameIdx, int typeIdx, statisticsData &data) const;
+
+  void clear();
+
+  int getNrFrames() const;
+  int64_t getNrBytes() const;
+  // The memory that is used by all rings together
+  static int64_t getTotalNrBytes();
+
+private:
+  struct SignalData
+  {
+    FrameBuffer frame;
+    QByteArray compressedData;
+  };
+  struct Entry
+  {
+    std::map<int, SignalData> signalData;
+    QHash<int, statisticsData> statistics;
+    bool hasStatistics {false};
+    int64_t nrBytes {0};
+  };
+
+  // Can the given number of bytes be added to the frame at all (even after evicting all other frames)?
+  bool fitsIntoRing(int frameIdx, int64_t nrBytes) const;
+  void evictFrames(int keepFrameIdx);
+  // Change the number of bytes of this ring and of all rings together
+  void addNrBytes(int64_t nrBytes);
+
+  mutable QMutex accessMutex;
+  std::map<int, Entry> frames;
+  int64_t nrBytes {0};
+  int64_t maxNrBytes {0};
+  bool compressFrames {false};
+  bool playbackReverse {false};
+  int lastRequestedFrameIdx {-1};
+};
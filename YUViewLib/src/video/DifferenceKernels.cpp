@@ -0,0 +1,401 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DifferenceKernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DIFFERENCEKERNELS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace DifferenceKernels
+{
+
+namespace
+{
+
+inline int readSample(const unsigned char *row, int x, int bitsPerSample, bool bigEndian)
+{
+  if (bitsPerSample > 8)
+    return bigEndian ? (row[x * 2] << 8 | row[x * 2 + 1]) : (row[x * 2] | row[x * 2 + 1] << 8);
+  return row[x];
+}
+
+inline int clip(int value, int minValue, int maxValue)
+{
+  return (value < minValue) ? minValue : (value > maxValue) ? maxValue : value;
+}
+
+inline uint32_t readNative(const unsigned char *data, int bytesPerSample)
+{
+  if (bytesPerSample == 1)
+    return *data;
+  if (bytesPerSample == 2)
+  {
+    uint16_t value;
+    std::memcpy(&value, data, 2);
+    return value;
+  }
+  uint32_t value;
+  std::memcpy(&value, data, 4);
+  return value;
+}
+
+#if DIFFERENCEKERNELS_SSE2
+// Multiply the 16 bit differences with the amplification factor, add zero and saturate the result to 16 bit
+inline __m128i amplify(__m128i diff, __m128i amplification, __m128i zero32)
+{
+  const __m128i lo = _mm_mullo_epi16(diff, amplification);
+  const __m128i hi = _mm_mulhi_epi16(diff, amplification);
+  const __m128i p0 = _mm_add_epi32(_mm_unpacklo_epi16(lo, hi), zero32);
+  const __m128i p1 = _mm_add_epi32(_mm_unpackhi_epi16(lo, hi), zero32);
+  return _mm_packs_epi32(p0, p1);
+}
+
+// Add the squares of the 16 bit differences to the two 64 bit sums
+inline __m128i addSquares(__m128i sum, __m128i diff)
+{
+  const __m128i squares = _mm_madd_epi16(diff, diff);
+  const __m128i zero = _mm_setzero_si128();
+  sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(squares, zero));
+  return _mm_add_epi64(sum, _mm_unpackhi_epi32(squares, zero));
+}
+
+inline int64_t horizontalSum64(__m128i sum)
+{
+  int64_t values[2];
+  _mm_storeu_si128((__m128i*)values, sum);
+  return values[0] + values[1];
+}
+
+inline __m128i swapBytes16(__m128i value)
+{
+  return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+}
+#endif
+
+} // namespace
+
+int64_t subtractPlane(const Plane &in0, const Plane &in1, int width, int height, int amplificationFactor, unsigned char *dst, int dstStride)
+{
+  const int bitsPerSampleOut = std::max(in0.bitsPerSample, in1.bitsPerSample);
+  const int shift0 = bitsPerSampleOut - in0.bitsPerSample;
+  const int shift1 = bitsPerSampleOut - in1.bitsPerSample;
+  const int zero = 1 << (bitsPerSampleOut - 1);
+  const int maxVal = (1 << bitsPerSampleOut) - 1;
+
+  int64_t sse = 0;
+  for (int y = 0; y < height; y++)
+  {
+    const unsigned char *src0 = in0.data + y * in0.stride;
+    const unsigned char *src1 = in1.data + y * in1.stride;
+    unsigned char *dstRow = dst + y * dstStride;
+
+    int x = 0;
+#if DIFFERENCEKERNELS_SSE2
+    const __m128i amplification = _mm_set1_epi16((short)amplificationFactor);
+    const __m128i zero32 = _mm_set1_epi32(zero);
+    __m128i sum = _mm_setzero_si128();
+    if (in0.bitsPerSample == 8 && in1.bitsPerSample == 8)
+    {
+      // 16 samples per iteration
+      const __m128i zeroVec = _mm_setzero_si128();
+      const __m128i offset = _mm_set1_epi16((short)zero);
+      for (; x + 16 <= width; x += 16)
+      {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(src0 + x));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(src1 + x));
+        const __m128i diff0 = _mm_sub_epi16(_mm_unpacklo_epi8(a, zeroVec), _mm_unpacklo_epi8(b, zeroVec));
+        const __m128i diff1 = _mm_sub_epi16(_mm_unpackhi_epi8(a, zeroVec), _mm_unpackhi_epi8(b, zeroVec));
+        sum = addSquares(addSquares(sum, diff0), diff1);
+        __m128i out0, out1;
+        if (amplificationFactor == 1)
+        {
+          out0 = _mm_add_epi16(diff0, offset);
+          out1 = _mm_add_epi16(diff1, offset);
+        }
+        else
+        {
+          out0 = amplify(diff0, amplification, zero32);
+          out1 = amplify(diff1, amplification, zero32);
+        }
+        _mm_storeu_si128((__m128i*)(dstRow + x), _mm_packus_epi16(out0, out1));
+      }
+    }
+    else if (in0.bitsPerSample > 8 && in1.bitsPerSample > 8 && bitsPerSampleOut <= 15)
+    {
+      // 8 samples per iteration. With up to 15 bit, the differences fit into 16 bit.
+      const __m128i offset = _mm_set1_epi16((short)zero);
+      const __m128i minOut = _mm_setzero_si128();
+      const __m128i maxOut = _mm_set1_epi16((short)maxVal);
+      const __m128i shiftCount0 = _mm_cvtsi32_si128(shift0);
+      const __m128i shiftCount1 = _mm_cvtsi32_si128(shift1);
+      for (; x + 8 <= width; x += 8)
+      {
+        __m128i a = _mm_loadu_si128((const __m128i*)(src0 + x * 2));
+        __m128i b = _mm_loadu_si128((const __m128i*)(src1 + x * 2));
+        if (in0.bigEndian)
+          a = swapBytes16(a);
+        if (in1.bigEndian)
+          b = swapBytes16(b);
+        const __m128i diff = _mm_sub_epi16(_mm_sll_epi16(a, shiftCount0), _mm_sll_epi16(b, shiftCount1));
+        sum = addSquares(sum, diff);
+        __m128i out;
+        if (amplificationFactor == 1)
+          out = _mm_adds_epi16(diff, offset);
+        else
+          out = amplify(diff, amplification, zero32);
+        out = _mm_min_epi16(_mm_max_epi16(out, minOut), maxOut);
+        _mm_storeu_si128((__m128i*)(dstRow + x * 2), out);
+      }
+    }
+    sse += horizontalSum64(sum);
+#endif
+
+    for (; x < width; x++)
+    {
+      const int diff = (readSample(src0, x, in0.bitsPerSample, in0.bigEndian) << shift0) - (readSample(src1, x, in1.bitsPerSample, in1.bigEndian) << shift1);
+      sse += int64_t(diff) * diff;
+      const int out = clip(diff * amplificationFactor + zero, 0, maxVal);
+      if (bitsPerSampleOut > 8)
+      {
+        dstRow[x * 2] = (unsigned char)(out & 0xff);
+        dstRow[x * 2 + 1] = (unsigned char)(out >> 8);
+      }
+      else
+        dstRow[x] = (unsigned char)out;
+    }
+  }
+  return sse;
+}
+
+void subtractRGB32(const unsigned char *in0, int stride0, const unsigned char *in1, int stride1, int width, int height, int amplificationFactor, bool markDifference, unsigned char *dst, int dstStride, int64_t sse[3])
+{
+  for (int y = 0; y < height; y++)
+  {
+    const unsigned char *src0 = in0 + y * stride0;
+    const unsigned char *src1 = in1 + y * stride1;
+    unsigned char *dstRow = dst + y * dstStride;
+
+    int x = 0;
+#if DIFFERENCEKERNELS_SSE2
+    // 4 pixels per iteration. The squares (up to 255^2) are summed per component in 32 bit. This does
+    // not overflow for lines of up to 33000 pixels.
+    const __m128i zeroVec = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi32(int(0xff000000));
+    const __m128i offset = _mm_set1_epi16(128);
+    const __m128i amplification = _mm_set1_epi16((short)amplificationFactor);
+    const __m128i zero32 = _mm_set1_epi32(128);
+    __m128i sum = _mm_setzero_si128();
+    for (; x + 4 <= width; x += 4)
+    {
+      const __m128i a = _mm_loadu_si128((const __m128i*)(src0 + x * 4));
+      const __m128i b = _mm_loadu_si128((const __m128i*)(src1 + x * 4));
+      const __m128i diff0 = _mm_sub_epi16(_mm_unpacklo_epi8(a, zeroVec), _mm_unpacklo_epi8(b, zeroVec));
+      const __m128i diff1 = _mm_sub_epi16(_mm_unpackhi_epi8(a, zeroVec), _mm_unpackhi_epi8(b, zeroVec));
+      // The squares fit into unsigned 16 bit
+      const __m128i squares0 = _mm_mullo_epi16(diff0, diff0);
+      const __m128i squares1 = _mm_mullo_epi16(diff1, diff1);
+      sum = _mm_add_epi32(sum, _mm_add_epi32(_mm_unpacklo_epi16(squares0, zeroVec), _mm_unpackhi_epi16(squares0, zeroVec)));
+      sum = _mm_add_epi32(sum, _mm_add_epi32(_mm_unpacklo_epi16(squares1, zeroVec), _mm_unpackhi_epi16(squares1, zeroVec)));
+
+      __m128i out;
+      if (markDifference)
+        out = _mm_andnot_si128(_mm_cmpeq_epi8(a, b), _mm_set1_epi8(-1));
+      else if (amplificationFactor == 1)
+        out = _mm_packus_epi16(_mm_add_epi16(diff0, offset), _mm_add_epi16(diff1, offset));
+      else
+        out = _mm_packus_epi16(amplify(diff0, amplification, zero32), amplify(diff1, amplification, zero32));
+      _mm_storeu_si128((__m128i*)(dstRow + x * 4), _mm_or_si128(out, alpha));
+    }
+    int32_t sums[4];
+    _mm_storeu_si128((__m128i*)sums, sum);
+    sse[0] += sums[2];
+    sse[1] += sums[1];
+    sse[2] += sums[0];
+#endif
+
+    for (; x < width; x++)
+    {
+      for (int c = 0; c < 3; c++)
+      {
+        const int diff = int(src0[x * 4 + c]) - int(src1[x * 4 + c]);
+        sse[2 - c] += diff * diff;
+        if (markDifference)
+          dstRow[x * 4 + c] = (diff != 0) ? 255 : 0;
+        else
+          dstRow[x * 4 + c] = (unsigned char)clip(128 + diff * amplificationFactor, 0, 255);
+      }
+      dstRow[x * 4 + 3] = 255;
+    }
+  }
+}
+
+int findFirstDifference(const unsigned char *row, int nrSamples, int bytesPerSample, uint32_t value, uint32_t mask)
+{
+  value &= mask;
+  int x = 0;
+#if DIFFERENCEKERNELS_SSE2
+  // Compare 16 bytes at a time. Only if they are not all equal, the first differing sample is searched.
+  __m128i valueVec, maskVec;
+  if (bytesPerSample == 1)
+  {
+    valueVec = _mm_set1_epi8((char)value);
+    maskVec = _mm_set1_epi8((char)mask);
+  }
+  else if (bytesPerSample == 2)
+  {
+    valueVec = _mm_set1_epi16((short)value);
+    maskVec = _mm_set1_epi16((short)mask);
+  }
+  else
+  {
+    valueVec = _mm_set1_epi32(int(value));
+    maskVec = _mm_set1_epi32(int(mask));
+  }
+  const int samplesPerVector = 16 / bytesPerSample;
+  for (; x + samplesPerVector <= nrSamples; x += samplesPerVector)
+  {
+    const __m128i samples = _mm_and_si128(_mm_loadu_si128((const __m128i*)(row + x * bytesPerSample)), maskVec);
+    const int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(samples, valueVec));
+    if (equal != 0xffff)
+    {
+      for (int i = 0; i < 16; i++)
+        if ((equal & (1 << i)) == 0)
+          return x + i / bytesPerSample;
+    }
+  }
+#endif
+  for (; x < nrSamples; x++)
+    if ((readNative(row + x * bytesPerSample, bytesPerSample) & mask) != value)
+      return x;
+  return -1;
+}
+
+void BlockMap::reset(const QSize &frameSize)
+{
+  this->frameSize = frameSize;
+  this->width = (frameSize.width() + blockSize - 1) / blockSize;
+  this->height = (frameSize.height() + blockSize - 1) / blockSize;
+  this->blocks.assign(size_t(std::max(this->width * this->height, 0)), 0);
+}
+
+void BlockMap::markPlane(const unsigned char *data, int stride, int width, int height, int bytesPerSample, uint32_t value, uint32_t mask, int scaleX, int scaleY)
+{
+  for (int y = 0; y < height; y++)
+  {
+    const int blockY = y * scaleY / blockSize;
+    if (blockY >= this->height)
+      break;
+
+    const unsigned char *row = data + y * stride;
+    int x = 0;
+    while (x < width)
+    {
+      const int idx = findFirstDifference(row + x * bytesPerSample, width - x, bytesPerSample, value, mask);
+      if (idx < 0)
+        break;
+      x += idx;
+      const int blockX = x * scaleX / blockSize;
+      if (blockX >= this->width)
+        break;
+      this->markBlock(blockX, blockY);
+      // Continue with the first sample of the next block
+      x = ((blockX + 1) * blockSize + scaleX - 1) / scaleX;
+    }
+  }
+}
+
+bool BlockMap::findFirstInCodingOrder(int ctuSize, int &ctuIndex, int &x, int &y, int &partIndex) const
+{
+  if (this->blocks.empty())
+    return false;
+
+  const int ctuBlocks = ctuSize / blockSize;
+  const int widthCTU = (this->frameSize.width() + ctuSize - 1) / ctuSize;
+  const int heightCTU = (this->frameSize.height() + ctuSize - 1) / ctuSize;
+  for (int ctuY = 0; ctuY < heightCTU; ctuY++)
+  {
+    for (int ctuX = 0; ctuX < widthCTU; ctuX++)
+    {
+      // Skip CTUs without any marked block before walking the tree
+      const int blockX = ctuX * ctuBlocks;
+      const int blockXEnd = std::min(blockX + ctuBlocks, this->width);
+      bool anyMarked = false;
+      for (int blockY = ctuY * ctuBlocks; blockY < std::min((ctuY + 1) * ctuBlocks, this->height) && !anyMarked; blockY++)
+      {
+        const auto rowBegin = this->blocks.begin() + blockY * this->width;
+        anyMarked = std::any_of(rowBegin + blockX, rowBegin + blockXEnd, [](uint8_t b) { return b != 0; });
+      }
+      if (!anyMarked)
+        continue;
+
+      partIndex = 0;
+      if (this->findFirstInZOrder(ctuX * ctuSize, ctuY * ctuSize, ctuSize, x, y, partIndex))
+      {
+        ctuIndex = ctuY * widthCTU + ctuX;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool BlockMap::findFirstInZOrder(int x, int y, int size, int &firstX, int &firstY, int &partIndex) const
+{
+  if (x >= this->frameSize.width() || y >= this->frameSize.height())
+    // This block is entirely outside of the picture
+    return false;
+
+  if (size == blockSize)
+  {
+    if (this->isMarked(x / blockSize, y / blockSize))
+    {
+      firstX = x;
+      firstY = y;
+      return true;
+    }
+    partIndex++;
+    return false;
+  }
+
+  const int half = size / 2;
+  return this->findFirstInZOrder(x, y, half, firstX, firstY, partIndex)
+      || this->findFirstInZOrder(x + half, y, half, firstX, firstY, partIndex)
+      || this->findFirstInZOrder(x, y + half, half, firstX, firstY, partIndex)
+      || this->findFirstInZOrder(x + half, y + half, half, firstX, firstY, partIndex);
+}
+
+} // namespace DifferenceKernels
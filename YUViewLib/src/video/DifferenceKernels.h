@@ -0,0 +1,102 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QSize>
+
+#include <cstdint>
+#include <vector>
+
+/* The kernels that calculate difference frames (SSE2 where available) and the search for the first
+ * difference in coding order.
+ * A difference sample is (in0 - in1) * amplificationFactor + zero, clipped to the output range. For
+ * planes, zero is the middle value of the bit depth (e.g. 128 for 8 bit). For 32 bit RGB images, zero
+ * is 128 or, if only differences are marked, a component is 255 if it differs and 0 otherwise.
+ */
+namespace DifferenceKernels
+{
+
+// A plane of samples with 1 byte (8 bit) or 2 bytes (9 to 16 bit) per sample
+struct Plane
+{
+  const unsigned char *data {nullptr};
+  int stride {0};
+  int bitsPerSample {8};
+  bool bigEndian {false};
+};
+
+// Calculate the difference of two planes. If the bit depths differ, the samples with the lower bit depth are
+// scaled up. The output has the higher bit depth (little endian for more than 8 bit).
+// Return the sum of squared differences (without amplification).
+int64_t subtractPlane(const Plane &in0, const Plane &in1, int width, int height, int amplificationFactor, unsigned char *dst, int dstStride);
+
+// Calculate the difference of two 32 bit images (BGRA byte order). The alpha of the output is 255.
+// The sums of squared differences of the R, G and B components (without amplification) are added to sse.
+void subtractRGB32(const unsigned char *in0, int stride0, const unsigned char *in1, int stride1, int width, int height, int amplificationFactor, bool markDifference, unsigned char *dst, int dstStride, int64_t sse[3]);
+
+// Return the index of the first sample of the row that is not equal to value (-1 if there is none).
+// The samples have 1, 2 or 4 bytes in the byte order of the machine. Only the bits set in mask are compared.
+int findFirstDifference(const unsigned char *row, int nrSamples, int bytesPerSample, uint32_t value, uint32_t mask = 0xffffffff);
+
+// Marks the 4x4 blocks of a frame that contain a difference
+class BlockMap
+{
+public:
+  static const int blockSize = 4;
+
+  // Clear all marks and set the size of the frame (in luma samples)
+  void reset(const QSize &frameSize);
+  QSize getFrameSize() const { return this->frameSize; }
+
+  // Mark all blocks that contain a sample that is not equal to the given value (see findFirstDifference).
+  // For chroma planes, scaleX and scaleY are the subsampling factors (1, 2 or 4) to get to luma positions.
+  void markPlane(const unsigned char *data, int stride, int width, int height, int bytesPerSample, uint32_t value, uint32_t mask = 0xffffffff, int scaleX = 1, int scaleY = 1);
+  void markBlock(int blockX, int blockY) { this->blocks[blockY * this->width + blockX] = 1; }
+  bool isMarked(int blockX, int blockY) const { return this->blocks[blockY * this->width + blockX] != 0; }
+
+  // Search the first marked block in coding order: The frame is split into CTUs (of ctuSize) in raster scan
+  // and every CTU is scanned in z-order down to the 4x4 blocks. partIndex is the number of 4x4 blocks of
+  // the CTU (inside of the frame) that are scanned before the block. Return false if no block is marked.
+  bool findFirstInCodingOrder(int ctuSize, int &ctuIndex, int &x, int &y, int &partIndex) const;
+
+private:
+  bool findFirstInZOrder(int x, int y, int size, int &firstX, int &firstY, int &partIndex) const;
+
+  QSize frameSize;
+  // The size in blocks
+  int width {0};
+  int height {0};
+  std::vector<uint8_t> blocks;
+};
+
+} // namespace DifferenceKernels
@@ -0,0 +1,123 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FrameBuffer.h"
+
+#include <cassert>
+#include <cstring>
+
+FrameBuffer::FrameBuffer(const QByteArray &data)
+{
+  if (data.isEmpty())
+    return;
+  this->d = std::make_shared<Data>();
+  this->d->contiguousData = data;
+}
+
+FrameBuffer::FrameBuffer(std::shared_ptr<void> owner)
+{
+  this->d = std::make_shared<Data>();
+  this->d->owner = owner;
+}
+
+void FrameBuffer::addPlane(const unsigned char *data, int stride, int widthInBytes, int height)
+{
+  assert(this->d && this->d->contiguousData.isEmpty());
+  assert(this->d->nrPlanes < maxNrPlanes);
+
+  auto &plane = this->d->planes[this->d->nrPlanes++];
+  plane.data = data;
+  plane.stride = stride;
+  plane.widthInBytes = widthInBytes;
+  plane.height = height;
+}
+
+bool FrameBuffer::isNull() const
+{
+  return !this->d || (this->d->nrPlanes == 0 && this->d->contiguousData.isEmpty());
+}
+
+bool FrameBuffer::arePlanesTightlyPacked() const
+{
+  for (int i = 0; i < this->getNrPlanes(); i++)
+    if (!this->d->planes[i].isTightlyPacked())
+      return false;
+  return true;
+}
+
+int FrameBuffer::getNrBytes() const
+{
+  if (!this->d)
+    return 0;
+  if (!this->hasPlanes())
+    return this->d->contiguousData.size();
+
+  int nrBytes = 0;
+  for (int i = 0; i < this->d->nrPlanes; i++)
+    nrBytes += this->d->planes[i].widthInBytes * this->d->planes[i].height;
+  return nrBytes;
+}
+
+QByteArray FrameBuffer::toByteArray() const
+{
+  if (!this->d)
+    return QByteArray();
+  if (!this->hasPlanes())
+    return this->d->contiguousData;
+
+  QMutexLocker lock(&this->d->packMutex);
+  if (this->d->packedData.isEmpty())
+  {
+    QByteArray packed;
+    packed.resize(this->getNrBytes());
+    auto dst = (unsigned char*)packed.data();
+    for (int i = 0; i < this->d->nrPlanes; i++)
+    {
+      const auto &plane = this->d->planes[i];
+      if (plane.isTightlyPacked())
+      {
+        memcpy(dst, plane.data, plane.widthInBytes * plane.height);
+        dst += plane.widthInBytes * plane.height;
+        continue;
+      }
+      auto src = plane.data;
+      for (int y = 0; y < plane.height; y++)
+      {
+        memcpy(dst, src, plane.widthInBytes);
+        dst += plane.widthInBytes;
+        src += plane.stride;
+      }
+    }
+    this->d->packedData = packed;
+  }
+  return this->d->packedData;
+}
@@ -0,0 +1,101 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+
+#include <memory>
+
+/* A reference counted buffer that holds the raw data of one frame.
+ * The samples of each plane are accessed using a pointer and a stride (in bytes). This way, a
+ * FrameBuffer can wrap the picture of a decoder (Dav1dPicture, AVFrame, ...) directly without
+ * copying it into a QByteArray first. Alternatively, a contiguous QByteArray in the YUView raw
+ * layout (all planes directly after each other) can be wrapped.
+ * Copies of a FrameBuffer are cheap and share the data. The memory of the planes is released
+ * (using the deleter of the owner) when the last copy is destroyed.
+ */
+class FrameBuffer
+{
+public:
+  static const int maxNrPlanes = 4;
+
+  struct Plane
+  {
+    const unsigned char *data {nullptr};
+    int stride {0};        // The number of bytes from the start of one line to the next
+    int widthInBytes {0};  // The number of bytes per line that belong to the picture
+    int height {0};
+
+    bool isTightlyPacked() const { return stride == widthInBytes; }
+  };
+
+  FrameBuffer() = default;
+  // Wrap the given contiguous data. No copy is made since QByteArray is implicitly shared.
+  explicit FrameBuffer(const QByteArray &data);
+  // Create an empty buffer that keeps the given owner alive. Add the planes of the owner using addPlane.
+  explicit FrameBuffer(std::shared_ptr<void> owner);
+
+  void addPlane(const unsigned char *data, int stride, int widthInBytes, int height);
+
+  bool isNull() const;
+
+  // If the buffer was created from planes, the planes can be accessed directly. Otherwise
+  // (a contiguous QByteArray was wrapped), use toByteArray.
+  bool hasPlanes() const { return this->d && this->d->nrPlanes > 0; }
+  int getNrPlanes() const { return this->d ? this->d->nrPlanes : 0; }
+  const Plane &getPlane(int plane) const { return this->d->planes[plane]; }
+  // Are all lines of all planes directly after each other (no padding at the end of the lines)?
+  bool arePlanesTightlyPacked() const;
+
+  // The number of bytes of the frame in the contiguous layout
+  int getNrBytes() const;
+
+  // Get the frame in the contiguous YUView raw layout. For a wrapped QByteArray, this does not copy anything.
+  // Otherwise, the planes are packed once and the result is shared by all copies of this FrameBuffer.
+  QByteArray toByteArray() const;
+
+private:
+  struct Data
+  {
+    std::shared_ptr<void> owner;
+    QByteArray contiguousData;
+
+    Plane planes[maxNrPlanes];
+    int nrPlanes {0};
+
+    QMutex packMutex;
+    QByteArray packedData;
+  };
+  std::shared_ptr<Data> d;
+};
@@ -0,0 +1,542 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FrameExporter.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QImage>
+#include <QMap>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "decoder/FileDecoder.h"
+#include "filesource/FileSource.h"
+#include "video/videoHandlerRGB.h"
+#include "video/videoHandlerYUV.h"
+
+using namespace YUView;
+using namespace YUV_Internals;
+
+#define FRAMEEXPORTER_DEBUG_OUTPUT 0
+#if FRAMEEXPORTER_DEBUG_OUTPUT && !NDEBUG
+#include <QDebug>
+#define DEBUG_EXPORT qDebug
+#else
+#define DEBUG_EXPORT(fmt,...) ((void)0)
+#endif
+
+namespace
+{
+
+// The number of bytes that are read to guess the format of a raw file from the correlation (same as the raw file item)
+const int64_t NR_BYTES_FORMAT_CORRELATION = 24883200;
+
+bool isRGBFileExtension(const QString &ext)
+{
+  return ext == "rgb" || ext == "gbr" || ext == "bgr" || ext == "brg";
+}
+
+bool isRGBFormatString(const QString &format)
+{
+  return format.split(";").value(2) == "RGB";
+}
+
+videoHandler *createVideoHandler(bool rgb)
+{
+  if (rgb)
+    return new videoHandlerRGB;
+  return new videoHandlerYUV;
+}
+
+} // namespace
+
+bool FrameExporter::outputFormatFromName(const QString &name, OutputFormat &format)
+{
+  const auto n = name.toLower();
+  if (n == "yuv")
+    format = OutputFormat::RawYUV;
+  else if (n == "rgb")
+    format = OutputFormat::RawRGB;
+  else if (n == "y4m")
+    format = OutputFormat::Y4M;
+  else if (n == "png")
+    format = OutputFormat::PNG;
+  else
+    return false;
+  return true;
+}
+
+FrameExporter::OutputFormat FrameExporter::outputFormatFromFileName(const QString &fileName)
+{
+  auto format = OutputFormat::RawYUV;
+  outputFormatFromName(QFileInfo(fileName).suffix(), format);
+  return format;
+}
+
+bool FrameExporter::isRawFileName(const QString &fileName)
+{
+  const auto ext = QFileInfo(fileName).suffix().toLower();
+  return ext == "yuv" || ext == "nv21" || isRGBFileExtension(ext);
+}
+
+FrameExporter::FrameExporter(const Source &source, const QString &outputFileName, OutputFormat outputFormat) :
+  source(source), outputFileName(outputFileName), outputFormat(outputFormat)
+{
+}
+
+FrameExporter::~FrameExporter()
+{
+}
+
+FrameExporter::Result FrameExporter::run()
+{
+  Result result;
+  QElapsedTimer timer;
+  timer.start();
+
+  if (!this->openSource())
+  {
+    result.error = this->getError();
+    return result;
+  }
+
+  auto nrConverters = this->nrConversionThreads;
+  if (nrConverters <= 0)
+  {
+    // Raw YUV and Y4M output only packs the planes. Converting to RGB (and compressing PNGs) is worth more threads.
+    const bool convertToRGB = (this->outputFormat == OutputFormat::RawRGB || this->outputFormat == OutputFormat::PNG);
+    nrConverters = convertToRGB ? std::max(1, QThread::idealThreadCount() - 2) : 1;
+  }
+
+  {
+    QMutexLocker lock(&this->stateMutex);
+    // Enough entries so that no converter runs dry while the writer is busy with a large frame
+    const auto capacity = size_t(nrConverters * 2 + 2);
+    this->readQueue.reset(new BoundedQueue<Frame>(capacity));
+    this->writeQueue.reset(new BoundedQueue<Frame>(capacity));
+    this->maxNrPendingFrames = int64_t(capacity);
+    this->pipelineStopped = false;
+    if (this->stopRequested)
+      this->stopPipeline();
+  }
+  this->nrRunningConverters = nrConverters;
+  DEBUG_EXPORT("FrameExporter::run Exporting %s with %d conversion threads", this->source.fileName.toLatin1().data(), nrConverters);
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(nrConverters + 1);
+  QList<QFuture<void>> futures;
+  futures.append(QtConcurrent::run(&pool, this, &FrameExporter::readFrames));
+  for (int i = 0; i < nrConverters; i++)
+    futures.append(QtConcurrent::run(&pool, this, &FrameExporter::convertFrames));
+
+  this->writeFrames();
+
+  // If writing stopped early, the other stages must not block on a full queue
+  {
+    QMutexLocker lock(&this->stateMutex);
+    this->stopPipeline();
+  }
+  for (auto &future : futures)
+    future.waitForFinished();
+
+  result.error = this->getError();
+  if (result.error.isEmpty() && this->stopRequested)
+    result.error = "The export was canceled.";
+  if (result.error.isEmpty() && this->nrFramesWritten == 0)
+    result.error = "No frames were exported.";
+  result.success = result.error.isEmpty();
+  result.nrFrames = this->nrFramesWritten;
+  result.nrBytesWritten = this->nrBytesWritten;
+  result.seconds = double(timer.nsecsElapsed()) / 1e9;
+  return result;
+}
+
+void FrameExporter::cancel()
+{
+  QMutexLocker lock(&this->stateMutex);
+  this->stopRequested = true;
+  this->stopPipeline();
+}
+
+bool FrameExporter::openSource()
+{
+  const auto &fileName = this->source.fileName;
+  if (QFileInfo(fileName).suffix().toLower() == "y4m")
+  {
+    // The frame headers of Y4M files are not skipped when reading. Open the file in YUView to check the format.
+    this->setError("Exporting from Y4M files is not supported.");
+    return false;
+  }
+  if (this->source.rawFormat.isEmpty() && !isRawFileName(fileName))
+  {
+    this->fileDecoder.reset(new FileDecoder(this->source.decoder));
+    if (!this->fileDecoder->openFile(fileName))
+    {
+      this->setError(this->fileDecoder->getError());
+      return false;
+    }
+    this->frameRate = this->fileDecoder->getFrameRate();
+    if (this->maxNrFrames > 0)
+      this->nrFramesTotal = this->maxNrFrames;
+    return true;
+  }
+
+  this->rawFile.reset(new FileSource);
+  if (!this->rawFile->openFile(fileName))
+  {
+    this->setError("Error opening the input file " + fileName);
+    return false;
+  }
+
+  // Set up a handler the same way the raw file item does it to get the frame size and pixel format
+  const auto fileInfo = QFileInfo(fileName);
+  const bool rgb = this->source.rawFormat.isEmpty() ? isRGBFileExtension(fileInfo.suffix().toLower()) : isRGBFormatString(this->source.rawFormat);
+  QScopedPointer<videoHandler> handler(createVideoHandler(rgb));
+  const auto fileFormat = FileSource::formatFromFilename(fileInfo);
+  if (!this->source.rawFormat.isEmpty())
+    handler->setFormatFromString(this->source.rawFormat);
+  else
+  {
+    if (fileFormat.frameSize.isValid())
+    {
+      handler->setFrameSize(fileFormat.frameSize);
+      handler->setFormatFromSizeAndName(fileFormat.frameSize, fileFormat.bitDepth, fileFormat.packed, this->rawFile->getFileSize(), fileInfo);
+    }
+    if (!handler->isFormatValid())
+    {
+      QByteArray rawData;
+      this->rawFile->readBytes(rawData, 0, NR_BYTES_FORMAT_CORRELATION);
+      handler->setFormatFromCorrelation(rawData, this->rawFile->getFileSize());
+    }
+  }
+  if (!handler->isFormatValid() || handler->getBytesPerFrame() <= 0)
+  {
+    this->setError("Unable to determine the frame size and pixel format of the raw file. Please specify the format.");
+    return false;
+  }
+
+  this->sourceFormat = handler->getFormatAsString();
+  this->rawBytesPerFrame = handler->getBytesPerFrame();
+  this->frameRate = fileFormat.frameRate;
+  auto nrFrames = this->rawFile->getFileSize() / this->rawBytesPerFrame;
+  if (this->maxNrFrames > 0)
+    nrFrames = std::min(nrFrames, this->maxNrFrames);
+  this->nrFramesTotal = nrFrames;
+
+  const auto formatError = this->checkSourceFormat();
+  if (!formatError.isEmpty())
+  {
+    this->setError(formatError);
+    return false;
+  }
+  return true;
+}
+
+void FrameExporter::readFrames()
+{
+  if (this->rawFile)
+  {
+    for (int64_t i = 0; i < this->nrFramesTotal && !this->stopRequested; i++)
+    {
+      Frame frame;
+      frame.index = i;
+      QByteArray data;
+      if (this->rawFile->readBytes(data, i * this->rawBytesPerFrame, this->rawBytesPerFrame) < this->rawBytesPerFrame)
+      {
+        this->setError(QString("Error reading frame %1 from the input file.").arg(i));
+        break;
+      }
+      frame.buffer = FrameBuffer(data);
+      if (!this->readQueue->push(std::move(frame)))
+        break;
+    }
+  }
+  else
+  {
+    int64_t i = 0;
+    while ((this->maxNrFrames <= 0 || i < this->maxNrFrames) && !this->stopRequested && this->fileDecoder->decodeNextFrame())
+    {
+      auto dec = this->fileDecoder->getDecoder();
+      const bool yuv = (dec->getRawFormat() == raw_YUV);
+      if (i == 0)
+      {
+        // The converters read the source format only after the first frame was queued
+        QScopedPointer<videoHandler> handler(createVideoHandler(!yuv));
+        handler->setFrameSize(dec->getFrameSize());
+        if (yuv)
+          static_cast<videoHandlerYUV*>(handler.data())->setYUVPixelFormat(dec->getYUVPixelFormat());
+        else
+          static_cast<videoHandlerRGB*>(handler.data())->setRGBPixelFormat(dec->getRGBPixelFormat());
+        this->sourceFormat = handler->getFormatAsString();
+        const auto formatError = this->checkSourceFormat();
+        if (!formatError.isEmpty())
+        {
+          this->setError(formatError);
+          break;
+        }
+      }
+
+      Frame frame;
+      frame.index = i++;
+      // For YUV, this references the decoder picture directly if the decoder supports it
+      frame.buffer = yuv ? dec->getFrameBuffer() : FrameBuffer(dec->getRawFrameData());
+      if (frame.buffer.isNull())
+      {
+        this->setError(QString("The decoder returned no data for frame %1.").arg(frame.index));
+        break;
+      }
+      if (!this->readQueue->push(std::move(frame)))
+        break;
+    }
+    if (!this->fileDecoder->getError().isEmpty())
+      this->setError(this->fileDecoder->getError());
+  }
+
+  DEBUG_EXPORT("FrameExporter::readFrames Done reading");
+  this->readQueue->close();
+}
+
+void FrameExporter::convertFrames()
+{
+  // The handlers are not thread safe. Every converter uses its own.
+  QScopedPointer<videoHandler> handler;
+  Frame frame;
+  while (this->readQueue->pop(frame))
+  {
+    if (this->stopRequested || !this->convertFrame(frame, handler))
+      break;
+    // Release the decoder picture as early as possible
+    frame.buffer = FrameBuffer();
+    if (!this->waitForWriter(frame.index) || !this->writeQueue->push(std::move(frame)))
+      break;
+  }
+
+  if (--this->nrRunningConverters == 0)
+    this->writeQueue->close();
+}
+
+void FrameExporter::writeFrames()
+{
+  QFile file;
+  if (this->outputFormat != OutputFormat::PNG)
+  {
+    file.setFileName(this->outputFileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+      this->setError("Unable to open the output file " + this->outputFileName);
+      return;
+    }
+  }
+
+  // The converters may finish frames out of order
+  QMap<int64_t, QByteArray> pendingFrames;
+  int64_t nextFrame = 0;
+  Frame frame;
+  while (this->writeQueue->pop(frame))
+  {
+    pendingFrames.insert(frame.index, frame.output);
+    while (!pendingFrames.isEmpty() && pendingFrames.firstKey() == nextFrame && !this->stopRequested)
+    {
+      const auto data = pendingFrames.take(nextFrame);
+      qint64 nrBytes = -1;
+      if (this->outputFormat == OutputFormat::PNG)
+      {
+        QFile pngFile(this->getPNGFileName(nextFrame));
+        if (pngFile.open(QIODevice::WriteOnly))
+          nrBytes = pngFile.write(data);
+      }
+      else
+        nrBytes = file.write(data);
+
+      if (nrBytes != data.size())
+      {
+        this->setError(QString("Error writing frame %1 to the output.").arg(nextFrame));
+        return;
+      }
+      this->nrBytesWritten += nrBytes;
+      nextFrame++;
+
+      QMutexLocker lock(&this->stateMutex);
+      this->nrFramesWritten++;
+      this->frameWritten.wakeAll();
+    }
+  }
+}
+
+bool FrameExporter::waitForWriter(int64_t frameIdx)
+{
+  // If one converter takes long for a frame, the others must not run ahead and pile up frames in the writer
+  QMutexLocker lock(&this->stateMutex);
+  while (frameIdx >= this->nrFramesWritten + this->maxNrPendingFrames && !this->pipelineStopped)
+    this->frameWritten.wait(&this->stateMutex);
+  return !this->pipelineStopped;
+}
+
+bool FrameExporter::convertFrame(Frame &frame, QScopedPointer<videoHandler> &handler)
+{
+  if (this->outputFormat == OutputFormat::RawYUV || this->outputFormat == OutputFormat::Y4M)
+  {
+    // The source is YUV in the output layout (see checkSourceFormat). Only pack the planes.
+    const auto data = frame.buffer.toByteArray();
+    if (this->outputFormat == OutputFormat::RawYUV)
+      frame.output = data;
+    else
+    {
+      if (frame.index == 0)
+        frame.output = this->getY4MHeader().toLatin1();
+      frame.output.append("FRAME\n");
+      frame.output.append(data);
+    }
+    return true;
+  }
+
+  if (!handler)
+  {
+    handler.reset(createVideoHandler(isRGBFormatString(this->sourceFormat)));
+    handler->setFormatFromString(this->sourceFormat);
+  }
+  const auto image = handler->convertFrameToImage(frame.buffer);
+  if (image.isNull())
+  {
+    this->setError(QString("Error converting frame %1 to RGB.").arg(frame.index));
+    return false;
+  }
+
+  if (this->outputFormat == OutputFormat::RawRGB)
+  {
+    const auto rgbImage = image.convertToFormat(QImage::Format_RGB888);
+    const auto bytesPerLine = rgbImage.width() * 3;
+    frame.output.resize(bytesPerLine * rgbImage.height());
+    for (int y = 0; y < rgbImage.height(); y++)
+      std::memcpy(frame.output.data() + y * bytesPerLine, rgbImage.constScanLine(y), bytesPerLine);
+  }
+  else
+  {
+    QBuffer buffer(&frame.output);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, "PNG"))
+    {
+      this->setError(QString("Error encoding frame %1 as PNG.").arg(frame.index));
+      return false;
+    }
+  }
+  return true;
+}
+
+QString FrameExporter::checkSourceFormat() const
+{
+  if (this->outputFormat != OutputFormat::RawYUV && this->outputFormat != OutputFormat::Y4M)
+    return {};
+  if (isRGBFormatString(this->sourceFormat))
+    return "The source is RGB. It can only be exported as RGB or PNG.";
+  if (this->outputFormat == OutputFormat::RawYUV)
+    return {};
+
+  const auto pixelFormat = yuvPixelFormat(this->sourceFormat.split(";").value(3));
+  const auto subsampling = pixelFormat.subsampling;
+  const bool y4mSubsampling = (subsampling == Subsampling::YUV_420 || subsampling == Subsampling::YUV_422 || subsampling == Subsampling::YUV_444 || subsampling == Subsampling::YUV_400);
+  if (!pixelFormat.planar || pixelFormat.uvInterleaved || pixelFormat.planeOrder != PlaneOrder::YUV || pixelFormat.bigEndian || !y4mSubsampling)
+    return "Y4M output requires a planar YUV source in Y, U, V order with 4:0:0, 4:2:0, 4:2:2 or 4:4:4 subsampling. Use raw YUV output instead.";
+  return {};
+}
+
+QString FrameExporter::getY4MHeader() const
+{
+  const auto format = this->sourceFormat.split(";");
+  const auto pixelFormat = yuvPixelFormat(format.value(3));
+
+  QString colorspace;
+  if (pixelFormat.subsampling == Subsampling::YUV_420)
+    colorspace = (pixelFormat.chromaOffset[0] == 1 && pixelFormat.chromaOffset[1] == 1) ? "420jpeg" : "420mpeg2";
+  else if (pixelFormat.subsampling == Subsampling::YUV_422)
+    colorspace = "422";
+  else if (pixelFormat.subsampling == Subsampling::YUV_444)
+    colorspace = "444";
+  else
+    colorspace = "mono";
+  if (pixelFormat.bitsPerSample > 8)
+    colorspace += QString("p%1").arg(pixelFormat.bitsPerSample);
+
+  // Fractional NTSC rates (e.g. 29.97) are written as multiples of 1/1001
+  const auto rate = (this->frameRate > 0) ? this->frameRate : DEFAULT_FRAMERATE;
+  QString frameRateString;
+  if (std::abs(rate - std::round(rate)) < 0.001)
+    frameRateString = QString("%1:1").arg(std::lround(rate));
+  else
+    frameRateString = QString("%1:1001").arg(std::lround(rate * 1001));
+
+  return QString("YUV4MPEG2 W%1 H%2 F%3 Ip A1:1 C%4\n").arg(format.value(0), format.value(1), frameRateString, colorspace);
+}
+
+QString FrameExporter::getPNGFileName(int64_t frameIdx) const
+{
+  const auto fileInfo = QFileInfo(this->outputFileName);
+  const auto name = QString("%1_%2.png").arg(fileInfo.completeBaseName()).arg(frameIdx, 5, 10, QChar('0'));
+  return fileInfo.dir().filePath(name);
+}
+
+void FrameExporter::setError(const QString &error)
+{
+  QMutexLocker lock(&this->stateMutex);
+  DEBUG_EXPORT("FrameExporter::setError %s", error.toLatin1().data());
+  if (this->error.isEmpty())
+    this->error = error;
+  this->stopRequested = true;
+  this->stopPipeline();
+}
+
+QString FrameExporter::getError()
+{
+  QMutexLocker lock(&this->stateMutex);
+  return this->error;
+}
+
+void FrameExporter::stopPipeline()
+{
+  // Must be called with the stateMutex locked
+  if (this->readQueue)
+    this->readQueue->close();
+  if (this->writeQueue)
+    this->writeQueue->close();
+  this->pipelineStopped = true;
+  this->frameWritten.wakeAll();
+}
@@ -0,0 +1,171 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QString>
+#include <QWaitCondition>
+
+#include <atomic>
+
+#include "common/BoundedQueue.h"
+#include "common/typedef.h"
+#include "video/FrameBuffer.h"
+
+class FileDecoder;
+class FileSource;
+class videoHandler;
+
+/* Export all frames of a bitstream or a raw file to raw YUV, raw RGB (8 bit per component, interleaved),
+ * a Y4M file or a sequence of PNG files without any GUI.
+ * The export runs as a pipeline of three stages that are connected by bounded queues:
+ * - One thread decodes the bitstream (or reads the raw file)
+ * - One or more threads convert the frames to the output format
+ * - The calling thread writes the converted frames (in order) to disk
+ * This way, decoding, conversion and writing overlap and the memory that is used is limited by the
+ * size of the queues. A converter that is ahead of the writer by more than the queue size waits until
+ * the writer caught up, so the frames that the writer has to put back in order are limited, too.
+ */
+class FrameExporter
+{
+public:
+  enum class OutputFormat
+  {
+    RawYUV,
+    RawRGB,
+    Y4M,
+    PNG
+  };
+  // Get the output format from its name (yuv, rgb, y4m or png). Return false if the name is unknown.
+  static bool outputFormatFromName(const QString &name, OutputFormat &format);
+  // Get the output format from the extension of the output file (raw YUV if the extension is unknown)
+  static OutputFormat outputFormatFromFileName(const QString &fileName);
+  // Is the file a raw YUV or RGB file (and not a bitstream) judging by the extension?
+  static bool isRawFileName(const QString &fileName);
+
+  struct Source
+  {
+    QString fileName;
+    // For raw files, the frame size and pixel format as returned by videoHandler::getFormatAsString
+    // (e.g. "1920;1080;YUV;4:2:0 8-bit"). If empty, it is guessed from the file name.
+    QString rawFormat;
+    // The decoder for bitstreams. If invalid, the decoder is chosen from the file type.
+    YUView::decoderEngine decoder {YUView::decoderEngineInvalid};
+  };
+
+  struct Result
+  {
+    bool success {false};
+    QString error;
+    int64_t nrFrames {0};
+    int64_t nrBytesWritten {0};
+    double seconds {0.0};
+  };
+
+  FrameExporter(const Source &source, const QString &outputFileName, OutputFormat outputFormat);
+  ~FrameExporter();
+
+  // Only export the first maxNrFrames frames (0: all frames)
+  void setMaxNrFrames(int64_t maxNrFrames) { this->maxNrFrames = maxNrFrames; }
+  // The number of threads that convert frames (0: chosen from the output format and the number of cores)
+  void setNrConversionThreads(int nrThreads) { this->nrConversionThreads = nrThreads; }
+
+  // Run the export. This blocks until all frames were written, an error occurred or cancel() was called.
+  Result run();
+
+  // These can be called from any thread while run() is running
+  void cancel();
+  int64_t getNrFramesWritten() const { return this->nrFramesWritten.load(); }
+  // The number of frames that will be exported (-1 if unknown, e.g. for bitstreams)
+  int64_t getNrFramesTotal() const { return this->nrFramesTotal.load(); }
+
+private:
+  struct Frame
+  {
+    int64_t index {0};
+    FrameBuffer buffer;
+    QByteArray output;
+  };
+
+  bool openSource();
+  void readFrames();
+  void convertFrames();
+  void writeFrames();
+  // Wait until the frame may be handed to the writer without being too far ahead of it. Return false if the pipeline stopped.
+  bool waitForWriter(int64_t frameIdx);
+
+  bool convertFrame(Frame &frame, QScopedPointer<videoHandler> &handler);
+  // Check if the source format can be written in the output format. Return an error message if not.
+  QString checkSourceFormat() const;
+  QString getY4MHeader() const;
+  QString getPNGFileName(int64_t frameIdx) const;
+
+  // The first error is kept. All queues are closed so that all stages stop.
+  void setError(const QString &error);
+  QString getError();
+  void stopPipeline();
+
+  Source source;
+  QString outputFileName;
+  OutputFormat outputFormat;
+  int64_t maxNrFrames {0};
+  int nrConversionThreads {0};
+
+  QScopedPointer<FileDecoder> fileDecoder;
+  QScopedPointer<FileSource> rawFile;
+  int64_t rawBytesPerFrame {0};
+  double frameRate {-1};
+
+  // The frame size and pixel format of the source (as given by videoHandler::getFormatAsString). For bitstreams,
+  // this is set by the reading thread before the first frame is queued.
+  QString sourceFormat;
+
+  // The queues are created by run(). Access to the pointers, the error and pipelineStopped is guarded by the stateMutex.
+  QScopedPointer<BoundedQueue<Frame>> readQueue;
+  QScopedPointer<BoundedQueue<Frame>> writeQueue;
+  std::atomic<int> nrRunningConverters {0};
+  QMutex stateMutex;
+  QString error;
+  bool pipelineStopped {false};
+
+  // The converters wait on this until the writer is less than maxNrPendingFrames behind their frame
+  QWaitCondition frameWritten;
+  int64_t maxNrPendingFrames {1};
+
+  std::atomic<bool> stopRequested {false};
+  std::atomic<int64_t> nrFramesWritten {0};
+  std::atomic<int64_t> nrFramesTotal {-1};
+  int64_t nrBytesWritten {0};
+};
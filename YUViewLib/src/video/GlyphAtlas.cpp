@@ -0,0 +1,181 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "GlyphAtlas.h"
+
+#include <QFontMetricsF>
+#include <QImage>
+
+#include <cmath>
+#include <cstdlib>
+
+void GlyphAtlas::Text::addValue(char label, int value, int base)
+{
+  // Format the digits backwards
+  char digits[40];
+  int nrDigits = 0;
+  unsigned int absValue = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+  do
+  {
+    const auto digit = absValue % (unsigned int)base;
+    digits[nrDigits++] = char((digit < 10) ? '0' + digit : 'a' + digit - 10);
+    absValue /= (unsigned int)base;
+  } while (absValue > 0 && nrDigits < 40);
+
+  const int lineLength = (this->length > 0 ? 1 : 0) + (label != 0 ? 1 : 0) + (value < 0 ? 1 : 0) + nrDigits;
+  if (this->length + lineLength > maxLength)
+    return;
+
+  if (this->length > 0)
+    this->chars[this->length++] = '\n';
+  if (label != 0)
+    this->chars[this->length++] = label;
+  if (value < 0)
+    this->chars[this->length++] = '-';
+  while (nrDigits > 0)
+    this->chars[this->length++] = digits[--nrDigits];
+}
+
+void GlyphAtlas::begin(QPainter *painter)
+{
+  const auto dpr = painter->device()->devicePixelRatioF();
+  if (this->atlas.isNull() || painter->font() != this->font || dpr != this->devicePixelRatio)
+    this->renderGlyphs(painter->font(), dpr);
+  this->fragments.clear();
+}
+
+void GlyphAtlas::renderGlyphs(const QFont &font, qreal devicePixelRatio)
+{
+  this->font = font;
+  this->devicePixelRatio = devicePixelRatio;
+
+  QFontMetricsF metrics(font);
+  this->lineHeight = metrics.height();
+  this->lineSpacing = metrics.lineSpacing();
+
+  // One row of glyphs per color. Every glyph gets a cell with some space around it for overhanging pixels.
+  const qreal padding = 2;
+  qreal atlasWidth = 0;
+  qreal cellWidth[nrChars];
+  for (int i = 0; i < nrChars; i++)
+  {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+    this->glyphs[i].advance = metrics.horizontalAdvance(QChar(firstChar + i));
+#else
+    this->glyphs[i].advance = metrics.width(QChar(firstChar + i));
+#endif
+    cellWidth[i] = std::ceil(this->glyphs[i].advance) + 2 * padding;
+    atlasWidth += cellWidth[i];
+  }
+  const qreal cellHeight = std::ceil(this->lineHeight) + 2 * padding;
+
+  QImage image(QSize(std::ceil(atlasWidth * devicePixelRatio), std::ceil(2 * cellHeight * devicePixelRatio)), QImage::Format_ARGB32_Premultiplied);
+  image.setDevicePixelRatio(devicePixelRatio);
+  image.fill(Qt::transparent);
+
+  QPainter painter(&image);
+  painter.setFont(font);
+  for (int color = 0; color < 2; color++)
+  {
+    painter.setPen(color == 0 ? Qt::black : Qt::white);
+    qreal x = 0;
+    const qreal y = color * cellHeight;
+    for (int i = 0; i < nrChars; i++)
+    {
+      painter.drawText(QPointF(x + padding, y + padding + metrics.ascent()), QString(QChar(firstChar + i)));
+      // The fragments are drawn centered. Keep the padding on both sides so that the advance is centered in the cell.
+      this->glyphs[i].source[color] = QRectF(x * devicePixelRatio, y * devicePixelRatio, cellWidth[i] * devicePixelRatio, cellHeight * devicePixelRatio);
+      x += cellWidth[i];
+    }
+  }
+  painter.end();
+
+  this->atlas = QPixmap::fromImage(image);
+}
+
+void GlyphAtlas::addText(const QRect &rect, const Text &text, bool white)
+{
+  if (text.length == 0)
+    return;
+
+  // Count the lines to center the block vertically
+  int nrLines = 1;
+  for (int i = 0; i < text.length; i++)
+    if (text.chars[i] == '\n')
+      nrLines++;
+
+  const qreal blockHeight = (nrLines - 1) * this->lineSpacing + this->lineHeight;
+  const auto center = QRectF(rect).center();
+  qreal lineCenterY = center.y() - blockHeight / 2 + this->lineHeight / 2;
+  const auto color = white ? 1 : 0;
+  const auto scale = 1.0 / this->devicePixelRatio;
+
+  int lineStart = 0;
+  while (lineStart <= text.length)
+  {
+    int lineEnd = lineStart;
+    qreal lineWidth = 0;
+    while (lineEnd < text.length && text.chars[lineEnd] != '\n')
+    {
+      const auto c = int((unsigned char)text.chars[lineEnd]);
+      if (c >= firstChar && c <= lastChar)
+        lineWidth += this->glyphs[c - firstChar].advance;
+      lineEnd++;
+    }
+
+    // Center the line horizontally
+    qreal x = center.x() - lineWidth / 2;
+    for (int i = lineStart; i < lineEnd; i++)
+    {
+      const auto c = int((unsigned char)text.chars[i]);
+      if (c < firstChar || c > lastChar)
+        continue;
+      const auto &glyph = this->glyphs[c - firstChar];
+      if (c != ' ')
+      {
+        const auto &source = glyph.source[color];
+        this->fragments.append(QPainter::PixmapFragment::create(QPointF(x + glyph.advance / 2, lineCenterY), source, scale, scale));
+      }
+      x += glyph.advance;
+    }
+
+    lineStart = lineEnd + 1;
+    lineCenterY += this->lineSpacing;
+  }
+}
+
+void GlyphAtlas::end(QPainter *painter)
+{
+  if (!this->fragments.isEmpty())
+    painter->drawPixmapFragments(this->fragments.constData(), this->fragments.size(), this->atlas);
+  this->fragments.clear();
+}
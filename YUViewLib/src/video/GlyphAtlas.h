@@ -0,0 +1,92 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QFont>
+#include <QPainter>
+#include <QPixmap>
+#include <QRect>
+#include <QVector>
+
+/* Draw many short texts (e.g. the pixel values that are drawn on top of every pixel at high zoom) from
+ * pre-rendered glyphs. Calling QPainter::drawText for every pixel lays out every string again, which gets
+ * slow when thousands of pixels are visible. Instead, all printable ASCII characters are rendered once
+ * into an atlas (in white and in black) and every text is added as a list of glyph fragments. All fragments
+ * are then drawn with one call to QPainter::drawPixmapFragments.
+ * The atlas is rendered again only if the font or the device pixel ratio of the painter changes.
+ */
+class GlyphAtlas
+{
+public:
+  // The text of one pixel. Values are formatted into a plain character buffer.
+  struct Text
+  {
+    // Add a line with the label followed by the value in the given base (e.g. "Y-12" or "Ua3")
+    void addValue(char label, int value, int base);
+    // Add a line with the value only
+    void addValue(int value, int base) { this->addValue(0, value, base); }
+
+    static const int maxLength = 64;
+    char chars[maxLength];
+    int length {0};
+  };
+
+  // Start a new batch. The font of the painter is used.
+  void begin(QPainter *painter);
+  // Add the text centered in the rect (like Qt::AlignCenter). Lines are separated by '\n'.
+  void addText(const QRect &rect, const Text &text, bool white);
+  // Draw all texts that were added since begin()
+  void end(QPainter *painter);
+
+private:
+  void renderGlyphs(const QFont &font, qreal devicePixelRatio);
+
+  static const int firstChar = 32;
+  static const int lastChar = 126;
+  static const int nrChars = lastChar - firstChar + 1;
+
+  struct Glyph
+  {
+    QRectF source[2];  // The source rect in the atlas (in device pixels) for black and white
+    qreal advance {0};
+  };
+  Glyph glyphs[nrChars];
+  qreal lineHeight {0};
+  qreal lineSpacing {0};
+
+  QFont font;
+  qreal devicePixelRatio {0};
+  QPixmap atlas;
+
+  QVector<QPainter::PixmapFragment> fragments;
+};
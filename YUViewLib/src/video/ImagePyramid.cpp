@@ -0,0 +1,151 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ImagePyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGEPYRAMID_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+// No levels are built below this width or height
+const int MIN_LEVEL_SIZE = 16;
+
+// Average 2x2 blocks of 32 bit pixels (4 components of 8 bit each) of two lines into one output line
+void downscaleLine32(const unsigned char *line0, const unsigned char *line1, unsigned char *dst, int dstWidth)
+{
+  int x = 0;
+#if IMAGEPYRAMID_SSE2
+  // 2 output pixels (4 input pixels per line) per iteration. The sums of 4 components need 16 bit.
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i two = _mm_set1_epi16(2);
+  for (; x + 2 <= dstWidth; x += 2)
+  {
+    const __m128i a = _mm_loadu_si128((const __m128i*)(line0 + x * 8));
+    const __m128i b = _mm_loadu_si128((const __m128i*)(line1 + x * 8));
+    // Vertical sums of the pixel pairs (0,1) and (2,3)
+    const __m128i sum01 = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    const __m128i sum23 = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+    // Horizontal sums: pixel 0 + 1 and pixel 2 + 3
+    const __m128i sum0 = _mm_add_epi16(sum01, _mm_srli_si128(sum01, 8));
+    const __m128i sum1 = _mm_add_epi16(sum23, _mm_srli_si128(sum23, 8));
+    const __m128i avg = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(sum0, sum1), two), 2);
+    _mm_storel_epi64((__m128i*)(dst + x * 4), _mm_packus_epi16(avg, zero));
+  }
+#endif
+  for (; x < dstWidth; x++)
+    for (int c = 0; c < 4; c++)
+      dst[x * 4 + c] = (unsigned char)((line0[x * 8 + c] + line0[x * 8 + 4 + c] + line1[x * 8 + c] + line1[x * 8 + 4 + c] + 2) >> 2);
+}
+
+bool is32BitFormat(QImage::Format format)
+{
+  return format == QImage::Format_RGB32 || format == QImage::Format_ARGB32 || format == QImage::Format_ARGB32_Premultiplied
+      || format == QImage::Format_RGBX8888 || format == QImage::Format_RGBA8888 || format == QImage::Format_RGBA8888_Premultiplied;
+}
+
+} // namespace
+
+int ImagePyramid::getLevelForZoom(double zoomFactor)
+{
+  if (zoomFactor <= 0 || zoomFactor >= 0.5)
+    return 0;
+  return int(std::floor(std::log2(1.0 / zoomFactor)));
+}
+
+QImage ImagePyramid::downscaleByTwo(const QImage &image)
+{
+  const auto dstWidth = image.width() / 2;
+  const auto dstHeight = image.height() / 2;
+  if (dstWidth == 0 || dstHeight == 0)
+    return {};
+
+  // The components of premultiplied formats can be averaged directly. Other formats are converted first.
+  const auto src = is32BitFormat(image.format()) ? image : image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+  QImage dst(dstWidth, dstHeight, src.format());
+  for (int y = 0; y < dstHeight; y++)
+    downscaleLine32(src.constScanLine(2 * y), src.constScanLine(2 * y + 1), dst.scanLine(y), dstWidth);
+  return dst;
+}
+
+QVector<QImage> ImagePyramid::buildLevels(const QImage &image, int nrLevels)
+{
+  QVector<QImage> levels;
+  auto level = image;
+  while (levels.size() < nrLevels && level.width() / 2 >= MIN_LEVEL_SIZE && level.height() / 2 >= MIN_LEVEL_SIZE)
+  {
+    level = downscaleByTwo(level);
+    levels.append(level);
+  }
+  return levels;
+}
+
+int64_t ImagePyramid::getLevelsBytes(const QSize &size, int bytesPerPixel, int nrLevels)
+{
+  int64_t bytes = 0;
+  auto w = int64_t(size.width());
+  auto h = int64_t(size.height());
+  for (int i = 0; i < nrLevels && w / 2 >= MIN_LEVEL_SIZE && h / 2 >= MIN_LEVEL_SIZE; i++)
+  {
+    w /= 2;
+    h /= 2;
+    bytes += w * h * bytesPerPixel;
+  }
+  return bytes;
+}
+
+void ImagePyramid::setImage(const QImage &image, const QVector<QImage> &levels)
+{
+  this->image = image;
+  this->levels = levels;
+}
+
+QImage ImagePyramid::getLevel(int level)
+{
+  if (level <= 0 || this->image.isNull())
+    return this->image;
+
+  if (this->levels.size() < level)
+  {
+    const auto &largest = this->levels.isEmpty() ? this->image : this->levels.last();
+    this->levels.append(buildLevels(largest, level - this->levels.size()));
+  }
+  if (this->levels.isEmpty())
+    return this->image;
+  return this->levels.at(std::min(level, this->levels.size()) - 1);
+}
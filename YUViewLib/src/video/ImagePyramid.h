@@ -0,0 +1,74 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QImage>
+#include <QVector>
+
+/* Downscaled versions (mip levels) of an image for drawing it zoomed out.
+ * Level 0 is the image itself and every further level halves the width and height (2x2 box filter).
+ * If a frame is drawn zoomed out (e.g. an 8K frame fit into a 1080p window), QPainter would
+ * resample the full resolution image on every repaint (panning, moving the split line, ...).
+ * Drawing the level that is closest to (but not smaller than) the screen size touches only about
+ * as many pixels as the screen has.
+ * The levels can be built ahead of time (e.g. while caching) and passed in or are built on demand.
+ */
+class ImagePyramid
+{
+public:
+  // The level to draw for the given zoom factor (the ratio of screen pixels to image pixels). The level
+  // is never smaller than the screen area it is drawn to. Level 0 for zoom factors of 0.5 and above.
+  static int getLevelForZoom(double zoomFactor);
+
+  // Downscale the image by two in both directions (2x2 box filter). For 32 bit images, SSE2 is used where available.
+  // A last odd line or column is dropped.
+  static QImage downscaleByTwo(const QImage &image);
+  // Build the levels 1 to nrLevels of the image. Fewer levels are returned if the image gets too small.
+  static QVector<QImage> buildLevels(const QImage &image, int nrLevels);
+  // The number of bytes of the given number of levels for an image of the given size and bytes per pixel
+  static int64_t getLevelsBytes(const QSize &size, int bytesPerPixel, int nrLevels);
+
+  // Set the image (level 0) and optionally levels that were built ahead of time
+  void setImage(const QImage &image, const QVector<QImage> &levels = {});
+  // Is the pyramid set up for this image (the same image data and not modified since)?
+  bool isForImage(const QImage &image) const { return !image.isNull() && image.cacheKey() == this->image.cacheKey(); }
+  void clear() { this->image = QImage(); this->levels.clear(); }
+
+  // Get the level (building missing levels from the next larger one). If the image is too small for the
+  // level, the smallest level is returned.
+  QImage getLevel(int level);
+
+private:
+  QImage image;
+  QVector<QImage> levels;
+};
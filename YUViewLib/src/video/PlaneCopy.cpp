@@ -0,0 +1,105 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PlaneCopy.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PLANECOPY_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PLANECOPY_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace PlaneCopy
+{
+
+namespace
+{
+
+void narrowLine(const short *src, unsigned char *dst, int width)
+{
+  int x = 0;
+#if PLANECOPY_SSE2
+  // 16 samples per iteration. packus saturates to 0..255.
+  for (; x + 16 <= width; x += 16)
+  {
+    const __m128i a = _mm_loadu_si128((const __m128i*)(src + x));
+    const __m128i b = _mm_loadu_si128((const __m128i*)(src + x + 8));
+    _mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(a, b));
+  }
+#elif PLANECOPY_NEON
+  for (; x + 16 <= width; x += 16)
+  {
+    const int16x8_t a = vld1q_s16(src + x);
+    const int16x8_t b = vld1q_s16(src + x + 8);
+    vst1q_u8(dst + x, vcombine_u8(vqmovun_s16(a), vqmovun_s16(b)));
+  }
+#endif
+  for (; x < width; x++)
+  {
+    const short v = src[x];
+    dst[x] = (unsigned char)((v < 0) ? 0 : (v > 255) ? 255 : v);
+  }
+}
+
+} // namespace
+
+void narrow16BitTo8Bit(const short *src, int srcStride, unsigned char *dst, int dstStride, int width, int height)
+{
+  for (int y = 0; y < height; y++)
+  {
+    narrowLine(src, dst, width);
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+void copy16Bit(const short *src, int srcStride, unsigned short *dst, int dstStride, int width, int height)
+{
+  // The samples of the decoders are never negative, so the bits can be copied directly.
+  if (srcStride == width && dstStride == width)
+  {
+    memcpy(dst, src, size_t(width) * height * 2);
+    return;
+  }
+  for (int y = 0; y < height; y++)
+  {
+    memcpy(dst, src, size_t(width) * 2);
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+} // namespace PlaneCopy
@@ -0,0 +1,51 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+/* Kernels to copy the 16 bit sample planes of a decoder into the YUView raw layout.
+ * The reference decoders (HM, VTM) always keep their samples in 16 bit (short) planes with a stride
+ * (in samples) that is larger than the width. These functions copy such a plane line by line into
+ * a destination with its own stride. SSE2 (x86) or NEON (ARM) is used where available.
+ */
+namespace PlaneCopy
+{
+
+// Copy a plane of 16 bit samples (values must be in the range 0..255) into a plane of 8 bit samples.
+// Values outside of the 8 bit range are clipped.
+void narrow16BitTo8Bit(const short *src, int srcStride, unsigned char *dst, int dstStride, int width, int height);
+
+// Copy a plane of 16 bit samples into a plane of 16 bit samples. If both planes have no padding
+// at the end of the lines, the plane is copied at once.
+void copy16Bit(const short *src, int srcStride, unsigned short *dst, int dstStride, int width, int height);
+
+}
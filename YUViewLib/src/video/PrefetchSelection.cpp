@@ -0,0 +1,80 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrefetchSelection.h"
+
+#include <algorithm>
+
+namespace PrefetchSelection
+{
+
+int getThreadShare(const std::array<Candidate, 2> &candidates, int index, int nrThreads, bool splitPair)
+{
+  if (!splitPair)
+    return nrThreads;
+
+  // If the cost is not known yet, the threads are split equally
+  const double costSum = candidates[0].frameCostMs + candidates[1].frameCostMs;
+  const double share = (costSum > 0.0) ? candidates[index].frameCostMs / costSum : 0.5;
+  return std::max(1, int(nrThreads * share + 0.5));
+}
+
+int selectNextJob(const std::array<Candidate, 2> &candidates, int nrThreads, bool splitPair)
+{
+  if (candidates[0].nrThreadsWorking + candidates[1].nrThreadsWorking >= nrThreads)
+    return -1;
+
+  int next = -1;
+  bool nextBelowShare = false;
+  for (int i = 0; i < 2; i++)
+  {
+    const Candidate &c = candidates[i];
+    if (c.frameIdx == -1)
+      continue;
+
+    const bool belowShare = c.nrThreadsWorking < getThreadShare(candidates, i, nrThreads, splitPair);
+    if (next == -1)
+      next = i;
+    else if (belowShare != nextBelowShare)
+      next = belowShare ? i : next;
+    else if (c.nrFramesAhead != candidates[next].nrFramesAhead)
+      next = (c.nrFramesAhead < candidates[next].nrFramesAhead) ? i : next;
+    else if (c.frameCostMs > candidates[next].frameCostMs)
+      next = i;
+
+    if (next == i)
+      nextBelowShare = belowShare;
+  }
+  return next;
+}
+
+} // namespace PrefetchSelection
@@ -0,0 +1,61 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+
+/* Decide which of the items that are shown during playback the caching threads prefetch next.
+ * If two different items are shown side by side, they share the threads according to how long loading a
+ * frame takes (the slower item gets more threads). This is kept free of any state so that it can be tested.
+ */
+namespace PrefetchSelection
+{
+
+struct Candidate
+{
+  int    frameIdx {-1};        // The next frame to prefetch (-1 if there is none or the item can not take another thread)
+  int    nrFramesAhead {0};    // How far this frame is ahead of the frame in the double buffer
+  int    nrThreadsWorking {0}; // The number of caching threads that work on the item right now
+  double frameCostMs {0.0};    // The average time loading one frame of the item takes (0 if not known yet)
+};
+
+// The number of threads that the item should get if both items share nrThreads
+int getThreadShare(const std::array<Candidate, 2> &candidates, int index, int nrThreads, bool splitPair);
+
+// Select the candidate to prefetch from. Items that did not get their share of the threads yet come first. Then
+// the item that is less far ahead of playback and if both are equally far ahead, the one that is slower to load.
+// nrThreads is the number of threads that may prefetch. splitPair is set if the two items are shown side by side.
+// Return the index of the candidate or -1 if nothing should be prefetched (e.g. all threads are busy).
+int selectNextJob(const std::array<Candidate, 2> &candidates, int nrThreads, bool splitPair);
+
+} // namespace PrefetchSelection
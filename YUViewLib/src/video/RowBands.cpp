@@ -0,0 +1,101 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RowBands.h"
+
+#include <QFuture>
+#include <QList>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+#include "common/ThreadBudget.h"
+
+namespace RowBands
+{
+
+namespace
+{
+
+// A band has at least this many pixels (about half a megapixel for 8K content)
+const int64_t MIN_PIXELS_PER_BAND = 128 * 1024;
+
+} // namespace
+
+QThreadPool *getThreadPool()
+{
+  // The conversions share the thread budget with the decoders
+  static QThreadPool pool;
+  ThreadBudget::instance().limitThreadPool(&pool);
+  return &pool;
+}
+
+int getNrBands(const QSize &frameSize, int rowAlignment)
+{
+  const auto nrPixels = int64_t(frameSize.width()) * frameSize.height();
+  const auto maxBandsBySize = int(nrPixels / MIN_PIXELS_PER_BAND);
+  const auto maxBandsByRows = frameSize.height() / std::max(rowAlignment, 1);
+  return std::max(1, std::min({getThreadPool()->maxThreadCount(), maxBandsBySize, maxBandsByRows}));
+}
+
+void run(int nrRows, int nrBands, int rowAlignment, const std::function<void(int rowBegin, int rowEnd)> &convertRows)
+{
+  if (nrBands <= 1)
+  {
+    convertRows(0, nrRows);
+    return;
+  }
+
+  rowAlignment = std::max(rowAlignment, 1);
+  auto getBandBegin = [nrRows, nrBands, rowAlignment](int band) {
+    if (band >= nrBands)
+      return nrRows;
+    return int(int64_t(nrRows) * band / nrBands) / rowAlignment * rowAlignment;
+  };
+
+  QList<QFuture<void>> futures;
+  for (int band = 1; band < nrBands; band++)
+  {
+    const auto rowBegin = getBandBegin(band);
+    const auto rowEnd = getBandBegin(band + 1);
+    if (rowBegin < rowEnd)
+      futures.append(QtConcurrent::run(getThreadPool(), [&convertRows, rowBegin, rowEnd]() { convertRows(rowBegin, rowEnd); }));
+  }
+
+  // Convert the first band in this thread while the others run in the pool
+  convertRows(0, getBandBegin(1));
+  for (auto &future : futures)
+    future.waitForFinished();
+}
+
+} // namespace RowBands
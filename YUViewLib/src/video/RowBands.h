@@ -0,0 +1,59 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QSize>
+
+#include <functional>
+
+class QThreadPool;
+
+/* Split the conversion of one frame into bands of rows that are converted in parallel.
+ * All conversions (YUV and RGB to image, the scaled YUV conversion, ...) share one thread pool. The calling
+ * thread converts the first band itself while the other bands run in the pool. This way, the latency of
+ * loading a single frame (e.g. when stepping through a sequence) scales with the number of cores.
+ */
+namespace RowBands
+{
+
+// The thread pool that is shared by all row band conversions
+QThreadPool *getThreadPool();
+
+// The number of bands to split a frame of the given size into. Small frames are not split since the overhead
+// of the thread pool would dominate. The band borders are multiples of rowAlignment.
+int getNrBands(const QSize &frameSize, int rowAlignment = 1);
+
+// Call convertRows(rowBegin, rowEnd) for all bands (rowEnd is exclusive) and wait until all bands are done
+void run(int nrRows, int nrBands, int rowAlignment, const std::function<void(int rowBegin, int rowEnd)> &convertRows);
+
+} // namespace RowBands
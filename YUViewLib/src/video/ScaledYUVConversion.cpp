@@ -0,0 +1,236 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ScaledYUVConversion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCALEDYUVCONVERSION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#include "RowBands.h"
+
+namespace ScaledYUVConversion
+{
+
+namespace
+{
+
+// The coefficients are scaled from 16 to 13 bit fractional precision so that they fit into 16 bit for SIMD
+const int COEFF_SHIFT = 13;
+const int COEFF_ROUND = 1 << (COEFF_SHIFT - 1);
+
+struct Coefficients
+{
+  short y, rv, gu, gv, bu;
+};
+
+Coefficients getCoefficients(const int RGBConv[5])
+{
+  auto scale = [](int c) { return short(std::lround(c / double(1 << (16 - COEFF_SHIFT)))); };
+  return {scale(RGBConv[0]), scale(RGBConv[1]), scale(RGBConv[2]), scale(RGBConv[3]), scale(RGBConv[4])};
+}
+
+inline int readSample(const unsigned char *line, int x, bool bigEndian)
+{
+  const auto p = line + 2 * x;
+  return bigEndian ? ((p[0] << 8) | p[1]) : ((p[1] << 8) | p[0]);
+}
+
+inline unsigned char clip8Bit(int val)
+{
+  return (unsigned char)((val < 0) ? 0 : (val > 255) ? 255 : val);
+}
+
+// Read the samples for one output line (8 bit, luma offset and chroma zero already subtracted)
+void readLine(const Source &source, int level, int y, int width, int yOffset, short *lineY, short *lineU, short *lineV)
+{
+  const int srcY = y << level;
+  const auto line0 = source.planes[0] + srcY * source.strides[0];
+  const auto line1 = line0 + source.strides[0];
+  if (source.bitsPerSample > 8)
+  {
+    // Average at full precision and round to 8 bit
+    const int shift = 2 + source.bitsPerSample - 8;
+    const int round = 1 << (shift - 1);
+    for (int x = 0; x < width; x++)
+    {
+      const int srcX = x << level;
+      const int sum = readSample(line0, srcX, source.bigEndian) + readSample(line0, srcX + 1, source.bigEndian) +
+                      readSample(line1, srcX, source.bigEndian) + readSample(line1, srcX + 1, source.bigEndian);
+      lineY[x] = short(((sum + round) >> shift) - yOffset);
+    }
+  }
+  else
+  {
+    for (int x = 0; x < width; x++)
+    {
+      const int srcX = x << level;
+      lineY[x] = short(((line0[srcX] + line0[srcX + 1] + line1[srcX] + line1[srcX + 1] + 2) >> 2) - yOffset);
+    }
+  }
+
+  if (!source.hasChroma)
+  {
+    std::fill(lineU, lineU + width, short(0));
+    std::fill(lineV, lineV + width, short(0));
+    return;
+  }
+
+  const int chromaY = srcY / source.subsamplingVer;
+  const auto lineSrcU = source.planes[1] + chromaY * source.strides[1];
+  const auto lineSrcV = source.planes[2] + chromaY * source.strides[2];
+  if (source.bitsPerSample > 8)
+  {
+    const int shift = source.bitsPerSample - 8;
+    const int round = 1 << (shift - 1);
+    for (int x = 0; x < width; x++)
+    {
+      const int chromaX = (x << level) / source.subsamplingHor;
+      lineU[x] = short(((readSample(lineSrcU, chromaX, source.bigEndian) + round) >> shift) - 128);
+      lineV[x] = short(((readSample(lineSrcV, chromaX, source.bigEndian) + round) >> shift) - 128);
+    }
+  }
+  else
+  {
+    for (int x = 0; x < width; x++)
+    {
+      const int chromaX = (x << level) / source.subsamplingHor;
+      lineU[x] = short(lineSrcU[chromaX] - 128);
+      lineV[x] = short(lineSrcV[chromaX] - 128);
+    }
+  }
+}
+
+#if SCALEDYUVCONVERSION_SSE2
+// Two 16 bit coefficients for _mm_madd_epi16 on interleaved (a, b) samples
+inline __m128i coefficientPair(short a, short b)
+{
+  return _mm_set1_epi32(int((unsigned int)(unsigned short)a | ((unsigned int)(unsigned short)b << 16)));
+}
+
+// Round, shift and saturate two vectors of 4 32 bit values to 8 unsigned 8 bit values (in the lower half)
+inline __m128i packTo8Bit(__m128i lo, __m128i hi, __m128i round)
+{
+  lo = _mm_srai_epi32(_mm_add_epi32(lo, round), COEFF_SHIFT);
+  hi = _mm_srai_epi32(_mm_add_epi32(hi, round), COEFF_SHIFT);
+  return _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+}
+#endif
+
+void convertLine(const short *lineY, const short *lineU, const short *lineV, unsigned char *dst, int width, const Coefficients &c)
+{
+  int x = 0;
+#if SCALEDYUVCONVERSION_SSE2
+  // 8 pixels per iteration
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi32(COEFF_ROUND);
+  const __m128i alpha = _mm_set1_epi8(char(0xff));
+  const __m128i cYRV = coefficientPair(c.y, c.rv);
+  const __m128i cYGU = coefficientPair(c.y, c.gu);
+  const __m128i cYBU = coefficientPair(c.y, c.bu);
+  const __m128i cGV  = coefficientPair(c.gv, 0);
+  for (; x + 8 <= width; x += 8)
+  {
+    const __m128i y = _mm_loadu_si128((const __m128i*)(lineY + x));
+    const __m128i u = _mm_loadu_si128((const __m128i*)(lineU + x));
+    const __m128i v = _mm_loadu_si128((const __m128i*)(lineV + x));
+
+    const __m128i yvLo = _mm_unpacklo_epi16(y, v);
+    const __m128i yvHi = _mm_unpackhi_epi16(y, v);
+    const __m128i yuLo = _mm_unpacklo_epi16(y, u);
+    const __m128i yuHi = _mm_unpackhi_epi16(y, u);
+    const __m128i vLo  = _mm_unpacklo_epi16(v, zero);
+    const __m128i vHi  = _mm_unpackhi_epi16(v, zero);
+
+    const __m128i r = packTo8Bit(_mm_madd_epi16(yvLo, cYRV), _mm_madd_epi16(yvHi, cYRV), round);
+    const __m128i g = packTo8Bit(_mm_add_epi32(_mm_madd_epi16(yuLo, cYGU), _mm_madd_epi16(vLo, cGV)),
+                                 _mm_add_epi32(_mm_madd_epi16(yuHi, cYGU), _mm_madd_epi16(vHi, cGV)), round);
+    const __m128i b = packTo8Bit(_mm_madd_epi16(yuLo, cYBU), _mm_madd_epi16(yuHi, cYBU), round);
+
+    // Interleave to BGRA
+    const __m128i bg = _mm_unpacklo_epi8(b, g);
+    const __m128i ra = _mm_unpacklo_epi8(r, alpha);
+    _mm_storeu_si128((__m128i*)(dst + x * 4), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128((__m128i*)(dst + x * 4 + 16), _mm_unpackhi_epi16(bg, ra));
+  }
+#endif
+  for (; x < width; x++)
+  {
+    const int y = c.y * lineY[x];
+    dst[x * 4    ] = clip8Bit((y + c.bu * lineU[x] + COEFF_ROUND) >> COEFF_SHIFT);
+    dst[x * 4 + 1] = clip8Bit((y + c.gu * lineU[x] + c.gv * lineV[x] + COEFF_ROUND) >> COEFF_SHIFT);
+    dst[x * 4 + 2] = clip8Bit((y + c.rv * lineV[x] + COEFF_ROUND) >> COEFF_SHIFT);
+    dst[x * 4 + 3] = 255;
+  }
+}
+
+} // namespace
+
+QSize getScaledSize(const QSize &frameSize, int level)
+{
+  return QSize(frameSize.width() >> level, frameSize.height() >> level);
+}
+
+void convertRows(const Source &source, int level, const int RGBConv[5], bool fullRange, unsigned char *dst, int dstStride, int rowBegin, int rowEnd)
+{
+  const auto width = getScaledSize(source.frameSize, level).width();
+  if (level <= 0 || width <= 0)
+    return;
+
+  const auto coefficients = getCoefficients(RGBConv);
+  const int yOffset = fullRange ? 0 : 16;
+
+  std::vector<short> lines(size_t(width) * 3);
+  auto lineY = lines.data();
+  auto lineU = lineY + width;
+  auto lineV = lineU + width;
+  for (int y = rowBegin; y < rowEnd; y++)
+  {
+    readLine(source, level, y, width, yOffset, lineY, lineU, lineV);
+    convertLine(lineY, lineU, lineV, dst + y * dstStride, width, coefficients);
+  }
+}
+
+void convert(const Source &source, int level, const int RGBConv[5], bool fullRange, unsigned char *dst, int dstStride, int nrBands)
+{
+  const auto height = getScaledSize(source.frameSize, level).height();
+  RowBands::run(height, nrBands, 1, [&](int rowBegin, int rowEnd) {
+    convertRows(source, level, RGBConv, fullRange, dst, dstStride, rowBegin, rowEnd);
+  });
+}
+
+} // namespace ScaledYUVConversion
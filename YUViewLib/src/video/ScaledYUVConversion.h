@@ -0,0 +1,70 @@
+/*  This file is part of YUView - The YUV player with advanced analytics toolset
+*   <https://github.com/IENT/YUView>
+*   Copyright (C) 2015  Institut für Nachrichtentechnik, RWTH Aachen University, GERMANY
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   In addition, as a special exception, the copyright holders give
+*   permission to link the code of portions of this program with the
+*   OpenSSL library under certain conditions as described in each
+*   individual source file, and distribute linked combinations including
+*   the two.
+*   
+*   You must obey the GNU General Public License in all respects for all
+*   of the code used other than OpenSSL. If you modify file(s) with this
+*   exception, you may extend this exception to your version of the
+*   file(s), but you are not obligated to do so. If you do not wish to do
+*   so, delete this exception statement from your version. If you delete
+*   this exception statement from all source files in the program, then
+*   also delete it here.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QSize>
+
+/* Convert planar YUV directly into a downscaled 32 bit BGRA image (the byte order of the ARGB32 QImage formats
+ * on little endian machines). This is used when a frame is only going to be shown zoomed out (e.g. 8K
+ * playback fit into a small window): Only the source samples that are needed for the output size are read
+ * and no full size RGB image is written and scaled afterwards.
+ * The output is downscaled by 2^level (level > 0). Every output pixel gets the average of the 2x2 luma samples
+ * at its top left corner and the collocated chroma sample. The conversion is done with 13 bit fixed point
+ * coefficients (SSE2 where available) in the 8 bit domain. Higher bit depths are rounded to 8 bit first.
+ */
+namespace ScaledYUVConversion
+{
+
+struct Source
+{
+  // The Y, U and V planes and their strides in bytes. The chroma planes are not read if there is no chroma.
+  const unsigned char *planes[3] {nullptr, nullptr, nullptr};
+  int strides[3] {0, 0, 0};
+  QSize frameSize;
+  bool hasChroma {true};
+  int subsamplingHor {2};
+  int subsamplingVer {2};
+  int bitsPerSample {8};
+  bool bigEndian {false};
+};
+
+// The size of the output for the given frame size and level
+QSize getScaledSize(const QSize &frameSize, int level);
+
+// Convert the output rows rowBegin to rowEnd (exclusive). RGBConv are the coefficients from getColorConversionCoefficients.
+void convertRows(const Source &source, int level, const int RGBConv[5], bool fullRange, unsigned char *dst, int dstStride, int rowBegin, int rowEnd);
+
+// Convert the whole output. The rows are split into bands that are converted in parallel (see RowBands).
+void convert(const Source &source, int level, const int RGBConv[5], bool fullRange, unsigned char *dst, int dstStride, int nrBands);
+
+} // namespace ScaledYUVConversion
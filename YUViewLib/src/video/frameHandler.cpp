@@ -34,6 +34,8 @@
 
 #include <QPainter>
 
+#include <algorithm>
+
 #include "common/functions.h"
 #include "playlistitem/playlistItem.h"
 
@@ -189,7 +191,7 @@ void frameHandler::drawFrame(QPainter *painter, double zoomFactor, bool drawRawV
   videoRect.moveCenter(QPoint(0,0));
 
   // Draw the current image (currentFrame)
-  painter->drawImage(videoRect, currentImage);
+  drawCurrentImage(painter, videoRect, zoomFactor);
 
   if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
   {
@@ -198,6 +200,21 @@ void frameHandler::drawFrame(QPainter *painter, double zoomFactor, bool drawRawV
   }
 }
 
+void frameHandler::drawCurrentImage(QPainter *painter, const QRect &videoRect, double zoomFactor)
+{
+  // Let QPainter scale an image that has about as many pixels as the screen area instead of the full image
+  const auto level = std::max(ImagePyramid::getLevelForZoom(zoomFactor * painter->device()->devicePixelRatioF()) - currentImageScaleLevel, 0);
+  if (level == 0)
+  {
+    painter->drawImage(videoRect, currentImage);
+    return;
+  }
+
+  if (!currentImagePyramid.isForImage(currentImage))
+    currentImagePyramid.setImage(currentImage);
+  painter->drawImage(videoRect, currentImagePyramid.getLevel(level));
+}
+
 void frameHandler::drawPixelValues(QPainter *painter, const int frameIdx, const QRect &videoRect, const double zoomFactor, frameHandler *item2, const bool markDifference, const int frameIdxItem1)
 {
   // Draw the pixel values onto the pixels
@@ -228,6 +245,9 @@ void frameHandler::drawPixelValues(QPainter *painter, const int frameIdx, const
   // This QRect has the size of one pixel and is moved on top of each pixel to draw the text
   QRect pixelRect;
   pixelRect.setSize(QSize(zoomFactor, zoomFactor));
+  const int formatBase = settings.value("ShowPixelValuesHex").toBool() ? 16 : 10;
+  // All values are collected and drawn from the glyph atlas in one batch
+  pixelValueGlyphs.begin(painter);
   for (int x = xMin; x <= xMax; x++)
   {
     for (int y = yMin; y <= yMax; y++)
@@ -239,8 +259,7 @@ void frameHandler::drawPixelValues(QPainter *painter, const int frameIdx, const
       // Get the text to show
       bool drawWhite = false;
       QRgb pixVal;
-      QString valText;
-      const int formatBase = settings.value("ShowPixelValuesHex").toBool() ? 16 : 10;
+      GlyphAtlas::Text valText;
       if (item2 != nullptr)
       {
         QRgb pixel1 = getPixelVal(x, y);
@@ -250,10 +269,6 @@ void frameHandler::drawPixelValues(QPainter *painter, const int frameIdx, const
         int dG = int(qGreen(pixel1)) - int(qGreen(pixel2));
         int dB = int(qBlue(pixel1)) - int(qBlue(pixel2));
 
-        const QString RString = ((dR < 0) ? "-" : "") + QString::number(std::abs(dR), formatBase);
-        const QString GString = ((dG < 0) ? "-" : "") + QString::number(std::abs(dG), formatBase);
-        const QString BString = ((dB < 0) ? "-" : "") + QString::number(std::abs(dB), formatBase);
-
         if (markDifference)
           drawWhite = (dR == 0 && dG == 0 && dB == 0);
         else
@@ -264,73 +279,71 @@ void frameHandler::drawPixelValues(QPainter *painter, const int frameIdx, const
           pixVal = qRgb(r,g,b);
           drawWhite = (qRed(pixVal) < 128 && qGreen(pixVal) < 128 && qBlue(pixVal) < 128);
         }
-        valText = QString("R%1\nG%2\nB%3").arg(RString, GString, BString);
+        valText.addValue('R', dR, formatBase);
+        valText.addValue('G', dG, formatBase);
+        valText.addValue('B', dB, formatBase);
       }
       else
       {
         pixVal = getPixelVal(x, y);
         drawWhite = (qRed(pixVal) < 128 && qGreen(pixVal) < 128 && qBlue(pixVal) < 128);
-        valText = QString("R%1\nG%2\nB%3").arg(qRed(pixVal), 0, formatBase).arg(qGreen(pixVal), 0, formatBase).arg(qBlue(pixVal), 0, formatBase);
+        valText.addValue('R', qRed(pixVal), formatBase);
+        valText.addValue('G', qGreen(pixVal), formatBase);
+        valText.addValue('B', qBlue(pixVal), formatBase);
       }
       
-      painter->setPen(drawWhite ? Qt::white : Qt::black);
-      painter->drawText(pixelRect, Qt::AlignCenter, valText);
+      pixelValueGlyphs.addText(pixelRect, valText, drawWhite);
     }
   }
+  pixelValueGlyphs.end(painter);
 }
 
-QImage frameHandler::calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference)
+QImage frameHandler::calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks)
 {
   Q_UNUSED(frameIdxItem0);
   Q_UNUSED(frameIdxItem1);
 
-  int width  = qMin(frameSize.width(), item2->frameSize.width());
-  int height = qMin(frameSize.height(), item2->frameSize.height());
+  return calculateImageDifference(currentImage, item2->currentImage, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
+}
 
-  QImage diffImg(width, height, functions::platformImageFormat());
+QImage frameHandler::calculateDifferenceForCaching(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks)
+{
+  const QImage image0 = loadImageForCaching(frameIdxItem0);
+  const QImage image1 = item2->loadImageForCaching(frameIdxItem1);
+  if (image0.isNull() || image1.isNull())
+    return QImage();
 
-  // Also calculate the MSE while we're at it (R,G,B)
-  int64_t mseAdd[3] = {0, 0, 0};
+  return calculateImageDifference(image0, image1, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
+}
 
-  for (int y = 0; y < height; y++)
-  {
-    for (int x = 0; x < width; x++)
-    {
-      QRgb pixel1 = getPixelVal(x, y);
-      QRgb pixel2 = item2->getPixelVal(x, y);
+namespace
+{
 
-      int dR = int(qRed(pixel1)) - int(qRed(pixel2));
-      int dG = int(qGreen(pixel1)) - int(qGreen(pixel2));
-      int dB = int(qBlue(pixel1)) - int(qBlue(pixel2));
+bool isRGB32Format(QImage::Format format)
+{
+  return format == QImage::Format_RGB32 || format == QImage::Format_ARGB32 || format == QImage::Format_ARGB32_Premultiplied;
+}
 
-      int r, g, b;
-      if (markDifference)
-      {
-        r = (dR != 0) ? 255 : 0;
-        g = (dG != 0) ? 255 : 0;
-        b = (dB != 0) ? 255 : 0;
-      }
-      else if (amplificationFactor != 1)
-      {  
-        r = clip(128 + dR * amplificationFactor, 0, 255);
-        g = clip(128 + dG * amplificationFactor, 0, 255);
-        b = clip(128 + dB * amplificationFactor, 0, 255);
-      }
-      else
-      {  
-        r = clip(128 + dR, 0, 255);
-        g = clip(128 + dG, 0, 255);
-        b = clip(128 + dB, 0, 255);
-      }
-      
-      mseAdd[0] += dR * dR;
-      mseAdd[1] += dG * dG;
-      mseAdd[2] += dB * dB;
+} // namespace
 
-      QRgb val = qRgb(r, g, b);
-      diffImg.setPixel(x, y, val);
-    }
-  }
+QImage frameHandler::calculateImageDifference(const QImage &image0, const QImage &image1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks)
+{
+  const int width  = qMin(image0.width(), image1.width());
+  const int height = qMin(image0.height(), image1.height());
+
+  // The kernel works on 32 bit pixels. The alpha of all these formats is 255 after the difference.
+  const QImage input0 = isRGB32Format(image0.format()) ? image0 : image0.convertToFormat(QImage::Format_RGB32);
+  const QImage input1 = isRGB32Format(image1.format()) ? image1 : image1.convertToFormat(QImage::Format_RGB32);
+  const auto platformFormat = functions::platformImageFormat();
+  QImage diffImg(width, height, isRGB32Format(platformFormat) ? platformFormat : QImage::Format_RGB32);
+
+  // Also calculate the MSE while we're at it (R,G,B)
+  int64_t mseAdd[3] = {0, 0, 0};
+  DifferenceKernels::subtractRGB32(input0.constBits(), input0.bytesPerLine(), input1.constBits(), input1.bytesPerLine(), width, height, markDifference ? 1 : amplificationFactor, markDifference, diffImg.bits(), diffImg.bytesPerLine(), mseAdd);
+
+  // A component without difference is 0 (if differences are marked) or 128
+  differenceBlocks.reset(QSize(width, height));
+  differenceBlocks.markPlane(diffImg.constBits(), diffImg.bytesPerLine(), width, height, 4, markDifference ? 0 : 0x808080, 0xffffff);
 
   differenceInfoList.append(infoItem("Difference Type","RGB"));
   
@@ -344,6 +357,8 @@ QImage frameHandler::calculateDifference(frameHandler *item2, const int frameIdx
   differenceInfoList.append(infoItem("MSE B",QString("%1").arg(mse[2])));
   differenceInfoList.append(infoItem("MSE All",QString("%1").arg(mse[3])));
 
+  if (diffImg.format() != platformFormat)
+    return diffImg.convertToFormat(platformFormat);
   return diffImg;
 }
 
@@ -38,6 +38,9 @@
 
 #include "common/saveUi.h"
 #include "common/typedef.h"
+#include "video/DifferenceKernels.h"
+#include "video/GlyphAtlas.h"
+#include "video/ImagePyramid.h"
 
 #include "ui_frameHandler.h"
 
@@ -84,7 +87,11 @@ public:
   // Calculate the difference of this frameHandler to another frameHandler. This
   // function can be overloaded by more specialized video items. For example the videoHandlerYUV
   // overloads this and calculates the difference directly on the YUV values (if possible).
-  virtual QImage calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference);
+  // The 4x4 blocks that contain a difference are marked in differenceBlocks.
+  virtual QImage calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks);
+  // Same as calculateDifference but the frames are loaded like frames for the cache. The currently loaded frames
+  // (and raw data) of the two items are not changed, so this can be called from the caching threads.
+  virtual QImage calculateDifferenceForCaching(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks);
   
   // Create the frame controls and return a pointer to the layout. This can be used by
   // inherited classes to create a properties widget.
@@ -114,6 +121,21 @@ protected:
 
   QImage currentImage;
   QSize  frameSize;
+  // The currentImage may be downscaled by 2^currentImageScaleLevel (e.g. while playing zoomed out)
+  int    currentImageScaleLevel {0};
+
+  // Draw the currentImage into the videoRect. When zoomed out, a downscaled level of the image is drawn.
+  void drawCurrentImage(QPainter *painter, const QRect &videoRect, double zoomFactor);
+  // The downscaled levels of the currentImage. They are updated when a different image is drawn.
+  ImagePyramid currentImagePyramid;
+
+  // The pixel values (drawPixelValues) are drawn from pre-rendered glyphs
+  GlyphAtlas pixelValueGlyphs;
+
+  // Calculate the RGB difference of two images (see calculateDifference)
+  static QImage calculateImageDifference(const QImage &image0, const QImage &image1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks);
+  // Get the image of the given frame without changing the currentImage. This is called from the caching threads.
+  virtual QImage loadImageForCaching(int frameIdx) { Q_UNUSED(frameIdx); return currentImage; }
 
   // Get the pixel value from currentImage. Make sure that currentImage is the correct image.
   QRgb getPixelVal(const QPoint &pos)    { return getPixelVal(pos.x(), pos.y()); }
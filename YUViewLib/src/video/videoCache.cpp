@@ -36,12 +36,16 @@
 #include <QMessageBox>
 #include <QPainter>
 #include <QScrollArea>
+#include <QSet>
 #include <QSettings>
 #include <QThread>
 
+#include "common/FrameProfiler.h"
 #include "common/functions.h"
+#include "common/ThreadBudget.h"
 #include "ui/playbackController.h"
 #include "playlistitem/playlistItem.h"
+#include "video/PrefetchSelection.h"
 
 // This debug setting has two values:
 // 1: Basic operation is written to qDebug: If a new item is selected, what is the decision to cache/remove next?
@@ -69,6 +73,12 @@
 #define DEBUG_JOBS(fmt,...) ((void)0)
 #endif
 
+// The minimum number of frames (after the one in the double buffer) of both items that are prefetched when two items
+// are played side by side
+#define SPLITVIEW_PREFETCH_NR_FRAMES 8
+// The weight of a new measurement in the average loading time of an item
+#define FRAME_COST_UPDATE_WEIGHT 0.2
+
 /// ------------------------ loadingWorker ------------------------
 
 class loadingWorker : public QObject
@@ -78,9 +88,13 @@ public:
   loadingWorker(QObject *parent) : QObject(parent) { currentCacheItem = nullptr; working = false; id = id_counter++; }
   playlistItem *getCacheItem() { return currentCacheItem; }
   int getCacheFrame() { return currentFrame; }
+  // The item of the last job that was processed and how long processing it took (not set in test mode)
+  playlistItem *getLastJobItem() { return lastJobItem; }
+  qint64 getLastJobDuration() { return lastJobDurationNs; }
   void setJob(playlistItem *item, int frame, bool test=false);
   void setWorking(bool state) { working = state; }
   bool isWorking() { return working; }
+  int getId() { return id; }
   QString getStatus() { return QString("T%1: %2").arg(id).arg(working ? QString::number(currentFrame) : QString("-")); }
   // Process the job in the thread that this worker was moved to. This function can be directly
   // called from the main thread. It will still process the call in the separate thread.
@@ -96,6 +110,8 @@ private:
   int currentFrame;
   bool working;
   bool testMode;
+  playlistItem *lastJobItem {nullptr};
+  qint64 lastJobDurationNs {0};
   int id;   // A static ID of the thread. Only used in getStatus().
   static int id_counter;
 };
@@ -131,7 +147,12 @@ void loadingWorker::processCacheJobInternal()
 
   // Just cache the frame that was given to us.
   // This is performed in the thread that this worker is currently placed in.
+  FRAME_PROFILER_SCOPE("Cache frame", currentFrame);
+  QElapsedTimer jobTimer;
+  jobTimer.start();
   currentCacheItem->cacheFrame(currentFrame, testMode);
+  lastJobItem = testMode ? nullptr : currentCacheItem;
+  lastJobDurationNs = jobTimer.nsecsElapsed();
   
   currentCacheItem = nullptr;
   DEBUG_JOBS("loadingWorker::processCacheJobInternal emit loadingFinished");
@@ -147,7 +168,12 @@ void loadingWorker::processLoadingJobInternal(bool playing, bool loadRawData)
 
   // Load the frame of the item that was given to us.
   // This is performed in the thread (the loading thread with higher priority.
+  FRAME_PROFILER_SCOPE("Load frame", currentFrame);
+  QElapsedTimer jobTimer;
+  jobTimer.start();
   currentCacheItem->loadFrame(currentFrame, playing, loadRawData);
+  lastJobItem = currentCacheItem;
+  lastJobDurationNs = jobTimer.nsecsElapsed();
 
   currentCacheItem = nullptr;
   emit loadingFinished();
@@ -203,6 +229,7 @@ videoCache::videoCache(PlaylistTreeWidget *playlistTreeWidget, PlaybackControlle
   for (int i=0; i<2; i++)
   {
     interactiveThread[i] = new loadingThread(this);
+    interactiveThread[i]->setObjectName(QString("Interactive T%1").arg(interactiveThread[i]->worker()->getId()));
     interactiveThread[i]->start(QThread::HighPriority);
     connect(interactiveThread[i]->worker(), &loadingWorker::loadingFinished, this, &videoCache::interactiveLoaderFinished);
 
@@ -257,6 +284,7 @@ void videoCache::startWorkerThreads(int nrThreads)
   for (int i = 0; i < nrThreads; i++)
   {
     loadingThread *newThread = new loadingThread(this);
+    newThread->setObjectName(QString("Caching T%1").arg(newThread->worker()->getId()));
     cachingThreadList.append(newThread);
 
     // Caching should run in the background without interrupting normal operation. Start with lowest priority.
@@ -283,20 +311,21 @@ void videoCache::updateSettings()
   cachingEnabled = settings.value("Enabled", true).toBool();
   cacheLevelMax = (int64_t)settings.value("ThresholdValueMB", 49).toUInt() * 1000 * 1000;
 
-  // See if the user changed the number of threads
-  int targetNrThreads = functions::getOptimalThreadCount();
-  if (settings.value("SetNrThreads", false).toBool())
-    targetNrThreads = settings.value("NrThreads", targetNrThreads).toInt();
-  if (targetNrThreads <= 0)
-    targetNrThreads = 1;
-  if (!cachingEnabled)
-    targetNrThreads = 0;
+  // See if the user changed the number of threads. The thread budget also distributes the threads
+  // between the decoders (their share is updated when they allocate a new decoder).
+  ThreadBudget::instance().updateSettings();
+  int targetNrThreads = ThreadBudget::instance().getNrCachingThreads();
 
   // How many threads should be used when playback is running?
   if (settings.value("PlaybackCachingEnabled", false).toBool())
     nrThreadsPlayback = settings.value("PlaybackCachingThreadLimit", 1).toInt();
   else
     nrThreadsPlayback = 0;
+  // How many threads may prefetch the next frames of the shown items while playback is running?
+  if (settings.value("PlaybackPrefetchEnabled", false).toBool())
+    nrThreadsPrefetch = settings.value("PlaybackPrefetchThreadLimit", functions::getOptimalThreadCount()).toInt();
+  else
+    nrThreadsPrefetch = 0;
 
   if (targetNrThreads > cachingThreadList.count())
     // Create new threads
@@ -366,6 +395,30 @@ void videoCache::loadFrame(playlistItem * item, int frameIndex, int loadingSlot)
   }
 }
 
+void videoCache::prefetchPlaybackFrames(playlistItem *item0, playlistItem *item1)
+{
+  prefetchItem[0] = item0;
+  prefetchItem[1] = item1;
+
+  if (!cachingEnabled || testMode || (workersState != workersIdle && workersState != workersRunning))
+    // If the workers are interrupted, the jobs are pushed again when they restart
+    return;
+
+  // Push prefetch jobs to all caching threads that are currently not working
+  bool jobStarted = false;
+  for (loadingThread *t : cachingThreadList)
+    if (!t->worker()->isWorking())
+      jobStarted |= pushNextJobToCachingThread(t);
+
+  if (jobStarted && workersState == workersIdle)
+  {
+    workersState = workersRunning;
+    if (!statusUpdateTimer.isActive())
+      statusUpdateTimer.start(100);
+    DEBUG_CACHING_DETAIL("videoCache::prefetchPlaybackFrames started prefetching");
+  }
+}
+
 void videoCache::interactiveLoaderFinished()
 {
   // Get the thread that caused this call
@@ -374,6 +427,8 @@ void videoCache::interactiveLoaderFinished()
   int threadID = (interactiveThread[0]->worker() == worker) ? 0 : 1;
   assert(worker == interactiveThread[0]->worker() || worker == interactiveThread[1]->worker());
 
+  updateItemFrameCost(worker->getLastJobItem(), worker->getLastJobDuration());
+
   // Check the list of items that are scheduled for deletion. Because a loading thread finished, maybe now we can delete the item(s).
   for (auto it = itemsToDelete.begin(); it != itemsToDelete.end();)
   {
@@ -566,43 +621,48 @@ void videoCache::updateCacheQueue()
     // Go through the playlist starting with the currently selected item.
     // Add as much of all items as possible. When the cache is full, mark the remaining frames as "can be
     // deleted"
-    int i = itemPos;
+    // If the view is split, the second selected item is played at the same time so it comes right after the first one.
+    QList<playlistItem*> playOrder;
+    for (int i = 0; i < allItems.count(); i++)
+      playOrder.append(allItems[(itemPos + i) % allItems.count()]);
+    if (splitView->isSplitting() && selection[1] && selection[1] != selection[0] && playOrder.removeOne(selection[1]))
+      playOrder.insert(1, selection[1]);
     int64_t newCacheLevel = 0;
 
     // We start in "adding" mode where items are added. If the cache is full, we switch to "deleting" mode where
     // all frames of all items are removed. This is done for all items in the playlist.
     bool adding = true;
-    do
+    for (playlistItem *item : playOrder)
     {
-      if (allItems[i]->isIndexedByFrame())
+      if (item->isIndexedByFrame())
       {
         // How much space do we need to cache the current item?
-        indexRange itemRange = allItems[i]->getFrameIdxRange();
-        int64_t itemCacheSize = (itemRange.second - itemRange.first + 1) * int64_t(allItems[i]->getCachingFrameSize());
+        indexRange itemRange = item->getFrameIdxRange();
+        int64_t itemCacheSize = (itemRange.second - itemRange.first + 1) * int64_t(item->getCachingFrameSize());
 
-        if (adding && allItems[i]->isCachable())
+        if (adding && item->isCachable())
         {
           if (newCacheLevel + itemCacheSize <= cacheLevelMax)
           {
             // All frames of the item fit and there is even more space. We remain in "adding" mode.
-            enqueueCacheJob(allItems[i], itemRange);
+            enqueueCacheJob(item, itemRange);
             newCacheLevel += itemCacheSize;
           }
           else
           {
             // Not all frames fit. Enqueue the ones that fit and set the ones that don't as "can be deleted".
             int64_t availableSpace = cacheLevelMax - newCacheLevel;
-            int64_t nrFramesCachable = availableSpace / allItems[i]->getCachingFrameSize() + 1;
+            int64_t nrFramesCachable = availableSpace / item->getCachingFrameSize() + 1;
 
             // These frames should be added...
             indexRange addFrames = indexRange(itemRange.first, itemRange.first + nrFramesCachable - 1);
-            enqueueCacheJob(allItems[i], addFrames);
-            newCacheLevel += nrFramesCachable * allItems[i]->getCachingFrameSize();
+            enqueueCacheJob(item, addFrames);
+            newCacheLevel += nrFramesCachable * item->getCachingFrameSize();
             // ... and the rest should be removed (if they are cached)
-            QList<int> cachedFrames = allItems[i]->getCachedFrames();
+            QList<int> cachedFrames = item->getCachedFrames();
             for (int f : cachedFrames)
               if (f < addFrames.first || f > addFrames.second)
-                cacheDeQueue.enqueue(plItemFrame(allItems[i], f));
+                cacheDeQueue.enqueue(plItemFrame(item, f));
 
             // The cache is now full. We switch to "deleting" mode.
             adding = false;
@@ -611,17 +671,12 @@ void videoCache::updateCacheQueue()
         else
         {
           // Enqueue all frames (that are cached) from the item as "can be deleted".
-          QList<int> cachedFrames = allItems[i]->getCachedFrames();
+          QList<int> cachedFrames = item->getCachedFrames();
           for (int f : cachedFrames)
-            cacheDeQueue.enqueue(plItemFrame(allItems[i], f));
+            cacheDeQueue.enqueue(plItemFrame(item, f));
         }
       }
-
-      // Goto the next item in the list
-      i++;
-      if (i >= allItems.count())
-        i = 0;
-    } while (i != itemPos);
+    }
 
     // Done. However, the list of frames that can be deleted is sorted the wrong way around. Reverse it.
     std::reverse(cacheDeQueue.begin(), cacheDeQueue.end());
@@ -922,6 +977,7 @@ void videoCache::threadCachingFinished()
   loadingWorker *worker = dynamic_cast<loadingWorker*>(sender);
   Q_ASSERT_X(worker->isWorking(), Q_FUNC_INFO, "The worker that just finished was not working?");
   worker->setWorking(false);
+  updateItemFrameCost(worker->getLastJobItem(), worker->getLastJobDuration());
   DEBUG_CACHING_DETAIL("videoCache::threadCachingFinished - state %d - worker %p", workersState, worker);
 
   // Check if all threads have stopped.
@@ -1105,27 +1161,114 @@ void videoCache::threadCachingFinished()
   DEBUG_CACHING_DETAIL("videoCache::threadCachingFinished - new state %d", workersState);
 }
 
-bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
+void videoCache::updateItemFrameCost(playlistItem *item, qint64 durationNs)
 {
-  if ((cacheQueue.isEmpty() && !testMode) || thread->isQuitting())
-    // No more jobs in the cache queue or the thread does not accept new jobs.
+  if (item == nullptr || itemsToDelete.contains(item))
+    return;
+
+  const double durationMs = double(durationNs) / 1000000.0;
+  auto it = itemFrameCostMs.find(item);
+  if (it == itemFrameCostMs.end())
+    itemFrameCostMs.insert(item, durationMs);
+  else
+    *it = (1.0 - FRAME_COST_UPDATE_WEIGHT) * (*it) + FRAME_COST_UPDATE_WEIGHT * durationMs;
+}
+
+bool videoCache::getNextPrefetchJob(playlistItem *&item, int &frameIdx)
+{
+  if (!playback->playing() || watchingItem != nullptr || nrThreadsPrefetch == 0)
     return false;
+  // Two different items that are shown next to each other are always prefetched. Other items only if they ask for it.
+  const bool splitPair = !prefetchItem[0].isNull() && !prefetchItem[1].isNull() && prefetchItem[0] != prefetchItem[1];
 
-  if (testMode)
+  // The frame after the current one is loaded into the double buffer by the interactive threads.
+  // We prefetch the frames after that one.
+  const int direction = playback->playingReverse() ? -1 : 1;
+  const int currentFrame = playback->getCurrentFrame();
+
+  // Only the configured number of threads may prefetch
+  int nrThreads = 0;
+  for (loadingThread *t : cachingThreadList)
+    if (!t->isQuitting())
+      nrThreads++;
+  nrThreads = std::min(nrThreads, nrThreadsPrefetch);
+
+  // The read ahead window of the items must fit into the cache together. Otherwise the frames that are
+  // prefetched would push out the ones that are not played yet and prefetching stalls once the cache is full.
+  int64_t bytesPerFrame = 0;
+  for (int i = 0; i < 2; i++)
+    if (prefetchItem[i] != nullptr && (i == 0 || prefetchItem[1] != prefetchItem[0]))
+      bytesPerFrame += prefetchItem[i]->getCachingFrameSize();
+  const int64_t nrFramesFitInCache = (bytesPerFrame > 0) ? cacheLevelMax / bytesPerFrame : INT_MAX;
+
+  std::array<PrefetchSelection::Candidate, 2> candidates;
+  for (int i = 0; i < 2; i++)
   {
-    Q_ASSERT_X(testItem, Q_FUNC_INFO, "Test item invalid");
-    indexRange r = testItem->getFrameIdxRange();
-    int frameNr = clip((1000-testLoopCount) % (r.second - r.first) + r.first, r.first, r.second);
-    if (frameNr < 0)
-      frameNr = 0;
-    thread->worker()->setJob(testItem, frameNr, true);
-    thread->worker()->setWorking(true);
-    thread->worker()->processCacheJob();
-    DEBUG_CACHING_DETAIL("videoCache::pushNextJobToCachingThread - %d of %s", frameNr, testItem->getName().toStdString().c_str());
-    testLoopCount--;
-    return true;
+    playlistItem *plItem = prefetchItem[i];
+    if (plItem == nullptr || (i == 1 && plItem == prefetchItem[0]))
+      continue;
+
+    // How many threads are currently caching the item?
+    for (loadingThread *t : cachingThreadList)
+      if (t->worker()->isWorking() && t->worker()->getCacheItem() == plItem)
+        candidates[i].nrThreadsWorking++;
+    candidates[i].frameCostMs = itemFrameCostMs.value(plItem, 0.0);
+
+    if (plItem->taggedForDeletion() || !plItem->isCachable() || !plItem->isIndexedByFrame())
+      continue;
+    int nrFramesToPrefetch = plItem->getPlaybackReadAheadFrames();
+    if (splitPair)
+      nrFramesToPrefetch = std::max(nrFramesToPrefetch, SPLITVIEW_PREFETCH_NR_FRAMES);
+    nrFramesToPrefetch = int(std::min(int64_t(nrFramesToPrefetch), nrFramesFitInCache));
+    if (nrFramesToPrefetch <= 0)
+      continue;
+    const int threadLimit = plItem->cachingThreadLimit();
+    if (threadLimit != -1 && candidates[i].nrThreadsWorking >= threadLimit)
+      continue;
+
+    // Find the first frame that is neither cached nor being loaded/cached right now
+    const indexRange range = plItem->getFrameIdxRange();
+    QSet<int> cachedFrames;
+    for (int f : plItem->getCachedFrames())
+      cachedFrames.insert(f);
+    for (int k = 2; k < nrFramesToPrefetch + 2; k++)
+    {
+      const int f = currentFrame + k * direction;
+      if (f < range.first || f > range.second)
+        break;
+
+      bool frameInFlight = cachedFrames.contains(f);
+      for (loadingThread *t : cachingThreadList)
+        if (t->worker()->isWorking() && t->worker()->getCacheItem() == plItem && t->worker()->getCacheFrame() == f)
+          frameInFlight = true;
+      for (int j = 0; j < 2; j++)
+        if (interactiveThread[j]->worker()->getCacheItem() == plItem && interactiveThread[j]->worker()->getCacheFrame() == f)
+          frameInFlight = true;
+
+      if (!frameInFlight)
+      {
+        candidates[i].frameIdx = f;
+        candidates[i].nrFramesAhead = k - 2;
+        break;
+      }
+    }
   }
 
+  const int next = PrefetchSelection::selectNextJob(candidates, nrThreads, splitPair);
+  if (next == -1)
+    return false;
+
+  item = prefetchItem[next];
+  frameIdx = candidates[next].frameIdx;
+  DEBUG_CACHING_DETAIL("videoCache::getNextPrefetchJob - %d of item %d (%d frames ahead, %f ms per frame)", frameIdx, next, candidates[next].nrFramesAhead, candidates[next].frameCostMs);
+  return true;
+}
+
+bool videoCache::getNextQueuedJob(playlistItem *&item, int &frameIdx)
+{
+  if (cacheQueue.isEmpty())
+    return false;
+
   // If playback is running and playback is not waiting for a specific item to cache,
   // only start caching of a new job if caching is enabled while playback is running.
   if (playback->playing() && watchingItem == nullptr)
@@ -1139,7 +1282,7 @@ bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
       if (nrThreadsPlayback == 0)
       {
         // No caching while playback is running
-        DEBUG_CACHING_DETAIL("videoCache::pushNextJobToCachingThread no new job started nrThreadsPlayback=0");
+        DEBUG_CACHING_DETAIL("videoCache::getNextQueuedJob no new job started nrThreadsPlayback=0");
         return false;
       }
 
@@ -1155,15 +1298,13 @@ bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
       {
         // The maximum number (or more) of threads are already working.
         // Do not start another one.
-        DEBUG_CACHING_DETAIL("videoCache::pushNextJobToCachingThread no new job started nrThreadsPlayback=%d threadsWorking=%d", nrThreadsPlayback, threadsWorking);
+        DEBUG_CACHING_DETAIL("videoCache::getNextQueuedJob no new job started nrThreadsPlayback=%d threadsWorking=%d", nrThreadsPlayback, threadsWorking);
         return false;
       }
     }
   }
 
   QMutableListIterator<cacheJob> j(cacheQueue);
-  playlistItem *plItem = nullptr;
-  indexRange range;
   while (j.hasNext())
   {
     cacheJob &job = j.next();
@@ -1186,30 +1327,90 @@ bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
           continue;
       }
 
-      // We can start another thread for this item
-      plItem = job.plItem;
-      range = job.frameRange;
+      // We can start another thread for this item. Cache the first frame of it.
+      item = job.plItem;
+      frameIdx = job.frameRange.first;
 
       // Check if this is the last frame to cache in the item 
-      if (range.first == range.second)
+      if (job.frameRange.first == job.frameRange.second)
         j.remove();
       else
         // Update the frame range of the head item in the cache queue
-        job.frameRange.first = range.first + 1;
+        job.frameRange.first++;
 
-      break;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool videoCache::removePlayedPrefetchFrames(int64_t nrBytes)
+{
+  const int direction = playback->playingReverse() ? -1 : 1;
+  const int currentFrame = playback->getCurrentFrame();
+  for (int i = 0; i < 2 && nrBytes > 0; i++)
+  {
+    playlistItem *plItem = prefetchItem[i];
+    if (plItem == nullptr || (i == 1 && plItem == prefetchItem[0]))
+      continue;
+
+    // Sort the frames by their distance to the current frame (negative if playback already passed them)
+    QList<int> cachedFrames = plItem->getCachedFrames();
+    std::sort(cachedFrames.begin(), cachedFrames.end(), [currentFrame, direction](int a, int b) {
+      return (a - currentFrame) * direction < (b - currentFrame) * direction;
+    });
+
+    const int64_t frameSize = plItem->getCachingFrameSize();
+    for (int frameIdx : cachedFrames)
+    {
+      if ((frameIdx - currentFrame) * direction >= 0 || nrBytes <= 0)
+        break;
+
+      DEBUG_CACHING_DETAIL("videoCache::removePlayedPrefetchFrames Remove frame %d of %s", frameIdx, plItem->getName().toStdString().c_str());
+      // The frame may also be in the dequeue. It must not be removed twice.
+      cacheDeQueue.removeAll(plItemFrame(plItem, frameIdx));
+      plItem->removeFrameFromCache(frameIdx);
+      cacheLevelCurrent -= frameSize;
+      nrBytes -= frameSize;
     }
   }
-  if (plItem == nullptr)
+  return nrBytes <= 0;
+}
+
+bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
+{
+  if (thread->isQuitting())
+    // The thread does not accept new jobs.
+    return false;
+
+  if (testMode)
+  {
+    Q_ASSERT_X(testItem, Q_FUNC_INFO, "Test item invalid");
+    indexRange r = testItem->getFrameIdxRange();
+    int frameNr = clip((1000-testLoopCount) % (r.second - r.first) + r.first, r.first, r.second);
+    if (frameNr < 0)
+      frameNr = 0;
+    thread->worker()->setJob(testItem, frameNr, true);
+    thread->worker()->setWorking(true);
+    thread->worker()->processCacheJob();
+    DEBUG_CACHING_DETAIL("videoCache::pushNextJobToCachingThread - %d of %s", frameNr, testItem->getName().toStdString().c_str());
+    testLoopCount--;
+    return true;
+  }
+
+  // The frames of the items that are played side by side come first. These would have to be loaded by the
+  // interactive threads anyways, so they are not restricted by the number of threads to use while playback is running.
+  playlistItem *plItem = nullptr;
+  int frameToCache = -1;
+  const bool prefetchJob = getNextPrefetchJob(plItem, frameToCache);
+  if (!prefetchJob && !getNextQueuedJob(plItem, frameToCache))
     // No item found that we can start another caching thread for.
     return false;
 
   // Get the size of one frame in bytes
   unsigned int frameSize = plItem->getCachingFrameSize();
 
-  // We found an item that we can cache. Cache the first frame of it.
-  int frameToCache = range.first;
-
   // First check if we need to free up space to cache this frame.
   while (cacheLevelCurrent + frameSize >= cacheLevelMax && !cacheDeQueue.isEmpty())
   {
@@ -1221,6 +1422,11 @@ bool videoCache::pushNextJobToCachingThread(loadingThread *thread)
     cacheLevelCurrent -= frameToRemoveSize;
   }
 
+  // While prefetching, the frames that were already played make room for the next ones. Otherwise prefetching
+  // would stop for good once the cache is full.
+  if (prefetchJob && cacheLevelCurrent + frameSize > cacheLevelMax)
+    removePlayedPrefetchFrames(cacheLevelCurrent + frameSize - cacheLevelMax);
+
   if (cacheDeQueue.isEmpty() && cacheLevelCurrent + frameSize > cacheLevelMax)
   {
     // There is still not enough space but there are no more frames that we can remove.
@@ -1251,6 +1457,8 @@ void videoCache::itemAboutToBeDeleted(playlistItem* item)
   bool loadingItem = (interactiveThread[0]->worker()->getCacheItem() == item || interactiveThread[1]->worker()->getCacheItem() == item);
   bool cachingItem = false;
 
+  itemFrameCostMs.remove(item);
+
   if (workersState != workersIdle)
   {
     // Are we currently caching a frame from this item?
@@ -34,6 +34,7 @@
 
 #include <QDockWidget>
 #include <QElapsedTimer>
+#include <QHash>
 #include <QLabel>
 #include <QPointer>
 #include <QProgressDialog>
@@ -65,6 +66,13 @@ public:
   // item that can be visible at the same time.
   void loadFrame(playlistItem *item, int frameIndex, int loadingSlot);
 
+  // While playback is running, the view tells us which items are visible. If two different items are shown next to
+  // each other, the caching threads fetch the next frames of both items together so that playback does not have to
+  // wait for the slower one. The threads are shared between the items according to how long loading a frame takes.
+  // Items that ask for a read ahead (playlistItem::getPlaybackReadAheadFrames) are also prefetched if shown alone.
+  // Set item1 to nullptr if the view is not split.
+  void prefetchPlaybackFrames(playlistItem *item0, playlistItem *item1);
+
   // Test the conversion speed with the currently selected item
   void testConversionSpeed();
 
@@ -141,6 +149,8 @@ private:
   int deleteNrThreads {0};
   // How many threads are to be used when playback is running?
   int nrThreadsPlayback;
+  // How many threads may prefetch frames of the shown items when playback is running (see prefetchPlaybackFrames)?
+  int nrThreadsPrefetch {0};
 
   // Our tiny internal state machine for the workers
   enum workersStateEnum
@@ -175,6 +185,19 @@ private:
   // Get the next item and frame to cache from the queue and push it to the given worker.
   // Return false if there are no more jobs to be pushed.
   bool pushNextJobToCachingThread(loadingThread *thread);
+
+  // The items that are shown while playback is running (see prefetchPlaybackFrames)
+  QPointer<playlistItem> prefetchItem[2];
+  // Get the next frame to prefetch for one of the prefetch items. Return false if no frame needs prefetching.
+  bool getNextPrefetchJob(playlistItem *&item, int &frameIdx);
+  // Get the next frame to cache from the cache queue. Return false if there is none or no thread may be used for it.
+  bool getNextQueuedJob(playlistItem *&item, int &frameIdx);
+  // The prefetched frames are not in the cacheDeQueue. Remove cached frames of the prefetch items that playback already
+  // passed (the ones farthest behind first) until nrBytes are free. Return false if not enough frames could be removed.
+  bool removePlayedPrefetchFrames(int64_t nrBytes);
+  // The average time (in ms) that loading/caching one frame of an item took
+  QHash<playlistItem*, double> itemFrameCostMs;
+  void updateItemFrameCost(playlistItem *item, qint64 durationNs);
   
   bool updateCacheQueueAndRestartWorker;
 
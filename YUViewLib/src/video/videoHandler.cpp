@@ -34,6 +34,7 @@
 
 #include <QPainter>
 
+#include "common/FrameProfiler.h"
 #include "common/functions.h"
 
 // Activate this if you want to know when which buffer is loaded/converted to image and so on.
@@ -103,23 +104,36 @@ itemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
   // Lock the mutex for checking the cache
   QMutexLocker lock(&imageCacheAccess);
 
+  // The frame that playback will show next
+  const int nextFrameIdx = frameIdx + doubleBufferFrameOffset;
+
+  // An image that was converted at a reduced size for playback is not good enough if the view was zoomed in since
+  // or if playback stopped (the image is then also used for the zoom box, pixel values and screenshots).
+  const int maxScaleLevel = reducedSizeAllowed ? nrPyramidLevelsToBuild.load() : 0;
+  if ((frameIdx == currentImageIdx && currentImageScaleLevel > maxScaleLevel) ||
+      (frameIdx != currentImageIdx && frameIdx == doubleBufferImageFrameIdx && doubleBufferScaleLevel > maxScaleLevel))
+  {
+    DEBUG_VIDEO("videoHandler::needsLoading %d was converted at a reduced size", frameIdx);
+    return LoadingNeeded;
+  }
+
   // The raw values are not needed. 
   if (frameIdx == currentImageIdx)
   {
-    if (doubleBufferImageFrameIdx == frameIdx + 1)
+    if (doubleBufferImageFrameIdx == nextFrameIdx)
     {
-      DEBUG_VIDEO("videoHandler::needsLoading %d is current and %d found in double buffer", frameIdx, frameIdx+1);
+      DEBUG_VIDEO("videoHandler::needsLoading %d is current and %d found in double buffer", frameIdx, nextFrameIdx);
       return LoadingNotNeeded;
     }
-    else if (cacheValid && imageCache.contains(frameIdx + 1))
+    else if (cacheValid && imageCache.contains(nextFrameIdx))
     {
-      DEBUG_VIDEO("videoHandler::needsLoading %d is current and %d found in cache", frameIdx, frameIdx+1);
+      DEBUG_VIDEO("videoHandler::needsLoading %d is current and %d found in cache", frameIdx, nextFrameIdx);
       return LoadingNotNeeded;
     }
     else
     {
       // The next frame is not in the double buffer so that needs to be loaded.
-      DEBUG_VIDEO("videoHandler::needsLoading %d is current but %d not found in double buffer", frameIdx, frameIdx+1);
+      DEBUG_VIDEO("videoHandler::needsLoading %d is current but %d not found in double buffer", frameIdx, nextFrameIdx);
       return LoadingNeededDoubleBuffer;
     }
   }
@@ -128,7 +142,7 @@ itemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
   if (doubleBufferImageFrameIdx == frameIdx)
   {
     // The frame in question is in the double buffer...
-    if (cacheValid && imageCache.contains(frameIdx + 1))
+    if (cacheValid && imageCache.contains(nextFrameIdx))
     {
       // ... and the one after that is in the cache.
       DEBUG_VIDEO("videoHandler::needsLoading %d found in double buffer. Next frame in cache.", frameIdx);
@@ -148,20 +162,20 @@ itemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
   if (cacheValid && imageCache.contains(frameIdx))
   {
     // What about the next frame? Is it also in the cache or in the double buffer?
-    if (doubleBufferImageFrameIdx == frameIdx + 1)
+    if (doubleBufferImageFrameIdx == nextFrameIdx)
     {
-      DEBUG_VIDEO("videoHandler::needsLoading %d in cache and %d found in double buffer", frameIdx, frameIdx+1);
+      DEBUG_VIDEO("videoHandler::needsLoading %d in cache and %d found in double buffer", frameIdx, nextFrameIdx);
       return LoadingNotNeeded;
     }
-    else if (cacheValid && imageCache.contains(frameIdx + 1))
+    else if (cacheValid && imageCache.contains(nextFrameIdx))
     {
-      DEBUG_VIDEO("videoHandler::needsLoading %d in cache and %d found in cache", frameIdx, frameIdx+1);
+      DEBUG_VIDEO("videoHandler::needsLoading %d in cache and %d found in cache", frameIdx, nextFrameIdx);
       return LoadingNotNeeded;
     }
     else
     {
       // The next frame is not in the double buffer so that needs to be loaded.
-      DEBUG_VIDEO("videoHandler::needsLoading %d found in cache but %d not found in double buffer", frameIdx, frameIdx+1);
+      DEBUG_VIDEO("videoHandler::needsLoading %d found in cache but %d not found in double buffer", frameIdx, nextFrameIdx);
       return LoadingNeededDoubleBuffer;
     }
   }
@@ -172,6 +186,27 @@ itemLoadingState videoHandler::needsLoading(int frameIdx, bool loadRawValues)
 }
 
 void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues)
+{
+  updateCurrentImage(frameIdx);
+
+  // Create the video QRect with the size of the sequence and center it.
+  QRect videoRect;
+  videoRect.setSize(frameSize * zoomFactor);
+  videoRect.moveCenter(QPoint(0,0));
+
+  // Draw the current image (currentImage)
+  currentImageSetMutex.lock();
+  drawCurrentImage(painter, videoRect, zoomFactor);
+  currentImageSetMutex.unlock();
+
+  if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
+  {
+    // Draw the pixel values onto the pixels
+    drawPixelValues(painter, frameIdx, videoRect, zoomFactor);
+  }
+}
+
+void videoHandler::updateCurrentImage(int frameIdx)
 {
   // Check if the frameIdx changed and if we have to load a new frame
   if (frameIdx != currentImageIdx)
@@ -181,7 +216,10 @@ void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor,
     // Check the double buffer
     if (frameIdx == doubleBufferImageFrameIdx)
     {
+      QMutexLocker imageLock(&currentImageSetMutex);
       currentImage = doubleBufferImage;
+      currentImageScaleLevel = doubleBufferScaleLevel;
+      currentImagePyramid.setImage(currentImage, doubleBufferLevels);
       currentImageIdx = frameIdx;
       DEBUG_VIDEO("videoHandler::drawFrame %d loaded from double buffer", frameIdx);
     }
@@ -190,55 +228,104 @@ void videoHandler::drawFrame(QPainter *painter, int frameIdx, double zoomFactor,
       QMutexLocker lock(&imageCacheAccess);
       if (cacheValid && imageCache.contains(frameIdx))
       {
+        QMutexLocker imageLock(&currentImageSetMutex);
         currentImage = imageCache[frameIdx];
+        currentImageScaleLevel = 0;
+        currentImagePyramid.setImage(currentImage, imageCacheLevels.value(frameIdx));
         currentImageIdx = frameIdx;
         DEBUG_VIDEO("videoHandler::drawFrame %d loaded from cache", frameIdx);
       }
     }
   }
+}
 
-  // Create the video QRect with the size of the sequence and center it.
+bool videoHandler::drawLoadedFrame(QPainter *painter, int frameIdx, double zoomFactor)
+{
   QRect videoRect;
   videoRect.setSize(frameSize * zoomFactor);
   videoRect.moveCenter(QPoint(0,0));
 
-  // Draw the current image (currentImage)
-  currentImageSetMutex.lock();
-  painter->drawImage(videoRect, currentImage);
-  currentImageSetMutex.unlock();
+  // Take the image (and its levels) under the locks. Drawing works on the implicitly shared copies.
+  QImage image;
+  QVector<QImage> levels;
+  int scaleLevel = 0;
+  {
+    QMutexLocker imageLock(&currentImageSetMutex);
+    if (frameIdx == currentImageIdx)
+    {
+      drawCurrentImage(painter, videoRect, zoomFactor);
+      return true;
+    }
+    if (frameIdx == doubleBufferImageFrameIdx)
+    {
+      image = doubleBufferImage;
+      levels = doubleBufferLevels;
+      scaleLevel = doubleBufferScaleLevel;
+    }
+  }
+  if (image.isNull())
+  {
+    QMutexLocker lock(&imageCacheAccess);
+    if (cacheValid && imageCache.contains(frameIdx))
+    {
+      image = imageCache[frameIdx];
+      levels = imageCacheLevels.value(frameIdx);
+    }
+  }
+  if (image.isNull())
+    return false;
 
-  if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
+  const auto level = std::max(ImagePyramid::getLevelForZoom(zoomFactor * painter->device()->devicePixelRatioF()) - scaleLevel, 0);
+  if (level == 0)
+    painter->drawImage(videoRect, image);
+  else
   {
-    // Draw the pixel values onto the pixels
-    drawPixelValues(painter, frameIdx, videoRect, zoomFactor);
+    ImagePyramid pyramid;
+    pyramid.setImage(image, levels);
+    painter->drawImage(videoRect, pyramid.getLevel(level));
   }
+  return true;
 }
 
-QImage videoHandler::calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference)
+QImage videoHandler::calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks)
 {
   // Try to cast item2 to a videoHandler
   videoHandler *videoItem2 = dynamic_cast<videoHandler*>(item2);
   if (videoItem2 == nullptr)
   {
     // The item2 is not a videoItem but this one is.
-    if (currentImageIdx != frameIdxItem0)
+    if (currentImageIdx != frameIdxItem0 || currentImageScaleLevel > 0)
       loadFrame(frameIdxItem0);
     // Call the frameHandler implementation to calculate the difference
-    return frameHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference);
+    return frameHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
   }
 
   // Load the right images, if not already loaded)
-  if (currentImageIdx != frameIdxItem0)
+  if (currentImageIdx != frameIdxItem0 || currentImageScaleLevel > 0)
     loadFrame(frameIdxItem0);
-  if (videoItem2->currentImageIdx != frameIdxItem1)
+  if (videoItem2->currentImageIdx != frameIdxItem1 || videoItem2->currentImageScaleLevel > 0)
     videoItem2->loadFrame(frameIdxItem1);
 
-  return frameHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference);
+  return frameHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
+}
+
+QImage videoHandler::loadImageForCaching(int frameIdx)
+{
+  {
+    QMutexLocker lock(&imageCacheAccess);
+    if (cacheValid && imageCache.contains(frameIdx))
+      return imageCache[frameIdx];
+  }
+
+  QImage image;
+  loadFrameForCaching(frameIdx, image);
+  return image;
 }
 
 QRgb videoHandler::getPixelVal(int x, int y)
 {
-  return currentImage.pixel(x, y);
+  // The image may have been converted at a reduced size during playback
+  return currentImage.pixel(x >> currentImageScaleLevel, y >> currentImageScaleLevel);
 }
 
 int videoHandler::getNrFramesCached() const
@@ -265,20 +352,31 @@ void videoHandler::cacheFrame(int frameIdx, bool testMode)
 
   // Put it into the cache
   if (!cacheImage.isNull())
-  {
-    DEBUG_VIDEO("videoHandler::cacheFrame insert frame %i into cache", frameIdx);
-    QMutexLocker imageCacheLock(&imageCacheAccess);
-    if (cacheValid && !testMode)
-      imageCache.insert(frameIdx, cacheImage);
-  }
+    insertFrameIntoCache(frameIdx, cacheImage, testMode);
   else
     DEBUG_VIDEO("videoHandler::cacheFrame loading frame %i for caching failed", frameIdx);
 }
 
+void videoHandler::insertFrameIntoCache(int frameIdx, const QImage &image, bool testMode)
+{
+  DEBUG_VIDEO("videoHandler::insertFrameIntoCache insert frame %i into cache", frameIdx);
+  FRAME_PROFILER_SCOPE("Insert into cache", frameIdx);
+  const auto levels = ImagePyramid::buildLevels(image, nrPyramidLevelsToBuild);
+  QMutexLocker imageCacheLock(&imageCacheAccess);
+  if (cacheValid && !testMode)
+  {
+    imageCache.insert(frameIdx, image);
+    if (levels.isEmpty())
+      imageCacheLevels.remove(frameIdx);
+    else
+      imageCacheLevels.insert(frameIdx, levels);
+  }
+}
+
 unsigned int videoHandler::getCachingFrameSize() const
 {
   auto bytes = functions::bytesPerPixel(functions::platformImageFormat());
-  return frameSize.width() * frameSize.height() * bytes;
+  return frameSize.width() * frameSize.height() * bytes + ImagePyramid::getLevelsBytes(frameSize, bytes, nrPyramidLevelsToBuild);
 }
 
 QList<int> videoHandler::getCachedFrames() const
@@ -304,6 +402,7 @@ void videoHandler::removeFrameFromCache(int frameIdx)
   DEBUG_VIDEO("removeFrameFromCache %d", frameIdx);
   QMutexLocker lock(&imageCacheAccess);
   imageCache.remove(frameIdx);
+  imageCacheLevels.remove(frameIdx);
   lock.unlock();
 }
 
@@ -312,6 +411,7 @@ void videoHandler::removeAllFrameFromCache()
   DEBUG_VIDEO("removeAllFrameFromCache");
   QMutexLocker lock(&imageCacheAccess);
   imageCache.clear();
+  imageCacheLevels.clear();
   cacheValid = true;
   lock.unlock();
 }
@@ -334,16 +434,14 @@ void videoHandler::loadFrame(int frameIndex, bool loadToDoubleBuffer)
   }
 
   if (loadToDoubleBuffer)
-  {
     // Save the requested frame in the double buffer
-    doubleBufferImage = requestedFrame;
-    doubleBufferImageFrameIdx = frameIndex;
-  }
+    setDoubleBufferImage(requestedFrame, frameIndex);
   else
   {
     // Set the requested frame as the current frame
     QMutexLocker imageLock(&currentImageSetMutex);
     currentImage = requestedFrame;
+    currentImageScaleLevel = 0;
     currentImageIdx = frameIndex;
   }
 }
@@ -377,23 +475,46 @@ void videoHandler::invalidateAllBuffers()
   currentImage_frameIndex = -1;
   currentImageSetMutex.lock();
   currentImage = QImage();
+  currentImageScaleLevel = 0;
+  currentImagePyramid.clear();
   currentImageSetMutex.unlock();
   requestedFrame_idx = -1;
 
+  // Frames that are currently cached by the caching threads must not end up in the cache. The cache is valid
+  // again once the video cache cleared it (the caller must emit RECACHE_CLEAR).
+  QMutexLocker lock(&imageCacheAccess);
+  setCacheInvalid();
   imageCache.clear();
-  cacheValid = true;
+  imageCacheLevels.clear();
 }
 
 void videoHandler::activateDoubleBuffer()
 {
   if (doubleBufferImageFrameIdx != -1)
   {
+    QMutexLocker imageLock(&currentImageSetMutex);
     currentImage = doubleBufferImage;
+    currentImageScaleLevel = doubleBufferScaleLevel;
+    currentImagePyramid.setImage(currentImage, doubleBufferLevels);
     currentImageIdx = doubleBufferImageFrameIdx;
     DEBUG_VIDEO("videoHandler::drawFrame %d loaded from double buffer", currentImageIdx);
   }
 }
 
+void videoHandler::setDoubleBufferImage(const QImage &image, int frameIdx, int scaleLevel)
+{
+  // This is called from the background loading thread. Build the levels here and not when drawing.
+  QVector<QImage> levels;
+  if (scaleLevel == 0)
+    levels = ImagePyramid::buildLevels(image, nrPyramidLevelsToBuild);
+
+  QMutexLocker imageLock(&currentImageSetMutex);
+  doubleBufferLevels = levels;
+  doubleBufferImage = image;
+  doubleBufferScaleLevel = scaleLevel;
+  doubleBufferImageFrameIdx = frameIdx;
+}
+
 int videoHandler::convScaleLimitedRange(int value)
 {
   assert(value >= 0 && value <= 255);
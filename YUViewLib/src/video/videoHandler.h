@@ -36,6 +36,9 @@
 #include <QFileInfo>
 #include <QMutex>
 
+#include <atomic>
+
+#include "video/FrameBuffer.h"
 #include "video/frameHandler.h"
 
 /* TODO
@@ -53,11 +56,23 @@ public:
   // Draw the frame with the given frame index and zoom factor. If onLoadShowLasFrame is set, show the last frame
   // if the frame with the current frame index is loaded in the background.
   virtual void drawFrame(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues);
+  // Draw the frame if it is the current frame, in the double buffer or in the cache. Unlike drawFrame, this does not
+  // change the current frame (or swap the double buffer). Returns false if the frame is not loaded.
+  bool drawLoadedFrame(QPainter *painter, int frameIdx, double zoomFactor);
+  // Make the given frame the current frame if it is in the double buffer or in the cache (as drawFrame does)
+  void updateCurrentImage(int frameIdx);
+
+  // Set the number of downscaled levels that the views need for their zoom factor (see ImagePyramid::getLevelForZoom).
+  // These are built ahead of time when a frame is cached or loaded to the double buffer. Only while playing, frames
+  // may be converted at the reduced size directly. Once playback stopped, such a frame needs loading again.
+  void setNrPyramidLevelsToBuild(int nrLevels, bool playing) { nrPyramidLevelsToBuild = nrLevels; reducedSizeAllowed = playing; }
 
   // --- Caching ----
   // These methods are all thread-safe and can be invoked from any thread.
   int getNrFramesCached() const;
   void cacheFrame(int frameIdx, bool testMode);
+  // Put an image that was loaded somewhere else (e.g. by the item in a caching thread) into the cache
+  void insertFrameIntoCache(int frameIdx, const QImage &image, bool testMode);
   unsigned int getCachingFrameSize() const; // How much bytes will be used when caching one frame?
   QList<int> getCachedFrames() const;
   int getNumberCachedFrames() const;
@@ -72,7 +87,7 @@ public:
   virtual void setFrameSize(const QSize &size) Q_DECL_OVERRIDE ;
   
   // Same as the calculateDifference in frameHandler. For a video we have to make sure that the right frame is loaded first.
-  virtual QImage calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference) Q_DECL_OVERRIDE;
+  virtual QImage calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks) Q_DECL_OVERRIDE;
 
   // Try to guess and set the format (frameSize/srcPixelFormat) from the raw data in the right raw format.
   // If a file size is given, it is tested if the guessed format and the file size match. You can overload this
@@ -89,7 +104,7 @@ public:
   int    requestedFrame_idx;
 
   // If reloading a raw file (because it changed), this function will clear all buffers (also the cache). With the next drawFrame(),
-  // the data will be reloaded from file.
+  // the data will be reloaded from file. The cache stays invalid until it was cleared, so emit RECACHE_CLEAR afterwards.
   void invalidateAllBuffers();
 
   // The user changed the frame. Do we need to load something before we can draw it? Do we need to update the double buffer?
@@ -102,10 +117,16 @@ public:
   // be equal to frameIndex.
   virtual void loadFrame(int frameIndex, bool loadToDoubleBuffer=false);
 
+  // Convert the given raw frame (in the current frame size and pixel format) to an image. The current frame
+  // and the cache are not changed (e.g. for exporting frames).
+  virtual QImage convertFrameToImage(const FrameBuffer &frame) { Q_UNUSED(frame); return QImage(); }
+
   int getCurrentImageIndex() { return currentImageIdx; }
 
   // Set the image in the double buffer as the current image. After this, a new image can be loaded to the double buffer.
   void activateDoubleBuffer();
+  // During reverse playback, the double buffer holds the previous (instead of the next) frame.
+  void setPlaybackReverse(bool reverse) { doubleBufferFrameOffset = reverse ? -1 : 1; }
 
   // Create the controls for this videoHandler and return a pointer to the layout (nullptr if the handler has no controls).
   // isSizeFixed: For example a YUV file does not have a fixed format (the user can change this),
@@ -123,6 +144,9 @@ public:
   // A buffer with the raw RGB data (this is filled if signalRequestRawData() is emitted)
   QByteArray rawData;
   int        rawData_frameIdx;
+  // Alternatively, the raw data can be provided as a FrameBuffer (if it is not null, it is used instead of rawData).
+  // Decoders use this to hand over their decoded pictures without copying them.
+  FrameBuffer rawFrameBuffer;
 
   // Scale a value with limited mpeg range (16 ... 245) to the full range (0 ... 255) for output.
   static int convScaleLimitedRange(int value);
@@ -162,6 +186,8 @@ protected:
   // the requested frame. No other internal state of the specific video format handler should be changed.
   // currentFrame/currentFrameIdx is still the frame on screen. This is called from a background thread.
   virtual void loadFrameForCaching(int frameIndex, QImage &frameToCache);
+  // Take the frame from the cache or load it like a frame for caching (without putting it into the cache)
+  virtual QImage loadImageForCaching(int frameIdx) Q_DECL_OVERRIDE;
     
   // Only one thread at a time should request something to be loaded. 
   QMutex requestDataMutex;
@@ -174,7 +200,19 @@ protected:
 
   // Double buffering
   QImage doubleBufferImage;
+  QVector<QImage> doubleBufferLevels;
   int    doubleBufferImageFrameIdx;
+  int    doubleBufferFrameOffset {1};
+  int    doubleBufferScaleLevel {0};
+  // Set the double buffer (and build the downscaled levels of the image if the view is zoomed out). If the image
+  // was already converted at a reduced size, scaleLevel gives the downscaling (2^scaleLevel) and no levels are built.
+  void setDoubleBufferImage(const QImage &image, int frameIdx, int scaleLevel = 0);
+
+  // The number of downscaled levels (see ImagePyramid) that are built when a frame is cached or loaded to the
+  // double buffer. This is set by the view (setNrPyramidLevelsToBuild) so that no levels are built when not zoomed out.
+  std::atomic<int> nrPyramidLevelsToBuild {0};
+  // Can a frame be converted at the reduced size of nrPyramidLevelsToBuild? (Only while playing)
+  std::atomic<bool> reducedSizeAllowed {false};
 
   // Set the cache to be invalid until a call to removefromCache(-1) clears it.
   void setCacheInvalid() { cacheValid = false; }
@@ -182,6 +220,7 @@ protected:
   // --- Caching
   QMutex mutable     imageCacheAccess;
   QMap<int, QImage>  imageCache;
+  QMap<int, QVector<QImage>> imageCacheLevels;  // The downscaled levels of the cached images (if any were built)
   // Is the cache valid? The cache can be ivalid in the following scenario:
   // Somethign about how an item is shown changes (e.g. the resolution) but caching of the item is currently performed.
   // If we just cleared the cache, the wrong (currently being cached) frames would still end up in the cache. So we emit
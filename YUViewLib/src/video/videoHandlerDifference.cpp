@@ -35,8 +35,6 @@
 #include <algorithm>
 #include <QPainter>
 
-#include "videoHandlerYUV.h"
-
 // Activate this if you want to know when which buffer is loaded/converted to image and so on.
 #define VIDEOHANDLERDIFFERENCE_DEBUG_LOADING 0
 #if VIDEOHANDLERDIFFERENCE_DEBUG_LOADING && !NDEBUG
@@ -75,7 +73,10 @@ void videoHandlerDifference::drawDifferenceFrame(QPainter *painter, int frameIdx
       if (cacheValid && imageCache.contains(frameIdx))
       {
         currentImage = imageCache[frameIdx];
+        currentImagePyramid.setImage(currentImage, imageCacheLevels.value(frameIdx));
         currentImageIdx = frameIdx;
+        differenceInfoList = differenceInfoCache.value(frameIdx);
+        firstDifferenceInfo = firstDifferenceInfoCache.value(frameIdx);
         DEBUG_VIDEO("videoHandler::drawFrame %d loaded from cache", frameIdx);
       }
     }
@@ -88,7 +89,7 @@ void videoHandlerDifference::drawDifferenceFrame(QPainter *painter, int frameIdx
 
   // Draw the current image (currentImage)
   currentImageSetMutex.lock();
-  painter->drawImage(videoRect, currentImage);
+  drawCurrentImage(painter, videoRect, zoomFactor);
   currentImageSetMutex.unlock();
 
   if (drawRawValues && zoomFactor >= SPLITVIEW_DRAW_VALUES_ZOOMFACTOR)
@@ -117,11 +118,12 @@ void videoHandlerDifference::loadFrameDifference(int frameIndex, int frameIndex0
     video1->loadFrame(frameIndex1);
   
   // Calculate the difference  
-  QImage newFrame = inputVideo[0]->calculateDifference(inputVideo[1], frameIndex0, frameIndex1, differenceInfoList, amplificationFactor, markDifference);
+  QImage newFrame = inputVideo[0]->calculateDifference(inputVideo[1], frameIndex0, frameIndex1, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
 
   if (!newFrame.isNull())
   {
     // The new difference frame is ready
+    firstDifferenceInfo = getFirstDifferenceInfo(differenceBlocks);
     currentImageIdx = frameIndex;
     currentImageSetMutex.lock();
     currentImage = newFrame;
@@ -129,6 +131,73 @@ void videoHandlerDifference::loadFrameDifference(int frameIndex, int frameIndex0
   }
 }
 
+void videoHandlerDifference::cacheDifferenceFrame(int frameIndex, int frameIndex0, int frameIndex1, bool testMode)
+{
+  DEBUG_VIDEO("videoHandlerDifference::cacheDifferenceFrame %d %s", frameIndex, testMode ? "testMode" : "");
+
+  if (!inputsValid())
+    return;
+  if (cacheValid && isInCache(frameIndex) && !testMode)
+    return;
+
+  // The inputs load the raw data for caching. Their current frames are not changed.
+  QList<infoItem> infoList;
+  DifferenceKernels::BlockMap blocks;
+  QImage cacheImage = inputVideo[0]->calculateDifferenceForCaching(inputVideo[1], frameIndex0, frameIndex1, infoList, amplificationFactor, markDifference, blocks);
+  if (cacheImage.isNull())
+  {
+    DEBUG_VIDEO("videoHandlerDifference::cacheDifferenceFrame calculating difference %d for caching failed", frameIndex);
+    return;
+  }
+
+  const auto firstInfo = getFirstDifferenceInfo(blocks);
+  const auto levels = ImagePyramid::buildLevels(cacheImage, nrPyramidLevelsToBuild);
+  QMutexLocker imageCacheLock(&imageCacheAccess);
+  if (cacheValid && !testMode)
+  {
+    imageCache.insert(frameIndex, cacheImage);
+    if (levels.isEmpty())
+      imageCacheLevels.remove(frameIndex);
+    else
+      imageCacheLevels.insert(frameIndex, levels);
+    differenceInfoCache.insert(frameIndex, infoList);
+    firstDifferenceInfoCache.insert(frameIndex, firstInfo);
+  }
+}
+
+void videoHandlerDifference::removeFrameFromCache(int frameIdx)
+{
+  videoHandler::removeFrameFromCache(frameIdx);
+  QMutexLocker lock(&imageCacheAccess);
+  differenceInfoCache.remove(frameIdx);
+  firstDifferenceInfoCache.remove(frameIdx);
+}
+
+void videoHandlerDifference::removeAllFrameFromCache()
+{
+  videoHandler::removeAllFrameFromCache();
+  QMutexLocker lock(&imageCacheAccess);
+  differenceInfoCache.clear();
+  firstDifferenceInfoCache.clear();
+}
+
+void videoHandlerDifference::invalidateDifference(bool onlyCurrentFrame)
+{
+  if (onlyCurrentFrame)
+  {
+    // The differences for a given pair of frame indices did not change. Only reload the current frame.
+    currentImageIdx = -1;
+    return;
+  }
+
+  invalidateAllBuffers();
+  QMutexLocker lock(&imageCacheAccess);
+  differenceInfoCache.clear();
+  firstDifferenceInfoCache.clear();
+  // Differences that are currently calculated by the caching threads must not end up in the cache
+  setCacheInvalid();
+}
+
 bool videoHandlerDifference::inputsValid() const
 {
   if (inputVideo[0].isNull() || inputVideo[1].isNull())
@@ -159,8 +228,9 @@ void videoHandlerDifference::setInputVideos(frameHandler *childVideo0, frameHand
       setFrameSize(diffSize);
     }
 
-    // If something changed, we might need a redraw
-    emit signalHandlerChanged(true, RECACHE_NONE);
+    // If something changed, we might need a redraw and the cached differences are invalid
+    invalidateDifference(false);
+    emit signalHandlerChanged(true, RECACHE_CLEAR);
   }
 }
 
@@ -204,9 +274,10 @@ void videoHandlerDifference::slotDifferenceControlChanged()
   {
     markDifference = ui.markDifferenceCheckBox->isChecked();
 
-    // Set the current frame in the buffer to be invalid and emit the signal that something has changed
+    // Set the current frame in the buffer and the cache to be invalid and emit the signal that something has changed
     currentImageIdx = -1;
-    emit signalHandlerChanged(true, RECACHE_NONE);
+    setCacheInvalid();
+    emit signalHandlerChanged(true, RECACHE_CLEAR);
   }
   else if (sender == ui.codingOrderComboBox)
   {
@@ -219,9 +290,10 @@ void videoHandlerDifference::slotDifferenceControlChanged()
   {
     amplificationFactor = ui.amplificationFactorSpinBox->value();
 
-    // Set the current frame in the buffer to be invalid and emit the signal that something has changed
+    // Set the current frame in the buffer and the cache to be invalid and emit the signal that something has changed
     currentImageIdx = -1;
-    emit signalHandlerChanged(true, RECACHE_NONE);
+    setCacheInvalid();
+    emit signalHandlerChanged(true, RECACHE_CLEAR);
   }
 }
 
@@ -230,240 +302,32 @@ void videoHandlerDifference::reportFirstDifferencePosition(QList<infoItem> &info
   if (!inputsValid())
     return;
 
-  if (currentImage.width() != frameSize.width() || currentImage.height() != frameSize.height())
-    return;
+  infoList.append(firstDifferenceInfo);
+}
+
+QList<infoItem> videoHandlerDifference::getFirstDifferenceInfo(const DifferenceKernels::BlockMap &differenceBlocks) const
+{
+  QList<infoItem> infoList;
+  if (differenceBlocks.getFrameSize() != frameSize)
+    return infoList;
 
   if (codingOrder == CodingOrder_HEVC)
   {
     // Assume the following:
     // - The picture is split into LCUs of 64x64 pixels which are scanned in raster scan
     // - Each LCU is scanned in a hierarchical tree until the smallest unit size (4x4 pixels) is reached
-    // This is exactly what we are going to do here now
-
-    int widthLCU  = (frameSize.width()  + 63) / 64;  // Round up
-    int heightLCU = (frameSize.height() + 63) / 64;
-
-    for (int y = 0; y < heightLCU; y++)
+    int lcuIndex, firstX, firstY, partIndex;
+    if (differenceBlocks.findFirstInCodingOrder(64, lcuIndex, firstX, firstY, partIndex))
     {
-      for (int x = 0; x < widthLCU; x++)
-      {
-        // Now take the tree approach
-        int firstX, firstY, partIndex = 0;
-
-
-        videoHandlerYUV* video0 = dynamic_cast<videoHandlerYUV*>(inputVideo[0].data());
-        if(video0 != NULL && video0->getIs_YUV_diff())
-        {
-
-            // find first difference using YUV instead of QImage. The latter does not work for 10bit videos and very small differences, since it only supports 8bit
-            if (hierarchicalPositionYUV(x*64, y*64, 64, firstX, firstY, partIndex, video0->getDiffYUV(), video0->getDiffYUVFormat()))
-            {
-              // We found a difference in this block
-              infoList.append(infoItem("First Difference LCU", QString::number(y * widthLCU + x)));
-              infoList.append(infoItem("First Difference X", QString::number(firstX)));
-              infoList.append(infoItem("First Difference Y", QString::number(firstY)));
-              infoList.append(infoItem("First Difference partIndex", QString::number(partIndex)));
-              return;
-            }
-
-        }
-        else
-        {
-            if (hierarchicalPosition(x*64, y*64, 64, firstX, firstY, partIndex, currentImage))
-            {
-              // We found a difference in this block
-              infoList.append(infoItem("First Difference LCU", QString::number(y * widthLCU + x)));
-              infoList.append(infoItem("First Difference X", QString::number(firstX)));
-              infoList.append(infoItem("First Difference Y", QString::number(firstY)));
-              infoList.append(infoItem("First Difference partIndex", QString::number(partIndex)));
-              return;
-            }
-        }
-      }
+      infoList.append(infoItem("First Difference LCU", QString::number(lcuIndex)));
+      infoList.append(infoItem("First Difference X", QString::number(firstX)));
+      infoList.append(infoItem("First Difference Y", QString::number(firstY)));
+      infoList.append(infoItem("First Difference partIndex", QString::number(partIndex)));
+      return infoList;
     }
   }
 
   // No difference was found
   infoList.append(infoItem("Difference", "Frames are identical"));
-}
-
-bool videoHandlerDifference::hierarchicalPosition(int x, int y, int blockSize, int &firstX, int &firstY, int &partIndex, const QImage &diffImg) const
-{
-  if (x >= frameSize.width() || y >= frameSize.height())
-    // This block is entirely outside of the picture
-    return false;
-
-  if (blockSize == 4)
-  {
-    // Check for a difference
-    for (int subX=x; subX < x+4; subX++)
-    {
-      for (int subY=y; subY < y+4; subY++)
-      {
-        QRgb rgb = diffImg.pixel(QPoint(subX, subY));
-
-        if (markDifference)
-        {
-          // Black means no difference
-          if (qRed(rgb) != 0 || qGreen(rgb) != 0 || qBlue(rgb) != 0)
-          {
-            // First difference found
-            firstX = x;
-            firstY = y;
-            return true;
-          }
-        }
-        else
-        {
-          // TODO: Double check if this is always true
-          // Do other values also convert to RGB(130,130,130) ?
-          // What about ten bit input material
-          int red = qRed(rgb);
-          int green = qGreen(rgb);
-          int blue = qBlue(rgb);
-
-          if (red != 130 || green != 130 || blue != 130)
-          {
-            // First difference found
-            firstX = x;
-            firstY = y;
-            return true;
-          }
-        }
-      }
-    }
-
-    // No difference found in this block. Count the number of 4x4 blocks scanned (that is the partIndex)
-    partIndex++;
-  }
-  else
-  {
-    // Walk further into the hierarchy
-    const int b2 = blockSize/2;
-    if (hierarchicalPosition(x     , y     , b2, firstX, firstY, partIndex, diffImg))
-      return true;
-    if (hierarchicalPosition(x + b2, y     , b2, firstX, firstY, partIndex, diffImg))
-      return true;
-    if (hierarchicalPosition(x     , y + b2, b2, firstX, firstY, partIndex, diffImg))
-      return true;
-    if (hierarchicalPosition(x + b2, y + b2, b2, firstX, firstY, partIndex, diffImg))
-      return true;
-  }
-  return false;
-}
-
-inline int getValueFromSource(const unsigned char * src, const int idx, const int bps, const bool bigEndian)
-{
-  if (bps > 8)
-    // Read two bytes in the right order
-    return (bigEndian) ? src[idx*2] << 8 | src[idx*2+1] : src[idx*2] | src[idx*2+1] << 8;
-  else
-    // Just read one byte
-    return src[idx];
-}
-
-
-bool videoHandlerDifference::hierarchicalPositionYUV(int x, int y, int blockSize, int &firstX, int &firstY, int &partIndex, const QByteArray &diffYUV, const YUV_Internals::yuvPixelFormat &diffYUVFormat) const
-{
-  if (x >= frameSize.width() || y >= frameSize.height())
-    // This block is entirely outside of the picture
-    return false;
-
-  // The items can be of different size (we then calculate the difference of the top left aligned part)
-  const int w_in = frameSize.width();
-  const int h_in = frameSize.height();
-
-  // Get subsampling modes (they are identical for both inputs and the output)
-  const int subH = diffYUVFormat.getSubsamplingHor();
-  const int subV = diffYUVFormat.getSubsamplingVer();
-
-  // Get the endianness of the inputs
-  const bool bigEndian = diffYUVFormat.bigEndian;
-
-  // Get/Set the bit depth of the input
-  const int bps_in = diffYUVFormat.bitsPerSample;
-  const int diffZero = 128 << (bps_in-8);
-
-  // Get pointers to the inputs
-  const int componentSizeLuma_In = w_in*h_in;
-  const int componentSizeChroma_In = (w_in/subH)*(h_in/subV);
-  const int nrBytesLumaPlane_In = bps_in > 8 ? 2 * componentSizeLuma_In : componentSizeLuma_In;
-  const int nrBytesChromaPlane_In = bps_in > 8 ? 2 * componentSizeChroma_In : componentSizeChroma_In;
-  // Current item
-
-  // Calculate Luma sample difference
-  const int stride_in = bps_in > 8 ? w_in*2 : w_in;  // How many bytes to the next y line?
-  const int strideC_in = w_in / subH * (bps_in > 8 ? 2 : 1) ;  // How many bytes to the next U/V y line
-
-  if (blockSize == 4)
-  {
-      const unsigned char * srcY1 = (unsigned char*)diffYUV.data();
-      const unsigned char * srcU1 = (diffYUVFormat.planeOrder == YUV_Internals::PlaneOrder::YUV || diffYUVFormat.planeOrder == YUV_Internals::PlaneOrder::YUVA) ? srcY1 + nrBytesLumaPlane_In : srcY1 + nrBytesLumaPlane_In + nrBytesChromaPlane_In;
-      const unsigned char * srcV1 = (diffYUVFormat.planeOrder == YUV_Internals::PlaneOrder::YUV || diffYUVFormat.planeOrder == YUV_Internals::PlaneOrder::YUVA) ? srcY1 + nrBytesLumaPlane_In + nrBytesChromaPlane_In: srcY1 + nrBytesLumaPlane_In;
-
-    // adjust source pointer according to block position
-    srcY1 += y*stride_in;
-    srcU1 += y/subV*strideC_in;
-    srcV1 += y/subV*strideC_in;
-
-    // Check for a difference
-    for (int subY=y; subY < y+4; subY++)
-    {
-
-      for (int subX=x; subX < x+4; subX++)
-      {
-
-          int val1 = getValueFromSource(srcY1, subX, bps_in, bigEndian);
-          if(val1 != diffZero)
-          {
-              firstX = x;
-              firstY = y;
-              return true;
-          }
-
-          // is this a position at which we have a chroma sample?
-          if(subX % subH == 0 && subY % subV == 0 && subX*subV < w_in)
-          {
-              int valU1 = getValueFromSource(srcU1, subX, bps_in, bigEndian);
-              int valV1 = getValueFromSource(srcV1, subX, bps_in, bigEndian);
-              if(valU1 != diffZero || valV1 != diffZero)
-              {
-                  firstX = x*subV;
-                  firstY = y;
-                  return true;
-              }
-          }
-
-
-      }
-
-      // Goto the next y line
-      srcY1 += stride_in;
-
-      // is this a position at which we have a chroma line?
-      if(subY % subV == 0)
-      {
-          // Goto the next y line
-          srcU1 += strideC_in;
-          srcV1 += strideC_in;
-      }
-    }
-
-    // No difference found in this block. Count the number of 4x4 blocks scanned (that is the partIndex)
-    partIndex++;
-  }
-  else
-  {
-    // Walk further into the hierarchy
-    const int b2 = blockSize/2;
-    if (hierarchicalPositionYUV(x     , y     , b2, firstX, firstY, partIndex, diffYUV, diffYUVFormat))
-      return true;
-    if (hierarchicalPositionYUV(x + b2, y     , b2, firstX, firstY, partIndex, diffYUV, diffYUVFormat))
-      return true;
-    if (hierarchicalPositionYUV(x     , y + b2, b2, firstX, firstY, partIndex, diffYUV, diffYUVFormat))
-      return true;
-    if (hierarchicalPositionYUV(x + b2, y + b2, b2, firstX, firstY, partIndex, diffYUV, diffYUVFormat))
-      return true;
-  }
-  return false;
+  return infoList;
 }
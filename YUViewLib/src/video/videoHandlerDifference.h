@@ -35,8 +35,8 @@
 #include <QPointer>
 
 #include "common/fileInfo.h"
+#include "DifferenceKernels.h"
 #include "videoHandler.h"
-#include "videoHandlerYUV.h"
 
 #include "ui_videoHandlerDifference.h"
 
@@ -53,6 +53,15 @@ public:
   explicit videoHandlerDifference();
 
   void loadFrameDifference(int frameIndex, int frameIndex0, int frameIndex1, bool loadToDoubleBuffer=false);
+
+  // Calculate the difference for the given frame and put it into the cache. This is called from the caching threads
+  // and does not change the current frame of the difference or the inputs.
+  void cacheDifferenceFrame(int frameIndex, int frameIndex0, int frameIndex1, bool testMode);
+  virtual void removeFrameFromCache(int frameIdx) Q_DECL_OVERRIDE;
+  virtual void removeAllFrameFromCache() Q_DECL_OVERRIDE;
+
+  // One of the inputs changed. If only the current frame is invalid, the cached differences are kept.
+  void invalidateDifference(bool onlyCurrentFrame);
   
   // Are both inputs valid and can be used?
   bool inputsValid() const;
@@ -69,7 +78,7 @@ public:
   // The difference overloads this and returns the difference values (A-B)
   virtual QStringPairList getPixelValues(const QPoint &pixelPos, int frameIdx, frameHandler *item2=nullptr, const int frameIdx1 = 0) Q_DECL_OVERRIDE;
 
-  // Calculate the position of the first difference and add the info to the list
+  // Add the position of the first difference (in coding order) of the current frame to the list
   void reportFirstDifferencePosition(QList<infoItem> &infoList) const;
     
 private slots:
@@ -90,9 +99,16 @@ private:
   // The two videos that the difference will be calculated from
   QPointer<frameHandler> inputVideo[2];  
 
-  // Recursively scan the LCU
-  bool hierarchicalPosition(int x, int y, int blockSize, int &firstX, int &firstY, int &partIndex, const QImage &diffImg) const;
-  bool hierarchicalPositionYUV(int x, int y, int blockSize, int &firstX, int &firstY, int &partIndex, const QByteArray &diffYUV, const YUV_Internals::yuvPixelFormat &diffYUVFormat) const;
+  // Get the info about the position of the first difference from the blocks that contain a difference
+  QList<infoItem> getFirstDifferenceInfo(const DifferenceKernels::BlockMap &differenceBlocks) const;
+
+  // The blocks with a difference and the first difference info of the current frame
+  DifferenceKernels::BlockMap differenceBlocks;
+  QList<infoItem> firstDifferenceInfo;
+
+  // The info lists of the cached frames (guarded by the imageCacheAccess mutex)
+  QMap<int, QList<infoItem>> differenceInfoCache;
+  QMap<int, QList<infoItem>> firstDifferenceInfoCache;
 
   SafeUi<Ui::videoHandlerDifference> ui;
 
@@ -36,6 +36,8 @@
 #include <QtGlobal>
 #include "common/functions.h"
 #include "common/fileInfo.h"
+#include "DifferenceKernels.h"
+#include "RowBands.h"
 #include "videoHandlerRGBCustomFormatDialog.h"
 
 using namespace RGB_Internals;
@@ -347,6 +349,13 @@ void videoHandlerRGB::slotRGBFormatControlChanged()
   emit signalHandlerChanged(true, RECACHE_CLEAR);
 }
 
+QImage videoHandlerRGB::convertFrameToImage(const FrameBuffer &frame)
+{
+  QImage image;
+  this->convertRGBToImage(frame.toByteArray(), image);
+  return image;
+}
+
 void videoHandlerRGB::loadFrame(int frameIndex, bool loadToDoubleBuffer)
 {
   DEBUG_RGB("videoHandlerRGB::loadFrame %d", frameIndex);
@@ -370,8 +379,7 @@ void videoHandlerRGB::loadFrame(int frameIndex, bool loadToDoubleBuffer)
   {
     QImage newImage;
     convertRGBToImage(currentFrameRawData, newImage);
-    doubleBufferImage = newImage;
-    doubleBufferImageFrameIdx = frameIndex;
+    setDoubleBufferImage(newImage, frameIndex);
   }
   else if (currentImageIdx != frameIndex)
   {
@@ -410,6 +418,24 @@ void videoHandlerRGB::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   rgbFormatMutex.unlock();
 }
 
+bool videoHandlerRGB::loadRawRGBDataForCaching(int frameIndex, QByteArray &buffer, rgbPixelFormat &rgbFormat, QSize &curFrameSize)
+{
+  DEBUG_RGB("videoHandlerRGB::loadRawRGBDataForCaching %d", frameIndex);
+
+  // The format and size could be changed from the main thread. Get a copy that belongs to the data.
+  rgbFormat = srcPixelFormat;
+  curFrameSize = frameSize;
+
+  requestDataMutex.lock();
+  emit signalRequestRawData(frameIndex, true);
+  const bool loaded = (frameIndex == rawData_frameIdx);
+  if (loaded)
+    buffer = rawData;
+  requestDataMutex.unlock();
+
+  return loaded;
+}
+
 // Load the raw RGB data for the given frame index into currentFrameRawData.
 bool videoHandlerRGB::loadRawRGBData(int frameIndex)
 {
@@ -508,8 +534,17 @@ void videoHandlerRGB::convertSourceToRGBA32Bit(const QByteArray &sourceBuffer, u
   // Check if the source buffer is of the correct size
   Q_ASSERT_X(sourceBuffer.size() >= getBytesPerFrame(), Q_FUNC_INFO, "The source buffer does not hold enough data.");
 
+  // Convert bands of rows in parallel
+  const int w = frameSize.width();
+  RowBands::run(frameSize.height(), RowBands::getNrBands(frameSize), 1, [&](int rowBegin, int rowEnd) {
+    convertSourceToRGBA32Bit(sourceBuffer, targetBuffer, rowBegin * w, rowEnd * w);
+  });
+}
+
+void videoHandlerRGB::convertSourceToRGBA32Bit(const QByteArray &sourceBuffer, unsigned char *targetBuffer, int pixelBegin, int pixelEnd)
+{
   // Get the raw data pointer to the output array
-  unsigned char * restrict dst = targetBuffer;
+  unsigned char * restrict dst = targetBuffer + pixelBegin * 4;
 
   // How many values do we have to skip in src to get to the next input value?
   // In case of 8 or less bits this is 1 byte per value, for 9 to 16 bits it is 2 bytes per value.
@@ -547,9 +582,10 @@ void videoHandlerRGB::convertSourceToRGBA32Bit(const QByteArray &sourceBuffer, u
         src += displayComponentOffset * frameSize.width() * frameSize.height();
       else
         src += displayComponentOffset;
+      src += pixelBegin * offsetToNextValue;
 
       // Now we just have to iterate over all values and always skip "offsetToNextValue" values in src and write 3 values in dst.
-      for (int i = 0; i < frameSize.width() * frameSize.height(); i++)
+      for (int i = pixelBegin; i < pixelEnd; i++)
       {
         int val = (((int)src[0]) * scale) >> rightShift;
         val = clip(val, 0, 255);
@@ -574,9 +610,10 @@ void videoHandlerRGB::convertSourceToRGBA32Bit(const QByteArray &sourceBuffer, u
         src += displayComponentOffset * frameSize.width() * frameSize.height();
       else
         src += displayComponentOffset;
+      src += pixelBegin * offsetToNextValue;
 
       // Now we just have to iterate over all values and always skip "offsetToNextValue" values in src and write 3 values in dst.
-      for (int i = 0; i < frameSize.width() * frameSize.height(); i++)
+      for (int i = pixelBegin; i < pixelEnd; i++)
       {
         int val = ((int)src[0]) * scale;
         val = clip(val, 0, 255);
@@ -621,9 +658,12 @@ void videoHandlerRGB::convertSourceToRGBA32Bit(const QByteArray &sourceBuffer, u
         srcG = (unsigned short*)sourceBuffer.data() + srcPixelFormat.posG;
         srcB = (unsigned short*)sourceBuffer.data() + srcPixelFormat.posB;
       }
+      srcR += pixelBegin * offsetToNextValue;
+      srcG += pixelBegin * offsetToNextValue;
+      srcB += pixelBegin * offsetToNextValue;
 
       // Now we just have to iterate over all values and always skip "offsetToNextValue" values in the sources and write 3 values in dst.
-      for (int i = 0; i < frameSize.width() * frameSize.height(); i++)
+      for (int i = pixelBegin; i < pixelEnd; i++)
       {
         int valR = (((int)srcR[0]) * componentScale[0]) >> rightShift;
         valR = clip(valR, 0, 255);
@@ -674,9 +714,12 @@ void videoHandlerRGB::convertSourceToRGBA32Bit(const QByteArray &sourceBuffer, u
         srcG = (unsigned char*)sourceBuffer.data() + srcPixelFormat.posG;
         srcB = (unsigned char*)sourceBuffer.data() + srcPixelFormat.posB;
       }
+      srcR += pixelBegin * offsetToNextValue;
+      srcG += pixelBegin * offsetToNextValue;
+      srcB += pixelBegin * offsetToNextValue;
 
       // Now we just have to iterate over all values and always skip "offsetToNextValue" values in the sources and write 3 values in dst.
-      for (int i = 0; i < frameSize.width() * frameSize.height(); i++)
+      for (int i = pixelBegin; i < pixelEnd; i++)
       {
         int valR = ((int)srcR[0]) * componentScale[0];
         valR = clip(valR, 0, 255);
@@ -898,6 +941,9 @@ void videoHandlerRGB::drawPixelValues(QPainter *painter, const int frameIdx, con
   QRect pixelRect;
   pixelRect.setSize(QSize(zoomFactor, zoomFactor));
   const unsigned int drawWhitLevel = 1 << (srcPixelFormat.bitsPerValue - 1);
+  const int formatBase = settings.value("ShowPixelValuesHex").toBool() ? 16 : 10;
+  // All values are collected and drawn from the glyph atlas in one batch
+  pixelValueGlyphs.begin(painter);
   for (int x = xMin; x <= xMax; x++)
   {
     for (int y = yMin; y <= yMax; y++)
@@ -907,8 +953,8 @@ void videoHandlerRGB::drawPixelValues(QPainter *painter, const int frameIdx, con
       pixelRect.moveCenter(pixCenter);
 
       // Get the text to show
-      QString valText;
-      const int formatBase = settings.value("ShowPixelValuesHex").toBool() ? 16 : 10;
+      GlyphAtlas::Text valText;
+      bool drawWhite;
       if (rgbItem2 != nullptr)
       {
         rgba_t valueThis = getPixelValue(QPoint(x,y));
@@ -918,52 +964,47 @@ void videoHandlerRGB::drawPixelValues(QPainter *painter, const int frameIdx, con
         const int G = int(valueThis.G) - int(valueOther.G);
         const int B = int(valueThis.B) - int(valueOther.B);
         const int A = int(valueThis.A) - int(valueOther.A);
-        const QString RString = ((R < 0) ? "-" : "") + QString::number(std::abs(R), formatBase);
-        const QString GString = ((G < 0) ? "-" : "") + QString::number(std::abs(G), formatBase);
-        const QString BString = ((B < 0) ? "-" : "") + QString::number(std::abs(B), formatBase);
             
         if (markDifference)
-          painter->setPen((R == 0 && G == 0 && B == 0 && (!srcPixelFormat.hasAlphaChannel() || A == 0)) ? Qt::white : Qt::black);
+          drawWhite = (R == 0 && G == 0 && B == 0 && (!srcPixelFormat.hasAlphaChannel() || A == 0));
         else
-          painter->setPen((R < 0 && G < 0 && B < 0) ? Qt::white : Qt::black);
+          drawWhite = (R < 0 && G < 0 && B < 0);
 
+        valText.addValue('R', R, formatBase);
+        valText.addValue('G', G, formatBase);
+        valText.addValue('B', B, formatBase);
         if (srcPixelFormat.hasAlphaChannel())
-        {
-          const QString AString = ((A < 0) ? "-" : "") + QString::number(std::abs(A), formatBase);
-          valText = QString("R%1\nG%2\nB%3\nA%4").arg(RString, GString, BString, AString);
-        }
-        else
-          valText = QString("R%1\nG%2\nB%3").arg(RString, GString, BString);
+          valText.addValue('A', A, formatBase);
       }
       else
       {
         rgba_t value = getPixelValue(QPoint(x, y));
+        valText.addValue('R', int(value.R), formatBase);
+        valText.addValue('G', int(value.G), formatBase);
+        valText.addValue('B', int(value.B), formatBase);
         if (srcPixelFormat.hasAlphaChannel())
-          valText = QString("R%1\nG%2\nB%3\nA%4").arg(value.R, 0, formatBase).arg(value.G, 0, formatBase).arg(value.B, 0, formatBase).arg(value.A, 0, formatBase);
-        else
-          valText = QString("R%1\nG%2\nB%3").arg(value.R, 0, formatBase).arg(value.G, 0, formatBase).arg(value.B, 0, formatBase);
-        painter->setPen((value.R < drawWhitLevel && value.G < drawWhitLevel && value.B < drawWhitLevel) ? Qt::white : Qt::black);
+          valText.addValue('A', int(value.A), formatBase);
+        drawWhite = (value.R < drawWhitLevel && value.G < drawWhitLevel && value.B < drawWhitLevel);
       }
 
-      painter->drawText(pixelRect, Qt::AlignCenter, valText);
+      pixelValueGlyphs.addText(pixelRect, valText, drawWhite);
     }
   }
+  pixelValueGlyphs.end(painter);
+}
+
+bool videoHandlerRGB::canCalculateRGBDifference(const videoHandlerRGB *rgbItem2) const
+{
+  // The given item must be a RGB source with the same bit depth. Otherwise, the RGB 888 values are compared.
+  return rgbItem2 != nullptr && srcPixelFormat.bitsPerValue == rgbItem2->srcPixelFormat.bitsPerValue;
 }
 
-QImage videoHandlerRGB::calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference)
+QImage videoHandlerRGB::calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks)
 {
   videoHandlerRGB *rgbItem2 = dynamic_cast<videoHandlerRGB*>(item2);
-  if (rgbItem2 == nullptr)
-    // The given item is not a RGB source. We cannot compare raw RGB values to non raw RGB values.
+  if (!canCalculateRGBDifference(rgbItem2))
     // Call the base class comparison function to compare the items using the RGB 888 values.
-    return videoHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference);
-
-  if (srcPixelFormat.bitsPerValue != rgbItem2->srcPixelFormat.bitsPerValue)
-    // The two items have different bit depths. Compare RGB 888 values instead.
-    return videoHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference);
-
-  const int width  = qMin(frameSize.width(), rgbItem2->frameSize.width());
-  const int height = qMin(frameSize.height(), rgbItem2->frameSize.height());
+    return videoHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
 
   // Load the right raw RGB data (if not already loaded).
   // This will just update the raw RGB data. No conversion to image (RGB) is performed. This is either
@@ -973,6 +1014,36 @@ QImage videoHandlerRGB::calculateDifference(frameHandler *item2, const int frame
   if (!rgbItem2->loadRawRGBData(frameIdxItem1))
     return QImage();  // Loading failed
 
+  return calculateDifferenceFromRawData(currentFrameRawData, srcPixelFormat, frameSize, rgbItem2->currentFrameRawData, rgbItem2->srcPixelFormat, rgbItem2->frameSize, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
+}
+
+QImage videoHandlerRGB::calculateDifferenceForCaching(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks)
+{
+  videoHandlerRGB *rgbItem2 = dynamic_cast<videoHandlerRGB*>(item2);
+  if (!canCalculateRGBDifference(rgbItem2))
+    return videoHandler::calculateDifferenceForCaching(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
+
+  QByteArray rawData[2];
+  rgbPixelFormat format[2];
+  QSize size[2];
+  if (!loadRawRGBDataForCaching(frameIdxItem0, rawData[0], format[0], size[0]))
+    return QImage();
+  if (!rgbItem2->loadRawRGBDataForCaching(frameIdxItem1, rawData[1], format[1], size[1]))
+    return QImage();
+
+  return calculateDifferenceFromRawData(rawData[0], format[0], size[0], rawData[1], format[1], size[1], differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
+}
+
+QImage videoHandlerRGB::calculateDifferenceFromRawData(const QByteArray &rawData0, const rgbPixelFormat &format0, const QSize &size0, const QByteArray &rawData1, const rgbPixelFormat &format1, const QSize &size1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks) const
+{
+  if (format0.bitsPerValue != format1.bitsPerValue)
+    return QImage();
+
+  const int width  = qMin(size0.width(), size1.width());
+  const int height = qMin(size0.height(), size1.height());
+  if (rawData0.size() < format0.bytesPerFrame(size0) || rawData1.size() < format1.bytesPerFrame(size1))
+    return QImage();
+
   // Also calculate the MSE while we're at it (R,G,B)
   int64_t mseAdd[3] = {0, 0, 0};
 
@@ -980,77 +1051,81 @@ QImage videoHandlerRGB::calculateDifference(frameHandler *item2, const int frame
   // In both cases, we will set the alpha channel to 255. The format of the raw buffer is: BGRA (each 8 bit).
   QImage outputImage;
   if (is_Q_OS_WIN)
-    outputImage = QImage(frameSize, QImage::Format_ARGB32_Premultiplied);
+    outputImage = QImage(QSize(width, height), QImage::Format_ARGB32_Premultiplied);
   else if (is_Q_OS_MAC)
-    outputImage = QImage(frameSize, QImage::Format_RGB32);
+    outputImage = QImage(QSize(width, height), QImage::Format_RGB32);
   else if (is_Q_OS_LINUX)
   {
     QImage::Format f = functions::platformImageFormat();
     if (f == QImage::Format_ARGB32_Premultiplied)
-      outputImage = QImage(frameSize, QImage::Format_ARGB32_Premultiplied);
+      outputImage = QImage(QSize(width, height), QImage::Format_ARGB32_Premultiplied);
     if (f == QImage::Format_ARGB32)
-      outputImage = QImage(frameSize, QImage::Format_ARGB32);
+      outputImage = QImage(QSize(width, height), QImage::Format_ARGB32);
     else
-      outputImage = QImage(frameSize, QImage::Format_RGB32);
+      outputImage = QImage(QSize(width, height), QImage::Format_RGB32);
   }
 
   // We directly write the difference values into the QImage buffer in the right format (ABGR).
   unsigned char * restrict dst = outputImage.bits();
 
-  if (srcPixelFormat.bitsPerValue >= 8 && srcPixelFormat.bitsPerValue <= 16)
+  if (format0.bitsPerValue >= 8 && format0.bitsPerValue <= 16)
   {
     // How many values do we have to skip in src to get to the next input value?
     // In case of 8 or less bits this is 1 byte per value, for 9 to 16 bits it is 2 bytes per value.
-    int offsetToNextValue = srcPixelFormat.nrChannels();
-    if (srcPixelFormat.planar)
+    int offsetToNextValue = format0.nrChannels();
+    if (format0.planar)
       offsetToNextValue = 1;
+    int offsetToNextValue1 = format1.nrChannels();
+    if (format1.planar)
+      offsetToNextValue1 = 1;
 
-    if (srcPixelFormat.bitsPerValue > 8 && srcPixelFormat.bitsPerValue <= 16)
+    if (format0.bitsPerValue > 8 && format0.bitsPerValue <= 16)
     {
       // 9 to 16 bits per component. We assume two bytes per value.
       // First get the pointer to the first value of each channel. (this item)
       unsigned short *srcR0, *srcG0, *srcB0;
-      if (srcPixelFormat.planar)
+      if (format0.planar)
       {
-        srcR0 = (unsigned short*)currentFrameRawData.data() + (srcPixelFormat.posR * frameSize.width() * frameSize.height());
-        srcG0 = (unsigned short*)currentFrameRawData.data() + (srcPixelFormat.posG * frameSize.width() * frameSize.height());
-        srcB0 = (unsigned short*)currentFrameRawData.data() + (srcPixelFormat.posB * frameSize.width() * frameSize.height());
+        srcR0 = (unsigned short*)rawData0.data() + (format0.posR * size0.width() * size0.height());
+        srcG0 = (unsigned short*)rawData0.data() + (format0.posG * size0.width() * size0.height());
+        srcB0 = (unsigned short*)rawData0.data() + (format0.posB * size0.width() * size0.height());
       }
       else
       {
-        srcR0 = (unsigned short*)currentFrameRawData.data() + srcPixelFormat.posR;
-        srcG0 = (unsigned short*)currentFrameRawData.data() + srcPixelFormat.posG;
-        srcB0 = (unsigned short*)currentFrameRawData.data() + srcPixelFormat.posB;
+        srcR0 = (unsigned short*)rawData0.data() + format0.posR;
+        srcG0 = (unsigned short*)rawData0.data() + format0.posG;
+        srcB0 = (unsigned short*)rawData0.data() + format0.posB;
       }
 
       // Next get the pointer to the first value of each channel. (the other item)
       unsigned short *srcR1, *srcG1, *srcB1;
-      if (srcPixelFormat.planar)
+      if (format1.planar)
       {
-        srcR1 = (unsigned short*)rgbItem2->currentFrameRawData.data() + (rgbItem2->srcPixelFormat.posR * rgbItem2->frameSize.width() * rgbItem2->frameSize.height());
-        srcG1 = (unsigned short*)rgbItem2->currentFrameRawData.data() + (rgbItem2->srcPixelFormat.posG * rgbItem2->frameSize.width() * rgbItem2->frameSize.height());
-        srcB1 = (unsigned short*)rgbItem2->currentFrameRawData.data() + (rgbItem2->srcPixelFormat.posB * rgbItem2->frameSize.width() * rgbItem2->frameSize.height());
+        srcR1 = (unsigned short*)rawData1.data() + (format1.posR * size1.width() * size1.height());
+        srcG1 = (unsigned short*)rawData1.data() + (format1.posG * size1.width() * size1.height());
+        srcB1 = (unsigned short*)rawData1.data() + (format1.posB * size1.width() * size1.height());
       }
       else
       {
-        srcR1 = (unsigned short*)rgbItem2->currentFrameRawData.data() + rgbItem2->srcPixelFormat.posR;
-        srcG1 = (unsigned short*)rgbItem2->currentFrameRawData.data() + rgbItem2->srcPixelFormat.posG;
-        srcB1 = (unsigned short*)rgbItem2->currentFrameRawData.data() + rgbItem2->srcPixelFormat.posB;
+        srcR1 = (unsigned short*)rawData1.data() + format1.posR;
+        srcG1 = (unsigned short*)rawData1.data() + format1.posG;
+        srcB1 = (unsigned short*)rawData1.data() + format1.posB;
       }
 
       for (int y = 0; y < height; y++)
       {
         for (int x = 0; x < width; x++)
         {
-          unsigned int offsetCoordinate = frameSize.width() * y + x;
+          unsigned int offsetCoordinate = size0.width() * y + x;
+          unsigned int offsetCoordinate1 = size1.width() * y + x;
 
           unsigned int R0 = (unsigned int)(*(srcR0 + offsetToNextValue * offsetCoordinate));
           unsigned int G0 = (unsigned int)(*(srcG0 + offsetToNextValue * offsetCoordinate));
           unsigned int B0 = (unsigned int)(*(srcB0 + offsetToNextValue * offsetCoordinate));
 
-          unsigned int R1 = (unsigned int)(*(srcR1 + offsetToNextValue * offsetCoordinate));
-          unsigned int G1 = (unsigned int)(*(srcG1 + offsetToNextValue * offsetCoordinate));
-          unsigned int B1 = (unsigned int)(*(srcB1 + offsetToNextValue * offsetCoordinate));
+          unsigned int R1 = (unsigned int)(*(srcR1 + offsetToNextValue1 * offsetCoordinate1));
+          unsigned int G1 = (unsigned int)(*(srcG1 + offsetToNextValue1 * offsetCoordinate1));
+          unsigned int B1 = (unsigned int)(*(srcB1 + offsetToNextValue1 * offsetCoordinate1));
 
           int deltaR = R0 - R1;
           int deltaG = G0 - G1;
@@ -1079,51 +1154,52 @@ QImage videoHandlerRGB::calculateDifference(frameHandler *item2, const int frame
         }
       }
     }
-    else if (srcPixelFormat.bitsPerValue == 8)
+    else if (format0.bitsPerValue == 8)
     {
       // First get the pointer to the first value of each channel. (this item)
       unsigned char *srcR0, *srcG0, *srcB0;
-      if (srcPixelFormat.planar)
+      if (format0.planar)
       {
-        srcR0 = (unsigned char*)currentFrameRawData.data() + (srcPixelFormat.posR * frameSize.width() * frameSize.height());
-        srcG0 = (unsigned char*)currentFrameRawData.data() + (srcPixelFormat.posG * frameSize.width() * frameSize.height());
-        srcB0 = (unsigned char*)currentFrameRawData.data() + (srcPixelFormat.posB * frameSize.width() * frameSize.height());
+        srcR0 = (unsigned char*)rawData0.data() + (format0.posR * size0.width() * size0.height());
+        srcG0 = (unsigned char*)rawData0.data() + (format0.posG * size0.width() * size0.height());
+        srcB0 = (unsigned char*)rawData0.data() + (format0.posB * size0.width() * size0.height());
       }
       else
       {
-        srcR0 = (unsigned char*)currentFrameRawData.data() + srcPixelFormat.posR;
-        srcG0 = (unsigned char*)currentFrameRawData.data() + srcPixelFormat.posG;
-        srcB0 = (unsigned char*)currentFrameRawData.data() + srcPixelFormat.posB;
+        srcR0 = (unsigned char*)rawData0.data() + format0.posR;
+        srcG0 = (unsigned char*)rawData0.data() + format0.posG;
+        srcB0 = (unsigned char*)rawData0.data() + format0.posB;
       }
 
       // First get the pointer to the first value of each channel. (other item)
       unsigned char *srcR1, *srcG1, *srcB1;
-      if (srcPixelFormat.planar)
+      if (format1.planar)
       {
-        srcR1 = (unsigned char*)rgbItem2->currentFrameRawData.data() + (rgbItem2->srcPixelFormat.posR * rgbItem2->frameSize.width() * rgbItem2->frameSize.height());
-        srcG1 = (unsigned char*)rgbItem2->currentFrameRawData.data() + (rgbItem2->srcPixelFormat.posG * rgbItem2->frameSize.width() * rgbItem2->frameSize.height());
-        srcB1 = (unsigned char*)rgbItem2->currentFrameRawData.data() + (rgbItem2->srcPixelFormat.posB * rgbItem2->frameSize.width() * rgbItem2->frameSize.height());
+        srcR1 = (unsigned char*)rawData1.data() + (format1.posR * size1.width() * size1.height());
+        srcG1 = (unsigned char*)rawData1.data() + (format1.posG * size1.width() * size1.height());
+        srcB1 = (unsigned char*)rawData1.data() + (format1.posB * size1.width() * size1.height());
       }
       else
       {
-        srcR1 = (unsigned char*)rgbItem2->currentFrameRawData.data() + rgbItem2->srcPixelFormat.posR;
-        srcG1 = (unsigned char*)rgbItem2->currentFrameRawData.data() + rgbItem2->srcPixelFormat.posG;
-        srcB1 = (unsigned char*)rgbItem2->currentFrameRawData.data() + rgbItem2->srcPixelFormat.posB;
+        srcR1 = (unsigned char*)rawData1.data() + format1.posR;
+        srcG1 = (unsigned char*)rawData1.data() + format1.posG;
+        srcB1 = (unsigned char*)rawData1.data() + format1.posB;
       }
 
       for (int y = 0; y < height; y++)
       {
         for (int x = 0; x < width; x++)
         {
-          unsigned int offsetCoordinate = frameSize.width() * y + x;
+          unsigned int offsetCoordinate = size0.width() * y + x;
+          unsigned int offsetCoordinate1 = size1.width() * y + x;
 
           unsigned int R0 = (unsigned int)(*(srcR0 + offsetToNextValue * offsetCoordinate));
           unsigned int G0 = (unsigned int)(*(srcG0 + offsetToNextValue * offsetCoordinate));
           unsigned int B0 = (unsigned int)(*(srcB0 + offsetToNextValue * offsetCoordinate));
 
-          unsigned int R1 = (unsigned int)(*(srcR1 + offsetToNextValue * offsetCoordinate));
-          unsigned int G1 = (unsigned int)(*(srcG1 + offsetToNextValue * offsetCoordinate));
-          unsigned int B1 = (unsigned int)(*(srcB1 + offsetToNextValue * offsetCoordinate));
+          unsigned int R1 = (unsigned int)(*(srcR1 + offsetToNextValue1 * offsetCoordinate1));
+          unsigned int G1 = (unsigned int)(*(srcG1 + offsetToNextValue1 * offsetCoordinate1));
+          unsigned int B1 = (unsigned int)(*(srcB1 + offsetToNextValue1 * offsetCoordinate1));
 
           int deltaR = R0 - R1;
           int deltaG = G0 - G1;
@@ -1156,8 +1232,12 @@ QImage videoHandlerRGB::calculateDifference(frameHandler *item2, const int frame
       Q_ASSERT_X(false, Q_FUNC_INFO, "No RGB format with less than 8 or more than 16 bits supported yet.");
   }
 
+  // Mark the blocks that contain a difference (gray 128 is no difference, black no marked difference)
+  differenceBlocks.reset(outputImage.size());
+  differenceBlocks.markPlane(outputImage.constBits(), outputImage.bytesPerLine(), width, height, 4, markDifference ? 0 : 0x808080, 0xffffff);
+
   // Append the conversion information that will be returned
-  differenceInfoList.append(infoItem("Difference Type", QString("RGB %1bit").arg(srcPixelFormat.bitsPerValue)));
+  differenceInfoList.append(infoItem("Difference Type", QString("RGB %1bit").arg(format0.bitsPerValue)));
   double mse[4];
   mse[0] = double(mseAdd[0]) / (width * height);
   mse[1] = double(mseAdd[1]) / (width * height);
@@ -89,12 +89,15 @@ public:
   // to another videoHandlerRGB. If item2 cannot be converted to a videoHandlerRGB,
   // we will use the videoHandler::calculateDifference function to calculate the difference
   // using the 8bit RGB values.
-  virtual QImage calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference) Q_DECL_OVERRIDE;
+  virtual QImage calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks) Q_DECL_OVERRIDE;
+  virtual QImage calculateDifferenceForCaching(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks) Q_DECL_OVERRIDE;
   
   // Load the given frame and convert it to image. After this, currentFrameRawRGBData and currentFrame will
   // contain the frame with the given frame index.
   virtual void loadFrame(int frameIndex, bool loadToDoubleBuffer=false) Q_DECL_OVERRIDE;
 
+  virtual QImage convertFrameToImage(const FrameBuffer &frame) Q_DECL_OVERRIDE;
+
 protected:
 
   // Which components should we display
@@ -147,6 +150,14 @@ private:
   // Load the raw RGB data for the given frame index into currentFrameRawRGBData.
   // Return false is loading failed.
   bool loadRawRGBData(int frameIndex);
+  // Load the raw RGB data for the given frame index without changing currentFrameRawData (like for caching).
+  // The format and the frame size that belong to the data are returned as well.
+  bool loadRawRGBDataForCaching(int frameIndex, QByteArray &buffer, RGB_Internals::rgbPixelFormat &rgbFormat, QSize &curFrameSize);
+
+  // Is the difference to the other item calculated on the raw RGB values (the bit depth must be identical)?
+  bool canCalculateRGBDifference(const videoHandlerRGB *rgbItem2) const;
+  // Calculate the difference of the two raw frames. This does not change any state of the handler.
+  QImage calculateDifferenceFromRawData(const QByteArray &rawData0, const RGB_Internals::rgbPixelFormat &format0, const QSize &size0, const QByteArray &rawData1, const RGB_Internals::rgbPixelFormat &format1, const QSize &size1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks) const;
 
   // Convert from RGB (which ever format is selected) to a QImage in the platform QImage format (platformImageFormat)
   void convertRGBToImage(const QByteArray &sourceBuffer, QImage &outputImage);
@@ -156,6 +167,8 @@ private:
 
   // Convert one frame from the current pixel format to RGB888
   void convertSourceToRGBA32Bit(const QByteArray &sourceBuffer, unsigned char *targetBuffer);
+  // Convert only the pixels from pixelBegin to pixelEnd (exclusive, in raster order). Used to convert bands of rows in parallel.
+  void convertSourceToRGBA32Bit(const QByteArray &sourceBuffer, unsigned char *targetBuffer, int pixelBegin, int pixelEnd);
   QByteArray tmpBufferRawRGBDataCaching;
 
   // When a caching job is running in the background it will lock this mutex, so that
@@ -40,8 +40,12 @@
 #include <QDir>
 #include <QPainter>
 
+#include "DifferenceKernels.h"
+#include "RowBands.h"
+#include "ScaledYUVConversion.h"
 #include "videoHandlerYUVCustomFormatDialog.h"
 #include "yuvPixelFormatGuess.h"
+#include "common/FrameProfiler.h"
 #include "common/fileInfo.h"
 #include "common/functions.h"
 
@@ -690,9 +694,6 @@ void videoHandlerYUV::drawPixelValues(QPainter *painter, const int frameIdx, con
   QRect pixelRect;
   pixelRect.setSize(QSize(zoomFactor, zoomFactor));
 
-  // We might change the pen doing this so backup the current pen and reset it later
-  QPen backupPen = painter->pen();
-
   // If the Y is below this value, use white text, otherwise black text
   // If there is a second item, a difference will be drawn. A difference of 0 is displayed as gray.
   const int whiteLimit = (yuvItem2) ? 0 : 1 << (srcPixelFormat.bitsPerSample - 1);
@@ -712,6 +713,9 @@ void videoHandlerYUV::drawPixelValues(QPainter *painter, const int frameIdx, con
   // If 'showPixelValuesAsDiff' is set, this is the zero value
   const int differenceZeroValue = 1 << (srcPixelFormat.bitsPerSample - 1);
 
+  const int formatBase = settings.value("ShowPixelValuesHex").toBool() ? 16 : 10;
+  // All values are collected and drawn from the glyph atlas in one batch
+  pixelValueGlyphs.begin(painter);
   for (int x = xMin; x <= xMax; x++)
   {
     for (int y = yMin; y <= yMax; y++)
@@ -769,28 +773,24 @@ void videoHandlerYUV::drawPixelValues(QPainter *painter, const int frameIdx, con
         drawWhite = (mathParameters[Component::Luma].invert) ? (Y > whiteLimit) : (Y < whiteLimit);
       }
 
-      const int formatBase = settings.value("ShowPixelValuesHex").toBool() ? 16 : 10;
-      const QString YString = ((Y < 0) ? "-" : "") + QString::number(std::abs(Y), formatBase);
-      const QString UString = ((U < 0) ? "-" : "") + QString::number(std::abs(U), formatBase);
-      const QString VString = ((V < 0) ? "-" : "") + QString::number(std::abs(V), formatBase);
-
-      painter->setPen(drawWhite ? Qt::white : Qt::black);
-
       if (chromaPresent && (x-chromaOffsetFullX) % subsamplingX == 0 && (y-chromaOffsetFullY) % subsamplingY == 0)
       {
-        QString valText;
-        if (chromaOffsetHalfX || chromaOffsetHalfY)
-          // We will only draw the Y value at the center of this pixel
-          valText = QString("Y%1").arg(YString);
-        else
+        GlyphAtlas::Text valText;
+        valText.addValue('Y', Y, formatBase);
+        if (!chromaOffsetHalfX && !chromaOffsetHalfY)
+        {
           // We also draw the U and V value at this position
-          valText = QString("Y%1\nU%2\nV%3").arg(YString, UString, VString);
-        painter->drawText(pixelRect, Qt::AlignCenter, valText);
+          valText.addValue('U', U, formatBase);
+          valText.addValue('V', V, formatBase);
+        }
+        pixelValueGlyphs.addText(pixelRect, valText, drawWhite);
 
         if (chromaOffsetHalfX || chromaOffsetHalfY)
         {
           // Draw the U and V values shifted half a pixel right and/or down
-          valText = QString("U%1\nV%2").arg(UString, VString);
+          GlyphAtlas::Text chromaText;
+          chromaText.addValue('U', U, formatBase);
+          chromaText.addValue('V', V, formatBase);
 
           // Move the QRect by half a pixel
           if (chromaOffsetHalfX)
@@ -798,20 +798,19 @@ void videoHandlerYUV::drawPixelValues(QPainter *painter, const int frameIdx, con
           if (chromaOffsetHalfY)
             pixelRect.translate(0, zoomFactor/2);
 
-          painter->drawText(pixelRect, Qt::AlignCenter, valText);
+          pixelValueGlyphs.addText(pixelRect, chromaText, drawWhite);
         }
       }
       else
       {
         // We only draw the luma value for this pixel
-        QString valText = QString("Y%1").arg(YString);
-        painter->drawText(pixelRect, Qt::AlignCenter, valText);
+        GlyphAtlas::Text valText;
+        valText.addValue('Y', Y, formatBase);
+        pixelValueGlyphs.addText(pixelRect, valText, drawWhite);
       }
     }
   }
-
-  // Reset pen
-  painter->setPen(backupPen);
+  pixelValueGlyphs.end(painter);
 }
 
 void videoHandlerYUV::setFormatFromSizeAndName(const QSize size, int bitDepth, bool packed, int64_t fileSize, const QFileInfo &fileInfo)
@@ -969,6 +968,13 @@ bool videoHandlerYUV::setFormatFromString(QString format)
   return true;
 }
 
+QImage videoHandlerYUV::convertFrameToImage(const FrameBuffer &frame)
+{
+  QImage image;
+  this->convertYUVToImage(frame, image, this->srcPixelFormat, this->frameSize);
+  return image;
+}
+
 void videoHandlerYUV::loadFrame(int frameIndex, bool loadToDoubleBuffer)
 {
   DEBUG_YUV("videoHandlerYUV::loadFrame " << frameIndex);
@@ -977,26 +983,34 @@ void videoHandlerYUV::loadFrame(int frameIndex, bool loadToDoubleBuffer)
     // We cannot load a frame if the format is not known
     return;
 
-  // Does the data in currentFrameRawData need to be updated?
+  // Does the data in currentFrameBuffer need to be updated?
   if (!loadRawYUVData(frameIndex))
     // Loading failed or it is still being performed in the background
     return;
 
-  // The data in currentFrameRawData is now up to date. If necessary
+  // The data in currentFrameBuffer is now up to date. If necessary
   // convert the data to RGB.
   if (loadToDoubleBuffer)
   {
+    // While playing zoomed out, only convert what is drawn. The full image is loaded again when playback stops
+    // at a zoom factor that needs it (see needsLoading).
     QImage newImage;
-    convertYUVToImage(currentFrameRawData, newImage, srcPixelFormat, frameSize);
-    doubleBufferImage = newImage;
-    doubleBufferImageFrameIdx = frameIndex;
+    const int level = reducedSizeAllowed ? nrPyramidLevelsToBuild.load() : 0;
+    if (level > 0 && convertYUVToScaledImage(currentFrameBuffer, newImage, srcPixelFormat, frameSize, level))
+      setDoubleBufferImage(newImage, frameIndex, level);
+    else
+    {
+      convertYUVToImage(currentFrameBuffer, newImage, srcPixelFormat, frameSize);
+      setDoubleBufferImage(newImage, frameIndex);
+    }
   }
-  else if (currentImageIdx != frameIndex)
+  else if (currentImageIdx != frameIndex || currentImageScaleLevel > 0)
   {
     QImage newImage;
-    convertYUVToImage(currentFrameRawData, newImage, srcPixelFormat, frameSize);
+    convertYUVToImage(currentFrameBuffer, newImage, srcPixelFormat, frameSize);
     QMutexLocker setLock(&currentImageSetMutex);    
     currentImage = newImage;
+    currentImageScaleLevel = 0;
     currentImageIdx = frameIndex;
   }
 }
@@ -1005,16 +1019,10 @@ void videoHandlerYUV::loadFrameForCaching(int frameIndex, QImage &frameToCache)
 {
   DEBUG_YUV("videoHandlerYUV::loadFrameForCaching " << frameIndex);
 
-  // Get the YUV format and the size here, so that the caching process does not crash if this changes.
-  yuvPixelFormat yuvFormat = srcPixelFormat;
-  const QSize curFrameSize = frameSize;
-
-  requestDataMutex.lock();
-  emit signalRequestRawData(frameIndex, true);
-  QByteArray tmpBufferRawYUVDataCaching = rawData;
-  requestDataMutex.unlock();
-
-  if (frameIndex != rawData_frameIdx)
+  FrameBuffer tmpBufferRawYUVDataCaching;
+  yuvPixelFormat yuvFormat;
+  QSize curFrameSize;
+  if (!loadRawYUVDataForCaching(frameIndex, tmpBufferRawYUVDataCaching, yuvFormat, curFrameSize))
   {
     // Loading failed
     DEBUG_YUV("videoHandlerYUV::loadFrameForCaching Loading failed");
@@ -1025,7 +1033,22 @@ void videoHandlerYUV::loadFrameForCaching(int frameIndex, QImage &frameToCache)
   convertYUVToImage(tmpBufferRawYUVDataCaching, frameToCache, yuvFormat, curFrameSize);
 }
 
-// Load the raw YUV data for the given frame index into currentFrameRawData.
+bool videoHandlerYUV::loadRawYUVDataForCaching(int frameIndex, FrameBuffer &buffer, yuvPixelFormat &yuvFormat, QSize &curFrameSize)
+{
+  // Get the YUV format and the size here, so that the caching process does not crash if this changes.
+  yuvFormat = srcPixelFormat;
+  curFrameSize = frameSize;
+
+  QMutexLocker lock(&requestDataMutex);
+  emit signalRequestRawData(frameIndex, true);
+  if (frameIndex != rawData_frameIdx)
+    return false;
+
+  buffer = rawFrameBuffer.isNull() ? FrameBuffer(rawData) : rawFrameBuffer;
+  return !buffer.isNull();
+}
+
+// Load the raw YUV data for the given frame index into currentFrameBuffer.
 bool videoHandlerYUV::loadRawYUVData(int frameIndex)
 {
   if (currentFrameRawData_frameIdx == frameIndex && cacheValid)
@@ -1039,7 +1062,7 @@ bool videoHandlerYUV::loadRawYUVData(int frameIndex)
   requestDataMutex.lock();
   emit signalRequestRawData(frameIndex, false);
 
-  if (frameIndex != rawData_frameIdx || rawData.isEmpty())
+  if (frameIndex != rawData_frameIdx || (rawFrameBuffer.isNull() && rawData.isEmpty()))
   {
     // Loading failed
     DEBUG_YUV("videoHandlerYUV::loadRawYUVData Loading failed");
@@ -1047,7 +1070,9 @@ bool videoHandlerYUV::loadRawYUVData(int frameIndex)
     return false;
   }
 
-  currentFrameRawData = rawData;
+  // The raw data is not copied here. If the decoder provided its picture as a FrameBuffer, the
+  // conversion reads directly from the planes of the decoder.
+  currentFrameBuffer = rawFrameBuffer.isNull() ? FrameBuffer(rawData) : rawFrameBuffer;
   currentFrameRawData_frameIdx = frameIndex;
   requestDataMutex.unlock();
   
@@ -2284,7 +2309,7 @@ bool videoHandlerYUV::convertYUVPackedToPlanar(const QByteArray &sourceBuffer, Q
   return true;
 }
 
-bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, uchar *targetBuffer, const QSize &curFrameSize, const yuvPixelFormat &sourceBufferFormat) const
+bool videoHandlerYUV::convertYUVPlanarToRGB(const FrameBuffer &sourceBuffer, uchar *targetBuffer, const QSize &curFrameSize, const yuvPixelFormat &sourceBufferFormat, bool splitIntoBands) const
 {
   // These are constant for the runtime of this function. This way, the compiler can optimize the
   // hell out of this function.
@@ -2322,6 +2347,90 @@ bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, ucha
   // If the U and V (and A if present) components are interlevaed, we have to skip every nth value in the input when reading U and V
   const auto inputValSkip = format.uvInterleaved ? ((format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YVU) ? 2 : 3) : 1;
 
+  // In case the U and V (and A if present) components are interleaved, the skip to the next plane is just 1 (or 2) bytes
+  int nrBytesToNextChromaPlane = nrBytesChromaPlane;
+  if (format.uvInterleaved)
+    nrBytesToNextChromaPlane = (bps > 8) ? 2 : 1;
+
+  // Get pointers to the luma plane and the two chroma planes (in the order of the format). If the planes of a decoder
+  // are wrapped and have no padding at the end of the lines, they are read directly. Otherwise, the contiguous data is used.
+  const unsigned char *srcPlanes[3];
+  QByteArray contiguousSource;
+  const bool readPlanesDirectly = (sourceBuffer.hasPlanes() && sourceBuffer.arePlanesTightlyPacked() && !format.uvInterleaved &&
+                                   sourceBuffer.getNrPlanes() >= ((format.subsampling == Subsampling::YUV_400) ? 1 : 3));
+  if (readPlanesDirectly)
+  {
+    for (int i = 0; i < 3; i++)
+      srcPlanes[i] = sourceBuffer.getPlane(std::min(i, sourceBuffer.getNrPlanes() - 1)).data;
+  }
+  else
+  {
+    contiguousSource = sourceBuffer.toByteArray();
+    srcPlanes[0] = (const unsigned char*)contiguousSource.data();
+    srcPlanes[1] = srcPlanes[0] + nrBytesLumaPlane;
+    srcPlanes[2] = srcPlanes[1] + nrBytesToNextChromaPlane;
+  }
+
+  // Is the U plane the first or the second?
+  const bool uPlaneFirst = (format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YUVA);
+
+  // Split the frame into bands of rows. Every band is converted like a frame of its own. This is only done if the
+  // conversion of a row does not depend on the rows of other bands (no vertical chroma interpolation).
+  const bool lumaOnly = (component == DisplayY || format.subsampling == Subsampling::YUV_400);
+  const bool rowsIndependent = lumaOnly || (component == DisplayAll && (format.getSubsamplingVer() == 1 || interpolation == ChromaInterpolation::NearestNeighbor));
+  const int rowAlignment = 4;
+  const int nrBands = (splitIntoBands && rowsIndependent) ? RowBands::getNrBands(curFrameSize, rowAlignment) : 1;
+  if (nrBands > 1)
+  {
+    // The planes that the bands read from. A chroma offset is resampled once for the whole frame and the bands
+    // then convert the resampled planes.
+    auto bandFormat = format;
+    const unsigned char *bandPlanes[3] = {srcPlanes[0], srcPlanes[1], srcPlanes[2]};
+    QByteArray uvPlaneChromaResampled[2];
+    if (!lumaOnly && (format.chromaOffset[0] != 0 || format.chromaOffset[1] != 0))
+    {
+      uvPlaneChromaResampled[0].resize(nrBytesChromaPlane);
+      uvPlaneChromaResampled[1].resize(nrBytesChromaPlane);
+      unsigned char *restrict dstU = (unsigned char*)uvPlaneChromaResampled[0].data();
+      unsigned char *restrict dstV = (unsigned char*)uvPlaneChromaResampled[1].data();
+      const unsigned char * restrict srcU = uPlaneFirst ? srcPlanes[1] : srcPlanes[2];
+      const unsigned char * restrict srcV = uPlaneFirst ? srcPlanes[2] : srcPlanes[1];
+      UVPlaneResamplingChromaOffset(format, w / format.getSubsamplingHor(), h / format.getSubsamplingVer(), srcU, srcV, inputValSkip, dstU, dstV);
+
+      bandPlanes[1] = dstU;
+      bandPlanes[2] = dstV;
+      bandFormat.planeOrder = PlaneOrder::YUV;
+      bandFormat.uvInterleaved = false;
+      bandFormat.chromaOffset[0] = 0;
+      bandFormat.chromaOffset[1] = 0;
+    }
+
+    const auto bytesPerSample = (bps > 8) ? 2 : 1;
+    const auto hasChroma = (format.subsampling != Subsampling::YUV_400);
+    const auto chromaWidthInBytes = hasChroma ? (w / format.getSubsamplingHor()) * bytesPerSample : 0;
+    const auto chromaSubsamplingVer = hasChroma ? format.getSubsamplingVer() : 1;
+    RowBands::run(h, nrBands, rowAlignment, [&](int rowBegin, int rowEnd) {
+      // Interleaved chroma is passed as one plane
+      FrameBuffer band((std::shared_ptr<void>()));
+      band.addPlane(bandPlanes[0] + rowBegin * w * bytesPerSample, w * bytesPerSample, w * bytesPerSample, rowEnd - rowBegin);
+      if (hasChroma)
+      {
+        const auto chromaRowBegin = rowBegin / chromaSubsamplingVer;
+        const auto chromaHeight = (rowEnd - rowBegin) / chromaSubsamplingVer;
+        if (bandFormat.uvInterleaved)
+        {
+          const auto lineBytes = chromaWidthInBytes * inputValSkip;
+          band.addPlane(bandPlanes[1] + chromaRowBegin * lineBytes, lineBytes, lineBytes, chromaHeight);
+        }
+        else
+          for (int i = 1; i < 3; i++)
+            band.addPlane(bandPlanes[i] + chromaRowBegin * chromaWidthInBytes, chromaWidthInBytes, chromaWidthInBytes, chromaHeight);
+      }
+      convertYUVPlanarToRGB(band, targetBuffer + rowBegin * w * 4, QSize(w, rowEnd - rowBegin), bandFormat, false);
+    });
+    return true;
+  }
+
   // A pointer to the output
   unsigned char * restrict dst = targetBuffer;
 
@@ -2331,7 +2440,7 @@ bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, ucha
     if (component == DisplayY || format.subsampling == Subsampling::YUV_400)
     {
       // Luma only. The chroma subsampling does not matter.
-      const unsigned char * restrict srcY = (unsigned char*)sourceBuffer.data();
+      const unsigned char * restrict srcY = srcPlanes[0];
       YUVPlaneToRGBMonochrome_444(componentSizeLuma, mathY, srcY, dst, inputMax, bps, format.bigEndian, 1, fullRange);
     }
     else
@@ -2339,17 +2448,8 @@ bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, ucha
       // Display only the U or V component
       bool firstComponent = (((format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YUVA) && component == DisplayCb) ||
                              ((format.planeOrder == PlaneOrder::YVU || format.planeOrder == PlaneOrder::YVUA) && component == DisplayCr));
-      
-      int srcOffset = nrBytesLumaPlane;
-      if (!firstComponent)
-      {
-        if (format.uvInterleaved)
-          srcOffset += (bps > 8) ? 2 : 1;
-        else
-          srcOffset += nrBytesChromaPlane;
-      }
 
-      const unsigned char * restrict srcC = (unsigned char*)sourceBuffer.data() + srcOffset;
+      const unsigned char * restrict srcC = firstComponent ? srcPlanes[1] : srcPlanes[2];
       if (format.subsampling == Subsampling::YUV_444)
         YUVPlaneToRGBMonochrome_444(componentSizeChroma, mathC, srcC, dst, inputMax, bps, format.bigEndian, inputValSkip, fullRange);
       else if (format.subsampling == Subsampling::YUV_422)
@@ -2368,14 +2468,6 @@ bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, ucha
   }
   else
   {
-    // Is the U plane the first or the second?
-    const bool uPlaneFirst = (format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YUVA);
-
-    // In case the U and V (and A if present) components are interleaved, the skip to the next plane is just 1 (or 2) bytes
-    int nrBytesToNextChromaPlane = nrBytesChromaPlane;
-    if (format.uvInterleaved)
-      nrBytesToNextChromaPlane = (bps > 8) ? 2 : 1;
-
     // Get/set the parameters used for YUV -> RGB conversion
     int RGBConv[5];
     getColorConversionCoefficients(yuvColorConversionType, RGBConv);
@@ -2393,9 +2485,9 @@ bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, ucha
       unsigned char *restrict dstU = (unsigned char*)uvPlaneChromaResampled[0].data();
       unsigned char *restrict dstV = (unsigned char*)uvPlaneChromaResampled[1].data();
 
-      unsigned char * restrict srcY = (unsigned char*)sourceBuffer.data();
-      unsigned char * restrict srcU = uPlaneFirst ? srcY + nrBytesLumaPlane : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
-      unsigned char * restrict srcV = uPlaneFirst ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane: srcY + nrBytesLumaPlane;
+      const unsigned char * restrict srcY = srcPlanes[0];
+      const unsigned char * restrict srcU = uPlaneFirst ? srcPlanes[1] : srcPlanes[2];
+      const unsigned char * restrict srcV = uPlaneFirst ? srcPlanes[2] : srcPlanes[1];
       UVPlaneResamplingChromaOffset(format, w / format.getSubsamplingHor(), h / format.getSubsamplingVer(), srcU, srcV, inputValSkip, dstU, dstV);
 
       if (format.subsampling == Subsampling::YUV_444)
@@ -2416,9 +2508,9 @@ bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, ucha
     else
     {
       // Get the pointers to the source planes (8 bit per sample)
-      const unsigned char * restrict srcY = (unsigned char*)sourceBuffer.data();
-      const unsigned char * restrict srcU = uPlaneFirst ? srcY + nrBytesLumaPlane : srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane;
-      const unsigned char * restrict srcV = uPlaneFirst ? srcY + nrBytesLumaPlane + nrBytesToNextChromaPlane: srcY + nrBytesLumaPlane;
+      const unsigned char * restrict srcY = srcPlanes[0];
+      const unsigned char * restrict srcU = uPlaneFirst ? srcPlanes[1] : srcPlanes[2];
+      const unsigned char * restrict srcV = uPlaneFirst ? srcPlanes[2] : srcPlanes[1];
 
       if (format.subsampling == Subsampling::YUV_444)
         YUVPlaneToRGB_444(componentSizeLuma, mathY, mathC, srcY, srcU, srcV, dst, RGBConv, fullRange, inputMax, bps, format.bigEndian, inputValSkip);
@@ -2442,10 +2534,36 @@ bool videoHandlerYUV::convertYUVPlanarToRGB(const QByteArray &sourceBuffer, ucha
   return true;
 }
 
+// Create an image that the conversion functions can write to (BGRA, each 8 bit)
+inline QImage createImageForConversion(const QSize &size)
+{
+  // In both cases, we will set the alpha channel to 255. The format of the raw buffer is: BGRA (each 8 bit).
+  // Internally, this is how QImage allocates the number of bytes per line (with depth = 32):
+  // const int bytes_per_line = ((width * depth + 31) >> 5) << 2; // bytes per scanline (must be multiple of 4)
+  if (is_Q_OS_WIN || is_Q_OS_MAC)
+    return QImage(size, functions::platformImageFormat());
+  QImage::Format f = functions::platformImageFormat();
+  if (f == QImage::Format_ARGB32_Premultiplied || f == QImage::Format_ARGB32)
+    return QImage(size, f);
+  return QImage(size, QImage::Format_RGB32);
+}
+
+// On linux, we may have to convert the image to the platform image format if it is not one of the RGBA formats.
+inline void convertToPlatformImageFormat(QImage &image)
+{
+  if (is_Q_OS_LINUX)
+  {
+    QImage::Format f = functions::platformImageFormat();
+    if (f != QImage::Format_ARGB32_Premultiplied && f != QImage::Format_ARGB32 && f != QImage::Format_RGB32)
+      image = image.convertToFormat(f);
+  }
+}
+
 // Convert the given raw YUV data in sourceBuffer (using srcPixelFormat) to image (RGB-888), using the
 // buffer tmpRGBBuffer for intermediate RGB values.
-void videoHandlerYUV::convertYUVToImage(const QByteArray &sourceBuffer, QImage &outputImage, const yuvPixelFormat &yuvFormat, const QSize &curFrameSize)
+void videoHandlerYUV::convertYUVToImage(const FrameBuffer &sourceBuffer, QImage &outputImage, const yuvPixelFormat &yuvFormat, const QSize &curFrameSize)
 {
+  FRAME_PROFILER_SCOPE("Convert YUV");
   if (!yuvFormat.canConvertToRGB(curFrameSize))
   {
     outputImage = QImage();
@@ -2455,19 +2573,7 @@ void videoHandlerYUV::convertYUVToImage(const QByteArray &sourceBuffer, QImage &
   DEBUG_YUV("videoHandlerYUV::convertYUVToImage");
 
   // Create the output image in the right format.
-  // In both cases, we will set the alpha channel to 255. The format of the raw buffer is: BGRA (each 8 bit).
-  // Internally, this is how QImage allocates the number of bytes per line (with depth = 32):
-  // const int bytes_per_line = ((width * depth + 31) >> 5) << 2; // bytes per scanline (must be multiple of 4)
-  if (is_Q_OS_WIN || is_Q_OS_MAC)
-    outputImage = QImage(curFrameSize, functions::platformImageFormat());
-  else if (is_Q_OS_LINUX)
-  {
-    QImage::Format f = functions::platformImageFormat();
-    if (f == QImage::Format_ARGB32_Premultiplied || f == QImage::Format_ARGB32)
-      outputImage = QImage(curFrameSize, f);
-    else
-      outputImage = QImage(curFrameSize, QImage::Format_RGB32);
-  }
+  outputImage = createImageForConversion(curFrameSize);
 
   // Check the image buffer size before we write to it
 #if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
@@ -2496,24 +2602,88 @@ void videoHandlerYUV::convertYUVToImage(const QByteArray &sourceBuffer, QImage &
     QByteArray tmpPlanarYUVSource;
     // This is the current format of the buffer. The conversion function will change this.
     yuvPixelFormat bufferPixelFormat = yuvFormat;
-    convOK &= convertYUVPackedToPlanar(sourceBuffer, tmpPlanarYUVSource, curFrameSize, bufferPixelFormat);
+    convOK &= convertYUVPackedToPlanar(sourceBuffer.toByteArray(), tmpPlanarYUVSource, curFrameSize, bufferPixelFormat);
 
     if (convOK)
-      convOK &= convertYUVPlanarToRGB(tmpPlanarYUVSource, outputImage.bits(), curFrameSize, bufferPixelFormat);
+      convOK &= convertYUVPlanarToRGB(FrameBuffer(tmpPlanarYUVSource), outputImage.bits(), curFrameSize, bufferPixelFormat);
   }
 
   assert(convOK);
 
-  if (is_Q_OS_LINUX)
+  convertToPlatformImageFormat(outputImage);
+
+  DEBUG_YUV("videoHandlerYUV::convertYUVToImage Done");
+}
+
+bool videoHandlerYUV::convertYUVToScaledImage(const FrameBuffer &sourceBuffer, QImage &outputImage, const yuvPixelFormat &yuvFormat, const QSize &curFrameSize, int level)
+{
+  // Only the plain conversion of planar formats is supported. Everything else goes through convertYUVToImage.
+  if (level <= 0 || !yuvFormat.canConvertToRGB(curFrameSize) || !yuvFormat.planar || yuvFormat.uvInterleaved || yuvFormat.bitsPerSample > 16 ||
+      componentDisplayMode != DisplayAll || mathParameters[Component::Luma].mathRequired() || mathParameters[Component::Chroma].mathRequired())
+    return false;
+
+  const auto scaledSize = ScaledYUVConversion::getScaledSize(curFrameSize, level);
+  if (scaledSize.width() <= 0 || scaledSize.height() <= 0)
+    return false;
+
+  DEBUG_YUV("videoHandlerYUV::convertYUVToScaledImage level " << level);
+
+  ScaledYUVConversion::Source source;
+  source.frameSize = curFrameSize;
+  source.hasChroma = (yuvFormat.subsampling != Subsampling::YUV_400);
+  source.subsamplingHor = yuvFormat.getSubsamplingHor();
+  source.subsamplingVer = yuvFormat.getSubsamplingVer();
+  source.bitsPerSample = yuvFormat.bitsPerSample;
+  source.bigEndian = yuvFormat.bigEndian;
+
+  // Read the planes of a decoder directly (with their strides). A contiguous buffer has no padding.
+  const auto nrPlanes = source.hasChroma ? 3 : 1;
+  const auto bytesPerSample = (yuvFormat.bitsPerSample > 8) ? 2 : 1;
+  const unsigned char *srcPlanes[3] {nullptr, nullptr, nullptr};
+  int srcStrides[3] {0, 0, 0};
+  QByteArray contiguousSource;
+  if (sourceBuffer.hasPlanes() && sourceBuffer.getNrPlanes() >= nrPlanes)
   {
-    // On linux, we may have to convert the image to the platform image format if it is not one of the
-    // RGBA formats.
-    QImage::Format f = functions::platformImageFormat();
-    if (f != QImage::Format_ARGB32_Premultiplied && f != QImage::Format_ARGB32 && f != QImage::Format_RGB32)
-      outputImage = outputImage.convertToFormat(f);
+    for (int i = 0; i < nrPlanes; i++)
+    {
+      srcPlanes[i] = sourceBuffer.getPlane(i).data;
+      srcStrides[i] = sourceBuffer.getPlane(i).stride;
+    }
+  }
+  else
+  {
+    contiguousSource = sourceBuffer.toByteArray();
+    const auto chromaWidth = source.hasChroma ? curFrameSize.width() / source.subsamplingHor : 0;
+    const auto chromaHeight = source.hasChroma ? curFrameSize.height() / source.subsamplingVer : 0;
+    if (contiguousSource.size() < (curFrameSize.width() * curFrameSize.height() + 2 * chromaWidth * chromaHeight) * bytesPerSample)
+      return false;
+    srcPlanes[0] = (const unsigned char*)contiguousSource.constData();
+    srcPlanes[1] = srcPlanes[0] + curFrameSize.width() * curFrameSize.height() * bytesPerSample;
+    srcPlanes[2] = srcPlanes[1] + chromaWidth * chromaHeight * bytesPerSample;
+    srcStrides[0] = curFrameSize.width() * bytesPerSample;
+    srcStrides[1] = chromaWidth * bytesPerSample;
+    srcStrides[2] = chromaWidth * bytesPerSample;
   }
 
-  DEBUG_YUV("videoHandlerYUV::convertYUVToImage Done");
+  // Is the U plane the first or the second?
+  const bool uPlaneFirst = (yuvFormat.planeOrder == PlaneOrder::YUV || yuvFormat.planeOrder == PlaneOrder::YUVA);
+  source.planes[0] = srcPlanes[0];
+  source.planes[1] = uPlaneFirst ? srcPlanes[1] : srcPlanes[2];
+  source.planes[2] = uPlaneFirst ? srcPlanes[2] : srcPlanes[1];
+  source.strides[0] = srcStrides[0];
+  source.strides[1] = uPlaneFirst ? srcStrides[1] : srcStrides[2];
+  source.strides[2] = uPlaneFirst ? srcStrides[2] : srcStrides[1];
+
+  int RGBConv[5];
+  getColorConversionCoefficients(yuvColorConversionType, RGBConv);
+  const bool fullRange = (yuvColorConversionType == ColorConversion::BT709_FullRange || yuvColorConversionType == ColorConversion::BT601_FullRange || yuvColorConversionType == ColorConversion::BT2020_FullRange);
+
+  outputImage = createImageForConversion(scaledSize);
+  ScaledYUVConversion::convert(source, level, RGBConv, fullRange, outputImage.bits(), outputImage.bytesPerLine(), RowBands::getNrBands(scaledSize));
+  convertToPlatformImageFormat(outputImage);
+
+  DEBUG_YUV("videoHandlerYUV::convertYUVToScaledImage Done");
+  return true;
 }
 
 videoHandlerYUV::yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) const
@@ -2524,6 +2694,11 @@ videoHandlerYUV::yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) co
 
   yuv_t value = {0, 0, 0};
 
+  // Planes that were provided by a decoder are packed when the first value is requested
+  const QByteArray rawYUVData = currentFrameBuffer.toByteArray();
+  if (rawYUVData.isEmpty())
+    return value;
+
   if (format.planar)
   {
     // The luma component has full resolution. The size of each chroma components depends on the subsampling.
@@ -2535,7 +2710,7 @@ videoHandlerYUV::yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) co
     const int nrBytesChromaPlane = (format.bitsPerSample > 8) ? componentSizeChroma * 2 : componentSizeChroma;
 
     // Luma first
-    const unsigned char * restrict srcY = (unsigned char*)currentFrameRawData.data();
+    const unsigned char * restrict srcY = (unsigned char*)rawYUVData.data();
     const unsigned int offsetCoordinateY  = w * pixelPos.y() + pixelPos.x();
     value.Y = getValueFromSource(srcY, offsetCoordinateY,  format.bitsPerSample, format.bigEndian);
 
@@ -2559,7 +2734,7 @@ videoHandlerYUV::yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) co
         const unsigned char * restrict srcU = uFirst ? srcY + nrBytesLumaPlane : srcY + nrBytesLumaPlane + nrBytesChromaPlane;
         const unsigned char * restrict srcV = uFirst ? srcY + nrBytesLumaPlane + nrBytesChromaPlane: srcY + nrBytesLumaPlane;
 
-        // Get the YUV data from the currentFrameRawData
+        // Get the YUV data from the current frame
         const unsigned int offsetCoordinateUV = (w / format.getSubsamplingHor() * (pixelPos.y() / format.getSubsamplingVer())) + pixelPos.x() / format.getSubsamplingHor();
         
         value.U = getValueFromSource(srcU, offsetCoordinateUV, format.bitsPerSample, format.bigEndian);
@@ -2580,7 +2755,7 @@ videoHandlerYUV::yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) co
 
       // The offset of the pixel in bytes
       const unsigned int offsetCoordinate4Block = (w * 2 * pixelPos.y() + (pixelPos.x() / 2 * 4)) * (format.bitsPerSample > 8 ? 2 : 1);
-      const unsigned char * restrict src = (unsigned char*)currentFrameRawData.data() + offsetCoordinate4Block;
+      const unsigned char * restrict src = (unsigned char*)rawYUVData.data() + offsetCoordinate4Block;
 
       value.Y = getValueFromSource(src, (pixelPos.x() % 2 == 0) ? oY : oY + 2,  format.bitsPerSample, format.bigEndian);
       value.U = getValueFromSource(src, oU, format.bitsPerSample, format.bigEndian);
@@ -2597,7 +2772,7 @@ videoHandlerYUV::yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) co
       // How many bytes to the next sample?
       const int offsetNext = (packing == PackingOrder::YUV || packing == PackingOrder::YVU ? 3 : 4) * (format.bitsPerSample > 8 ? 2 : 1);
       const int offsetSrc = (w * pixelPos.y() + pixelPos.x()) * offsetNext;
-      const unsigned char * restrict src = (unsigned char*)currentFrameRawData.data() + offsetSrc;
+      const unsigned char * restrict src = (unsigned char*)rawYUVData.data() + offsetSrc;
 
       value.Y = getValueFromSource(src, oY, format.bitsPerSample, format.bigEndian);
       value.U = getValueFromSource(src, oU, format.bitsPerSample, format.bigEndian);
@@ -2614,7 +2789,7 @@ videoHandlerYUV::yuv_t videoHandlerYUV::getPixelValue(const QPoint &pixelPos) co
 #if SSE_CONVERSION
 bool videoHandlerYUV::convertYUV420ToRGB(const byteArrayAligned &sourceBuffer, byteArrayAligned &targetBuffer)
 #else
-bool videoHandlerYUV::convertYUV420ToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &size, const yuvPixelFormat format)
+bool videoHandlerYUV::convertYUV420ToRGB(const FrameBuffer &sourceBuffer, unsigned char *targetBuffer, const QSize &size, const yuvPixelFormat format)
 #endif
 {
   const int frameWidth = size.width();
@@ -2625,7 +2800,7 @@ bool videoHandlerYUV::convertYUV420ToRGB(const QByteArray &sourceBuffer, unsigne
   
   int componentLenghtY  = frameWidth * frameHeight;
   int componentLengthUV = componentLenghtY >> 2;
-  Q_ASSERT(sourceBuffer.size() >= componentLenghtY + componentLengthUV + componentLengthUV); // YUV 420 must be (at least) 1.5*Y-area
+  Q_ASSERT(sourceBuffer.getNrBytes() >= componentLenghtY + componentLengthUV + componentLengthUV); // YUV 420 must be (at least) 1.5*Y-area
 
 #if SSE_CONVERSION_420_ALT
   quint8 *srcYRaw = (quint8*) sourceBuffer.data();
@@ -2740,91 +2915,121 @@ bool videoHandlerYUV::convertYUV420ToRGB(const QByteArray &sourceBuffer, unsigne
   int RGBConv[5];
   getColorConversionCoefficients(yuvColorConversionType, RGBConv);
   
-  // Get pointers to the source and the output array
-  const bool uPplaneFirst = (format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YUVA); // Is the U plane the first or the second?
-  const unsigned char * restrict srcY = (unsigned char*)sourceBuffer.data();
-  const unsigned char * restrict srcU = uPplaneFirst ? srcY + componentLenghtY : srcY + componentLenghtY + componentLengthUV;
-  const unsigned char * restrict srcV = uPplaneFirst ? srcY + componentLenghtY + componentLengthUV : srcY + componentLenghtY;
-
-  int yh;
-  for (yh=0; yh < frameHeight / 2; yh++)
+  // Get pointers to the source planes and their strides. The planes of a decoder are read directly (including
+  // padding at the end of the lines). A contiguous buffer has no padding.
+  const unsigned char *srcPlanes[3];
+  int srcStrides[3];
+  QByteArray contiguousSource;
+  if (sourceBuffer.hasPlanes() && sourceBuffer.getNrPlanes() >= 3)
   {
-    // Process two lines at once, always 4 RGB values at a time (they have the same U/V components)
-
-    int dstAddr1 = yh * 2 * frameWidth * 4;         // The RGB output address of line yh*2
-    int dstAddr2 = (yh * 2 + 1) * frameWidth * 4;   // The RGB output address of line yh*2+1
-    int srcAddrY1 = yh * 2 * frameWidth;            // The Y source address of line yh*2
-    int srcAddrY2 = (yh * 2 + 1) * frameWidth;      // The Y source address of line yh*2+1
-    int srcAddrUV = yh * frameWidth / 2;            // The UV source address of both lines (UV are identical)
+    for (int i = 0; i < 3; i++)
+    {
+      srcPlanes[i] = sourceBuffer.getPlane(i).data;
+      srcStrides[i] = sourceBuffer.getPlane(i).stride;
+    }
+  }
+  else
+  {
+    contiguousSource = sourceBuffer.toByteArray();
+    srcPlanes[0] = (const unsigned char*)contiguousSource.data();
+    srcPlanes[1] = srcPlanes[0] + componentLenghtY;
+    srcPlanes[2] = srcPlanes[1] + componentLengthUV;
+    srcStrides[0] = frameWidth;
+    srcStrides[1] = frameWidth / 2;
+    srcStrides[2] = frameWidth / 2;
+  }
 
-    for (int xh=0, x=0; xh < frameWidth / 2; xh++, x+=2)
+  // Get pointers to the source and the output array
+  const bool uPplaneFirst = (format.planeOrder == PlaneOrder::YUV || format.planeOrder == PlaneOrder::YUVA); // Is the U plane the first or the second?
+  const unsigned char * restrict srcY = srcPlanes[0];
+  const unsigned char * restrict srcU = uPplaneFirst ? srcPlanes[1] : srcPlanes[2];
+  const unsigned char * restrict srcV = uPplaneFirst ? srcPlanes[2] : srcPlanes[1];
+  const int strideY = srcStrides[0];
+  const int strideU = uPplaneFirst ? srcStrides[1] : srcStrides[2];
+  const int strideV = uPplaneFirst ? srcStrides[2] : srcStrides[1];
+
+  // Convert bands of line pairs in parallel
+  RowBands::run(frameHeight / 2, RowBands::getNrBands(size, 2), 1, [&](int yhBegin, int yhEnd) {
+    for (int yh = yhBegin; yh < yhEnd; yh++)
     {
-      // Process four pixels (the ones for which U/V are valid
+      // Process two lines at once, always 4 RGB values at a time (they have the same U/V components)
 
-      // Load UV and pre-multiply
-      const int U_tmp_G = ((int)srcU[srcAddrUV + xh] - cZero) * RGBConv[2];
-      const int U_tmp_B = ((int)srcU[srcAddrUV + xh] - cZero) * RGBConv[4];
-      const int V_tmp_R = ((int)srcV[srcAddrUV + xh] - cZero) * RGBConv[1];
-      const int V_tmp_G = ((int)srcV[srcAddrUV + xh] - cZero) * RGBConv[3];
+      int dstAddr1 = yh * 2 * frameWidth * 4;         // The RGB output address of line yh*2
+      int dstAddr2 = (yh * 2 + 1) * frameWidth * 4;   // The RGB output address of line yh*2+1
+      int srcAddrY1 = yh * 2 * strideY;               // The Y source address of line yh*2
+      int srcAddrY2 = (yh * 2 + 1) * strideY;         // The Y source address of line yh*2+1
+      int srcAddrU = yh * strideU;                    // The U/V source addresses of both lines (UV are identical)
+      int srcAddrV = yh * strideV;
 
-      // Pixel top left
+      for (int xh=0, x=0; xh < frameWidth / 2; xh++, x+=2)
       {
-        const int Y_tmp = ((int)srcY[srcAddrY1 + x] - yOffset) * RGBConv[0];
+        // Process four pixels (the ones for which U/V are valid
 
-        const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+        // Load UV and pre-multiply
+        const int U_tmp_G = ((int)srcU[srcAddrU + xh] - cZero) * RGBConv[2];
+        const int U_tmp_B = ((int)srcU[srcAddrU + xh] - cZero) * RGBConv[4];
+        const int V_tmp_R = ((int)srcV[srcAddrV + xh] - cZero) * RGBConv[1];
+        const int V_tmp_G = ((int)srcV[srcAddrV + xh] - cZero) * RGBConv[3];
 
-        dst[dstAddr1]   = clip_buf[B_tmp];
-        dst[dstAddr1+1] = clip_buf[G_tmp];
-        dst[dstAddr1+2] = clip_buf[R_tmp];
-        dst[dstAddr1+3] = 255;
-        dstAddr1 += 4;
-      }
-      // Pixel top right
-      {
-        const int Y_tmp = ((int)srcY[srcAddrY1 + x + 1] - yOffset) * RGBConv[0];
+        // Pixel top left
+        {
+          const int Y_tmp = ((int)srcY[srcAddrY1 + x] - yOffset) * RGBConv[0];
 
-        const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+          const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
+          const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
+          const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
 
-        dst[dstAddr1]   = clip_buf[B_tmp];
-        dst[dstAddr1+1] = clip_buf[G_tmp];
-        dst[dstAddr1+2] = clip_buf[R_tmp];
-        dst[dstAddr1+3] = 255;
-        dstAddr1 += 4;
-      }
-      // Pixel bottom left
-      {
-        const int Y_tmp = ((int)srcY[srcAddrY2 + x] - yOffset) * RGBConv[0];
+          dst[dstAddr1]   = clip_buf[B_tmp];
+          dst[dstAddr1+1] = clip_buf[G_tmp];
+          dst[dstAddr1+2] = clip_buf[R_tmp];
+          dst[dstAddr1+3] = 255;
+          dstAddr1 += 4;
+        }
+        // Pixel top right
+        {
+          const int Y_tmp = ((int)srcY[srcAddrY1 + x + 1] - yOffset) * RGBConv[0];
 
-        const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+          const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
+          const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
+          const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
 
-        dst[dstAddr2]   = clip_buf[B_tmp];
-        dst[dstAddr2+1] = clip_buf[G_tmp];
-        dst[dstAddr2+2] = clip_buf[R_tmp];
-        dst[dstAddr2+3] = 255;
-        dstAddr2 += 4;
-      }
-      // Pixel bottom right
-      {
-        const int Y_tmp = ((int)srcY[srcAddrY2 + x + 1] - yOffset) * RGBConv[0];
+          dst[dstAddr1]   = clip_buf[B_tmp];
+          dst[dstAddr1+1] = clip_buf[G_tmp];
+          dst[dstAddr1+2] = clip_buf[R_tmp];
+          dst[dstAddr1+3] = 255;
+          dstAddr1 += 4;
+        }
+        // Pixel bottom left
+        {
+          const int Y_tmp = ((int)srcY[srcAddrY2 + x] - yOffset) * RGBConv[0];
 
-        const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
-        const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
-        const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+          const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
+          const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
+          const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
 
-        dst[dstAddr2]   = clip_buf[B_tmp];
-        dst[dstAddr2+1] = clip_buf[G_tmp];
-        dst[dstAddr2+2] = clip_buf[R_tmp];
-        dst[dstAddr2+3] = 255;
-        dstAddr2 += 4;
+          dst[dstAddr2]   = clip_buf[B_tmp];
+          dst[dstAddr2+1] = clip_buf[G_tmp];
+          dst[dstAddr2+2] = clip_buf[R_tmp];
+          dst[dstAddr2+3] = 255;
+          dstAddr2 += 4;
+        }
+        // Pixel bottom right
+        {
+          const int Y_tmp = ((int)srcY[srcAddrY2 + x + 1] - yOffset) * RGBConv[0];
+
+          const int R_tmp = (Y_tmp           + V_tmp_R) >> 16;
+          const int G_tmp = (Y_tmp + U_tmp_G + V_tmp_G) >> 16;
+          const int B_tmp = (Y_tmp + U_tmp_B          ) >> 16;
+
+          dst[dstAddr2]   = clip_buf[B_tmp];
+          dst[dstAddr2+1] = clip_buf[G_tmp];
+          dst[dstAddr2+2] = clip_buf[R_tmp];
+          dst[dstAddr2+3] = 255;
+          dstAddr2 += 4;
+        }
       }
     }
-  }
+  });
 
   return true;
 }
@@ -2851,7 +3056,7 @@ bool videoHandlerYUV::markDifferencesYUVPlanarToRGB(const QByteArray &sourceBuff
   const int nrBytesLumaPlane = (bps > 8) ? componentSizeLuma * 2 : componentSizeLuma;
   const int nrBytesChromaPlane = (bps > 8) ? componentSizeChroma * 2 : componentSizeChroma;
 
-  // Is this big endian (actually the difference buffer should always be big endian)
+  // Is this big endian (the difference buffer is little endian)
   const bool bigEndian = format.bigEndian;
 
   // A pointer to the output
@@ -2916,47 +3121,18 @@ bool videoHandlerYUV::markDifferencesYUVPlanarToRGB(const QByteArray &sourceBuff
   return true;
 }
 
-YUV_Internals::yuvPixelFormat videoHandlerYUV::getDiffYUVFormat() const
-{
-    return diffYUVFormat;
-}
-
-QByteArray videoHandlerYUV::getDiffYUV() const
+bool videoHandlerYUV::canCalculateYUVDifference(const videoHandlerYUV *yuvItem2) const
 {
-    return diffYUV;
+  // The given item must be a YUV source with the same subsampling. Otherwise, the RGB values are compared.
+  return yuvItem2 != nullptr && srcPixelFormat.subsampling == yuvItem2->srcPixelFormat.subsampling;
 }
 
-QImage videoHandlerYUV::calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference)
+QImage videoHandlerYUV::calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks)
 {
-  is_YUV_diff = false;
-
   videoHandlerYUV *yuvItem2 = dynamic_cast<videoHandlerYUV*>(item2);
-  if (yuvItem2 == nullptr)
-    // The given item is not a YUV source. We cannot compare YUV values to non YUV values.
+  if (!canCalculateYUVDifference(yuvItem2))
     // Call the base class comparison function to compare the items using the RGB values.
-    return videoHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference);
-
-  if (srcPixelFormat.subsampling != yuvItem2->srcPixelFormat.subsampling)
-    // The two items have different subsampling modes. Compare RGB values instead.
-    return videoHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference);
-
-  // Get/Set the bit depth of the input and output
-  // If the bit depth if the two items is different, we will scale the item with the lower bit depth up.
-  const int bps_in[2] = {srcPixelFormat.bitsPerSample, yuvItem2->srcPixelFormat.bitsPerSample};
-  const int bps_out = std::max(bps_in[0], bps_in[1]);
-  // Which of the two input values has to be scaled up? Only one of these (or neither) can be set.
-  const bool bitDepthScaling[2] = {bps_in[0] != bps_out, bps_in[1] != bps_out};
-  // Scale the input up by this many bits
-  const int depthScale = bps_out - (bitDepthScaling[0] ? bps_in[0] : bps_in[1]);
-  // Add a warning if the bit depths of the two inputs don't agree
-  if (bitDepthScaling[0] || bitDepthScaling[1])
-    differenceInfoList.append(infoItem("Warning", "The bit depth of the two items differs.", "The bit depth of the two input items is different. The lower bit depth will be scaled up and the difference is calculated."));
-  // What are the maximum and middle value for the output bit depth
-  const int diffZero = 128 << (bps_out-8);
-  const int maxVal = (1 << bps_out) - 1;
-
-  // Do we amplify the values?
-  const bool amplification = (amplificationFactor != 1 && !markDifference);
+    return videoHandler::calculateDifference(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
 
   // Load the right raw YUV data (if not already loaded).
   // This will just update the raw YUV data. No conversion to image (RGB) is performed. This is either
@@ -2968,168 +3144,132 @@ QImage videoHandlerYUV::calculateDifference(frameHandler *item2, const int frame
 
   // Both YUV buffers are up to date. Really calculate the difference.
   DEBUG_YUV("videoHandlerYUV::calculateDifference frame idx item 0 " << frameIdxItem0 << " - item 1 " << frameIdxItem1);
+  return calculateDifferenceFromRawData(currentFrameBuffer, srcPixelFormat, frameSize, yuvItem2->currentFrameBuffer, yuvItem2->srcPixelFormat, yuvItem2->frameSize, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
+}
+
+QImage videoHandlerYUV::calculateDifferenceForCaching(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks)
+{
+  videoHandlerYUV *yuvItem2 = dynamic_cast<videoHandlerYUV*>(item2);
+  if (!canCalculateYUVDifference(yuvItem2))
+    return videoHandler::calculateDifferenceForCaching(item2, frameIdxItem0, frameIdxItem1, differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
+
+  FrameBuffer rawData[2];
+  yuvPixelFormat format[2];
+  QSize size[2];
+  if (!loadRawYUVDataForCaching(frameIdxItem0, rawData[0], format[0], size[0]))
+    return QImage();
+  if (!yuvItem2->loadRawYUVDataForCaching(frameIdxItem1, rawData[1], format[1], size[1]))
+    return QImage();
+
+  DEBUG_YUV("videoHandlerYUV::calculateDifferenceForCaching frame idx item 0 " << frameIdxItem0 << " - item 1 " << frameIdxItem1);
+  return calculateDifferenceFromRawData(rawData[0], format[0], size[0], rawData[1], format[1], size[1], differenceInfoList, amplificationFactor, markDifference, differenceBlocks);
+}
+
+QImage videoHandlerYUV::calculateDifferenceFromRawData(const FrameBuffer &rawData0, const yuvPixelFormat &format0, const QSize &size0, const FrameBuffer &rawData1, const yuvPixelFormat &format1, const QSize &size1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks) const
+{
+  if (format0.subsampling != format1.subsampling)
+    return QImage();
+
+  // Get/Set the bit depth of the input and output
+  // If the bit depth if the two items is different, we will scale the item with the lower bit depth up.
+  const int bps_in[2] = {format0.bitsPerSample, format1.bitsPerSample};
+  const int bps_out = std::max(bps_in[0], bps_in[1]);
+  // Add a warning if the bit depths of the two inputs don't agree
+  if (bps_in[0] != bps_in[1])
+    differenceInfoList.append(infoItem("Warning", "The bit depth of the two items differs.", "The bit depth of the two input items is different. The lower bit depth will be scaled up and the difference is calculated."));
+  // The value of a difference of 0 for the output bit depth
+  const int diffZero = 128 << (bps_out-8);
 
   // The items can be of different size (we then calculate the difference of the top left aligned part)
-  const int w_in[2] = {frameSize.width(), yuvItem2->frameSize.width()};
-  const int h_in[2] = {frameSize.height(), yuvItem2->frameSize.height()};
+  const int w_in[2] = {size0.width(), size1.width()};
+  const int h_in[2] = {size0.height(), size1.height()};
   const int w_out = qMin(w_in[0], w_in[1]);
   const int h_out = qMin(h_in[0], h_in[1]);
   // Append a warning if the frame sizes are different
-  if (frameSize != yuvItem2->frameSize)
+  if (size0 != size1)
     differenceInfoList.append(infoItem("Warning", "The size of the two items differs.", "The size of the two input items is different. The difference of the top left aligned part that overlaps will be calculated."));
 
-  yuvPixelFormat tmpDiffYUVFormat(srcPixelFormat.subsampling, bps_out, PlaneOrder::YUV, true);
-  diffYUVFormat = tmpDiffYUVFormat;
-
-  if (!tmpDiffYUVFormat.canConvertToRGB(QSize(w_out, h_out)))
+  // The difference is written little endian
+  const yuvPixelFormat diffYUVFormat(format0.subsampling, bps_out, PlaneOrder::YUV, false);
+  if (!diffYUVFormat.canConvertToRGB(QSize(w_out, h_out)))
     return QImage();
 
-
   // Get subsampling modes (they are identical for both inputs and the output)
-  const int subH = srcPixelFormat.getSubsamplingHor();
-  const int subV = srcPixelFormat.getSubsamplingVer();
-
-  // Get the endianness of the inputs
-  const bool bigEndian[2] = {srcPixelFormat.bigEndian, yuvItem2->srcPixelFormat.bigEndian};
-
-  // Get pointers to the inputs
-  const int componentSizeLuma_In[2] = {w_in[0]*h_in[0], w_in[1]*h_in[1]};
-  const int componentSizeChroma_In[2] = {(w_in[0]/subH)*(h_in[0]/subV), (w_in[1]/subH)*(h_in[1]/subV)};
-  const int nrBytesLumaPlane_In[2] = {bps_in[0] > 8 ? 2 * componentSizeLuma_In[0] : componentSizeLuma_In[0], bps_in[1] > 8 ? 2 * componentSizeLuma_In[1] : componentSizeLuma_In[1]};
-  const int nrBytesChromaPlane_In[2] = {bps_in[0] > 8 ? 2 * componentSizeChroma_In[0] : componentSizeChroma_In[0], bps_in[1] > 8 ? 2 * componentSizeChroma_In[1] : componentSizeChroma_In[1]};
-  // Current item
-  const unsigned char * restrict srcY1 = (unsigned char*)currentFrameRawData.data();
-  const unsigned char * restrict srcU1 = (srcPixelFormat.planeOrder == PlaneOrder::YUV || srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY1 + nrBytesLumaPlane_In[0] : srcY1 + nrBytesLumaPlane_In[0] + nrBytesChromaPlane_In[0];
-  const unsigned char * restrict srcV1 = (srcPixelFormat.planeOrder == PlaneOrder::YUV || srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY1 + nrBytesLumaPlane_In[0] + nrBytesChromaPlane_In[0]: srcY1 + nrBytesLumaPlane_In[0];
-  // The other item
-  const unsigned char * restrict srcY2 = (unsigned char*)yuvItem2->currentFrameRawData.data();
-  const unsigned char * restrict srcU2 = (yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUV || yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY2 + nrBytesLumaPlane_In[1] : srcY2 + nrBytesLumaPlane_In[1] + nrBytesChromaPlane_In[1];
-  const unsigned char * restrict srcV2 = (yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUV || yuvItem2->srcPixelFormat.planeOrder == PlaneOrder::YUVA) ? srcY2 + nrBytesLumaPlane_In[1] + nrBytesChromaPlane_In[1]: srcY2 + nrBytesLumaPlane_In[1];
+  const int subH = format0.getSubsamplingHor();
+  const int subV = format0.getSubsamplingVer();
+  const bool chromaPresent = (format0.subsampling != Subsampling::YUV_400);
+
+  // Get pointers to the input planes
+  const QByteArray rawYUVData[2] = {rawData0.toByteArray(), rawData1.toByteArray()};
+  const yuvPixelFormat *formats[2] = {&format0, &format1};
+  DifferenceKernels::Plane planesIn[2][3];
+  for (int i = 0; i < 2; i++)
+  {
+    const int bytesPerSample = bps_in[i] > 8 ? 2 : 1;
+    const int nrBytesLumaPlane = w_in[i] * h_in[i] * bytesPerSample;
+    const int nrBytesChromaPlane = chromaPresent ? (w_in[i] / subH) * (h_in[i] / subV) * bytesPerSample : 0;
+    if (rawYUVData[i].size() < nrBytesLumaPlane + 2 * nrBytesChromaPlane)
+      return QImage();
+
+    const unsigned char *srcY = (const unsigned char*)rawYUVData[i].constData();
+    const bool uPlaneFirst = (formats[i]->planeOrder == PlaneOrder::YUV || formats[i]->planeOrder == PlaneOrder::YUVA);
+    const unsigned char *srcU = uPlaneFirst ? srcY + nrBytesLumaPlane : srcY + nrBytesLumaPlane + nrBytesChromaPlane;
+    const unsigned char *srcV = uPlaneFirst ? srcY + nrBytesLumaPlane + nrBytesChromaPlane : srcY + nrBytesLumaPlane;
+    planesIn[i][0] = {srcY, w_in[i] * bytesPerSample, bps_in[i], formats[i]->bigEndian};
+    planesIn[i][1] = {srcU, w_in[i] / subH * bytesPerSample, bps_in[i], formats[i]->bigEndian};
+    planesIn[i][2] = {srcV, w_in[i] / subH * bytesPerSample, bps_in[i], formats[i]->bigEndian};
+  }
 
   // Get pointers to the output
-  const int componentSizeLuma_out = w_out*h_out * (bps_out > 8 ? 2 : 1); // Size in bytes
-  const int componentSizeChroma_out = (w_out/subH) * (h_out/subV) * (bps_out > 8 ? 2 : 1);
-  // Resize the output buffer to the right size
-  diffYUV.resize(componentSizeLuma_out + 2*componentSizeChroma_out);
-  unsigned char * restrict dstY = (unsigned char*)diffYUV.data();
-  unsigned char * restrict dstU = dstY + componentSizeLuma_out;
-  unsigned char * restrict dstV = dstU + componentSizeChroma_out;
-
-  // Also calculate the MSE while we're at it (Y,U,V)
+  const int bytesPerSampleOut = bps_out > 8 ? 2 : 1;
+  const int componentSizeLuma_out = w_out * h_out * bytesPerSampleOut; // Size in bytes
+  const int componentSizeChroma_out = (w_out/subH) * (h_out/subV) * bytesPerSampleOut;
+  QByteArray diffYUV(componentSizeLuma_out + 2*componentSizeChroma_out, 0);
+  unsigned char *dstY = (unsigned char*)diffYUV.data();
+  unsigned char *dstU = dstY + componentSizeLuma_out;
+  unsigned char *dstV = dstU + componentSizeChroma_out;
+
+  // No amplification when only the differences are marked
+  const int amplification = markDifference ? 1 : amplificationFactor;
+
+  // Calculate the difference and the MSE (Y,U,V)
   // TODO: Bug: MSE is not scaled correctly in all YUV format cases
   int64_t mseAdd[3] = {0, 0, 0};
-
-  // Calculate Luma sample difference
-  const int stride_in[2] = {bps_in[0] > 8 ? w_in[0]*2 : w_in[0], bps_in[1] > 8 ? w_in[1]*2 : w_in[1]};  // How many bytes to the next y line?
-  for (int y = 0; y < h_out; y++)
+  mseAdd[0] = DifferenceKernels::subtractPlane(planesIn[0][0], planesIn[1][0], w_out, h_out, amplification, dstY, w_out * bytesPerSampleOut);
+  if (chromaPresent)
   {
-    for (int x = 0; x < w_out; x++)
-    {
-      int val1 = getValueFromSource(srcY1, x, bps_in[0], bigEndian[0]);
-      int val2 = getValueFromSource(srcY2, x, bps_in[1], bigEndian[1]);
-
-      // Scale (if necessary)
-      if (bitDepthScaling[0])
-        val1 = val1 << depthScale;
-      else if (bitDepthScaling[1])
-        val2 = val2 << depthScale;
-
-      // Calculate the difference, add MSE, (amplify) and clip the difference value
-      int diff = val1 - val2;
-      mseAdd[0] += diff * diff;
-      if (amplification)
-        diff *= amplificationFactor;
-      diff = clip(diff + diffZero, 0, maxVal);
-
-      setValueInBuffer(dstY, diff, 0, bps_out, true);
-      dstY += (bps_out > 8) ? 2 : 1;
-    }
-
-    // Goto the next y line
-    srcY1 += stride_in[0];
-    srcY2 += stride_in[1];
+    mseAdd[1] = DifferenceKernels::subtractPlane(planesIn[0][1], planesIn[1][1], w_out / subH, h_out / subV, amplification, dstU, w_out / subH * bytesPerSampleOut);
+    mseAdd[2] = DifferenceKernels::subtractPlane(planesIn[0][2], planesIn[1][2], w_out / subH, h_out / subV, amplification, dstV, w_out / subH * bytesPerSampleOut);
   }
-
-  // Next U/V
-  const int strideC_in[2] = {w_in[0] / subH * (bps_in[0] > 8 ? 2 : 1), w_in[1] / subH * (bps_in[1] > 8 ? 2 : 1)};  // How many bytes to the next U/V y line
-  for (int y = 0; y < h_out / subV; y++)
+  else
   {
-    for (int x = 0; x < w_out / subH; x++)
-    {
-      int valU1 = getValueFromSource(srcU1, x, bps_in[0], bigEndian[0]);
-      int valU2 = getValueFromSource(srcU2, x, bps_in[1], bigEndian[1]);
-      int valV1 = getValueFromSource(srcV1, x, bps_in[0], bigEndian[0]);
-      int valV2 = getValueFromSource(srcV2, x, bps_in[1], bigEndian[1]);
-
-      // Scale (if necessary)
-      if (bitDepthScaling[0])
-      {
-        valU1 = valU1 << depthScale;
-        valV1 = valV1 << depthScale;
-      }
-      else if (bitDepthScaling[1])
-      {
-        valU2 = valU2 << depthScale;
-        valV2 = valV2 << depthScale;
-      }
-
-      // Calculate the difference, add MSE, (amplify) and clip the difference value
-      int diffU = valU1 - valU2;
-      int diffV = valV1 - valV2;
-      mseAdd[1] += diffU * diffU;
-      mseAdd[2] += diffV * diffV;
-      if (amplification)
-      {
-        diffU *= amplificationFactor;
-        diffV *= amplificationFactor;
-      }
-      diffU = clip(diffU + diffZero, 0, maxVal);
-      diffV = clip(diffV + diffZero, 0, maxVal);
-
-      setValueInBuffer(dstU, diffU, 0, bps_out, true);
-      setValueInBuffer(dstV, diffV, 0, bps_out, true);
-      dstU += (bps_out > 8) ? 2 : 1;
-      dstV += (bps_out > 8) ? 2 : 1;
-    }
-
-    // Goto the next y line
-    srcU1 += strideC_in[0];
-    srcV1 += strideC_in[0];
-    srcU2 += strideC_in[1];
-    srcV2 += strideC_in[1];
+    // The chroma planes are only read when differences are marked. There is no difference.
+    for (int i = 0; i < 2 * componentSizeChroma_out; i += bytesPerSampleOut)
+      setValueInBuffer(dstU + i, diffZero, 0, bps_out, false);
   }
 
-  // Next we convert the difference YUV image to RGB, either using the normal conversion function or
-  // another function that only marks the difference values.
-
-  // Create the output image in the right format
-  // In both cases, we will set the alpha channel to 255. The format of the raw buffer is: BGRA (each 8 bit).
-  QImage outputImage;
-  if (is_Q_OS_WIN)
-    outputImage = QImage(QSize(w_out, h_out), QImage::Format_ARGB32_Premultiplied);
-  else if (is_Q_OS_MAC)
-    outputImage = QImage(QSize(w_out, h_out), QImage::Format_RGB32);
-  else if (is_Q_OS_LINUX)
+  // Mark the blocks with a difference in any component
+  differenceBlocks.reset(QSize(w_out, h_out));
+  differenceBlocks.markPlane(dstY, w_out * bytesPerSampleOut, w_out, h_out, bytesPerSampleOut, diffZero);
+  if (chromaPresent)
   {
-    QImage::Format f = functions::platformImageFormat();
-    if (f == QImage::Format_ARGB32_Premultiplied)
-      outputImage = QImage(QSize(w_out, h_out), QImage::Format_ARGB32_Premultiplied);
-    if (f == QImage::Format_ARGB32)
-      outputImage = QImage(QSize(w_out, h_out), QImage::Format_ARGB32);
-    else
-      outputImage = QImage(QSize(w_out, h_out), QImage::Format_RGB32);
+    differenceBlocks.markPlane(dstU, w_out / subH * bytesPerSampleOut, w_out / subH, h_out / subV, bytesPerSampleOut, diffZero, 0xffffffff, subH, subV);
+    differenceBlocks.markPlane(dstV, w_out / subH * bytesPerSampleOut, w_out / subH, h_out / subV, bytesPerSampleOut, diffZero, 0xffffffff, subH, subV);
   }
 
+  // Next we convert the difference YUV image to RGB, either using the normal conversion function or
+  // another function that only marks the difference values.
+  QImage outputImage = createImageForConversion(QSize(w_out, h_out));
   if (markDifference)
     // We don't want to see the actual difference but just where differences are.
-    markDifferencesYUVPlanarToRGB(diffYUV, outputImage.bits(), QSize(w_out, h_out), tmpDiffYUVFormat);
+    markDifferencesYUVPlanarToRGB(diffYUV, outputImage.bits(), QSize(w_out, h_out), diffYUVFormat);
   else
     // Get the format of the tmpDiffYUV buffer and convert it to RGB
-    convertYUVPlanarToRGB(diffYUV, outputImage.bits(), QSize(w_out, h_out), tmpDiffYUVFormat);
+    convertYUVPlanarToRGB(FrameBuffer(diffYUV), outputImage.bits(), QSize(w_out, h_out), diffYUVFormat);
 
   // Append the conversion information that will be returned
   QStringList yuvSubsamplings = QStringList() << "4:4:4" << "4:2:2" << "4:2:0" << "4:4:0" << "4:1:0" << "4:1:1" << "4:0:0";
-  differenceInfoList.append(infoItem("Difference Type",QString("YUV %1").arg(yuvSubsamplings[subsamplingList.indexOf(srcPixelFormat.subsampling)])));
+  differenceInfoList.append(infoItem("Difference Type",QString("YUV %1").arg(yuvSubsamplings[subsamplingList.indexOf(format0.subsampling)])));
   double mse[4];
   mse[0] = double(mseAdd[0]) / (w_out * h_out);
   mse[1] = double(mseAdd[1]) / (w_out * h_out);
@@ -3140,17 +3280,7 @@ QImage videoHandlerYUV::calculateDifference(frameHandler *item2, const int frame
   differenceInfoList.append(infoItem("MSE V",QString("%1").arg(mse[2])));
   differenceInfoList.append(infoItem("MSE All",QString("%1").arg(mse[3])));
 
-  if (is_Q_OS_LINUX)
-  {
-    // On linux, we may have to convert the image to the platform image format if it is not one of the
-    // RGBA formats.
-    auto f = functions::platformImageFormat();
-    if (f != QImage::Format_ARGB32_Premultiplied && f != QImage::Format_ARGB32 && f != QImage::Format_RGB32)
-      return outputImage.convertToFormat(f);
-  }
-
-  // we have a yuv differance available
-  is_YUV_diff = true;
+  convertToPlatformImageFormat(outputImage);
   return outputImage;
 }
 
@@ -3188,12 +3318,6 @@ void videoHandlerYUV::setYUVPixelFormat(const yuvPixelFormat &newFormat, bool em
   }
 }
 
-bool videoHandlerYUV::getIs_YUV_diff() const
-{
-    return is_YUV_diff;
-}
-
-
 void videoHandlerYUV::setYUVColorConversion(ColorConversion conversion)
 {
   if (conversion != yuvColorConversionType)
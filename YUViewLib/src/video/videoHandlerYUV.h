@@ -64,7 +64,8 @@ public:
   // to another playlistItemVideo. If item2 cannot be converted to a playlistItemYuvSource,
   // we will use the playlistItemVideo::calculateDifference function to calculate the difference
   // using the RGB values.
-  virtual QImage calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference) Q_DECL_OVERRIDE;
+  virtual QImage calculateDifference(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks) Q_DECL_OVERRIDE;
+  virtual QImage calculateDifferenceForCaching(frameHandler *item2, const int frameIdxItem0, const int frameIdxItem1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks) Q_DECL_OVERRIDE;
 
   // Get the number of bytes for one YUV frame with the current format
   virtual int64_t getBytesPerFrame() const Q_DECL_OVERRIDE { return srcPixelFormat.bytesPerFrame(frameSize); }
@@ -104,16 +105,12 @@ public:
   // contain the frame with the given frame index.
   virtual void loadFrame(int frameIndex, bool loadToDoubleBuffer=false) Q_DECL_OVERRIDE;
 
+  virtual QImage convertFrameToImage(const FrameBuffer &frame) Q_DECL_OVERRIDE;
+
   // If this is set, the pixel values drawn in the drawPixels function will be scaled according to the bit depth.
   // E.g: The bit depth is 8 and the pixel value is 127, then the value shown will be -1.
   bool showPixelValuesAsDiff {false};
 
-  QByteArray getDiffYUV() const;
-
-  YUV_Internals::yuvPixelFormat getDiffYUVFormat() const;
-
-  bool getIs_YUV_diff() const;
-
 protected:
   
   // How do we perform interpolation for the subsampled YUV formats?
@@ -159,12 +156,26 @@ protected:
 
 private:
 
-  // Load the raw YUV data for the given frame index into currentFrameRawYUVData.
+  // Load the raw YUV data for the given frame index into currentFrameBuffer.
   // Return false is loading failed.
   bool loadRawYUVData(int frameIndex);
+  // Load the raw YUV data for the given frame index without changing currentFrameBuffer (like for caching).
+  // The format and the frame size that belong to the data are returned as well.
+  bool loadRawYUVDataForCaching(int frameIndex, FrameBuffer &buffer, YUV_Internals::yuvPixelFormat &yuvFormat, QSize &curFrameSize);
+
+  // Is the difference to the other item calculated on the YUV values (the subsampling must be identical)?
+  bool canCalculateYUVDifference(const videoHandlerYUV *yuvItem2) const;
+  // Calculate the YUV difference of the two raw frames. This does not change any state of the handler.
+  QImage calculateDifferenceFromRawData(const FrameBuffer &rawData0, const YUV_Internals::yuvPixelFormat &format0, const QSize &size0, const FrameBuffer &rawData1, const YUV_Internals::yuvPixelFormat &format1, const QSize &size1, QList<infoItem> &differenceInfoList, const int amplificationFactor, const bool markDifference, DifferenceKernels::BlockMap &differenceBlocks) const;
+
+  // The raw YUV data of the current frame (currentFrameRawData_frameIdx). This may reference the planes of a decoder.
+  FrameBuffer currentFrameBuffer;
 
   // Convert from YUV (which ever format is selected) to image (RGB-888)
-  void convertYUVToImage(const QByteArray &sourceBuffer, QImage &outputImage, const YUV_Internals::yuvPixelFormat &yuvFormat, const QSize &curFrameSize);
+  void convertYUVToImage(const FrameBuffer &sourceBuffer, QImage &outputImage, const YUV_Internals::yuvPixelFormat &yuvFormat, const QSize &curFrameSize);
+  // Convert directly to an image that is downscaled by 2^level (see ScaledYUVConversion). This is used for playback when
+  // zoomed out. Returns false if the format (or the YUV math/component display settings) is not supported.
+  bool convertYUVToScaledImage(const FrameBuffer &sourceBuffer, QImage &outputImage, const YUV_Internals::yuvPixelFormat &yuvFormat, const QSize &curFrameSize, int level);
 
   // Set the new pixel format thread save (lock the mutex). We should also emit that something changed (can be disabled).
   void setSrcPixelFormat(YUV_Internals::yuvPixelFormat newFormat, bool emitChangedSignal=true);
@@ -177,11 +188,12 @@ private:
 #if SSE_CONVERSION
   bool convertYUV420ToRGB(const byteArrayAligned &sourceBuffer, byteArrayAligned &targetBuffer);
 #else
-  bool convertYUV420ToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &size, const YUV_Internals::yuvPixelFormat format);
+  bool convertYUV420ToRGB(const FrameBuffer &sourceBuffer, unsigned char *targetBuffer, const QSize &size, const YUV_Internals::yuvPixelFormat format);
 #endif
 
   bool convertYUVPackedToPlanar(const QByteArray &sourceBuffer, QByteArray &targetBuffer, const QSize &frameSize, YUV_Internals::yuvPixelFormat &sourceBufferFormat);
-  bool convertYUVPlanarToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &frameSize, const YUV_Internals::yuvPixelFormat &sourceBufferFormat) const;
+  // Larger frames are split into bands of rows that are converted in parallel (see RowBands) unless splitIntoBands is false
+  bool convertYUVPlanarToRGB(const FrameBuffer &sourceBuffer, unsigned char *targetBuffer, const QSize &frameSize, const YUV_Internals::yuvPixelFormat &sourceBufferFormat, bool splitIntoBands = true) const;
   bool markDifferencesYUVPlanarToRGB(const QByteArray &sourceBuffer, unsigned char *targetBuffer, const QSize &frameSize, const YUV_Internals::yuvPixelFormat &sourceBufferFormat) const;
 
 #if SSE_CONVERSION_420_ALT
@@ -193,10 +205,6 @@ private:
 
   SafeUi<Ui::videoHandlerYUV> ui;
 
-  bool is_YUV_diff;
-  QByteArray diffYUV;
-  YUV_Internals::yuvPixelFormat diffYUVFormat;
-
   QList<YUV_Internals::yuvPixelFormat> presetList;
 
 private slots:
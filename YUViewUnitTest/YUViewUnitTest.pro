@@ -2,5 +2,9 @@ TEMPLATE = subdirs
 
 requires(qtHaveModule(testlib))
 
-SUBDIRS = filesource \
+SUBDIRS = common \
+          decoder \
+          filesource \
+          parser \
+          playlistitem \
           video
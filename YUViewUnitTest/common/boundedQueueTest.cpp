@@ -0,0 +1,144 @@
+#include <QtTest>
+
+#include <QThread>
+
+#include <common/BoundedQueue.h>
+
+#include <atomic>
+#include <memory>
+
+class boundedQueueTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  boundedQueueTest() {};
+  ~boundedQueueTest() {};
+
+private slots:
+  void testOrder();
+  void testPushBlocksWhenFull();
+  void testCloseDrainsEntries();
+  void testCloseWakesPop();
+  void testCloseWakesPush();
+  void testMoveOnly();
+};
+
+void boundedQueueTest::testOrder()
+{
+  BoundedQueue<int> queue(4);
+  for (int i = 0; i < 4; i++)
+    QVERIFY(queue.push(i));
+
+  int value = -1;
+  for (int i = 0; i < 4; i++)
+  {
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, i);
+  }
+}
+
+void boundedQueueTest::testPushBlocksWhenFull()
+{
+  BoundedQueue<int> queue(2);
+  QVERIFY(queue.push(0));
+  QVERIFY(queue.push(1));
+
+  std::atomic<bool> pushed {false};
+  QThread *producer = QThread::create([&queue, &pushed] {
+    queue.push(2);
+    pushed = true;
+  });
+  producer->start();
+
+  // The producer can not run ahead of the consumer
+  QTest::qWait(50);
+  QVERIFY(!pushed);
+
+  int value = -1;
+  QVERIFY(queue.pop(value));
+  QCOMPARE(value, 0);
+  QVERIFY(producer->wait(5000));
+  QVERIFY(pushed);
+  delete producer;
+
+  QVERIFY(queue.pop(value));
+  QCOMPARE(value, 1);
+  QVERIFY(queue.pop(value));
+  QCOMPARE(value, 2);
+}
+
+void boundedQueueTest::testCloseDrainsEntries()
+{
+  BoundedQueue<int> queue(4);
+  QVERIFY(queue.push(1));
+  QVERIFY(queue.push(2));
+  queue.close();
+
+  // No new entries after close but the remaining ones can still be taken
+  QVERIFY(!queue.push(3));
+  int value = -1;
+  QVERIFY(queue.pop(value));
+  QCOMPARE(value, 1);
+  QVERIFY(queue.pop(value));
+  QCOMPARE(value, 2);
+  QVERIFY(!queue.pop(value));
+}
+
+void boundedQueueTest::testCloseWakesPop()
+{
+  BoundedQueue<int> queue(1);
+
+  std::atomic<bool> popResult {true};
+  QThread *consumer = QThread::create([&queue, &popResult] {
+    int value;
+    popResult = queue.pop(value);
+  });
+  consumer->start();
+
+  QTest::qWait(50);
+  QVERIFY(consumer->isRunning());
+  queue.close();
+  QVERIFY(consumer->wait(5000));
+  delete consumer;
+  QVERIFY(!popResult);
+}
+
+void boundedQueueTest::testCloseWakesPush()
+{
+  // Aborting a pipeline: a producer that waits on a full queue must return
+  BoundedQueue<int> queue(1);
+  QVERIFY(queue.push(0));
+
+  std::atomic<bool> pushResult {true};
+  QThread *producer = QThread::create([&queue, &pushResult] { pushResult = queue.push(1); });
+  producer->start();
+
+  QTest::qWait(50);
+  QVERIFY(producer->isRunning());
+  queue.close();
+  QVERIFY(producer->wait(5000));
+  delete producer;
+  QVERIFY(!pushResult);
+
+  // The entry that was pushed before is still there, the one of the aborted push is not
+  int value = -1;
+  QVERIFY(queue.pop(value));
+  QCOMPARE(value, 0);
+  QVERIFY(!queue.pop(value));
+}
+
+void boundedQueueTest::testMoveOnly()
+{
+  BoundedQueue<std::unique_ptr<int>> queue(0);
+  QVERIFY(queue.push(std::unique_ptr<int>(new int(7))));
+
+  std::unique_ptr<int> value;
+  QVERIFY(queue.pop(value));
+  QVERIFY(value);
+  QCOMPARE(*value, 7);
+}
+
+QTEST_MAIN(boundedQueueTest)
+
+#include "boundedQueueTest.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+
+requires(qtHaveModule(testlib))
+
+SUBDIRS = playbackClockTest.pro \
+          frameProfilerTest.pro \
+          numberedFileSequenceTest.pro \
+          boundedQueueTest.pro \
+          threadBudgetTest.pro
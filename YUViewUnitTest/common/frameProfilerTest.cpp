@@ -0,0 +1,156 @@
+#include <QtTest>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <common/FrameProfiler.h>
+
+class frameProfilerTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  frameProfilerTest() {};
+  ~frameProfilerTest() {};
+
+private slots:
+  void testDisabledScope();
+  void testScope();
+  void testRingOverflow();
+  void testSinceAndClear();
+  void testConcurrentReading();
+  void testChromeTrace();
+};
+
+void frameProfilerTest::testDisabledScope()
+{
+  FrameProfiler profiler;
+  {
+    FRAME_PROFILER_SCOPE("Disabled", -1, profiler);
+  }
+  QVERIFY(profiler.getSpans().isEmpty());
+}
+
+void frameProfilerTest::testScope()
+{
+  FrameProfiler profiler;
+  profiler.setEnabled(true);
+  profiler.setThreadName("Test thread");
+  {
+    FRAME_PROFILER_SCOPE("Outer", 7, profiler);
+    FRAME_PROFILER_SCOPE("Inner", -1, profiler);
+  }
+
+  const auto threads = profiler.getSpans();
+  QCOMPARE(threads.size(), 1);
+  QCOMPARE(threads[0].threadName, QString("Test thread"));
+  QCOMPARE(threads[0].spans.size(), 2);
+  // The inner scope ends first
+  QCOMPARE(QString(threads[0].spans[0].name), QString("Inner"));
+  QCOMPARE(threads[0].spans[0].frameIdx, int64_t(-1));
+  QCOMPARE(QString(threads[0].spans[1].name), QString("Outer"));
+  QCOMPARE(threads[0].spans[1].frameIdx, int64_t(7));
+  QVERIFY(threads[0].spans[1].startNs <= threads[0].spans[0].startNs);
+  QVERIFY(threads[0].spans[1].endNs >= threads[0].spans[0].endNs);
+}
+
+void frameProfilerTest::testRingOverflow()
+{
+  FrameProfiler profiler;
+  const int nrSpans = FrameProfiler::RING_SIZE + 100;
+  for (int i = 0; i < nrSpans; i++)
+    profiler.addSpan("Span", i, i + 1, i);
+
+  // Only the newest spans are kept
+  const auto threads = profiler.getSpans();
+  QCOMPARE(threads.size(), 1);
+  QCOMPARE(threads[0].spans.size(), int(FrameProfiler::RING_SIZE));
+  QCOMPARE(threads[0].spans.first().frameIdx, int64_t(100));
+  QCOMPARE(threads[0].spans.last().frameIdx, int64_t(nrSpans - 1));
+}
+
+void frameProfilerTest::testSinceAndClear()
+{
+  FrameProfiler profiler;
+  for (int i = 0; i < 10; i++)
+    profiler.addSpan("Span", i * 10, i * 10 + 5, i);
+
+  const auto threads = profiler.getSpans(50);
+  QCOMPARE(threads.size(), 1);
+  QCOMPARE(threads[0].spans.size(), 5);
+  QCOMPARE(threads[0].spans.first().frameIdx, int64_t(5));
+
+  profiler.clear();
+  QVERIFY(profiler.getSpans().isEmpty());
+  profiler.addSpan("Span", 100, 105, 10);
+  QCOMPARE(profiler.getSpans()[0].spans.size(), 1);
+}
+
+void frameProfilerTest::testConcurrentReading()
+{
+  FrameProfiler profiler;
+  const int nrSpans = FrameProfiler::RING_SIZE * 20;
+  QThread *writer = QThread::create([&profiler, nrSpans] {
+    for (int i = 0; i < nrSpans; i++)
+      profiler.addSpan("Span", i, i + 1, i);
+  });
+  writer->start();
+
+  // Every span that is read while the ring is overwritten must be complete and in order
+  bool spansValid = true;
+  while (!writer->isFinished())
+  {
+    for (const auto &thread : profiler.getSpans())
+    {
+      int64_t lastFrame = -1;
+      for (const auto &span : thread.spans)
+      {
+        if (span.startNs != span.frameIdx || span.endNs != span.frameIdx + 1 || span.frameIdx <= lastFrame)
+          spansValid = false;
+        lastFrame = span.frameIdx;
+      }
+    }
+  }
+  writer->wait();
+  delete writer;
+  QVERIFY(spansValid);
+
+  const auto threads = profiler.getSpans();
+  QCOMPARE(threads.size(), 1);
+  QCOMPARE(threads[0].spans.last().frameIdx, int64_t(nrSpans - 1));
+}
+
+void frameProfilerTest::testChromeTrace()
+{
+  FrameProfiler profiler;
+  profiler.setThreadName("Main");
+  profiler.addSpan("Decode", 1000000, 3000000, 4);
+  profiler.addSpan("Paint", 3000000, 3500000);
+
+  const auto document = QJsonDocument::fromJson(FrameProfiler::toChromeTrace(profiler.getSpans()));
+  const auto events = document.object()["traceEvents"].toArray();
+  QCOMPARE(events.size(), 3);
+
+  const auto threadName = events[0].toObject();
+  QCOMPARE(threadName["ph"].toString(), QString("M"));
+  QCOMPARE(threadName["args"].toObject()["name"].toString(), QString("Main"));
+
+  const auto decode = events[1].toObject();
+  QCOMPARE(decode["name"].toString(), QString("Decode"));
+  QCOMPARE(decode["ph"].toString(), QString("X"));
+  QCOMPARE(decode["ts"].toDouble(), 0.0);
+  QCOMPARE(decode["dur"].toDouble(), 2000.0);
+  QCOMPARE(decode["args"].toObject()["frame"].toInt(), 4);
+  QCOMPARE(decode["tid"].toInt(), threadName["tid"].toInt());
+
+  const auto paint = events[2].toObject();
+  QCOMPARE(paint["ts"].toDouble(), 2000.0);
+  QCOMPARE(paint["dur"].toDouble(), 500.0);
+  QVERIFY(!paint.contains("args"));
+}
+
+QTEST_MAIN(frameProfilerTest)
+
+#include "frameProfilerTest.moc"
@@ -0,0 +1,70 @@
+#include <QtTest>
+
+#include <QDir>
+
+#include <common/functions.h>
+
+class numberedFileSequenceTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  numberedFileSequenceTest() {};
+  ~numberedFileSequenceTest() {};
+
+private slots:
+  void testNoNumber();
+  void testNumericSort();
+  void testDuplicateNumbers();
+  void testOtherFilesIgnored();
+};
+
+void numberedFileSequenceTest::testNoNumber()
+{
+  const QString filePath = QDir("/images").absoluteFilePath("image.png");
+  const auto files = functions::getNumberedFileSequence(filePath, QStringList() << "image.png" << "image1.png");
+  QCOMPARE(files, QStringList() << filePath);
+}
+
+void numberedFileSequenceTest::testNumericSort()
+{
+  // Sorting by name would put image10 before image9
+  const QDir dir("/images");
+  const QStringList fileNames = QStringList() << "image10.png" << "image9.png" << "image100.png" << "image0.png" << "image11.png";
+  const auto files = functions::getNumberedFileSequence(dir.absoluteFilePath("image9.png"), fileNames);
+
+  const QStringList expected = QStringList() << dir.absoluteFilePath("image0.png") << dir.absoluteFilePath("image9.png")
+                                             << dir.absoluteFilePath("image10.png") << dir.absoluteFilePath("image11.png")
+                                             << dir.absoluteFilePath("image100.png");
+  QCOMPARE(files, expected);
+}
+
+void numberedFileSequenceTest::testDuplicateNumbers()
+{
+  // image1 and image01 are the same frame. Only one of them is used.
+  const QDir dir("/images");
+  const QStringList fileNames = QStringList() << "image01.png" << "image2.png" << "image1.png" << "image002.png" << "image3.png";
+  const auto files = functions::getNumberedFileSequence(dir.absoluteFilePath("image01.png"), fileNames);
+
+  // The one that comes first by name is used.
+  const QStringList expected = QStringList() << dir.absoluteFilePath("image01.png") << dir.absoluteFilePath("image002.png")
+                                             << dir.absoluteFilePath("image3.png");
+  QCOMPARE(files, expected);
+}
+
+void numberedFileSequenceTest::testOtherFilesIgnored()
+{
+  // Files with another extension or a different name are not part of the sequence
+  const QDir dir("/images");
+  const QStringList fileNames = QStringList() << "image1.png" << "image2.jpg" << "image2.png" << "other3.png"
+                                              << "image_a.png" << "image3b.png" << "image4.png";
+  const auto files = functions::getNumberedFileSequence(dir.absoluteFilePath("image1.png"), fileNames);
+
+  const QStringList expected = QStringList() << dir.absoluteFilePath("image1.png") << dir.absoluteFilePath("image2.png")
+                                             << dir.absoluteFilePath("image4.png");
+  QCOMPARE(files, expected);
+}
+
+QTEST_MAIN(numberedFileSequenceTest)
+
+#include "numberedFileSequenceTest.moc"
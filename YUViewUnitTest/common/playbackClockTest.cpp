@@ -0,0 +1,140 @@
+#include <QtTest>
+
+#include <common/PlaybackClock.h>
+
+class playbackClockTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  playbackClockTest() {};
+  ~playbackClockTest() {};
+
+private slots:
+  void testNoDrift_data();
+  void testNoDrift();
+  void testEarlyAndLateTimer();
+  void testHold();
+  void testChangeFrameRate();
+  void testStatistics();
+};
+
+void playbackClockTest::testNoDrift_data()
+{
+  QTest::addColumn<double>("frameRate");
+
+  QTest::newRow("23.976") << 24000.0 / 1001;
+  QTest::newRow("59.94") << 60000.0 / 1001;
+  QTest::newRow("60") << 60.0;
+}
+
+void playbackClockTest::testNoDrift()
+{
+  QFETCH(double, frameRate);
+
+  // Simulate a timer with a resolution of 1 ms that is started for every frame (like the playback controller does)
+  PlaybackClock clock;
+  int64_t now = 0;
+  clock.start(frameRate, now);
+  const int nrFrames = 6000;
+  for (int i = 0; i < nrFrames; i++)
+  {
+    const auto ns = clock.getNsUntilNextFrame(now);
+    now += (ns + 999999) / 1000000 * 1000000;
+    QCOMPARE(clock.getNrFramesDue(now), int64_t(1));
+    const auto latency = clock.advance(1, now);
+    QVERIFY(latency >= 0 && latency < 1000000);
+  }
+
+  // The last frame is presented within a millisecond of its ideal time
+  const auto idealNs = double(nrFrames) / frameRate * 1e9;
+  QVERIFY(std::abs(double(now) - idealNs) < 1e6);
+}
+
+void playbackClockTest::testEarlyAndLateTimer()
+{
+  PlaybackClock clock;
+  clock.start(25.0, 0);
+  QCOMPARE(clock.getFramePeriodNs(), int64_t(40000000));
+  QCOMPARE(clock.getNsUntilNextFrame(0), int64_t(40000000));
+
+  // A timer that fires a millisecond early does not present the frame. Within the tolerance, it does.
+  QCOMPARE(clock.getNrFramesDue(39000000), int64_t(0));
+  QCOMPARE(clock.getNrFramesDue(39800000), int64_t(1));
+
+  // 2.5 frame periods later, two frames are due
+  QCOMPARE(clock.getNrFramesDue(100000000), int64_t(2));
+  QCOMPARE(clock.advance(2, 100000000), int64_t(20000000));
+  QCOMPARE(clock.getNrFramesDue(100000000), int64_t(0));
+  QCOMPARE(clock.getNsUntilNextFrame(100000000), int64_t(20000000));
+}
+
+void playbackClockTest::testHold()
+{
+  PlaybackClock clock;
+  clock.start(50.0, 0);
+
+  // Presentation stalled for 200 ms. Show the next frame now and continue the schedule from here.
+  QCOMPARE(clock.getNrFramesDue(200000000), int64_t(10));
+  clock.setNextFrameDue(200000000);
+  QCOMPARE(clock.getNrFramesDue(200000000), int64_t(1));
+  QCOMPARE(clock.advance(1, 200000000), int64_t(0));
+  QCOMPARE(clock.getNsUntilNextFrame(200000000), int64_t(20000000));
+}
+
+void playbackClockTest::testChangeFrameRate()
+{
+  PlaybackClock clock;
+  clock.start(10.0, 0);
+  clock.advance(1, 100000000);
+
+  // The schedule continues from the due time of the last presented frame
+  clock.setFrameRate(20.0);
+  QCOMPARE(clock.getFrameRate(), 20.0);
+  QCOMPARE(clock.getNsUntilNextFrame(100000000), int64_t(50000000));
+
+  // The frame rate is limited to 0.01
+  clock.setFrameRate(0.0);
+  QCOMPARE(clock.getFrameRate(), 0.01);
+}
+
+void playbackClockTest::testStatistics()
+{
+  PlaybackStatistics statistics;
+  QCOMPARE(statistics.getLatencyPercentileMs(50), 0.0);
+
+  // 98 frames on time, one 3.2 ms late and one very late
+  for (int i = 0; i < 98; i++)
+    statistics.addPresentedFrame(100000);
+  statistics.addPresentedFrame(3200000);
+  statistics.addPresentedFrame(250000000);
+  statistics.addDroppedFrames(3);
+  statistics.addHeldFrame();
+  statistics.addStall(50000000);
+  statistics.addStall(150000000);
+
+  QCOMPARE(statistics.getNrPresentedFrames(), int64_t(100));
+  QCOMPARE(statistics.getLatencyHistogram()[0], int64_t(98));
+  QCOMPARE(statistics.getLatencyHistogram()[6], int64_t(1));
+  QCOMPARE(statistics.getLatencyHistogram()[PlaybackStatistics::NR_LATENCY_BINS - 1], int64_t(1));
+  QCOMPARE(statistics.getLatencyPercentileMs(50), 0.5);
+  QCOMPARE(statistics.getLatencyPercentileMs(99), 3.5);
+  QCOMPARE(statistics.getLatencyPercentileMs(100), 250.0);
+  QCOMPARE(statistics.getNrDroppedFrames(), int64_t(3));
+  QCOMPARE(statistics.getNrHeldFrames(), int64_t(1));
+  QCOMPARE(statistics.getNrStalls(), int64_t(2));
+  QCOMPARE(statistics.getStallSeconds(), 0.2);
+  QCOMPARE(statistics.getMaxStallMs(), 150.0);
+
+  const auto json = statistics.toJSON();
+  QCOMPARE(json["framesDropped"].toInt(), 3);
+  QCOMPARE(json["stalls"].toObject()["count"].toInt(), 2);
+
+  statistics.reset();
+  QCOMPARE(statistics.getNrPresentedFrames(), int64_t(0));
+  QCOMPARE(statistics.getLatencyHistogram()[0], int64_t(0));
+}
+
+QTEST_MAIN(playbackClockTest)
+
+#include "playbackClockTest.moc"
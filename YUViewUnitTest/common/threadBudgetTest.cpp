@@ -0,0 +1,219 @@
+#include <QtTest>
+
+#include <QSettings>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <common/ThreadBudget.h>
+
+namespace
+{
+
+void writeSettings(bool cachingEnabled, bool setNrThreads, int nrThreads)
+{
+  QSettings settings;
+  settings.beginGroup("VideoCache");
+  settings.setValue("Enabled", cachingEnabled);
+  settings.setValue("SetNrThreads", setNrThreads);
+  settings.setValue("NrThreads", nrThreads);
+  settings.endGroup();
+}
+
+} // namespace
+
+class threadBudgetTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  threadBudgetTest() {};
+  ~threadBudgetTest() {};
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+
+  void testDecoderShare_data();
+  void testDecoderShare();
+  void testInactiveRegistration();
+  void testCachingThreads();
+  void testSettings();
+  void testSettingsClampedToHardware();
+  void testLimitThreadPool();
+};
+
+void threadBudgetTest::initTestCase()
+{
+  // Do not touch the settings of YUView
+  QCoreApplication::setOrganizationName("YUViewUnitTest");
+  QCOMPARE(ThreadBudget::instance().getNrRegisteredDecoders(), 0);
+}
+
+void threadBudgetTest::cleanupTestCase()
+{
+  QSettings settings;
+  settings.remove("VideoCache");
+}
+
+void threadBudgetTest::testDecoderShare_data()
+{
+  QTest::addColumn<int>("totalThreads");
+  QTest::addColumn<int>("nrDecoders");
+  QTest::addColumn<int>("expectedThreadsPerDecoder");
+
+  QTest::newRow("No decoder") << 8 << 0 << 8;
+  QTest::newRow("One decoder") << 8 << 1 << 8;
+  QTest::newRow("Two decoders") << 8 << 2 << 4;
+  QTest::newRow("Uneven split is rounded down") << 8 << 3 << 2;
+  QTest::newRow("At least one thread") << 2 << 4 << 1;
+  QTest::newRow("At most 16 threads") << 64 << 1 << int(ThreadBudget::maxThreadsPerDecoder);
+  QTest::newRow("At most 16 threads of two") << 64 << 2 << int(ThreadBudget::maxThreadsPerDecoder);
+  QTest::newRow("Zero threads") << 0 << 1 << 1;
+}
+
+void threadBudgetTest::testDecoderShare()
+{
+  QFETCH(int, totalThreads);
+  QFETCH(int, nrDecoders);
+  QFETCH(int, expectedThreadsPerDecoder);
+
+  auto &budget = ThreadBudget::instance();
+  budget.setTotalThreads(totalThreads);
+  QCOMPARE(budget.getTotalThreads(), std::max(totalThreads, 1));
+
+  {
+    std::vector<std::unique_ptr<ThreadBudget::Registration>> registrations;
+    for (int i = 0; i < nrDecoders; i++)
+      registrations.push_back(std::make_unique<ThreadBudget::Registration>());
+    QCOMPARE(budget.getNrRegisteredDecoders(), nrDecoders);
+    QCOMPARE(budget.getNrThreadsPerDecoder(), expectedThreadsPerDecoder);
+  }
+
+  // The share of the decoders that were deleted goes back to the others
+  QCOMPARE(budget.getNrRegisteredDecoders(), 0);
+  QCOMPARE(budget.getNrThreadsPerDecoder(), std::min(std::max(totalThreads, 1), int(ThreadBudget::maxThreadsPerDecoder)));
+}
+
+void threadBudgetTest::testInactiveRegistration()
+{
+  auto &budget = ThreadBudget::instance();
+  budget.setTotalThreads(12);
+
+  {
+    ThreadBudget::Registration active;
+    ThreadBudget::Registration idle;
+    QCOMPARE(budget.getNrThreadsPerDecoder(), 6);
+
+    // A decoder that waits in the pool does not take a share
+    idle.setActive(false);
+    QCOMPARE(budget.getNrRegisteredDecoders(), 1);
+    QCOMPARE(budget.getNrThreadsPerDecoder(), 12);
+    idle.setActive(false);
+    QCOMPARE(budget.getNrRegisteredDecoders(), 1);
+
+    idle.setActive(true);
+    QCOMPARE(budget.getNrRegisteredDecoders(), 2);
+    QCOMPARE(budget.getNrThreadsPerDecoder(), 6);
+    idle.setActive(false);
+  }
+
+  // Deleting an inactive registration does not unregister it twice
+  QCOMPARE(budget.getNrRegisteredDecoders(), 0);
+}
+
+void threadBudgetTest::testCachingThreads()
+{
+  auto &budget = ThreadBudget::instance();
+  writeSettings(true, true, 4);
+  budget.updateSettings();
+  const int nrCachingThreads = budget.getNrCachingThreads();
+  QCOMPARE(nrCachingThreads, 4);
+
+  // A smaller budget also limits the caching workers. A larger budget leaves them as they are.
+  budget.setTotalThreads(2);
+  QCOMPARE(budget.getNrCachingThreads(), 2);
+  budget.setTotalThreads(32);
+  QCOMPARE(budget.getNrCachingThreads(), 2);
+  QCOMPARE(budget.getTotalThreads(), 32);
+
+  // The caching workers and the decoders share the same budget
+  ThreadBudget::Registration decoder;
+  QCOMPARE(budget.getNrThreadsPerDecoder(), int(ThreadBudget::maxThreadsPerDecoder));
+
+  writeSettings(false, true, 4);
+  budget.updateSettings();
+  QCOMPARE(budget.getNrCachingThreads(), 0);
+  QVERIFY(budget.getTotalThreads() >= 1);
+}
+
+void threadBudgetTest::testSettings()
+{
+  auto &budget = ThreadBudget::instance();
+  const int nrHardwareThreads = std::max(QThread::idealThreadCount(), 1);
+
+  // Without a user setting, all cores are used and one core is left for the GUI when caching
+  writeSettings(true, false, 1);
+  budget.updateSettings();
+  QCOMPARE(budget.getTotalThreads(), nrHardwareThreads);
+  QCOMPARE(budget.getNrCachingThreads(), std::max(nrHardwareThreads - 1, 1));
+
+  // The number of threads of the user is the budget for everything
+  writeSettings(true, true, 1);
+  budget.updateSettings();
+  QCOMPARE(budget.getTotalThreads(), 1);
+  QCOMPARE(budget.getNrCachingThreads(), 1);
+  QCOMPARE(budget.getNrThreadsPerDecoder(), 1);
+
+  writeSettings(true, true, 0);
+  budget.updateSettings();
+  QCOMPARE(budget.getTotalThreads(), 1);
+  QCOMPARE(budget.getNrCachingThreads(), 1);
+}
+
+void threadBudgetTest::testSettingsClampedToHardware()
+{
+  auto &budget = ThreadBudget::instance();
+  const int nrHardwareThreads = std::max(QThread::idealThreadCount(), 1);
+
+  // Decoders do not get more threads than there are cores. The caching workers are what the user asked for.
+  writeSettings(true, true, nrHardwareThreads * 2);
+  budget.updateSettings();
+  QCOMPARE(budget.getTotalThreads(), nrHardwareThreads);
+  QCOMPARE(budget.getNrCachingThreads(), nrHardwareThreads * 2);
+  QCOMPARE(budget.getNrThreadsPerDecoder(), std::min(nrHardwareThreads, int(ThreadBudget::maxThreadsPerDecoder)));
+
+  {
+    ThreadBudget::Registration decoder0;
+    ThreadBudget::Registration decoder1;
+    QCOMPARE(budget.getNrThreadsPerDecoder(), std::max(1, std::min(nrHardwareThreads / 2, int(ThreadBudget::maxThreadsPerDecoder))));
+  }
+}
+
+void threadBudgetTest::testLimitThreadPool()
+{
+  auto &budget = ThreadBudget::instance();
+  QThreadPool pool;
+
+  // The pools that split the work on one frame between threads use the whole budget
+  budget.setTotalThreads(5);
+  budget.limitThreadPool(&pool);
+  QCOMPARE(pool.maxThreadCount(), 5);
+
+  // Decoders do not reduce the pool size. Each decoder only puts as many tasks into the pool as it has threads.
+  ThreadBudget::Registration decoder0;
+  ThreadBudget::Registration decoder1;
+  budget.limitThreadPool(&pool);
+  QCOMPARE(pool.maxThreadCount(), 5);
+
+  budget.setTotalThreads(1);
+  budget.limitThreadPool(&pool);
+  QCOMPARE(pool.maxThreadCount(), 1);
+}
+
+QTEST_MAIN(threadBudgetTest)
+
+#include "threadBudgetTest.moc"
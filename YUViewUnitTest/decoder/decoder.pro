@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+requires(qtHaveModule(testlib))
+
+SUBDIRS = decoderPoolTest.pro \
+          decoderBenchmarkTest.pro \
+          statisticsStripesTest.pro
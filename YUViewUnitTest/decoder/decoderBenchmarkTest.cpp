@@ -0,0 +1,108 @@
+#include <QtTest>
+
+#include <decoder/DecoderBenchmark.h>
+
+class decoderBenchmarkTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  decoderBenchmarkTest() {};
+  ~decoderBenchmarkTest() {};
+
+private slots:
+  void testLatencyPercentile_data();
+  void testLatencyPercentile();
+  void testLatencyPercentileEmpty();
+  void testLatencyPercentileUnsorted();
+  void testJSON();
+};
+
+void decoderBenchmarkTest::testLatencyPercentile_data()
+{
+  QTest::addColumn<int>("nrLatencies");
+  QTest::addColumn<double>("percentile");
+  QTest::addColumn<double>("expectedMs");
+
+  // The latencies are 1, 2, ..., nrLatencies. The nearest rank is used.
+  QTest::newRow("Single value p50") << 1 << 50.0 << 1.0;
+  QTest::newRow("Single value p100") << 1 << 100.0 << 1.0;
+  QTest::newRow("p0 is the minimum") << 10 << 0.0 << 1.0;
+  QTest::newRow("p50 of even size") << 10 << 50.0 << 5.0;
+  QTest::newRow("p50 of odd size") << 9 << 50.0 << 5.0;
+  QTest::newRow("p90") << 10 << 90.0 << 9.0;
+  QTest::newRow("p99 rounds up") << 10 << 99.0 << 10.0;
+  QTest::newRow("p99 of 1000") << 1000 << 99.0 << 990.0;
+  QTest::newRow("p100 is the maximum") << 1000 << 100.0 << 1000.0;
+  QTest::newRow("Above 100 is clamped") << 10 << 150.0 << 10.0;
+  QTest::newRow("Below 0 is clamped") << 10 << -10.0 << 1.0;
+}
+
+void decoderBenchmarkTest::testLatencyPercentile()
+{
+  QFETCH(int, nrLatencies);
+  QFETCH(double, percentile);
+  QFETCH(double, expectedMs);
+
+  DecoderBenchmark::Result result;
+  for (int i = 1; i <= nrLatencies; i++)
+    result.frameLatenciesMs.append(double(i));
+
+  QCOMPARE(result.getLatencyPercentileMs(percentile), expectedMs);
+}
+
+void decoderBenchmarkTest::testLatencyPercentileEmpty()
+{
+  DecoderBenchmark::Result result;
+  QCOMPARE(result.getLatencyPercentileMs(50), 0.0);
+  QCOMPARE(result.getLatencyPercentileMs(100), 0.0);
+}
+
+void decoderBenchmarkTest::testLatencyPercentileUnsorted()
+{
+  DecoderBenchmark::Result result;
+  result.frameLatenciesMs = QList<double>() << 40.0 << 10.0 << 30.0 << 20.0;
+
+  QCOMPARE(result.getLatencyPercentileMs(25), 10.0);
+  QCOMPARE(result.getLatencyPercentileMs(50), 20.0);
+  QCOMPARE(result.getLatencyPercentileMs(75), 30.0);
+  QCOMPARE(result.getLatencyPercentileMs(100), 40.0);
+  // The latencies themselves are not reordered
+  QCOMPARE(result.frameLatenciesMs.first(), 40.0);
+}
+
+void decoderBenchmarkTest::testJSON()
+{
+  DecoderBenchmark::Result result;
+  result.success = true;
+  result.nrThreads = 16;
+  result.requestedNrThreads = 32;
+  result.peakMemoryMB = 100;
+  result.peakMemoryOfRun = true;
+  result.nrFrames = 20;
+  result.seconds = 2.0;
+  for (int i = 1; i <= 100; i++)
+    result.frameLatenciesMs.append(double(i));
+
+  const auto json = result.toJSON();
+  QCOMPARE(json["fps"].toDouble(), 10.0);
+  QCOMPARE(json["threads"].toInt(), 16);
+  QCOMPARE(json["requestedThreads"].toInt(), 32);
+  QCOMPARE(json["peakMemoryMB"].toInt(), 100);
+  QVERIFY(json["peakMemoryOfRun"].toBool());
+  QVERIFY(!json.contains("error"));
+  const auto latency = json["latencyMs"].toObject();
+  QCOMPARE(latency["p50"].toDouble(), 50.0);
+  QCOMPARE(latency["p90"].toDouble(), 90.0);
+  QCOMPARE(latency["p99"].toDouble(), 99.0);
+  QCOMPARE(latency["max"].toDouble(), 100.0);
+
+  // No frames were decoded in no time
+  DecoderBenchmark::Result emptyResult;
+  QCOMPARE(emptyResult.getFramesPerSecond(), 0.0);
+  QCOMPARE(emptyResult.toJSON()["latencyMs"].toObject()["max"].toDouble(), 0.0);
+}
+
+QTEST_MAIN(decoderBenchmarkTest)
+
+#include "decoderBenchmarkTest.moc"
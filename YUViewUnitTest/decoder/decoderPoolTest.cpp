@@ -0,0 +1,217 @@
+#include <QtTest>
+
+#include <decoder/DecoderPool.h>
+#include <decoder/decoderBase.h>
+
+namespace
+{
+
+// A decoder without a library that counts its instances and resets
+class testDecoder : public decoderBase
+{
+public:
+  testDecoder(int signalID, bool cachingDecoder) : decoderBase(cachingDecoder)
+  {
+    this->decodeSignal = signalID;
+    nrInstances++;
+  }
+  ~testDecoder() { nrInstances--; }
+
+  void resetDecoder() override
+  {
+    decoderBase::resetDecoder();
+    this->nrResets++;
+  }
+
+  int nrSignalsSupported() const override { return 2; }
+
+  bool decodeNextFrame() override { return false; }
+  QByteArray getRawFrameData() override { return QByteArray(); }
+  bool pushData(QByteArray &data) override { Q_UNUSED(data); return false; }
+  QStringList getLibraryPaths() const override { return QStringList(); }
+  QString getDecoderName() const override { return "Test"; }
+  QString getCodecName() override { return "Test"; }
+
+  void setTestError() { this->setError("Test error"); }
+
+  int nrResets {0};
+  static int nrInstances;
+};
+
+int testDecoder::nrInstances = 0;
+
+} // namespace
+
+class decoderPoolTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  decoderPoolTest() {};
+  ~decoderPoolTest() {};
+
+private slots:
+  void init();
+  void cleanup();
+
+  void testCheckoutAndReturn();
+  void testKeyMismatch();
+  void testReconfiguredDecoderNotPooled();
+  void testDecoderInErrorNotPooled();
+  void testMaxNrIdleDecoders();
+  void testUnknownEngine();
+  void testForeignDecoder();
+  void testReleaser();
+};
+
+void decoderPoolTest::init()
+{
+  DecoderPool::instance().clear();
+  DecoderPool::instance().setDecoderFactory([](YUView::decoderEngine engine, int signalID, bool cachingDecoder) -> decoderBase* {
+    if (engine == YUView::decoderEngineInvalid)
+      return nullptr;
+    return new testDecoder(signalID, cachingDecoder);
+  });
+  testDecoder::nrInstances = 0;
+}
+
+void decoderPoolTest::cleanup()
+{
+  DecoderPool::instance().clear();
+  DecoderPool::instance().setDecoderFactory(DecoderPool::DecoderFactory());
+  QCOMPARE(testDecoder::nrInstances, 0);
+}
+
+void decoderPoolTest::testCheckoutAndReturn()
+{
+  auto &pool = DecoderPool::instance();
+  const auto hits = pool.getNrHits();
+  const auto misses = pool.getNrMisses();
+
+  auto decoder = pool.getDecoder(YUView::decoderEngineLibde265, 0, false);
+  QVERIFY(decoder != nullptr);
+  QCOMPARE(pool.getNrMisses(), misses + 1);
+  QCOMPARE(pool.getNrIdleDecoders(), 0);
+
+  pool.releaseDecoder(decoder);
+  QCOMPARE(pool.getNrIdleDecoders(), 1);
+  QCOMPARE(testDecoder::nrInstances, 1);
+
+  // The same decoder is handed out again and is reset before
+  const int nrResets = static_cast<testDecoder*>(decoder)->nrResets;
+  auto reused = pool.getDecoder(YUView::decoderEngineLibde265, 0, false);
+  QCOMPARE(reused, decoder);
+  QCOMPARE(pool.getNrHits(), hits + 1);
+  QCOMPARE(pool.getNrMisses(), misses + 1);
+  QCOMPARE(pool.getNrIdleDecoders(), 0);
+  QCOMPARE(static_cast<testDecoder*>(reused)->nrResets, nrResets + 1);
+  QCOMPARE(testDecoder::nrInstances, 1);
+
+  pool.releaseDecoder(reused);
+}
+
+void decoderPoolTest::testKeyMismatch()
+{
+  auto &pool = DecoderPool::instance();
+  auto decoder = pool.getDecoder(YUView::decoderEngineLibde265, 0, false);
+  pool.releaseDecoder(decoder);
+
+  // Another engine, signal or caching role does not get the idle decoder
+  const auto misses = pool.getNrMisses();
+  auto otherEngine = pool.getDecoder(YUView::decoderEngineHM, 0, false);
+  auto otherSignal = pool.getDecoder(YUView::decoderEngineLibde265, 1, false);
+  auto otherRole = pool.getDecoder(YUView::decoderEngineLibde265, 0, true);
+  QCOMPARE(pool.getNrMisses(), misses + 3);
+  QVERIFY(otherEngine != decoder && otherSignal != decoder && otherRole != decoder);
+  QCOMPARE(pool.getNrIdleDecoders(), 1);
+  QCOMPARE(testDecoder::nrInstances, 4);
+
+  pool.releaseDecoder(otherEngine);
+  pool.releaseDecoder(otherSignal);
+  pool.releaseDecoder(otherRole);
+  QCOMPARE(pool.getNrIdleDecoders(), 4);
+}
+
+void decoderPoolTest::testReconfiguredDecoderNotPooled()
+{
+  auto &pool = DecoderPool::instance();
+
+  auto statisticsDecoder = pool.getDecoder(YUView::decoderEngineLibde265, 0, false);
+  statisticsDecoder->enableStatisticsRetrieval();
+  pool.releaseDecoder(statisticsDecoder);
+  QCOMPARE(pool.getNrIdleDecoders(), 0);
+  QCOMPARE(testDecoder::nrInstances, 0);
+
+  // A decoder that switched its signal is pooled for the new signal
+  auto decoder = pool.getDecoder(YUView::decoderEngineLibde265, 0, false);
+  bool decoderResetNeeded;
+  decoder->setDecodeSignal(1, decoderResetNeeded);
+  pool.releaseDecoder(decoder);
+  QCOMPARE(pool.getNrIdleDecoders(), 1);
+  auto reused = pool.getDecoder(YUView::decoderEngineLibde265, 1, false);
+  QCOMPARE(reused, decoder);
+  pool.releaseDecoder(reused);
+}
+
+void decoderPoolTest::testDecoderInErrorNotPooled()
+{
+  auto &pool = DecoderPool::instance();
+  auto decoder = pool.getDecoder(YUView::decoderEngineLibde265, 0, false);
+  static_cast<testDecoder*>(decoder)->setTestError();
+  pool.releaseDecoder(decoder);
+  QCOMPARE(pool.getNrIdleDecoders(), 0);
+  QCOMPARE(testDecoder::nrInstances, 0);
+}
+
+void decoderPoolTest::testMaxNrIdleDecoders()
+{
+  auto &pool = DecoderPool::instance();
+  const int nrDecoders = DecoderPool::maxNrIdleDecoders + 2;
+  QList<decoderBase*> decoders;
+  for (int i = 0; i < nrDecoders; i++)
+    decoders.append(pool.getDecoder(YUView::decoderEngineLibde265, 0, false));
+  for (auto decoder : decoders)
+    pool.releaseDecoder(decoder);
+
+  // The decoders that were returned first are deleted
+  QCOMPARE(pool.getNrIdleDecoders(), int(DecoderPool::maxNrIdleDecoders));
+  QCOMPARE(testDecoder::nrInstances, int(DecoderPool::maxNrIdleDecoders));
+
+  // The most recently returned decoder is handed out first
+  auto reused = pool.getDecoder(YUView::decoderEngineLibde265, 0, false);
+  QCOMPARE(reused, decoders.last());
+  pool.releaseDecoder(reused);
+}
+
+void decoderPoolTest::testUnknownEngine()
+{
+  auto &pool = DecoderPool::instance();
+  QVERIFY(pool.getDecoder(YUView::decoderEngineInvalid, 0, false) == nullptr);
+  QCOMPARE(pool.getNrIdleDecoders(), 0);
+}
+
+void decoderPoolTest::testForeignDecoder()
+{
+  // A decoder that was not handed out by the pool is deleted
+  DecoderPool::instance().releaseDecoder(new testDecoder(0, false));
+  QCOMPARE(DecoderPool::instance().getNrIdleDecoders(), 0);
+  QCOMPARE(testDecoder::nrInstances, 0);
+}
+
+void decoderPoolTest::testReleaser()
+{
+  auto &pool = DecoderPool::instance();
+  decoderBase *decoderPtr;
+  {
+    QScopedPointer<decoderBase, DecoderPool::Releaser> decoder(pool.getDecoder(YUView::decoderEngineDav1d, 0, true));
+    decoderPtr = decoder.data();
+  }
+  QCOMPARE(pool.getNrIdleDecoders(), 1);
+  auto reused = pool.getDecoder(YUView::decoderEngineDav1d, 0, true);
+  QCOMPARE(reused, decoderPtr);
+  pool.releaseDecoder(reused);
+}
+
+QTEST_MAIN(decoderPoolTest)
+
+#include "decoderPoolTest.moc"
@@ -0,0 +1,163 @@
+#include <QtTest>
+
+#include <QMutex>
+#include <QThread>
+
+#include <algorithm>
+
+#include <decoder/decoderBase.h>
+
+namespace
+{
+
+// A decoder without a library that exposes the parsing of statistics in stripes
+class testDecoder : public decoderBase
+{
+public:
+  testDecoder() : decoderBase(false) {}
+
+  bool decodeNextFrame() override { return false; }
+  QByteArray getRawFrameData() override { return QByteArray(); }
+  bool pushData(QByteArray &data) override { Q_UNUSED(data); return false; }
+  QStringList getLibraryPaths() const override { return QStringList(); }
+  QString getDecoderName() const override { return "Test"; }
+  QString getCodecName() override { return "Test"; }
+
+  using decoderBase::cacheStatisticsInStripes;
+  using decoderBase::curPOCStats;
+};
+
+statisticsData createData(int firstValue, int nrValues, unsigned short blockSize)
+{
+  statisticsData data;
+  for (int i = 0; i < nrValues; i++)
+  {
+    data.addBlockValue(0, i, blockSize, blockSize, firstValue + i);
+    data.addBlockVector(0, i, blockSize, blockSize, firstValue + i, 0);
+    data.addPolygonValue(QVector<QPoint>() << QPoint(0, i) << QPoint(1, i) << QPoint(1, i + 1), firstValue + i);
+  }
+  return data;
+}
+
+} // namespace
+
+class statisticsStripesTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  statisticsStripesTest() {};
+  ~statisticsStripesTest() {};
+
+private slots:
+  void testAppend();
+  void testAppendEmpty();
+  void testStripeOrder_data();
+  void testStripeOrder();
+};
+
+void statisticsStripesTest::testAppend()
+{
+  auto data = createData(0, 3, 8);
+  const auto other = createData(3, 2, 16);
+  data.append(other);
+
+  // The items of the other data are appended in their order
+  QCOMPARE(data.valueData.size(), 5);
+  QCOMPARE(data.vectorData.size(), 5);
+  QCOMPARE(data.polygonValueData.size(), 5);
+  for (int i = 0; i < 5; i++)
+  {
+    QCOMPARE(data.valueData[i].value, i);
+    QCOMPARE(data.vectorData[i].point[0].x(), i);
+    QCOMPARE(data.polygonValueData[i].value, i);
+  }
+  QCOMPARE(data.maxBlockSize, 16u * 16u);
+
+  // A smaller block size does not lower the maximum
+  data.append(createData(5, 1, 4));
+  QCOMPARE(data.valueData.size(), 6);
+  QCOMPARE(data.maxBlockSize, 16u * 16u);
+}
+
+void statisticsStripesTest::testAppendEmpty()
+{
+  auto data = createData(0, 3, 8);
+  data.append(statisticsData());
+  QCOMPARE(data.valueData.size(), 3);
+  QCOMPARE(data.maxBlockSize, 8u * 8u);
+
+  statisticsData empty;
+  empty.append(data);
+  QCOMPARE(empty.valueData.size(), 3);
+  QCOMPARE(empty.valueData.last().value, 2);
+  QCOMPARE(empty.maxBlockSize, 8u * 8u);
+}
+
+void statisticsStripesTest::testStripeOrder_data()
+{
+  QTest::addColumn<int>("nrThreads");
+  QTest::addColumn<int>("nrRows");
+
+  QTest::newRow("One thread") << 1 << 17;
+  QTest::newRow("Two threads") << 2 << 17;
+  QTest::newRow("Four threads") << 4 << 16;
+  QTest::newRow("Seven threads odd rows") << 7 << 23;
+  QTest::newRow("More threads than rows") << 8 << 3;
+  QTest::newRow("One row") << 4 << 1;
+}
+
+void statisticsStripesTest::testStripeOrder()
+{
+  QFETCH(int, nrThreads);
+  QFETCH(int, nrRows);
+
+  ThreadBudget::instance().setTotalThreads(nrThreads);
+  testDecoder decoder;
+  QCOMPARE(ThreadBudget::instance().getNrThreadsPerDecoder(), nrThreads);
+
+  // Add one value per row for type 0 and one vector on every odd row for type 1
+  QMutex stripesMutex;
+  QList<QPair<int, int>> stripes;
+  decoder.cacheStatisticsInStripes(nrRows, [&stripesMutex, &stripes](int rowBegin, int rowEnd, QHash<int, statisticsData> &stats) {
+    {
+      QMutexLocker lock(&stripesMutex);
+      stripes.append(qMakePair(rowBegin, rowEnd));
+    }
+    // Let the first stripe finish last
+    if (rowBegin == 0)
+      QThread::msleep(20);
+    for (int row = rowBegin; row < rowEnd; row++)
+    {
+      stats[0].addBlockValue(0, row, 8, 8, row);
+      if (row % 2 == 1)
+        stats[1].addBlockVector(0, row, 8, 8, row, 0);
+    }
+  });
+
+  // Every row is parsed once in one of the stripes
+  QCOMPARE(stripes.size(), std::min(nrThreads, nrRows));
+  std::sort(stripes.begin(), stripes.end());
+  QCOMPARE(stripes.first().first, 0);
+  QCOMPARE(stripes.last().second, nrRows);
+  for (int i = 1; i < stripes.size(); i++)
+  {
+    QCOMPARE(stripes[i].first, stripes[i - 1].second);
+    QVERIFY(stripes[i].second > stripes[i].first);
+  }
+
+  // The items are in the order of a sequential walk over all rows
+  const auto &values = decoder.curPOCStats[0].valueData;
+  QCOMPARE(values.size(), nrRows);
+  for (int row = 0; row < nrRows; row++)
+    QCOMPARE(int(values[row].pos[1]), row);
+
+  const auto &vectors = decoder.curPOCStats[1].vectorData;
+  QCOMPARE(vectors.size(), nrRows / 2);
+  for (int i = 0; i < vectors.size(); i++)
+    QCOMPARE(int(vectors[i].pos[1]), i * 2 + 1);
+}
+
+QTEST_MAIN(statisticsStripesTest)
+
+#include "statisticsStripesTest.moc"
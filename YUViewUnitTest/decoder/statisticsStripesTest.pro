@@ -0,0 +1,15 @@
+TEMPLATE = app
+
+CONFIG += qt console warn_on no_testcase_installs depend_includepath testcase
+CONFIG -= debug_and_release
+CONFIG -= app_bundled
+
+TARGET = statisticsStripesTest
+
+QT += testlib gui opengl xml concurrent network
+
+# The decoders include the video handlers which include the ui headers that are generated when building YUViewLib
+INCLUDEPATH += $$top_srcdir/YUViewLib/src $$top_builddir/YUViewLib
+LIBS += -L$$top_builddir/YUViewLib -lYUViewLib
+
+SOURCES += statisticsStripesTest.cpp
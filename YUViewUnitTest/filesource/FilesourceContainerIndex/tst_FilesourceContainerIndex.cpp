@@ -0,0 +1,250 @@
+#include <QtTest>
+#include <QTemporaryFile>
+
+#include <filesource/ContainerIndex.h>
+
+class FileSourceContainerIndexTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  FileSourceContainerIndexTest() {};
+  ~FileSourceContainerIndexTest() {};
+
+private slots:
+  void testMP4();
+  void testMP4Fragmented();
+  void testMatroska();
+  void testMPEGTS();
+  void testUnknown();
+};
+
+namespace
+{
+
+// All test streams have 10 frames with a keyframe at frame 0 and 6
+const int nrTestFrames = 10;
+const QList<int> testKeyFrames = {0, 6};
+
+QByteArray bigEndian(uint64_t value, int nrBytes)
+{
+  QByteArray data;
+  for (int i = nrBytes - 1; i >= 0; i--)
+    data.append(char((value >> (i * 8)) & 0xFF));
+  return data;
+}
+
+QByteArray mp4Box(const char *type, const QByteArray &body)
+{
+  return bigEndian(8 + body.size(), 4) + QByteArray(type, 4) + body;
+}
+
+QByteArray mp4FullBox(const char *type, const QByteArray &body)
+{
+  return mp4Box(type, bigEndian(0, 4) + body);
+}
+
+QByteArray createMP4(bool fragmented)
+{
+  const auto tkhd = mp4FullBox("tkhd", bigEndian(0, 4) + bigEndian(0, 4) + bigEndian(2, 4) + QByteArray(68, 0));
+  const auto hdlr = mp4FullBox("hdlr", bigEndian(0, 4) + QByteArray("vide") + QByteArray(13, 0));
+  // 4 samples with a duration of 512 and 6 with 1024
+  const auto stts = mp4FullBox("stts", bigEndian(2, 4) + bigEndian(4, 4) + bigEndian(512, 4) + bigEndian(6, 4) + bigEndian(1024, 4));
+  // The sync samples are counted from 1
+  const auto stss = mp4FullBox("stss", bigEndian(2, 4) + bigEndian(1, 4) + bigEndian(7, 4));
+  const auto stsz = mp4FullBox("stsz", bigEndian(0, 4) + bigEndian(fragmented ? 0 : nrTestFrames, 4) + QByteArray(fragmented ? 0 : nrTestFrames * 4, 1));
+  const auto stbl = mp4Box("stbl", stts + stss + stsz);
+  const auto mdia = mp4Box("mdia", hdlr + mp4Box("minf", stbl));
+
+  // An audio track in front of the video track
+  const auto audioTrak = mp4Box("trak", mp4FullBox("tkhd", bigEndian(0, 4) + bigEndian(0, 4) + bigEndian(1, 4) + QByteArray(68, 0)));
+  auto moovBody = mp4Box("mvhd", QByteArray(100, 0)) + audioTrak + mp4Box("trak", tkhd + mdia);
+  if (fragmented)
+    moovBody += mp4Box("mvex", QByteArray(32, 0));
+
+  // Put the mdat in front of the moov
+  return mp4Box("ftyp", QByteArray("isom") + bigEndian(0, 4)) + mp4Box("mdat", QByteArray(5000, 2)) + mp4Box("moov", moovBody);
+}
+
+QByteArray ebmlElement(uint32_t id, const QByteArray &body)
+{
+  auto idBytes = bigEndian(id, 4);
+  while (idBytes.at(0) == 0)
+    idBytes.remove(0, 1);
+  // Always use an 8 byte size
+  return idBytes + bigEndian((uint64_t(0x01) << 56) | uint64_t(body.size()), 8) + body;
+}
+
+QByteArray createMatroska()
+{
+  const auto header = ebmlElement(0x1A45DFA3, ebmlElement(0x4282, "webm"));
+  const auto videoTrack = ebmlElement(0xAE, ebmlElement(0xD7, bigEndian(1, 1)) + ebmlElement(0x83, bigEndian(1, 1)));
+  const auto audioTrack = ebmlElement(0xAE, ebmlElement(0xD7, bigEndian(2, 1)) + ebmlElement(0x83, bigEndian(2, 1)));
+  const auto tracks = ebmlElement(0x1654AE6B, videoTrack + audioTrack);
+
+  QByteArray clusters;
+  for (int cluster = 0; cluster < 2; cluster++)
+  {
+    // Cluster 0 contains frame 0 to 4, cluster 1 frame 5 to 9. The time stamps are in ms (40 ms per frame).
+    QByteArray clusterBody = ebmlElement(0xE7, bigEndian(cluster * 200, 2));
+    for (int i = 0; i < 5; i++)
+    {
+      const auto frame = cluster * 5 + i;
+      const bool keyframe = testKeyFrames.contains(frame);
+      const auto blockHeader = QByteArray(1, char(0x81)) + bigEndian(i * 40, 2);
+      if (frame % 2 == 0)
+        clusterBody += ebmlElement(0xA3, blockHeader + QByteArray(1, keyframe ? char(0x80) : char(0)) + QByteArray(100, 3));
+      else
+      {
+        // Use block groups for the odd frames
+        auto groupBody = ebmlElement(0xA1, blockHeader + QByteArray(1, 0) + QByteArray(100, 3));
+        if (!keyframe)
+          groupBody += ebmlElement(0xFB, bigEndian(uint8_t(-40), 1));
+        clusterBody += ebmlElement(0xA0, groupBody);
+      }
+      // An audio block in between
+      clusterBody += ebmlElement(0xA3, QByteArray(1, char(0x82)) + bigEndian(i * 40, 2) + QByteArray(1, char(0x80)) + QByteArray(20, 4));
+    }
+    clusters += ebmlElement(0x1F43B675, clusterBody);
+  }
+
+  return header + ebmlElement(0x18538067, ebmlElement(0x1549A966, ebmlElement(0x2AD7B1, bigEndian(1000000, 4))) + tracks + clusters);
+}
+
+QByteArray pesTimestamp(uint8_t prefix, int64_t timestamp)
+{
+  QByteArray data;
+  data.append(char((prefix << 4) | ((timestamp >> 29) & 0x0E) | 0x01));
+  data.append(char((timestamp >> 22) & 0xFF));
+  data.append(char(((timestamp >> 14) & 0xFE) | 0x01));
+  data.append(char((timestamp >> 7) & 0xFF));
+  data.append(char(((timestamp << 1) & 0xFE) | 0x01));
+  return data;
+}
+
+QByteArray tsPacket(int pid, bool payloadUnitStart, bool randomAccess, const QByteArray &payload)
+{
+  QByteArray packet;
+  packet.append(char(0x47));
+  packet.append(char((payloadUnitStart ? 0x40 : 0) | ((pid >> 8) & 0x1F)));
+  packet.append(char(pid & 0xFF));
+  // Adaptation field and payload
+  packet.append(char(0x30));
+  const auto adaptationFieldLength = 188 - 5 - payload.size();
+  packet.append(char(adaptationFieldLength));
+  if (adaptationFieldLength > 0)
+  {
+    packet.append(char(randomAccess ? 0x40 : 0x00));
+    packet.append(QByteArray(adaptationFieldLength - 1, char(0xFF)));
+  }
+  packet.append(payload);
+  return packet;
+}
+
+QByteArray createMPEGTS()
+{
+  QByteArray data;
+  // Start close to the 33 bit wrap around
+  const int64_t startDTS = (int64_t(1) << 33) - 3600 * 3;
+  for (int frame = 0; frame < nrTestFrames; frame++)
+  {
+    const auto dts = (startDTS + frame * 3600) % (int64_t(1) << 33);
+    const auto pts = (dts + 7200) % (int64_t(1) << 33);
+    const auto pesHeader = QByteArray::fromHex("000001e0000084c00a") + pesTimestamp(3, pts) + pesTimestamp(1, dts);
+    data += tsPacket(0x100, true, testKeyFrames.contains(frame), pesHeader + QByteArray(50, 5));
+    data += tsPacket(0x100, false, false, QByteArray(150, 5));
+    // Audio
+    data += tsPacket(0x101, true, true, QByteArray::fromHex("000001c00000") + QByteArray(20, 6));
+  }
+  return data;
+}
+
+QString writeTemporaryFile(QTemporaryFile &file, const QByteArray &data)
+{
+  file.open();
+  file.write(data);
+  file.close();
+  return file.fileName();
+}
+
+void checkIndex(const ContainerIndex &index, const QList<int64_t> &expectedTimestamps)
+{
+  QCOMPARE(index.getNrFrames(), int64_t(nrTestFrames));
+  QCOMPARE(index.getKeyFrames().size(), testKeyFrames.size());
+  for (int i = 0; i < testKeyFrames.size(); i++)
+    QCOMPARE(index.getKeyFrames()[i].frame, int64_t(testKeyFrames[i]));
+
+  QCOMPARE(index.getFirstSamples().size(), nrTestFrames);
+  for (int i = 0; i < nrTestFrames; i++)
+  {
+    QCOMPARE(index.getFirstSamples()[i].timestamp, expectedTimestamps[i]);
+    QCOMPARE(index.getFirstSamples()[i].keyframe, testKeyFrames.contains(i));
+  }
+}
+
+} // namespace
+
+void FileSourceContainerIndexTest::testMP4()
+{
+  QTemporaryFile file;
+  const auto fileName = writeTemporaryFile(file, createMP4(false));
+
+  ContainerIndex index;
+  QVERIFY(index.readIndex(fileName, 2));
+  QVERIFY(index.getContainer() == ContainerIndex::Container::MP4);
+  checkIndex(index, {0, 512, 1024, 1536, 2048, 3072, 4096, 5120, 6144, 7168});
+
+  // Track 1 is not a video track
+  QVERIFY(!index.readIndex(fileName, 1));
+}
+
+void FileSourceContainerIndexTest::testMP4Fragmented()
+{
+  QTemporaryFile file;
+  const auto fileName = writeTemporaryFile(file, createMP4(true));
+
+  ContainerIndex index;
+  QVERIFY(!index.readIndex(fileName, 2));
+}
+
+void FileSourceContainerIndexTest::testMatroska()
+{
+  QTemporaryFile file;
+  const auto fileName = writeTemporaryFile(file, createMatroska());
+
+  ContainerIndex index;
+  QVERIFY(index.readIndex(fileName, 1));
+  QVERIFY(index.getContainer() == ContainerIndex::Container::Matroska);
+  checkIndex(index, {0, 40, 80, 120, 160, 200, 240, 280, 320, 360});
+}
+
+void FileSourceContainerIndexTest::testMPEGTS()
+{
+  QTemporaryFile file;
+  const auto fileName = writeTemporaryFile(file, createMPEGTS());
+
+  ContainerIndex index;
+  QVERIFY(index.readIndex(fileName, 0x100));
+  QVERIFY(index.getContainer() == ContainerIndex::Container::MPEGTS);
+
+  // The timestamps are unwrapped
+  const int64_t startDTS = (int64_t(1) << 33) - 3600 * 3;
+  QList<int64_t> expected;
+  for (int i = 0; i < nrTestFrames; i++)
+    expected.append(startDTS + i * 3600);
+  checkIndex(index, expected);
+}
+
+void FileSourceContainerIndexTest::testUnknown()
+{
+  QTemporaryFile file;
+  const auto fileName = writeTemporaryFile(file, QByteArray(1000, 7));
+
+  ContainerIndex index;
+  QVERIFY(!index.readIndex(fileName, 0));
+  QVERIFY(index.getContainer() == ContainerIndex::Container::Unknown);
+}
+
+QTEST_MAIN(FileSourceContainerIndexTest)
+
+#include "tst_FilesourceContainerIndex.moc"
@@ -0,0 +1,114 @@
+#include <QtTest>
+
+#include <parser/common/HRDPlotModel.h>
+
+class hrdPlotModelTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  hrdPlotModelTest() {};
+  ~hrdPlotModelTest() {};
+
+private slots:
+  void testEnvelopeIsBounded();
+  void testEnvelopeKeepsExtremes();
+  void testEvents();
+};
+
+namespace
+{
+
+void addSawtooth(HRDPlotModel &model, int nrFrames, int peakFrame)
+{
+  for (int i = 0; i < nrFrames; i++)
+  {
+    const auto peak = (i == peakFrame) ? 100000 : 1000;
+
+    HRDPlotModel::HRDEntry adding;
+    adding.type = HRDPlotModel::HRDEntry::EntryType::Adding;
+    adding.cbp_fullness_start = 0;
+    adding.cbp_fullness_end = peak;
+    adding.time_offset_start = i;
+    adding.time_offset_end = i + 0.5;
+    adding.poc = i;
+    model.addHRDEntry(adding);
+
+    HRDPlotModel::HRDEntry removal;
+    removal.type = HRDPlotModel::HRDEntry::EntryType::Removal;
+    removal.cbp_fullness_start = peak;
+    removal.cbp_fullness_end = (i == peakFrame + 1) ? -500 : 0;
+    removal.time_offset_start = i + 0.5;
+    removal.time_offset_end = i + 0.5;
+    removal.poc = i;
+    model.addHRDEntry(removal);
+  }
+}
+
+} // namespace
+
+void hrdPlotModelTest::testEnvelopeIsBounded()
+{
+  HRDPlotModel model;
+  addSawtooth(model, 100000, -1);
+
+  QCOMPARE(model.getNrEntries(), uint64_t(200000));
+  const auto param = model.getStreamParameter(0);
+  QCOMPARE(param.getNrPlots(), 1u);
+  QVERIFY(param.plotParameters[0].nrpoints <= 2 * 8192 + 1);
+  QVERIFY(param.plotParameters[0].nrpoints > 8192);
+  QCOMPARE(param.xRange.max, 100000 - 0.5);
+
+  // The points must be ordered in time
+  double lastX = 0;
+  for (unsigned i = 0; i < param.plotParameters[0].nrpoints; i++)
+  {
+    const auto point = model.getPlotPoint(0, 0, i);
+    QVERIFY(point.x >= lastX);
+    lastX = point.x;
+  }
+}
+
+void hrdPlotModelTest::testEnvelopeKeepsExtremes()
+{
+  HRDPlotModel model;
+  addSawtooth(model, 50000, 31337);
+
+  const auto param = model.getStreamParameter(0);
+  QCOMPARE(param.yRange.max, 100000.0);
+  QCOMPARE(param.yRange.min, -500.0);
+
+  bool foundMax = false;
+  bool foundMin = false;
+  for (unsigned i = 0; i < param.plotParameters[0].nrpoints; i++)
+  {
+    const auto point = model.getPlotPoint(0, 0, i);
+    foundMax |= (point.y == 100000);
+    foundMin |= (point.y == -500);
+  }
+  QVERIFY(foundMax);
+  QVERIFY(foundMin);
+}
+
+void hrdPlotModelTest::testEvents()
+{
+  HRDPlotModel model;
+  QCOMPARE(model.getNrEvents(), uint64_t(0));
+
+  HRDPlotModel::HRDEvent event;
+  event.type = HRDPlotModel::HRDEvent::Type::Underflow;
+  event.accessUnit = 7;
+  event.bits = 1234;
+  for (int i = 0; i < 10010; i++)
+    model.addHRDEvent(event);
+
+  QCOMPARE(model.getNrEvents(), uint64_t(10010));
+  const auto events = model.getEvents();
+  QCOMPARE(events.size(), 10000);
+  QCOMPARE(events[0].accessUnit, uint64_t(7));
+  QCOMPARE(HRDPlotModel::eventTypeToString(events[0].type), QString("Underflow"));
+}
+
+QTEST_MAIN(hrdPlotModelTest)
+
+#include "hrdPlotModelTest.moc"
@@ -0,0 +1,203 @@
+#include <QtTest>
+
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <parser/common/PacketDumpWriter.h>
+#include <parser/common/TreeItemArena.h>
+
+namespace
+{
+
+const QString fileName = "dir, with \"quotes\"/file.265";
+const QString packetName = "NAL 0: \"SEI\", prefix";
+const QString elementName = "user_data \"quoted\"";
+const QString elementValue = "1,2\n3\r4";
+const QString elementCoding = "tab\there";
+const QString elementCode = QString("ctrl") + QChar(0x01) + QChar(0x1f) + "\rend";
+const QString elementMeaning = QString("Umlaut ") + QChar(0xe4) + ", backslash \\ and \"quotes\"";
+
+// Parse CSV as described in RFC 4180. Line breaks and quotes are only allowed in quoted fields.
+QList<QStringList> parseCSV(const QString &csv)
+{
+  QList<QStringList> records;
+  QStringList record;
+  QString field;
+  bool inQuotes = false;
+  for (int i = 0; i < csv.size(); i++)
+  {
+    const auto c = csv[i];
+    if (inQuotes)
+    {
+      if (c == '"' && i + 1 < csv.size() && csv[i + 1] == '"')
+      {
+        field += '"';
+        i++;
+      }
+      else if (c == '"')
+        inQuotes = false;
+      else
+        field += c;
+    }
+    else if (c == '"')
+      inQuotes = true;
+    else if (c == ',')
+    {
+      record.append(field);
+      field.clear();
+    }
+    else if (c == '\n' || c == '\r')
+    {
+      record.append(field);
+      field.clear();
+      records.append(record);
+      record.clear();
+    }
+    else
+      field += c;
+  }
+  if (!field.isEmpty() || !record.isEmpty())
+  {
+    record.append(field);
+    records.append(record);
+  }
+  return records;
+}
+
+} // namespace
+
+class packetDumpWriterTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  packetDumpWriterTest() {};
+  ~packetDumpWriterTest() {};
+
+private slots:
+  void init();
+  void testJSONLines();
+  void testCSV();
+  void testFormatFromName();
+
+private:
+  QByteArray dumpPackets(PacketDumpWriter::Format format);
+
+  TreeItemArena arena;
+  TreeItem *packet {nullptr};
+  int64_t nrPacketsWritten {0};
+};
+
+void packetDumpWriterTest::init()
+{
+  TreeItemArena::Scope arenaScope(&this->arena);
+
+  // A packet with one syntax element that has a child and an empty second element
+  this->packet = new TreeItem(nullptr);
+  this->packet->setName(packetName);
+  this->packet->setStreamIndex(1);
+  auto element = new TreeItem(elementName, elementValue, elementCoding, elementCode, elementMeaning, this->packet, true);
+  new TreeItem("child", 7, "u(3)", "111", element);
+  new TreeItem("empty", this->packet);
+}
+
+QByteArray packetDumpWriterTest::dumpPackets(PacketDumpWriter::Format format)
+{
+  QBuffer buffer;
+  buffer.open(QIODevice::WriteOnly);
+  PacketDumpWriter writer(&buffer, format, fileName);
+  writer.writeHeader();
+  writer.writePacket(this->packet);
+  writer.writePacket(this->packet);
+  writer.writePacket(nullptr);
+  this->nrPacketsWritten = writer.getNrPacketsWritten();
+  return buffer.data();
+}
+
+void packetDumpWriterTest::testJSONLines()
+{
+  const auto data = this->dumpPackets(PacketDumpWriter::Format::JSONLines);
+  QCOMPARE(this->nrPacketsWritten, int64_t(2));
+
+  // Line breaks in the values are escaped so that there is exactly one line per packet
+  const auto lines = data.split('\n');
+  QCOMPARE(lines.size(), 3);
+  QVERIFY(lines[2].isEmpty());
+
+  for (int packetIdx = 0; packetIdx < 2; packetIdx++)
+  {
+    QJsonParseError error;
+    const auto doc = QJsonDocument::fromJson(lines[packetIdx], &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    const auto obj = doc.object();
+    QCOMPARE(obj["file"].toString(), fileName);
+    QCOMPARE(obj["packet"].toInt(), packetIdx);
+    QCOMPARE(obj["stream"].toInt(), 1);
+    QCOMPARE(obj["name"].toString(), packetName);
+    QVERIFY(!obj.contains("error"));
+
+    const auto syntax = obj["syntax"].toArray();
+    QCOMPARE(syntax.size(), 2);
+    const auto element = syntax[0].toObject();
+    QCOMPARE(element["name"].toString(), elementName);
+    QCOMPARE(element["value"].toString(), elementValue);
+    QCOMPARE(element["coding"].toString(), elementCoding);
+    QCOMPARE(element["code"].toString(), elementCode);
+    QCOMPARE(element["meaning"].toString(), elementMeaning);
+    QVERIFY(element["error"].toBool());
+
+    const auto children = element["children"].toArray();
+    QCOMPARE(children.size(), 1);
+    const auto child = children[0].toObject();
+    QCOMPARE(child["name"].toString(), QString("child"));
+    QCOMPARE(child["value"].toString(), QString("7"));
+    QCOMPARE(child["code"].toString(), QString("111"));
+    QVERIFY(!child.contains("meaning"));
+    QVERIFY(!child.contains("children"));
+
+    // Empty values are omitted
+    const auto empty = syntax[1].toObject();
+    QCOMPARE(empty.keys(), QStringList() << "name");
+    QCOMPARE(empty["name"].toString(), QString("empty"));
+  }
+}
+
+void packetDumpWriterTest::testCSV()
+{
+  const auto records = parseCSV(QString::fromUtf8(this->dumpPackets(PacketDumpWriter::Format::CSV)));
+  QCOMPARE(this->nrPacketsWritten, int64_t(2));
+
+  // The header and four items (packet, element, child and empty element) per packet
+  QCOMPARE(records.size(), 1 + 2 * 4);
+  const auto header = QStringList() << "file" << "packet" << "stream" << "depth" << "name" << "value" << "coding" << "code" << "meaning" << "error";
+  QCOMPARE(records[0], header);
+  for (const auto &record : records)
+    QCOMPARE(record.size(), header.size());
+
+  for (int packetIdx = 0; packetIdx < 2; packetIdx++)
+  {
+    const auto prefix = QStringList() << fileName << QString::number(packetIdx) << "1";
+    const int row = 1 + packetIdx * 4;
+    QCOMPARE(records[row], prefix + (QStringList() << "0" << packetName << "" << "" << "" << "" << "0"));
+    QCOMPARE(records[row + 1], prefix + (QStringList() << "1" << elementName << elementValue << elementCoding << elementCode << elementMeaning << "1"));
+    QCOMPARE(records[row + 2], prefix + (QStringList() << "2" << "child" << "7" << "u(3)" << "111" << "" << "0"));
+    QCOMPARE(records[row + 3], prefix + (QStringList() << "1" << "empty" << "" << "" << "" << "" << "0"));
+  }
+}
+
+void packetDumpWriterTest::testFormatFromName()
+{
+  bool ok;
+  QVERIFY(PacketDumpWriter::formatFromName("CSV", &ok) == PacketDumpWriter::Format::CSV);
+  QVERIFY(ok);
+  QVERIFY(PacketDumpWriter::formatFromName("jsonl", &ok) == PacketDumpWriter::Format::JSONLines);
+  QVERIFY(ok);
+  QVERIFY(PacketDumpWriter::formatFromName("xml", &ok) == PacketDumpWriter::Format::JSONLines);
+  QVERIFY(!ok);
+}
+
+QTEST_MAIN(packetDumpWriterTest)
+
+#include "packetDumpWriterTest.moc"
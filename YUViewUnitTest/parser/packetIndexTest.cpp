@@ -0,0 +1,100 @@
+#include <QtTest>
+
+#include <parser/common/PacketIndex.h>
+#include <parser/common/PacketItemModel.h>
+
+class packetIndexTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  packetIndexTest() {};
+  ~packetIndexTest() {};
+
+private slots:
+  void testParseQuery();
+  void testParseQueryErrors();
+  void testFindModelRows();
+};
+
+void packetIndexTest::testParseQuery()
+{
+  QString error;
+  auto query = PacketIndex::parseQuery("nal_type=21 pps_id == 3, poc>=10 and sei != 137", error);
+  QVERIFY(query);
+  QCOMPARE(query->size(), 4);
+  QVERIFY(query->at(0).column == PacketIndex::Column::NalType);
+  QVERIFY(query->at(0).op == PacketIndex::Operator::Equal);
+  QCOMPARE(query->at(0).value, 21);
+  QVERIFY(query->at(1).column == PacketIndex::Column::ParameterSetID);
+  QCOMPARE(query->at(1).value, 3);
+  QVERIFY(query->at(2).column == PacketIndex::Column::POC);
+  QVERIFY(query->at(2).op == PacketIndex::Operator::GreaterEqual);
+  QVERIFY(query->at(3).column == PacketIndex::Column::SEIPayloadType);
+  QVERIFY(query->at(3).op == PacketIndex::Operator::NotEqual);
+
+  auto emptyQuery = PacketIndex::parseQuery("  ", error);
+  QVERIFY(emptyQuery);
+  QVERIFY(emptyQuery->isEmpty());
+}
+
+void packetIndexTest::testParseQueryErrors()
+{
+  QString error;
+  QVERIFY(!PacketIndex::parseQuery("foo=3", error));
+  QVERIFY(!error.isEmpty());
+  QVERIFY(!PacketIndex::parseQuery("poc=3 garbage", error));
+  QVERIFY(!PacketIndex::parseQuery("poc", error));
+}
+
+void packetIndexTest::testFindModelRows()
+{
+  PacketItemModel model(nullptr);
+  model.createRootItem(QStringList() << "root");
+  TreeItemArena::Scope arenaScope(model.getArena());
+  PacketIndex index(&model);
+
+  // Row 0: PPS 3, row 1: CRA slice referencing PPS 3, row 2: SEI with two messages, row 3: TRAIL slice
+  new TreeItem(model.getRootItem());
+  PacketIndex::Entry pps;
+  pps[PacketIndex::Column::NalType] = 34;
+  pps[PacketIndex::Column::ParameterSetID] = 3;
+  index.addEntry(pps);
+
+  new TreeItem(model.getRootItem());
+  PacketIndex::Entry cra;
+  cra[PacketIndex::Column::NalType] = 21;
+  cra[PacketIndex::Column::ParameterSetID] = 3;
+  cra[PacketIndex::Column::POC] = 0;
+  index.addEntry(cra);
+
+  new TreeItem(model.getRootItem());
+  PacketIndex::Entry sei;
+  sei[PacketIndex::Column::NalType] = 39;
+  index.addEntry(sei, QList<int>() << 137 << 144);
+
+  new TreeItem(model.getRootItem());
+  PacketIndex::Entry trail;
+  trail[PacketIndex::Column::NalType] = 1;
+  trail[PacketIndex::Column::ParameterSetID] = 3;
+  trail[PacketIndex::Column::POC] = 8;
+  index.addEntry(trail);
+
+  QCOMPARE(index.getNrEntries(), 5);
+
+  QString error;
+  QCOMPARE(index.findModelRows(*PacketIndex::parseQuery("nal_type=21 pps_id=3", error)), QVector<int>() << 1);
+  QCOMPARE(index.findModelRows(*PacketIndex::parseQuery("sei=137", error)), QVector<int>() << 2);
+  QCOMPARE(index.findModelRows(*PacketIndex::parseQuery("pps_id=3", error)), QVector<int>() << 0 << 1 << 3);
+  QCOMPARE(index.findModelRows(*PacketIndex::parseQuery("poc<10", error)), QVector<int>() << 1 << 3);
+  QCOMPARE(index.findModelRows(*PacketIndex::parseQuery("nal_type!=0", error)), QVector<int>() << 0 << 1 << 2 << 3);
+  QCOMPARE(index.findModelRows({}), QVector<int>() << 0 << 1 << 2 << 3);
+  QVERIFY(index.findModelRows(*PacketIndex::parseQuery("sei=5", error)).isEmpty());
+
+  index.clear();
+  QCOMPARE(index.getNrEntries(), 0);
+}
+
+QTEST_MAIN(packetIndexTest)
+
+#include "packetIndexTest.moc"
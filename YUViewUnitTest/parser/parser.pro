@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+requires(qtHaveModule(testlib))
+
+SUBDIRS = packetIndexTest.pro \
+          treeItemTest.pro \
+          hrdPlotModelTest.pro \
+          packetDumpWriterTest.pro
@@ -0,0 +1,111 @@
+#include <QtTest>
+
+#include <parser/common/PacketItemModel.h>
+#include <parser/common/TreeItem.h>
+#include <parser/common/TreeItemArena.h>
+
+class treeItemTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  treeItemTest() {};
+  ~treeItemTest() {};
+
+private slots:
+  void testItemData();
+  void testInternedText();
+  void testManyChildren();
+  void testClearModelItems();
+};
+
+void treeItemTest::testItemData()
+{
+  TreeItemArena arena;
+  TreeItemArena::Scope arenaScope(&arena);
+
+  auto root = new TreeItem(QStringList() << "Name" << "Value" << "Coding" << "Code" << "Meaning", nullptr);
+  QCOMPARE(root->getData(0), QString("Name"));
+  QCOMPARE(root->getData(4), QString("Meaning"));
+
+  auto intItem = new TreeItem("slice_qp_delta", -3, "se(v)", "00111", root);
+  QCOMPARE(intItem->getData(0), QString("slice_qp_delta"));
+  QCOMPARE(intItem->getData(1), QString("-3"));
+  QCOMPARE(intItem->getData(2), QString("se(v)"));
+  QCOMPARE(intItem->getData(3), QString("00111"));
+  QCOMPARE(intItem->getData(4), QString());
+
+  auto uintItem = new TreeItem("pos", uint64_t(5000000000), "", "", root);
+  QCOMPARE(uintItem->getData(1), QString("5000000000"));
+  auto boolItem = new TreeItem("flag", true, "u(1)", "1", root);
+  QCOMPARE(boolItem->getData(1), QString("1"));
+  auto errorItem = new TreeItem("Error", "", "", "", "Something went wrong", root, true);
+  QVERIFY(errorItem->isError());
+  QCOMPARE(errorItem->getData(4), QString("Something went wrong"));
+
+  QCOMPARE(root->getNrChildren(), 4);
+  QCOMPARE(root->getChild(1), uintItem);
+  QCOMPARE(root->getLastChild(), errorItem);
+  QCOMPARE(root->getChild(4), static_cast<TreeItem*>(nullptr));
+  QCOMPARE(boolItem->getRow(), 2);
+  QCOMPARE(boolItem->getParent(), root);
+
+  auto nal = new TreeItem(root);
+  nal->setName("NAL 0: 32");
+  nal->setStreamIndex(2);
+  QCOMPARE(nal->getName(false), QString("NAL 0: 32"));
+  QCOMPARE(nal->getName(true), QString("Stream 2 - NAL 0: 32"));
+}
+
+void treeItemTest::testInternedText()
+{
+  TreeItemArena arena;
+  auto a = arena.internText("ue(v)");
+  auto b = arena.internText(QString("ue") + "(v)");
+  QCOMPARE(a.data, b.data);
+  QCOMPARE(b.toString(), QString("ue(v)"));
+  QVERIFY(arena.internText("").isEmpty());
+
+  auto stored = arena.storeText("ue(v)");
+  QVERIFY(stored.data != a.data);
+  QCOMPARE(stored.toString(), QString("ue(v)"));
+}
+
+void treeItemTest::testManyChildren()
+{
+  TreeItemArena arena;
+  TreeItemArena::Scope arenaScope(&arena);
+
+  auto root = new TreeItem("root", nullptr);
+  for (int i = 0; i < 100000; i++)
+    new TreeItem("slice_pic_order_cnt_lsb", i, "u(v)", "", root);
+
+  QCOMPARE(root->getNrChildren(), 100000);
+  for (int i : {0, 1, 4, 5, 4095, 99999})
+  {
+    QCOMPARE(root->getChild(i)->getRow(), i);
+    QCOMPARE(root->getChild(i)->getData(1), QString::number(i));
+  }
+  QVERIFY(arena.getNrBytesAllocated() > 0);
+}
+
+void treeItemTest::testClearModelItems()
+{
+  PacketItemModel model(nullptr);
+  model.createRootItem(QStringList() << "Name" << "Value");
+  {
+    TreeItemArena::Scope arenaScope(model.getArena());
+    for (int i = 0; i < 10; i++)
+      new TreeItem(QString("Packet %1").arg(i), model.getRootItem());
+  }
+  QCOMPARE(model.getRootItem()->getNrChildren(), 10);
+
+  model.clearItems();
+  QVERIFY(!model.isNull());
+  QCOMPARE(model.getRootItem()->getNrChildren(), 0);
+  QCOMPARE(model.headerData(1, Qt::Horizontal).toString(), QString("Value"));
+}
+
+QTEST_MAIN(treeItemTest)
+
+#include "treeItemTest.moc"
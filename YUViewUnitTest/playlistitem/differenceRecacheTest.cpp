@@ -0,0 +1,108 @@
+#include <QtTest>
+
+#include <QFile>
+#include <QPainter>
+#include <QSpinBox>
+#include <QTemporaryDir>
+
+#include <playlistitem/playlistItemDifference.h>
+#include <playlistitem/playlistItemRawFile.h>
+
+namespace
+{
+
+// The frame size and format are guessed from the file names
+const int width = 64;
+const int height = 32;
+const int nrFrames = 8;
+
+void createRawFile(const QString &fileName, unsigned seed)
+{
+  QByteArray data(width * height * 3 / 2 * nrFrames, 0);
+  for (int i = 0; i < data.size(); i++)
+    data[i] = char(((i + seed) * 2654435761u) >> 13);
+  QFile file(fileName);
+  if (file.open(QIODevice::WriteOnly))
+    file.write(data);
+}
+
+} // namespace
+
+class differenceRecacheTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  differenceRecacheTest() {};
+  ~differenceRecacheTest() {};
+
+private slots:
+  void initTestCase();
+  void testChildStartEndChange();
+
+private:
+  QTemporaryDir dir;
+  QString file0;
+  QString file1;
+};
+
+void differenceRecacheTest::initTestCase()
+{
+  QVERIFY(this->dir.isValid());
+  this->file0 = this->dir.filePath(QString("a_%1x%2_yuv420p.yuv").arg(width).arg(height));
+  this->file1 = this->dir.filePath(QString("b_%1x%2_yuv420p.yuv").arg(width).arg(height));
+  createRawFile(this->file0, 0);
+  createRawFile(this->file1, 1);
+}
+
+void differenceRecacheTest::testChildStartEndChange()
+{
+  auto difference = new playlistItemDifference();
+  auto child0 = new playlistItemRawFile(this->file0);
+  auto child1 = new playlistItemRawFile(this->file1);
+  difference->addChild(child0);
+  difference->addChild(child1);
+  difference->updateChildItems();
+
+  // Drawing connects the children and sets the input videos
+  QImage image(width * 2, height * 2, QImage::Format_ARGB32_Premultiplied);
+  {
+    QPainter painter(&image);
+    painter.translate(width, height);
+    difference->drawItem(&painter, 0, 1.0, false);
+  }
+  QVERIFY(difference->isCachable());
+
+  difference->cacheFrame(0, false);
+  QCOMPARE(difference->getCachedFrames(), QList<int>() << 0);
+
+  QList<recacheIndicator> recaches;
+  QObject::connect(difference, &playlistItem::signalItemChanged, [&recaches](bool redraw, recacheIndicator recache) {
+    Q_UNUSED(redraw);
+    recaches.append(recache);
+  });
+
+  // Changing the end frame of a child only asks for a RECACHE_UPDATE. The difference must ask for a RECACHE_CLEAR
+  // because all cached differences are invalid now.
+  auto endSpinBox = child0->getPropertiesWidget()->findChild<QSpinBox*>("endSpinBox");
+  QVERIFY(endSpinBox != nullptr);
+  endSpinBox->setValue(nrFrames - 3);
+  QVERIFY(!recaches.isEmpty());
+  QCOMPARE(recaches.last(), RECACHE_CLEAR);
+
+  // Until the video cache cleared the item, nothing is cached
+  QVERIFY(difference->getCachedFrames().isEmpty());
+  difference->cacheFrame(1, false);
+  QVERIFY(difference->getCachedFrames().isEmpty());
+
+  // The video cache clears the item for a RECACHE_CLEAR. After this, differences are cached again.
+  difference->removeAllFramesFromCache();
+  difference->cacheFrame(1, false);
+  QCOMPARE(difference->getCachedFrames(), QList<int>() << 1);
+
+  delete difference;
+}
+
+QTEST_MAIN(differenceRecacheTest)
+
+#include "differenceRecacheTest.moc"
@@ -0,0 +1,198 @@
+#include <QtTest>
+
+#include <QPainter>
+
+#include <playlistitem/playlistItemOverlay.h>
+
+namespace
+{
+
+// An item that draws a colored rectangle per frame. Like a video with statistics, it can draw the frame that was
+// loaded last without drawItem.
+class testItem : public playlistItem
+{
+public:
+  testItem(const QSize &size, int colorOffset) : playlistItem("Test item", playlistItem_Indexed), size(size), colorOffset(colorOffset)
+  {
+    startEndFrame = indexRange(0, 9);
+  }
+
+  virtual void savePlaylist(QDomElement &root, const QDir &playlistDir) const override { Q_UNUSED(root); Q_UNUSED(playlistDir); }
+  virtual QString getPropertiesTitle() const override { return "Test item"; }
+  virtual QSize getSize() const override { return this->size; }
+
+  virtual itemLoadingState needsLoading(int frameIdx, bool loadRawValues) override
+  {
+    Q_UNUSED(loadRawValues);
+    return (frameIdx == this->loadedFrameIdx) ? LoadingNotNeeded : LoadingNeeded;
+  }
+  virtual void loadFrame(int frameIdx, bool playback, bool loadRawData, bool emitSignals) override
+  {
+    Q_UNUSED(playback); Q_UNUSED(loadRawData); Q_UNUSED(emitSignals);
+    this->loadedFrameIdx = frameIdx;
+  }
+
+  virtual void drawItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues) override
+  {
+    Q_UNUSED(drawRawValues);
+    this->nrDrawItem++;
+    this->drawFrame(painter, frameIdx, zoomFactor);
+  }
+  virtual bool drawLoadedItem(QPainter *painter, int frameIdx, double zoomFactor, bool drawRawValues) override
+  {
+    Q_UNUSED(drawRawValues);
+    if (!this->canDrawLoaded || frameIdx != this->loadedFrameIdx)
+      return false;
+    this->nrDrawLoadedItem++;
+    this->drawFrame(painter, frameIdx, zoomFactor);
+    return true;
+  }
+
+  void setColorOffset(int offset)
+  {
+    this->colorOffset = offset;
+    emit signalItemChanged(true, RECACHE_NONE);
+  }
+
+  int nrDrawItem {0};
+  int nrDrawLoadedItem {0};
+  // If false, the item behaves like a compressed video that shows an info text
+  bool canDrawLoaded {true};
+
+private:
+  void drawFrame(QPainter *painter, int frameIdx, double zoomFactor)
+  {
+    QRect rect(QPoint(0, 0), this->size * zoomFactor);
+    rect.moveCenter(QPoint(0, 0));
+    painter->fillRect(rect, QColor(frameIdx * 20, this->colorOffset, 255 - this->colorOffset));
+    // The statistics of a video are drawn on top of the frame
+    painter->fillRect(QRect(rect.topLeft(), rect.size() / 2), QColor(this->colorOffset, frameIdx * 20, 0, 128));
+  }
+
+  QSize size;
+  int colorOffset;
+  int loadedFrameIdx {-1};
+};
+
+struct testOverlay
+{
+  testOverlay(int colorOffset)
+  {
+    this->overlay = new playlistItemOverlay();
+    this->video = new testItem(QSize(32, 16), colorOffset);
+    this->statistics = new testItem(QSize(12, 10), colorOffset + 50);
+    this->overlay->addChild(this->video);
+    this->overlay->addChild(this->statistics);
+    this->overlay->updateChildItems();
+  }
+  ~testOverlay() { delete this->overlay; }
+
+  QImage draw(int frameIdx)
+  {
+    QImage image(100, 60, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.translate(50, 30);
+    this->overlay->drawItem(&painter, frameIdx, zoomFactor, false);
+    return image;
+  }
+
+  playlistItemOverlay *overlay;
+  testItem *video;
+  testItem *statistics;
+  static constexpr double zoomFactor = 2.0;
+};
+
+} // namespace
+
+class overlayCompositionTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  overlayCompositionTest() {};
+  ~overlayCompositionTest() {};
+
+private slots:
+  void testLoadedFrameIsComposed();
+  void testFrameDrawnAgainIsComposed();
+  void testChildChangeInvalidatesLayer();
+  void testChildCanNotDrawLoaded();
+};
+
+void overlayCompositionTest::testLoadedFrameIsComposed()
+{
+  testOverlay composed(0);
+  composed.draw(0);
+
+  // Loading composes the layer of the loaded frame from what the children loaded
+  composed.overlay->loadFrame(1, true, false, false);
+  QCOMPARE(composed.video->nrDrawLoadedItem, 1);
+  QCOMPARE(composed.statistics->nrDrawLoadedItem, 1);
+
+  // The layer is drawn without drawing the children again
+  const QImage fromLayer = composed.draw(1);
+  QCOMPARE(composed.video->nrDrawItem, 1);
+  QCOMPARE(composed.statistics->nrDrawItem, 1);
+
+  // It looks exactly like the children drawn directly
+  testOverlay direct(0);
+  const QImage drawnDirectly = direct.draw(1);
+  QCOMPARE(direct.video->nrDrawItem, 1);
+  QCOMPARE(fromLayer, drawnDirectly);
+}
+
+void overlayCompositionTest::testFrameDrawnAgainIsComposed()
+{
+  testOverlay composed(0);
+  const QImage first = composed.draw(3);
+  const QImage second = composed.draw(3);
+  QCOMPARE(composed.video->nrDrawItem, 2);
+
+  // From the third time on, the layer that was composed when the frame was drawn again is used
+  const QImage third = composed.draw(3);
+  QCOMPARE(composed.video->nrDrawItem, 2);
+  QCOMPARE(second, first);
+  QCOMPARE(third, first);
+}
+
+void overlayCompositionTest::testChildChangeInvalidatesLayer()
+{
+  testOverlay composed(0);
+  composed.draw(0);
+  composed.overlay->loadFrame(1, true, false, false);
+  composed.draw(1);
+
+  // The layer of frame 1 was composed with the old child state
+  composed.statistics->setColorOffset(100);
+  const int nrDrawItem = composed.statistics->nrDrawItem;
+  const QImage afterChange = composed.draw(1);
+  QCOMPARE(composed.statistics->nrDrawItem, nrDrawItem + 1);
+
+  testOverlay direct(0);
+  direct.statistics->setColorOffset(100);
+  QCOMPARE(afterChange, direct.draw(1));
+
+  testOverlay unchanged(0);
+  QVERIFY(afterChange != unchanged.draw(1));
+}
+
+void overlayCompositionTest::testChildCanNotDrawLoaded()
+{
+  testOverlay composed(0);
+  composed.draw(0);
+
+  // No layer is composed if one child can only be drawn with drawItem
+  composed.statistics->canDrawLoaded = false;
+  composed.overlay->loadFrame(1, true, false, false);
+  const QImage drawn = composed.draw(1);
+  QCOMPARE(composed.video->nrDrawItem, 2);
+  QCOMPARE(composed.statistics->nrDrawItem, 2);
+
+  testOverlay direct(0);
+  QCOMPARE(drawn, direct.draw(1));
+}
+
+QTEST_MAIN(overlayCompositionTest)
+
+#include "overlayCompositionTest.moc"
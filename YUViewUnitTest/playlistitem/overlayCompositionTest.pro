@@ -0,0 +1,15 @@
+TEMPLATE = app
+
+CONFIG += qt console warn_on no_testcase_installs depend_includepath testcase
+CONFIG -= debug_and_release
+CONFIG -= app_bundled
+
+TARGET = overlayCompositionTest
+
+QT += testlib gui opengl xml concurrent network
+
+# The playlist items include the ui headers that are generated when building YUViewLib
+INCLUDEPATH += $$top_srcdir/YUViewLib/src $$top_builddir/YUViewLib
+LIBS += -L$$top_builddir/YUViewLib -lYUViewLib
+
+SOURCES += overlayCompositionTest.cpp
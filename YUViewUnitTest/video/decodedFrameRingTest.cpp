@@ -0,0 +1,174 @@
+#include <QtTest>
+
+#include <video/DecodedFrameRing.h>
+
+class decodedFrameRingTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  decodedFrameRingTest() {};
+  ~decodedFrameRingTest() {};
+
+private slots:
+  void testStoreAndGet();
+  void testEvictFarthestFrame();
+  void testEvictShownFramesInReverse();
+  void testCompressedFrames();
+  void testAllSignalsAndStatistics();
+  void testDisabled();
+  void testLimitSharedByAllRings();
+};
+
+void decodedFrameRingTest::testStoreAndGet()
+{
+  DecodedFrameRing ring;
+  ring.setLimits(1000, false);
+
+  QByteArray data(100, 'a');
+  ring.store(5, FrameBuffer(data));
+  QVERIFY(ring.contains(5));
+  QVERIFY(!ring.contains(4));
+  QCOMPARE(ring.getNrBytes(), int64_t(100));
+
+  // Uncompressed frames are shared, not copied
+  QCOMPARE(ring.get(5).toByteArray().constData(), data.constData());
+  QVERIFY(ring.get(4).isNull());
+
+  ring.clear();
+  QCOMPARE(ring.getNrFrames(), 0);
+  QCOMPARE(ring.getNrBytes(), int64_t(0));
+}
+
+void decodedFrameRingTest::testEvictFarthestFrame()
+{
+  DecodedFrameRing ring;
+  ring.setLimits(400, false);
+
+  // Decode frames 10 to 15 while frame 12 is requested (e.g. a GOP checkpoint after a backwards step)
+  ring.get(12);
+  for (int i = 10; i <= 15; i++)
+    ring.store(i, FrameBuffer(QByteArray(100, char(i))));
+
+  // Only 4 frames fit. The frames farthest away from frame 12 are evicted.
+  QCOMPARE(ring.getNrFrames(), 4);
+  QVERIFY(ring.contains(10));
+  QVERIFY(ring.contains(11));
+  QVERIFY(ring.contains(12));
+  QVERIFY(ring.contains(13));
+  QCOMPARE(ring.get(11).toByteArray(), QByteArray(100, char(11)));
+
+  // A frame that is bigger than the whole ring is not stored
+  ring.store(20, FrameBuffer(QByteArray(500, 'b')));
+  QVERIFY(!ring.contains(20));
+}
+
+void decodedFrameRingTest::testEvictShownFramesInReverse()
+{
+  DecodedFrameRing ring;
+  ring.setLimits(400, false);
+  ring.setPlaybackReverse(true);
+
+  // Frames 20 to 23 were played backwards. Frame 20 is shown now and the previous GOP is staged.
+  for (int i = 20; i <= 23; i++)
+    ring.store(i, FrameBuffer(QByteArray(100, char(i))));
+  ring.get(20);
+  ring.store(18, FrameBuffer(QByteArray(100, char(18))));
+  ring.store(19, FrameBuffer(QByteArray(100, char(19))));
+
+  // The frames that were already shown are evicted first
+  QCOMPARE(ring.getNrFrames(), 4);
+  QVERIFY(ring.contains(18));
+  QVERIFY(ring.contains(19));
+  QVERIFY(ring.contains(20));
+  QVERIFY(ring.contains(21));
+}
+
+void decodedFrameRingTest::testCompressedFrames()
+{
+  DecodedFrameRing ring;
+  ring.setLimits(1000, true);
+
+  QByteArray data(4000, 'c');
+  ring.store(0, FrameBuffer(data));
+  QVERIFY(ring.contains(0));
+  QVERIFY(ring.getNrBytes() < 1000);
+  QCOMPARE(ring.get(0).toByteArray(), data);
+}
+
+void decodedFrameRingTest::testAllSignalsAndStatistics()
+{
+  DecodedFrameRing ring;
+  ring.setLimits(1000, false);
+
+  // All signals of a frame are kept together
+  ring.store(3, FrameBuffer(QByteArray(100, 'r')), 0);
+  ring.store(3, FrameBuffer(QByteArray(100, 'p')), 1);
+  QVERIFY(ring.contains(3, 0));
+  QVERIFY(ring.contains(3, 1));
+  QVERIFY(!ring.contains(3, 2));
+  QCOMPARE(ring.getNrFrames(), 1);
+  QCOMPARE(ring.getNrBytes(), int64_t(200));
+  QCOMPARE(ring.get(3, 1).toByteArray(), QByteArray(100, 'p'));
+  QVERIFY(ring.get(3, 2).isNull());
+
+  statisticsData data;
+  QVERIFY(!ring.getStatistics(3, 0, data));
+  QHash<int, statisticsData> statistics;
+  statistics[0].valueData.append(statisticsItem_Value());
+  ring.storeStatistics(3, statistics);
+  QVERIFY(ring.getStatistics(3, 0, data));
+  QCOMPARE(data.valueData.size(), 1);
+  // Types without data in this frame are still served from the ring
+  QVERIFY(ring.getStatistics(3, 7, data));
+  QCOMPARE(data.valueData.size(), 0);
+  QCOMPARE(ring.getNrBytes(), int64_t(200 + sizeof(statisticsItem_Value)));
+
+  // Evicting a frame removes all of its signals and statistics
+  ring.get(10);
+  for (int i = 8; i <= 11; i++)
+    ring.store(i, FrameBuffer(QByteArray(200, char(i))));
+  QVERIFY(!ring.contains(3, 0));
+  QVERIFY(!ring.contains(3, 1));
+  QVERIFY(!ring.getStatistics(3, 0, data));
+  QCOMPARE(ring.getNrBytes(), int64_t(800));
+}
+
+void decodedFrameRingTest::testDisabled()
+{
+  DecodedFrameRing ring;
+  QVERIFY(!ring.isEnabled());
+  ring.store(0, FrameBuffer(QByteArray(10, 'd')));
+  QVERIFY(!ring.contains(0));
+}
+
+void decodedFrameRingTest::testLimitSharedByAllRings()
+{
+  DecodedFrameRing ring0;
+  ring0.setLimits(400, false);
+  for (int i = 0; i < 3; i++)
+    ring0.store(i, FrameBuffer(QByteArray(100, char(i))));
+  QCOMPARE(DecodedFrameRing::getTotalNrBytes(), int64_t(300));
+
+  {
+    // The second ring only gets what is left of the limit. It evicts its own frames, not the ones of the first ring.
+    DecodedFrameRing ring1;
+    ring1.setLimits(400, false);
+    ring1.get(0);
+    ring1.store(0, FrameBuffer(QByteArray(100, 'a')));
+    ring1.store(1, FrameBuffer(QByteArray(100, 'b')));
+    QCOMPARE(ring1.getNrFrames(), 1);
+    QVERIFY(ring1.contains(0));
+    QCOMPARE(ring0.getNrFrames(), 3);
+    QCOMPARE(DecodedFrameRing::getTotalNrBytes(), int64_t(400));
+  }
+
+  // A deleted ring frees its memory
+  QCOMPARE(DecodedFrameRing::getTotalNrBytes(), int64_t(300));
+  ring0.clear();
+  QCOMPARE(DecodedFrameRing::getTotalNrBytes(), int64_t(0));
+}
+
+QTEST_MAIN(decodedFrameRingTest)
+
+#include "decodedFrameRingTest.moc"
@@ -0,0 +1,192 @@
+#include <QtTest>
+
+#include <video/DifferenceKernels.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace DifferenceKernels;
+
+namespace
+{
+
+const int width = 37;
+const int height = 5;
+
+int readSample(const std::vector<unsigned char> &plane, int idx, int bitsPerSample, bool bigEndian)
+{
+  if (bitsPerSample <= 8)
+    return plane[idx];
+  if (bigEndian)
+    return plane[idx * 2] << 8 | plane[idx * 2 + 1];
+  return plane[idx * 2] | plane[idx * 2 + 1] << 8;
+}
+
+std::vector<unsigned char> createPlane(int bitsPerSample, bool bigEndian, int seed)
+{
+  const int bytes = bitsPerSample > 8 ? 2 : 1;
+  std::vector<unsigned char> plane(width * height * bytes);
+  for (int i = 0; i < width * height; i++)
+  {
+    int value = ((i + seed) * 2654435761u >> 7) % (1 << bitsPerSample);
+    if (i % 3 == 0)
+      value = 1 << (bitsPerSample - 1);
+    if (bytes == 1)
+      plane[i] = (unsigned char)value;
+    else
+    {
+      plane[i * 2]     = (unsigned char)(bigEndian ? value >> 8 : value & 0xff);
+      plane[i * 2 + 1] = (unsigned char)(bigEndian ? value & 0xff : value >> 8);
+    }
+  }
+  return plane;
+}
+
+} // namespace
+
+class differenceKernelsTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  differenceKernelsTest() {};
+  ~differenceKernelsTest() {};
+
+private slots:
+  void testSubtractPlane_data();
+  void testSubtractPlane();
+  void testSubtractRGB32();
+  void testFindFirstDifference();
+  void testBlockMapCodingOrder();
+};
+
+void differenceKernelsTest::testSubtractPlane_data()
+{
+  QTest::addColumn<int>("bitsPerSample0");
+  QTest::addColumn<bool>("bigEndian0");
+  QTest::addColumn<int>("bitsPerSample1");
+  QTest::addColumn<bool>("bigEndian1");
+  QTest::addColumn<int>("amplificationFactor");
+
+  QTest::newRow("8 bit") << 8 << false << 8 << false << 1;
+  QTest::newRow("8 bit amplified") << 8 << false << 8 << false << 3;
+  QTest::newRow("10 bit") << 10 << false << 10 << false << 1;
+  QTest::newRow("10 bit big endian") << 10 << true << 10 << false << 5;
+  QTest::newRow("8 and 10 bit") << 8 << false << 10 << true << 1;
+  QTest::newRow("16 bit") << 16 << false << 16 << false << 2;
+}
+
+void differenceKernelsTest::testSubtractPlane()
+{
+  QFETCH(int, bitsPerSample0);
+  QFETCH(bool, bigEndian0);
+  QFETCH(int, bitsPerSample1);
+  QFETCH(bool, bigEndian1);
+  QFETCH(int, amplificationFactor);
+
+  const auto plane0 = createPlane(bitsPerSample0, bigEndian0, 0);
+  const auto plane1 = createPlane(bitsPerSample1, bigEndian1, 11);
+  const int bytes0 = bitsPerSample0 > 8 ? 2 : 1;
+  const int bytes1 = bitsPerSample1 > 8 ? 2 : 1;
+  const int bitsOut = std::max(bitsPerSample0, bitsPerSample1);
+  const int bytesOut = bitsOut > 8 ? 2 : 1;
+
+  std::vector<unsigned char> dst(width * height * bytesOut);
+  Plane in0 {plane0.data(), width * bytes0, bitsPerSample0, bigEndian0};
+  Plane in1 {plane1.data(), width * bytes1, bitsPerSample1, bigEndian1};
+  const int64_t sse = subtractPlane(in0, in1, width, height, amplificationFactor, dst.data(), width * bytesOut);
+
+  // The lower bit depth is scaled up and the output is always little endian
+  int64_t expectedSSE = 0;
+  for (int i = 0; i < width * height; i++)
+  {
+    const int diff = (readSample(plane0, i, bitsPerSample0, bigEndian0) << (bitsOut - bitsPerSample0)) - (readSample(plane1, i, bitsPerSample1, bigEndian1) << (bitsOut - bitsPerSample1));
+    expectedSSE += int64_t(diff) * diff;
+    const int expected = std::min(std::max(diff * amplificationFactor + (1 << (bitsOut - 1)), 0), (1 << bitsOut) - 1);
+    QCOMPARE(readSample(dst, i, bitsOut, false), expected);
+  }
+  QCOMPARE(sse, expectedSSE);
+}
+
+void differenceKernelsTest::testSubtractRGB32()
+{
+  std::vector<unsigned char> image0(width * height * 4);
+  std::vector<unsigned char> image1(width * height * 4);
+  for (size_t i = 0; i < image0.size(); i++)
+  {
+    image0[i] = (unsigned char)(i * 37);
+    image1[i] = (i % 5 == 0) ? (unsigned char)(i * 11) : image0[i];
+  }
+
+  for (bool markDifference : {false, true})
+  {
+    std::vector<unsigned char> dst(width * height * 4);
+    int64_t sse[3] = {0, 0, 0};
+    subtractRGB32(image0.data(), width * 4, image1.data(), width * 4, width, height, 4, markDifference, dst.data(), width * 4, sse);
+
+    // The buffers are BGRA
+    int64_t expectedSSE[3] = {0, 0, 0};
+    for (int i = 0; i < width * height; i++)
+    {
+      for (int c = 0; c < 3; c++)
+      {
+        const int diff = image0[i * 4 + c] - image1[i * 4 + c];
+        expectedSSE[2 - c] += diff * diff;
+        const int expected = markDifference ? (diff == 0 ? 0 : 255) : std::min(std::max(128 + diff * 4, 0), 255);
+        QCOMPARE(int(dst[i * 4 + c]), expected);
+      }
+      QCOMPARE(int(dst[i * 4 + 3]), 255);
+    }
+    for (int c = 0; c < 3; c++)
+      QCOMPARE(sse[c], expectedSSE[c]);
+  }
+}
+
+void differenceKernelsTest::testFindFirstDifference()
+{
+  std::vector<unsigned char> row(200, 7);
+  QCOMPARE(findFirstDifference(row.data(), 200, 1, 7), -1);
+  row[150] = 8;
+  QCOMPARE(findFirstDifference(row.data(), 200, 1, 7), 150);
+  QCOMPARE(findFirstDifference(row.data(), 100, 2, 0x0707), 75);
+
+  // Only the masked bytes are compared
+  row[150] = 7;
+  row[199] = 1;
+  QCOMPARE(findFirstDifference(row.data(), 50, 4, 0x07070707), 49);
+  QCOMPARE(findFirstDifference(row.data(), 50, 4, 0x00070707, 0x00ffffff), -1);
+}
+
+void differenceKernelsTest::testBlockMapCodingOrder()
+{
+  int ctuIndex, x, y, partIndex;
+
+  BlockMap blocks;
+  blocks.reset(QSize(130, 70));
+  QVERIFY(!blocks.findFirstInCodingOrder(64, ctuIndex, x, y, partIndex));
+
+  // A difference in the last sample. The last CTU only contains two 4x4 blocks inside of the frame.
+  std::vector<unsigned char> luma(130 * 70, 128);
+  luma[69 * 130 + 129] = 5;
+  blocks.markPlane(luma.data(), 130, 130, 70, 1, 128);
+  QVERIFY(blocks.findFirstInCodingOrder(64, ctuIndex, x, y, partIndex));
+  QCOMPARE(ctuIndex, 5);
+  QCOMPARE(x, 128);
+  QCOMPARE(y, 68);
+  QCOMPARE(partIndex, 1);
+
+  // A difference in a 4:2:0 chroma plane is marked at the luma position
+  blocks.reset(QSize(128, 64));
+  std::vector<unsigned char> chroma(64 * 32, 128);
+  chroma[1 * 64 + 10] = 0;
+  blocks.markPlane(chroma.data(), 64, 64, 32, 1, 128, 0xffffffff, 2, 2);
+  QVERIFY(blocks.findFirstInCodingOrder(64, ctuIndex, x, y, partIndex));
+  QCOMPARE(ctuIndex, 0);
+  QCOMPARE(x, 20);
+  QCOMPARE(y, 0);
+  QCOMPARE(partIndex, 17);
+}
+
+QTEST_MAIN(differenceKernelsTest)
+
+#include "differenceKernelsTest.moc"
@@ -0,0 +1,76 @@
+#include <QtTest>
+
+#include <video/FrameBuffer.h>
+
+class frameBufferTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  frameBufferTest() {};
+  ~frameBufferTest() {};
+
+private slots:
+  void testWrapByteArray();
+  void testPackStridedPlanes();
+  void testOwnerReleasedWithLastCopy();
+};
+
+void frameBufferTest::testWrapByteArray()
+{
+  QByteArray data(24, 'a');
+  FrameBuffer buffer(data);
+  QVERIFY(!buffer.isNull());
+  QVERIFY(!buffer.hasPlanes());
+  QCOMPARE(buffer.getNrBytes(), 24);
+  // The data is shared, not copied
+  QCOMPARE(buffer.toByteArray().constData(), data.constData());
+
+  QVERIFY(FrameBuffer().isNull());
+  QVERIFY(FrameBuffer(QByteArray()).isNull());
+}
+
+void frameBufferTest::testPackStridedPlanes()
+{
+  // A 4x2 luma plane with a stride of 6 and two 2x1 chroma planes with a stride of 4 (4:2:0)
+  const unsigned char luma[] = {1, 2, 3, 4, 0, 0, 5, 6, 7, 8, 0, 0};
+  const unsigned char cb[] = {10, 11, 0, 0};
+  const unsigned char cr[] = {20, 21, 0, 0};
+
+  FrameBuffer buffer(std::shared_ptr<void>(nullptr));
+  buffer.addPlane(luma, 6, 4, 2);
+  buffer.addPlane(cb, 4, 2, 1);
+  buffer.addPlane(cr, 4, 2, 1);
+
+  QVERIFY(buffer.hasPlanes());
+  QCOMPARE(buffer.getNrPlanes(), 3);
+  QVERIFY(!buffer.arePlanesTightlyPacked());
+  QCOMPARE(buffer.getNrBytes(), 12);
+  QCOMPARE(buffer.getPlane(0).data, luma);
+
+  const unsigned char expected[] = {1, 2, 3, 4, 5, 6, 7, 8, 10, 11, 20, 21};
+  const auto packed = buffer.toByteArray();
+  QCOMPARE(packed, QByteArray((const char*)expected, 12));
+
+  // The packed data is shared by all copies
+  FrameBuffer copy = buffer;
+  QCOMPARE(copy.toByteArray().constData(), packed.constData());
+}
+
+void frameBufferTest::testOwnerReleasedWithLastCopy()
+{
+  int nrReleased = 0;
+  {
+    FrameBuffer copy;
+    {
+      FrameBuffer buffer(std::shared_ptr<int>(new int(0), [&nrReleased](int *p) { nrReleased++; delete p; }));
+      copy = buffer;
+    }
+    QCOMPARE(nrReleased, 0);
+  }
+  QCOMPARE(nrReleased, 1);
+}
+
+QTEST_MAIN(frameBufferTest)
+
+#include "frameBufferTest.moc"
@@ -0,0 +1,162 @@
+#include <QtTest>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <video/FrameExporter.h>
+
+namespace
+{
+
+// The frame size and format are guessed from the file names
+const int width = 176;
+const int height = 144;
+const int nrFrames = 24;
+
+QByteArray createRawFile(const QString &fileName, int64_t bytesPerFrame)
+{
+  QByteArray data(int(bytesPerFrame * nrFrames), 0);
+  for (int i = 0; i < data.size(); i++)
+    data[i] = char((i * 2654435761u) >> 13);
+  QFile file(fileName);
+  if (file.open(QIODevice::WriteOnly))
+    file.write(data);
+  return data;
+}
+
+QByteArray readFile(const QString &fileName)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+    return {};
+  return file.readAll();
+}
+
+FrameExporter::Result exportFile(const QString &input, const QString &output, FrameExporter::OutputFormat format, int nrThreads, int64_t maxNrFrames = 0)
+{
+  FrameExporter::Source source;
+  source.fileName = input;
+  FrameExporter exporter(source, output, format);
+  exporter.setNrConversionThreads(nrThreads);
+  exporter.setMaxNrFrames(maxNrFrames);
+  return exporter.run();
+}
+
+} // namespace
+
+class frameExporterTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  frameExporterTest() {};
+  ~frameExporterTest() {};
+
+private slots:
+  void initTestCase();
+
+  void testRawYUV();
+  void testMaxNrFrames();
+  void testWriterOrder();
+  void testInputError();
+  void testSourceFormatError();
+  void testOutputErrorStopsPipeline();
+  void testCancel();
+
+private:
+  QTemporaryDir dir;
+  QString yuvFile;
+  QByteArray yuvData;
+  QString rgbFile;
+};
+
+void frameExporterTest::initTestCase()
+{
+  QVERIFY(this->dir.isValid());
+  this->yuvFile = this->dir.filePath(QString("source_%1x%2_yuv420p.yuv").arg(width).arg(height));
+  this->yuvData = createRawFile(this->yuvFile, width * height * 3 / 2);
+  this->rgbFile = this->dir.filePath(QString("source_%1x%2.rgb").arg(width).arg(height));
+  createRawFile(this->rgbFile, width * height * 3);
+}
+
+void frameExporterTest::testRawYUV()
+{
+  // Exporting raw YUV to raw YUV must give the input again (in order, even with multiple converters)
+  const auto output = this->dir.filePath("out.yuv");
+  const auto result = exportFile(this->yuvFile, output, FrameExporter::OutputFormat::RawYUV, 4);
+  QVERIFY2(result.success, result.error.toLatin1().data());
+  QCOMPARE(result.nrFrames, int64_t(nrFrames));
+  QCOMPARE(result.nrBytesWritten, int64_t(this->yuvData.size()));
+  QVERIFY(readFile(output) == this->yuvData);
+}
+
+void frameExporterTest::testMaxNrFrames()
+{
+  const auto output = this->dir.filePath("out_max.yuv");
+  const auto result = exportFile(this->yuvFile, output, FrameExporter::OutputFormat::RawYUV, 2, 5);
+  QVERIFY2(result.success, result.error.toLatin1().data());
+  QCOMPARE(result.nrFrames, int64_t(5));
+  QVERIFY(readFile(output) == this->yuvData.left(5 * width * height * 3 / 2));
+}
+
+void frameExporterTest::testWriterOrder()
+{
+  // The converters finish the frames out of order. The writer must put them back in order so that the result
+  // is the same as with one converter.
+  const auto outputSingle = this->dir.filePath("out_single.rgb");
+  const auto outputParallel = this->dir.filePath("out_parallel.rgb");
+  const auto resultSingle = exportFile(this->yuvFile, outputSingle, FrameExporter::OutputFormat::RawRGB, 1);
+  const auto resultParallel = exportFile(this->yuvFile, outputParallel, FrameExporter::OutputFormat::RawRGB, 6);
+  QVERIFY2(resultSingle.success, resultSingle.error.toLatin1().data());
+  QVERIFY2(resultParallel.success, resultParallel.error.toLatin1().data());
+  QCOMPARE(resultParallel.nrFrames, int64_t(nrFrames));
+
+  const auto single = readFile(outputSingle);
+  QCOMPARE(single.size(), width * height * 3 * nrFrames);
+  QVERIFY(readFile(outputParallel) == single);
+}
+
+void frameExporterTest::testInputError()
+{
+  const auto output = this->dir.filePath("out_missing.yuv");
+  const auto result = exportFile(this->dir.filePath("missing_176x144.yuv"), output, FrameExporter::OutputFormat::RawYUV, 1);
+  QVERIFY(!result.success);
+  QVERIFY(result.error.startsWith("Error opening the input file"));
+  QCOMPARE(result.nrFrames, int64_t(0));
+}
+
+void frameExporterTest::testSourceFormatError()
+{
+  const auto result = exportFile(this->rgbFile, this->dir.filePath("out_rgb.yuv"), FrameExporter::OutputFormat::RawYUV, 1);
+  QVERIFY(!result.success);
+  QCOMPARE(result.error, QString("The source is RGB. It can only be exported as RGB or PNG."));
+}
+
+void frameExporterTest::testOutputErrorStopsPipeline()
+{
+  // The writer fails right away while the reader has more frames than fit into the queues. All stages must stop
+  // and the error of the writer is reported (and not a later one).
+  const auto output = this->dir.filePath("missing_dir/out.rgb");
+  const auto result = exportFile(this->yuvFile, output, FrameExporter::OutputFormat::RawRGB, 1);
+  QVERIFY(!result.success);
+  QCOMPARE(result.error, "Unable to open the output file " + output);
+  QCOMPARE(result.nrFrames, int64_t(0));
+}
+
+void frameExporterTest::testCancel()
+{
+  FrameExporter::Source source;
+  source.fileName = this->yuvFile;
+  const auto output = this->dir.filePath("out_canceled.yuv");
+  FrameExporter exporter(source, output, FrameExporter::OutputFormat::RawYUV);
+  exporter.cancel();
+  const auto result = exporter.run();
+  QVERIFY(!result.success);
+  QCOMPARE(result.error, QString("The export was canceled."));
+  QCOMPARE(result.nrFrames, int64_t(0));
+}
+
+QTEST_MAIN(frameExporterTest)
+
+#include "frameExporterTest.moc"
@@ -0,0 +1,64 @@
+#include <QtTest>
+
+#include <video/GlyphAtlas.h>
+
+#include <climits>
+
+class glyphAtlasTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  glyphAtlasTest() {};
+  ~glyphAtlasTest() {};
+
+private slots:
+  void testFormatValues();
+  void testFormatOverflow();
+};
+
+namespace
+{
+QByteArray toByteArray(const GlyphAtlas::Text &text)
+{
+  return QByteArray(text.chars, text.length);
+}
+} // namespace
+
+void glyphAtlasTest::testFormatValues()
+{
+  GlyphAtlas::Text text;
+  QCOMPARE(toByteArray(text), QByteArray());
+
+  text.addValue('Y', 235, 10);
+  QCOMPARE(toByteArray(text), QByteArray("Y235"));
+  text.addValue('U', -12, 10);
+  text.addValue('V', 0, 10);
+  QCOMPARE(toByteArray(text), QByteArray("Y235\nU-12\nV0"));
+
+  // Hex values as in QString::number
+  GlyphAtlas::Text hexText;
+  hexText.addValue('R', 255, 16);
+  hexText.addValue('G', -171, 16);
+  hexText.addValue('B', 1023, 16);
+  QCOMPARE(toByteArray(hexText), QByteArray("Rff\nG-ab\nB3ff"));
+
+  GlyphAtlas::Text noLabel;
+  noLabel.addValue(INT_MIN, 10);
+  QCOMPARE(toByteArray(noLabel), QByteArray::number(INT_MIN));
+}
+
+void glyphAtlasTest::testFormatOverflow()
+{
+  // Lines that do not fit completely are dropped
+  GlyphAtlas::Text text;
+  for (int i = 0; i < 20; i++)
+    text.addValue('A', 1234567, 10);
+  QVERIFY(text.length <= GlyphAtlas::Text::maxLength);
+  QCOMPARE(text.length % 9, 8);
+  QVERIFY(toByteArray(text).endsWith("\nA1234567"));
+}
+
+QTEST_MAIN(glyphAtlasTest)
+
+#include "glyphAtlasTest.moc"
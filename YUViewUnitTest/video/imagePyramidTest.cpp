@@ -0,0 +1,113 @@
+#include <QtTest>
+
+#include <video/ImagePyramid.h>
+
+class imagePyramidTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  imagePyramidTest() {};
+  ~imagePyramidTest() {};
+
+private slots:
+  void testLevelForZoom();
+  void testDownscaleByTwo();
+  void testBuildLevels();
+  void testPyramid();
+};
+
+void imagePyramidTest::testLevelForZoom()
+{
+  QCOMPARE(ImagePyramid::getLevelForZoom(2.0), 0);
+  QCOMPARE(ImagePyramid::getLevelForZoom(1.0), 0);
+  QCOMPARE(ImagePyramid::getLevelForZoom(0.6), 0);
+  QCOMPARE(ImagePyramid::getLevelForZoom(0.5), 0);
+  QCOMPARE(ImagePyramid::getLevelForZoom(0.4), 1);
+  QCOMPARE(ImagePyramid::getLevelForZoom(0.25), 2);
+  // An 8K frame fit into a 1080p window
+  QCOMPARE(ImagePyramid::getLevelForZoom(1920.0 / 7680), 2);
+  QCOMPARE(ImagePyramid::getLevelForZoom(0.1), 3);
+}
+
+void imagePyramidTest::testDownscaleByTwo()
+{
+  // Odd sizes: The last line and column are dropped. Use a width that covers the SIMD loop and the scalar tail.
+  QImage image(11, 5, QImage::Format_ARGB32_Premultiplied);
+  for (int y = 0; y < image.height(); y++)
+    for (int x = 0; x < image.width(); x++)
+      image.setPixel(x, y, qRgba(x * 20, y * 50, (x + y) * 10, 255));
+
+  const auto scaled = ImagePyramid::downscaleByTwo(image);
+  QCOMPARE(scaled.size(), QSize(5, 2));
+  QCOMPARE(scaled.format(), image.format());
+  for (int y = 0; y < scaled.height(); y++)
+  {
+    for (int x = 0; x < scaled.width(); x++)
+    {
+      // The average of 2x2 pixels (rounded)
+      const auto expected = qRgba(x * 40 + 10, y * 100 + 25, (2 * x + 2 * y) * 10 + 10, 255);
+      const auto pixel = scaled.pixel(x, y);
+      QCOMPARE(qRed(pixel), qRed(expected));
+      QCOMPARE(qGreen(pixel), qGreen(expected));
+      QCOMPARE(qBlue(pixel), qBlue(expected));
+      QCOMPARE(qAlpha(pixel), 255);
+    }
+  }
+
+  // Rounding of the average
+  QImage rounding(2, 2, QImage::Format_RGB32);
+  rounding.fill(qRgb(1, 2, 3));
+  rounding.setPixel(0, 0, qRgb(2, 3, 4));
+  rounding.setPixel(1, 1, qRgb(2, 3, 4));
+  QCOMPARE(ImagePyramid::downscaleByTwo(rounding).pixel(0, 0), qRgb(2, 3, 4));
+
+  // Too small to be scaled
+  QVERIFY(ImagePyramid::downscaleByTwo(QImage(1, 8, QImage::Format_RGB32)).isNull());
+}
+
+void imagePyramidTest::testBuildLevels()
+{
+  QImage image(256, 100, QImage::Format_RGB32);
+  image.fill(Qt::red);
+
+  // Levels stop before the width or height gets smaller than 16
+  const auto levels = ImagePyramid::buildLevels(image, 5);
+  QCOMPARE(levels.size(), 2);
+  QCOMPARE(levels[0].size(), QSize(128, 50));
+  QCOMPARE(levels[1].size(), QSize(64, 25));
+  QCOMPARE(levels[1].pixel(10, 10), qRgb(255, 0, 0));
+  QCOMPARE(ImagePyramid::getLevelsBytes(image.size(), 4, 5), int64_t((128 * 50 + 64 * 25) * 4));
+  QVERIFY(ImagePyramid::buildLevels(image, 0).isEmpty());
+}
+
+void imagePyramidTest::testPyramid()
+{
+  QImage image(128, 128, QImage::Format_RGB32);
+  image.fill(Qt::blue);
+
+  ImagePyramid pyramid;
+  QVERIFY(!pyramid.isForImage(image));
+  pyramid.setImage(image);
+  QVERIFY(pyramid.isForImage(image));
+  QCOMPARE(pyramid.getLevel(0).cacheKey(), image.cacheKey());
+  QCOMPARE(pyramid.getLevel(2).size(), QSize(32, 32));
+  // Level 1 was built on the way to level 2
+  QCOMPARE(pyramid.getLevel(1).size(), QSize(64, 64));
+  // Not more levels than the size allows
+  QCOMPARE(pyramid.getLevel(10).size(), QSize(16, 16));
+
+  // Modifying the image detaches it. The pyramid does not belong to it anymore.
+  auto modified = image;
+  modified.setPixel(0, 0, qRgb(0, 0, 0));
+  QVERIFY(!pyramid.isForImage(modified));
+
+  // Levels that were built ahead of time are used
+  const auto levels = ImagePyramid::buildLevels(image, 1);
+  pyramid.setImage(image, levels);
+  QCOMPARE(pyramid.getLevel(1).cacheKey(), levels[0].cacheKey());
+}
+
+QTEST_MAIN(imagePyramidTest)
+
+#include "imagePyramidTest.moc"
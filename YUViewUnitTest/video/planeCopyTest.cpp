@@ -0,0 +1,93 @@
+#include <QtTest>
+
+#include <video/PlaneCopy.h>
+
+#include <vector>
+
+class planeCopyTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  planeCopyTest() {};
+  ~planeCopyTest() {};
+
+private slots:
+  void testNarrowStridedPlane();
+  void testCopy16BitStridedPlane();
+  void testCopy16BitPackedPlane();
+};
+
+void planeCopyTest::testNarrowStridedPlane()
+{
+  // A width of 37 covers the vector loop and the remainder. The padding at the end of
+  // each line must neither be read into the output nor may the output stride be ignored.
+  const int width = 37;
+  const int height = 3;
+  const int srcStride = 48;
+  const int dstStride = 40;
+
+  std::vector<short> src(srcStride * height, 999);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      src[y * srcStride + x] = short((x * 7 + y * 13) % 256);
+  src[1] = 300;
+  src[2] = -5;
+
+  std::vector<unsigned char> dst(dstStride * height, 42);
+  PlaneCopy::narrow16BitTo8Bit(src.data(), srcStride, dst.data(), dstStride, width, height);
+
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+    {
+      int expected = (x * 7 + y * 13) % 256;
+      if (y == 0 && x == 1)
+        expected = 255;
+      if (y == 0 && x == 2)
+        expected = 0;
+      QCOMPARE(int(dst[y * dstStride + x]), expected);
+    }
+    for (int x = width; x < dstStride; x++)
+      QCOMPARE(int(dst[y * dstStride + x]), 42);
+  }
+}
+
+void planeCopyTest::testCopy16BitStridedPlane()
+{
+  const int width = 19;
+  const int height = 4;
+  const int srcStride = 32;
+
+  std::vector<short> src(srcStride * height, 0);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      src[y * srcStride + x] = short(y * 1000 + x);
+
+  std::vector<unsigned short> dst(width * height, 0);
+  PlaneCopy::copy16Bit(src.data(), srcStride, dst.data(), width, width, height);
+
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      QCOMPARE(int(dst[y * width + x]), y * 1000 + x);
+}
+
+void planeCopyTest::testCopy16BitPackedPlane()
+{
+  const int width = 8;
+  const int height = 2;
+
+  std::vector<short> src(width * height);
+  for (int i = 0; i < width * height; i++)
+    src[i] = short(1023 - i);
+
+  std::vector<unsigned short> dst(width * height, 0);
+  PlaneCopy::copy16Bit(src.data(), width, dst.data(), width, width, height);
+
+  for (int i = 0; i < width * height; i++)
+    QCOMPARE(int(dst[i]), 1023 - i);
+}
+
+QTEST_MAIN(planeCopyTest)
+
+#include "planeCopyTest.moc"
@@ -0,0 +1,131 @@
+#include <QtTest>
+
+#include <video/PrefetchSelection.h>
+
+using PrefetchSelection::Candidate;
+using Candidates = std::array<Candidate, 2>;
+
+namespace
+{
+
+Candidate makeCandidate(int frameIdx, int nrFramesAhead, int nrThreadsWorking, double frameCostMs)
+{
+  Candidate c;
+  c.frameIdx = frameIdx;
+  c.nrFramesAhead = nrFramesAhead;
+  c.nrThreadsWorking = nrThreadsWorking;
+  c.frameCostMs = frameCostMs;
+  return c;
+}
+
+} // namespace
+
+class prefetchSelectionTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  prefetchSelectionTest() {};
+  ~prefetchSelectionTest() {};
+
+private slots:
+  void testNoCandidate();
+  void testAllThreadsBusy();
+  void testSingleItem();
+  void testUnknownCostSplitsEqually();
+  void testSlowerItemGetsMoreThreads();
+  void testFewerFramesAheadFirst();
+  void testTieGoesToSlowerItem();
+};
+
+void prefetchSelectionTest::testNoCandidate()
+{
+  Candidates candidates;
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, true), -1);
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, false), -1);
+}
+
+void prefetchSelectionTest::testAllThreadsBusy()
+{
+  // Threads working on an item count against the limit even if the item has nothing left to prefetch
+  Candidates candidates = {makeCandidate(12, 0, 2, 10.0), makeCandidate(-1, 0, 2, 10.0)};
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, true), -1);
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 5, true), 0);
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 0, true), -1);
+}
+
+void prefetchSelectionTest::testSingleItem()
+{
+  Candidates candidates = {Candidate(), makeCandidate(7, 3, 3, 0.0)};
+  QCOMPARE(PrefetchSelection::getThreadShare(candidates, 1, 4, false), 4);
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, false), 1);
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 3, false), -1);
+}
+
+void prefetchSelectionTest::testUnknownCostSplitsEqually()
+{
+  Candidates candidates = {makeCandidate(5, 0, 0, 0.0), makeCandidate(5, 0, 0, 0.0)};
+  QCOMPARE(PrefetchSelection::getThreadShare(candidates, 0, 4, true), 2);
+  QCOMPARE(PrefetchSelection::getThreadShare(candidates, 1, 4, true), 2);
+
+  // Each item gets at least one thread
+  QCOMPARE(PrefetchSelection::getThreadShare(candidates, 0, 1, true), 1);
+  QCOMPARE(PrefetchSelection::getThreadShare(candidates, 1, 1, true), 1);
+
+  // The item that already has its share is not preferred even if it is less far ahead
+  candidates = {makeCandidate(5, 0, 2, 0.0), makeCandidate(8, 3, 1, 0.0)};
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, true), 1);
+}
+
+void prefetchSelectionTest::testSlowerItemGetsMoreThreads()
+{
+  // Item 0 takes three times as long per frame, so it should get three of the four threads
+  Candidates candidates = {makeCandidate(5, 0, 0, 30.0), makeCandidate(5, 0, 0, 10.0)};
+  QCOMPARE(PrefetchSelection::getThreadShare(candidates, 0, 4, true), 3);
+  QCOMPARE(PrefetchSelection::getThreadShare(candidates, 1, 4, true), 1);
+
+  // Simulate handing out the threads one after the other
+  int nrThreads[2] = {0, 0};
+  for (int i = 0; i < 4; i++)
+  {
+    candidates[0].nrThreadsWorking = nrThreads[0];
+    candidates[1].nrThreadsWorking = nrThreads[1];
+    const int next = PrefetchSelection::selectNextJob(candidates, 4, true);
+    QVERIFY(next != -1);
+    nrThreads[next]++;
+    candidates[next].nrFramesAhead++;
+  }
+  QCOMPARE(nrThreads[0], 3);
+  QCOMPARE(nrThreads[1], 1);
+
+  candidates[0].nrThreadsWorking = 3;
+  candidates[1].nrThreadsWorking = 1;
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, true), -1);
+}
+
+void prefetchSelectionTest::testFewerFramesAheadFirst()
+{
+  // Both items are below their share. The one that is less far ahead of playback is prefetched first.
+  Candidates candidates = {makeCandidate(9, 4, 0, 10.0), makeCandidate(6, 1, 0, 10.0)};
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, true), 1);
+
+  candidates = {makeCandidate(6, 1, 0, 10.0), makeCandidate(9, 4, 0, 10.0)};
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, true), 0);
+}
+
+void prefetchSelectionTest::testTieGoesToSlowerItem()
+{
+  Candidates candidates = {makeCandidate(6, 1, 0, 10.0), makeCandidate(6, 1, 0, 20.0)};
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, true), 1);
+
+  candidates[0].frameCostMs = 25.0;
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, true), 0);
+
+  // With equal cost, the first item is kept
+  candidates[1].frameCostMs = 25.0;
+  QCOMPARE(PrefetchSelection::selectNextJob(candidates, 4, true), 0);
+}
+
+QTEST_MAIN(prefetchSelectionTest)
+
+#include "prefetchSelectionTest.moc"
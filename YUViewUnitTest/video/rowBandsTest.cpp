@@ -0,0 +1,247 @@
+#include <QtTest>
+
+#include <QMutex>
+#include <QThreadPool>
+
+#include <common/ThreadBudget.h>
+#include <video/RowBands.h>
+#include <video/videoHandlerRGB.h>
+#include <video/videoHandlerYUV.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace YUV_Internals;
+
+namespace
+{
+
+// Gives access to the display settings of the YUV handler
+class testVideoHandlerYUV : public videoHandlerYUV
+{
+public:
+  void setChromaInterpolation(ChromaInterpolation interpolation) { this->chromaInterpolation = interpolation; }
+  void setLumaOnly(bool lumaOnly) { this->componentDisplayMode = lumaOnly ? DisplayY : DisplayAll; }
+};
+
+QByteArray createFrame(int64_t nrBytes, int bitsPerSample)
+{
+  QByteArray data(int(nrBytes), 0);
+  auto sample = [bitsPerSample](int i) { return int((i * 2654435761u) >> 9) % (1 << bitsPerSample); };
+  if (bitsPerSample <= 8)
+    for (int i = 0; i < data.size(); i++)
+      data[i] = char(sample(i));
+  else
+    for (int i = 0; i < data.size() / 2; i++)
+    {
+      const auto value = sample(i);
+      data[i * 2] = char(value & 0xff);
+      data[i * 2 + 1] = char(value >> 8);
+    }
+  return data;
+}
+
+// The row band conversion is only used if the thread budget (and with it the pool) has more than one thread
+void setNrThreads(int nrThreads) { ThreadBudget::instance().setTotalThreads(nrThreads); }
+
+} // namespace
+
+class rowBandsTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  rowBandsTest() {};
+  ~rowBandsTest() {};
+
+private slots:
+  void cleanup();
+
+  void testGetNrBands();
+  void testRun_data();
+  void testRun();
+  void testYUVConversion_data();
+  void testYUVConversion();
+  void testRGBConversion_data();
+  void testRGBConversion();
+};
+
+void rowBandsTest::cleanup()
+{
+  ThreadBudget::instance().updateSettings();
+}
+
+void rowBandsTest::testGetNrBands()
+{
+  setNrThreads(8);
+
+  // Small frames are not split
+  QCOMPARE(RowBands::getNrBands(QSize(352, 288)), 1);
+  QCOMPARE(RowBands::getNrBands(QSize(0, 0)), 1);
+
+  // No more bands than threads in the pool
+  QCOMPARE(RowBands::getNrBands(QSize(7680, 4320)), 8);
+  setNrThreads(3);
+  QCOMPARE(RowBands::getNrBands(QSize(7680, 4320)), 3);
+  setNrThreads(1);
+  QCOMPARE(RowBands::getNrBands(QSize(7680, 4320)), 1);
+
+  // The pool is sized from the budget
+  setNrThreads(8);
+  RowBands::getThreadPool()->setMaxThreadCount(2);
+  QCOMPARE(RowBands::getNrBands(QSize(7680, 4320)), 8);
+  QCOMPARE(RowBands::getThreadPool()->maxThreadCount(), 8);
+
+  QCOMPARE(RowBands::getNrBands(QSize(200000, 12), 4), 3);
+  QCOMPARE(RowBands::getNrBands(QSize(200000, 3), 4), 1);
+}
+
+void rowBandsTest::testRun_data()
+{
+  QTest::addColumn<int>("nrRows");
+  QTest::addColumn<int>("nrBands");
+  QTest::addColumn<int>("rowAlignment");
+
+  QTest::newRow("one band") << 100 << 1 << 1;
+  QTest::newRow("even split") << 100 << 4 << 1;
+  QTest::newRow("uneven split") << 101 << 7 << 1;
+  QTest::newRow("aligned to 2") << 1081 << 5 << 2;
+  QTest::newRow("aligned to 4") << 515 << 8 << 4;
+}
+
+void rowBandsTest::testRun()
+{
+  QFETCH(int, nrRows);
+  QFETCH(int, nrBands);
+  QFETCH(int, rowAlignment);
+
+  setNrThreads(nrBands);
+
+  QMutex bandsMutex;
+  QList<QPair<int, int>> bands;
+  std::vector<int> rowCount(nrRows, 0);
+  RowBands::run(nrRows, nrBands, rowAlignment, [&](int rowBegin, int rowEnd) {
+    QMutexLocker lock(&bandsMutex);
+    bands.append(qMakePair(rowBegin, rowEnd));
+    for (int row = rowBegin; row < rowEnd; row++)
+      rowCount[row]++;
+  });
+
+  // Every row is converted exactly once
+  QVERIFY(std::all_of(rowCount.begin(), rowCount.end(), [](int count) { return count == 1; }));
+
+  // No empty bands, not more than requested and all borders (except for the end of the frame) are aligned
+  QVERIFY(bands.size() >= 1 && bands.size() <= nrBands);
+  for (const auto &band : bands)
+  {
+    QVERIFY(band.first < band.second);
+    QCOMPARE(band.first % rowAlignment, 0);
+    QVERIFY(band.second == nrRows || band.second % rowAlignment == 0);
+  }
+}
+
+void rowBandsTest::testYUVConversion_data()
+{
+  QTest::addColumn<int>("subsampling");
+  QTest::addColumn<int>("bitsPerSample");
+  QTest::addColumn<int>("interpolation");
+  QTest::addColumn<int>("chromaOffsetX");
+  QTest::addColumn<bool>("lumaOnly");
+  QTest::addColumn<int>("height");
+
+  const auto yuv420 = int(Subsampling::YUV_420);
+  const auto yuv422 = int(Subsampling::YUV_422);
+  const auto yuv444 = int(Subsampling::YUV_444);
+  const auto yuv400 = int(Subsampling::YUV_400);
+  const auto nearest = int(ChromaInterpolation::NearestNeighbor);
+  const auto bilinear = int(ChromaInterpolation::Bilinear);
+
+  // The 8 bit 4:2:0 conversion splits the line pairs into bands
+  QTest::newRow("4:2:0 8 bit") << yuv420 << 8 << nearest << 0 << false << 516;
+  // The default 4:2:0 chroma offset is resampled once before the bands are converted
+  QTest::newRow("4:2:0 10 bit") << yuv420 << 10 << nearest << 0 << false << 516;
+  QTest::newRow("4:2:0 luma only") << yuv420 << 8 << bilinear << 0 << true << 516;
+  // Vertical interpolation is not split into bands but must still give the same result
+  QTest::newRow("4:2:0 bilinear") << yuv420 << 8 << bilinear << 0 << false << 516;
+  QTest::newRow("4:2:2 bilinear") << yuv422 << 8 << bilinear << 0 << false << 515;
+  QTest::newRow("4:2:2 bilinear chroma offset") << yuv422 << 10 << bilinear << 1 << false << 515;
+  QTest::newRow("4:2:2 chroma offset") << yuv422 << 8 << nearest << 3 << false << 513;
+  QTest::newRow("4:4:4 16 bit") << yuv444 << 16 << nearest << 0 << false << 513;
+  QTest::newRow("4:0:0") << yuv400 << 8 << nearest << 0 << false << 517;
+}
+
+void rowBandsTest::testYUVConversion()
+{
+  QFETCH(int, subsampling);
+  QFETCH(int, bitsPerSample);
+  QFETCH(int, interpolation);
+  QFETCH(int, chromaOffsetX);
+  QFETCH(bool, lumaOnly);
+  QFETCH(int, height);
+
+  const QSize frameSize(1024, height);
+  auto format = yuvPixelFormat(Subsampling(subsampling), bitsPerSample, PlaneOrder::YUV);
+  if (chromaOffsetX != 0)
+    format.chromaOffset[0] = chromaOffsetX;
+  QVERIFY(format.canConvertToRGB(frameSize));
+
+  testVideoHandlerYUV handler;
+  handler.setFrameSize(frameSize);
+  handler.setYUVPixelFormat(format);
+  handler.setChromaInterpolation(ChromaInterpolation(interpolation));
+  handler.setLumaOnly(lumaOnly);
+
+  const FrameBuffer frame(createFrame(format.bytesPerFrame(frameSize), bitsPerSample));
+
+  setNrThreads(1);
+  QCOMPARE(RowBands::getNrBands(frameSize, 4), 1);
+  const auto singlePass = handler.convertFrameToImage(frame);
+
+  setNrThreads(4);
+  QVERIFY(RowBands::getNrBands(frameSize, 4) > 1);
+  const auto banded = handler.convertFrameToImage(frame);
+
+  QVERIFY(!singlePass.isNull());
+  QCOMPARE(banded, singlePass);
+}
+
+void rowBandsTest::testRGBConversion_data()
+{
+  QTest::addColumn<int>("bitsPerValue");
+  QTest::addColumn<bool>("planar");
+  QTest::addColumn<int>("posA");
+
+  QTest::newRow("RGB 8 bit") << 8 << false << -1;
+  QTest::newRow("RGBA 8 bit") << 8 << false << 3;
+  QTest::newRow("RGB 10 bit") << 10 << false << -1;
+  QTest::newRow("RGB 8 bit planar") << 8 << true << -1;
+  QTest::newRow("RGB 12 bit planar") << 12 << true << -1;
+}
+
+void rowBandsTest::testRGBConversion()
+{
+  QFETCH(int, bitsPerValue);
+  QFETCH(bool, planar);
+  QFETCH(int, posA);
+
+  const QSize frameSize(1024, 515);
+  videoHandlerRGB handler;
+  handler.setFrameSize(frameSize);
+  handler.setRGBPixelFormat(RGB_Internals::rgbPixelFormat(bitsPerValue, planar, 0, 1, 2, posA));
+
+  const FrameBuffer frame(createFrame(handler.getBytesPerFrame(), bitsPerValue));
+
+  setNrThreads(1);
+  const auto singlePass = handler.convertFrameToImage(frame);
+
+  setNrThreads(4);
+  QVERIFY(RowBands::getNrBands(frameSize) > 1);
+  const auto banded = handler.convertFrameToImage(frame);
+
+  QVERIFY(!singlePass.isNull());
+  QCOMPARE(banded, singlePass);
+}
+
+QTEST_MAIN(rowBandsTest)
+
+#include "rowBandsTest.moc"
@@ -0,0 +1,209 @@
+#include <QtTest>
+
+#include <video/ScaledYUVConversion.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+class scaledYUVConversionTest : public QObject
+{
+  Q_OBJECT
+
+public:
+  scaledYUVConversionTest() {};
+  ~scaledYUVConversionTest() {};
+
+private slots:
+  void testConversion_data();
+  void testConversion();
+  void testMonochrome();
+  void testBands();
+};
+
+namespace
+{
+
+// BT709 limited range (see getColorConversionCoefficients)
+const int RGBConv[5] = {76309, 117489, -13975, -34925, 138438};
+
+struct Plane
+{
+  Plane(int width, int height, int bytesPerSample, int padding) : width(width), height(height), bytesPerSample(bytesPerSample), stride((width + padding) * bytesPerSample)
+  {
+    data.resize(stride * height, 0xab);
+  }
+  void set(int x, int y, int value, bool bigEndian)
+  {
+    auto p = &data[y * stride + x * bytesPerSample];
+    if (bytesPerSample == 1)
+      p[0] = (unsigned char)value;
+    else
+    {
+      p[bigEndian ? 1 : 0] = (unsigned char)(value & 0xff);
+      p[bigEndian ? 0 : 1] = (unsigned char)(value >> 8);
+    }
+  }
+  int get(int x, int y, bool bigEndian) const
+  {
+    auto p = &data[y * stride + x * bytesPerSample];
+    if (bytesPerSample == 1)
+      return p[0];
+    return bigEndian ? ((p[0] << 8) | p[1]) : ((p[1] << 8) | p[0]);
+  }
+  int width, height, bytesPerSample, stride;
+  std::vector<unsigned char> data;
+};
+
+int clip(double val)
+{
+  return int(std::lround(std::min(255.0, std::max(0.0, val))));
+}
+
+} // namespace
+
+void scaledYUVConversionTest::testConversion_data()
+{
+  QTest::addColumn<int>("bitsPerSample");
+  QTest::addColumn<bool>("bigEndian");
+  QTest::addColumn<int>("level");
+
+  QTest::newRow("8 bit level 1") << 8 << false << 1;
+  QTest::newRow("8 bit level 2") << 8 << false << 2;
+  QTest::newRow("10 bit level 1") << 10 << false << 1;
+  QTest::newRow("10 bit big endian level 3") << 10 << true << 3;
+}
+
+void scaledYUVConversionTest::testConversion()
+{
+  QFETCH(int, bitsPerSample);
+  QFETCH(bool, bigEndian);
+  QFETCH(int, level);
+
+  // 4:2:0 with padded lines. The output width of odd sizes covers the SIMD loop and the scalar tail.
+  const int width = 150;
+  const int height = 46;
+  const int bytesPerSample = (bitsPerSample > 8) ? 2 : 1;
+  const int maxVal = (1 << bitsPerSample) - 1;
+  Plane planeY(width, height, bytesPerSample, 8);
+  Plane planeU(width / 2, height / 2, bytesPerSample, 4);
+  Plane planeV(width / 2, height / 2, bytesPerSample, 4);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      planeY.set(x, y, (x * 7 + y * 13) % (maxVal + 1), bigEndian);
+  for (int y = 0; y < height / 2; y++)
+    for (int x = 0; x < width / 2; x++)
+    {
+      planeU.set(x, y, (x * 11 + y * 3) % (maxVal + 1), bigEndian);
+      planeV.set(x, y, (x * 5 + y * 17 + 100) % (maxVal + 1), bigEndian);
+    }
+
+  ScaledYUVConversion::Source source;
+  source.planes[0] = planeY.data.data();
+  source.planes[1] = planeU.data.data();
+  source.planes[2] = planeV.data.data();
+  source.strides[0] = planeY.stride;
+  source.strides[1] = planeU.stride;
+  source.strides[2] = planeV.stride;
+  source.frameSize = QSize(width, height);
+  source.bitsPerSample = bitsPerSample;
+  source.bigEndian = bigEndian;
+
+  const auto scaledSize = ScaledYUVConversion::getScaledSize(source.frameSize, level);
+  QCOMPARE(scaledSize, QSize(width >> level, height >> level));
+  const int dstStride = scaledSize.width() * 4 + 12;
+  std::vector<unsigned char> output(dstStride * scaledSize.height(), 0);
+  ScaledYUVConversion::convert(source, level, RGBConv, false, output.data(), dstStride, 1);
+
+  // Compare to a floating point conversion of the 2x2 luma average and the collocated chroma sample.
+  // The conversion is done in 8 bit with 13 bit coefficients.
+  const double scale = double(1 << (bitsPerSample - 8));
+  int maxError = 0;
+  for (int y = 0; y < scaledSize.height(); y++)
+  {
+    for (int x = 0; x < scaledSize.width(); x++)
+    {
+      const int srcX = x << level;
+      const int srcY = y << level;
+      const double valY = (planeY.get(srcX, srcY, bigEndian) + planeY.get(srcX + 1, srcY, bigEndian) +
+                           planeY.get(srcX, srcY + 1, bigEndian) + planeY.get(srcX + 1, srcY + 1, bigEndian)) / 4.0 / scale - 16;
+      const double valU = planeU.get(srcX / 2, srcY / 2, bigEndian) / scale - 128;
+      const double valV = planeV.get(srcX / 2, srcY / 2, bigEndian) / scale - 128;
+      const int r = clip((RGBConv[0] * valY + RGBConv[1] * valV) / 65536);
+      const int g = clip((RGBConv[0] * valY + RGBConv[2] * valU + RGBConv[3] * valV) / 65536);
+      const int b = clip((RGBConv[0] * valY + RGBConv[4] * valU) / 65536);
+
+      const auto pixel = &output[y * dstStride + x * 4];
+      maxError = std::max(maxError, std::abs(pixel[0] - b));
+      maxError = std::max(maxError, std::abs(pixel[1] - g));
+      maxError = std::max(maxError, std::abs(pixel[2] - r));
+      QCOMPARE(int(pixel[3]), 255);
+    }
+    // The padding of the output lines is not touched
+    QCOMPARE(int(output[y * dstStride + scaledSize.width() * 4]), 0);
+  }
+  QVERIFY2(maxError <= 2, qPrintable(QString("Max error %1").arg(maxError)));
+}
+
+void scaledYUVConversionTest::testMonochrome()
+{
+  Plane planeY(64, 32, 1, 0);
+  for (int y = 0; y < 32; y++)
+    for (int x = 0; x < 64; x++)
+      planeY.set(x, y, (x % 2 == 0) ? 16 : 236, false);
+
+  ScaledYUVConversion::Source source;
+  source.planes[0] = planeY.data.data();
+  source.strides[0] = planeY.stride;
+  source.frameSize = QSize(64, 32);
+  source.hasChroma = false;
+
+  std::vector<unsigned char> output(32 * 16 * 4);
+  ScaledYUVConversion::convert(source, 1, RGBConv, false, output.data(), 32 * 4, 1);
+
+  // The average of black and white (126 in limited range) is gray
+  for (int i = 0; i < 32 * 16; i++)
+  {
+    QCOMPARE(int(output[i * 4]), 128);
+    QCOMPARE(int(output[i * 4 + 1]), 128);
+    QCOMPARE(int(output[i * 4 + 2]), 128);
+  }
+}
+
+void scaledYUVConversionTest::testBands()
+{
+  const int width = 512;
+  const int height = 300;
+  Plane planeY(width, height, 1, 0);
+  Plane planeU(width / 2, height / 2, 1, 0);
+  Plane planeV(width / 2, height / 2, 1, 0);
+  for (size_t i = 0; i < planeY.data.size(); i++)
+    planeY.data[i] = (unsigned char)(i * 31);
+  for (size_t i = 0; i < planeU.data.size(); i++)
+  {
+    planeU.data[i] = (unsigned char)(i * 17);
+    planeV.data[i] = (unsigned char)(i * 23);
+  }
+
+  ScaledYUVConversion::Source source;
+  source.planes[0] = planeY.data.data();
+  source.planes[1] = planeU.data.data();
+  source.planes[2] = planeV.data.data();
+  source.strides[0] = planeY.stride;
+  source.strides[1] = planeU.stride;
+  source.strides[2] = planeV.stride;
+  source.frameSize = QSize(width, height);
+
+  // Converting in parallel bands must give the same result as one pass
+  const auto scaledSize = ScaledYUVConversion::getScaledSize(source.frameSize, 1);
+  const int dstStride = scaledSize.width() * 4;
+  std::vector<unsigned char> single(dstStride * scaledSize.height(), 0);
+  std::vector<unsigned char> bands(dstStride * scaledSize.height(), 0);
+  ScaledYUVConversion::convert(source, 1, RGBConv, true, single.data(), dstStride, 1);
+  ScaledYUVConversion::convert(source, 1, RGBConv, true, bands.data(), dstStride, 7);
+  QVERIFY(single == bands);
+}
+
+QTEST_MAIN(scaledYUVConversionTest)
+
+#include "scaledYUVConversionTest.moc"
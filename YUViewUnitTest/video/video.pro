@@ -4,4 +4,14 @@ requires(qtHaveModule(testlib))
 
 SUBDIRS = yuvPixelFormatTest.pro \
           rgbPixelFormatTest.pro \
-          yuvPixelFormatGuessTest.pro
+          yuvPixelFormatGuessTest.pro \
+          frameBufferTest.pro \
+          decodedFrameRingTest.pro \
+          planeCopyTest.pro \
+          imagePyramidTest.pro \
+          scaledYUVConversionTest.pro \
+          glyphAtlasTest.pro \
+          differenceKernelsTest.pro \
+          prefetchSelectionTest.pro \
+          rowBandsTest.pro \
+          frameExporterTest.pro